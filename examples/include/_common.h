@@ -203,18 +203,20 @@ typedef enum {
                                    *   input audio. */
     CODEC_STATUS_NOT_INITIALISED, /**< Codec has not yet been initialised, or
                                    *   the codec configuration has changed.
-                                   *   Input audio should not be processed. */
-    CODEC_STATUS_INITIALISING     /**< Codec is currently being initialised,
-                                   *   input audio should not be processed. */
+                                   *   Input audio is still processed with the
+                                   *   previous configuration (if any). */
+    CODEC_STATUS_INITIALISING     /**< Codec is currently being initialised;
+                                   *   input audio is still processed with the
+                                   *   previous configuration (if any). */
 }CODEC_STATUS;
 
 /**
  * Current status of the processing loop
  *
- * These are used to keep things thread-safe. i.e., the codec will not be
- * initialised if the currently configured codec is being used to process a
- * block of audio. Likewise, if the codec is being initialised, then the
- * "process" functions are bypassed.
+ * @deprecated None of the examples use this anymore: a new configuration is
+ *             built while the current one is still being used to process
+ *             audio, and is then handed over to the "process" function via a
+ *             saf_stateSwap. It is only retained for source compatibility.
  */
 typedef enum {
     PROC_STATUS_ONGOING = 0, /**< Codec is processing input audio, and should
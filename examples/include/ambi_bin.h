@@ -46,9 +46,9 @@
  *     //
  *     // This function is fully thread-safe, and actually calling this on a
  *     // separate thread is actively encouraged, in order to avoid the
- *     // aforementioned run-time clicks/hangs. ambi_bin_process() is muted
- *     // if the initialisations are still on-going, and initialisations are
- *     // paused until the current ambi_bin_process() call has completed.
+ *     // aforementioned run-time clicks/hangs. ambi_bin_process() keeps
+ *     // rendering with the previous configuration while the initialisations
+ *     // are still on-going, and switches over once they have completed.
  *     ambi_bin_initCodec(hAmbi);
  *
  *     // ambi_bin_init() should be called once before calling
@@ -174,9 +174,13 @@ void ambi_bin_destroy(void** const phAmbi);
  *
  * @param[in] hAmbi      ambi_bin handle
  * @param[in] samplerate host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void ambi_bin_init(void* const hAmbi,
-                   int samplerate);
+                   int samplerate,
+                   int blockSize);
 
 /**
  * Intialises the codec variables, based on current global/user parameters
@@ -185,10 +189,11 @@ void ambi_bin_init(void* const hAmbi,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (filterbank and decoding matrices), while
+ *       process() keeps rendering with the current one. The new state is then
+ *       handed over to process() without locking (see saf_stateSwap), and the
+ *       previous state is re-used for the next re-init. process() is only
+ *       muted before the very first initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hAmbi ambi_bin handle
@@ -317,6 +322,18 @@ void ambi_bin_setFlipRoll(void* const hAmbi, int newState);
  */
 void ambi_bin_setRPYflag(void* const hAmbi, int newState);
 
+/**
+ * Sets the number of threads, across which the frequency bands are processed
+ * (default: 1)
+ *
+ * One of them is always the host thread, which calls ambi_bin_process(); the
+ * rest are the workers of a saf_threadPool, created by ambi_bin_initCodec().
+ *
+ * @param[in] hAmbi    ambi_bin handle
+ * @param[in] newValue New number of threads
+ */
+void ambi_bin_setNumThreads(void* const hAmbi, int newValue);
+
 
 /* ========================================================================== */
 /*                                Get Functions                               */
@@ -475,11 +492,25 @@ int ambi_bin_getHRIRsamplerate(void* const hAmbi);
 /** Returns the DAW/Host sample rate */
 int ambi_bin_getDAWsamplerate(void* const hAmbi);
 
+/** Returns the number of threads, across which the frequency bands are processed */
+int ambi_bin_getNumThreads(void* const hAmbi);
+
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       ambi_bin_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once ambi_bin_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hAmbi ambi_bin handle
  */
-int ambi_bin_getProcessingDelay(void);
+int ambi_bin_getProcessingDelay(void* const hAmbi);
 
     
 #ifdef __cplusplus
@@ -127,9 +127,13 @@ void ambi_dec_destroy(void** const phAmbi);
  *
  * @param[in] hAmbi      ambi_dec handle
  * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void ambi_dec_init(void* const hAmbi,
-                   int samplerate);
+                   int samplerate,
+                   int blockSize);
 
 /**
  * Intialises the codec variables, based on current global/user parameters
@@ -138,10 +142,11 @@ void ambi_dec_init(void* const hAmbi,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (filterbank, decoders and HRTF
+ *       interpolation tables), while process() keeps rendering with the current
+ *       one. The new state is then handed over to process() without locking
+ *       (see saf_stateSwap), and the previous state is re-used for the next
+ *       re-init. process() is only muted before the very first initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hAmbi      ambi_dec handle
@@ -351,6 +356,18 @@ void ambi_dec_setDecNormType(void* const hAmbi, int index, int newID);
  */
 void ambi_dec_setTransitionFreq(void* const hAmbi, float newValue);
 
+/**
+ * Sets the number of threads, across which the frequency bands are processed
+ * (default: 1, i.e. only the host thread)
+ *
+ * The host thread is always one of these threads, and the others are the
+ * workers of a saf_threadPool, which is created by ambi_dec_initCodec().
+ *
+ * @param[in] hAmbi    ambi_dec handle
+ * @param[in] newValue New number of threads
+ */
+void ambi_dec_setNumThreads(void* const hAmbi, int newValue);
+
 
 /* ========================================================================== */
 /*                                Get Functions                               */
@@ -513,11 +530,25 @@ int ambi_dec_getHRIRsamplerate(void* const hAmbi);
 /** Returns the DAW/Host sample rate */
 int ambi_dec_getDAWsamplerate(void* const hAmbi);
     
+/** Returns the number of threads, across which the frequency bands are processed */
+int ambi_dec_getNumThreads(void* const hAmbi);
+    
 /**
  * Returns the processing delay in samples; may be used for delay compensation
  * features
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       ambi_dec_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once ambi_dec_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hAmbi ambi_dec handle
  */
-int ambi_dec_getProcessingDelay(void);
+int ambi_dec_getProcessingDelay(void* const hAmbi);
 
 
 #ifdef __cplusplus
@@ -69,9 +69,26 @@ extern "C" {
 # define AMBI_DRC_NUM_DISPLAY_TIME_SLOTS ( (int)(AMBI_DRC_NUM_DISPLAY_SECONDS*48000.0f/(float)128) )
 /** Number of samples to offset when reading TF data */
 # define AMBI_DRC_READ_OFFSET ( 200 )
-/** Number of frequency bands used during processing */
-# define AMBI_DRC_NUM_BANDS ( 133 )
+/**
+ * Maximum number of frequency bands used during processing (the number used by
+ * the current filterbank is returned by ambi_drc_getFreqVector())
+ */
+# define AMBI_DRC_NUM_BANDS ( 257 )
 #endif
+/** Available filterbanks (see ambi_drc_setFilterbank()) */
+typedef enum {
+    AMBI_DRC_FILTERBANK_AFSTFT = 1, /**< Alias-free STFT filterbank (133 bands) */
+    AMBI_DRC_FILTERBANK_AFSTFT_LD,  /**< Alias-free STFT filterbank, low-delay
+                                     *   mode (133 bands) */
+    AMBI_DRC_FILTERBANK_QMF,        /**< Complex QMF filterbank (135 bands) */
+    AMBI_DRC_FILTERBANK_STFT        /**< STFT with 50% overlapping windows (257
+                                     *   bands) */
+
+} AMBI_DRC_FILTERBANKS;
+
+/** Number of filterbank options */
+#define AMBI_DRC_NUM_FILTERBANKS ( 4 )
+
 /** -16dB, maximum gain reduction for a given frequency band */
 #define AMBI_DRC_SPECTRAL_FLOOR (0.1585f)
 
@@ -114,9 +131,13 @@ void ambi_drc_destroy(void** const phAmbi);
  *
  * @param[in] hAmbi      ambi_drc handle
  * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void ambi_drc_init(void* const hAmbi,
-                   int samplerate);
+                   int samplerate,
+                   int blockSize);
 
 /**
  * Applies the frequency-dependent dynamic range compression to the input
@@ -188,6 +209,14 @@ void ambi_drc_setNormType(void* const hAmbi, int newType);
  */
 void ambi_drc_setInputPreset(void* const hAmbi, SH_ORDERS newPreset);
 
+/**
+ * Sets the filterbank used for the processing (see #AMBI_DRC_FILTERBANKS enum)
+ *
+ * The filterbank is changed at the next available opportunity. Note that this
+ * also changes the number of frequency bands and the processing delay.
+ */
+void ambi_drc_setFilterbank(void* const hAmbi, int newType);
+
     
 /* ========================================================================== */
 /*                                Get Functions                               */
@@ -251,6 +280,9 @@ int ambi_drc_getNormType(void* const hAmbi);
     
 /** Returns the current processing order (see #SH_ORDERS enum) */
 SH_ORDERS ambi_drc_getInputPreset(void* const hAmbi);
+
+/** Returns the filterbank used for the processing (see #AMBI_DRC_FILTERBANKS) */
+int ambi_drc_getFilterbank(void* const hAmbi);
     
 /**
  * Returns the number of spherical harmonic signals required by the current
@@ -264,8 +296,19 @@ int ambi_drc_getSamplerate(void* const hAmbi);
 /**
  * Returns the processing delay in samples; may be used for delay compensation
  * features
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       ambi_drc_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once ambi_drc_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hAmbi ambi_drc handle
  */
-int ambi_drc_getProcessingDelay(void);
+int ambi_drc_getProcessingDelay(void* const hAmbi);
     
     
 #ifdef __cplusplus
@@ -70,9 +70,13 @@ void ambi_roomsim_destroy(void** const phAmbi);
  *
  * @param[in] hAmbi      ambi_roomsim handle
  * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void ambi_roomsim_init(void* const hAmbi,
-                     int samplerate);
+                     int samplerate,
+                     int blockSize);
 
 /**
  * Processes audio
@@ -286,8 +290,19 @@ int ambi_roomsim_getNormType(void* const hAmbi);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       ambi_roomsim_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once ambi_roomsim_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hAmbi ambi_roomsim handle
  */
-int ambi_roomsim_getProcessingDelay(void);
+int ambi_roomsim_getProcessingDelay(void* const hAmbi);
 
 
 #ifdef __cplusplus
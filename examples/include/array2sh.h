@@ -248,9 +248,13 @@ void array2sh_destroy(void** const phA2sh);
  *
  * @param[in] hA2sh      array2sh handle
  * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void array2sh_init(void* const hA2sh,
-                   int samplerate);
+                   int samplerate,
+                   int blockSize);
 
 /**
  * Evaluates the encoder, based on current global/user parameters
@@ -651,8 +655,19 @@ int array2sh_getSamplingRate(void* const hA2sh);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features) 
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       array2sh_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once array2sh_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hA2sh array2sh handle
  */
-int array2sh_getProcessingDelay(void);
+int array2sh_getProcessingDelay(void* const hA2sh);
    
     
 #ifdef __cplusplus
@@ -67,9 +67,13 @@ void beamformer_destroy(void** const phBeam);
  *
  * @param[in] hBeam      beamformer handle
  * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void beamformer_init(void* const hBeam,
-                     int samplerate);
+                     int samplerate,
+                     int blockSize);
 
 /**
  * Generates beamformers/virtual microphones in the specified directions
@@ -185,8 +189,19 @@ int beamformer_getBeamType(void* const hBeam);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       beamformer_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once beamformer_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hBeam beamformer handle
  */
-int beamformer_getProcessingDelay(void);
+int beamformer_getProcessingDelay(void* const hBeam);
 
     
 #ifdef __cplusplus
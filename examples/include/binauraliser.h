@@ -86,9 +86,13 @@ void binauraliser_destroy(void** const phBin);
  *
  * @param[in] hBin       binauraliser handle
  * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void binauraliser_init(void* const hBin,
-                       int samplerate);
+                       int samplerate,
+                       int blockSize);
 
 /**
  * Intialises the codec variables, based on current global/user parameters
@@ -97,10 +101,11 @@ void binauraliser_init(void* const hBin,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (filterbank, HRTFs and interpolation
+ *       tables), while process() keeps rendering with the current one. The new
+ *       state is then handed over to process() without locking (see
+ *       saf_stateSwap), and the previous state is re-used for the next re-init.
+ *       process() is only muted before the very first initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hBin binauraliser handle
@@ -372,8 +377,19 @@ int binauraliser_getInterpMode(void* const hBin);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * purposes)
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       binauraliser_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once binauraliser_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hBin binauraliser handle
  */
-int binauraliser_getProcessingDelay(void);
+int binauraliser_getProcessingDelay(void* const hBin);
 
 
 #ifdef __cplusplus
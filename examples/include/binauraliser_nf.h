@@ -89,9 +89,13 @@ void binauraliserNF_destroy(void** const phBin);
  *
  * @param[in] hBin       binauraliserNF handle
  * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void binauraliserNF_init(void* const hBin,
-                         int samplerate);
+                         int samplerate,
+                         int blockSize);
 
 /**
  * Intialises the codec variables, based on current global/user parameters
@@ -100,10 +104,11 @@ void binauraliserNF_init(void* const hBin,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (filterbank, HRTFs and interpolation
+ *       tables), while process() keeps rendering with the current one. The new
+ *       state is then handed over to process() without locking (see
+ *       saf_stateSwap), and the previous state is re-used for the next re-init.
+ *       process() is only muted before the very first initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hBin binauraliser handle
@@ -42,6 +42,26 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/* ========================================================================== */
+/*                             Presets + Constants                            */
+/* ========================================================================== */
+
+/** Available filterbanks (see decorrelator_setFilterbank()) */
+typedef enum {
+    DECORRELATOR_FILTERBANK_AFSTFT = 1, /**< Alias-free STFT filterbank (133
+                                         *   bands) */
+    DECORRELATOR_FILTERBANK_AFSTFT_LD,  /**< Alias-free STFT filterbank,
+                                         *   low-delay mode (133 bands) */
+    DECORRELATOR_FILTERBANK_QMF,        /**< Complex QMF filterbank (135 bands) */
+    DECORRELATOR_FILTERBANK_STFT        /**< STFT with 50% overlapping windows
+                                         *   (257 bands) */
+
+} DECORRELATOR_FILTERBANKS;
+
+/** Number of filterbank options */
+#define DECORRELATOR_NUM_FILTERBANKS ( 4 )
+
+
 /* ========================================================================== */
 /*                               Main Functions                               */
 /* ========================================================================== */
@@ -67,9 +87,13 @@ void decorrelator_destroy(void** const phDecor);
  *
  * @param[in] hDecor     decorrelator handle
  * @param[in] samplerate host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void decorrelator_init(void* const hDecor,
-                       int samplerate);
+                       int samplerate,
+                       int blockSize);
 
 /**
  * Intialises the codec variables, based on current global/user parameters
@@ -78,10 +102,11 @@ void decorrelator_init(void* const hDecor,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (the decorrelators and transient ducker),
+ *       while process() keeps rendering with the current one. The new state is
+ *       then handed over to process() without locking (see saf_stateSwap), and
+ *       the previous state is re-used for the next re-init. process() is only
+ *       muted before the very first initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hDecor decorrelator handle
@@ -132,6 +157,16 @@ void decorrelator_setLevelCompensationFlag(void* const hDecor,
 void decorrelator_setTransientBypassFlag(void* const hDecor,
                                          int newValue);
 
+/**
+ * Sets the filterbank used for the processing (see #DECORRELATOR_FILTERBANKS
+ * enum)
+ *
+ * The filterbank is changed at the next re-initialisation. Note that this also
+ * changes the processing delay.
+ */
+void decorrelator_setFilterbank(void* const hDecor,
+                                int newType);
+
 
 /* ========================================================================== */
 /*                                Get Functions                               */
@@ -171,14 +206,31 @@ int decorrelator_getLevelCompensationFlag(void* const hDecor);
 /** Returns whether to bypass decorrelating the transients (0 or 1) */
 int decorrelator_getTransientBypassFlag(void* const hDecor);
 
+/**
+ * Returns the filterbank used for the processing (see
+ * #DECORRELATOR_FILTERBANKS)
+ */
+int decorrelator_getFilterbank(void* const hDecor);
+
 /** Returns the DAW/Host sample rate */
 int decorrelator_getDAWsamplerate(void* const hDecor);
 
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       decorrelator_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once decorrelator_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hDecor decorrelator handle
  */
-int decorrelator_getProcessingDelay(void);
+int decorrelator_getProcessingDelay(void* const hDecor);
 
     
 #ifdef __cplusplus
@@ -156,10 +156,11 @@ void dirass_init(void* const hDir,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (scanning grid, beamforming weights and
+ *       display buffers), while process() keeps rendering with the current one.
+ *       The new state is then handed over to process() without locking (see
+ *       saf_stateSwap), and the previous state is re-used for the next re-init.
+ *       process() is only muted before the very first initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hDir dirass handle
@@ -113,6 +113,11 @@ void matrixconv_checkReInit(void* const hMCnv);
  * This is then divided by the number of inputs, which should be user specified
  * to be 32 in this case.
  *
+ * @note If the dimensions of the loaded data are unchanged, then the new filters
+ *       are swapped in without interrupting the audio (see
+ *       saf_matrixConv_updateFilters()); otherwise, the convolver is
+ *       re-initialised.
+ *
  * @param[in] hMCnv       matrixconv handle
  * @param[in] H           Input channel buffers; 2-D array:
  *                        numChannels x nSamples
@@ -127,7 +132,10 @@ void matrixconv_setFilters(void* const hMCnv,
                            int numSamples,
                            int sampleRate);
 
-/** Enable (1), disable (0), partitioned convolution */
+/**
+ * Enable (1), disable (0), partitioned convolution, or enable non-uniform
+ * partitioned convolution (2); the latter being recommended for long filters
+ */
 void matrixconv_setEnablePart(void* const hMCnv, int newState);
     
 /**
@@ -152,8 +160,8 @@ void matrixconv_setNumInputChannels(void* const hMCnv, int newValue);
 int matrixconv_getFrameSize(void);
 
 /**
- * Returns a flag indicating whether partitioned convolution is enabled (1) or
- * disabled (0)
+ * Returns a flag indicating whether partitioned convolution is enabled (1),
+ * disabled (0), or whether non-uniform partitioned convolution is enabled (2)
  */
 int matrixconv_getEnablePart(void* const hMCnv);
     
@@ -187,6 +195,11 @@ int matrixconv_getHostFs(void* const hMCnv);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
+ *
+ * @note This is the latency of buffering the host blocks into frames of
+ *       512..8192 samples, which is 0 if the host block size lies within this
+ *       range, or is a multiple of the frame size (see
+ *       saf_blockAdapter_getLatency())
  */
 int matrixconv_getProcessingDelay(void* const hMCnv);
     
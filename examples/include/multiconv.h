@@ -120,7 +120,10 @@ void multiconv_setFilters(void* const hMCnv,
                           int numSamples,
                           int sampleRate);
     
-/** Enable (1), disable (0), partitioned convolution */
+/**
+ * Enable (1), disable (0), partitioned convolution, or enable non-uniform
+ * partitioned convolution (2); the latter being recommended for long filters
+ */
 void multiconv_setEnablePart(void* const hMCnv, int newState);
     
 /** Sets the number of input/output channels */
@@ -138,8 +141,8 @@ void multiconv_setNumChannels(void* const hMCnv, int newValue);
 int multiconv_getFrameSize(void);
 
 /**
- * Returns a flag indicating whether partitioned convolution is enabled (1) or
- * disabled (0)
+ * Returns a flag indicating whether partitioned convolution is enabled (1),
+ * disabled (0), or whether non-uniform partitioned convolution is enabled (2)
  */
 int multiconv_getEnablePart(void* const hMCnv);
 
@@ -164,6 +167,11 @@ int multiconv_getHostFs(void* const hMCnv);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
+ *
+ * @note This is the latency of buffering the host blocks into frames of
+ *       512..8192 samples, which is 0 if the host block size lies within this
+ *       range, or is a multiple of the frame size (see
+ *       saf_blockAdapter_getLatency())
  */
 int multiconv_getProcessingDelay(void* const hMCnv);
 
@@ -96,9 +96,13 @@ void panner_destroy(void** const phPan);
  *
  * @param[in] hPan       panner handle
  * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void panner_init(void* const hPan,
-                 int samplerate);
+                 int samplerate,
+                 int blockSize);
     
 /**
  * Intialises the codec variables, based on current global/user parameters
@@ -107,10 +111,11 @@ void panner_init(void* const hPan,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (filterbank and VBAP gain table), while
+ *       process() keeps rendering with the current one. The new state is then
+ *       handed over to process() without locking (see saf_stateSwap), and the
+ *       previous state is re-used for the next re-init. process() is only muted
+ *       before the very first initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hPan panner handle
@@ -321,8 +326,19 @@ int panner_getFlipRoll(void* const hPan);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features) 
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       panner_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once panner_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hPan panner handle
  */
-int panner_getProcessingDelay(void);
+int panner_getProcessingDelay(void* const hPan);
 
 
 #ifdef __cplusplus
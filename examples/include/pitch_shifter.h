@@ -109,11 +109,15 @@ void pitch_shifter_destroy(void** const phPS);
  *
  * @warning This should not be called while _process() is on-going!
  *
- * @param[in] hPS       pitch_shifter handle
+ * @param[in] hPS        pitch_shifter handle
  * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void pitch_shifter_init(void* const hPS,
-                        int samplerate);
+                        int samplerate,
+                        int blockSize);
 
 /**
  * Intialises the codec variables, based on current global/user parameters
@@ -122,10 +126,11 @@ void pitch_shifter_init(void* const hPS,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (a new pitch-shifter handle), while
+ *       process() keeps rendering with the current one. The new state is then
+ *       handed over to process() without locking (see saf_stateSwap), and the
+ *       previous state is re-used for the next re-init. process() is only muted
+ *       before the very first initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hPS pitch_shifter handle
@@ -238,6 +243,13 @@ int pitch_shifter_getNCHrequired(void* const hPS);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       pitch_shifter_getFrameSize() samples, which is 0 if the host block size
+ *       is a multiple of the frame size (see saf_blockAdapter_getLatency()). It
+ *       is known once pitch_shifter_init() has been called with the host block
+ *       size, and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
  */
 int pitch_shifter_getProcessingDelay(void* const hPS);
 
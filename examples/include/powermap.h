@@ -111,10 +111,12 @@ void powermap_init(void* const hPm,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (filterbank, scanning grid, interpolation
+ *       table and display buffers), while process() keeps rendering with the
+ *       current one. The new state is then handed over to process() without
+ *       locking (see saf_stateSwap), and the previous state is re-used for the
+ *       next re-init. process() is only muted before the very first
+ *       initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hPm powermap handle
@@ -214,6 +216,15 @@ void powermap_setPowermapAvgCoeff(void* const hPm, float newValue);
  */
 void powermap_requestPmapUpdate(void* const hPm);
 
+/**
+ * Sets the number of threads, across which the computation of the covariance
+ * matrices is split (default: 1)
+ *
+ * The host thread is one of them, and the rest are the workers of a
+ * saf_threadPool, which is created by powermap_initCodec().
+ */
+void powermap_setNumThreads(void* const hPm, int newValue);
+
 
 /* ========================================================================== */
 /*                                Get Functions                               */
@@ -364,6 +375,9 @@ int powermap_getPmap(void* const hPm,
                      int* hfov,
                      int* aspectRatio);
 
+/** Returns the number of threads computing the covariance matrices */
+int powermap_getNumThreads(void* const hPm);
+
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
@@ -71,10 +71,14 @@ void rotator_destroy(void** const phRot);
  * Initialises an instance of rotator with default settings
  *
  * @param[in] hRot       rotator handle
- * @param[in] samplerate Host samplerate.
+ * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void rotator_init(void* const hRot,
-                  int samplerate);
+                  int samplerate,
+                  int blockSize);
 
 /**
  * Rotates the input spherical harmonic signals
@@ -252,8 +256,19 @@ int rotator_getNSHrequired(void* const hRot);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       rotator_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once rotator_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hRot rotator handle
  */
-int rotator_getProcessingDelay(void);
+int rotator_getProcessingDelay(void* const hRot);
     
     
 #ifdef __cplusplus
@@ -84,10 +84,14 @@ void spreader_destroy(void** const phSpr);
  * @warning This should not be called while _process() is on-going!
  *
  * @param[in] hSpr       spreader handle
- * @param[in] samplerate Host samplerate.
+ * @param[in] samplerate Host samplerate.
+ * @param[in] blockSize  Host block size (the largest, if it varies), or 0 if
+ *                       unknown; used to establish the processing delay
+ *                       before the first call to _process()
  */
 void spreader_init(void* const hSpr,
-                   int samplerate);
+                   int samplerate,
+                   int blockSize);
 
 /**
  * Intialises the codec variables, based on current global/user parameters
@@ -96,10 +100,11 @@ void spreader_init(void* const hSpr,
  *       via a timer on one thread, while calling _process() on another thread.
  *       Since, if a set function is called (that warrants a re-init), then a
  *       flag is triggered internally and the next time this function is called,
- *       it will wait until the current process() function has completed before
- *       reinitialising the relevant parameters. If the _initCodec() takes
- *       longer than the time it takes for process() to be called again, then
- *       process() is simply bypassed until the codec is ready.
+ *       it builds a new render state (the filter tables, decorrelators and
+ *       mixing matrices), while process() keeps rendering with the current one.
+ *       The new state is then handed over to process() without locking (see
+ *       saf_stateSwap), and the previous state is re-used for the next re-init.
+ *       process() is only muted before the very first initialisation.
  * @note This function does nothing if no re-initialisations are required.
  *
  * @param[in] hSpr spreader handle
@@ -181,6 +186,18 @@ void spreader_setUseDefaultHRIRsflag(void* const hSpr, int newState);
  */
 void spreader_setSofaFilePath(void* const hSpr, const char* path);
 
+/**
+ * Sets the number of threads, across which the mixing matrices are applied to
+ * the frequency bands (default: 1)
+ *
+ * The calling thread counts as one of them; any additional threads are pooled
+ * and (re)created with the next spreader_initCodec() call.
+ *
+ * @param[in] hSpr     spreader handle
+ * @param[in] newValue New number of threads
+ */
+void spreader_setNumThreads(void* const hSpr, int newValue);
+
 
 /* ========================================================================== */
 /*                                Get Functions                               */
@@ -280,11 +297,25 @@ char* spreader_getSofaFilePath(void* const hSpr);
 /** Returns the DAW/Host sample rate */
 int spreader_getDAWsamplerate(void* const hSpr);
 
+/** Returns the number of threads used for applying the mixing matrices */
+int spreader_getNumThreads(void* const hSpr);
+
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * purposes)
+ *
+ * @note This includes the latency of buffering the host blocks into frames of
+ *       spreader_getFrameSize() samples, which is 0 if the host block size is a
+ *       multiple of the frame size (see saf_blockAdapter_getLatency()). It is
+ *       known once spreader_init() has been called with the host block size,
+ *       and is only increased if a later block is not a multiple of the
+ *       sizes seen so far
+ * @note This function previously took no arguments, and excluded the block
+ *       adapter latency
+ *
+ * @param[in] hSpr spreader handle
  */
-int spreader_getProcessingDelay(void);
+int spreader_getProcessingDelay(void* const hSpr);
 
 
 #ifdef __cplusplus
@@ -101,13 +101,18 @@ void tvconv_process(void* const hTVCnv,
 /* ========================================================================== */
     
 /**
- * Sets all intialisation flags to 1. Re-initialising all settings/variables,
- * as tvconv is currently configured, at next available opportunity.
+ * Sets all intialisation flags to 1, and re-initialises all settings/variables,
+ * as tvconv is currently configured (see tvconv_checkReInit())
  */
 void tvconv_refreshParams(void* const hTVCnv);
 
 /**
  * Checks whether things have to be reinitialised, and does so if it is needed
+ *
+ * @note This function may be called while tvconv_process() is on-going on
+ *       another thread. The new convolver is built in a new render state,
+ *       while tvconv_process() keeps rendering with the current one, and is
+ *       then handed over without locking (see saf_stateSwap).
  */
 void tvconv_checkReInit(void* const hTVCnv);
 
@@ -186,6 +191,11 @@ int tvconv_getHostFs(void* const hTVCnv);
 /**
  * Returns the processing delay in samples (may be used for delay compensation
  * features)
+ *
+ * @note This is the latency of buffering the host blocks into frames of
+ *       512..8192 samples, which is 0 if the host block size lies within this
+ *       range, or is a multiple of the frame size (see
+ *       saf_blockAdapter_getLatency())
  */
 int tvconv_getProcessingDelay(void* const hTVCnv);
 
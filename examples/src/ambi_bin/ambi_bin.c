@@ -80,12 +80,11 @@ void ambi_bin_create
     
     /* afSTFT and audio buffers */
     pData->fs = 48000;
-    pData->hSTFT = NULL;
-    pData->SHFrameTD = (float**)malloc2d(MAX_NUM_SH_SIGNALS, AMBI_BIN_FRAME_SIZE, sizeof(float));
-    pData->binFrameTD = (float**)malloc2d(NUM_EARS, AMBI_BIN_FRAME_SIZE, sizeof(float));
-    pData->SHframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
-    pData->binframeTF = (float_complex***)malloc3d(HYBRID_BANDS, NUM_EARS, TIME_SLOTS, sizeof(float_complex));
-    afSTFT_getCentreFreqs(pData->hSTFT, (float)pData->fs, HYBRID_BANDS, (float*)pData->freqVector);
+    pData->SHFrameTD = (float**)calloc2d_aligned(MAX_NUM_SH_SIGNALS, AMBI_BIN_FRAME_SIZE, sizeof(float));
+    pData->binFrameTD = (float**)malloc2d_aligned(NUM_EARS, AMBI_BIN_FRAME_SIZE, sizeof(float));
+    pData->SHframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
+    pData->binframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, NUM_EARS, TIME_SLOTS, sizeof(float_complex));
+    afSTFT_getCentreFreqs(NULL, (float)pData->fs, HYBRID_BANDS, (float*)pData->freqVector);
 
     /* codec data */
     pData->progressBar0_1 = 0.0f;
@@ -100,11 +99,22 @@ void ambi_bin_create
     pars->hrtf_fb = NULL;
     pars->weights = NULL;
     
+    /* render states are built by ambi_bin_initCodec() */
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
+
     /* flags */
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
+    pData->initLock = 0;
     pData->recalc_M_rotFLAG = 1;
     pData->reinit_hrtfsFLAG = 1;
+
+    /* single-threaded by default */
+    pData->nThreads = pData->new_nThreads = 1;
+    pData->hThreadPool = NULL;
+
+    /* for passing arbitrary host block sizes through ambi_bin_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), AMBI_BIN_FRAME_SIZE, MAX_NUM_SH_SIGNALS, NUM_EARS);
 }
 
 void ambi_bin_destroy
@@ -114,20 +124,23 @@ void ambi_bin_destroy
 {
     ambi_bin_data *pData = (ambi_bin_data*)(*phAmbi);
     ambi_bin_codecPars *pars;
+    ambi_bin_renderState *state;
     
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
+        /* Wait for any on-going initialisation to complete, and then take back the current render state (which also
+         * waits for the processing loop to let go of it) */
+        saf_spinLock_lock(&(pData->initLock));
+        state = (ambi_bin_renderState*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(state==pData->liveState, "Unexpected render state");
+        ambi_bin_destroyRenderState(&state);
+        ambi_bin_destroyRenderState(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
         
-        /* free afSTFT and buffers */
-        afSTFT_destroy(&(pData->hSTFT));
-        free(pData->SHFrameTD);
-        free(pData->binFrameTD);
-        free(pData->SHframeTF);
-        free(pData->binframeTF);
+        /* free buffers */
+        free2d_aligned((void**)pData->SHFrameTD);
+        free2d_aligned((void**)pData->binFrameTD);
+        free3d_aligned((void***)pData->SHframeTF);
+        free3d_aligned((void***)pData->binframeTF);
 
         pars = pData->pars;
         free(pars->sofa_filepath);
@@ -139,6 +152,9 @@ void ambi_bin_destroy
         free(pars);
         free(pData->progressBarText);
         
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
+        if(pData->hThreadPool!=NULL)
+            saf_threadPool_destroy(&(pData->hThreadPool));
         free(pData);
         pData = NULL;
         *phAmbi = NULL;
@@ -148,7 +164,8 @@ void ambi_bin_destroy
 void ambi_bin_init
 (
     void * const hAmbi,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
@@ -156,13 +173,16 @@ void ambi_bin_init
     /* define frequency vector */
     if(pData->fs != sampleRate){
         pData->fs = sampleRate;
-        pData->reinit_hrtfsFLAG = 1;
+        saf_atomic_store(&(pData->reinit_hrtfsFLAG), 1);
         ambi_bin_setCodecStatus(hAmbi, CODEC_STATUS_NOT_INITIALISED);
     }
-    afSTFT_getCentreFreqs(pData->hSTFT, (float)pData->fs, HYBRID_BANDS, (float*)pData->freqVector);
+    afSTFT_getCentreFreqs(NULL, (float)pData->fs, HYBRID_BANDS, (float*)pData->freqVector);
 
     /* default starting values */
     pData->recalc_M_rotFLAG = 1;
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
 void ambi_bin_initCodec
@@ -172,37 +192,67 @@ void ambi_bin_initCodec
 {
     ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
     ambi_bin_codecPars* pars = pData->pars;
-    int i, j, nSH, order, band;
+    ambi_bin_renderState* state, *live;
+    void* hPrevThreadPool;
+    int i, j, nSH, order, band, reinitHRTFs;
 #ifdef SAF_ENABLE_SOFA_READER_MODULE
     SAF_SOFA_ERROR_CODES error;
     saf_sofa_container sofa;
 #endif
     
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
     
+    /* Take (and clear) the HRTF flag now, such that a refresh requested during this initialisation is not lost */
+    reinitHRTFs = saf_atomic_compareExchange(&(pData->reinit_hrtfsFLAG), 1, 0);
+
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Preparing HRIRs");
     pData->progressBar0_1 = 0.0f;
+
+    /* The new render state is built in the spare one, while the audio thread keeps rendering with the current one */
+    if(pData->spareState==NULL)
+        ambi_bin_createRenderState(&(pData->spareState));
+    state = pData->spareState;
+
+    /* (Re)create the thread pool, with one thread fewer, since the host thread also processes bands (the previous pool
+     * is only destroyed once the audio thread has switched over to the new render state) */
+    hPrevThreadPool = NULL;
+    if(pData->new_nThreads != pData->nThreads){
+        hPrevThreadPool = pData->hThreadPool;
+        pData->hThreadPool = NULL;
+        if(pData->new_nThreads>1)
+            saf_threadPool_create(&(pData->hThreadPool), pData->new_nThreads-1);
+        pData->nThreads = pData->new_nThreads;
+    }
+    state->hThreadPool = pData->hThreadPool;
     
-    /* (Re)Initialise afSTFT */
+    /* (Re)Initialise afSTFT. If the number of channels is unchanged, then the filterbank currently in use is passed on
+     * to the new render state, so that its buffered signals carry over and the audio continues seamlessly */
     order = pData->new_order;
     nSH = (order+1)*(order+1);
-    if(pData->hSTFT==NULL)
-        afSTFT_create(&(pData->hSTFT), nSH, NUM_EARS, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-    else if(pData->nSH != nSH) {/* Or change the number of channels */
-        afSTFT_channelChange(pData->hSTFT, nSH, NUM_EARS);
-        afSTFT_clearBuffers(pData->hSTFT);
+    live = pData->liveState;
+    if(live!=NULL && live->nSH == nSH){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        state->hSTFT = live->hSTFT;
     }
-    pData->nSH = nSH;
+    else if(state->hSTFT==NULL)
+        afSTFT_create(&(state->hSTFT), nSH, NUM_EARS, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    else {
+        if(state->nSH != nSH) /* Change the number of channels */
+            afSTFT_channelChange(state->hSTFT, nSH, NUM_EARS);
+        afSTFT_clearBuffers(state->hSTFT); /* (the spare state still holds the signals from when it was last used) */
+    }
+    state->order = order;
+    state->nSH = pData->nSH = nSH;
     
-    if(pData->reinit_hrtfsFLAG){
+    if(reinitHRTFs){
         /* load sofa file or default hrir data */
         strcpy(pData->progressBarText,"Preparing HRIRs");
         pData->progressBar0_1 = 0.15f;
@@ -287,7 +337,6 @@ void ambi_bin_initCodec
                                   pData->preProc == HRIR_PREPROC_EQ    || pData->preProc == HRIR_PREPROC_ALL ? 1 : 0, /* Apply Diffuse-field EQ? */
                                   pData->preProc == HRIR_PREPROC_PHASE || pData->preProc == HRIR_PREPROC_ALL ? 1 : 0, /* Apply phase simplification EQ? */
                                   pars->hrtf_fb);
-        pData->reinit_hrtfsFLAG = 0;
     }
     
     /* get new decoder */
@@ -368,7 +417,7 @@ void ambi_bin_initCodec
 
         /* apply to decoding matrix */
         for (int idxBand=0; idxBand<numBands; idxBand++){
-            for (int idxSH=0; idxSH<pData->nSH; idxSH++){
+            for (int idxSH=0; idxSH<nSH; idxSH++){
                 decMtx[idxBand*NUM_EARS*nSH+0*nSH+idxSH] = crmulf(decMtx[idxBand*NUM_EARS*nSH+0*nSH+idxSH], eqGain[idxBand]); /* left ear */
                 decMtx[idxBand*NUM_EARS*nSH+1*nSH+idxSH] = crmulf(decMtx[idxBand*NUM_EARS*nSH+1*nSH+idxSH], eqGain[idxBand]); /* right ear */
             }
@@ -380,26 +429,80 @@ void ambi_bin_initCodec
         free(eqGain);
     }
     
-    /* replace current decoder */
-    memset(pars->M_dec, 0, HYBRID_BANDS*NUM_EARS*MAX_NUM_SH_SIGNALS*sizeof(float_complex));
+    /* new decoder */
+    memset(state->M_dec, 0, HYBRID_BANDS*NUM_EARS*MAX_NUM_SH_SIGNALS*sizeof(float_complex));
     for(band=0; band<HYBRID_BANDS; band++)
         for(i=0; i<NUM_EARS; i++)
             for(j=0; j<nSH; j++)
-                pars->M_dec[band][i][j] = decMtx[band*NUM_EARS*nSH + i*nSH + j];
+                state->M_dec[band][i][j] = decMtx[band*NUM_EARS*nSH + i*nSH + j];
     free(decMtx);
 
     /* rotation matrix will need to be updated too */
-    pData->recalc_M_rotFLAG = 1;
+    state->bakeRotFLAG = 1;
+
+    /* Hand the new render state over to the audio thread, and keep the previous one as the spare, once it is no longer
+     * being used */
+    pData->spareState = (ambi_bin_renderState*)saf_stateSwap_publish(pData->hStateSwap, (void*)state);
+    pData->liveState = state;
+    if(pData->spareState!=NULL && pData->spareState->hSTFT == state->hSTFT)
+        pData->spareState->hSTFT = NULL; /* (passed on to the new render state) */
+    if(hPrevThreadPool!=NULL)
+        saf_threadPool_destroy(&hPrevThreadPool);
     
     pData->order = order;
 
-    /* done! */
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
-void ambi_bin_process
+/** Arguments for ambi_bin_processBands() */
+typedef struct _ambi_bin_bandArgs {
+    ambi_bin_data* pData;
+    ambi_bin_renderState* state;
+    int nSH;
+    int enableRot;
+    int bakeRot;   /**< 1: the rotation matrix has changed, and needs to be baked into the decoding matrices */
+} ambi_bin_bandArgs;
+
+/**
+ * Applies the decoding matrices to frequency bands start..end-1 of the current
+ * frame (see saf_threadPool_parallelFor())
+ */
+static void ambi_bin_processBands
+(
+    void* arg,
+    int start,
+    int end
+)
+{
+    ambi_bin_bandArgs* a = (ambi_bin_bandArgs*)arg;
+    ambi_bin_data *pData = a->pData;
+    ambi_bin_renderState* state = a->state;
+    int band;
+    const float_complex calpha = cmplxf(1.0f,0.0f), cbeta = cmplxf(0.0f, 0.0f);
+
+    for(band = start; band < end; band++) {
+        /* Bake the rotation into the decoding matrix */
+        if(a->bakeRot){
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, a->nSH, a->nSH, &calpha,
+                        state->M_dec[band], MAX_NUM_SH_SIGNALS,
+                        pData->M_rot, MAX_NUM_SH_SIGNALS, &cbeta,
+                        state->M_dec_rot[band], MAX_NUM_SH_SIGNALS);
+        }
+
+        /* Apply the decoder to go from SH input to binaural output */
+        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, TIME_SLOTS, a->nSH, &calpha,
+                    a->enableRot ? state->M_dec_rot[band] : state->M_dec[band], MAX_NUM_SH_SIGNALS,
+                    FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS_STRIDE, &cbeta,
+                    FLATTEN2D(pData->binframeTF[band]), TIME_SLOTS_STRIDE);
+    }
+}
+
+/** Processes one frame of #AMBI_BIN_FRAME_SIZE samples (see ambi_bin_process()) */
+static void ambi_bin_processFrame
 (
     void        *  const hAmbi,
     const float *const * inputs,
@@ -410,9 +513,9 @@ void ambi_bin_process
 )
 {
     ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
-    ambi_bin_codecPars* pars = pData->pars;
-    int ch, i, j, band;
-    const float_complex calpha = cmplxf(1.0f,0.0f), cbeta = cmplxf(0.0f, 0.0f);
+    ambi_bin_renderState* state;
+    ambi_bin_bandArgs bandArgs;
+    int ch, i, j;
     float Rxyz[3][3];
     float M_rot_tmp[MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS];
     
@@ -422,13 +525,15 @@ void ambi_bin_process
     CH_ORDER chOrdering;
     norm = pData->norm;
     chOrdering = pData->chOrdering;
-    order = pData->order;
-    nSH = (order+1)*(order+1);
     enableRot = pData->enableRotation;
 
+    /* The current render state remains valid (and untouched by ambi_bin_initCodec()) until it is released */
+    state = (ambi_bin_renderState*)saf_stateSwap_acquire(pData->hStateSwap);
+
     /* Process frame */
-    if (nSamples == AMBI_BIN_FRAME_SIZE && (pData->codecStatus == CODEC_STATUS_INITIALISED) ) {
-        pData->procStatus = PROC_STATUS_ONGOING;
+    if (nSamples == AMBI_BIN_FRAME_SIZE && state!=NULL) {
+        order = state->order;
+        nSH = state->nSH;
 
         /* Load time-domain data */
         for(i=0; i < SAF_MIN(nSH, nInputs); i++)
@@ -439,23 +544,28 @@ void ambi_bin_process
         /* account for channel order convention */
         switch(chOrdering){
             case CH_ACN:  /* already in ACN, do nothing */ break; /* Otherwise, convert to ACN... */
-            case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHFrameTD), order, AMBI_BIN_FRAME_SIZE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
+            case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHFrameTD), order, AMBI_BIN_FRAME_STRIDE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
         }
 
         /* account for input normalisation scheme */
         switch(norm){
             case NORM_N3D:  /* already in N3D, do nothing */ break; /* Otherwise, convert to N3D... */
-            case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHFrameTD), order, AMBI_BIN_FRAME_SIZE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
-            case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHFrameTD), order, AMBI_BIN_FRAME_SIZE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
+            case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHFrameTD), order, AMBI_BIN_FRAME_STRIDE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
+            case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHFrameTD), order, AMBI_BIN_FRAME_STRIDE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
         }
 
         /* Apply time-frequency transform (TFT) */
-        afSTFT_forward_knownDimensions(pData->hSTFT, pData->SHFrameTD, AMBI_BIN_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS, pData->SHframeTF);
+        afSTFT_forward_knownDimensions(state->hSTFT, pData->SHFrameTD, AMBI_BIN_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS_STRIDE, pData->SHframeTF);
 
         /* Main processing: */
+        bandArgs.pData = pData;
+        bandArgs.state = state;
+        bandArgs.nSH = nSH;
+        bandArgs.enableRot = enableRot;
+        bandArgs.bakeRot = 0;
         if(order > 0 && enableRot) {
             /* Apply rotation */
-            if(pData->recalc_M_rotFLAG){
+            if(pData->recalc_M_rotFLAG || state->bakeRotFLAG){
                 /* Compute the new SH rotation matrix */
                 memset(pData->M_rot, 0, MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS*sizeof(float_complex));
                 yawPitchRoll2Rzyx(pData->yaw, pData->pitch, pData->roll, pData->useRollPitchYawFlag, Rxyz);
@@ -464,27 +574,18 @@ void ambi_bin_process
                     for (j = 0; j < nSH; j++)
                         pData->M_rot[i][j] = cmplxf(M_rot_tmp[i*nSH + j], 0.0f);
 
-                /* Bake the rotation into the decoding matrix */
-                for(band = 0; band < HYBRID_BANDS; band++) {
-                    cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, nSH, nSH, &calpha,
-                                pars->M_dec[band], MAX_NUM_SH_SIGNALS,
-                                pData->M_rot, MAX_NUM_SH_SIGNALS, &cbeta,
-                                pars->M_dec_rot[band], MAX_NUM_SH_SIGNALS);
-                }
+                /* (which is baked into the decoding matrices below) */
+                bandArgs.bakeRot = 1;
                 pData->recalc_M_rotFLAG = 0;
+                state->bakeRotFLAG = 0;
             }
         }
 
-        /* Apply the decoder to go from SH input to binaural output */
-        for(band = 0; band < HYBRID_BANDS; band++) {
-            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, TIME_SLOTS, nSH, &calpha,
-                        enableRot ? pars->M_dec_rot[band] : pars->M_dec[band], MAX_NUM_SH_SIGNALS,
-                        FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS, &cbeta,
-                        FLATTEN2D(pData->binframeTF[band]), TIME_SLOTS);
-        }
+        /* Apply the decoder to go from SH input to binaural output, with the bands split across the thread pool */
+        saf_threadPool_parallelFor(state->hThreadPool, HYBRID_BANDS, ambi_bin_processBands, (void*)&bandArgs);
 
         /* inverse-TFT */
-        afSTFT_backward_knownDimensions(pData->hSTFT, pData->binframeTF, AMBI_BIN_FRAME_SIZE, NUM_EARS, TIME_SLOTS, pData->binFrameTD);
+        afSTFT_backward_knownDimensions(state->hSTFT, pData->binframeTF, AMBI_BIN_FRAME_SIZE, NUM_EARS, TIME_SLOTS_STRIDE, pData->binFrameTD);
 
         /* Copy to output */
         for (ch = 0; ch < SAF_MIN(NUM_EARS, nOutputs); ch++)
@@ -496,7 +597,23 @@ void ambi_bin_process
         for (ch=0; ch < nOutputs; ch++)
             memset(outputs[ch],0, AMBI_BIN_FRAME_SIZE*sizeof(float));
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void ambi_bin_process
+(
+    void        *  const hAmbi,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
+
+    /* Process the host buffers in frames of #AMBI_BIN_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, ambi_bin_processFrame, hAmbi);
 }
 
 
@@ -505,7 +622,7 @@ void ambi_bin_process
 void ambi_bin_refreshParams(void* const hAmbi)
 {
     ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
-    pData->reinit_hrtfsFLAG = 1;
+    saf_atomic_store(&(pData->reinit_hrtfsFLAG), 1);
     ambi_bin_setCodecStatus(hAmbi, CODEC_STATUS_NOT_INITIALISED);
 }
 
@@ -662,6 +779,16 @@ void ambi_bin_setRPYflag(void* const hAmbi, int newState)
     pData->useRollPitchYawFlag = newState;
 }
 
+void ambi_bin_setNumThreads(void* const hAmbi, int newValue)
+{
+    ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
+    newValue = SAF_CLAMP(newValue, 1, SAF_THREADPOOL_MAX_NUM_FOR_JOBS+1);
+    if(pData->new_nThreads != newValue){
+        pData->new_nThreads = newValue;
+        ambi_bin_setCodecStatus(hAmbi, CODEC_STATUS_NOT_INITIALISED);
+    }
+}
+
 
 /* Get Functions */
 
@@ -673,7 +800,7 @@ int ambi_bin_getFrameSize(void)
 CODEC_STATUS ambi_bin_getCodecStatus(void* const hAmbi)
 {
     ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float ambi_bin_getProgressBar0_1(void* const hAmbi)
@@ -838,7 +965,14 @@ int ambi_bin_getDAWsamplerate(void* const hAmbi)
     return pData->fs;
 }
 
-int ambi_bin_getProcessingDelay()
+int ambi_bin_getNumThreads(void* const hAmbi)
 {
-    return 12*HOP_SIZE;
+    ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
+    return pData->new_nThreads;
+}
+
+int ambi_bin_getProcessingDelay(void* const hAmbi)
+{
+    ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
+    return 12*HOP_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
@@ -51,10 +51,33 @@
 void ambi_bin_setCodecStatus(void* const hAmbi, CODEC_STATUS newStatus)
 {
     ambi_bin_data *pData = (ambi_bin_data*)(hAmbi);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next ambi_bin_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void ambi_bin_createRenderState(ambi_bin_renderState** const pState)
+{
+    ambi_bin_renderState* state = (ambi_bin_renderState*)malloc1d(sizeof(ambi_bin_renderState));
+    *pState = state;
+
+    state->order = state->nSH = 0;
+    state->hSTFT = NULL;
+    state->hThreadPool = NULL;
+    memset(state->M_dec, 0, HYBRID_BANDS*NUM_EARS*MAX_NUM_SH_SIGNALS*sizeof(float_complex));
+    memset(state->M_dec_rot, 0, HYBRID_BANDS*NUM_EARS*MAX_NUM_SH_SIGNALS*sizeof(float_complex));
+    state->bakeRotFLAG = 1;
+}
+
+void ambi_bin_destroyRenderState(ambi_bin_renderState** const pState)
+{
+    ambi_bin_renderState* state = *pState;
+
+    if(state!=NULL){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        free(state);
+        state = NULL;
+        *pState = NULL;
     }
-    pData->codecStatus = newStatus;
 }
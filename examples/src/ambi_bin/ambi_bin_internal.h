@@ -70,6 +70,8 @@ extern "C" {
 #define HOP_SIZE ( 128 )                              /**< STFT hop size */
 #define HYBRID_BANDS ( HOP_SIZE + 5 )                 /**< Number of frequency bands */
 #define TIME_SLOTS ( AMBI_BIN_FRAME_SIZE / HOP_SIZE ) /**< Number of STFT timeslots */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
+#define AMBI_BIN_FRAME_STRIDE ( (int)md_alignedStride(AMBI_BIN_FRAME_SIZE, sizeof(float)) ) /**< Distance between the rows of the time-domain frames (#AMBI_BIN_FRAME_SIZE, padded to whole cache lines) */
 #define POST_GAIN ( -9.0f )                           /**< Post-gain scaling, in dB */
 
 /* Checks: */
@@ -82,13 +84,29 @@ extern "C" {
 /*                                 Structures                                 */
 /* ========================================================================== */
 
-/** Contains variables for sofa file loading, HRIRs, and the binaural decoder */
-typedef struct _ambi_bin_codecPars
+/**
+ * Everything that ambi_bin_processFrame() needs from an initialisation
+ *
+ * A new render state is built by ambi_bin_initCodec() (while the audio thread
+ * keeps rendering with the current one), and then handed over to the audio
+ * thread via a saf_stateSwap. Once published, only the audio thread may touch
+ * it, until it is handed back by the next initialisation.
+ */
+typedef struct _ambi_bin_renderState
 {
-    /* Decoder */
+    int order;                      /**< decoding order */
+    int nSH;                        /**< number of spherical harmonic signals */
+    void* hSTFT;                    /**< afSTFT handle (passed on to the next render state, if it has the same number of channels) */
+    void* hThreadPool;              /**< saf_threadPool handle (owned by ambi_bin_data); NULL if nThreads==1 */
     float_complex M_dec[HYBRID_BANDS][NUM_EARS][MAX_NUM_SH_SIGNALS];     /**< Decoding matrix per band*/
     float_complex M_dec_rot[HYBRID_BANDS][NUM_EARS][MAX_NUM_SH_SIGNALS]; /**< Decording matrix per band, with sound-field rotation baked-in */
-    
+    int bakeRotFLAG;                /**< 1: the rotation is yet to be baked into M_dec_rot, 0: M_dec_rot is up-to-date */
+
+}ambi_bin_renderState;
+
+/** Contains variables for sofa file loading, HRIRs, and the binaural decoder */
+typedef struct _ambi_bin_codecPars
+{
     /* sofa file info */
     char* sofa_filepath;    /**< absolute/relevative file path for a sofa file */
     float* hrirs;           /**< time domain HRIRs; FLAT: N_hrir_dirs x 2 x hrir_len */
@@ -113,33 +131,38 @@ typedef struct _ambi_bin_codecPars
 typedef struct _ambi_bin
 {
     /* audio buffers + afSTFT time-frequency transform handle */
+    void* hBlockAdapter;            /**< Block adapter handle (for arbitrary host block sizes) */
     int fs;                         /**< host sampling rate */ 
     float** SHFrameTD;              /**< Input spherical harmonic (SH) signals in the time-domain; #MAX_NUM_SH_SIGNALS x #AMBI_BIN_FRAME_SIZE */
     float** binFrameTD;             /**< Output binaural signals in the time-domain; #NUM_EARS x #AMBI_BIN_FRAME_SIZE */
     float_complex*** SHframeTF;     /**< Input spherical harmonic (SH) signals in the time-frequency domain; #HYBRID_BANDS x #MAX_NUM_SH_SIGNALS x #TIME_SLOTS */
     float_complex*** binframeTF;    /**< Output binaural signals in the time-frequency domain; #HYBRID_BANDS x #NUM_EARS x #TIME_SLOTS */
-    void* hSTFT;                    /**< afSTFT handle */
     int afSTFTdelay;                /**< for host delay compensation */
     float freqVector[HYBRID_BANDS]; /**< frequency vector for time-frequency transform, in Hz */
      
     /* our codec configuration */
-    CODEC_STATUS codecStatus;       /**< see #CODEC_STATUS */
+    volatile long codecStatus;      /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;         /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;           /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;          /**< Current (re)initialisation step, string */
     ambi_bin_codecPars* pars;       /**< Decoding specific data */
+    void* hStateSwap;               /**< saf_stateSwap handle, via which new render states are handed over to the audio thread */
+    ambi_bin_renderState* liveState;  /**< The last published render state (or NULL); read-only, until it is handed back */
+    ambi_bin_renderState* spareState; /**< The previous render state (or NULL), in which the next one is built */
     
     /* internal variables */
-    PROC_STATUS procStatus;         /**< see #PROC_STATUS */
     float_complex M_rot[MAX_NUM_SH_SIGNALS][MAX_NUM_SH_SIGNALS]; /**< Current SH rotation matrix */
     int new_order;                  /**< new decoding order (current value will be replaced by this after next re-init) */
-    int nSH;                        /**< number of spherical harmonic signals */
+    int nSH;                        /**< number of spherical harmonic signals of the last built render state */
+    int new_nThreads;               /**< new number of threads (current value will be replaced by this after next re-init) */
+    void* hThreadPool;              /**< saf_threadPool handle, across which the frequency bands are processed (NULL if nThreads==1) */
     
     /* flags */ 
     int recalc_M_rotFLAG;           /**< 0: no init required, 1: init required */
-    int reinit_hrtfsFLAG;           /**< 0: no init required, 1: init required */
+    volatile long reinit_hrtfsFLAG; /**< 0: no init required, 1: init required (only accessed via the saf_atomic functions) */
     
     /* user parameters */
-    int order;                      /**< current decoding order */
+    int order;                      /**< decoding order of the last built render state */
     int enableMaxRE;                /**< 0: disabled, 1: enabled */
     int enableDiffuseMatching;      /**< 0: disabled, 1: enabled */
     int enableTruncationEQ;         /**< 0: disabled, 1: enabled */
@@ -157,6 +180,7 @@ typedef struct _ambi_bin
     int bFlipPitch;                 /**< flag to flip the sign of the pitch rotation angle */
     int bFlipRoll;                  /**< flag to flip the sign of the roll rotation angle */
     int useRollPitchYawFlag;        /**< rotation order flag, 1: r-p-y, 0: y-p-r */
+    int nThreads;                   /**< Number of threads processing the frequency bands (including the host thread) */
     
 } ambi_bin_data;
 
@@ -169,6 +193,12 @@ typedef struct _ambi_bin
 void ambi_bin_setCodecStatus(void* const hAmbi,
                              CODEC_STATUS newStatus);
 
+/** Creates an (empty) render state; see #ambi_bin_renderState */
+void ambi_bin_createRenderState(ambi_bin_renderState** const pState);
+
+/** Destroys a render state (if not NULL) */
+void ambi_bin_destroyRenderState(ambi_bin_renderState** const pState);
+
 
 #ifdef __cplusplus
 } /* extern "C" { */
@@ -52,7 +52,7 @@ void ambi_dec_create
 {
     ambi_dec_data* pData = (ambi_dec_data*)malloc1d(sizeof(ambi_dec_data));
     *phAmbi = (void*)pData;
-    int i, j, ch, band;
+    int i, j, band;
 
     /* default user parameters */
     loadLoudspeakerArrayPreset(LOUDSPEAKER_ARRAY_PRESET_T_DESIGN_24, pData->loudpkrs_dirs_deg, &(pData->new_nLoudpkrs), &(pData->loudpkrs_nDims));
@@ -74,46 +74,46 @@ void ambi_dec_create
     
     /* afSTFT stuff and audio buffers */
     pData->fs = 48000.0f;
-    pData->hSTFT = NULL; 
-    pData->SHFrameTD = (float**)malloc2d(MAX_NUM_SH_SIGNALS, AMBI_DEC_FRAME_SIZE, sizeof(float));
-    pData->outputFrameTD = (float**)malloc2d(SAF_MAX(MAX_NUM_LOUDSPEAKERS, NUM_EARS), AMBI_DEC_FRAME_SIZE, sizeof(float));
-    pData->SHframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
-    pData->outputframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_LOUDSPEAKERS, TIME_SLOTS, sizeof(float_complex));
-    pData->binframeTF = (float_complex***)malloc3d(HYBRID_BANDS, NUM_EARS, TIME_SLOTS, sizeof(float_complex));
+    pData->SHFrameTD = (float**)calloc2d_aligned(MAX_NUM_SH_SIGNALS, AMBI_DEC_FRAME_SIZE, sizeof(float));
+    pData->outputFrameTD = (float**)malloc2d_aligned(SAF_MAX(MAX_NUM_LOUDSPEAKERS, NUM_EARS), AMBI_DEC_FRAME_SIZE, sizeof(float));
+    pData->SHframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
+    pData->outputframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_LOUDSPEAKERS, TIME_SLOTS, sizeof(float_complex));
+    pData->binframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, NUM_EARS, TIME_SLOTS, sizeof(float_complex));
     
     /* codec data */
     pData->progressBar0_1 = 0.0f;
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
-    pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
     pData->pars = (ambi_dec_codecPars*)malloc1d(sizeof(ambi_dec_codecPars));
     ambi_dec_codecPars* pars = pData->pars;
     for (i=0; i<NUM_DECODERS; i++){
         for(j=0; j<MAX_SH_ORDER; j++){
             pars->M_dec[i][j] = NULL;
-            pars->M_dec_cmplx[i][j] = NULL;
             pars->M_dec_maxrE[i][j] = NULL;
-            pars->M_dec_cmplx_maxrE[i][j] = NULL;
         }
     }
     pars->sofa_filepath = NULL;
     pars->hrirs = NULL;
     pars->hrir_dirs_deg = NULL;
-    pars->hrtf_vbap_gtableIdx = NULL;
-    pars->hrtf_vbap_gtableComp = NULL;
-    pars->itds_s = NULL;
     pars->hrtf_fb = NULL;
-    pars->hrtf_fb_mag = NULL;
     pars->weights = NULL;
     
+    /* render states are built by ambi_dec_initCodec() */
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
+    
     /* internal parameters */ 
     pData->binauraliseLS = pData->new_binauraliseLS = 0;
+    pData->nThreads = pData->new_nThreads = 1;
+    pData->hThreadPool = NULL;
     
     /* flags */
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
+    pData->initLock = 0;
     pData->reinit_hrtfsFLAG = 1;
-    for(ch=0; ch<MAX_NUM_LOUDSPEAKERS; ch++)
-        pData->recalc_hrtf_interpFLAG[ch] = 1;
+
+    /* for passing arbitrary host block sizes through ambi_dec_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), AMBI_DEC_FRAME_SIZE, MAX_NUM_SH_SIGNALS, MAX_NUM_LOUDSPEAKERS);
 }
 
 void ambi_dec_destroy
@@ -123,44 +123,44 @@ void ambi_dec_destroy
 {
     ambi_dec_data *pData = (ambi_dec_data*)(*phAmbi);
     ambi_dec_codecPars *pars;
+    ambi_dec_renderState *state;
     int i, j;
     
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
+        /* Wait for any on-going initialisation to complete, and then take back the current render state (which also
+         * waits for the processing loop to let go of it) */
+        saf_spinLock_lock(&(pData->initLock));
+        state = (ambi_dec_renderState*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(state==pData->liveState, "Unexpected render state");
+        ambi_dec_destroyRenderState(&state);
+        ambi_dec_destroyRenderState(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
         
-        /* free afSTFT and buffers */
-        if(pData->hSTFT!=NULL)
-            afSTFT_destroy(&(pData->hSTFT));
-        free(pData->SHFrameTD);
-        free(pData->outputFrameTD);
-        free(pData->SHframeTF);
-        free(pData->outputframeTF);
-        free(pData->binframeTF);
+        /* free buffers */
+        free2d_aligned((void**)pData->SHFrameTD);
+        free2d_aligned((void**)pData->outputFrameTD);
+        free3d_aligned((void***)pData->SHframeTF);
+        free3d_aligned((void***)pData->outputframeTF);
+        free3d_aligned((void***)pData->binframeTF);
 
         /* free codec data */
         pars = pData->pars;
-        free(pars->hrtf_vbap_gtableComp);
-        free(pars->hrtf_vbap_gtableIdx);
         free(pars->hrtf_fb);
-        free(pars->hrtf_fb_mag);
-        free(pars->itds_s);
-    free(pars->sofa_filepath);
+        free(pars->sofa_filepath);
         free(pars->hrirs);
         free(pars->hrir_dirs_deg);
         free(pars->weights);
         for (i=0; i<NUM_DECODERS; i++){
             for(j=0; j<MAX_SH_ORDER; j++){
                 free(pars->M_dec[i][j]);
-                free(pars->M_dec_cmplx[i][j]);
                 free(pars->M_dec_maxrE[i][j]);
-                free(pars->M_dec_cmplx_maxrE[i][j]);
             }
         }
+        free(pars);
         free(pData->progressBarText);
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
+        if(pData->hThreadPool!=NULL)
+            saf_threadPool_destroy(&(pData->hThreadPool));
         free(pData);
         pData = NULL;
         *phAmbi = NULL;
@@ -170,14 +170,18 @@ void ambi_dec_destroy
 void ambi_dec_init
 (
     void * const hAmbi,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
 
     /* define frequency vector */
     pData->fs = sampleRate;
-    afSTFT_getCentreFreqs(pData->hSTFT, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
+    afSTFT_getCentreFreqs(NULL, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
 void ambi_dec_initCodec
@@ -187,46 +191,80 @@ void ambi_dec_initCodec
 {
     ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
     ambi_dec_codecPars* pars = pData->pars;
-    int i, ch, d, j, n, ng, nGrid_dirs, masterOrder, nSH_order, max_nSH, nLoudspeakers;
-    float* grid_dirs_deg, *Y, *M_dec_tmp, *g, *a, *e, *a_n, *hrtf_vbap_gtable;;
+    ambi_dec_renderState* state, *live;
+    void* hPrevThreadPool;
+    int i, ch, d, j, n, ng, nGrid_dirs, masterOrder, nSH_order, max_nSH, nLoudspeakers, nOutputs, reinitHRTFs;
+    float* grid_dirs_deg, *Y, *M_dec_tmp, *g, *a, *e, *a_n;
     float a_avg[MAX_SH_ORDER], e_avg[MAX_SH_ORDER], azi_incl[2], sum_elev;
-#ifdef SAF_ENABLE_SOFA_READER_MODULE
-    SAF_SOFA_ERROR_CODES error;
-    saf_sofa_container sofa;
-#endif
     
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
+
+    /* Take (and clear) the HRTF flag now, such that a refresh requested during this initialisation is not lost */
+    reinitHRTFs = saf_atomic_compareExchange(&(pData->reinit_hrtfsFLAG), 1, 0);
     
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Initialising");
     pData->progressBar0_1 = 0.0f;
+
+    /* The new render state is built in the spare one, while the audio thread keeps rendering with the current one */
+    if(pData->spareState==NULL)
+        ambi_dec_createRenderState(&(pData->spareState));
+    state = pData->spareState;
+
+    /* Release the previous decoding matrices and HRTF tables of the spare render state all at once (the memory is
+     * re-used) */
+    saf_arena_reset(state->hArena);
+    for(d=0; d<NUM_DECODERS; d++){
+        for(n=0; n<MAX_SH_ORDER; n++){
+            state->M_dec_cmplx[d][n] = NULL;
+            state->M_dec_cmplx_maxrE[d][n] = NULL;
+        }
+    }
+
+    /* (Re)create the thread pool, with one thread fewer, since the host thread also processes bands (the previous pool
+     * is only destroyed once the audio thread has switched over to the new render state) */
+    hPrevThreadPool = NULL;
+    if(pData->new_nThreads != pData->nThreads){
+        hPrevThreadPool = pData->hThreadPool;
+        pData->hThreadPool = NULL;
+        if(pData->new_nThreads>1)
+            saf_threadPool_create(&(pData->hThreadPool), pData->new_nThreads-1);
+        pData->nThreads = pData->new_nThreads;
+    }
+    state->hThreadPool = pData->hThreadPool;
     
-    /* reinit afSTFT */
+    /* (Re)Initialise afSTFT. If the number of channels is unchanged, then the filterbank currently in use is passed on
+     * to the new render state, so that its buffered signals carry over and the audio continues seamlessly */
     masterOrder = pData->new_masterOrder;
     max_nSH = (masterOrder+1)*(masterOrder+1);
     nLoudspeakers = pData->new_nLoudpkrs;
-    if(pData->hSTFT==NULL){
-        if(pData->new_binauraliseLS)
-            afSTFT_create(&(pData->hSTFT), max_nSH, NUM_EARS, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-        else
-            afSTFT_create(&(pData->hSTFT), max_nSH, nLoudspeakers, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-        afSTFT_clearBuffers(pData->hSTFT);
+    nOutputs = pData->new_binauraliseLS ? NUM_EARS : nLoudspeakers;
+    live = pData->liveState;
+    if(live!=NULL && live->masterOrder == masterOrder && (live->binauraliseLS ? NUM_EARS : live->nLoudpkrs) == nOutputs){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        state->hSTFT = live->hSTFT;
     }
-    else{
-        if(pData->new_binauraliseLS)
-            afSTFT_channelChange(pData->hSTFT, max_nSH, NUM_EARS);
-        else
-            afSTFT_channelChange(pData->hSTFT, max_nSH, nLoudspeakers);
-        afSTFT_clearBuffers(pData->hSTFT);
+    else if(state->hSTFT==NULL)
+        afSTFT_create(&(state->hSTFT), max_nSH, nOutputs, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    else {
+        if(state->masterOrder != masterOrder || (state->binauraliseLS ? NUM_EARS : state->nLoudpkrs) != nOutputs) /* Change the number of channels */
+            afSTFT_channelChange(state->hSTFT, max_nSH, nOutputs);
+        afSTFT_clearBuffers(state->hSTFT); /* (the spare state still holds the signals from when it was last used) */
     }
-    pData->binauraliseLS = pData->new_binauraliseLS;
+    state->masterOrder = masterOrder;
+    state->nLoudpkrs = nLoudspeakers;
+    state->binauraliseLS = pData->new_binauraliseLS;
+    for(ch=0; ch < nLoudspeakers; ch++)
+        for(i=0; i<2; i++)
+            state->loudpkrs_dirs_deg[ch][i] = pData->loudpkrs_dirs_deg[ch][i];
+    pData->binauraliseLS = state->binauraliseLS;
     pData->nLoudpkrs = nLoudspeakers;
     
     /* Quick and dirty check to find loudspeaker dimensionality */
@@ -280,12 +318,11 @@ void ambi_dec_initCodec
             nSH_order = (n+1)*(n+1);
             free(pars->M_dec[d][n-1]);
             pars->M_dec[d][n-1] = malloc1d(nLoudspeakers* nSH_order * sizeof(float));
-            free(pars->M_dec_cmplx[d][n-1]);
-            pars->M_dec_cmplx[d][n-1] = malloc1d(nLoudspeakers * nSH_order * sizeof(float_complex));
+            state->M_dec_cmplx[d][n-1] = saf_arena_malloc1d(state->hArena, nLoudspeakers * nSH_order * sizeof(float_complex));
             for(i=0; i<nLoudspeakers; i++){
                 for(j=0; j<nSH_order; j++){
                     pars->M_dec[d][n-1][i*nSH_order+j] = M_dec_tmp[i*max_nSH +j]; /* for applying in the time domain, and... */
-                    pars->M_dec_cmplx[d][n-1][i*nSH_order+j] = cmplxf(pars->M_dec[d][n-1][i*nSH_order+j], 0.0f); /* for the time-frequency domain */
+                    state->M_dec_cmplx[d][n-1][i*nSH_order+j] = cmplxf(pars->M_dec[d][n-1][i*nSH_order+j], 0.0f); /* for the time-frequency domain */
                 }
             }
             
@@ -294,14 +331,13 @@ void ambi_dec_initCodec
             getMaxREweights(n, 1, a_n); /* weights returned as diagonal matrix */
             free(pars->M_dec_maxrE[d][n-1]);
             pars->M_dec_maxrE[d][n-1] = malloc1d(nLoudspeakers * nSH_order * sizeof(float));
-            free(pars->M_dec_cmplx_maxrE[d][n-1]);
-            pars->M_dec_cmplx_maxrE[d][n-1] = malloc1d(nLoudspeakers * nSH_order * sizeof(float_complex));
+            state->M_dec_cmplx_maxrE[d][n-1] = saf_arena_malloc1d(state->hArena, nLoudspeakers * nSH_order * sizeof(float_complex));
             cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nLoudspeakers, nSH_order, nSH_order, 1.0f,
                         pars->M_dec[d][n-1], nSH_order,
                         a_n, nSH_order, 0.0f,
                         pars->M_dec_maxrE[d][n-1], nSH_order); /* for applying in the time domain */
             for(i=0; i<nLoudspeakers * nSH_order; i++)
-                pars->M_dec_cmplx_maxrE[d][n-1][i] = cmplxf(pars->M_dec_maxrE[d][n-1][i], 0.0f); /* for the time-frequency domain */
+                state->M_dec_cmplx_maxrE[d][n-1][i] = cmplxf(pars->M_dec_maxrE[d][n-1][i], 0.0f); /* for the time-frequency domain */
             
             /* fire a plane-wave from each grid direction to find the total energy/amplitude (using non-maxrE weighted versions) */
             Y = malloc1d(nSH_order*sizeof(float));
@@ -329,144 +365,119 @@ void ambi_dec_initCodec
             }
             a_avg[n-1] /= (float)nGrid_dirs;
             e_avg[n-1] /= (float)nGrid_dirs;
-            pars->M_norm[d][n-1][0] = 1.0f/(a_avg[n-1]+2.23e-6f); /* use this to preserve omni amplitude */
-            pars->M_norm[d][n-1][1] = sqrtf(1.0f/(e_avg[n-1]+2.23e-6f));  /* use this to preserve omni energy */
+            state->M_norm[d][n-1][0] = 1.0f/(a_avg[n-1]+2.23e-6f); /* use this to preserve omni amplitude */
+            state->M_norm[d][n-1][1] = sqrtf(1.0f/(e_avg[n-1]+2.23e-6f));  /* use this to preserve omni energy */
             free(a_n);
             free(Y);
             
             /* remove virtual loudspeakers from the decoder (if needed) */
             if (pData->loudpkrs_nDims == 2 && (pData->dec_method[0]==DECODING_METHOD_ALLRAD || pData->dec_method[1]==DECODING_METHOD_ALLRAD)){
-                pars->M_dec[d][n-1] = realloc1d(pars->M_dec[d][n-1], pData->nLoudpkrs * nSH_order * sizeof(float));
-                pars->M_dec_cmplx[d][n-1] = realloc1d(pars->M_dec_cmplx[d][n-1], pData->nLoudpkrs * nSH_order * sizeof(float_complex));
-                pars->M_dec_maxrE[d][n-1] = realloc1d(pars->M_dec_maxrE[d][n-1], pData->nLoudpkrs * nSH_order * sizeof(float));
-                pars->M_dec_cmplx_maxrE[d][n-1] = realloc1d(pars->M_dec_cmplx_maxrE[d][n-1], pData->nLoudpkrs * nSH_order * sizeof(float_complex));
+                pars->M_dec[d][n-1] = realloc1d(pars->M_dec[d][n-1], state->nLoudpkrs * nSH_order * sizeof(float));
+                pars->M_dec_maxrE[d][n-1] = realloc1d(pars->M_dec_maxrE[d][n-1], state->nLoudpkrs * nSH_order * sizeof(float));
+                /* (the complex versions are left as they are, since the rows of the real loudspeakers come first) */
             }
         }
         free(M_dec_tmp);
     }
     
-    /* update order */
-    pData->masterOrder = pData->new_masterOrder;
-    
-    /* Binaural-related initialisations */
-    if(pData->reinit_hrtfsFLAG){
-        strcpy(pData->progressBarText,"Computing VBAP gain table");
-        pData->progressBar0_1 = 0.4f;
-        
-        /* load sofa file or load default hrir data */
-#ifdef SAF_ENABLE_SOFA_READER_MODULE
-        if(!pData->useDefaultHRIRsFLAG && pars->sofa_filepath!=NULL){
-            /* Load SOFA file */ 
-            error = saf_sofa_open(&sofa, pars->sofa_filepath, SAF_SOFA_READER_OPTION_DEFAULT);
-
-            /* Load defaults instead */
-            if(error!=SAF_SOFA_OK || sofa.nReceivers!=NUM_EARS){
-                pData->useDefaultHRIRsFLAG = 1;
-                saf_print_warning("Unable to load the specified SOFA file, or it contained something other than 2 channels. Using default HRIR data instead.");
-            }
-            else{
-                /* Copy SOFA data */
-                pars->hrir_fs = (int)sofa.DataSamplingRate;
-                pars->hrir_len = sofa.DataLengthIR;
-                pars->N_hrir_dirs = sofa.nSources;
-                pars->hrirs = realloc1d(pars->hrirs, pars->N_hrir_dirs*NUM_EARS*(pars->hrir_len)*sizeof(float));
-                memcpy(pars->hrirs, sofa.DataIR, pars->N_hrir_dirs*NUM_EARS*(pars->hrir_len)*sizeof(float));
-                pars->hrir_dirs_deg = realloc1d(pars->hrir_dirs_deg, pars->N_hrir_dirs*2*sizeof(float));
-                cblas_scopy(pars->N_hrir_dirs, sofa.SourcePosition, 3, pars->hrir_dirs_deg, 2); /* azi */
-                cblas_scopy(pars->N_hrir_dirs, &sofa.SourcePosition[1], 3, &pars->hrir_dirs_deg[1], 2); /* elev */
-            }
+    /* Binaural-related initialisations (the HRTF interpolation tables are otherwise carried over from the current
+     * render state) */
+    if(reinitHRTFs || live==NULL)
+        ambi_dec_initHRTFs(hAmbi, state);
+    else
+        ambi_dec_copyHRTFs(state, live);
+    state->reinterpFLAG = 1;
+
+    /* Hand the new render state over to the audio thread, and keep the previous one as the spare, once it is no longer
+     * being used */
+    pData->spareState = (ambi_dec_renderState*)saf_stateSwap_publish(pData->hStateSwap, (void*)state);
+    pData->liveState = state;
+    if(pData->spareState!=NULL && pData->spareState->hSTFT == state->hSTFT)
+        pData->spareState->hSTFT = NULL; /* (passed on to the new render state) */
+    if(hPrevThreadPool!=NULL)
+        saf_threadPool_destroy(&hPrevThreadPool);
 
-            /* Clean-up */
-            saf_sofa_close(&sofa);
-        }
-#else
-        pData->useDefaultHRIRsFLAG = 1; /* Can only load the default HRIR data */
-#endif
-        if(pData->useDefaultHRIRsFLAG){
-            /* Copy default HRIR data */
-            pars->hrir_fs = __default_hrir_fs;
-            pars->hrir_len = __default_hrir_len;
-            pars->N_hrir_dirs = __default_N_hrir_dirs;
-            pars->hrirs = realloc1d(pars->hrirs, pars->N_hrir_dirs*NUM_EARS*(pars->hrir_len)*sizeof(float));
-            memcpy(pars->hrirs, (float*)__default_hrirs, pars->N_hrir_dirs*NUM_EARS*(pars->hrir_len)*sizeof(float));
-            pars->hrir_dirs_deg = realloc1d(pars->hrir_dirs_deg, pars->N_hrir_dirs*2*sizeof(float));
-            memcpy(pars->hrir_dirs_deg, (float*)__default_hrir_dirs_deg, pars->N_hrir_dirs*2*sizeof(float));
-        }
-        
-        /* estimate the ITDs for each HRIR */
-        pars->itds_s = realloc1d(pars->itds_s, pars->N_hrir_dirs*sizeof(float));
-        estimateITDs(pars->hrirs, pars->N_hrir_dirs, pars->hrir_len, pars->hrir_fs, pars->itds_s);
-        
-        /* generate VBAP gain table for the hrir_dirs */
-        hrtf_vbap_gtable = NULL;
-        pars->hrtf_vbapTableRes[0] = 2; /* azimuth resolution in degrees */
-        pars->hrtf_vbapTableRes[1] = 5; /* elevation resolution in degrees */
-        generateVBAPgainTable3D(pars->hrir_dirs_deg, pars->N_hrir_dirs, pars->hrtf_vbapTableRes[0], pars->hrtf_vbapTableRes[1], 1, 0, 0.0f,
-                                &hrtf_vbap_gtable, &(pars->N_hrtf_vbap_gtable), &(pars->hrtf_nTriangles));
-        if(hrtf_vbap_gtable==NULL){
-            /* if generating vbap gain tabled failed, re-calculate with default HRIR set (which is known to triangulate correctly) */
-            pData->useDefaultHRIRsFLAG = 1;
-            ambi_dec_initCodec(hAmbi);
-        }
-        
-        /* compress VBAP table (i.e. remove the zero elements) */
-        pars->hrtf_vbap_gtableComp = realloc1d(pars->hrtf_vbap_gtableComp, pars->N_hrtf_vbap_gtable * 3 * sizeof(float));
-        pars->hrtf_vbap_gtableIdx  = realloc1d(pars->hrtf_vbap_gtableIdx,  pars->N_hrtf_vbap_gtable * 3 * sizeof(int));
-        compressVBAPgainTable3D(hrtf_vbap_gtable, pars->N_hrtf_vbap_gtable, pars->N_hrir_dirs, pars->hrtf_vbap_gtableComp, pars->hrtf_vbap_gtableIdx);
-        
-        /* convert hrirs to filterbank coefficients */
-        strcpy(pData->progressBarText,"Preparing HRIRs");
-        pData->progressBar0_1 = 0.85f;
-        pars->hrtf_fb = realloc1d(pars->hrtf_fb, HYBRID_BANDS * NUM_EARS * (pars->N_hrir_dirs)*sizeof(float_complex));
-        HRIRs2HRTFs_afSTFT(pars->hrirs, pars->N_hrir_dirs, pars->hrir_len, HOP_SIZE, 0, 1, pars->hrtf_fb);
-        /* HRIR pre-processing */
-        if(pData->enableHRIRsPreProc){
-            /* get integration weights */
-            strcpy(pData->progressBarText,"Applying HRIR Pre-Processing");
-            pData->progressBar0_1 = 0.95f;
-            if(pars->N_hrir_dirs<=3600){
-                pars->weights = realloc1d(pars->weights, pars->N_hrir_dirs*sizeof(float));
-                //getVoronoiWeights(pars->hrir_dirs_deg, pars->N_hrir_dirs, 0, pars->weights);
-                float * hrir_dirs_rad = (float*) malloc1d(pars->N_hrir_dirs*2*sizeof(float));
-                memcpy(hrir_dirs_rad, pars->hrir_dirs_deg, pars->N_hrir_dirs*2*sizeof(float));
-                cblas_sscal(pars->N_hrir_dirs*2, SAF_PI/180.f, hrir_dirs_rad, 1);
-                sphElev2incl(hrir_dirs_rad, pars->N_hrir_dirs, 0, hrir_dirs_rad);
-                int supOrder = calculateGridWeights(hrir_dirs_rad, pars->N_hrir_dirs, -1, pars->weights);
-                if(supOrder < 1){
-                    saf_print_warning("Could not calculate grid weights");
-                    free(pars->weights);
-                    pars->weights = NULL;
-                }
-            }
-            else{
-                saf_print_warning("Too many grid points");
-                free(pars->weights);
-                pars->weights = NULL;
-            }
-            diffuseFieldEqualiseHRTFs(pars->N_hrir_dirs, pars->itds_s, pData->freqVector, HYBRID_BANDS, pars->weights, 1, 0, pars->hrtf_fb);
-        }
-        
-        /* calculate magnitude responses */
-        pars->hrtf_fb_mag = realloc1d(pars->hrtf_fb_mag, HYBRID_BANDS*NUM_EARS*(pars->N_hrir_dirs)*sizeof(float));
-        for(i=0; i<HYBRID_BANDS*NUM_EARS* (pars->N_hrir_dirs); i++)
-            pars->hrtf_fb_mag[i] = cabsf(pars->hrtf_fb[i]);
-        
-        /* clean-up */
-        free(hrtf_vbap_gtable);
-        pData->reinit_hrtfsFLAG = 0;
-    }
+    /* update order */
+    pData->masterOrder = masterOrder;
     
-    /* done! */
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
     
     free(g);
     free(a);
     free(e);
 }
 
-void ambi_dec_process
+/** Arguments for ambi_dec_processBands(), i.e. the local copies of the user parameters */
+typedef struct _ambi_dec_bandArgs {
+    ambi_dec_data* pData;
+    ambi_dec_renderState* state;
+    int masterOrder, nLoudspeakers, binauraliseLS;
+    float transitionFreq;
+    const int* orderPerBand;
+    const int* rE_WEIGHT;
+    const AMBI_DEC_DIFFUSE_FIELD_EQ_APPROACH* diffEQmode;
+} ambi_dec_bandArgs;
+
+/**
+ * Decodes (and optionally binauralises) frequency bands start..end-1 of the
+ * current frame (see saf_threadPool_parallelFor())
+ */
+static void ambi_dec_processBands
+(
+    void* arg,
+    int start,
+    int end
+)
+{
+    ambi_dec_bandArgs* a = (ambi_dec_bandArgs*)arg;
+    ambi_dec_data *pData = a->pData;
+    ambi_dec_renderState* state = a->state;
+    int ch, ear, band, orderBand, nSH_band, decIdx;
+    const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
+
+    for(band=start; band<end; band++){
+        orderBand = SAF_MAX(SAF_MIN(a->orderPerBand[band], a->masterOrder),1);
+        nSH_band = (orderBand+1)*(orderBand+1);
+
+        /* There is a different decoder for low (0) and high (1) frequencies, and for max_rE weights enabled/disabled */
+        decIdx = pData->freqVector[band] < a->transitionFreq ? 0 : 1;
+        if(a->rE_WEIGHT[decIdx]){
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, a->nLoudspeakers, TIME_SLOTS, nSH_band, &calpha,
+                        state->M_dec_cmplx_maxrE[decIdx][orderBand-1], nSH_band,
+                        FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS_STRIDE, &cbeta,
+                        FLATTEN2D(pData->outputframeTF[band]), TIME_SLOTS_STRIDE);
+        }
+        else{
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, a->nLoudspeakers, TIME_SLOTS, nSH_band, &calpha,
+                        state->M_dec_cmplx[decIdx][orderBand-1], nSH_band,
+                        FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS_STRIDE, &cbeta,
+                        FLATTEN2D(pData->outputframeTF[band]), TIME_SLOTS_STRIDE);
+        }
+
+        /* Apply scaling to preserve either the amplitude or energy when the decododing orders are different over frequency */
+        cblas_sscal(/*re+im*/2*a->nLoudspeakers*TIME_SLOTS_STRIDE, state->M_norm[decIdx][orderBand-1][a->diffEQmode[decIdx]==AMPLITUDE_PRESERVING ? 0 : 1],
+                    (float*)FLATTEN2D(pData->outputframeTF[band]), 1);
+
+        /* Binauralise the loudspeaker signals */
+        if(a->binauraliseLS){
+            /* Convolve each loudspeaker signal with the respective (interpolated) HRTF, and add it to the binaural buffer */
+            memset(FLATTEN2D(pData->binframeTF[band]), 0, NUM_EARS*TIME_SLOTS_STRIDE*sizeof(float_complex));
+            for (ch = 0; ch < a->nLoudspeakers; ch++)
+                for (ear = 0; ear < NUM_EARS; ear++)
+                    cblas_caxpy(TIME_SLOTS, &state->hrtf_interp[ch][band][ear], pData->outputframeTF[band][ch], 1, pData->binframeTF[band][ear], 1);
+
+            /* Scale by sqrt(number of loudspeakers) */
+            cblas_sscal(/*re+im*/2*NUM_EARS*TIME_SLOTS_STRIDE, 1.0f/sqrtf((float)a->nLoudspeakers), (float*)FLATTEN2D(pData->binframeTF[band]), 1);
+        }
+    }
+}
+
+/** Processes one frame of #AMBI_DEC_FRAME_SIZE samples (see ambi_dec_process()) */
+static void ambi_dec_processFrame
 (
     void        *  const hAmbi,
     const float *const * inputs,
@@ -477,9 +488,9 @@ void ambi_dec_process
 )
 {
     ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
-    ambi_dec_codecPars* pars = pData->pars;
-    int ch, ear, i, band, orderBand, nSH_band, decIdx, nSH;
-    const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
+    ambi_dec_renderState* state;
+    ambi_dec_bandArgs bandArgs;
+    int ch, i, nSH;
 
     /* local copies of user parameters */
     int nLoudspeakers, binauraliseLS, masterOrder;
@@ -488,20 +499,22 @@ void ambi_dec_process
     AMBI_DEC_DIFFUSE_FIELD_EQ_APPROACH diffEQmode[NUM_DECODERS];
     NORM_TYPES norm;
     CH_ORDER chOrdering;
-    masterOrder = pData->masterOrder;
-    nSH = ORDER2NSH(masterOrder);
-    nLoudspeakers = pData->nLoudpkrs;
     memcpy(orderPerBand, pData->orderPerBand, HYBRID_BANDS*sizeof(int));
     transitionFreq = pData->transitionFreq;
     memcpy(diffEQmode, pData->diffEQmode, NUM_DECODERS*sizeof(int));
-    binauraliseLS = pData->binauraliseLS;
     norm = pData->norm;
     chOrdering = pData->chOrdering;
     memcpy(rE_WEIGHT, pData->rE_WEIGHT, NUM_DECODERS*sizeof(int));
     
+    /* The current render state remains valid (and untouched by ambi_dec_initCodec()) until it is released */
+    state = (ambi_dec_renderState*)saf_stateSwap_acquire(pData->hStateSwap);
+
     /* Process frame */
-    if (nSamples == AMBI_DEC_FRAME_SIZE && (pData->codecStatus == CODEC_STATUS_INITIALISED) ) {
-        pData->procStatus = PROC_STATUS_ONGOING;
+    if (nSamples == AMBI_DEC_FRAME_SIZE && state!=NULL) {
+        masterOrder = state->masterOrder;
+        nSH = ORDER2NSH(masterOrder);
+        nLoudspeakers = state->nLoudpkrs;
+        binauraliseLS = state->binauraliseLS;
 
         /* Load time-domain data */
         for(i=0; i < SAF_MIN(nSH, nInputs); i++)
@@ -512,71 +525,42 @@ void ambi_dec_process
         /* account for channel order convention */
         switch(chOrdering){
             case CH_ACN: /* already ACN, do nothing */ break; /* Otherwise, convert to ACN... */
-            case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHFrameTD), masterOrder, AMBI_DEC_FRAME_SIZE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
+            case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHFrameTD), masterOrder, AMBI_DEC_FRAME_STRIDE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
         }
 
         /* account for input normalisation scheme */
         switch(norm){
             case NORM_N3D:  /* already in N3D, do nothing */ break; /* Otherwise, convert to N3D... */
-            case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHFrameTD), masterOrder, AMBI_DEC_FRAME_SIZE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
-            case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHFrameTD), masterOrder, AMBI_DEC_FRAME_SIZE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
+            case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHFrameTD), masterOrder, AMBI_DEC_FRAME_STRIDE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
+            case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHFrameTD), masterOrder, AMBI_DEC_FRAME_STRIDE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
         }
 
         /* Apply time-frequency transform (TFT) */
-        afSTFT_forward_knownDimensions(pData->hSTFT, pData->SHFrameTD, AMBI_DEC_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS, pData->SHframeTF);
-
-        /* Decode to loudspeaker set-up */
-        memset(FLATTEN3D(pData->outputframeTF), 0, HYBRID_BANDS*MAX_NUM_LOUDSPEAKERS*TIME_SLOTS*sizeof(float_complex));
-        for(band=0; band<HYBRID_BANDS; band++){
-            orderBand = SAF_MAX(SAF_MIN(orderPerBand[band], masterOrder),1);
-            nSH_band = (orderBand+1)*(orderBand+1);
-
-            /* There is a different decoder for low (0) and high (1) frequencies, and for max_rE weights enabled/disabled */
-            decIdx = pData->freqVector[band] < transitionFreq ? 0 : 1;
-            if(rE_WEIGHT[decIdx]){
-                cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nLoudspeakers, TIME_SLOTS, nSH_band, &calpha,
-                            pars->M_dec_cmplx_maxrE[decIdx][orderBand-1], nSH_band,
-                            FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS, &cbeta,
-                            FLATTEN2D(pData->outputframeTF[band]), TIME_SLOTS);
-            }
-            else{
-                cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nLoudspeakers, TIME_SLOTS, nSH_band, &calpha,
-                            pars->M_dec_cmplx[decIdx][orderBand-1], nSH_band,
-                            FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS, &cbeta,
-                            FLATTEN2D(pData->outputframeTF[band]), TIME_SLOTS);
-            }
+        afSTFT_forward_knownDimensions(state->hSTFT, pData->SHFrameTD, AMBI_DEC_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS_STRIDE, pData->SHframeTF);
 
-            /* Apply scaling to preserve either the amplitude or energy when the decododing orders are different over frequency */
-            cblas_sscal(/*re+im*/2*nLoudspeakers*TIME_SLOTS, pars->M_norm[decIdx][orderBand-1][diffEQmode[decIdx]==AMPLITUDE_PRESERVING ? 0 : 1],
-                        (float*)FLATTEN2D(pData->outputframeTF[band]), 1);
+        /* Interpolate the HRTFs for the loudspeaker directions (once, after switching to a new render state) */
+        if(binauraliseLS && state->reinterpFLAG){
+            for (ch = 0; ch < nLoudspeakers; ch++)
+                ambi_dec_interpHRTFs(hAmbi, state, state->loudpkrs_dirs_deg[ch][0], state->loudpkrs_dirs_deg[ch][1], state->hrtf_interp[ch]);
+            state->reinterpFLAG = 0;
         }
 
-        /* Binauralise the loudspeaker signals */
-        if(binauraliseLS){
-            /* Initialise the binaural buffer with zeros */
-            memset(FLATTEN3D(pData->binframeTF), 0, HYBRID_BANDS*NUM_EARS*TIME_SLOTS * sizeof(float_complex));
-
-            /* Convolve each loudspeaker signals with the respective HRTFs */
-            for (ch = 0; ch < nLoudspeakers; ch++) {
-                if(pData->recalc_hrtf_interpFLAG[ch]){
-                    /* Re-compute the interpolated HRTF (only if loudspeaker direction changed) */
-                    ambi_dec_interpHRTFs(hAmbi, pData->loudpkrs_dirs_deg[ch][0], pData->loudpkrs_dirs_deg[ch][1], pars->hrtf_interp[ch]);
-                    pData->recalc_hrtf_interpFLAG[ch] = 0;
-                }
-
-                /* Convolve this loudspeaker channel with the interpolated HRTF, and add it to the binaural buffer */
-                for (band = 0; band < HYBRID_BANDS; band++)
-                    for (ear = 0; ear < NUM_EARS; ear++)
-                        cblas_caxpy(TIME_SLOTS, &pars->hrtf_interp[ch][band][ear], pData->outputframeTF[band][ch], 1, pData->binframeTF[band][ear], 1);
-            }
-
-            /* Scale by sqrt(number of loudspeakers) */
-            cblas_sscal(/*re+im*/2*HYBRID_BANDS*NUM_EARS*TIME_SLOTS, 1.0f/sqrtf((float)nLoudspeakers), (float*)FLATTEN3D(pData->binframeTF), 1);
-        }
+        /* Decode to loudspeaker set-up (and binauralise), with the bands split across the thread pool */
+        memset(FLATTEN3D(pData->outputframeTF), 0, HYBRID_BANDS*MAX_NUM_LOUDSPEAKERS*TIME_SLOTS_STRIDE*sizeof(float_complex));
+        bandArgs.pData = pData;
+        bandArgs.state = state;
+        bandArgs.masterOrder = masterOrder;
+        bandArgs.nLoudspeakers = nLoudspeakers;
+        bandArgs.binauraliseLS = binauraliseLS;
+        bandArgs.transitionFreq = transitionFreq;
+        bandArgs.orderPerBand = orderPerBand;
+        bandArgs.rE_WEIGHT = rE_WEIGHT;
+        bandArgs.diffEQmode = diffEQmode;
+        saf_threadPool_parallelFor(state->hThreadPool, HYBRID_BANDS, ambi_dec_processBands, (void*)&bandArgs);
 
         /* inverse-TFT */
-        afSTFT_backward_knownDimensions(pData->hSTFT,        binauraliseLS ? pData->binframeTF : pData->outputframeTF,
-                                        AMBI_DEC_FRAME_SIZE, binauraliseLS ? NUM_EARS : MAX_NUM_LOUDSPEAKERS, TIME_SLOTS, pData->outputFrameTD);
+        afSTFT_backward_knownDimensions(state->hSTFT,        binauraliseLS ? pData->binframeTF : pData->outputframeTF,
+                                        AMBI_DEC_FRAME_SIZE, binauraliseLS ? NUM_EARS : MAX_NUM_LOUDSPEAKERS, TIME_SLOTS_STRIDE, pData->outputFrameTD);
 
         /* Copy to output buffer */
         for(ch = 0; ch < SAF_MIN(binauraliseLS==1 ? NUM_EARS : nLoudspeakers, nOutputs); ch++)
@@ -588,7 +572,23 @@ void ambi_dec_process
         for (ch=0; ch < nOutputs; ch++)
             memset(outputs[ch], 0, AMBI_DEC_FRAME_SIZE*sizeof(float));
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void ambi_dec_process
+(
+    void        *  const hAmbi,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
+
+    /* Process the host buffers in frames of #AMBI_DEC_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, ambi_dec_processFrame, hAmbi);
 }
 
 
@@ -597,10 +597,7 @@ void ambi_dec_process
 void ambi_dec_refreshSettings(void* const hAmbi)
 {
     ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
-    int ch;
-    for(ch=0; ch<MAX_NUM_LOUDSPEAKERS; ch++)
-        pData->recalc_hrtf_interpFLAG[ch] = 1;
-    pData->reinit_hrtfsFLAG = 1;
+    saf_atomic_store(&(pData->reinit_hrtfsFLAG), 1);
     ambi_dec_setCodecStatus(hAmbi, CODEC_STATUS_NOT_INITIALISED);
 }
 
@@ -640,7 +637,6 @@ void ambi_dec_setLoudspeakerAzi_deg(void* const hAmbi, int index, float newAzi_d
     newAzi_deg = SAF_MIN(newAzi_deg, 180.0f);
     if(pData->loudpkrs_dirs_deg[index][0] != newAzi_deg){
         pData->loudpkrs_dirs_deg[index][0] = newAzi_deg;
-        pData->recalc_hrtf_interpFLAG[index] = 1;
         ambi_dec_setCodecStatus(hAmbi, CODEC_STATUS_NOT_INITIALISED);
     }
 }
@@ -652,7 +648,6 @@ void ambi_dec_setLoudspeakerElev_deg(void* const hAmbi, int index, float newElev
     newElev_deg = SAF_MIN(newElev_deg, 90.0f);
     if(pData->loudpkrs_dirs_deg[index][1] != newElev_deg){
         pData->loudpkrs_dirs_deg[index][1] = newElev_deg;
-        pData->recalc_hrtf_interpFLAG[index] = 1;
         ambi_dec_setCodecStatus(hAmbi, CODEC_STATUS_NOT_INITIALISED);
     }
 }
@@ -660,14 +655,10 @@ void ambi_dec_setLoudspeakerElev_deg(void* const hAmbi, int index, float newElev
 void ambi_dec_setNumLoudspeakers(void* const hAmbi, int new_nLoudspeakers)
 {
     ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
-    int ch; 
     pData->new_nLoudpkrs = new_nLoudspeakers > MAX_NUM_LOUDSPEAKERS ? MAX_NUM_LOUDSPEAKERS : new_nLoudspeakers;
     pData->new_nLoudpkrs = SAF_MAX(MIN_NUM_LOUDSPEAKERS, pData->new_nLoudpkrs);
-    if(pData->nLoudpkrs != pData->new_nLoudpkrs){
-        for(ch=0; ch<MAX_NUM_LOUDSPEAKERS; ch++)
-            pData->recalc_hrtf_interpFLAG[ch] = 1;
+    if(pData->nLoudpkrs != pData->new_nLoudpkrs)
         ambi_dec_setCodecStatus(hAmbi, CODEC_STATUS_NOT_INITIALISED);
-    }
 }
 
 void ambi_dec_setBinauraliseLSflag(void* const hAmbi, int newState)
@@ -712,11 +703,8 @@ void ambi_dec_setEnableHRIRsPreProc(void* const hAmbi, int newState)
 void ambi_dec_setOutputConfigPreset(void* const hAmbi, int newPresetID)
 {
     ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
-    int ch;
     
     loadLoudspeakerArrayPreset(newPresetID, pData->loudpkrs_dirs_deg, &(pData->new_nLoudpkrs), &(pData->loudpkrs_nDims));
-    for(ch=0; ch<MAX_NUM_LOUDSPEAKERS; ch++)
-        pData->recalc_hrtf_interpFLAG[ch] = 1;
     ambi_dec_setCodecStatus(hAmbi, CODEC_STATUS_NOT_INITIALISED);
 }
 
@@ -825,6 +813,16 @@ void ambi_dec_setTransitionFreq(void* const hAmbi, float newValue)
     pData->transitionFreq = SAF_CLAMP(newValue, AMBI_DEC_TRANSITION_MIN_VALUE, AMBI_DEC_TRANSITION_MAX_VALUE);
 }
 
+void ambi_dec_setNumThreads(void* const hAmbi, int newValue)
+{
+    ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
+    newValue = SAF_CLAMP(newValue, 1, SAF_THREADPOOL_MAX_NUM_FOR_JOBS+1);
+    if(pData->new_nThreads != newValue){
+        pData->new_nThreads = newValue;
+        ambi_dec_setCodecStatus(hAmbi, CODEC_STATUS_NOT_INITIALISED);
+    }
+}
+
 
 /* Get Functions */
 
@@ -836,7 +834,7 @@ int ambi_dec_getFrameSize(void)
 CODEC_STATUS ambi_dec_getCodecStatus(void* const hAmbi)
 {
     ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float ambi_dec_getProgressBar0_1(void* const hAmbi)
@@ -994,9 +992,16 @@ int ambi_dec_getDAWsamplerate(void* const hAmbi)
     return pData->fs;
 }
 
-int ambi_dec_getProcessingDelay()
+int ambi_dec_getNumThreads(void* const hAmbi)
 {
-    return 12*HOP_SIZE;
+    ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
+    return pData->new_nThreads;
+}
+
+int ambi_dec_getProcessingDelay(void* const hAmbi)
+{
+    ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
+    return 12*HOP_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
 
 
@@ -48,24 +48,204 @@
 void ambi_dec_setCodecStatus(void* const hAmbi, CODEC_STATUS newStatus)
 {
     ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next ambi_dec_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void ambi_dec_createRenderState(ambi_dec_renderState** const pState)
+{
+    ambi_dec_renderState* state = (ambi_dec_renderState*)malloc1d(sizeof(ambi_dec_renderState));
+    int i, j;
+    *pState = state;
+
+    state->masterOrder = state->nLoudpkrs = state->binauraliseLS = 0;
+    state->hSTFT = NULL;
+    state->hThreadPool = NULL;
+    saf_arena_create(&(state->hArena), 0); /* (sized by the first ambi_dec_initCodec() call that uses this state) */
+    for (i=0; i<NUM_DECODERS; i++){
+        for(j=0; j<MAX_SH_ORDER; j++){
+            state->M_dec_cmplx[i][j] = NULL;
+            state->M_dec_cmplx_maxrE[i][j] = NULL;
+        }
     }
-    pData->codecStatus = newStatus;
+    state->N_hrir_dirs = state->N_hrtf_vbap_gtable = 0;
+    state->hrtf_vbapTableRes[0] = state->hrtf_vbapTableRes[1] = 0;
+    state->hrtf_vbap_gtableIdx = NULL;
+    state->hrtf_vbap_gtableComp = NULL;
+    state->itds_s = NULL;
+    state->hrtf_fb_mag = NULL;
+    state->reinterpFLAG = 1;
+}
+
+void ambi_dec_destroyRenderState(ambi_dec_renderState** const pState)
+{
+    ambi_dec_renderState* state = *pState;
+
+    if(state!=NULL){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        saf_arena_destroy(&(state->hArena));
+        free(state);
+        state = NULL;
+        *pState = NULL;
+    }
+}
+
+void ambi_dec_copyHRTFs
+(
+    ambi_dec_renderState* const dst,
+    const ambi_dec_renderState* const src
+)
+{
+    dst->N_hrir_dirs = src->N_hrir_dirs;
+    dst->hrtf_vbapTableRes[0] = src->hrtf_vbapTableRes[0];
+    dst->hrtf_vbapTableRes[1] = src->hrtf_vbapTableRes[1];
+    dst->N_hrtf_vbap_gtable = src->N_hrtf_vbap_gtable;
+    dst->hrtf_vbap_gtableIdx = saf_arena_malloc1d(dst->hArena, src->N_hrtf_vbap_gtable*3*sizeof(int));
+    memcpy(dst->hrtf_vbap_gtableIdx, src->hrtf_vbap_gtableIdx, src->N_hrtf_vbap_gtable*3*sizeof(int));
+    dst->hrtf_vbap_gtableComp = saf_arena_malloc1d(dst->hArena, src->N_hrtf_vbap_gtable*3*sizeof(float));
+    memcpy(dst->hrtf_vbap_gtableComp, src->hrtf_vbap_gtableComp, src->N_hrtf_vbap_gtable*3*sizeof(float));
+    dst->itds_s = saf_arena_malloc1d(dst->hArena, src->N_hrir_dirs*sizeof(float));
+    memcpy(dst->itds_s, src->itds_s, src->N_hrir_dirs*sizeof(float));
+    dst->hrtf_fb_mag = saf_arena_malloc1d(dst->hArena, HYBRID_BANDS*NUM_EARS*(src->N_hrir_dirs)*sizeof(float));
+    memcpy(dst->hrtf_fb_mag, src->hrtf_fb_mag, HYBRID_BANDS*NUM_EARS*(src->N_hrir_dirs)*sizeof(float));
+}
+
+void ambi_dec_initHRTFs
+(
+    void* const hAmbi,
+    ambi_dec_renderState* const state
+)
+{
+    ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
+    ambi_dec_codecPars* pars = pData->pars;
+    int i;
+    float* hrtf_vbap_gtable;
+#ifdef SAF_ENABLE_SOFA_READER_MODULE
+    SAF_SOFA_ERROR_CODES error;
+    saf_sofa_container sofa;
+#endif
+
+    strcpy(pData->progressBarText,"Computing VBAP gain table");
+    pData->progressBar0_1 = 0.4f;
+
+    /* load sofa file or load default hrir data */
+#ifdef SAF_ENABLE_SOFA_READER_MODULE
+    if(!pData->useDefaultHRIRsFLAG && pars->sofa_filepath!=NULL){
+        /* Load SOFA file */
+        error = saf_sofa_open(&sofa, pars->sofa_filepath, SAF_SOFA_READER_OPTION_DEFAULT);
+
+        /* Load defaults instead */
+        if(error!=SAF_SOFA_OK || sofa.nReceivers!=NUM_EARS){
+            pData->useDefaultHRIRsFLAG = 1;
+            saf_print_warning("Unable to load the specified SOFA file, or it contained something other than 2 channels. Using default HRIR data instead.");
+        }
+        else{
+            /* Copy SOFA data */
+            pars->hrir_fs = (int)sofa.DataSamplingRate;
+            pars->hrir_len = sofa.DataLengthIR;
+            pars->N_hrir_dirs = sofa.nSources;
+            pars->hrirs = realloc1d(pars->hrirs, pars->N_hrir_dirs*NUM_EARS*(pars->hrir_len)*sizeof(float));
+            memcpy(pars->hrirs, sofa.DataIR, pars->N_hrir_dirs*NUM_EARS*(pars->hrir_len)*sizeof(float));
+            pars->hrir_dirs_deg = realloc1d(pars->hrir_dirs_deg, pars->N_hrir_dirs*2*sizeof(float));
+            cblas_scopy(pars->N_hrir_dirs, sofa.SourcePosition, 3, pars->hrir_dirs_deg, 2); /* azi */
+            cblas_scopy(pars->N_hrir_dirs, &sofa.SourcePosition[1], 3, &pars->hrir_dirs_deg[1], 2); /* elev */
+        }
+
+        /* Clean-up */
+        saf_sofa_close(&sofa);
+    }
+#else
+    pData->useDefaultHRIRsFLAG = 1; /* Can only load the default HRIR data */
+#endif
+    if(pData->useDefaultHRIRsFLAG){
+        /* Copy default HRIR data */
+        pars->hrir_fs = __default_hrir_fs;
+        pars->hrir_len = __default_hrir_len;
+        pars->N_hrir_dirs = __default_N_hrir_dirs;
+        pars->hrirs = realloc1d(pars->hrirs, pars->N_hrir_dirs*NUM_EARS*(pars->hrir_len)*sizeof(float));
+        memcpy(pars->hrirs, (float*)__default_hrirs, pars->N_hrir_dirs*NUM_EARS*(pars->hrir_len)*sizeof(float));
+        pars->hrir_dirs_deg = realloc1d(pars->hrir_dirs_deg, pars->N_hrir_dirs*2*sizeof(float));
+        memcpy(pars->hrir_dirs_deg, (float*)__default_hrir_dirs_deg, pars->N_hrir_dirs*2*sizeof(float));
+    }
+
+    /* estimate the ITDs for each HRIR */
+    state->itds_s = saf_arena_malloc1d(state->hArena, pars->N_hrir_dirs*sizeof(float));
+    estimateITDs(pars->hrirs, pars->N_hrir_dirs, pars->hrir_len, pars->hrir_fs, state->itds_s);
+
+    /* generate VBAP gain table for the hrir_dirs */
+    hrtf_vbap_gtable = NULL;
+    state->hrtf_vbapTableRes[0] = 2; /* azimuth resolution in degrees */
+    state->hrtf_vbapTableRes[1] = 5; /* elevation resolution in degrees */
+    generateVBAPgainTable3D(pars->hrir_dirs_deg, pars->N_hrir_dirs, state->hrtf_vbapTableRes[0], state->hrtf_vbapTableRes[1], 1, 0, 0.0f,
+                            &hrtf_vbap_gtable, &(state->N_hrtf_vbap_gtable), &(pars->hrtf_nTriangles));
+    if(hrtf_vbap_gtable==NULL){
+        /* if generating vbap gain tabled failed, re-calculate with default HRIR set (which is known to triangulate correctly) */
+        pData->useDefaultHRIRsFLAG = 1;
+        ambi_dec_initHRTFs(hAmbi, state);
+        return;
+    }
+
+    /* compress VBAP table (i.e. remove the zero elements) */
+    state->hrtf_vbap_gtableComp = saf_arena_malloc1d(state->hArena, state->N_hrtf_vbap_gtable * 3 * sizeof(float));
+    state->hrtf_vbap_gtableIdx  = saf_arena_malloc1d(state->hArena, state->N_hrtf_vbap_gtable * 3 * sizeof(int));
+    compressVBAPgainTable3D(hrtf_vbap_gtable, state->N_hrtf_vbap_gtable, pars->N_hrir_dirs, state->hrtf_vbap_gtableComp, state->hrtf_vbap_gtableIdx);
+
+    /* convert hrirs to filterbank coefficients */
+    strcpy(pData->progressBarText,"Preparing HRIRs");
+    pData->progressBar0_1 = 0.85f;
+    pars->hrtf_fb = realloc1d(pars->hrtf_fb, HYBRID_BANDS * NUM_EARS * (pars->N_hrir_dirs)*sizeof(float_complex));
+    HRIRs2HRTFs_afSTFT(pars->hrirs, pars->N_hrir_dirs, pars->hrir_len, HOP_SIZE, 0, 1, pars->hrtf_fb);
+    /* HRIR pre-processing */
+    if(pData->enableHRIRsPreProc){
+        /* get integration weights */
+        strcpy(pData->progressBarText,"Applying HRIR Pre-Processing");
+        pData->progressBar0_1 = 0.95f;
+        if(pars->N_hrir_dirs<=3600){
+            pars->weights = realloc1d(pars->weights, pars->N_hrir_dirs*sizeof(float));
+            //getVoronoiWeights(pars->hrir_dirs_deg, pars->N_hrir_dirs, 0, pars->weights);
+            float * hrir_dirs_rad = (float*) malloc1d(pars->N_hrir_dirs*2*sizeof(float));
+            memcpy(hrir_dirs_rad, pars->hrir_dirs_deg, pars->N_hrir_dirs*2*sizeof(float));
+            cblas_sscal(pars->N_hrir_dirs*2, SAF_PI/180.f, hrir_dirs_rad, 1);
+            sphElev2incl(hrir_dirs_rad, pars->N_hrir_dirs, 0, hrir_dirs_rad);
+            int supOrder = calculateGridWeights(hrir_dirs_rad, pars->N_hrir_dirs, -1, pars->weights);
+            free(hrir_dirs_rad);
+            if(supOrder < 1){
+                saf_print_warning("Could not calculate grid weights");
+                free(pars->weights);
+                pars->weights = NULL;
+            }
+        }
+        else{
+            saf_print_warning("Too many grid points");
+            free(pars->weights);
+            pars->weights = NULL;
+        }
+        diffuseFieldEqualiseHRTFs(pars->N_hrir_dirs, state->itds_s, pData->freqVector, HYBRID_BANDS, pars->weights, 1, 0, pars->hrtf_fb);
+    }
+
+    /* calculate magnitude responses */
+    state->hrtf_fb_mag = saf_arena_malloc1d(state->hArena, HYBRID_BANDS*NUM_EARS*(pars->N_hrir_dirs)*sizeof(float));
+    for(i=0; i<HYBRID_BANDS*NUM_EARS* (pars->N_hrir_dirs); i++)
+        state->hrtf_fb_mag[i] = cabsf(pars->hrtf_fb[i]);
+
+    state->N_hrir_dirs = pars->N_hrir_dirs;
+
+    /* clean-up */
+    free(hrtf_vbap_gtable);
 }
 
 void ambi_dec_interpHRTFs
 (
     void* const hAmbi,
+    ambi_dec_renderState* const state,
     float azimuth_deg,
     float elevation_deg,
     float_complex h_intrp[HYBRID_BANDS][NUM_EARS]
 )
 {
     ambi_dec_data *pData = (ambi_dec_data*)(hAmbi);
-    ambi_dec_codecPars* pars = pData->pars;
     int i, band;
     int aziIndex, elevIndex, N_azi, idx3d;
     float_complex ipd;
@@ -73,21 +253,21 @@ void ambi_dec_interpHRTFs
     float magnitudes3[HYBRID_BANDS][3][NUM_EARS], magInterp[HYBRID_BANDS][NUM_EARS];
 
     /* find closest pre-computed VBAP direction */
-    aziRes = (float)pars->hrtf_vbapTableRes[0];
-    elevRes = (float)pars->hrtf_vbapTableRes[1];
+    aziRes = (float)state->hrtf_vbapTableRes[0];
+    elevRes = (float)state->hrtf_vbapTableRes[1];
     N_azi = (int)(360.0f / aziRes + 0.5f) + 1;
     aziIndex = (int)(matlab_fmodf(azimuth_deg + 180.0f, 360.0f) / aziRes + 0.5f);
     elevIndex = (int)((elevation_deg + 90.0f) / elevRes + 0.5f);
     idx3d = elevIndex * N_azi + aziIndex;
     for (i = 0; i < 3; i++)
-        weights[0][i] = pars->hrtf_vbap_gtableComp[idx3d*3 + i];
+        weights[0][i] = state->hrtf_vbap_gtableComp[idx3d*3 + i];
     
     /* retrieve the 3 itds and hrtf magnitudes */
     for (i = 0; i < 3; i++) {
-        itds3[i] = pars->itds_s[pars->hrtf_vbap_gtableIdx[idx3d*3+i]];
+        itds3[i] = state->itds_s[state->hrtf_vbap_gtableIdx[idx3d*3+i]];
         for (band = 0; band < HYBRID_BANDS; band++) {
-            magnitudes3[band][i][0] = pars->hrtf_fb_mag[band*NUM_EARS*(pars->N_hrir_dirs) + 0*(pars->N_hrir_dirs) + pars->hrtf_vbap_gtableIdx[idx3d*3+i]];
-            magnitudes3[band][i][1] = pars->hrtf_fb_mag[band*NUM_EARS*(pars->N_hrir_dirs) + 1*(pars->N_hrir_dirs) + pars->hrtf_vbap_gtableIdx[idx3d*3+i]];
+            magnitudes3[band][i][0] = state->hrtf_fb_mag[band*NUM_EARS*(state->N_hrir_dirs) + 0*(state->N_hrir_dirs) + state->hrtf_vbap_gtableIdx[idx3d*3+i]];
+            magnitudes3[band][i][1] = state->hrtf_fb_mag[band*NUM_EARS*(state->N_hrir_dirs) + 1*(state->N_hrir_dirs) + state->hrtf_vbap_gtableIdx[idx3d*3+i]];
         }
     }
     
@@ -68,6 +68,8 @@ extern "C" {
 #define HOP_SIZE ( 128 )                               /**< STFT hop size */
 #define HYBRID_BANDS ( HOP_SIZE + 5 )                  /**< Number of frequency bands */
 #define TIME_SLOTS ( AMBI_DEC_FRAME_SIZE / HOP_SIZE )  /**< Number of STFT timeslots */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
+#define AMBI_DEC_FRAME_STRIDE ( (int)md_alignedStride(AMBI_DEC_FRAME_SIZE, sizeof(float)) ) /**< Distance between the rows of the time-domain frames (#AMBI_DEC_FRAME_SIZE, padded to whole cache lines) */
 #define MAX_NUM_LOUDSPEAKERS ( MAX_NUM_OUTPUTS )       /**< Maximum permitted output channels */
 #define MIN_NUM_LOUDSPEAKERS ( 4 )                     /**< To avoid triangulation errors when using AllRAD */
 #define NUM_DECODERS ( 2 )                             /**< One for low-frequencies and another for high-frequencies */
@@ -82,18 +84,53 @@ extern "C" {
 /* ========================================================================== */
 
 /**
- * Contains variables for sofa file loading, HRTF interpolation, and the
- * loudspeaker decoders.
+ * Everything that ambi_dec_processFrame() needs from an initialisation
+ *
+ * A new render state is built by ambi_dec_initCodec() (while the audio thread
+ * keeps rendering with the current one), and then handed over to the audio
+ * thread via a saf_stateSwap. Once published, only the audio thread may touch
+ * it, until it is handed back by the next initialisation.
  */
-typedef struct _ambi_dec_codecPars
+typedef struct _ambi_dec_renderState
 {
+    int masterOrder;                            /**< maximum/master decoding order */
+    int nLoudpkrs;                              /**< number of loudspeakers */
+    int binauraliseLS;                          /**< 1: the loudspeaker signals are binauralised, 0: they are output */
+    float loudpkrs_dirs_deg[MAX_NUM_LOUDSPEAKERS][2]; /**< loudspeaker directions in degrees [azi, elev] */
+    void* hSTFT;                                /**< afSTFT handle (passed on to the next render state, if it has the same number of channels) */
+    void* hThreadPool;                          /**< saf_threadPool handle (owned by ambi_dec_data); NULL if nThreads==1 */
+    void* hArena;                               /**< Arena, from which the decoding matrices and HRTF tables below are allocated */
+
     /* decoders */
-    float* M_dec[NUM_DECODERS][MAX_SH_ORDER];   /**< ambisonic decoding matrices ([0] for low-freq, [1] for high-freq); FLAT: nLoudspeakers x nSH */
     float_complex* M_dec_cmplx[NUM_DECODERS][MAX_SH_ORDER]; /**< complex ambisonic decoding matrices ([0] for low-freq, [1] for high-freq); FLAT: nLoudspeakers x nSH */
-    float* M_dec_maxrE[NUM_DECODERS][MAX_SH_ORDER]; /**< ambisonic decoding matrices with maxrE weighting ([0] for low-freq, [1] for high-freq); FLAT: nLoudspeakers x nSH */
     float_complex* M_dec_cmplx_maxrE[NUM_DECODERS][MAX_SH_ORDER]; /**< complex ambisonic decoding matrices with maxrE weighting ([0] for low-freq, [1] for high-freq); FLAT: nLoudspeakers x nSH */
     float M_norm[NUM_DECODERS][MAX_SH_ORDER][2]; /**< norm coefficients to preserve omni energy/amplitude between different orders and decoders */
-    
+
+    /* vbap gain table for panning the HRIRs */
+    int N_hrir_dirs;                            /**< number of HRIR directions */
+    int hrtf_vbapTableRes[2];                   /**< [azi elev] step sizes in degrees */
+    int N_hrtf_vbap_gtable;                     /**< number of interpolation directions */
+    int* hrtf_vbap_gtableIdx;                   /**< N_hrtf_vbap_gtable x 3 */
+    float* hrtf_vbap_gtableComp;                /**< N_hrtf_vbap_gtable x 3 */
+
+    /* hrir filterbank coefficients */
+    float* itds_s;                              /**< interaural-time differences for each HRIR (in seconds); N_hrirs x 1 */
+    float* hrtf_fb_mag;                         /**< magnitudes of the HRTF filterbank coefficients; nBands x nCH x N_hrirs */
+    float_complex hrtf_interp[MAX_NUM_LOUDSPEAKERS][HYBRID_BANDS][NUM_EARS]; /**< interpolated HRTFs */
+    int reinterpFLAG;                           /**< 1: the HRTFs are yet to be interpolated for the loudspeaker directions, 0: hrtf_interp is up-to-date */
+
+}ambi_dec_renderState;
+
+/**
+ * Contains variables for sofa file loading, and the time-domain loudspeaker
+ * decoders.
+ */
+typedef struct _ambi_dec_codecPars
+{
+    /* decoders */
+    float* M_dec[NUM_DECODERS][MAX_SH_ORDER];   /**< ambisonic decoding matrices ([0] for low-freq, [1] for high-freq); FLAT: nLoudspeakers x nSH */
+    float* M_dec_maxrE[NUM_DECODERS][MAX_SH_ORDER]; /**< ambisonic decoding matrices with maxrE weighting ([0] for low-freq, [1] for high-freq); FLAT: nLoudspeakers x nSH */
+
     /* sofa file info */
     char* sofa_filepath;                        /**< absolute/relevative file path for a sofa file */
     float* hrirs;                               /**< time domain HRIRs; N_hrir_dirs x 2 x hrir_len */
@@ -103,18 +140,11 @@ typedef struct _ambi_dec_codecPars
     int hrir_fs;                                /**< sampling rate of the HRIRs, should ideally match the host sampling rate, although not required */
     
     /* vbap gain table for panning the HRIRs */
-    int hrtf_vbapTableRes[2];                   /**< [azi elev] step sizes in degrees */
-    int N_hrtf_vbap_gtable;                     /**< number of interpolation directions */
     int hrtf_nTriangles;                        /**< number of triangle groups after triangulation */
-    int* hrtf_vbap_gtableIdx;                   /**< N_hrtf_vbap_gtable x 3 */
-    float* hrtf_vbap_gtableComp;                /**< N_hrtf_vbap_gtable x 3 */
-    
+
     /* hrir filterbank coefficients */
-    float* itds_s;                              /**< interaural-time differences for each HRIR (in seconds); N_hrirs x 1 */
     float_complex* hrtf_fb;                     /**< HRTF filterbank coefficients; nBands x nCH x N_hrirs */
-    float* hrtf_fb_mag;                         /**< magnitudes of the HRTF filterbank coefficients; nBands x nCH x N_hrirs */
-    float_complex hrtf_interp[MAX_NUM_LOUDSPEAKERS][HYBRID_BANDS][NUM_EARS]; /**< interpolated HRTFs */
-    
+
     /* integration weights */
     float* weights;                             /**< grid integration weights of hrirs; N_hrirs x 1 */
 
@@ -127,47 +157,52 @@ typedef struct _ambi_dec_codecPars
 typedef struct _ambi_dec
 {
     /* audio buffers + afSTFT time-frequency transform handle */
+    void* hBlockAdapter;                 /**< Block adapter handle (for arbitrary host block sizes) */
     float** SHFrameTD;                   /**< Input spherical harmonic (SH) signals in the time-domain; #MAX_NUM_SH_SIGNALS x #AMBI_DEC_FRAME_SIZE */
     float** outputFrameTD;               /**< Output loudspeaker or binaural signals in the time-domain; #MAX_NUM_LOUDSPEAKERS x #AMBI_DEC_FRAME_SIZE */
     float_complex*** SHframeTF;          /**< Input spherical harmonic (SH) signals in the time-frequency domain; #HYBRID_BANDS x #MAX_NUM_SH_SIGNALS x #TIME_SLOTS */
     float_complex*** outputframeTF;      /**< Output loudspeaker signals in the time-frequency domain; #HYBRID_BANDS x #MAX_NUM_LOUDSPEAKERS x #TIME_SLOTS */
     float_complex*** binframeTF;         /**< Output binaural signals in the time-frequency domain; #HYBRID_BANDS x #NUM_EARS x #TIME_SLOTS */
-    void* hSTFT;                         /**< afSTFT handle */
     int afSTFTdelay;                     /**< for host delay compensation */ 
     int fs;                              /**< host sampling rate */
     float freqVector[HYBRID_BANDS];      /**< frequency vector for time-frequency transform, in Hz */
     
     /* our codec configuration */
-    CODEC_STATUS codecStatus;            /**< see #CODEC_STATUS */
+    volatile long codecStatus;           /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;              /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;                /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;               /**< Current (re)initialisation step, string */
     ambi_dec_codecPars* pars;            /**< codec parameters */
+    void* hStateSwap;                    /**< saf_stateSwap handle, via which new render states are handed over to the audio thread */
+    ambi_dec_renderState* liveState;     /**< The last published render state (or NULL); read-only, until it is handed back */
+    ambi_dec_renderState* spareState;    /**< The previous render state (or NULL), in which the next one is built */
     
     /* internal variables */
     int loudpkrs_nDims;                  /**< dimensionality of the current loudspeaker set-up */
     int new_nLoudpkrs;                   /**< if new_nLoudpkrs != nLoudpkrs, afSTFT is reinitialised  (current value will be replaced by this after next re-init) */
     int new_binauraliseLS;               /**< if new_binauraliseLS != binauraliseLS, ambi_dec is reinitialised (current value will be replaced by this after next re-init) */
     int new_masterOrder;                 /**< if new_masterOrder != masterOrder, ambi_dec is reinitialised (current value will be replaced by this after next re-init) */
+    int new_nThreads;                    /**< if new_nThreads != nThreads, the thread pool is recreated (current value will be replaced by this after next re-init) */
+    void* hThreadPool;                   /**< saf_threadPool handle, across which the frequency bands are processed (NULL if nThreads==1) */
     
     /* flags */
-    PROC_STATUS procStatus;              /**< see #PROC_STATUS */
-    int reinit_hrtfsFLAG;                /**< 0: no init required, 1: init required */
-    int recalc_hrtf_interpFLAG[MAX_NUM_LOUDSPEAKERS]; /**< 0: no init required, 1: init required */
+    volatile long reinit_hrtfsFLAG;      /**< 0: no init required, 1: init required (only accessed via the saf_atomic functions) */
     
     /* user parameters */
-    int masterOrder;                     /**< Current maximum/master decoding order */
+    int masterOrder;                     /**< Maximum/master decoding order of the last built render state */
     int orderPerBand[HYBRID_BANDS];      /**< Ambisonic decoding order per frequency band 1..SH_ORDER */
     AMBI_DEC_DECODING_METHODS dec_method[NUM_DECODERS]; /**< decoding methods for each decoder, see #AMBI_DEC_DECODING_METHODS enum */
     int rE_WEIGHT[NUM_DECODERS];         /**< 0:disabled, 1: enable max_rE weight */
     AMBI_DEC_DIFFUSE_FIELD_EQ_APPROACH diffEQmode[NUM_DECODERS]; /**< diffuse-field EQ approach; see #AMBI_DEC_DIFFUSE_FIELD_EQ_APPROACH enum */
     float transitionFreq;                /**< transition frequency for the 2 decoders, in Hz */
-    int nLoudpkrs;                       /**< number of loudspeakers/virtual loudspeakers */
+    int nLoudpkrs;                       /**< number of loudspeakers/virtual loudspeakers of the last built render state */
     float loudpkrs_dirs_deg[MAX_NUM_LOUDSPEAKERS][NUM_DECODERS]; /**< loudspeaker directions in degrees [azi, elev] */
     int useDefaultHRIRsFLAG;             /**< 1: use default HRIRs in database, 0: use those from SOFA file */
     int enableHRIRsPreProc;              /**< flag to apply pre-processing to the currently loaded HRTFs */
-    int binauraliseLS;                   /**< 1: convolve loudspeaker signals with HRTFs, 0: output loudspeaker signals */
+    int binauraliseLS;                   /**< 1: convolve loudspeaker signals with HRTFs, 0: output loudspeaker signals (of the last built render state) */
     CH_ORDER chOrdering;                 /**< Ambisonic channel order convention (see #CH_ORDER) */
     NORM_TYPES norm;                     /**< Ambisonic normalisation convention (see #NORM_TYPES) */
+    int nThreads;                        /**< Number of threads processing the frequency bands (including the host thread) */
     
 } ambi_dec_data;
 
@@ -181,17 +216,40 @@ typedef struct _ambi_dec
  */
 void ambi_dec_setCodecStatus(void* const hCmp, CODEC_STATUS newStatus);
 
+/** Creates an (empty) render state; see #ambi_dec_renderState */
+void ambi_dec_createRenderState(ambi_dec_renderState** const pState);
+
+/** Destroys a render state (if not NULL) */
+void ambi_dec_destroyRenderState(ambi_dec_renderState** const pState);
+
+/**
+ * Copies the HRTF interpolation tables of one render state to another (for
+ * when the HRTFs have not changed)
+ */
+void ambi_dec_copyHRTFs(ambi_dec_renderState* const dst,
+                        const ambi_dec_renderState* const src);
+
+/**
+ * Initialise the HRTFs: either loading the default set or loading from a SOFA
+ * file; and then generate a VBAP gain table for interpolation (written to the
+ * given render state).
+ */
+void ambi_dec_initHRTFs(void* const hAmbi,
+                        ambi_dec_renderState* const state);
+
 /**
  * Interpolates between the 3 nearest HRTFs using amplitude-preserving VBAP
  * gains. The HRTF magnitude responses and HRIR ITDs are interpolated seperately
  * before being re-combined.
  *
  * @param[in]  hAmbi         ambi_dec handle
+ * @param[in]  state         Render state holding the HRTF interpolation tables
  * @param[in]  azimuth_deg   Interpolation direction azimuth in DEGREES
  * @param[in]  elevation_deg Interpolation direction elevation in DEGREES
  * @param[out] h_intrp       Interpolated HRTF
  */
 void ambi_dec_interpHRTFs(void* const hAmbi,
+                          ambi_dec_renderState* const state,
                           float azimuth_deg,
                           float elevation_deg,
                           float_complex h_intrp[HYBRID_BANDS][NUM_EARS]);
@@ -48,17 +48,17 @@ void ambi_drc_create
     ambi_drc_data* pData = (ambi_drc_data*)malloc1d(sizeof(ambi_drc_data));
     *phAmbi = (void*)pData;
  
-    /* afSTFT stuff and audio buffers*/
-    pData->hSTFT = NULL;
-    pData->frameTD = (float**)malloc2d(MAX_NUM_SH_SIGNALS, AMBI_DRC_FRAME_SIZE, sizeof(float));
-    pData->inputFrameTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
-    pData->outputFrameTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
+    /* filterbank stuff and audio buffers*/
+    pData->hFB = NULL;
+    pData->frameTD = (float**)malloc2d_aligned(MAX_NUM_SH_SIGNALS, AMBI_DRC_FRAME_SIZE, sizeof(float));
+    pData->inputFrameTF = (float_complex***)calloc3d_aligned(MAX_NUM_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
+    pData->outputFrameTF = (float_complex***)calloc3d_aligned(MAX_NUM_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
     
     /* internal */
     pData->fs = 48000;
 #ifdef ENABLE_TF_DISPLAY
-    pData->gainsTF_bank0 = (float**)malloc2d(HYBRID_BANDS, AMBI_DRC_NUM_DISPLAY_TIME_SLOTS, sizeof(float));
-    pData->gainsTF_bank1 = (float**)malloc2d(HYBRID_BANDS, AMBI_DRC_NUM_DISPLAY_TIME_SLOTS, sizeof(float));
+    pData->gainsTF_bank0 = (float**)malloc2d(MAX_NUM_BANDS, AMBI_DRC_NUM_DISPLAY_TIME_SLOTS, sizeof(float));
+    pData->gainsTF_bank1 = (float**)malloc2d(MAX_NUM_BANDS, AMBI_DRC_NUM_DISPLAY_TIME_SLOTS, sizeof(float));
 #endif
   
     /* Default user parameters */
@@ -72,11 +72,18 @@ void ambi_drc_create
     pData->chOrdering = CH_ACN;
     pData->norm = NORM_SN3D;
     pData->currentOrder = SH_ORDER_FIRST;
+    pData->new_fbType = AMBI_DRC_FILTERBANK_AFSTFT;
     
     /* for dynamically allocating the number of channels */
     ambi_drc_setInputOrder(pData->currentOrder, &(pData->new_nSH));
     pData->nSH = pData->new_nSH;
-    pData->reInitTFT = 1;
+
+    /* create the filterbank now, so that the number of bands and its delay are known before ambi_drc_init() */
+    ambi_drc_initTFT(*phAmbi);
+    pData->reInitTFT = 0;
+
+    /* for passing arbitrary host block sizes through ambi_drc_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), AMBI_DRC_FRAME_SIZE, MAX_NUM_SH_SIGNALS, MAX_NUM_SH_SIGNALS);
 }
 
 void ambi_drc_destroy
@@ -87,15 +94,15 @@ void ambi_drc_destroy
     ambi_drc_data *pData = (ambi_drc_data*)(*phAmbi);
 
     if (pData != NULL) {
-        if (pData->hSTFT != NULL)
-            afSTFT_destroy(&(pData->hSTFT));
-        free(pData->frameTD);
-        free(pData->inputFrameTF);
-        free(pData->outputFrameTF);
+        saf_filterbank_destroy(&(pData->hFB));
+        free2d_aligned((void**)pData->frameTD);
+        free3d_aligned((void***)pData->inputFrameTF);
+        free3d_aligned((void***)pData->outputFrameTF);
 #ifdef ENABLE_TF_DISPLAY
         free(pData->gainsTF_bank0);
         free(pData->gainsTF_bank1);
 #endif
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phAmbi = NULL;
@@ -105,21 +112,22 @@ void ambi_drc_destroy
 void ambi_drc_init
 (
     void * const hAmbi,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     ambi_drc_data *pData = (ambi_drc_data*)(hAmbi);
     int band;
 
     pData->fs = (float)sampleRate;
-    memset(pData->yL_z1, 0, HYBRID_BANDS * sizeof(float));
-    afSTFT_getCentreFreqs(pData->hSTFT, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
+    memset(pData->yL_z1, 0, MAX_NUM_BANDS * sizeof(float));
+    saf_filterbank_getCentreFreqs(pData->hFB, (float)sampleRate, pData->nBands, pData->freqVector);
      
 #ifdef ENABLE_TF_DISPLAY
     pData->rIdx = 0;
     pData->wIdx = 1;
     pData->storeIdx = 0;
-    for (band = 0; band < HYBRID_BANDS; band++) {
+    for (band = 0; band < MAX_NUM_BANDS; band++) {
         memset(pData->gainsTF_bank0[band], 0, AMBI_DRC_NUM_DISPLAY_TIME_SLOTS * sizeof(float));
         memset(pData->gainsTF_bank1[band], 0, AMBI_DRC_NUM_DISPLAY_TIME_SLOTS * sizeof(float));
     }
@@ -131,16 +139,21 @@ void ambi_drc_init
         ambi_drc_initTFT(hAmbi);
         pData->reInitTFT = 0;
     }
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
-void ambi_drc_process
+/** Processes one frame of #AMBI_DRC_FRAME_SIZE samples (see ambi_drc_process()) */
+static void ambi_drc_processFrame
 (
     void        *  const hAmbi,
     const float *const * inputs,
     float* const*  const outputs,
-    int                  nCh,
+    int                  nInputs,
+    int                  nOutputs,
     int                  nSamples
-)                                         
+)
 {
     ambi_drc_data *pData = (ambi_drc_data*)(hAmbi);
     int i, t, ch, band;
@@ -167,20 +180,20 @@ void ambi_drc_process
     if (nSamples == AMBI_DRC_FRAME_SIZE && pData->reInitTFT == 0) {
 
         /* Load time-domain data */
-        for(i=0; i < SAF_MIN(pData->nSH, nCh); i++)
+        for(i=0; i < SAF_MIN(pData->nSH, nInputs); i++)
             utility_svvcopy(inputs[i], AMBI_DRC_FRAME_SIZE, pData->frameTD[i]);
         for(; i<pData->nSH; i++)
             memset(pData->frameTD[i], 0, AMBI_DRC_FRAME_SIZE * sizeof(float));
 
         /* Apply time-frequency transform */
-        afSTFT_forward_knownDimensions(pData->hSTFT, pData->frameTD, AMBI_DRC_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS, pData->inputFrameTF);
+        saf_filterbank_forward(pData->hFB, pData->frameTD, AMBI_DRC_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS_STRIDE, pData->inputFrameTF);
 
         /* Main processing: */
         /* Calculate the dynamic range compression gain factors per frequency band based on the omnidirectional component.
             *     McCormack, L., & Välimäki, V. (2017). "FFT-Based Dynamic Range Compression". in Proceedings of the 14th
             *     Sound and Music Computing Conference, July 5-8, Espoo, Finland.*/
         for (t = 0; t < TIME_SLOTS; t++) {
-            for (band = 0; band < HYBRID_BANDS; band++) {
+            for (band = 0; band < pData->nBands; band++) {
                 /* apply input boost */
                 for (ch = 0; ch < pData->nSH; ch++)
                     pData->inputFrameTF[band][ch][t] = crmulf(pData->inputFrameTF[band][ch][t], boost);
@@ -220,20 +233,35 @@ void ambi_drc_process
         }
 
         /* Inverse time-frequency transform */
-        afSTFT_backward_knownDimensions(pData->hSTFT, pData->outputFrameTF, AMBI_DRC_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS, pData->frameTD);
+        saf_filterbank_backward(pData->hFB, pData->outputFrameTF, AMBI_DRC_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS_STRIDE, pData->frameTD);
 
         /* Copy to output */
-        for(ch = 0; ch < SAF_MIN(pData->nSH, nCh); ch++)
+        for(ch = 0; ch < SAF_MIN(pData->nSH, nOutputs); ch++)
             utility_svvcopy(pData->frameTD[ch], AMBI_DRC_FRAME_SIZE, outputs[ch]);
-        for (; ch < nCh; ch++)
+        for (; ch < nOutputs; ch++)
             memset(outputs[ch], 0, AMBI_DRC_FRAME_SIZE*sizeof(float));
     }
     else {
-        for (ch=0; ch < nCh; ch++)
+        for (ch=0; ch < nOutputs; ch++)
             memset(outputs[ch], 0, AMBI_DRC_FRAME_SIZE*sizeof(float));
     }
 }
 
+void ambi_drc_process
+(
+    void        *  const hAmbi,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nCh,
+    int                  nSamples
+)
+{
+    ambi_drc_data *pData = (ambi_drc_data*)(hAmbi);
+
+    /* Process the host buffers in frames of #AMBI_DRC_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nCh, nCh, nSamples, ambi_drc_processFrame, hAmbi);
+}
+
 /* SETS */
 
 void ambi_drc_refreshSettings(void* const hAmbi)
@@ -312,6 +340,15 @@ void ambi_drc_setInputPreset(void* const hAmbi, SH_ORDERS newPreset)
         pData->norm = NORM_SN3D;
 }
 
+void ambi_drc_setFilterbank(void* const hAmbi, int newType)
+{
+    ambi_drc_data *pData = (ambi_drc_data*)hAmbi;
+    if(pData->new_fbType != (AMBI_DRC_FILTERBANKS)newType){
+        pData->new_fbType = (AMBI_DRC_FILTERBANKS)newType;
+        pData->reInitTFT = 1;
+    }
+}
+
 
 /* GETS */
 
@@ -345,7 +382,7 @@ int ambi_drc_getGainTFrIdx(void* const hAmbi)
 float* ambi_drc_getFreqVector(void* const hAmbi, int* nFreqPoints)
 {
     ambi_drc_data *pData = (ambi_drc_data*)(hAmbi);
-    (*nFreqPoints) = HYBRID_BANDS;
+    (*nFreqPoints) = pData->nBands;
     return pData->freqVector;
 }
 #endif
@@ -410,6 +447,12 @@ SH_ORDERS ambi_drc_getInputPreset(void* const hAmbi)
     return pData->currentOrder;
 }
 
+int ambi_drc_getFilterbank(void* const hAmbi)
+{
+    ambi_drc_data *pData = (ambi_drc_data*)(hAmbi);
+    return (int)pData->new_fbType;
+}
+
 int ambi_drc_getNSHrequired(void* const hAmbi)
 {
     ambi_drc_data *pData = (ambi_drc_data*)(hAmbi);
@@ -422,8 +465,9 @@ int ambi_drc_getSamplerate(void* const hAmbi)
     return (int)(pData->fs+0.5f);
 }
 
-int ambi_drc_getProcessingDelay()
+int ambi_drc_getProcessingDelay(void* const hAmbi)
 {
-    return 12*HOP_SIZE;
+    ambi_drc_data *pData = (ambi_drc_data*)(hAmbi);
+    return pData->fbDelay + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
 
@@ -90,13 +90,29 @@ void ambi_drc_initTFT
 )
 {
     ambi_drc_data *pData = (ambi_drc_data*)(hAmbi);
+    SAF_FILTERBANK_TYPES type;
 
-    /* Initialise afSTFT */
-    if (pData->hSTFT == NULL)
-        afSTFT_create(&(pData->hSTFT), pData->new_nSH, pData->new_nSH, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    /* Initialise the filterbank (or replace it, if a different one has been selected) */
+    if (pData->hFB == NULL || pData->fbType != pData->new_fbType) {
+        switch(pData->new_fbType){
+            default: /* fall through */
+            case AMBI_DRC_FILTERBANK_AFSTFT:    type = SAF_FILTERBANK_AFSTFT;    break;
+            case AMBI_DRC_FILTERBANK_AFSTFT_LD: type = SAF_FILTERBANK_AFSTFT_LD; break;
+            case AMBI_DRC_FILTERBANK_QMF:       type = SAF_FILTERBANK_QMF;       break;
+            case AMBI_DRC_FILTERBANK_STFT:      type = SAF_FILTERBANK_STFT;      break;
+        }
+        saf_filterbank_destroy(&(pData->hFB));
+        saf_filterbank_create(&(pData->hFB), type, pData->new_nSH, pData->new_nSH, HOP_SIZE, 1);
+        pData->fbType = pData->new_fbType;
+        pData->nBands = saf_filterbank_getNBands(pData->hFB);
+        pData->fbDelay = saf_filterbank_getProcDelay(pData->hFB);
+        saf_assert(pData->nBands<=MAX_NUM_BANDS, "MAX_NUM_BANDS is too small for this filterbank");
+        saf_filterbank_getCentreFreqs(pData->hFB, pData->fs, pData->nBands, pData->freqVector);
+        memset(pData->yL_z1, 0, MAX_NUM_BANDS * sizeof(float));
+    }
     else if(pData->nSH!=pData->new_nSH){/* Or change the number of channels */
-        afSTFT_channelChange(pData->hSTFT, pData->new_nSH, pData->new_nSH);
-        afSTFT_clearBuffers(pData->hSTFT);
+        saf_filterbank_channelChange(pData->hFB, pData->new_nSH, pData->new_nSH);
+        saf_filterbank_clearBuffers(pData->hFB);
     }
     pData->nSH = pData->new_nSH; 
 }
@@ -59,37 +59,44 @@ extern "C" {
 #  define AMBI_DRC_FRAME_SIZE ( 128 )                 /**< Framesize, in time-domain samples */
 # endif
 #endif
-#define HOP_SIZE ( 128 )                              /**< STFT hop size */
-#define HYBRID_BANDS ( HOP_SIZE + 5 )                 /**< Number of frequency bands */
-#define TIME_SLOTS ( AMBI_DRC_FRAME_SIZE / HOP_SIZE ) /**< Number of STFT timeslots */
+#define HOP_SIZE ( 128 )                              /**< Filterbank hop size */
+#define MAX_NUM_BANDS ( 2*HOP_SIZE + 1 )              /**< Maximum number of frequency bands (that of #AMBI_DRC_FILTERBANK_STFT) */
+#define TIME_SLOTS ( AMBI_DRC_FRAME_SIZE / HOP_SIZE ) /**< Number of filterbank timeslots */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
 
 /* Checks: */
 #if (AMBI_DRC_FRAME_SIZE % HOP_SIZE != 0)
 # error "AMBI_DRC_FRAME_SIZE must be an integer multiple of HOP_SIZE"
 #endif
+#if defined(ENABLE_TF_DISPLAY) && (AMBI_DRC_NUM_BANDS != MAX_NUM_BANDS)
+# error "AMBI_DRC_NUM_BANDS must be equal to MAX_NUM_BANDS"
+#endif
 
 /* ========================================================================== */
 /*                                 Structures                                 */
 /* ========================================================================== */
     
 /**
- * Main structure for ambi_drc. Contains variables for audio buffers, afSTFT,
- * internal variables, user parameters
+ * Main structure for ambi_drc. Contains variables for audio buffers, the
+ * filterbank, internal variables, user parameters
  */
 typedef struct _ambi_drc
 { 
-    /* audio buffers and afSTFT handle */
+    /* audio buffers and filterbank handle */
+    void* hBlockAdapter;             /**< Block adapter handle (for arbitrary host block sizes) */
     float** frameTD;                 /**< Input/output SH signals, in the time-domain; #MAX_NUM_SH_SIGNALS x #AMBI_DRC_FRAME_SIZE */
-    float_complex*** inputFrameTF;   /**< Input SH signals, in the time-frequency domain; #HYBRID_BANDS x #MAX_NUM_SH_SIGNALS x #TIME_SLOTS */
-    float_complex*** outputFrameTF;  /**< Output SH signals, in the time-frequency domain; #HYBRID_BANDS x #MAX_NUM_SH_SIGNALS x #TIME_SLOTS */
-    void* hSTFT;                     /**< Time-frequency transform handle */
-    float freqVector[HYBRID_BANDS];  /**< Frequency vector */
+    float_complex*** inputFrameTF;   /**< Input SH signals, in the time-frequency domain; #MAX_NUM_BANDS x #MAX_NUM_SH_SIGNALS x #TIME_SLOTS */
+    float_complex*** outputFrameTF;  /**< Output SH signals, in the time-frequency domain; #MAX_NUM_BANDS x #MAX_NUM_SH_SIGNALS x #TIME_SLOTS */
+    void* hFB;                       /**< Filterbank handle (see saf_filterbank_create()) */
+    int nBands;                      /**< Number of frequency bands of the current filterbank */
+    int fbDelay;                     /**< Processing delay of the current filterbank, in samples */
+    float freqVector[MAX_NUM_BANDS]; /**< Frequency vector; #MAX_NUM_BANDS x 1 (only the first nBands are used) */
 
     /* internal */
     int nSH;                         /**< Current number of SH signals */
     int new_nSH;                     /**< New number of SH signals (current value will be replaced by this after next re-init) */
     float fs;                        /**< Host sampling rate, in Hz */
-    float yL_z1[HYBRID_BANDS];       /**< Delay elements */
+    float yL_z1[MAX_NUM_BANDS];      /**< Delay elements */
     int reInitTFT;                   /**< 0: no init required, 1: init required, 2: init in progress */
 
 #ifdef ENABLE_TF_DISPLAY
@@ -111,6 +118,8 @@ typedef struct _ambi_drc
     CH_ORDER chOrdering;             /**< Ambisonic channel order convention (see #CH_ORDER) */
     NORM_TYPES norm;                 /**< Ambisonic normalisation convention (see #NORM_TYPES) */
     SH_ORDERS currentOrder;          /**< Current input SH order */
+    AMBI_DRC_FILTERBANKS fbType;     /**< Current filterbank (see #AMBI_DRC_FILTERBANKS) */
+    AMBI_DRC_FILTERBANKS new_fbType; /**< New filterbank (current value will be replaced by this after next re-init) */
     
 } ambi_drc_data;
      
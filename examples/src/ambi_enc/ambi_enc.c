@@ -49,6 +49,9 @@ void ambi_enc_create
     pData->norm = NORM_SN3D;
     pData->order = SH_ORDER_FIRST;
     pData->enablePostScaling = 1;
+
+    /* for passing arbitrary host block sizes through ambi_enc_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), AMBI_ENC_FRAME_SIZE, MAX_NUM_INPUTS, MAX_NUM_SH_SIGNALS);
 }
 
 void ambi_enc_destroy
@@ -59,6 +62,7 @@ void ambi_enc_destroy
     ambi_enc_data *pData = (ambi_enc_data*)(*phAmbi);
     
     if (pData != NULL) {
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phAmbi = NULL;
@@ -68,7 +72,8 @@ void ambi_enc_destroy
 void ambi_enc_init
 (
     void * const hAmbi,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     ambi_enc_data *pData = (ambi_enc_data*)(hAmbi);
@@ -83,9 +88,13 @@ void ambi_enc_init
     memset(pData->prev_inputFrameTD, 0, MAX_NUM_INPUTS*AMBI_ENC_FRAME_SIZE*sizeof(float));
     for(i=0; i<MAX_NUM_INPUTS; i++)
         pData->recalc_SH_FLAG[i] = 1;
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
-void ambi_enc_process
+/** Processes one frame of #AMBI_ENC_FRAME_SIZE samples (see ambi_enc_process()) */
+static void ambi_enc_processFrame
 (
     void        *  const hAmbi,
     const float *const * inputs,
@@ -197,6 +206,22 @@ void ambi_enc_process
     }
 }
 
+void ambi_enc_process
+(
+    void        *  const hAmbi,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    ambi_enc_data *pData = (ambi_enc_data*)(hAmbi);
+
+    /* Process the host buffers in frames of #AMBI_ENC_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, ambi_enc_processFrame, hAmbi);
+}
+
 /* Set Functions */
 
 int ambi_enc_getFrameSize(void)
@@ -368,7 +393,8 @@ int ambi_enc_getEnablePostScaling(void* const hAmbi)
     return pData->enablePostScaling;
 }
 
-int ambi_enc_getProcessingDelay()
+int ambi_enc_getProcessingDelay(void* const hAmbi)
 {
-    return AMBI_ENC_FRAME_SIZE;
+    ambi_enc_data *pData = (ambi_enc_data*)(hAmbi);
+    return AMBI_ENC_FRAME_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
@@ -57,6 +57,7 @@ extern "C" {
 typedef struct _ambi_enc
 {
     /* Internal audio buffers */
+    void* hBlockAdapter;                                                  /**< Block adapter handle (for arbitrary host block sizes) */
     float inputFrameTD[MAX_NUM_INPUTS][AMBI_ENC_FRAME_SIZE];              /**< Input frame of signals */
     float prev_inputFrameTD[MAX_NUM_INPUTS][AMBI_ENC_FRAME_SIZE];         /**< Previous frame of signals */
     float tempFrame_fadeOut[MAX_NUM_SH_SIGNALS][AMBI_ENC_FRAME_SIZE];     /**< Temporary frame with linear interpolation (fade-out) applied */
@@ -74,6 +74,9 @@ void ambi_roomsim_create
     pData->rec_sh_outsigs = (float***)malloc3d(IMS_MAX_NUM_RECEIVERS, MAX_NUM_SH_SIGNALS, AMBI_ROOMSIM_FRAME_SIZE, sizeof(float));
 
     pData->reinit_room = 1;
+
+    /* for passing arbitrary host block sizes through ambi_roomsim_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), AMBI_ROOMSIM_FRAME_SIZE, ROOM_SIM_MAX_NUM_SOURCES, MAX_NUM_CHANNELS);
 }
 
 void ambi_roomsim_destroy
@@ -87,6 +90,7 @@ void ambi_roomsim_destroy
         ims_shoebox_destroy(&(pData->hIms));
         free(pData->src_sigs);
         free(pData->rec_sh_outsigs);
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phAmbi = NULL;
@@ -96,14 +100,19 @@ void ambi_roomsim_destroy
 void ambi_roomsim_init
 (
     void * const hAmbi,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     ambi_roomsim_data *pData = (ambi_roomsim_data*)(hAmbi);
     pData->fs = (float)sampleRate;
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
-void ambi_roomsim_process
+/** Processes one frame of #AMBI_ROOMSIM_FRAME_SIZE samples (see ambi_roomsim_process()) */
+static void ambi_roomsim_processFrame
 (
     void        *  const hAmbi,
     const float *const * inputs,
@@ -216,6 +225,22 @@ void ambi_roomsim_process
     }
 }
 
+void ambi_roomsim_process
+(
+    void        *  const hAmbi,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    ambi_roomsim_data *pData = (ambi_roomsim_data*)(hAmbi);
+
+    /* Process the host buffers in frames of #AMBI_ROOMSIM_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, ambi_roomsim_processFrame, hAmbi);
+}
+
 /* Set Functions */
 
 void ambi_roomsim_refreshParams(void* const hAmbi)
@@ -485,7 +510,8 @@ int ambi_roomsim_getNormType(void* const hAmbi)
     return (int)pData->norm;
 }
 
-int ambi_roomsim_getProcessingDelay()
+int ambi_roomsim_getProcessingDelay(void* const hAmbi)
 {
-    return AMBI_ROOMSIM_FRAME_SIZE;
+    ambi_roomsim_data *pData = (ambi_roomsim_data*)(hAmbi);
+    return AMBI_ROOMSIM_FRAME_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
@@ -57,6 +57,7 @@ extern "C" {
 typedef struct _ambi_roomsim
 {
     /* Internals */
+    void* hBlockAdapter;                                              /**< Block adapter handle (for arbitrary host block sizes) */
     float inputFrameTD[MAX_NUM_INPUTS][AMBI_ROOMSIM_FRAME_SIZE];      /**< Input frame of signals */
     float outputFrameTD[MAX_NUM_SH_SIGNALS][AMBI_ROOMSIM_FRAME_SIZE]; /**< Output frame of SH signals */
     float fs;                 /**< Host sampling rate, in Hz */
@@ -72,10 +72,10 @@ void array2sh_create
     /* time-frequency transform + buffers */
     pData->fs = 48000.0f;
     pData->hSTFT = NULL;
-    pData->inputFrameTD = (float**)malloc2d(MAX_NUM_SENSORS, ARRAY2SH_FRAME_SIZE, sizeof(float));
-    pData->SHframeTD = (float**)malloc2d(MAX_NUM_SH_SIGNALS, ARRAY2SH_FRAME_SIZE, sizeof(float));
-    pData->inputframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_SENSORS, TIME_SLOTS, sizeof(float_complex));
-    pData->SHframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
+    pData->inputFrameTD = (float**)malloc2d_aligned(MAX_NUM_SENSORS, ARRAY2SH_FRAME_SIZE, sizeof(float));
+    pData->SHframeTD = (float**)calloc2d_aligned(MAX_NUM_SH_SIGNALS, ARRAY2SH_FRAME_SIZE, sizeof(float));
+    pData->inputframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_SENSORS, TIME_SLOTS, sizeof(float_complex));
+    pData->SHframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
 
     /* internal */
     pData->progressBar0_1 = 0.0f;
@@ -99,6 +99,9 @@ void array2sh_create
     pData->bN_inv_dB = (float**)calloc2d(HYBRID_BANDS, MAX_SH_ORDER + 1, sizeof(float));
     pData->cSH = (float*)calloc1d((HYBRID_BANDS)*(MAX_SH_ORDER + 1),sizeof(float));
     pData->lSH = (float*)calloc1d((HYBRID_BANDS)*(MAX_SH_ORDER + 1),sizeof(float));
+
+    /* for passing arbitrary host block sizes through array2sh_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), ARRAY2SH_FRAME_SIZE, MAX_NUM_SENSORS, MAX_NUM_SH_SIGNALS);
 }
 
 void array2sh_destroy
@@ -116,10 +119,10 @@ void array2sh_destroy
         /* free afSTFT and buffers */
         if (pData->hSTFT != NULL)
             afSTFT_destroy(&(pData->hSTFT));
-        free(pData->inputFrameTD);
-        free(pData->SHframeTD);
-        free(pData->inputframeTF);
-        free(pData->SHframeTF);
+        free2d_aligned((void**)pData->inputFrameTD);
+        free2d_aligned((void**)pData->SHframeTD);
+        free3d_aligned((void***)pData->inputframeTF);
+        free3d_aligned((void***)pData->SHframeTF);
         array2sh_destroyArray(&(pData->arraySpecs));
 
         /* For diffuse-field equalisation */
@@ -139,6 +142,7 @@ void array2sh_destroy
         free(pData->cSH);
         free(pData->lSH);
         
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phM2sh = NULL;
@@ -148,7 +152,8 @@ void array2sh_destroy
 void array2sh_init
 (
     void * const hA2sh,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     array2sh_data *pData = (array2sh_data*)(hA2sh); 
@@ -156,6 +161,9 @@ void array2sh_init
     pData->fs = sampleRate;
     afSTFT_getCentreFreqs(pData->hSTFT, (float)pData->fs, HYBRID_BANDS, pData->freqVector);
     pData->freqVector[0] = pData->freqVector[1]/4.0f; /* avoids NaNs at DC */
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
 void array2sh_evalEncoder
@@ -182,7 +190,8 @@ void array2sh_evalEncoder
     pData->evalStatus = EVAL_STATUS_RECENTLY_EVALUATED;
 }
 
-void array2sh_process
+/** Processes one frame of #ARRAY2SH_FRAME_SIZE samples (see array2sh_process()) */
+static void array2sh_processFrame
 (
     void        *  const hA2sh,
     const float *const * inputs,
@@ -220,8 +229,6 @@ void array2sh_process
 
     /* processing loop */
     if ((nSamples == ARRAY2SH_FRAME_SIZE) && (pData->reinitSHTmatrixFLAG==0) ) {
-        pData->procStatus = PROC_STATUS_ONGOING;
-
         /* Load time-domain data */
         for(i=0; i < nInputs; i++)
             utility_svvcopy(inputs[i], ARRAY2SH_FRAME_SIZE, pData->inputFrameTD[i]);
@@ -229,34 +236,34 @@ void array2sh_process
             memset(pData->inputFrameTD[i], 0, ARRAY2SH_FRAME_SIZE * sizeof(float));
 
         /* Apply time-frequency transform (TFT) */
-        afSTFT_forward_knownDimensions(pData->hSTFT, pData->inputFrameTD, ARRAY2SH_FRAME_SIZE, MAX_NUM_SENSORS, TIME_SLOTS, pData->inputframeTF);
+        afSTFT_forward_knownDimensions(pData->hSTFT, pData->inputFrameTD, ARRAY2SH_FRAME_SIZE, MAX_NUM_SENSORS, TIME_SLOTS_STRIDE, pData->inputframeTF);
 
         /* Apply spherical harmonic transform (SHT) */
         for(band=0; band<HYBRID_BANDS; band++){
             cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nSH, TIME_SLOTS, Q, &calpha,
                         pData->W[band], MAX_NUM_SENSORS,
-                        FLATTEN2D(pData->inputframeTF[band]), TIME_SLOTS, &cbeta,
-                        FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS);
+                        FLATTEN2D(pData->inputframeTF[band]), TIME_SLOTS_STRIDE, &cbeta,
+                        FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS_STRIDE);
         }
 
         /* inverse-TFT */
-        afSTFT_backward_knownDimensions(pData->hSTFT, pData->SHframeTF, ARRAY2SH_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS, pData->SHframeTD);
+        afSTFT_backward_knownDimensions(pData->hSTFT, pData->SHframeTF, ARRAY2SH_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS_STRIDE, pData->SHframeTD);
 
         /* account for output channel order */
         switch(chOrdering){
             case CH_ACN:  /* already ACN, do nothing */ break;
-            case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHframeTD), order, ARRAY2SH_FRAME_SIZE, HOA_CH_ORDER_ACN, HOA_CH_ORDER_FUMA); break;
+            case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHframeTD), order, ARRAY2SH_FRAME_STRIDE, HOA_CH_ORDER_ACN, HOA_CH_ORDER_FUMA); break;
         }
 
         /* account for normalisation scheme */
         switch(norm){
             case NORM_N3D:  /* already N3D, do nothing */ break;
-            case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), order, ARRAY2SH_FRAME_SIZE, HOA_NORM_N3D, HOA_NORM_SN3D); break;
-            case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), order, ARRAY2SH_FRAME_SIZE, HOA_NORM_N3D, HOA_NORM_FUMA); break;
+            case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), order, ARRAY2SH_FRAME_STRIDE, HOA_NORM_N3D, HOA_NORM_SN3D); break;
+            case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), order, ARRAY2SH_FRAME_STRIDE, HOA_NORM_N3D, HOA_NORM_FUMA); break;
         }
 
         /* Apply post-gain */
-        utility_svsmul(FLATTEN2D(pData->SHframeTD), &gain_lin, nSH*ARRAY2SH_FRAME_SIZE, NULL);
+        utility_svsmul(FLATTEN2D(pData->SHframeTD), &gain_lin, nSH*ARRAY2SH_FRAME_STRIDE, NULL);
 
         /* Copy to output */
         for(i = 0; i < SAF_MIN(nSH,nOutputs); i++)
@@ -268,8 +275,22 @@ void array2sh_process
         for (ch=0; ch < nOutputs; ch++)
             memset(outputs[ch],0, ARRAY2SH_FRAME_SIZE*sizeof(float));
     }
+}
+
+void array2sh_process
+(
+    void        *  const hA2sh,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    array2sh_data *pData = (array2sh_data*)(hA2sh);
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    /* Process the host buffers in frames of #ARRAY2SH_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, array2sh_processFrame, hA2sh);
 }
 
 /* Set Functions */
@@ -722,7 +743,8 @@ int array2sh_getSamplingRate(void* const hA2sh)
     return pData->fs;
 }
 
-int array2sh_getProcessingDelay()
+int array2sh_getProcessingDelay(void* const hA2sh)
 {
-    return 12*HOP_SIZE;
+    array2sh_data *pData = (array2sh_data*)(hA2sh);
+    return 12*HOP_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
@@ -72,6 +72,8 @@ extern "C" {
 #define HOP_SIZE ( 128 )                              /**< STFT hop size */
 #define HYBRID_BANDS ( HOP_SIZE + 5 )                 /**< Number of frequency bands */
 #define TIME_SLOTS ( ARRAY2SH_FRAME_SIZE / HOP_SIZE ) /**< Number of STFT timeslots */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
+#define ARRAY2SH_FRAME_STRIDE ( (int)md_alignedStride(ARRAY2SH_FRAME_SIZE, sizeof(float)) ) /**< Distance between the rows of the time-domain frames (#ARRAY2SH_FRAME_SIZE, padded to whole cache lines) */
 #define MAX_NUM_SENSORS ( ARRAY2SH_MAX_NUM_SENSORS )  /**< Maximum permitted number of inputs/sensors */
 #define MAX_EVAL_FREQ_HZ ( 20e3f )                    /**< Up to which frequency should the evaluation be accurate */
 #define MAX_NUM_SENSORS_IN_PRESET ( MAX_NUM_SENSORS ) /**< Maximum permitted number of inputs/sensors */
@@ -105,6 +107,7 @@ typedef struct _array2sh_arrayPars {
 typedef struct _array2sh
 {
     /* audio buffers */
+    void* hBlockAdapter;            /**< Block adapter handle (for arbitrary host block sizes) */
     float** inputFrameTD;           /**< Input sensor signals in the time-domain; #MAX_NUM_SENSORS x #ARRAY2SH_FRAME_SIZE */
     float** SHframeTD;              /**< Output SH signals in the time-domain; #MAX_NUM_SH_SIGNALS x #ARRAY2SH_FRAME_SIZE */
     float_complex*** inputframeTF;  /**< Input sensor signals in the time-domain; #HYBRID_BANDS x #MAX_NUM_SENSORS x #TIME_SLOTS */
@@ -144,7 +147,6 @@ typedef struct _array2sh
     double_complex* W_tmp;
 
     /* flags */
-    PROC_STATUS procStatus;         /**< see #PROC_STATUS */
     int reinitSHTmatrixFLAG;        /**< 0: do not reinit; 1: reinit; */
     int evalRequestedFLAG;          /**< 0: do not reinit; 1: reinit; */
     
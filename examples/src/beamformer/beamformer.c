@@ -51,6 +51,9 @@ void beamformer_create
     /* flags */
     for(ch=0; ch<MAX_NUM_BEAMS; ch++)
         pData->recalc_beamWeights[ch] = 1;
+
+    /* for passing arbitrary host block sizes through beamformer_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), BEAMFORMER_FRAME_SIZE, MAX_NUM_SH_SIGNALS, MAX_NUM_BEAMS);
 }
 
 void beamformer_destroy
@@ -62,6 +65,7 @@ void beamformer_destroy
     
     if (pData != NULL) {
         
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phBeam = NULL;
@@ -71,7 +75,8 @@ void beamformer_destroy
 void beamformer_init
 (
     void * const hBeam,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     beamformer_data *pData = (beamformer_data*)(hBeam);
@@ -90,9 +95,13 @@ void beamformer_init
         pData->interpolator_fadeIn[i-1] = (float)i*1.0f/(float)BEAMFORMER_FRAME_SIZE;
         pData->interpolator_fadeOut[i-1] = 1.0f - pData->interpolator_fadeIn[i-1];
     }
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
-void beamformer_process
+/** Processes one frame of #BEAMFORMER_FRAME_SIZE samples (see beamformer_process()) */
+static void beamformer_processFrame
 (
     void        *  const hBeam,
     const float *const * inputs,
@@ -193,6 +202,22 @@ void beamformer_process
             memset(outputs[ch], 0, BEAMFORMER_FRAME_SIZE*sizeof(float));
 }
 
+void beamformer_process
+(
+    void        *  const hBeam,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    beamformer_data *pData = (beamformer_data*)(hBeam);
+
+    /* Process the host buffers in frames of #BEAMFORMER_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, beamformer_processFrame, hBeam);
+}
+
 
 /* Set Functions */
 
@@ -332,9 +357,10 @@ int beamformer_getBeamType(void* const hBeam)
     return pData->beamType;
 }
 
-int beamformer_getProcessingDelay()
+int beamformer_getProcessingDelay(void* const hBeam)
 {
-    return BEAMFORMER_FRAME_SIZE;
+    beamformer_data *pData = (beamformer_data*)(hBeam);
+    return BEAMFORMER_FRAME_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
 
 
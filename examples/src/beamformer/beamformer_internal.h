@@ -59,6 +59,7 @@ extern "C" {
 typedef struct _beamformer
 {
     /* Internal audio buffers */
+    void* hBlockAdapter;                                                    /**< Block adapter handle (for arbitrary host block sizes) */
     float SHFrameTD[MAX_NUM_SH_SIGNALS][BEAMFORMER_FRAME_SIZE];             /**< Input frame of SH signals */
     float prev_SHFrameTD[MAX_NUM_SH_SIGNALS][BEAMFORMER_FRAME_SIZE];        /**< Previous frame of SH signals */
     float tempFrame[MAX_NUM_BEAMS][BEAMFORMER_FRAME_SIZE];                  /**< Temporary frame */
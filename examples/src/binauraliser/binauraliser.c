@@ -57,12 +57,11 @@ void binauraliser_create
     pData->enableRotation = 0;
 
     /* time-frequency transform + buffers */
-    pData->hSTFT = NULL;
     pData->fs = 48000.0f;
-    pData->inputFrameTD = (float**)malloc2d(MAX_NUM_INPUTS, BINAURALISER_FRAME_SIZE, sizeof(float));
-    pData->outframeTD = (float**)malloc2d(NUM_EARS, BINAURALISER_FRAME_SIZE, sizeof(float));
-    pData->inputframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_INPUTS, TIME_SLOTS, sizeof(float_complex));
-    pData->outputframeTF = (float_complex***)malloc3d(HYBRID_BANDS, NUM_EARS, TIME_SLOTS, sizeof(float_complex));
+    pData->inputFrameTD = (float**)malloc2d_aligned(MAX_NUM_INPUTS, BINAURALISER_FRAME_SIZE, sizeof(float));
+    pData->outframeTD = (float**)malloc2d_aligned(NUM_EARS, BINAURALISER_FRAME_SIZE, sizeof(float));
+    pData->inputframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_INPUTS, TIME_SLOTS, sizeof(float_complex));
+    pData->outputframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, NUM_EARS, TIME_SLOTS, sizeof(float_complex));
     
     /* hrir data */
     pData->hrirs = NULL;
@@ -71,29 +70,27 @@ void binauraliser_create
     pData->weights = NULL;
     pData->N_hrir_dirs = pData->hrir_loaded_len = pData->hrir_runtime_len = 0;
     pData->hrir_loaded_fs = pData->hrir_runtime_fs = -1; /* unknown */
-    
-    /* vbap (amplitude normalised) */
-    pData->hrtf_vbap_gtableIdx = NULL;
-    pData->hrtf_vbap_gtableComp = NULL;
-    pData->nTriangles = pData->N_hrtf_vbap_gtable = 0;
-    
-    /* HRTF filterbank coefficients */
-    pData->itds_s = NULL;
-    pData->hrtf_fb = NULL;
-    pData->hrtf_fb_mag = NULL;
+    pData->nTriangles = 0;
+
+    /* render states (afSTFT, HRTFs and vbap tables) are built by binauraliser_initCodec() */
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
 
     /* flags/status */
     pData->progressBar0_1 = 0.0f;
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    pData->initLock = 0;
     pData->reInitHRTFsAndGainTables = 1;
     for(ch=0; ch<MAX_NUM_INPUTS; ch++) {
         pData->recalc_hrtf_interpFLAG[ch] = 1;
         pData->src_gains[ch] = 1.f;
     }
-    pData->recalc_M_rotFLAG = 1; 
+    pData->recalc_M_rotFLAG = 1;
+
+    /* for passing arbitrary host block sizes through binauraliser_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), BINAURALISER_FRAME_SIZE, MAX_NUM_INPUTS, NUM_EARS);
 }
 
 void binauraliser_destroy
@@ -102,32 +99,30 @@ void binauraliser_destroy
 )
 {
     binauraliser_data *pData = (binauraliser_data*)(*phBin);
+    binauraliser_renderState *state;
 
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
+        /* Wait for any on-going initialisation to complete, and then take back the current render state (which also
+         * waits for the processing loop to let go of it) */
+        saf_spinLock_lock(&(pData->initLock));
+        state = (binauraliser_renderState*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(state==pData->liveState, "Unexpected render state");
+        binauraliser_destroyRenderState(&state);
+        binauraliser_destroyRenderState(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
         
-        /* free afSTFT and buffers */
-        if(pData->hSTFT !=NULL)
-            afSTFT_destroy(&(pData->hSTFT));
-        free(pData->inputFrameTD);
-        free(pData->outframeTD);
-        free(pData->inputframeTF);
-        free(pData->outputframeTF);
-        free(pData->hrtf_vbap_gtableComp);
-        free(pData->hrtf_vbap_gtableIdx);
-        free(pData->hrtf_fb);
-        free(pData->hrtf_fb_mag);
-        free(pData->itds_s);
+        /* free buffers */
+        free2d_aligned((void**)pData->inputFrameTD);
+        free2d_aligned((void**)pData->outframeTD);
+        free3d_aligned((void***)pData->inputframeTF);
+        free3d_aligned((void***)pData->outputframeTF);
         free(pData->sofa_filepath);
         free(pData->hrirs);
         free(pData->hrir_dirs_deg);
         free(pData->weights);
         free(pData->progressBarText);
          
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phBin = NULL;
@@ -137,21 +132,25 @@ void binauraliser_destroy
 void binauraliser_init
 (
     void * const hBin,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     binauraliser_data *pData = (binauraliser_data*)(hBin);
     
     /* define frequency vector */
     pData->fs = sampleRate;
-    afSTFT_getCentreFreqs(pData->hSTFT, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
+    afSTFT_getCentreFreqs(NULL, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
     if(pData->hrir_runtime_fs!=pData->fs){
-        pData->reInitHRTFsAndGainTables = 1;
+        saf_atomic_store(&(pData->reInitHRTFsAndGainTables), 1);
         binauraliser_setCodecStatus(hBin, CODEC_STATUS_NOT_INITIALISED);
     }
 
     /* defaults */
     pData->recalc_M_rotFLAG = 1;
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
 void binauraliser_initCodec
@@ -160,37 +159,57 @@ void binauraliser_initCodec
 )
 {
     binauraliser_data *pData = (binauraliser_data*)(hBin);
+    binauraliser_renderState* state;
+    int reinitHRTFs;
     
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
+
+    /* Take (and clear) the HRTF flag now, such that a refresh requested during this initialisation is not lost */
+    reinitHRTFs = saf_atomic_compareExchange(&(pData->reInitHRTFsAndGainTables), 1, 0);
     
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Initialising");
     pData->progressBar0_1 = 0.0f;
+
+    /* The new render state is built in the spare one, while the audio thread keeps rendering with the current one */
+    if(pData->spareState==NULL)
+        binauraliser_createRenderState(&(pData->spareState));
+    state = pData->spareState;
     
     /* check if TFT needs to be reinitialised */
-    binauraliser_initTFT(hBin);
+    binauraliser_initTFT(hBin, state);
     
-    /* reinit HRTFs and interpolation tables */
-    if(pData->reInitHRTFsAndGainTables){
-        binauraliser_initHRTFsAndGainTables(hBin);
-        pData->reInitHRTFsAndGainTables = 0;
-    }
+    /* reinit HRTFs and interpolation tables (or carry over those currently in use). The previous tables of the spare
+     * render state are released all at once (the memory is re-used) */
+    saf_arena_reset(state->hArena);
+    if(reinitHRTFs || pData->liveState==NULL)
+        binauraliser_initHRTFsAndGainTables(hBin, state);
+    else
+        binauraliser_copyHRTFs(state, pData->liveState);
+    state->reinterpFLAG = 1;
+
+    /* Hand the new render state over to the audio thread, and keep the previous one as the spare, once it is no longer
+     * being used */
+    pData->spareState = (binauraliser_renderState*)saf_stateSwap_publish(pData->hStateSwap, (void*)state);
+    pData->liveState = state;
+    if(pData->spareState!=NULL && pData->spareState->hSTFT == state->hSTFT)
+        pData->spareState->hSTFT = NULL; /* (passed on to the new render state) */
     
-    /* done! */
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
-    
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
-void binauraliser_process
+/** Processes one frame of #BINAURALISER_FRAME_SIZE samples (see binauraliser_process()) */
+static void binauraliser_processFrame
 (
     void        *  const hBin,
     const float *const * inputs,
@@ -201,17 +220,28 @@ void binauraliser_process
 )
 {
     binauraliser_data *pData = (binauraliser_data*)(hBin);
+    binauraliser_renderState* state;
     int ch, ear, i, band, nSources;
     float Rxyz[3][3], hypotxy;
     int enableRotation;
 
     /* copy user parameters to local variables */
-    nSources = pData->nSources;
     enableRotation = pData->enableRotation;
+
+    /* The current render state remains valid (and untouched by binauraliser_initCodec()) until it is released */
+    state = (binauraliser_renderState*)saf_stateSwap_acquire(pData->hStateSwap);
     
     /* apply binaural panner */
-    if ((nSamples == BINAURALISER_FRAME_SIZE) && (pData->hrtf_fb!=NULL) && (pData->codecStatus==CODEC_STATUS_INITIALISED) ){
-        pData->procStatus = PROC_STATUS_ONGOING;
+    if ((nSamples == BINAURALISER_FRAME_SIZE) && (state!=NULL)){
+        nSources = state->nSources;
+
+        /* The HRTFs (and rotated source directions) are re-interpolated after switching to a new render state */
+        if(state->reinterpFLAG){
+            for(ch=0; ch<MAX_NUM_INPUTS; ch++)
+                pData->recalc_hrtf_interpFLAG[ch] = 1;
+            pData->recalc_M_rotFLAG = 1;
+            state->reinterpFLAG = 0;
+        }
 
         /* Load time-domain data */
         for(i=0; i < SAF_MIN(nSources,nInputs); i++)
@@ -226,7 +256,7 @@ void binauraliser_process
         }
 
         /* Apply time-frequency transform (TFT) */
-        afSTFT_forward_knownDimensions(pData->hSTFT, pData->inputFrameTD, BINAURALISER_FRAME_SIZE, MAX_NUM_INPUTS, TIME_SLOTS, pData->inputframeTF);
+        afSTFT_forward_knownDimensions(state->hSTFT, pData->inputFrameTD, BINAURALISER_FRAME_SIZE, MAX_NUM_INPUTS, TIME_SLOTS_STRIDE, pData->inputframeTF);
 
         /* Rotate source directions */
         if(enableRotation && pData->recalc_M_rotFLAG){
@@ -250,13 +280,13 @@ void binauraliser_process
         }
 
         /* interpolate hrtfs and apply to each source */
-        memset(FLATTEN3D(pData->outputframeTF), 0, HYBRID_BANDS*NUM_EARS*TIME_SLOTS * sizeof(float_complex));
+        memset(FLATTEN3D(pData->outputframeTF), 0, HYBRID_BANDS*NUM_EARS*TIME_SLOTS_STRIDE * sizeof(float_complex));
         for (ch = 0; ch < nSources; ch++) {
             if(pData->recalc_hrtf_interpFLAG[ch]){
                 if(enableRotation)
-                    binauraliser_interpHRTFs(hBin, pData->interpMode, pData->src_dirs_rot_deg[ch][0], pData->src_dirs_rot_deg[ch][1], pData->hrtf_interp[ch]);
+                    binauraliser_interpHRTFs(hBin, state, pData->interpMode, pData->src_dirs_rot_deg[ch][0], pData->src_dirs_rot_deg[ch][1], pData->hrtf_interp[ch]);
                 else
-                    binauraliser_interpHRTFs(hBin, pData->interpMode, pData->src_dirs_deg[ch][0], pData->src_dirs_deg[ch][1], pData->hrtf_interp[ch]);
+                    binauraliser_interpHRTFs(hBin, state, pData->interpMode, pData->src_dirs_deg[ch][0], pData->src_dirs_deg[ch][1], pData->hrtf_interp[ch]);
                 pData->recalc_hrtf_interpFLAG[ch] = 0;
             }
 
@@ -267,10 +297,10 @@ void binauraliser_process
         }
 
         /* scale by number of sources */ 
-        cblas_sscal(/*re+im*/2*HYBRID_BANDS*NUM_EARS*TIME_SLOTS, 1.0f/sqrtf((float)nSources), (float*)FLATTEN3D(pData->outputframeTF), 1);
+        cblas_sscal(/*re+im*/2*HYBRID_BANDS*NUM_EARS*TIME_SLOTS_STRIDE, 1.0f/sqrtf((float)nSources), (float*)FLATTEN3D(pData->outputframeTF), 1);
 
         /* inverse-TFT */
-        afSTFT_backward_knownDimensions(pData->hSTFT, pData->outputframeTF, BINAURALISER_FRAME_SIZE, NUM_EARS, TIME_SLOTS, pData->outframeTD);
+        afSTFT_backward_knownDimensions(state->hSTFT, pData->outputframeTF, BINAURALISER_FRAME_SIZE, NUM_EARS, TIME_SLOTS_STRIDE, pData->outframeTD);
 
         /* Copy to output buffer */
         for (ch = 0; ch < SAF_MIN(NUM_EARS, nOutputs); ch++)
@@ -283,7 +313,23 @@ void binauraliser_process
             memset(outputs[ch],0, BINAURALISER_FRAME_SIZE*sizeof(float));
     }
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void binauraliser_process
+(
+    void        *  const hBin,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    binauraliser_data *pData = (binauraliser_data*)(hBin);
+
+    /* Process the host buffers in frames of #BINAURALISER_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, binauraliser_processFrame, hBin);
 }
 
 /* Set Functions */
@@ -292,7 +338,7 @@ void binauraliser_refreshSettings(void* const hBin)
 {
     binauraliser_data *pData = (binauraliser_data*)(hBin);
     int ch;
-    pData->reInitHRTFsAndGainTables = 1;
+    saf_atomic_store(&(pData->reInitHRTFsAndGainTables), 1);
     for(ch=0; ch<MAX_NUM_INPUTS; ch++)
         pData->recalc_hrtf_interpFLAG[ch] = 1;
     binauraliser_setCodecStatus(hBin, CODEC_STATUS_NOT_INITIALISED);
@@ -485,7 +531,7 @@ int binauraliser_getFrameSize(void)
 CODEC_STATUS binauraliser_getCodecStatus(void* const hBin)
 {
     binauraliser_data *pData = (binauraliser_data*)(hBin);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float binauraliser_getProgressBar0_1(void* const hBin)
@@ -651,7 +697,8 @@ int binauraliser_getInterpMode(void* const hBin)
     return (int)pData->interpMode;
 }
 
-int binauraliser_getProcessingDelay()
+int binauraliser_getProcessingDelay(void* const hBin)
 {
-    return 12*HOP_SIZE;
+    binauraliser_data *pData = (binauraliser_data*)(hBin);
+    return 12*HOP_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
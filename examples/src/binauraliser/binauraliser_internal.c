@@ -35,17 +35,69 @@
 void binauraliser_setCodecStatus(void* const hBin, CODEC_STATUS newStatus)
 {
     binauraliser_data *pData = (binauraliser_data*)(hBin);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next binauraliser_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void binauraliser_createRenderState(binauraliser_renderState** const pState)
+{
+    binauraliser_renderState* state = (binauraliser_renderState*)malloc1d(sizeof(binauraliser_renderState));
+    *pState = state;
+
+    state->nSources = 0;
+    state->hSTFT = NULL;
+    saf_arena_create(&(state->hArena), 0); /* (sized by the first binauraliser_initCodec() call that uses this state) */
+    state->N_hrir_dirs = state->N_hrtf_vbap_gtable = 0;
+    state->hrtf_vbapTableRes[0] = state->hrtf_vbapTableRes[1] = 0;
+    state->hrtf_vbap_gtableIdx = NULL;
+    state->hrtf_vbap_gtableComp = NULL;
+    state->itds_s = NULL;
+    state->hrtf_fb = NULL;
+    state->hrtf_fb_mag = NULL;
+    state->reinterpFLAG = 1;
+}
+
+void binauraliser_destroyRenderState(binauraliser_renderState** const pState)
+{
+    binauraliser_renderState* state = *pState;
+
+    if(state!=NULL){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        saf_arena_destroy(&(state->hArena));
+        free(state);
+        state = NULL;
+        *pState = NULL;
     }
-    pData->codecStatus = newStatus;
+}
+
+void binauraliser_copyHRTFs
+(
+    binauraliser_renderState* const dst,
+    const binauraliser_renderState* const src
+)
+{
+    dst->N_hrir_dirs = src->N_hrir_dirs;
+    dst->hrtf_vbapTableRes[0] = src->hrtf_vbapTableRes[0];
+    dst->hrtf_vbapTableRes[1] = src->hrtf_vbapTableRes[1];
+    dst->N_hrtf_vbap_gtable = src->N_hrtf_vbap_gtable;
+    dst->hrtf_vbap_gtableIdx = saf_arena_malloc1d(dst->hArena, src->N_hrtf_vbap_gtable*3*sizeof(int));
+    memcpy(dst->hrtf_vbap_gtableIdx, src->hrtf_vbap_gtableIdx, src->N_hrtf_vbap_gtable*3*sizeof(int));
+    dst->hrtf_vbap_gtableComp = saf_arena_malloc1d(dst->hArena, src->N_hrtf_vbap_gtable*3*sizeof(float));
+    memcpy(dst->hrtf_vbap_gtableComp, src->hrtf_vbap_gtableComp, src->N_hrtf_vbap_gtable*3*sizeof(float));
+    dst->itds_s = saf_arena_malloc1d(dst->hArena, src->N_hrir_dirs*sizeof(float));
+    memcpy(dst->itds_s, src->itds_s, src->N_hrir_dirs*sizeof(float));
+    dst->hrtf_fb = saf_arena_malloc1d(dst->hArena, HYBRID_BANDS*NUM_EARS*(src->N_hrir_dirs)*sizeof(float_complex));
+    memcpy(dst->hrtf_fb, src->hrtf_fb, HYBRID_BANDS*NUM_EARS*(src->N_hrir_dirs)*sizeof(float_complex));
+    dst->hrtf_fb_mag = saf_arena_malloc1d(dst->hArena, HYBRID_BANDS*NUM_EARS*(src->N_hrir_dirs)*sizeof(float));
+    memcpy(dst->hrtf_fb_mag, src->hrtf_fb_mag, HYBRID_BANDS*NUM_EARS*(src->N_hrir_dirs)*sizeof(float));
 }
 
 void binauraliser_interpHRTFs
 (
     void* const hBin,
+    binauraliser_renderState* const state,
     INTERP_MODES mode,
     float azimuth_deg,
     float elevation_deg,
@@ -62,14 +114,14 @@ void binauraliser_interpHRTFs
     const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
      
     /* find closest pre-computed VBAP direction */
-    aziRes = (float)pData->hrtf_vbapTableRes[0];
-    elevRes = (float)pData->hrtf_vbapTableRes[1];
+    aziRes = (float)state->hrtf_vbapTableRes[0];
+    elevRes = (float)state->hrtf_vbapTableRes[1];
     N_azi = (int)(360.0f / aziRes + 0.5f) + 1;
     aziIndex = (int)(matlab_fmodf(azimuth_deg + 180.0f, 360.0f) / aziRes + 0.5f);
     elevIndex = (int)((elevation_deg + 90.0f) / elevRes + 0.5f);
     idx3d = elevIndex * N_azi + aziIndex;
     for (i = 0; i < 3; i++)
-        weights[i] = pData->hrtf_vbap_gtableComp[idx3d*3 + i];
+        weights[i] = state->hrtf_vbap_gtableComp[idx3d*3 + i];
 
     switch(mode){
         case INTERP_TRI:
@@ -77,8 +129,8 @@ void binauraliser_interpHRTFs
                 weights_cmplx[i] = cmplxf(weights[i], 0.0f);
             for (band = 0; band < HYBRID_BANDS; band++) {
                 for (i = 0; i < 3; i++){
-                    hrtf_fb3[0][i] = pData->hrtf_fb[band*NUM_EARS*(pData->N_hrir_dirs) + 0*(pData->N_hrir_dirs) + pData->hrtf_vbap_gtableIdx[idx3d*3+i]];
-                    hrtf_fb3[1][i] = pData->hrtf_fb[band*NUM_EARS*(pData->N_hrir_dirs) + 1*(pData->N_hrir_dirs) + pData->hrtf_vbap_gtableIdx[idx3d*3+i]];
+                    hrtf_fb3[0][i] = state->hrtf_fb[band*NUM_EARS*(state->N_hrir_dirs) + 0*(state->N_hrir_dirs) + state->hrtf_vbap_gtableIdx[idx3d*3+i]];
+                    hrtf_fb3[1][i] = state->hrtf_fb[band*NUM_EARS*(state->N_hrir_dirs) + 1*(state->N_hrir_dirs) + state->hrtf_vbap_gtableIdx[idx3d*3+i]];
                 } 
                 cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, 1, 3, &calpha,
                             (float_complex*)hrtf_fb3, 3,
@@ -90,10 +142,10 @@ void binauraliser_interpHRTFs
         case INTERP_TRI_PS:
             /* retrieve the 3 itds and hrtf magnitudes */
             for (i = 0; i < 3; i++) {
-                itds3[i] = pData->itds_s[pData->hrtf_vbap_gtableIdx[idx3d*3+i]];
+                itds3[i] = state->itds_s[state->hrtf_vbap_gtableIdx[idx3d*3+i]];
                 for (band = 0; band < HYBRID_BANDS; band++) {
-                    magnitudes3[band][i][0] = pData->hrtf_fb_mag[band*NUM_EARS*(pData->N_hrir_dirs) + 0*(pData->N_hrir_dirs) + pData->hrtf_vbap_gtableIdx[idx3d*3+i]];
-                    magnitudes3[band][i][1] = pData->hrtf_fb_mag[band*NUM_EARS*(pData->N_hrir_dirs) + 1*(pData->N_hrir_dirs) + pData->hrtf_vbap_gtableIdx[idx3d*3+i]];
+                    magnitudes3[band][i][0] = state->hrtf_fb_mag[band*NUM_EARS*(state->N_hrir_dirs) + 0*(state->N_hrir_dirs) + state->hrtf_vbap_gtableIdx[idx3d*3+i]];
+                    magnitudes3[band][i][1] = state->hrtf_fb_mag[band*NUM_EARS*(state->N_hrir_dirs) + 1*(state->N_hrir_dirs) + state->hrtf_vbap_gtableIdx[idx3d*3+i]];
                 }
             }
 
@@ -122,7 +174,11 @@ void binauraliser_interpHRTFs
     }
 }
 
-void binauraliser_initHRTFsAndGainTables(void* const hBin)
+void binauraliser_initHRTFsAndGainTables
+(
+    void* const hBin,
+    binauraliser_renderState* const state
+)
 {
     binauraliser_data *pData = (binauraliser_data*)(hBin);
     int i, new_len;
@@ -181,8 +237,8 @@ void binauraliser_initHRTFsAndGainTables(void* const hBin)
     /* estimate the ITDs for each HRIR */
     strcpy(pData->progressBarText,"Estimating ITDs");
     pData->progressBar0_1 = 0.4f;
-    pData->itds_s = realloc1d(pData->itds_s, pData->N_hrir_dirs*sizeof(float));
-    estimateITDs(pData->hrirs, pData->N_hrir_dirs, pData->hrir_loaded_len, pData->hrir_loaded_fs, pData->itds_s);
+    state->itds_s = saf_arena_malloc1d(state->hArena, pData->N_hrir_dirs*sizeof(float));
+    estimateITDs(pData->hrirs, pData->N_hrir_dirs, pData->hrir_loaded_len, pData->hrir_loaded_fs, state->itds_s);
 
     /* Resample the HRIRs if needed */
     if(pData->hrir_loaded_fs!=pData->fs){
@@ -205,25 +261,26 @@ void binauraliser_initHRTFsAndGainTables(void* const hBin)
     strcpy(pData->progressBarText,"Generating interpolation table");
     pData->progressBar0_1 = 0.6f;
     hrtf_vbap_gtable = NULL;
-    pData->hrtf_vbapTableRes[0] = 2;
-    pData->hrtf_vbapTableRes[1] = 5;
-    generateVBAPgainTable3D(pData->hrir_dirs_deg, pData->N_hrir_dirs, pData->hrtf_vbapTableRes[0], pData->hrtf_vbapTableRes[1], 1, 0, 0.0f,
-                            &hrtf_vbap_gtable, &(pData->N_hrtf_vbap_gtable), &(pData->nTriangles));
+    state->hrtf_vbapTableRes[0] = 2;
+    state->hrtf_vbapTableRes[1] = 5;
+    generateVBAPgainTable3D(pData->hrir_dirs_deg, pData->N_hrir_dirs, state->hrtf_vbapTableRes[0], state->hrtf_vbapTableRes[1], 1, 0, 0.0f,
+                            &hrtf_vbap_gtable, &(state->N_hrtf_vbap_gtable), &(pData->nTriangles));
     if(hrtf_vbap_gtable==NULL){
         /* if generating vbap gain tabled failed, re-calculate with default HRIR set */
         pData->useDefaultHRIRsFLAG = 1;
-        binauraliser_initHRTFsAndGainTables(hBin);
+        binauraliser_initHRTFsAndGainTables(hBin, state);
+        return;
     }
     
     /* compress VBAP table (i.e. remove the zero elements) */
-    pData->hrtf_vbap_gtableComp = realloc1d(pData->hrtf_vbap_gtableComp, pData->N_hrtf_vbap_gtable * 3 * sizeof(float));
-    pData->hrtf_vbap_gtableIdx  = realloc1d(pData->hrtf_vbap_gtableIdx,  pData->N_hrtf_vbap_gtable * 3 * sizeof(int));
-    compressVBAPgainTable3D(hrtf_vbap_gtable, pData->N_hrtf_vbap_gtable, pData->N_hrir_dirs, pData->hrtf_vbap_gtableComp, pData->hrtf_vbap_gtableIdx);
+    state->hrtf_vbap_gtableComp = saf_arena_malloc1d(state->hArena, state->N_hrtf_vbap_gtable * 3 * sizeof(float));
+    state->hrtf_vbap_gtableIdx  = saf_arena_malloc1d(state->hArena, state->N_hrtf_vbap_gtable * 3 * sizeof(int));
+    compressVBAPgainTable3D(hrtf_vbap_gtable, state->N_hrtf_vbap_gtable, pData->N_hrir_dirs, state->hrtf_vbap_gtableComp, state->hrtf_vbap_gtableIdx);
     
     /* convert hrirs to filterbank coefficients */
     pData->progressBar0_1 = 0.6f;
-    pData->hrtf_fb = realloc1d(pData->hrtf_fb, HYBRID_BANDS * NUM_EARS * (pData->N_hrir_dirs)*sizeof(float_complex));
-    HRIRs2HRTFs_afSTFT(pData->hrirs, pData->N_hrir_dirs, pData->hrir_runtime_len, HOP_SIZE, 0, 1, pData->hrtf_fb);
+    state->hrtf_fb = saf_arena_malloc1d(state->hArena, HYBRID_BANDS * NUM_EARS * (pData->N_hrir_dirs)*sizeof(float_complex));
+    HRIRs2HRTFs_afSTFT(pData->hrirs, pData->N_hrir_dirs, pData->hrir_runtime_len, HOP_SIZE, 0, 1, state->hrtf_fb);
 
     /* HRIR pre-processing */
     if(pData->enableHRIRsDiffuseEQ){
@@ -248,36 +305,45 @@ void binauraliser_initHRTFsAndGainTables(void* const hBin)
             free(pData->weights);
             pData->weights = NULL;
         }
-        diffuseFieldEqualiseHRTFs(pData->N_hrir_dirs, pData->itds_s, pData->freqVector, HYBRID_BANDS, pData->weights, 1, 0, pData->hrtf_fb);
+        diffuseFieldEqualiseHRTFs(pData->N_hrir_dirs, state->itds_s, pData->freqVector, HYBRID_BANDS, pData->weights, 1, 0, state->hrtf_fb);
     }
 
     /* calculate magnitude responses */
-    pData->hrtf_fb_mag = realloc1d(pData->hrtf_fb_mag, HYBRID_BANDS*NUM_EARS*(pData->N_hrir_dirs)*sizeof(float)); 
+    state->hrtf_fb_mag = saf_arena_malloc1d(state->hArena, HYBRID_BANDS*NUM_EARS*(pData->N_hrir_dirs)*sizeof(float)); 
     for(i=0; i<HYBRID_BANDS*NUM_EARS* (pData->N_hrir_dirs); i++)
-        pData->hrtf_fb_mag[i] = cabsf(pData->hrtf_fb[i]);
+        state->hrtf_fb_mag[i] = cabsf(state->hrtf_fb[i]);
+
+    state->N_hrir_dirs = pData->N_hrir_dirs;
 
-    /* The HRTFs should be re-interpolated */
-    for(i=0; i<MAX_NUM_INPUTS; i++)
-        pData->recalc_hrtf_interpFLAG[i] = 1;
-    
     /* clean-up */
     free(hrtf_vbap_gtable);
 }
 
 void binauraliser_initTFT
 (
-    void* const hBin
+    void* const hBin,
+    binauraliser_renderState* const state
 )
 {
     binauraliser_data *pData = (binauraliser_data*)(hBin);
- 
-    if(pData->hSTFT==NULL)
-        afSTFT_create(&(pData->hSTFT), pData->new_nSources, NUM_EARS, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-    else if(pData->new_nSources!=pData->nSources){
-        afSTFT_channelChange(pData->hSTFT, pData->new_nSources, NUM_EARS);
-        afSTFT_clearBuffers(pData->hSTFT);
+    binauraliser_renderState* live = pData->liveState;
+    int nSources = pData->new_nSources;
+
+    /* If the number of sources is unchanged, then the filterbank currently in use is passed on to the new render state,
+     * so that its buffered signals carry over and the audio continues seamlessly */
+    if(live!=NULL && live->nSources == nSources){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        state->hSTFT = live->hSTFT;
+    }
+    else if(state->hSTFT==NULL)
+        afSTFT_create(&(state->hSTFT), nSources, NUM_EARS, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    else {
+        if(state->nSources != nSources) /* Change the number of channels */
+            afSTFT_channelChange(state->hSTFT, nSources, NUM_EARS);
+        afSTFT_clearBuffers(state->hSTFT); /* (the spare state still holds the signals from when it was last used) */
     }
-    pData->nSources = pData->new_nSources;
+    state->nSources = pData->nSources = nSources;
 }
 
 void binauraliser_loadPreset
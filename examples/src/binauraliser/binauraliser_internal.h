@@ -55,6 +55,7 @@ extern "C" {
 #define HOP_SIZE ( 128 )                                  /**< STFT hop size */
 #define HYBRID_BANDS ( HOP_SIZE + 5 )                     /**< Number of frequency bands */
 #define TIME_SLOTS ( BINAURALISER_FRAME_SIZE / HOP_SIZE ) /**< Number of STFT timeslots */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
 
 /* Checks: */
 #if (BINAURALISER_FRAME_SIZE % HOP_SIZE != 0)
@@ -65,6 +66,36 @@ extern "C" {
 /*                                 Structures                                 */
 /* ========================================================================== */
 
+/**
+ * Everything that binauraliser_processFrame() needs from an initialisation
+ *
+ * A new render state is built by binauraliser_initCodec() (while the audio
+ * thread keeps rendering with the current one), and then handed over to the
+ * audio thread via a saf_stateSwap. Once published, only the audio thread may
+ * touch it, until it is handed back by the next initialisation.
+ * Note: this is shared with binauraliser_nf.
+ */
+typedef struct _binauraliser_renderState
+{
+    int nSources;                    /**< Number of input/source signals */
+    void* hSTFT;                     /**< afSTFT handle (passed on to the next render state, if it has the same number of sources) */
+    void* hArena;                    /**< Arena, from which the HRTF tables below are allocated */
+
+    /* vbap gain table */
+    int N_hrir_dirs;                 /**< Number of HRIR directions */
+    int hrtf_vbapTableRes[2];        /**< [0] azimuth, and [1] elevation grid resolution, in degrees */
+    int N_hrtf_vbap_gtable;          /**< Number of interpolation weights/directions */
+    int* hrtf_vbap_gtableIdx;        /**< N_hrtf_vbap_gtable x 3 */
+    float* hrtf_vbap_gtableComp;     /**< N_hrtf_vbap_gtable x 3 */
+
+    /* hrir filterbank coefficients */
+    float* itds_s;                   /**< interaural-time differences for each HRIR (in seconds); nBands x 1 */
+    float_complex* hrtf_fb;          /**< hrtf filterbank coefficients; nBands x nCH x N_hrirs */
+    float* hrtf_fb_mag;              /**< magnitudes of the hrtf filterbank coefficients; nBands x nCH x N_hrirs */
+    int reinterpFLAG;                /**< 1: the HRTFs of all sources are yet to be interpolated from this render state, 0: they have been */
+
+} binauraliser_renderState;
+
 /**
  * Main structure for binauraliser. Contains variables for audio buffers,
  * afSTFT, HRTFs, internal variables, flags, user parameters.
@@ -73,13 +104,13 @@ extern "C" {
 typedef struct _binauraliser
 {
     /* audio buffers */
+    void* hBlockAdapter;             /**< Block adapter handle (for arbitrary host block sizes) */
     float** inputFrameTD;            /**< time-domain input frame; #MAX_NUM_INPUTS x #BINAURALISER_FRAME_SIZE */
     float** outframeTD;              /**< time-domain output frame; #NUM_EARS x #BINAURALISER_FRAME_SIZE */
     float_complex*** inputframeTF;   /**< time-frequency domain input frame; #HYBRID_BANDS x #MAX_NUM_INPUTS x #TIME_SLOTS */
     float_complex*** outputframeTF;  /**< time-frequency domain input frame; #HYBRID_BANDS x #NUM_EARS x #TIME_SLOTS */
     int fs;                          /**< Host sampling rate, in Hz */
     float freqVector[HYBRID_BANDS];  /**< Frequency vector (filterbank centre frequencies) */
-    void* hSTFT;                     /**< afSTFT handle */
     
     /* sofa file info */
     char* sofa_filepath;             /**< absolute/relevative file path for a sofa file */
@@ -92,25 +123,20 @@ typedef struct _binauraliser
     int hrir_runtime_fs;             /**< sampling rate of the HRIRs being used for processing (after any resampling) */
     float* weights;                  /**< Integration weights for the HRIR measurement grid */
     
-    /* vbap gain table */
-    int hrtf_vbapTableRes[2];        /**< [0] azimuth, and [1] elevation grid resolution, in degrees */
-    int N_hrtf_vbap_gtable;          /**< Number of interpolation weights/directions */
-    int* hrtf_vbap_gtableIdx;        /**< N_hrtf_vbap_gtable x 3 */
-    float* hrtf_vbap_gtableComp;     /**< N_hrtf_vbap_gtable x 3 */
     
-    /* hrir filterbank coefficients */
-    float* itds_s;                   /**< interaural-time differences for each HRIR (in seconds); nBands x 1 */
-    float_complex* hrtf_fb;          /**< hrtf filterbank coefficients; nBands x nCH x N_hrirs */
-    float* hrtf_fb_mag;              /**< magnitudes of the hrtf filterbank coefficients; nBands x nCH x N_hrirs */
+    /* interpolated hrtfs (only accessed by the processing loop) */
     float_complex hrtf_interp[MAX_NUM_INPUTS][HYBRID_BANDS][NUM_EARS]; /**< Interpolated HRTFs */
     
     /* flags/status */
-    CODEC_STATUS codecStatus;        /**< see #CODEC_STATUS */
+    volatile long codecStatus;       /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;          /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;            /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;           /**< Current (re)initialisation step, string */
-    PROC_STATUS procStatus;          /**< see #PROC_STATUS */
+    void* hStateSwap;                /**< saf_stateSwap handle, via which new render states are handed over to the audio thread */
+    binauraliser_renderState* liveState;  /**< The last published render state (or NULL); read-only, until it is handed back */
+    binauraliser_renderState* spareState; /**< The previous render state (or NULL), in which the next one is built */
     int recalc_hrtf_interpFLAG[MAX_NUM_INPUTS]; /**< 1: re-calculate/interpolate the HRTF, 0: do not */
-    int reInitHRTFsAndGainTables;    /**< 1: reinitialise the HRTFs and interpolation tables, 0: do not */
+    volatile long reInitHRTFsAndGainTables; /**< 1: reinitialise the HRTFs and interpolation tables, 0: do not (only accessed via the saf_atomic functions) */
     int recalc_M_rotFLAG;            /**< 1: re-calculate the rotation matrix, 0: do not */
     
     /* misc. */
@@ -121,7 +147,7 @@ typedef struct _binauraliser
     int new_nSources;                          /**< New number of input/source signals (current value will be replaced by this after next re-init) */
 
     /* user parameters */
-    int nSources;                            /**< Current number of input/source signals */
+    int nSources;                            /**< Number of input/source signals of the last built render state */
     float src_dirs_deg[MAX_NUM_INPUTS][2];   /**< Current source/panning directions, in degrees */
     INTERP_MODES interpMode;                 /**< see #INTERP_MODES */
     int useDefaultHRIRsFLAG;                 /**< 1: use default HRIRs in database, 0: use those from SOFA file */
@@ -147,6 +173,19 @@ typedef struct _binauraliser
 void binauraliser_setCodecStatus(void* const hBin,
                                  CODEC_STATUS newStatus);
 
+/** Creates an (empty) render state; see #binauraliser_renderState */
+void binauraliser_createRenderState(binauraliser_renderState** const pState);
+
+/** Destroys a render state (if not NULL) */
+void binauraliser_destroyRenderState(binauraliser_renderState** const pState);
+
+/**
+ * Copies the HRTF data and interpolation tables of one render state to another
+ * (for when only the number of sources has changed)
+ */
+void binauraliser_copyHRTFs(binauraliser_renderState* const dst,
+                            const binauraliser_renderState* const src);
+
 /**
  * Interpolates between (up to) 3 HRTFs via amplitude-normalised VBAP gains.
  *
@@ -154,12 +193,14 @@ void binauraliser_setCodecStatus(void* const hBin,
  * re-introducing the phase.
  *
  * @param[in]  hBin          binauraliser handle
+ * @param[in]  state         Render state holding the HRTFs and VBAP table
  * @param[in]  mode          see #INTERP_MODES 
  * @param[in]  azimuth_deg   Source azimuth in DEGREES
  * @param[in]  elevation_deg Source elevation in DEGREES
  * @param[out] h_intrp       Interpolated HRTF
  */
 void binauraliser_interpHRTFs(void* const hBin,
+                              binauraliser_renderState* const state,
                               INTERP_MODES mode,
                               float azimuth_deg,
                               float elevation_deg,
@@ -167,18 +208,22 @@ void binauraliser_interpHRTFs(void* const hBin,
 
 /**
  * Initialise the HRTFs: either loading the default set or loading from a SOFA
- * file; and then generate a VBAP gain table for interpolation.
+ * file; and then generate a VBAP gain table for interpolation (written to the
+ * given render state).
  *
  * @note Call binauraliser_initTFT() (if needed) before calling this function
  */
-void binauraliser_initHRTFsAndGainTables(void* const hBin);
+void binauraliser_initHRTFsAndGainTables(void* const hBin,
+                                         binauraliser_renderState* const state);
 
 /**
- * Initialise the filterbank used by binauraliser.
+ * Initialise the filterbank of a new render state. If the number of sources is
+ * unchanged, then the filterbank of the current render state is passed on.
  *
  * @note Call this function before binauraliser_initHRTFsAndGainTables()
  */
-void binauraliser_initTFT(void* const hBin);
+void binauraliser_initTFT(void* const hBin,
+                          binauraliser_renderState* const state);
 
 /**
  * Returns the source directions for a specified source config preset.
@@ -81,8 +81,6 @@ void binauraliserNF_create /* FREQUENCY DOMAIN version */
     /* For now, any preset selected will reset sources to the far field */
     binauraliserNF_resetSourceDistances(pData); /* Must be called after pData->farfield_thresh_m is set */
 
-    /* time-frequency transform + buffers */
-    pData->hSTFT            = NULL;
     /* hrir data */
     pData->hrirs            = NULL;
     pData->hrir_dirs_deg    = NULL;
@@ -93,20 +91,16 @@ void binauraliserNF_create /* FREQUENCY DOMAIN version */
 
     /* time domain buffers */
     pData->fs = 48000.0f;
-    pData->inputFrameTD     = (float**)malloc2d(MAX_NUM_INPUTS, BINAURALISER_FRAME_SIZE, sizeof(float));
-    pData->outframeTD       = (float**)malloc2d(NUM_EARS, BINAURALISER_FRAME_SIZE, sizeof(float));
-    pData->inputframeTF     = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_INPUTS, TIME_SLOTS, sizeof(float_complex));
-    pData->outputframeTF    = (float_complex***)malloc3d(HYBRID_BANDS, NUM_EARS, TIME_SLOTS, sizeof(float_complex));
-
-    /* vbap (amplitude normalised) */
-    pData->hrtf_vbap_gtableIdx  = NULL;
-    pData->hrtf_vbap_gtableComp = NULL;
-    pData->nTriangles = pData->N_hrtf_vbap_gtable = 0;
-
-    /* HRTF filterbank coefficients */
-    pData->itds_s      = NULL;
-    pData->hrtf_fb     = NULL;
-    pData->hrtf_fb_mag = NULL;
+    pData->inputFrameTD     = (float**)malloc2d_aligned(MAX_NUM_INPUTS, BINAURALISER_FRAME_SIZE, sizeof(float));
+    pData->outframeTD       = (float**)malloc2d_aligned(NUM_EARS, BINAURALISER_FRAME_SIZE, sizeof(float));
+    pData->inputframeTF     = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_INPUTS, TIME_SLOTS, sizeof(float_complex));
+    pData->outputframeTF    = (float_complex***)calloc3d_aligned(HYBRID_BANDS, NUM_EARS, TIME_SLOTS, sizeof(float_complex));
+
+    pData->nTriangles = 0;
+
+    /* render states (afSTFT, HRTFs and vbap tables) are built by binauraliserNF_initCodec() */
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
     
     /* Initialize DVF filter parameters */
     memset(FLATTEN3D(pData->dvfmags), 1.f, MAX_NUM_INPUTS * NUM_EARS * HYBRID_BANDS * sizeof(float));
@@ -124,7 +118,7 @@ void binauraliserNF_create /* FREQUENCY DOMAIN version */
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH * sizeof(char));
     strcpy(pData->progressBarText, "");
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    pData->initLock = 0;
     pData->reInitHRTFsAndGainTables = 1;
     for(int ch = 0; ch < MAX_NUM_INPUTS; ch++) {
         pData->recalc_hrtf_interpFLAG[ch] = 1;
@@ -134,6 +128,9 @@ void binauraliserNF_create /* FREQUENCY DOMAIN version */
     pData->recalc_M_rotFLAG = 1;
     
     pData->src_dirs_cur = pData->src_dirs_deg;
+
+    /* for passing arbitrary host block sizes through binauraliserNF_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), BINAURALISER_FRAME_SIZE, MAX_NUM_INPUTS, NUM_EARS);
 }
 
 void binauraliserNF_destroy
@@ -142,30 +139,29 @@ void binauraliserNF_destroy
 )
 {
     binauraliserNF_data *pData = (binauraliserNF_data*)(*phBin);
+    binauraliser_renderState *state;
 
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
-
-        if(pData->hSTFT !=NULL)
-            afSTFT_destroy(&(pData->hSTFT));
-        free(pData->inputFrameTD);
-        free(pData->outframeTD);
-        free(pData->inputframeTF);
-        free(pData->outputframeTF);
-        free(pData->hrtf_vbap_gtableComp);
-        free(pData->hrtf_vbap_gtableIdx);
-        free(pData->hrtf_fb);
-        free(pData->hrtf_fb_mag);
-        free(pData->itds_s);
+        /* Wait for any on-going initialisation to complete, and then take back the current render state (which also
+         * waits for the processing loop to let go of it) */
+        saf_spinLock_lock(&(pData->initLock));
+        state = (binauraliser_renderState*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(state==pData->liveState, "Unexpected render state");
+        binauraliser_destroyRenderState(&state);
+        binauraliser_destroyRenderState(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
+
+        free2d_aligned((void**)pData->inputFrameTD);
+        free2d_aligned((void**)pData->outframeTD);
+        free3d_aligned((void***)pData->inputframeTF);
+        free3d_aligned((void***)pData->outputframeTF);
+        free(pData->sofa_filepath);
         free(pData->hrirs);
         free(pData->hrir_dirs_deg);
         free(pData->weights);
         free(pData->progressBarText);
         
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phBin = NULL;
@@ -174,56 +170,26 @@ void binauraliserNF_destroy
 
 void binauraliserNF_init
 (
-      void * const hBin, int sampleRate
+      void * const hBin, int sampleRate, int blockSize
 )
 {
-    binauraliser_init(hBin, sampleRate);
+    binauraliser_init(hBin, sampleRate, blockSize);
 }
 
-/* NOTE: This function is a copy of binauraliser_initCodec.
- * The only difference is that it calls binauraliserNF_initTFT, which needs
- * new_nSources * NUM_EARS output channels in the afSTFT. This function could
- * be omitted if binauraliser_initTFT could be refactored to set its number
- * of outputs differently for the regular and NF version of the binauraliser,
- * e.g. a member var afSTFT_nOuts, which changes when binauraliser_setNumSources
- * is called. */
+/* NOTE: The frequency-domain DVF needs the same render state as the regular
+ * binauraliser (i.e. binauraliser_initTFT()), so the initialisation is shared.
+ * A time-domain DVF would instead need binauraliserNF_initTFT(), which creates
+ * the afSTFT with new_nSources * NUM_EARS output channels. */
 void binauraliserNF_initCodec
 (
     void* const hBin
 )
 {
-    binauraliser_data *pData = (binauraliser_data*)(hBin);
-    
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
-        return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
-    }
-    
-    /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
-    strcpy(pData->progressBarText,"Initialising");
-    pData->progressBar0_1 = 0.0f;
-    
-    /* check if TFT needs to be reinitialised */
-    // use binauraliser_initTFT() Freq-domain DVF, binauraliserNF_initTFT() for Time-domain DVF
-    binauraliser_initTFT(hBin);
-
-    /* reinit HRTFs and interpolation tables */
-    if(pData->reInitHRTFsAndGainTables){
-        binauraliser_initHRTFsAndGainTables(hBin);
-        pData->reInitHRTFsAndGainTables = 0;
-    }
-    
-    /* done! */
-    strcpy(pData->progressBarText,"Done!");
-    pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
+    binauraliser_initCodec(hBin);
 }
 
-void binauraliserNF_process /* FREQ DOMAIN version */
+/** Processes one frame of #BINAURALISER_FRAME_SIZE samples (see binauraliserNF_process()) */
+static void binauraliserNF_processFrame /* FREQ DOMAIN version */
 (
     void        *  const hBin,
     const float *const * inputs,
@@ -234,21 +200,32 @@ void binauraliserNF_process /* FREQ DOMAIN version */
 )
 {
     binauraliserNF_data *pData = (binauraliserNF_data*)(hBin);
+    binauraliser_renderState* state;
     int ch, ear, i, band, nSources, enableRotation;
     float hypotxy, headRadiusRecip, fs, ffThresh, rho;
     float Rxyz[3][3];
     float alphaLR[2] = { 0.0, 0.0 };
 
     /* copy user parameters to local variables */
-    nSources        = pData->nSources;
     enableRotation  = pData->enableRotation;
     headRadiusRecip = pData->head_radius_recip;
     ffThresh        = pData->farfield_thresh_m;
     fs              = (float)pData->fs;
 
+    /* The current render state remains valid (and untouched by binauraliserNF_initCodec()) until it is released */
+    state = (binauraliser_renderState*)saf_stateSwap_acquire(pData->hStateSwap);
+
     /* apply binaural panner */
-    if ((nSamples == BINAURALISER_FRAME_SIZE) && (pData->hrtf_fb!=NULL) && (pData->codecStatus==CODEC_STATUS_INITIALISED) ) {
-        pData->procStatus = PROC_STATUS_ONGOING;
+    if ((nSamples == BINAURALISER_FRAME_SIZE) && (state!=NULL)) {
+        nSources = state->nSources;
+
+        /* The HRTFs (and rotated source directions) are re-interpolated after switching to a new render state */
+        if(state->reinterpFLAG){
+            for(ch=0; ch<MAX_NUM_INPUTS; ch++)
+                pData->recalc_hrtf_interpFLAG[ch] = 1;
+            pData->recalc_M_rotFLAG = 1;
+            state->reinterpFLAG = 0;
+        }
 
         /* Load time-domain data */
         for (i = 0; i < SAF_MIN(nSources, nInputs); i++)
@@ -263,7 +240,7 @@ void binauraliserNF_process /* FREQ DOMAIN version */
         }
         
         /* Apply time-frequency transform (TFT) */
-        afSTFT_forward_knownDimensions(pData->hSTFT, pData->inputFrameTD, BINAURALISER_FRAME_SIZE, MAX_NUM_INPUTS, TIME_SLOTS, pData->inputframeTF);
+        afSTFT_forward_knownDimensions(state->hSTFT, pData->inputFrameTD, BINAURALISER_FRAME_SIZE, MAX_NUM_INPUTS, TIME_SLOTS_STRIDE, pData->inputframeTF);
         
         /* Rotate source directions */
         if (enableRotation && pData->recalc_M_rotFLAG) {
@@ -288,7 +265,7 @@ void binauraliserNF_process /* FREQ DOMAIN version */
         
         /* Interpolate and apply HRTFs, apply DVF magnitude filter */
         /* Zero out TF summing bus */
-        memset(FLATTEN3D(pData->outputframeTF), 0, HYBRID_BANDS*NUM_EARS*TIME_SLOTS * sizeof(float_complex));
+        memset(FLATTEN3D(pData->outputframeTF), 0, HYBRID_BANDS*NUM_EARS*TIME_SLOTS_STRIDE * sizeof(float_complex));
         
         for (ch = 0; ch < nSources; ch++) {
             /* Interpolate HRTFs */
@@ -298,7 +275,7 @@ void binauraliserNF_process /* FREQ DOMAIN version */
                 } else {
                     pData->src_dirs_cur = pData->src_dirs_deg;
                 }
-                binauraliser_interpHRTFs(hBin, pData->interpMode, pData->src_dirs_cur[ch][0], pData->src_dirs_cur[ch][1], pData->hrtf_interp[ch]);
+                binauraliser_interpHRTFs(hBin, state, pData->interpMode, pData->src_dirs_cur[ch][0], pData->src_dirs_cur[ch][1], pData->hrtf_interp[ch]);
                 pData->recalc_hrtf_interpFLAG[ch] = 0;
                 pData->recalc_dvfCoeffFLAG[ch] = 1;
             }
@@ -352,10 +329,10 @@ void binauraliserNF_process /* FREQ DOMAIN version */
         }
 
         /* scale by number of sources */
-        cblas_sscal(/*re+im*/2*HYBRID_BANDS*NUM_EARS*TIME_SLOTS, 1.0f/sqrtf((float)nSources), (float*)FLATTEN3D(pData->outputframeTF), 1);
+        cblas_sscal(/*re+im*/2*HYBRID_BANDS*NUM_EARS*TIME_SLOTS_STRIDE, 1.0f/sqrtf((float)nSources), (float*)FLATTEN3D(pData->outputframeTF), 1);
 
         /* inverse-TFT */
-        afSTFT_backward_knownDimensions(pData->hSTFT, pData->outputframeTF, BINAURALISER_FRAME_SIZE, NUM_EARS, TIME_SLOTS, pData->outframeTD);
+        afSTFT_backward_knownDimensions(state->hSTFT, pData->outputframeTF, BINAURALISER_FRAME_SIZE, NUM_EARS, TIME_SLOTS_STRIDE, pData->outframeTD);
 
         /* Copy to output buffer */
         for (ch = 0; ch < SAF_MIN(NUM_EARS, nOutputs); ch++)
@@ -368,7 +345,23 @@ void binauraliserNF_process /* FREQ DOMAIN version */
             memset(outputs[ch],0, BINAURALISER_FRAME_SIZE*sizeof(float));
     }
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void binauraliserNF_process
+(
+    void        *  const hBin,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    binauraliserNF_data *pData = (binauraliserNF_data*)(hBin);
+
+    /* Process the host buffers in frames of #BINAURALISER_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, binauraliserNF_processFrame, hBin);
 }
 
 
@@ -40,18 +40,28 @@
 
 void binauraliserNF_initTFT
 (
-    void* const hBin
+    void* const hBin,
+    binauraliser_renderState* const state
 )
 {
     binauraliserNF_data *pData = (binauraliserNF_data*)(hBin);
- 
-    if(pData->hSTFT==NULL)
-        afSTFT_create(&(pData->hSTFT), pData->new_nSources, pData->new_nSources * NUM_EARS, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-    else if(pData->new_nSources!=pData->nSources){
-        afSTFT_channelChange(pData->hSTFT, pData->new_nSources, pData->new_nSources * NUM_EARS);
-        afSTFT_clearBuffers(pData->hSTFT);
+    binauraliser_renderState* live = pData->liveState;
+    int nSources = pData->new_nSources;
+
+    /* (see binauraliser_initTFT()) */
+    if(live!=NULL && live->nSources == nSources){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        state->hSTFT = live->hSTFT;
+    }
+    else if(state->hSTFT==NULL)
+        afSTFT_create(&(state->hSTFT), nSources, nSources * NUM_EARS, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    else {
+        if(state->nSources != nSources)
+            afSTFT_channelChange(state->hSTFT, nSources, nSources * NUM_EARS);
+        afSTFT_clearBuffers(state->hSTFT);
     }
-    pData->nSources = pData->new_nSources;
+    state->nSources = pData->nSources = nSources;
 }
 
 void binauraliserNF_resetSourceDistances(void* const hBin)
@@ -64,13 +64,13 @@ typedef struct _binauraliserNF {
     /* The following variables MUST match those of the _binauraliser struct */
 
     /* audio buffers */
+    void* hBlockAdapter;             /**< Block adapter handle (for arbitrary host block sizes) */
     float** inputFrameTD;            /**< time-domain input frame; #MAX_NUM_INPUTS x #BINAURALISER_FRAME_SIZE */
     float** outframeTD;              /**< time-domain output frame; #NUM_EARS x #BINAURALISER_FRAME_SIZE */
     float_complex*** inputframeTF;   /**< time-frequency domain input frame; #HYBRID_BANDS x #MAX_NUM_INPUTS x #TIME_SLOTS */
     float_complex*** outputframeTF;  /**< time-frequency domain input frame; #HYBRID_BANDS x #NUM_EARS x #TIME_SLOTS */
     int fs;                          /**< Host sampling rate, in Hz */
     float freqVector[HYBRID_BANDS];  /**< Frequency vector (filterbank centre frequencies) */
-    void* hSTFT;                     /**< afSTFT handle */
 
     /* sofa file info */
     char* sofa_filepath;             /**< absolute/relevative file path for a sofa file */
@@ -83,25 +83,20 @@ typedef struct _binauraliserNF {
     int hrir_runtime_fs;             /**< sampling rate of the HRIRs being used for processing (after any resampling) */
     float* weights;                  /**< Integration weights for the HRIR measurement grid */
 
-    /* vbap gain table */
-    int hrtf_vbapTableRes[2];        /**< [0] azimuth, and [1] elevation grid resolution, in degrees */
-    int N_hrtf_vbap_gtable;          /**< Number of interpolation weights/directions */
-    int* hrtf_vbap_gtableIdx;        /**< N_hrtf_vbap_gtable x 3 */
-    float* hrtf_vbap_gtableComp;     /**< N_hrtf_vbap_gtable x 3 */
 
-    /* hrir filterbank coefficients */
-    float* itds_s;                   /**< interaural-time differences for each HRIR (in seconds); nBands x 1 */
-    float_complex* hrtf_fb;          /**< hrtf filterbank coefficients; nBands x nCH x N_hrirs */
-    float* hrtf_fb_mag;              /**< magnitudes of the hrtf filterbank coefficients; nBands x nCH x N_hrirs */
+    /* interpolated hrtfs (only accessed by the processing loop) */
     float_complex hrtf_interp[MAX_NUM_INPUTS][HYBRID_BANDS][NUM_EARS]; /**< Interpolated HRTFs */
 
     /* flags/status */
-    CODEC_STATUS codecStatus;        /**< see #CODEC_STATUS */
+    volatile long codecStatus;       /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;          /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;            /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;           /**< Current (re)initialisation step, string */
-    PROC_STATUS procStatus;          /**< see #PROC_STATUS */
+    void* hStateSwap;                /**< saf_stateSwap handle, via which new render states are handed over to the audio thread */
+    binauraliser_renderState* liveState;  /**< The last published render state (or NULL); read-only, until it is handed back */
+    binauraliser_renderState* spareState; /**< The previous render state (or NULL), in which the next one is built */
     int recalc_hrtf_interpFLAG[MAX_NUM_INPUTS]; /**< 1: re-calculate/interpolate the HRTF, 0: do not */
-    int reInitHRTFsAndGainTables;    /**< 1: reinitialise the HRTFs and interpolation tables, 0: do not */
+    volatile long reInitHRTFsAndGainTables; /**< 1: reinitialise the HRTFs and interpolation tables, 0: do not (only accessed via the saf_atomic functions) */
     int recalc_M_rotFLAG;            /**< 1: re-calculate the rotation matrix, 0: do not */
 
     /* misc. */
@@ -112,7 +107,7 @@ typedef struct _binauraliserNF {
     int new_nSources;                          /**< New number of input/source signals (current value will be replaced by this after next re-init) */
 
     /* user parameters */
-    int nSources;                            /**< Current number of input/source signals */
+    int nSources;                            /**< Number of input/source signals of the last built render state */
     float src_dirs_deg[MAX_NUM_INPUTS][2];   /**< Current source/panning directions, in degrees */
     INTERP_MODES interpMode;                 /**< see #INTERP_MODES */
     int useDefaultHRIRsFLAG;                 /**< 1: use default HRIRs in database, 0: use those from SOFA file */
@@ -154,11 +149,13 @@ typedef struct _binauraliserNF {
 /* ========================================================================== */
 
 /**
- * Initialise the filterbank used by binauraliserNF.
+ * Initialise the filterbank of a new render state, for the time-domain DVF
+ * variant (see binauraliser_initTFT()).
  *
  * @note Call this function before binauraliser_initHRTFsAndGainTables()
  */
-void binauraliserNF_initTFT(void* const hBin);
+void binauraliserNF_initTFT(void* const hBin,
+                            binauraliser_renderState* const state);
 
 /**
  * Resets the source distances to the default far field distance.
@@ -39,26 +39,30 @@ void decorrelator_create
     pData->decorAmount = 1.0f;
     pData->compensateLevel = 0;
     
-    /* afSTFT stuff */
+    /* filterbank stuff */
     pData->fs = 48000.0f;
-    pData->hSTFT = NULL;
-    pData->InputFrameTD = (float**)malloc2d(MAX_NUM_CHANNELS, DECORRELATOR_FRAME_SIZE, sizeof(float));
-    pData->OutputFrameTD = (float**)malloc2d(MAX_NUM_CHANNELS, DECORRELATOR_FRAME_SIZE, sizeof(float));
-    pData->InputFrameTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_CHANNELS, TIME_SLOTS, sizeof(float_complex));
-    pData->OutputFrameTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_CHANNELS, TIME_SLOTS, sizeof(float_complex));
-    pData->transientFrameTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_CHANNELS, TIME_SLOTS, sizeof(float_complex));
+    pData->new_fbType = DECORRELATOR_FILTERBANK_AFSTFT;
+    pData->fbDelay = 12*HOP_SIZE; /* (that of the default filterbank, until the first initialisation) */
+    pData->InputFrameTD = (float**)malloc2d_aligned(MAX_NUM_CHANNELS, DECORRELATOR_FRAME_SIZE, sizeof(float));
+    pData->OutputFrameTD = (float**)malloc2d_aligned(MAX_NUM_CHANNELS, DECORRELATOR_FRAME_SIZE, sizeof(float));
+    pData->InputFrameTF = (float_complex***)calloc3d_aligned(MAX_NUM_BANDS, MAX_NUM_CHANNELS, TIME_SLOTS, sizeof(float_complex));
+    pData->OutputFrameTF = (float_complex***)calloc3d_aligned(MAX_NUM_BANDS, MAX_NUM_CHANNELS, TIME_SLOTS, sizeof(float_complex));
+    pData->transientFrameTF = (float_complex***)calloc3d_aligned(MAX_NUM_BANDS, MAX_NUM_CHANNELS, TIME_SLOTS, sizeof(float_complex));
 
     /* codec data */
-    pData->hDecor = NULL;
-    pData->hDucker = NULL;
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
     pData->new_nChannels = pData->nChannels;
     pData->progressBar0_1 = 0.0f;
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
     
     /* flags */
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
+    pData->initLock = 0;
+
+    /* for passing arbitrary host block sizes through decorrelator_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), DECORRELATOR_FRAME_SIZE, MAX_NUM_INPUTS, MAX_NUM_OUTPUTS);
 }
 
 void decorrelator_destroy
@@ -67,27 +71,27 @@ void decorrelator_destroy
 )
 {
     decorrelator_data *pData = (decorrelator_data*)(*phDecor);
+    decorrelator_renderState *state;
     
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
+        /* Wait for any on-going initialisation to complete, and then take back the current render state (which also
+         * waits for the processing loop to let go of it) */
+        saf_spinLock_lock(&(pData->initLock));
+        state = (decorrelator_renderState*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(state==pData->liveState, "Unexpected render state");
+        decorrelator_destroyRenderState(&state);
+        decorrelator_destroyRenderState(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
         
-        /* free afSTFT and buffers */ 
-        if(pData->hSTFT!=NULL)
-            afSTFT_destroy(&(pData->hSTFT));
-        free(pData->InputFrameTD);
-        free(pData->OutputFrameTD);
-        free(pData->InputFrameTF);
-        free(pData->OutputFrameTF);
-        free(pData->transientFrameTF);
+        /* free buffers */ 
+        free2d_aligned((void**)pData->InputFrameTD);
+        free2d_aligned((void**)pData->OutputFrameTD);
+        free3d_aligned((void***)pData->InputFrameTF);
+        free3d_aligned((void***)pData->OutputFrameTF);
+        free3d_aligned((void***)pData->transientFrameTF);
         free(pData->progressBarText);
 
-        transientDucker_destroy(&(pData->hDucker));
-        latticeDecorrelator_destroy(&(pData->hDecor));
-
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phDecor = NULL;
@@ -97,16 +101,20 @@ void decorrelator_destroy
 void decorrelator_init
 (
     void * const hDecor,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     decorrelator_data *pData = (decorrelator_data*)(hDecor);
     
-    /* define frequency vector */
+    /* The decorrelators are designed for the sampling rate (and the centre frequencies of the filterbank), and are
+     * therefore rebuilt if it changes */
+    if(pData->fs != sampleRate)
+        decorrelator_setCodecStatus(hDecor, CODEC_STATUS_NOT_INITIALISED);
     pData->fs = sampleRate;
-    afSTFT_getCentreFreqs(pData->hSTFT, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
-    if(pData->hDecor!=NULL)
-        latticeDecorrelator_reset(pData->hDecor);
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
 void decorrelator_initCodec
@@ -115,50 +123,89 @@ void decorrelator_initCodec
 )
 {
     decorrelator_data *pData = (decorrelator_data*)(hDecor);
+    decorrelator_renderState* state, *live;
     int nChannels;
+    DECORRELATOR_FILTERBANKS fbType;
+    SAF_FILTERBANK_TYPES type;
     
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
     
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Preparing Decorrelators");
     pData->progressBar0_1 = 0.0f;
+
+    /* The new render state is built in the spare one, while the audio thread keeps rendering with the current one */
+    if(pData->spareState==NULL)
+        decorrelator_createRenderState(&(pData->spareState));
+    state = pData->spareState;
     
-    /* (Re)Initialise afSTFT */
+    /* (Re)Initialise the filterbank. If the filterbank and the number of channels are unchanged, then the one currently
+     * in use is passed on to the new render state, so that its buffered signals carry over and the audio continues
+     * seamlessly */
     nChannels = pData->new_nChannels; 
-    if(pData->hSTFT==NULL)
-        afSTFT_create(&(pData->hSTFT), nChannels, nChannels, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-    else if(pData->nChannels != nChannels) {/* Or change the number of channels */
-        afSTFT_channelChange(pData->hSTFT, nChannels, nChannels);
-        afSTFT_clearBuffers(pData->hSTFT);
+    fbType = pData->new_fbType;
+    live = pData->liveState;
+    if(live!=NULL && live->fbType == fbType && live->nChannels == nChannels){
+        saf_filterbank_destroy(&(state->hFB));
+        state->hFB = live->hFB;
     }
-    pData->nChannels = nChannels;
+    else if(state->hFB==NULL || state->fbType != fbType){
+        switch(fbType){
+            default: /* fall through */
+            case DECORRELATOR_FILTERBANK_AFSTFT:    type = SAF_FILTERBANK_AFSTFT;    break;
+            case DECORRELATOR_FILTERBANK_AFSTFT_LD: type = SAF_FILTERBANK_AFSTFT_LD; break;
+            case DECORRELATOR_FILTERBANK_QMF:       type = SAF_FILTERBANK_QMF;       break;
+            case DECORRELATOR_FILTERBANK_STFT:      type = SAF_FILTERBANK_STFT;      break;
+        }
+        saf_filterbank_destroy(&(state->hFB));
+        saf_filterbank_create(&(state->hFB), type, nChannels, nChannels, HOP_SIZE, 1);
+    }
+    else {
+        if(state->nChannels != nChannels) /* Change the number of channels */
+            saf_filterbank_channelChange(state->hFB, nChannels, nChannels);
+        saf_filterbank_clearBuffers(state->hFB); /* (the spare state still holds the signals from when it was last used) */
+    }
+    state->nChannels = pData->nChannels = nChannels;
+    state->fbType = fbType;
+    state->nBands = saf_filterbank_getNBands(state->hFB);
+    saf_assert(state->nBands<=MAX_NUM_BANDS, "MAX_NUM_BANDS is too small for this filterbank");
+    saf_filterbank_getCentreFreqs(state->hFB, (float)pData->fs, state->nBands, pData->freqVector);
+    pData->fbDelay = saf_filterbank_getProcDelay(state->hFB);
 
     /* Init transient ducker */
-    transientDucker_destroy(&(pData->hDucker));
-    transientDucker_create(&(pData->hDucker), nChannels, HYBRID_BANDS);
+    transientDucker_destroy(&(state->hDucker));
+    transientDucker_create(&(state->hDucker), nChannels, state->nBands);
 
     /* Init decorrelator  */
     const int orders[4] = {20, 15, 6, 3}; /* 20th order up to 700Hz, 15th->2.4kHz, 6th->4kHz, 3rd->12kHz, NONE(only delays)->Nyquist */
     const float freqCutoffs[4] = {600.0f, 2.4e3f, 4.0e3f, 12e3f};
     //const float freqCutoffs[4] = {900.0f, 6.8e3f, 12e3f, 16e3f};
     const int maxDelay = 8;
-    latticeDecorrelator_destroy(&(pData->hDecor));
-    latticeDecorrelator_create(&(pData->hDecor), pData->fs, HOP_SIZE, pData->freqVector, HYBRID_BANDS, pData->nChannels, (int*)orders, (float*)freqCutoffs, 4, maxDelay, 0, 0.75f);
+    latticeDecorrelator_destroy(&(state->hDecor));
+    latticeDecorrelator_create(&(state->hDecor), pData->fs, HOP_SIZE, pData->freqVector, state->nBands, nChannels, (int*)orders, (float*)freqCutoffs, 4, maxDelay, 0, 0.75f);
+
+    /* Hand the new render state over to the audio thread, and keep the previous one as the spare, once it is no longer
+     * being used */
+    pData->spareState = (decorrelator_renderState*)saf_stateSwap_publish(pData->hStateSwap, (void*)state);
+    pData->liveState = state;
+    if(pData->spareState!=NULL && pData->spareState->hFB == state->hFB)
+        pData->spareState->hFB = NULL; /* (passed on to the new render state) */
 
-    /* done! */
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
-void decorrelator_process
+/** Processes one frame of #DECORRELATOR_FRAME_SIZE samples (see decorrelator_process()) */
+static void decorrelator_processFrame
 (
     void        *  const hDecor,
     const float *const * inputs,
@@ -169,19 +216,23 @@ void decorrelator_process
 )
 {
     decorrelator_data *pData = (decorrelator_data*)(hDecor);
-    int ch, i, band, enableTransientDucker, compensateLevel;
+    decorrelator_renderState* state;
+    int ch, i, band, nBands, enableTransientDucker, compensateLevel;
     float decorAmount;
     
     /* local copies of user parameters */
     int nCH;
-    nCH = pData->nChannels;
     decorAmount = pData->decorAmount;
     enableTransientDucker = pData->enableTransientDucker;
     compensateLevel = pData->compensateLevel;
 
+    /* The current render state remains valid (and untouched by decorrelator_initCodec()) until it is released */
+    state = (decorrelator_renderState*)saf_stateSwap_acquire(pData->hStateSwap);
+
     /* Process frame */
-    if (nSamples == DECORRELATOR_FRAME_SIZE && (pData->codecStatus == CODEC_STATUS_INITIALISED) ) {
-        pData->procStatus = PROC_STATUS_ONGOING;
+    if (nSamples == DECORRELATOR_FRAME_SIZE && (state!=NULL) ) {
+        nCH = state->nChannels;
+        nBands = state->nBands;
 
         /* Load time-domain data */
         for(i=0; i < SAF_MIN(nCH, nInputs); i++)
@@ -190,39 +241,39 @@ void decorrelator_process
             memset(pData->InputFrameTD[i], 0, DECORRELATOR_FRAME_SIZE * sizeof(float)); /* fill remaining channels with zeros */
 
         /* Apply time-frequency transform (TFT) */
-        afSTFT_forward_knownDimensions(pData->hSTFT, pData->InputFrameTD, DECORRELATOR_FRAME_SIZE, MAX_NUM_CHANNELS, TIME_SLOTS, pData->InputFrameTF);
+        saf_filterbank_forward(state->hFB, pData->InputFrameTD, DECORRELATOR_FRAME_SIZE, MAX_NUM_CHANNELS, TIME_SLOTS_STRIDE, pData->InputFrameTF);
 
         /* Apply decorrelation */
         if(enableTransientDucker){
             /* remove transients */
-            transientDucker_apply(pData->hDucker, pData->InputFrameTF, TIME_SLOTS, 0.95f, 0.995f, pData->OutputFrameTF, pData->transientFrameTF);
+            transientDucker_apply(state->hDucker, pData->InputFrameTF, TIME_SLOTS, 0.95f, 0.995f, pData->OutputFrameTF, pData->transientFrameTF);
             /* decorrelate only the residual */
-            latticeDecorrelator_apply(pData->hDecor,  pData->OutputFrameTF, TIME_SLOTS, pData->OutputFrameTF);
+            latticeDecorrelator_apply(state->hDecor,  pData->OutputFrameTF, TIME_SLOTS, pData->OutputFrameTF);
         }
         else
-            latticeDecorrelator_apply(pData->hDecor,  pData->InputFrameTF, TIME_SLOTS, pData->OutputFrameTF);
+            latticeDecorrelator_apply(state->hDecor,  pData->InputFrameTF, TIME_SLOTS, pData->OutputFrameTF);
 
         /* Optionally compensate for the level (as they channels wll no longer sum coherently) */
         if(compensateLevel){
-            for(band=0; band<HYBRID_BANDS; band++)
-                cblas_sscal(/*re+im*/2*nCH*TIME_SLOTS, 0.75f*(float)nCH/(sqrtf((float)nCH)), (float*)FLATTEN2D(pData->OutputFrameTF[band]), 1);
+            for(band=0; band<nBands; band++)
+                cblas_sscal(/*re+im*/2*nCH*TIME_SLOTS_STRIDE, 0.75f*(float)nCH/(sqrtf((float)nCH)), (float*)FLATTEN2D(pData->OutputFrameTF[band]), 1);
         }
 
         /* re-introduce the transient part */
         if(enableTransientDucker){
             //scalec =  cmplxf(1.0f, 0.0f);//!compensateLevel ? cmplxf(1.25f*(sqrtf((float)nCH)/(float)nCH), 0.0f) : cmplxf(1.0f, 0.0f);
-            for(band=0; band<HYBRID_BANDS; band++)
-                cblas_saxpy(/*re+im*/2*nCH*TIME_SLOTS, 1.0f, (float*)FLATTEN2D(pData->transientFrameTF[band]), 1, (float*)FLATTEN2D(pData->OutputFrameTF[band]), 1);
+            for(band=0; band<nBands; band++)
+                cblas_saxpy(/*re+im*/2*nCH*TIME_SLOTS_STRIDE, 1.0f, (float*)FLATTEN2D(pData->transientFrameTF[band]), 1, (float*)FLATTEN2D(pData->OutputFrameTF[band]), 1);
         }
 
         /* Mix  thedecorrelated audio with the input non-decorrelated audio */ 
-        for(band=0; band<HYBRID_BANDS; band++){
-            cblas_sscal(/*re+im*/2*nCH*TIME_SLOTS, decorAmount, (float*)FLATTEN2D(pData->OutputFrameTF[band]), 1);
-            cblas_saxpy(/*re+im*/2*nCH*TIME_SLOTS, 1.0f-decorAmount, (float*)FLATTEN2D(pData->InputFrameTF[band]), 1, (float*)FLATTEN2D(pData->OutputFrameTF[band]), 1);
+        for(band=0; band<nBands; band++){
+            cblas_sscal(/*re+im*/2*nCH*TIME_SLOTS_STRIDE, decorAmount, (float*)FLATTEN2D(pData->OutputFrameTF[band]), 1);
+            cblas_saxpy(/*re+im*/2*nCH*TIME_SLOTS_STRIDE, 1.0f-decorAmount, (float*)FLATTEN2D(pData->InputFrameTF[band]), 1, (float*)FLATTEN2D(pData->OutputFrameTF[band]), 1);
         }
 
         /* inverse-TFT */
-        afSTFT_backward_knownDimensions(pData->hSTFT, pData->OutputFrameTF, DECORRELATOR_FRAME_SIZE, MAX_NUM_CHANNELS, TIME_SLOTS, pData->OutputFrameTD);
+        saf_filterbank_backward(state->hFB, pData->OutputFrameTF, DECORRELATOR_FRAME_SIZE, MAX_NUM_CHANNELS, TIME_SLOTS_STRIDE, pData->OutputFrameTD);
 
         /* Copy to output buffer */
         for (ch = 0; ch < SAF_MIN(nCH, nOutputs); ch++)
@@ -234,7 +285,23 @@ void decorrelator_process
         for (ch=0; ch < nOutputs; ch++)
             memset(outputs[ch],0, DECORRELATOR_FRAME_SIZE*sizeof(float));
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void decorrelator_process
+(
+    void        *  const hDecor,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    decorrelator_data *pData = (decorrelator_data*)(hDecor);
+
+    /* Process the host buffers in frames of #DECORRELATOR_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, decorrelator_processFrame, hDecor);
 }
 
 
@@ -274,6 +341,15 @@ void decorrelator_setTransientBypassFlag(void* const hDecor, int newValue)
     saf_assert(newValue==0 || newValue==1, "newValue is a bool");
     pData->enableTransientDucker = newValue;
 }
+
+void decorrelator_setFilterbank(void* const hDecor, int newType)
+{
+    decorrelator_data *pData = (decorrelator_data*)(hDecor);
+    if(pData->new_fbType != (DECORRELATOR_FILTERBANKS)newType){
+        pData->new_fbType = (DECORRELATOR_FILTERBANKS)newType;
+        decorrelator_setCodecStatus(hDecor, CODEC_STATUS_NOT_INITIALISED);
+    }
+}
  
 /* Get Functions */
 
@@ -285,7 +361,7 @@ int decorrelator_getFrameSize(void)
 CODEC_STATUS decorrelator_getCodecStatus(void* const hDecor)
 {
     decorrelator_data *pData = (decorrelator_data*)(hDecor);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float decorrelator_getProgressBar0_1(void* const hDecor)
@@ -324,13 +400,20 @@ int decorrelator_getTransientBypassFlag(void* const hDecor)
     return pData->enableTransientDucker;
 }
 
+int decorrelator_getFilterbank(void* const hDecor)
+{
+    decorrelator_data *pData = (decorrelator_data*)(hDecor);
+    return (int)pData->new_fbType;
+}
+
 int decorrelator_getDAWsamplerate(void* const hDecor)
 {
     decorrelator_data *pData = (decorrelator_data*)(hDecor);
     return pData->fs;
 }
 
-int decorrelator_getProcessingDelay()
+int decorrelator_getProcessingDelay(void* const hDecor)
 {
-    return 12*HOP_SIZE;
+    decorrelator_data *pData = (decorrelator_data*)(hDecor);
+    return pData->fbDelay + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
@@ -29,10 +29,34 @@
 void decorrelator_setCodecStatus(void* const hDecor, CODEC_STATUS newStatus)
 {
     decorrelator_data *pData = (decorrelator_data*)(hDecor);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next decorrelator_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void decorrelator_createRenderState(decorrelator_renderState** const pState)
+{
+    decorrelator_renderState* state = (decorrelator_renderState*)malloc1d(sizeof(decorrelator_renderState));
+    *pState = state;
+
+    state->nChannels = 0;
+    state->fbType = DECORRELATOR_FILTERBANK_AFSTFT;
+    state->nBands = 0;
+    state->hFB = NULL;
+    state->hDecor = NULL;
+    state->hDucker = NULL;
+}
+
+void decorrelator_destroyRenderState(decorrelator_renderState** const pState)
+{
+    decorrelator_renderState* state = *pState;
+
+    if(state!=NULL){
+        saf_filterbank_destroy(&(state->hFB));
+        transientDucker_destroy(&(state->hDucker));
+        latticeDecorrelator_destroy(&(state->hDecor));
+        free(state);
+        state = NULL;
+        *pState = NULL;
     }
-    pData->codecStatus = newStatus;
 }
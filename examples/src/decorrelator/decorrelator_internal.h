@@ -46,9 +46,10 @@ extern "C" {
 #  define DECORRELATOR_FRAME_SIZE ( 128 )                 /**< Framesize, in time-domain samples */
 # endif
 #endif
-#define HOP_SIZE ( 128 )                                  /**< STFT hop size */
-#define HYBRID_BANDS ( HOP_SIZE + 5 )                     /**< Number of frequency bands */
-#define TIME_SLOTS ( DECORRELATOR_FRAME_SIZE / HOP_SIZE ) /**< Number of STFT timeslots */
+#define HOP_SIZE ( 128 )                                  /**< Filterbank hop size */
+#define MAX_NUM_BANDS ( 2*HOP_SIZE + 1 )                  /**< Maximum number of frequency bands (that of #DECORRELATOR_FILTERBANK_STFT) */
+#define TIME_SLOTS ( DECORRELATOR_FRAME_SIZE / HOP_SIZE ) /**< Number of filterbank timeslots */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
 
 /* Checks: */
 #if (DECORRELATOR_FRAME_SIZE % HOP_SIZE != 0)
@@ -60,35 +61,56 @@ extern "C" {
 /* ========================================================================== */
 
 /**
- * Main structure for decorrelator. Contains variables for audio buffers, afSTFT,
+ * Everything that decorrelator_processFrame() needs from an initialisation
+ *
+ * A new render state is built by decorrelator_initCodec() (while the audio
+ * thread keeps rendering with the current one), and then handed over to the
+ * audio thread via a saf_stateSwap. Once published, only the audio thread may
+ * touch it, until it is handed back by the next initialisation.
+ */
+typedef struct _decorrelator_renderState
+{
+    int nChannels;                    /**< Number of input/output channels */
+    DECORRELATOR_FILTERBANKS fbType;  /**< Filterbank of this render state (see #DECORRELATOR_FILTERBANKS) */
+    int nBands;                       /**< Number of frequency bands of the filterbank */
+    void* hFB;                        /**< Filterbank handle (passed on to the next render state, if it has the same filterbank and number of channels) */
+    void* hDecor;                     /**< Decorrelator handle */
+    void* hDucker;                    /**< Transient extractor/Ducker handle */
+
+} decorrelator_renderState;
+
+/**
+ * Main structure for decorrelator. Contains variables for audio buffers, filterbank,
  * rotation matrices, internal variables, flags, user parameters
  */
 typedef struct _decorrelator
 {
-    /* audio buffers + afSTFT time-frequency transform handle */
+    /* audio buffers */
+    void* hBlockAdapter;              /**< Block adapter handle (for arbitrary host block sizes) */
     int fs;                           /**< host sampling rate */
     float** InputFrameTD;             /**< Input time-domain signals; #MAX_NUM_CHANNELS x #DECORRELATOR_FRAME_SIZE */
     float** OutputFrameTD;            /**< Output time-domain signals; #MAX_NUM_CHANNELS x #DECORRELATOR_FRAME_SIZE */
-    float_complex*** InputFrameTF;    /**< Input time-frequency domain signals; #HYBRID_BANDS x #MAX_NUM_CHANNELS x #TIME_SLOTS */
-    float_complex*** transientFrameTF; /**< Transient time-frequency domain signals; #HYBRID_BANDS x #MAX_NUM_CHANNELS x #TIME_SLOTS */
-    float_complex*** OutputFrameTF;   /**< Output time-frequency domain signals; #HYBRID_BANDS x #MAX_NUM_CHANNELS x #TIME_SLOTS */
-    void* hSTFT;                      /**< afSTFT handle */
-    int afSTFTdelay;                  /**< for host delay compensation */
-    float freqVector[HYBRID_BANDS];   /**< frequency vector for time-frequency transform, in Hz */
+    float_complex*** InputFrameTF;    /**< Input time-frequency domain signals; #MAX_NUM_BANDS x #MAX_NUM_CHANNELS x #TIME_SLOTS */
+    float_complex*** transientFrameTF; /**< Transient time-frequency domain signals; #MAX_NUM_BANDS x #MAX_NUM_CHANNELS x #TIME_SLOTS */
+    float_complex*** OutputFrameTF;   /**< Output time-frequency domain signals; #MAX_NUM_BANDS x #MAX_NUM_CHANNELS x #TIME_SLOTS */
+    int fbDelay;                      /**< Processing delay of the filterbank of the last built render state, in samples (for host delay compensation) */
+    float freqVector[MAX_NUM_BANDS];  /**< Centre frequencies of the filterbank of the last built render state, in Hz (only the first nBands are used) */
      
     /* our codec configuration */
-    void* hDecor;                     /**< Decorrelator handle */
-    void* hDucker;                    /**< Transient extractor/Ducker handle */
-    CODEC_STATUS codecStatus;         /**< see #CODEC_STATUS */
+    volatile long codecStatus;        /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;           /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;             /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;            /**< Current (re)initialisation step, string */
+    void* hStateSwap;                 /**< saf_stateSwap handle, via which new render states are handed over to the audio thread */
+    decorrelator_renderState* liveState;  /**< The last published render state (or NULL); read-only, until it is handed back */
+    decorrelator_renderState* spareState; /**< The previous render state (or NULL), in which the next one is built */
     
     /* internal variables */
-    PROC_STATUS procStatus;           /**< see #PROC_STATUS */
     int new_nChannels;                /**< New number of input/output channels (current value will be replaced by this after next re-init) */
+    DECORRELATOR_FILTERBANKS new_fbType; /**< New filterbank (the current one will be replaced by this after next re-init) */
 
     /* user parameters */
-    int nChannels;                    /**< Current number of input/output channels */
+    int nChannels;                    /**< Number of input/output channels of the last built render state */
     int enableTransientDucker;        /**< 1: transient extractor is enabled, 0: disabled */
     float decorAmount;                /**< The mix between decorrelated signals and the input signals [0..1], 1: fully decorrelated 0: bypassed */
     int compensateLevel;              /**< 1: apply a sqrt(nChannels)/nChannels scaling on the output signals, 0: disabled */
@@ -106,6 +128,12 @@ typedef struct _decorrelator
 void decorrelator_setCodecStatus(void* const hDecor,
                                  CODEC_STATUS newStatus);
 
+/** Creates an (empty) render state; see #decorrelator_renderState */
+void decorrelator_createRenderState(decorrelator_renderState** const pState);
+
+/** Destroys a render state (if not NULL) */
+void decorrelator_destroyRenderState(decorrelator_renderState** const pState);
+
 
 #ifdef __cplusplus
 } /* extern "C" { */
@@ -44,7 +44,6 @@ void dirass_create
 {
     dirass_data* pData = (dirass_data*)malloc1d(sizeof(dirass_data));
     *phDir = (void*)pData;
-    int i;
 
     /* Default user parameters */
     pData->inputOrder = pData->new_inputOrder = SH_ORDER_FIRST;
@@ -61,42 +60,27 @@ void dirass_create
     pData->HFOVoption = HFOV_360;
     pData->aspectRatioOption = ASPECT_RATIO_2_1;
 
-    /* codec data */
-    pData->pars = (dirass_codecPars*)malloc1d(sizeof(dirass_codecPars));
-    dirass_codecPars* pars = pData->pars;
-    pars->interp_dirs_deg = NULL;
-    pars->interp_dirs_rad = NULL;
-    pars->Y_up = NULL;
-    pars->interp_table = NULL;
-    pars->w = NULL;
-    pars->Cw = NULL;
-    pars->Uw = NULL;
-    pars->Cxyz = NULL;
-    pars->ss = NULL;
-    pars->ssxyz = NULL;
-    pars->est_dirs = NULL;
-    pars->est_dirs_idx = NULL;
-    pars->prev_intensity = NULL;
-    pars->prev_energy = NULL;
+    /* codec data (built by dirass_initCodec()) */
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
     
     /* internal */
     pData->progressBar0_1 = 0.0f;
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    pData->initLock = 0;
+    pData->resetAvgFLAG = 0;
 
     /* display */
-    pData->pmap = NULL;
-    for(i=0; i<NUM_DISP_SLOTS; i++)
-        pData->pmap_grid[i] = NULL;
+    pData->dispSlotIdx = 0;
     pData->pmapReady = 0;
     pData->recalcPmap = 1;
 
-    /* set FIFO buffers */
+    /* for passing arbitrary host block sizes through dirass_analysisFrame() */
     pData->fs = 48000.0f;
-    pData->FIFO_idx = 0;
-    memset(pData->inFIFO, 0, MAX_NUM_INPUT_SH_SIGNALS*DIRASS_FRAME_SIZE*sizeof(float));
+    pData->isPlaying = 0;
+    saf_blockAdapter_create(&(pData->hBlockAdapter), DIRASS_FRAME_SIZE, MAX_NUM_INPUT_SH_SIGNALS, 0);
 }
 
 void dirass_destroy
@@ -106,37 +90,18 @@ void dirass_destroy
 {
     dirass_data *pData = (dirass_data*)(*phDir);
     dirass_codecPars* pars;
-    int i;
     
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
+        /* Wait for any on-going initialisation to complete, and then take back the current codec parameters (which
+         * also waits for the analysis to let go of them) */
+        saf_spinLock_lock(&(pData->initLock));
+        pars = (dirass_codecPars*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(pars==pData->liveState, "Unexpected codec parameters");
+        dirass_destroyCodecPars(&pars);
+        dirass_destroyCodecPars(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         
-        if(pData->pmap!=NULL)
-            free(pData->pmap);
-        for(i=0; i<NUM_DISP_SLOTS; i++)
-            free(pData->pmap_grid[i]);
-
-        pars = pData->pars;
-        free(pars->interp_dirs_deg);
-        free(pars->interp_dirs_rad);
-        free(pars->Y_up);
-        free(pars->interp_table);
-        free(pars->ss);
-        free(pars->ssxyz);
-        free(pars->Cxyz);
-        free(pars->w);
-        free(pars->Cw);
-        free(pars->Uw);
-        free(pars->est_dirs);
-        free(pars->est_dirs_idx);
-        free(pars->prev_intensity);
-        free(pars->prev_energy);
-        
-        free(pData->pars);
         free(pData->progressBarText);
         free(pData);
         pData = NULL;
@@ -151,15 +116,12 @@ void dirass_init
 )
 {
     dirass_data *pData = (dirass_data*)(hDir);
-    dirass_codecPars* pars = pData->pars;
 
     pData->fs = sampleRate;
+    saf_blockAdapter_reset(pData->hBlockAdapter, 0);
     
-    /* intialise parameters */
-    if(pars->prev_intensity!=NULL)
-        memset(pars->prev_intensity, 0, pars->grid_nDirs*3*sizeof(float));
-    if(pars->prev_energy!=NULL)
-        memset(pars->prev_energy, 0, pars->grid_nDirs*sizeof(float));
+    /* intialise parameters (the temporal averaging buffers are cleared by the analysis thread) */
+    saf_atomic_store(&(pData->resetAvgFLAG), 1);
     memset(pData->Wz12_hpf, 0, MAX_NUM_INPUT_SH_SIGNALS*2*sizeof(float));
     memset(pData->Wz12_lpf, 0, MAX_NUM_INPUT_SH_SIGNALS*2*sizeof(float));
     pData->pmapReady = 0;
@@ -172,40 +134,54 @@ void dirass_initCodec
 )
 {
     dirass_data *pData = (dirass_data*)(hDir);
+    dirass_codecPars* pars;
     
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
     
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Initialising");
     pData->progressBar0_1 = 0.0f;
     
-    dirass_initAna(hDir);
+    /* The new codec parameters are built in the spare set, while the analysis keeps running with the current one */
+    if(pData->spareState==NULL)
+        dirass_createCodecPars(&(pData->spareState));
+    pars = pData->spareState;
+    dirass_initAna(hDir, pars);
+
+    /* Hand the new codec parameters over to the analysis thread, and keep the previous ones as the spare set, once
+     * they are no longer being used */
+    pData->spareState = (dirass_codecPars*)saf_stateSwap_publish(pData->hStateSwap, (void*)pars);
+    pData->liveState = pars;
+    pData->inputOrder = pars->inputOrder;
+    pData->upscaleOrder = pars->upscaleOrder;
     
-    /* done! */
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
-void dirass_analysis
+/** Analyses one frame of #DIRASS_FRAME_SIZE samples (see dirass_analysis()) */
+static void dirass_analysisFrame
 (
     void        *  const hDir,
     const float *const * inputs,
+    float* const*  const outputs,
     int                  nInputs,
-    int                  nSamples,
-    int                  isPlaying
+    int                  nOutputs,
+    int                  nSamples
 )
 {
     dirass_data *pData = (dirass_data*)(hDir);
-    dirass_codecPars* pars = pData->pars;
-    int s, i, j, k, ch, sec_nSH, secOrder, nSH, up_nSH;
+    dirass_codecPars* pars;
+    int i, j, k, ch, sec_nSH, secOrder, nSH, up_nSH;
     float intensity[3];
     
     /* local copy of user parameters */
@@ -217,202 +193,213 @@ void dirass_analysis
     chOrdering = pData->chOrdering;
     pmapAvgCoeff = pData->pmapAvgCoeff;
     DirAssMode = pData->DirAssMode;
-    upscaleOrder = pData->upscaleOrder;
     minFreq_hz = pData->minFreq_hz;
     maxFreq_hz = pData->maxFreq_hz;
-    inputOrder = pData->inputOrder;
+    SAF_UNUSED(outputs);
+    SAF_UNUSED(nOutputs);
+    SAF_UNUSED(nSamples);
+
+    /* The current codec parameters remain valid (and untouched by dirass_initCodec()) until they are released */
+    pars = (dirass_codecPars*)saf_stateSwap_acquire(pData->hStateSwap);
+    inputOrder = pars!=NULL ? pars->inputOrder : SH_ORDER_FIRST;
+    upscaleOrder = pars!=NULL ? pars->upscaleOrder : SH_ORDER_FIRST;
     secOrder = inputOrder-1;
     nSH = (inputOrder+1)*(inputOrder+1);
     sec_nSH = (secOrder+1)*(secOrder+1);
     up_nSH = (upscaleOrder+1)*(upscaleOrder+1);
 
-    /* Loop over all samples */
-    for(s=0; s<nSamples; s++){
-        /* Load input signals into inFIFO buffer */
+    /* Clear the temporal averaging buffers, if requested */
+    if(pars!=NULL && saf_atomic_compareExchange(&(pData->resetAvgFLAG), 1, 0)){
+        memset(pars->prev_intensity, 0, pars->grid_nDirs*3*sizeof(float));
+        memset(pars->prev_energy, 0, pars->grid_nDirs*sizeof(float));
+    }
+
+    /* Process frame if the codec is ready for it */
+    if (pars!=NULL && pData->isPlaying) {
+        /* Load time-domain data */
         for(ch=0; ch<SAF_MIN(nInputs,nSH); ch++)
-            pData->inFIFO[ch][pData->FIFO_idx] = inputs[ch][s];
+            memcpy(pData->SHframeTD[ch], inputs[ch], DIRASS_FRAME_SIZE*sizeof(float));
         for(; ch<nSH; ch++) /* Zero any channels that were not given */
-            pData->inFIFO[ch][pData->FIFO_idx] = 0.0f;
-
-        /* Increment buffer index */
-        pData->FIFO_idx++;
+            memset(pData->SHframeTD[ch], 0, DIRASS_FRAME_SIZE*sizeof(float));
 
-        /* Process frame if inFIFO is full and codec is ready for it */
-        if (pData->FIFO_idx >= DIRASS_FRAME_SIZE && (pData->codecStatus == CODEC_STATUS_INITIALISED) && isPlaying) {
-            pData->FIFO_idx = 0;
-            pData->procStatus = PROC_STATUS_ONGOING;
+        /* account for input channel order */
+        switch(chOrdering){
+            case CH_ACN:  /* already ACN */ break; /* Otherwise, convert to ACN... */
+            case CH_FUMA: convertHOAChannelConvention((float*)pData->SHframeTD, inputOrder, DIRASS_FRAME_SIZE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
+        }
 
-            /* Load time-domain data */
-            for(ch=0; ch<nSH; ch++)
-                memcpy(pData->SHframeTD[ch],pData->inFIFO[ch], DIRASS_FRAME_SIZE*sizeof(float));
+        /* account for input normalisation scheme */
+        switch(norm){
+            case NORM_N3D:  /* already in N3D, do nothing */ break; /* Otherwise, convert to N3D... */
+            case NORM_SN3D: convertHOANormConvention((float*)pData->SHframeTD, inputOrder, DIRASS_FRAME_SIZE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
+            case NORM_FUMA: convertHOANormConvention((float*)pData->SHframeTD, inputOrder, DIRASS_FRAME_SIZE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
+        }
 
-            /* account for input channel order */
-            switch(chOrdering){
-                case CH_ACN:  /* already ACN */ break; /* Otherwise, convert to ACN... */
-                case CH_FUMA: convertHOAChannelConvention((float*)pData->SHframeTD, inputOrder, DIRASS_FRAME_SIZE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
-            }
+        /* update the dirass powermap */
+        if(pData->recalcPmap==1){
+            pData->recalcPmap = 0;
+            pData->pmapReady = 0;
+
+            /* filter input signals */
+            float b[3], a[3];
+            biQuadCoeffs(BIQUAD_FILTER_HPF, minFreq_hz, pData->fs, 0.7071f, 0.0f, b, a);
+            for(i=0; i<nSH; i++)
+                applyBiQuadFilter(b, a, pData->Wz12_hpf[i], pData->SHframeTD[i], DIRASS_FRAME_SIZE);
+            biQuadCoeffs(BIQUAD_FILTER_LPF, maxFreq_hz, pData->fs, 0.7071f, 0.0f, b, a);
+            for(i=0; i<nSH; i++)
+                applyBiQuadFilter(b, a, pData->Wz12_lpf[i], pData->SHframeTD[i], DIRASS_FRAME_SIZE);
+
+            /* DoA estimation for each spatially-localised sector */
+            if(DirAssMode==REASS_UPSCALE || DirAssMode==REASS_NEAREST){
+                /* Beamform using the sector patterns */
+                cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->grid_nDirs, DIRASS_FRAME_SIZE, sec_nSH, 1.0f,
+                            pars->Cw, sec_nSH,
+                            (const float*)pData->SHframeTD, DIRASS_FRAME_SIZE, 0.0f,
+                            pars->ss, DIRASS_FRAME_SIZE);
+
+                for(i=0; i<pars->grid_nDirs; i++){
+                    /* beamforming to get velocity patterns */
+                    cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, 3, DIRASS_FRAME_SIZE, nSH, 1.0f,
+                                &(pars->Cxyz[i*nSH*3]), 3,
+                                (const float*)pData->SHframeTD, DIRASS_FRAME_SIZE, 0.0f,
+                                pars->ssxyz, DIRASS_FRAME_SIZE);
+
+                    /* take the sum or mean ss.*ssxyz, to get intensity vector */
+                    memset(intensity, 0, 3*sizeof(float));
+                    for(k=0; k<3; k++){
+                        for(j=0; j<DIRASS_FRAME_SIZE; j++)
+                            intensity[k] += pars->ssxyz[k*DIRASS_FRAME_SIZE + j] * pars->ss[i*DIRASS_FRAME_SIZE+j];
+                        intensity[k] /= (float)DIRASS_FRAME_SIZE;
+
+                        /* average over time */
+                        intensity[k] = pmapAvgCoeff * (pars->prev_intensity[i*3+k]) + (1.0f-pmapAvgCoeff) * intensity[k];
+                        pars->prev_intensity[i*3+k] = intensity[k];
+                    }
 
-            /* account for input normalisation scheme */
-            switch(norm){
-                case NORM_N3D:  /* already in N3D, do nothing */ break; /* Otherwise, convert to N3D... */
-                case NORM_SN3D: convertHOANormConvention((float*)pData->SHframeTD, inputOrder, DIRASS_FRAME_SIZE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
-                case NORM_FUMA: convertHOANormConvention((float*)pData->SHframeTD, inputOrder, DIRASS_FRAME_SIZE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
+                    /* extract DoA [azi elev] convention */
+                    pars->est_dirs[i*2] = atan2f(intensity[1], intensity[0]);
+                    pars->est_dirs[i*2+1] = atan2f(intensity[2], sqrtf(powf(intensity[0], 2.0f) + powf(intensity[1], 2.0f)));
+                    if(DirAssMode==REASS_UPSCALE)
+                        pars->est_dirs[i*2+1] = SAF_PI/2.0f - pars->est_dirs[i*2+1]; /* convert to inclination */
+                }
             }
 
-            /* update the dirass powermap */
-            if(pData->recalcPmap==1){
-                pData->recalcPmap = 0;
-                pData->pmapReady = 0;
-
-                /* filter input signals */
-                float b[3], a[3];
-                biQuadCoeffs(BIQUAD_FILTER_HPF, minFreq_hz, pData->fs, 0.7071f, 0.0f, b, a);
-                for(i=0; i<nSH; i++)
-                    applyBiQuadFilter(b, a, pData->Wz12_hpf[i], pData->SHframeTD[i], DIRASS_FRAME_SIZE);
-                biQuadCoeffs(BIQUAD_FILTER_LPF, maxFreq_hz, pData->fs, 0.7071f, 0.0f, b, a);
-                for(i=0; i<nSH; i++)
-                    applyBiQuadFilter(b, a, pData->Wz12_lpf[i], pData->SHframeTD[i], DIRASS_FRAME_SIZE);
-
-                /* DoA estimation for each spatially-localised sector */
-                if(DirAssMode==REASS_UPSCALE || DirAssMode==REASS_NEAREST){
-                    /* Beamform using the sector patterns */
-                    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->grid_nDirs, DIRASS_FRAME_SIZE, sec_nSH, 1.0f,
-                                pars->Cw, sec_nSH,
+            /* Obtain pmap/upscaled pmap in the case of REASS_MODE_OFF and REASS_UPSCALE modes, respectively.
+             * OR find the nearest display grid indices, corresponding to the DoA estimates, for the REASS_NEAREST mode */
+            switch(DirAssMode) {
+                default:
+                case REASS_MODE_OFF:
+                    /* Standard beamformer-based pmap */
+                    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->grid_nDirs, DIRASS_FRAME_SIZE, nSH, 1.0f,
+                                pars->w, nSH,
                                 (const float*)pData->SHframeTD, DIRASS_FRAME_SIZE, 0.0f,
                                 pars->ss, DIRASS_FRAME_SIZE);
 
+                    /* sum energy over the length of the frame to obtain the pmap */
+                    memset(pars->pmap, 0, pars->grid_nDirs *sizeof(float));
+                    for(i=0; i<pars->grid_nDirs; i++)
+                        for(j=0; j<DIRASS_FRAME_SIZE; j++)
+                            pars->pmap[i] += (pars->ss[i*DIRASS_FRAME_SIZE+j])*(pars->ss[i*DIRASS_FRAME_SIZE+j]);
+
+                    /* average energy over time */
                     for(i=0; i<pars->grid_nDirs; i++){
-                        /* beamforming to get velocity patterns */
-                        cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, 3, DIRASS_FRAME_SIZE, nSH, 1.0f,
-                                    &(pars->Cxyz[i*nSH*3]), 3,
-                                    (const float*)pData->SHframeTD, DIRASS_FRAME_SIZE, 0.0f,
-                                    pars->ssxyz, DIRASS_FRAME_SIZE);
-
-                        /* take the sum or mean ss.*ssxyz, to get intensity vector */
-                        memset(intensity, 0, 3*sizeof(float));
-                        for(k=0; k<3; k++){
-                            for(j=0; j<DIRASS_FRAME_SIZE; j++)
-                                intensity[k] += pars->ssxyz[k*DIRASS_FRAME_SIZE + j] * pars->ss[i*DIRASS_FRAME_SIZE+j];
-                            intensity[k] /= (float)DIRASS_FRAME_SIZE;
-
-                            /* average over time */
-                            intensity[k] = pmapAvgCoeff * (pars->prev_intensity[i*3+k]) + (1.0f-pmapAvgCoeff) * intensity[k];
-                            pars->prev_intensity[i*3+k] = intensity[k];
-                        }
-
-                        /* extract DoA [azi elev] convention */
-                        pars->est_dirs[i*2] = atan2f(intensity[1], intensity[0]);
-                        pars->est_dirs[i*2+1] = atan2f(intensity[2], sqrtf(powf(intensity[0], 2.0f) + powf(intensity[1], 2.0f)));
-                        if(DirAssMode==REASS_UPSCALE)
-                            pars->est_dirs[i*2+1] = SAF_PI/2.0f - pars->est_dirs[i*2+1]; /* convert to inclination */
+                        pars->pmap[i] = pmapAvgCoeff * (pars->prev_energy[i]) + (1.0f-pmapAvgCoeff) * (pars->pmap[i]);
+                        pars->prev_energy[i] = pars->pmap[i];
                     }
-                }
 
-                /* Obtain pmap/upscaled pmap in the case of REASS_MODE_OFF and REASS_UPSCALE modes, respectively.
-                 * OR find the nearest display grid indices, corresponding to the DoA estimates, for the REASS_NEAREST mode */
-                switch(DirAssMode) {
-                    default:
-                    case REASS_MODE_OFF:
-                        /* Standard beamformer-based pmap */
-                        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->grid_nDirs, DIRASS_FRAME_SIZE, nSH, 1.0f,
-                                    pars->w, nSH,
-                                    (const float*)pData->SHframeTD, DIRASS_FRAME_SIZE, 0.0f,
-                                    pars->ss, DIRASS_FRAME_SIZE);
-
-                        /* sum energy over the length of the frame to obtain the pmap */
-                        memset(pData->pmap, 0, pars->grid_nDirs *sizeof(float));
-                        for(i=0; i<pars->grid_nDirs; i++)
-                            for(j=0; j<DIRASS_FRAME_SIZE; j++)
-                                pData->pmap[i] += (pars->ss[i*DIRASS_FRAME_SIZE+j])*(pars->ss[i*DIRASS_FRAME_SIZE+j]);
-
-                        /* average energy over time */
-                        for(i=0; i<pars->grid_nDirs; i++){
-                            pData->pmap[i] = pmapAvgCoeff * (pars->prev_energy[i]) + (1.0f-pmapAvgCoeff) * (pData->pmap[i]);
-                            pars->prev_energy[i] = pData->pmap[i];
-                        }
-
-                        /* interpolate the pmap */
-                        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->interp_nDirs, 1, pars->grid_nDirs, 1.0f,
-                                    pars->interp_table, pars->grid_nDirs,
-                                    pData->pmap, 1, 0.0f,
-                                    pData->pmap_grid[pData->dispSlotIdx], 1);
-                        break;
-
-                    case REASS_UPSCALE:
-                        /* upscale */
-                        getSHreal_recur(upscaleOrder, pars->est_dirs, pars->grid_nDirs, pars->Y_up);
-                        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, up_nSH, DIRASS_FRAME_SIZE, pars->grid_nDirs, 1.0f,
-                                    pars->Y_up, pars->grid_nDirs,
-                                    pars->ss, DIRASS_FRAME_SIZE, 0.0f,
-                                    (float*)pData->SHframe_upTD, DIRASS_FRAME_SIZE);
-
-                        /* Beamform using the new spatially upscaled frame */
-                        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->grid_nDirs, DIRASS_FRAME_SIZE, up_nSH, 1.0f,
-                                    pars->Uw, up_nSH,
-                                    (float*)pData->SHframe_upTD, DIRASS_FRAME_SIZE, 0.0f,
-                                    pars->ss, DIRASS_FRAME_SIZE);
-
-                        /* sum energy over the length of the frame to obtain the pmap */
-                        memset(pData->pmap, 0, pars->grid_nDirs *sizeof(float));
-                        for(i=0; i<pars->grid_nDirs; i++)
-                            for(j=0; j<DIRASS_FRAME_SIZE; j++)
-                                pData->pmap[i] += (pars->ss[i*DIRASS_FRAME_SIZE+j])*(pars->ss[i*DIRASS_FRAME_SIZE+j]);
-
-                        /* average energy over time */
-                        for(i=0; i<pars->grid_nDirs; i++){
-                            pData->pmap[i] = pmapAvgCoeff * (pars->prev_energy[i]) + (1.0f-pmapAvgCoeff) * (pData->pmap[i]);
-                            pars->prev_energy[i] = pData->pmap[i];
-                        }
-
-                        /* interpolate the pmap */
-                        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->interp_nDirs, 1, pars->grid_nDirs, 1.0f,
-                                    pars->interp_table, pars->grid_nDirs,
-                                    pData->pmap, 1, 0.0f,
-                                    pData->pmap_grid[pData->dispSlotIdx], 1);
-                        break;
-
-                    case REASS_NEAREST:
-                        /* Assign the sector energies to the nearest display grid point */
-                        findClosestGridPoints(pars->interp_dirs_rad, pars->interp_nDirs, pars->est_dirs, pars->grid_nDirs, 0, pars->est_dirs_idx, NULL, NULL);
-                        memset(pData->pmap_grid[pData->dispSlotIdx], 0, pars->interp_nDirs * sizeof(float));
-                        for(i=0; i< pars->grid_nDirs; i++)
-                            for(j=0; j<DIRASS_FRAME_SIZE; j++)
-                                pData->pmap[i] = (pars->ss[i*DIRASS_FRAME_SIZE+j])*(pars->ss[i*DIRASS_FRAME_SIZE+j]);
-
-                        /* average energy over time, and assign to nearest grid direction */
-                        for(i=0; i<pars->grid_nDirs; i++){
-                            pData->pmap[i] = pmapAvgCoeff * (pars->prev_energy[i]) + (1.0f-pmapAvgCoeff) * (pData->pmap[i]);
-                            pars->prev_energy[i] = pData->pmap[i];
-                            pData->pmap_grid[pData->dispSlotIdx][pars->est_dirs_idx[i]] += pData->pmap[i];
-                        }
-                        break;
-                }
+                    /* interpolate the pmap */
+                    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->interp_nDirs, 1, pars->grid_nDirs, 1.0f,
+                                pars->interp_table, pars->grid_nDirs,
+                                pars->pmap, 1, 0.0f,
+                                pars->pmap_grid[pData->dispSlotIdx], 1);
+                    break;
+
+                case REASS_UPSCALE:
+                    /* upscale */
+                    getSHreal_recur(upscaleOrder, pars->est_dirs, pars->grid_nDirs, pars->Y_up);
+                    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, up_nSH, DIRASS_FRAME_SIZE, pars->grid_nDirs, 1.0f,
+                                pars->Y_up, pars->grid_nDirs,
+                                pars->ss, DIRASS_FRAME_SIZE, 0.0f,
+                                (float*)pData->SHframe_upTD, DIRASS_FRAME_SIZE);
+
+                    /* Beamform using the new spatially upscaled frame */
+                    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->grid_nDirs, DIRASS_FRAME_SIZE, up_nSH, 1.0f,
+                                pars->Uw, up_nSH,
+                                (float*)pData->SHframe_upTD, DIRASS_FRAME_SIZE, 0.0f,
+                                pars->ss, DIRASS_FRAME_SIZE);
 
-                /* ascertain the minimum and maximum values for pmap colour scaling */
-                int ind;
-                utility_siminv(pData->pmap_grid[pData->dispSlotIdx], pars->interp_nDirs, &ind);
-                pData->pmap_grid_minVal = pData->pmap_grid[pData->dispSlotIdx][ind];
-                utility_simaxv(pData->pmap_grid[pData->dispSlotIdx], pars->interp_nDirs, &ind);
-                pData->pmap_grid_maxVal = pData->pmap_grid[pData->dispSlotIdx][ind];
-
-                /* normalise the pmap to 0..1 */
-                for(i=0; i<pars->interp_nDirs; i++)
-                    pData->pmap_grid[pData->dispSlotIdx][i] = (pData->pmap_grid[pData->dispSlotIdx][i]-pData->pmap_grid_minVal)/(pData->pmap_grid_maxVal-pData->pmap_grid_minVal+1e-11f);
-
-                /* signify that the pmap in the current slot is ready for plotting */
-                pData->dispSlotIdx++;
-                if(pData->dispSlotIdx>=NUM_DISP_SLOTS)
-                    pData->dispSlotIdx = 0;
-                pData->pmapReady = 1;
+                    /* sum energy over the length of the frame to obtain the pmap */
+                    memset(pars->pmap, 0, pars->grid_nDirs *sizeof(float));
+                    for(i=0; i<pars->grid_nDirs; i++)
+                        for(j=0; j<DIRASS_FRAME_SIZE; j++)
+                            pars->pmap[i] += (pars->ss[i*DIRASS_FRAME_SIZE+j])*(pars->ss[i*DIRASS_FRAME_SIZE+j]);
+
+                    /* average energy over time */
+                    for(i=0; i<pars->grid_nDirs; i++){
+                        pars->pmap[i] = pmapAvgCoeff * (pars->prev_energy[i]) + (1.0f-pmapAvgCoeff) * (pars->pmap[i]);
+                        pars->prev_energy[i] = pars->pmap[i];
+                    }
+
+                    /* interpolate the pmap */
+                    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->interp_nDirs, 1, pars->grid_nDirs, 1.0f,
+                                pars->interp_table, pars->grid_nDirs,
+                                pars->pmap, 1, 0.0f,
+                                pars->pmap_grid[pData->dispSlotIdx], 1);
+                    break;
+
+                case REASS_NEAREST:
+                    /* Assign the sector energies to the nearest display grid point */
+                    findClosestGridPoints(pars->interp_dirs_rad, pars->interp_nDirs, pars->est_dirs, pars->grid_nDirs, 0, pars->est_dirs_idx, NULL, NULL);
+                    memset(pars->pmap_grid[pData->dispSlotIdx], 0, pars->interp_nDirs * sizeof(float));
+                    for(i=0; i< pars->grid_nDirs; i++)
+                        for(j=0; j<DIRASS_FRAME_SIZE; j++)
+                            pars->pmap[i] = (pars->ss[i*DIRASS_FRAME_SIZE+j])*(pars->ss[i*DIRASS_FRAME_SIZE+j]);
+
+                    /* average energy over time, and assign to nearest grid direction */
+                    for(i=0; i<pars->grid_nDirs; i++){
+                        pars->pmap[i] = pmapAvgCoeff * (pars->prev_energy[i]) + (1.0f-pmapAvgCoeff) * (pars->pmap[i]);
+                        pars->prev_energy[i] = pars->pmap[i];
+                        pars->pmap_grid[pData->dispSlotIdx][pars->est_dirs_idx[i]] += pars->pmap[i];
+                    }
+                    break;
             }
-        }
-        else if(pData->FIFO_idx >= DIRASS_FRAME_SIZE){
-            /* reset FIFO_idx index if codec was not ready */
-            pData->FIFO_idx = 0;
+
+            /* ascertain the minimum and maximum values for pmap colour scaling */
+            int ind;
+            utility_siminv(pars->pmap_grid[pData->dispSlotIdx], pars->interp_nDirs, &ind);
+            pData->pmap_grid_minVal = pars->pmap_grid[pData->dispSlotIdx][ind];
+            utility_simaxv(pars->pmap_grid[pData->dispSlotIdx], pars->interp_nDirs, &ind);
+            pData->pmap_grid_maxVal = pars->pmap_grid[pData->dispSlotIdx][ind];
+
+            /* normalise the pmap to 0..1 */
+            for(i=0; i<pars->interp_nDirs; i++)
+                pars->pmap_grid[pData->dispSlotIdx][i] = (pars->pmap_grid[pData->dispSlotIdx][i]-pData->pmap_grid_minVal)/(pData->pmap_grid_maxVal-pData->pmap_grid_minVal+1e-11f);
+
+            /* signify that the pmap in the current slot is ready for plotting */
+            pData->dispSlotIdx++;
+            if(pData->dispSlotIdx>=NUM_DISP_SLOTS)
+                pData->dispSlotIdx = 0;
+            pData->pmapReady = 1;
         }
     }
-    
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void dirass_analysis
+(
+    void        *  const hDir,
+    const float *const * inputs,
+    int                  nInputs,
+    int                  nSamples,
+    int                  isPlaying
+)
+{
+    dirass_data *pData = (dirass_data*)(hDir);
+
+    /* Analyse the host buffers in frames of #DIRASS_FRAME_SIZE samples */
+    pData->isPlaying = isPlaying;
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, NULL, nInputs, 0, nSamples, dirass_analysisFrame, hDir);
 }
 
 /* SETS */
@@ -475,12 +462,9 @@ void dirass_setUpscaleOrder(void* const hDir,  int newValue)
 void dirass_setDiRAssMode(void* const hDir,  int newMode)
 {
     dirass_data *pData = (dirass_data*)(hDir);
-    dirass_codecPars* pars = pData->pars;
     if(pData->DirAssMode!=(DIRASS_REASS_MODES)newMode){
         pData->DirAssMode = (DIRASS_REASS_MODES)newMode;
-        if(pars->prev_intensity!=NULL)
-            memset(pars->prev_intensity, 0, pars->grid_nDirs*3*sizeof(float));
-        memset(pars->prev_energy, 0, pars->grid_nDirs*sizeof(float));
+        saf_atomic_store(&(pData->resetAvgFLAG), 1);
     }
 }
 
@@ -551,7 +535,7 @@ int dirass_getFrameSize(void)
 CODEC_STATUS dirass_getCodecStatus(void* const hDir)
 {
     dirass_data *pData = (dirass_data*)(hDir);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float dirass_getProgressBar0_1(void* const hDir)
@@ -659,10 +643,10 @@ float dirass_getMapAvgCoeff(void* const hDir)
 int dirass_getPmap(void* const hDir, float** grid_dirs, float** pmap, int* nDirs,int* pmapWidth, int* hfov, float* aspectRatio) 
 {
     dirass_data *pData = (dirass_data*)(hDir);
-    dirass_codecPars* pars = pData->pars;
-    if((pData->codecStatus == CODEC_STATUS_INITIALISED) && pData->pmapReady){
+    dirass_codecPars* pars = pData->liveState;
+    if((saf_atomic_load(&(pData->codecStatus)) == CODEC_STATUS_INITIALISED) && pData->pmapReady){
         (*grid_dirs) = pars->interp_dirs_deg;
-        (*pmap) = pData->pmap_grid[pData->dispSlotIdx-1 < 0 ? NUM_DISP_SLOTS-1 : pData->dispSlotIdx-1];
+        (*pmap) = pars->pmap_grid[pData->dispSlotIdx-1 < 0 ? NUM_DISP_SLOTS-1 : pData->dispSlotIdx-1];
         (*nDirs) = pars->interp_nDirs;
         (*pmapWidth) = pData->dispWidth;
         switch(pData->HFOVoption){
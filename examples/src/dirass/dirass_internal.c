@@ -40,18 +40,74 @@
 void dirass_setCodecStatus(void* const hDir, CODEC_STATUS newStatus)
 {
     dirass_data *pData = (dirass_data*)(hDir);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next dirass_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void dirass_createCodecPars(dirass_codecPars** const pPars)
+{
+    dirass_codecPars* pars = (dirass_codecPars*)malloc1d(sizeof(dirass_codecPars));
+    int i;
+    *pPars = pars;
+
+    pars->inputOrder = pars->upscaleOrder = 0;
+    pars->grid_nDirs = pars->interp_nDirs = 0;
+    pars->interp_dirs_deg = NULL;
+    pars->interp_dirs_rad = NULL;
+    pars->Y_up = NULL;
+    pars->interp_table = NULL;
+    pars->w = NULL;
+    pars->Cw = NULL;
+    pars->Uw = NULL;
+    pars->Cxyz = NULL;
+    pars->ss = NULL;
+    pars->ssxyz = NULL;
+    pars->est_dirs = NULL;
+    pars->est_dirs_idx = NULL;
+    pars->prev_intensity = NULL;
+    pars->prev_energy = NULL;
+    pars->pmap = NULL;
+    for(i=0; i<NUM_DISP_SLOTS; i++)
+        pars->pmap_grid[i] = NULL;
+}
+
+void dirass_destroyCodecPars(dirass_codecPars** const pPars)
+{
+    dirass_codecPars* pars = *pPars;
+    int i;
+
+    if(pars!=NULL){
+        free(pars->interp_dirs_deg);
+        free(pars->interp_dirs_rad);
+        free(pars->Y_up);
+        free(pars->interp_table);
+        free(pars->ss);
+        free(pars->ssxyz);
+        free(pars->Cxyz);
+        free(pars->w);
+        free(pars->Cw);
+        free(pars->Uw);
+        free(pars->est_dirs);
+        free(pars->est_dirs_idx);
+        free(pars->prev_intensity);
+        free(pars->prev_energy);
+        free(pars->pmap);
+        for(i=0; i<NUM_DISP_SLOTS; i++)
+            free(pars->pmap_grid[i]);
+        free(pars);
+        pars = NULL;
+        *pPars = NULL;
     }
-    pData->codecStatus = newStatus;
 }
 
-void dirass_initAna(void* const hDir)
+void dirass_initAna
+(
+    void* const hDir,
+    dirass_codecPars* const pars
+)
 {
     dirass_data *pData = (dirass_data*)(hDir);
-    dirass_codecPars* pars = pData->pars;
     int i, j, N_azi, N_ele, nSH_order, order, nSH_sec, order_sec, order_up, nSH_up, geosphere_ico_freq, td_degree;
     float hfov, vfov, fi, aspectRatio;
     float *grid_x_axis, *grid_y_axis, *c_n;
@@ -223,19 +279,19 @@ void dirass_initAna(void* const hDir)
     pars->est_dirs = realloc1d(pars->est_dirs, pars->grid_nDirs * 2 * sizeof(float));
     pars->ss = realloc1d(pars->ss, pars->grid_nDirs * DIRASS_FRAME_SIZE * sizeof(float));
     pars->ssxyz = realloc1d(pars->ssxyz, 3 * DIRASS_FRAME_SIZE * sizeof(float));
-    pData->pmap = realloc1d(pData->pmap, pars->grid_nDirs*sizeof(float));
+    pars->pmap = realloc1d(pars->pmap, pars->grid_nDirs*sizeof(float));
     pars->est_dirs_idx = realloc1d(pars->est_dirs_idx, pars->grid_nDirs*sizeof(int));
     pars->prev_intensity = realloc1d(pars->prev_intensity, pars->grid_nDirs*3*sizeof(float));
     pars->prev_energy = realloc1d(pars->prev_energy, pars->grid_nDirs*sizeof(float));
     memset(pars->prev_intensity, 0, pars->grid_nDirs*3*sizeof(float));
     memset(pars->prev_energy, 0, pars->grid_nDirs*sizeof(float)); 
     for(i=0; i<NUM_DISP_SLOTS; i++){
-        pData->pmap_grid[i] = realloc1d(pData->pmap_grid[i], pars->interp_nDirs*sizeof(float));
-        memset(pData->pmap_grid[i], 0, pars->interp_nDirs*sizeof(float));
+        pars->pmap_grid[i] = realloc1d(pars->pmap_grid[i], pars->interp_nDirs*sizeof(float));
+        memset(pars->pmap_grid[i], 0, pars->interp_nDirs*sizeof(float));
     }
     
-    pData->inputOrder = order;
-    pData->upscaleOrder = order_up;
+    pars->inputOrder = order;
+    pars->upscaleOrder = order_up;
     
     free(grid_x_axis);
     free(grid_y_axis);
@@ -66,10 +66,19 @@ extern "C" {
 /* ========================================================================== */
 
 /**
- * Contains variables for scanning grids, and sector beamforming
+ * Contains variables for scanning grids, and sector beamforming; i.e.
+ * everything that dirass_analysis() needs from an initialisation
+ *
+ * A new set is built by dirass_initCodec() (while the analysis keeps running
+ * with the current one), and then handed over to the analysis thread via a
+ * saf_stateSwap. Once published, only the analysis thread may touch it, until
+ * it is handed back by the next initialisation.
  */
 typedef struct _dirass_codecPars
 {
+    int inputOrder;           /**< input/analysis order */
+    int upscaleOrder;         /**< target upscale order */
+
     /* scanning grid and intepolation table */
     float* grid_dirs_deg;     /**< scanning grid directions; FLAT: grid_nDirs x 2 */
     int grid_nDirs;           /**< number of grid directions */
@@ -93,6 +102,10 @@ typedef struct _dirass_codecPars
     
     /* regular beamforming */
     float* w;                 /**< beamforming weights; FLAT: nDirs x (order+1)^2 */
+
+    /* display */
+    float* pmap;              /**< grid_nDirs x 1 */
+    float* pmap_grid[NUM_DISP_SLOTS]; /**< dirass interpolated to grid; interp_nDirs x 1 */
      
 }dirass_codecPars;
     
@@ -102,9 +115,9 @@ typedef struct _dirass_codecPars
  */
 typedef struct _dirass
 {
-    /* FIFO buffers */
-    int FIFO_idx;                           /**< FIFO buffer index */
-    float inFIFO[MAX_NUM_INPUT_SH_SIGNALS][DIRASS_FRAME_SIZE]; /**< FIFO buffer */
+    /* Block adapter */
+    void* hBlockAdapter;                    /**< Block adapter handle (for arbitrary host block sizes) */
+    int isPlaying;                          /**< Flag passed on to dirass_analysisFrame() */
     
     /* Buffers */
     float SHframeTD[MAX_NUM_INPUT_SH_SIGNALS][DIRASS_FRAME_SIZE];       /**< Input SH signals */
@@ -119,15 +132,16 @@ typedef struct _dirass
     int new_upscaleOrder;                   /**< New target upscale order */
     
     /* ana configuration */
-    CODEC_STATUS codecStatus;               /**< see #CODEC_STATUS */
-    PROC_STATUS procStatus;                 /**< see #PROC_STATUS */
+    volatile long codecStatus;              /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;                 /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;                   /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;                  /**< Current (re)initialisation step, string */
-    dirass_codecPars* pars;                 /**< codec parameters */
+    void* hStateSwap;                       /**< saf_stateSwap handle, via which new codec parameters are handed over to the analysis thread */
+    dirass_codecPars* liveState;            /**< The last published codec parameters (or NULL); read-only, until they are handed back */
+    dirass_codecPars* spareState;           /**< The previous codec parameters (or NULL), in which the next ones are built */
+    volatile long resetAvgFLAG;             /**< 1: the analysis thread clears its temporal averaging buffers (only accessed via the saf_atomic functions) */
     
     /* display */
-    float* pmap;                            /**< grid_nDirs x 1 */
-    float* pmap_grid[NUM_DISP_SLOTS];       /**< dirass interpolated to grid; interp_nDirs x 1 */
     int dispSlotIdx;                        /**< current display slot index */
     float pmap_grid_minVal;                 /**< minimum value in pmap */
     float pmap_grid_maxVal;                 /**< maximum value in pmap */
@@ -135,10 +149,10 @@ typedef struct _dirass
     int pmapReady;                          /**< 0: image generation not started yet, 1: image is ready for plotting*/
     
     /* User parameters */
-    int inputOrder;                         /**< Current input/analysis order */
+    int inputOrder;                         /**< Input/analysis order of the last built codec parameters */
     STATIC_BEAM_TYPES beamType;             /**< beamformer type mode */
     DIRASS_REASS_MODES DirAssMode;          /**< see #DIRASS_REASS_MODES enum */
-    int upscaleOrder;                       /**< Current target upscale order */
+    int upscaleOrder;                       /**< Target upscale order of the last built codec parameters */
     DIRASS_GRID_OPTIONS gridOption;         /**< grid option */
     float pmapAvgCoeff;                     /**< averaging coefficient for the intensity vector per grid direction */
     float minFreq_hz;                       /**< minimum frequency to include in pmap generation, Hz */
@@ -158,8 +172,18 @@ typedef struct _dirass
 /** Sets codec status (see #CODEC_STATUS enum) */
 void dirass_setCodecStatus(void* const hDir, CODEC_STATUS newStatus);
 
-/** Intialises the codec variables, based on current global/user parameters */
-void dirass_initAna(void* const hDir);
+/** Creates an (empty) set of codec parameters; see #dirass_codecPars */
+void dirass_createCodecPars(dirass_codecPars** const pPars);
+
+/** Destroys a set of codec parameters (if not NULL) */
+void dirass_destroyCodecPars(dirass_codecPars** const pPars);
+
+/**
+ * Intialises the codec variables, based on current global/user parameters
+ * (written to the given set of codec parameters)
+ */
+void dirass_initAna(void* const hDir,
+                    dirass_codecPars* const pars);
 
 
 #ifdef __cplusplus
@@ -46,15 +46,14 @@ void matrixconv_create
     pData->reInitFilters = 1;
     pData->nfilters = 0;
     pData->filter_length = 0;
+    pData->filter_length_conv = 0;
     pData->filter_fs = 0;
     pData->input_wav_length = 0;
     pData->nOutputChannels = 0;
 
-    /* set FIFO buffers */
+    /* for passing arbitrary host block sizes through matrixconv_processFrame() (created by matrixconv_init()) */
     pData->host_fs = 48000.0f;
-    pData->FIFO_idx = 0;
-    pData->inFIFO = (float**)calloc2d(MAX_NUM_CHANNELS, MAX_FRAME_SIZE, sizeof(float));
-    pData->outFIFO = (float**)calloc2d(MAX_NUM_CHANNELS, MAX_FRAME_SIZE, sizeof(float));
+    pData->hBlockAdapter = NULL;
 }
 
 void matrixconv_destroy
@@ -69,8 +68,7 @@ void matrixconv_destroy
         free(pData->outputFrameTD);
         free(pData->filters);
         saf_matrixConv_destroy(&(pData->hMatrixConv));
-        free(pData->inFIFO);
-        free(pData->outFIFO);
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phMCnv = NULL;
@@ -92,12 +90,18 @@ void matrixconv_init
         pData->hostBlockSize = hostBlockSize;
         pData->hostBlockSize_clamped = SAF_CLAMP(pData->hostBlockSize, MIN_FRAME_SIZE, MAX_FRAME_SIZE);
         pData->reInitFilters = 1;
+
+        /* The host blocks are passed through the convolver in frames of hostBlockSize_clamped samples */
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
+        saf_blockAdapter_create(&(pData->hBlockAdapter), pData->hostBlockSize_clamped, MAX_NUM_CHANNELS, MAX_NUM_CHANNELS);
+        saf_blockAdapter_reset(pData->hBlockAdapter, pData->hostBlockSize);
     }
     
     matrixconv_checkReInit(hMCnv);
 } 
 
-void matrixconv_process
+/** Processes one frame of hostBlockSize_clamped samples (see matrixconv_process()) */
+static void matrixconv_processFrame
 (
     void        *  const hMCnv,
     const float *const * inputs,
@@ -108,55 +112,61 @@ void matrixconv_process
 )
 {
     matrixconv_data *pData = (matrixconv_data*)(hMCnv);
-    int s, ch, i;
+    int ch;
     int numInputChannels, numOutputChannels;
- 
-    matrixconv_checkReInit(hMCnv);
 
     /* prep */
     numInputChannels = pData->nInputChannels;
     numOutputChannels = pData->nOutputChannels;
 
-    for(s=0; s<nSamples; s++){
-        /* Load input signals into inFIFO buffer */
-        for(ch=0; ch<SAF_MIN(SAF_MIN(nInputs,numInputChannels),MAX_NUM_CHANNELS); ch++)
-            pData->inFIFO[ch][pData->FIFO_idx] = inputs[ch][s];
+    /* Process frame if filters are loaded and the convolver is ready for it */
+    if (pData->reInitFilters == 0) {
+        /* Load time-domain data */
+        for(ch=0; ch<SAF_MIN(nInputs,numInputChannels); ch++)
+            utility_svvcopy(inputs[ch], nSamples, pData->inputFrameTD[ch]);
         for(; ch<numInputChannels; ch++) /* Zero any channels that were not given */
-            pData->inFIFO[ch][pData->FIFO_idx] = 0.0f;
-
-        /* Pull output signals from outFIFO buffer */
-        for(ch=0; ch<SAF_MIN(SAF_MIN(nOutputs, numOutputChannels),MAX_NUM_CHANNELS); ch++)
-            outputs[ch][s] = pData->outFIFO[ch][pData->FIFO_idx];
+            memset(pData->inputFrameTD[ch], 0, nSamples*sizeof(float));
+
+        /* Apply matrix convolution */
+        if(pData->hMatrixConv != NULL && pData->filter_length>0)
+            saf_matrixConv_apply(pData->hMatrixConv, FLATTEN2D(pData->inputFrameTD), FLATTEN2D(pData->outputFrameTD));
+        /* if the matrix convolver handle has not been initialised yet (i.e. no filters have been loaded) then zero the output */
+        else
+            memset(FLATTEN2D(pData->outputFrameTD), 0, MAX_NUM_CHANNELS * (pData->hostBlockSize_clamped)*sizeof(float));
+
+        /* copy signals to output buffer */
+        for(ch=0; ch<SAF_MIN(nOutputs,numOutputChannels); ch++)
+            utility_svvcopy(pData->outputFrameTD[ch], nSamples, outputs[ch]);
         for(; ch<nOutputs; ch++) /* Zero any extra channels */
-            outputs[ch][s] = 0.0f;
-
-        /* Increment buffer index */
-        pData->FIFO_idx++;
-
-        /* Process frame if inFIFO is full and filters are loaded and saf_matrixConv_apply is ready for it */
-        if (pData->FIFO_idx >= pData->hostBlockSize_clamped && pData->reInitFilters == 0 ) {
-            pData->FIFO_idx = 0;
-
-            /* Load time-domain data */
-            for(i=0; i < numInputChannels; i++)
-                utility_svvcopy(pData->inFIFO[i], pData->hostBlockSize_clamped, pData->inputFrameTD[i]);
+            memset(outputs[ch], 0, nSamples*sizeof(float));
+    }
+    else{
+        for(ch=0; ch<nOutputs; ch++)
+            memset(outputs[ch], 0, nSamples*sizeof(float));
+    }
+}
 
-            /* Apply matrix convolution */
-            if(pData->hMatrixConv != NULL && pData->filter_length>0)
-                saf_matrixConv_apply(pData->hMatrixConv, FLATTEN2D(pData->inputFrameTD), FLATTEN2D(pData->outputFrameTD));
-            /* if the matrix convolver handle has not been initialised yet (i.e. no filters have been loaded) then zero the output */
-            else
-                memset(FLATTEN2D(pData->outputFrameTD), 0, MAX_NUM_CHANNELS * (pData->hostBlockSize_clamped)*sizeof(float));
+void matrixconv_process
+(
+    void        *  const hMCnv,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    matrixconv_data *pData = (matrixconv_data*)(hMCnv);
+    int ch;
+ 
+    matrixconv_checkReInit(hMCnv);
 
-            /* copy signals to output buffer */
-            for (i = 0; i < SAF_MIN(numOutputChannels, MAX_NUM_CHANNELS); i++)
-                utility_svvcopy(pData->outputFrameTD[i], pData->hostBlockSize_clamped, pData->outFIFO[i]);
-        }
-        else if(pData->FIFO_idx >= pData->hostBlockSize_clamped){
-            /* clear outFIFO if codec was not ready */
-            pData->FIFO_idx = 0;
-            memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
-        }
+    /* Process the host buffers in frames of hostBlockSize_clamped samples (once matrixconv_init() has been called) */
+    if(pData->hBlockAdapter != NULL)
+        saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, matrixconv_processFrame, hMCnv);
+    else{
+        for(ch=0; ch<nOutputs; ch++)
+            memset(outputs[ch], 0, nSamples*sizeof(float));
     }
 }
 
@@ -178,6 +188,7 @@ void matrixconv_checkReInit(void* const hMCnv)
         pData->reInitFilters = 2;
         saf_matrixConv_destroy(&(pData->hMatrixConv));
         pData->hMatrixConv = NULL;
+        pData->filter_length_conv = 0;
         
         /* if length of the loaded wav file was not divisable by the specified number of inputs, then the handle remains NULL,
          * and no convolution is applied */
@@ -190,6 +201,7 @@ void matrixconv_checkReInit(void* const hMCnv)
                                   pData->nInputChannels,
                                   pData->nOutputChannels,
                                   pData->enablePartitionedConv);
+            pData->filter_length_conv = pData->filter_length;
         }
 
         /* Resize buffers */
@@ -197,10 +209,9 @@ void matrixconv_checkReInit(void* const hMCnv)
         pData->outputFrameTD = (float**)realloc2d((void**)pData->outputFrameTD, MAX_NUM_CHANNELS, pData->hostBlockSize_clamped, sizeof(float));
         memset(FLATTEN2D(pData->inputFrameTD), 0, MAX_NUM_CHANNELS*(pData->hostBlockSize_clamped)*sizeof(float));
 
-        /* reset FIFO buffers */
-        pData->FIFO_idx = 0;
-        memset(FLATTEN2D(pData->inFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
-        memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
+        /* flush the block adapter */
+        if(pData->hBlockAdapter != NULL)
+            saf_blockAdapter_reset(pData->hBlockAdapter, pData->hostBlockSize);
 
         pData->reInitFilters = 0;
     }
@@ -216,9 +227,10 @@ void matrixconv_setFilters
 )
 {
     matrixconv_data *pData = (matrixconv_data*)(hMCnv);
-    int i;
+    int i, nOutputChannels_last;
     saf_assert(numChannels<=MAX_NUM_CHANNELS_FOR_WAV && numChannels > 0 && numSamples > 0, "WAV is limited to 1024 channels");
     
+    nOutputChannels_last = pData->nOutputChannels;
     pData->nOutputChannels = SAF_MIN(numChannels, MAX_NUM_CHANNELS);
     pData->input_wav_length = numSamples;
     pData->nfilters = (pData->nOutputChannels) * (pData->nInputChannels);
@@ -236,7 +248,14 @@ void matrixconv_setFilters
     else
         pData->filter_length = 0;
 
-    pData->reInitFilters = 1;
+    /* If only the filter coefficients have changed, and the new filters are no longer than those the convolver was
+     * created with, then they are swapped in without interrupting the audio (longer filters, or a change in the number
+     * of channels, require the convolver to be re-initialised) */
+    if(pData->hMatrixConv!=NULL && pData->reInitFilters==0 && pData->filter_length>0 &&
+       pData->nOutputChannels==nOutputChannels_last && pData->filter_length<=pData->filter_length_conv)
+        saf_matrixConv_updateFilters(pData->hMatrixConv, pData->filters, pData->filter_length);
+    else
+        pData->reInitFilters = 1;
 }
 
 void matrixconv_setEnablePart(void* const hMCnv, int newState)
@@ -314,6 +333,6 @@ int matrixconv_getHostFs(void* const hMCnv)
 int matrixconv_getProcessingDelay(void* const hMCnv)
 {
     matrixconv_data *pData = (matrixconv_data*)(hMCnv);
-    return pData->hostBlockSize_clamped;
+    return pData->hBlockAdapter != NULL ? saf_blockAdapter_getLatency(pData->hBlockAdapter) : 0;
 }
 
@@ -48,10 +48,8 @@ extern "C" {
 /** Main structure for matrixconv */
 typedef struct _matrixconv
 {
-    /* FIFO buffers */
-    int FIFO_idx;          /**< FIFO buffer index */
-    float** inFIFO;        /**< Input FIFO buffer */
-    float** outFIFO;       /**< Output FIFO buffer */
+    /* Block adapter */
+    void* hBlockAdapter;   /**< Block adapter handle (for arbitrary host block sizes); frame size: hostBlockSize_clamped */
 
     /* input/output buffers */
     float** inputFrameTD;  /**< Input buffer; #MAX_NUM_CHANNELS x hostBlockSize_clamped */
@@ -65,6 +63,7 @@ typedef struct _matrixconv
     int nfilters;          /**< the number of filters (nOutputChannels x nInputChannels) */
     int input_wav_length;  /**< length of the wav files loaded in samples (inputs are concatenated) */
     int filter_length;     /**< length of the filters (input_wav_length/nInputChannels) */
+    int filter_length_conv; /**< length of the filters that hMatrixConv was created with (0 if NULL) */
     int filter_fs;         /**< current samplerate of the filters */
     int host_fs;           /**< current samplerate of the host */
     int reInitFilters;     /**< FLAG: 0: do not reinit, 1: reinit, 2: reinit in progress */
@@ -72,7 +71,7 @@ typedef struct _matrixconv
     
     /* user parameters */
     int nInputChannels;        /**< number of input channels */
-    int enablePartitionedConv; /**< 0: disabled, 1: enabled */
+    int enablePartitionedConv; /**< 0: disabled, 1: enabled, 2: enabled (non-uniform) */
     
 } matrixconv_data;
     
@@ -48,13 +48,9 @@ void multiconv_create
     pData->filter_length = 0;
     pData->filter_fs = 0;
 
-    /* set FIFO buffers */
+    /* for passing arbitrary host block sizes through multiconv_processFrame() (created by multiconv_init()) */
     pData->host_fs = 48000.0f;
-    pData->FIFO_idx = 0;
-    pData->inFIFO = (float**)calloc2d(MAX_NUM_CHANNELS, MAX_FRAME_SIZE, sizeof(float));
-    pData->outFIFO = (float**)calloc2d(MAX_NUM_CHANNELS, MAX_FRAME_SIZE, sizeof(float));
-//    memset(FLATTEN2D(pData->inFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
-//    memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
+    pData->hBlockAdapter = NULL;
 }
 
 void multiconv_destroy
@@ -69,8 +65,7 @@ void multiconv_destroy
         free(pData->outputFrameTD);
         free(pData->filters);
         saf_multiConv_destroy(&(pData->hMultiConv));
-        free(pData->inFIFO);
-        free(pData->outFIFO);
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phMCnv = NULL;
@@ -91,13 +86,19 @@ void multiconv_init
         pData->hostBlockSize = hostBlockSize;
         pData->hostBlockSize_clamped = SAF_CLAMP(pData->hostBlockSize, MIN_FRAME_SIZE, MAX_FRAME_SIZE);
         pData->reInitFilters = 1;
+
+        /* The host blocks are passed through the convolver in frames of hostBlockSize_clamped samples */
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
+        saf_blockAdapter_create(&(pData->hBlockAdapter), pData->hostBlockSize_clamped, MAX_NUM_CHANNELS, MAX_NUM_CHANNELS);
+        saf_blockAdapter_reset(pData->hBlockAdapter, pData->hostBlockSize);
     }
     
     multiconv_checkReInit(hMCnv);
 } 
 
 
-void multiconv_process
+/** Processes one frame of hostBlockSize_clamped samples (see multiconv_process()) */
+static void multiconv_processFrame
 (
     void        *  const hMCnv,
     const float *const * inputs,
@@ -108,53 +109,59 @@ void multiconv_process
 )
 {
     multiconv_data *pData = (multiconv_data*)(hMCnv);
-    int s, ch, i;
+    int ch;
     int numChannels;
- 
-    multiconv_checkReInit(hMCnv);
 
     /* prep */
     numChannels = SAF_MIN(pData->nChannels, pData->nfilters);
 
-    for(s=0; s<nSamples; s++){
-        /* Load input signals into inFIFO buffer */
-        for(ch=0; ch<SAF_MIN(SAF_MIN(nInputs,numChannels),MAX_NUM_CHANNELS); ch++)
-            pData->inFIFO[ch][pData->FIFO_idx] = inputs[ch][s];
+    /* Process frame if filters are loaded and the convolver is ready for it */
+    if (pData->reInitFilters == 0) {
+        /* Load time-domain data */
+        for(ch=0; ch<SAF_MIN(nInputs,numChannels); ch++)
+            utility_svvcopy(inputs[ch], nSamples, pData->inputFrameTD[ch]);
         for(; ch<numChannels; ch++) /* Zero any channels that were not given */
-            pData->inFIFO[ch][pData->FIFO_idx] = 0.0f;
+            memset(pData->inputFrameTD[ch], 0, nSamples*sizeof(float));
+
+        /* Apply convolution */
+        if(pData->hMultiConv != NULL)
+            saf_multiConv_apply(pData->hMultiConv, FLATTEN2D(pData->inputFrameTD), FLATTEN2D(pData->outputFrameTD));
+        else
+            memset(FLATTEN2D(pData->outputFrameTD), 0, MAX_NUM_CHANNELS * (pData->hostBlockSize_clamped)*sizeof(float));
 
-        /* Pull output signals from outFIFO buffer */
-        for(ch=0; ch<SAF_MIN(SAF_MIN(nOutputs, numChannels),MAX_NUM_CHANNELS); ch++)
-            outputs[ch][s] = pData->outFIFO[ch][pData->FIFO_idx];
+        /* copy signals to output buffer */
+        for(ch=0; ch<SAF_MIN(nOutputs,numChannels); ch++)
+            utility_svvcopy(pData->outputFrameTD[ch], nSamples, outputs[ch]);
         for(; ch<nOutputs; ch++) /* Zero any extra channels */
-            outputs[ch][s] = 0.0f;
-
-        /* Increment buffer index */
-        pData->FIFO_idx++;
-
-        /* Process frame if inFIFO is full and filters are loaded and saf_matrixConv_apply is ready for it */
-        if (pData->FIFO_idx >= pData->hostBlockSize_clamped && pData->reInitFilters == 0 ) {
-            pData->FIFO_idx = 0;
-
-            /* Load time-domain data */
-            for(i=0; i < numChannels; i++)
-                utility_svvcopy(pData->inFIFO[i], pData->hostBlockSize_clamped, pData->inputFrameTD[i]);
-
-            /* Apply convolution */
-            if(pData->hMultiConv != NULL)
-                saf_multiConv_apply(pData->hMultiConv, FLATTEN2D(pData->inputFrameTD), FLATTEN2D(pData->outputFrameTD));
-            else
-                memset(FLATTEN2D(pData->outputFrameTD), 0, MAX_NUM_CHANNELS * (pData->hostBlockSize_clamped)*sizeof(float));
-
-            /* copy signals to output buffer */
-            for (i = 0; i < SAF_MIN(numChannels, MAX_NUM_CHANNELS); i++)
-                utility_svvcopy(pData->outputFrameTD[i], pData->hostBlockSize_clamped, pData->outFIFO[i]);
-        }
-        else if(pData->FIFO_idx >= pData->hostBlockSize_clamped){
-            /* clear outFIFO if codec was not ready */
-            pData->FIFO_idx = 0;
-            memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
-        }
+            memset(outputs[ch], 0, nSamples*sizeof(float));
+    }
+    else{
+        for(ch=0; ch<nOutputs; ch++)
+            memset(outputs[ch], 0, nSamples*sizeof(float));
+    }
+}
+
+void multiconv_process
+(
+    void        *  const hMCnv,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    multiconv_data *pData = (multiconv_data*)(hMCnv);
+    int ch;
+ 
+    multiconv_checkReInit(hMCnv);
+
+    /* Process the host buffers in frames of hostBlockSize_clamped samples (once multiconv_init() has been called) */
+    if(pData->hBlockAdapter != NULL)
+        saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, multiconv_processFrame, hMCnv);
+    else{
+        for(ch=0; ch<nOutputs; ch++)
+            memset(outputs[ch], 0, nSamples*sizeof(float));
     }
 }
 
@@ -188,10 +195,9 @@ void multiconv_checkReInit(void* const hMCnv)
         pData->outputFrameTD = (float**)realloc2d((void**)pData->outputFrameTD, MAX_NUM_CHANNELS, pData->hostBlockSize_clamped, sizeof(float));
         memset(FLATTEN2D(pData->inputFrameTD), 0, MAX_NUM_CHANNELS*(pData->hostBlockSize_clamped)*sizeof(float));
 
-        /* reset FIFO buffers */
-        pData->FIFO_idx = 0;
-        memset(FLATTEN2D(pData->inFIFO),  0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
-        memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
+        /* flush the block adapter */
+        if(pData->hBlockAdapter != NULL)
+            saf_blockAdapter_reset(pData->hBlockAdapter, pData->hostBlockSize);
 
         pData->reInitFilters = 0;
     }
@@ -280,5 +286,5 @@ int multiconv_getHostFs(void* const hMCnv)
 int multiconv_getProcessingDelay(void* const hMCnv)
 {
     multiconv_data *pData = (multiconv_data*)(hMCnv);
-    return pData->hostBlockSize_clamped;
+    return pData->hBlockAdapter != NULL ? saf_blockAdapter_getLatency(pData->hBlockAdapter) : 0;
 }
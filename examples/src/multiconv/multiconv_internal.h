@@ -47,10 +47,8 @@ extern "C" {
 /** Main structure for multiconv */
 typedef struct _multiconv
 {
-    /* FIFO buffers */
-    int FIFO_idx;          /**< FIFO buffer index */
-    float** inFIFO;        /**< Input FIFO buffer */
-    float** outFIFO;       /**< Output FIFO buffer */
+    /* Block adapter */
+    void* hBlockAdapter;   /**< Block adapter handle (for arbitrary host block sizes); frame size: hostBlockSize_clamped */
 
     /* Internal buffers */
     float** inputFrameTD;  /**< Input buffer; #MAX_NUM_CHANNELS x hostBlockSize_clamped */
@@ -69,7 +67,7 @@ typedef struct _multiconv
     
     /* user parameters */
     int nChannels;         /**< Current number of input/output channels */
-    int enablePartitionedConv; /**< 1: enable partitioned convolution, 0: regular convolution (fft over the length of the filter) */
+    int enablePartitionedConv; /**< 1: enable partitioned convolution, 2: enable non-uniform partitioned convolution, 0: regular convolution (fft over the length of the filter) */
     
 } multiconv_data;
 
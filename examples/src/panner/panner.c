@@ -68,23 +68,29 @@ void panner_create
     
     /* time-frequency transform + buffers */
     pData->fs = 48000.0f;
-    pData->hSTFT = NULL;
-    pData->inputFrameTD = (float**)malloc2d(MAX_NUM_INPUTS, PANNER_FRAME_SIZE, sizeof(float));
-    pData->outputFrameTD = (float**)malloc2d(MAX_NUM_OUTPUTS, PANNER_FRAME_SIZE, sizeof(float));
-    pData->inputframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_INPUTS, TIME_SLOTS, sizeof(float_complex));
-    pData->outputframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
+    pData->inputFrameTD = (float**)malloc2d_aligned(MAX_NUM_INPUTS, PANNER_FRAME_SIZE, sizeof(float));
+    pData->outputFrameTD = (float**)malloc2d_aligned(MAX_NUM_OUTPUTS, PANNER_FRAME_SIZE, sizeof(float));
+    pData->inputframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_INPUTS, TIME_SLOTS, sizeof(float_complex));
+    pData->outputframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
 
     /* flags and gain table */
     pData->progressBar0_1 = 0.0f;
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    pData->initLock = 0;
     for(ch=0; ch<MAX_NUM_INPUTS; ch++)
         pData->recalc_gainsFLAG[ch] = 1;
-    pData->vbap_gtable = NULL;
+    pData->nTriangles = 0;
     pData->recalc_M_rotFLAG = 1;
     pData->reInitGainTables = 1;
+
+    /* render states (afSTFT and VBAP gain table) are built by panner_initCodec() */
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
+
+    /* for passing arbitrary host block sizes through panner_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), PANNER_FRAME_SIZE, MAX_NUM_INPUTS, MAX_NUM_OUTPUTS);
 }
 
 void panner_destroy
@@ -93,24 +99,26 @@ void panner_destroy
 )
 {
     panner_data *pData = (panner_data*)(*phPan);
+    panner_renderState *state;
 
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
+        /* Wait for any on-going initialisation to complete, and then take back the current render state (which also
+         * waits for the processing loop to let go of it) */
+        saf_spinLock_lock(&(pData->initLock));
+        state = (panner_renderState*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(state==pData->liveState, "Unexpected render state");
+        panner_destroyRenderState(&state);
+        panner_destroyRenderState(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
         
-        /* free afSTFT and buffers */
-        if(pData->hSTFT !=NULL)
-            afSTFT_destroy(&(pData->hSTFT));
-        free(pData->inputFrameTD);
-        free(pData->outputFrameTD);
-        free(pData->inputframeTF);
-        free(pData->outputframeTF);
-        free(pData->vbap_gtable);
+        /* free buffers */
+        free2d_aligned((void**)pData->inputFrameTD);
+        free2d_aligned((void**)pData->outputFrameTD);
+        free3d_aligned((void***)pData->inputframeTF);
+        free3d_aligned((void***)pData->outputframeTF);
         free(pData->progressBarText);
         
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phPan = NULL;
@@ -120,20 +128,24 @@ void panner_destroy
 void panner_init
 (
     void * const hPan,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     panner_data *pData = (panner_data*)(hPan);
     
     /* define frequency vector */
     pData->fs = sampleRate;
-    afSTFT_getCentreFreqs(pData->hSTFT, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
+    afSTFT_getCentreFreqs(NULL, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
     
     /* calculate pValue per frequency */
     getPvalues(pData->DTT, pData->freqVector, HYBRID_BANDS, pData->pValue);
 
     /* reinitialise if needed */
     pData->recalc_M_rotFLAG = 1;
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
 void panner_initCodec
@@ -142,37 +154,62 @@ void panner_initCodec
 )
 {
     panner_data *pData = (panner_data*)(hPan);
+    panner_renderState* state, *live;
+    int reinitGainTables;
     
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
+
+    /* Take (and clear) the gain table flag now, such that a refresh requested during this initialisation is not lost */
+    reinitGainTables = saf_atomic_compareExchange(&(pData->reInitGainTables), 1, 0);
     
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Initialising");
     pData->progressBar0_1 = 0.0f;
+
+    /* The new render state is built in the spare one, while the audio thread keeps rendering with the current one */
+    if(pData->spareState==NULL)
+        panner_createRenderState(&(pData->spareState));
+    state = pData->spareState;
+    live = pData->liveState;
     
     /* reinit TFT if needed */
-    panner_initTFT(hPan);
+    panner_initTFT(hPan, state);
     
-    /* reinit gain tables */
-    if(pData->reInitGainTables){
-        panner_initGainTables(hPan);
-        pData->reInitGainTables = 0;
+    /* reinit gain tables (or carry over the one currently in use) */
+    if(reinitGainTables || live==NULL || live->vbap_gtable==NULL)
+        panner_initGainTables(hPan, state);
+    else{
+        state->output_nDims = live->output_nDims;
+        state->vbapTableRes[0] = live->vbapTableRes[0];
+        state->vbapTableRes[1] = live->vbapTableRes[1];
+        state->N_vbap_gtable = live->N_vbap_gtable;
+        state->vbap_gtable = realloc1d(state->vbap_gtable, live->N_vbap_gtable*(live->nLoudpkrs)*sizeof(float));
+        memcpy(state->vbap_gtable, live->vbap_gtable, live->N_vbap_gtable*(live->nLoudpkrs)*sizeof(float));
     }
+    state->recalc_gainsFLAG = 1;
+
+    /* Hand the new render state over to the audio thread, and keep the previous one as the spare, once it is no longer
+     * being used */
+    pData->spareState = (panner_renderState*)saf_stateSwap_publish(pData->hStateSwap, (void*)state);
+    pData->liveState = state;
+    if(pData->spareState!=NULL && pData->spareState->hSTFT == state->hSTFT)
+        pData->spareState->hSTFT = NULL; /* (passed on to the new render state) */
     
-    /* done! */
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
-    
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
-void panner_process
+/** Processes one frame of #PANNER_FRAME_SIZE samples (see panner_process()) */
+static void panner_processFrame
 (
     void        *  const hPan,
     const float *const * inputs,
@@ -183,6 +220,7 @@ void panner_process
 )
 {
     panner_data *pData = (panner_data*)(hPan);
+    panner_renderState* state;
     int t, ch, ls, i, band, nSources, nLoudspeakers, N_azi, aziIndex, elevIndex, idx3d, idx2D;
     float aziRes, elevRes, pv_f, gains3D_sum_pvf, gains2D_sum_pvf, Rxyz[3][3], hypotxy;
     float src_dirs[MAX_NUM_INPUTS][2], pValue[HYBRID_BANDS], gains3D[MAX_NUM_OUTPUTS], gains2D[MAX_NUM_OUTPUTS];
@@ -192,12 +230,22 @@ void panner_process
     /* copy user parameters to local variables */
     memcpy(src_dirs, pData->src_dirs_deg, MAX_NUM_INPUTS*2*sizeof(float));
     memcpy(pValue, pData->pValue, HYBRID_BANDS*sizeof(float));
-    nSources = pData->nSources;
-    nLoudspeakers = pData->nLoudpkrs;
+
+    /* The current render state remains valid (and untouched by panner_initCodec()) until it is released */
+    state = (panner_renderState*)saf_stateSwap_acquire(pData->hStateSwap);
 
     /* apply panner */
-    if ((nSamples == PANNER_FRAME_SIZE) && (pData->vbap_gtable != NULL) && (pData->codecStatus == CODEC_STATUS_INITIALISED) ) {
-        pData->procStatus = PROC_STATUS_ONGOING;
+    if ((nSamples == PANNER_FRAME_SIZE) && (state != NULL) && (state->vbap_gtable != NULL)) {
+        nSources = state->nSources;
+        nLoudspeakers = state->nLoudpkrs;
+
+        /* The panning gains (and rotated source directions) are recomputed after switching to a new render state */
+        if(state->recalc_gainsFLAG){
+            for(ch=0; ch<MAX_NUM_INPUTS; ch++)
+                pData->recalc_gainsFLAG[ch] = 1;
+            pData->recalc_M_rotFLAG = 1;
+            state->recalc_gainsFLAG = 0;
+        }
 
         /* Load time-domain data */
         for(i=0; i < SAF_MIN(nSources,nInputs); i++)
@@ -206,8 +254,8 @@ void panner_process
             memset(pData->inputFrameTD[i], 0, PANNER_FRAME_SIZE * sizeof(float));
 
         /* Apply time-frequency transform (TFT) */
-        afSTFT_forward_knownDimensions(pData->hSTFT, pData->inputFrameTD, PANNER_FRAME_SIZE, MAX_NUM_INPUTS, TIME_SLOTS, pData->inputframeTF);
-        memset(FLATTEN3D(pData->outputframeTF), 0, HYBRID_BANDS*MAX_NUM_OUTPUTS*TIME_SLOTS * sizeof(float_complex));
+        afSTFT_forward_knownDimensions(state->hSTFT, pData->inputFrameTD, PANNER_FRAME_SIZE, MAX_NUM_INPUTS, TIME_SLOTS_STRIDE, pData->inputframeTF);
+        memset(FLATTEN3D(pData->outputframeTF), 0, HYBRID_BANDS*MAX_NUM_OUTPUTS*TIME_SLOTS_STRIDE * sizeof(float_complex));
         memset(outputTemp, 0, MAX_NUM_OUTPUTS*TIME_SLOTS * sizeof(float_complex));
 
         /* Rotate source directions */
@@ -232,9 +280,9 @@ void panner_process
         }
 
         /* Apply VBAP Panning */
-        if(pData->output_nDims == 3){/* 3-D case */
-            aziRes = (float)pData->vbapTableRes[0];
-            elevRes = (float)pData->vbapTableRes[1];
+        if(state->output_nDims == 3){/* 3-D case */
+            aziRes = (float)state->vbapTableRes[0];
+            elevRes = (float)state->vbapTableRes[1];
             N_azi = (int)(360.0f / aziRes + 0.5f) + 1;
             for (ch = 0; ch < nSources; ch++) {
                 /* recalculate frequency dependent panning gains */
@@ -245,7 +293,7 @@ void panner_process
                     elevIndex = (int)((pData->src_dirs_rot_deg[ch][1] + 90.0f) / elevRes + 0.5f);
                     idx3d = elevIndex * N_azi + aziIndex;
                     for (ls = 0; ls < nLoudspeakers; ls++)
-                        gains3D[ls] =  pData->vbap_gtable[idx3d*nLoudspeakers+ls];
+                        gains3D[ls] =  state->vbap_gtable[idx3d*nLoudspeakers+ls];
                     for (band = 0; band < HYBRID_BANDS; band++){
                         /* apply pValue per frequency */
                         pv_f = pData->pValue[band];
@@ -268,7 +316,7 @@ void panner_process
             for (band = 0; band < HYBRID_BANDS; band++) {
                 cblas_cgemm(CblasRowMajor, CblasTrans, CblasNoTrans, nLoudspeakers, TIME_SLOTS, nSources, &calpha,
                     pData->G_src[band], MAX_NUM_OUTPUTS,
-                    FLATTEN2D(pData->inputframeTF[band]), TIME_SLOTS, &cbeta,
+                    FLATTEN2D(pData->inputframeTF[band]), TIME_SLOTS_STRIDE, &cbeta,
                     outputTemp, TIME_SLOTS);
                 for (i = 0; i < nLoudspeakers; i++)
                     for (t = 0; t < TIME_SLOTS; t++)
@@ -276,14 +324,14 @@ void panner_process
             }
         }
         else{/* 2-D case */
-            aziRes = (float)pData->vbapTableRes[0];
+            aziRes = (float)state->vbapTableRes[0];
             for (ch = 0; ch < nSources; ch++) {
                 /* recalculate frequency dependent panning gains */
                 if(pData->recalc_gainsFLAG[ch]){
                     //idx2D = (int)((matlab_fmodf(pData->src_dirs_deg[ch][0]+180.0f,360.0f)/aziRes)+0.5f);
                     idx2D = (int)((matlab_fmodf(pData->src_dirs_rot_deg[ch][0]+180.0f,360.0f)/aziRes)+0.5f);
                     for (ls = 0; ls < nLoudspeakers; ls++)
-                        gains2D[ls] = pData->vbap_gtable[idx2D*nLoudspeakers+ls];
+                        gains2D[ls] = state->vbap_gtable[idx2D*nLoudspeakers+ls];
                     for (band = 0; band < HYBRID_BANDS; band++){
                         /* apply pValue per frequency */
                         pv_f = pData->pValue[band];
@@ -313,10 +361,10 @@ void panner_process
 
         /* scale by sqrt(number of sources) */
         for (band = 0; band < HYBRID_BANDS; band++)
-            cblas_sscal(/*re+im*/2*nLoudspeakers*TIME_SLOTS, 1.0f/sqrtf((float)nSources), (float*)FLATTEN2D(pData->outputframeTF[band]), 1);
+            cblas_sscal(/*re+im*/2*nLoudspeakers*TIME_SLOTS_STRIDE, 1.0f/sqrtf((float)nSources), (float*)FLATTEN2D(pData->outputframeTF[band]), 1);
 
         /* inverse-TFT and copy to output */
-        afSTFT_backward_knownDimensions(pData->hSTFT, pData->outputframeTF, PANNER_FRAME_SIZE, MAX_NUM_OUTPUTS, TIME_SLOTS, pData->outputFrameTD);
+        afSTFT_backward_knownDimensions(state->hSTFT, pData->outputframeTF, PANNER_FRAME_SIZE, MAX_NUM_OUTPUTS, TIME_SLOTS_STRIDE, pData->outputFrameTD);
         for (ch = 0; ch < SAF_MIN(nLoudspeakers, nOutputs); ch++)
             utility_svvcopy(pData->outputFrameTD[ch], PANNER_FRAME_SIZE, outputs[ch]);
         for (; ch < nOutputs; ch++)
@@ -327,8 +375,23 @@ void panner_process
         for (ch=0; ch < nOutputs; ch++)
             memset(outputs[ch],0, PANNER_FRAME_SIZE*sizeof(float));
 
+    saf_stateSwap_release(pData->hStateSwap);
+}
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+void panner_process
+(
+    void        *  const hPan,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    panner_data *pData = (panner_data*)(hPan);
+
+    /* Process the host buffers in frames of #PANNER_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, panner_processFrame, hPan);
 }
 
 
@@ -338,7 +401,7 @@ void panner_refreshSettings(void* const hPan)
 {
     panner_data *pData = (panner_data*)(hPan);
     int ch;
-    pData->reInitGainTables = 1;
+    saf_atomic_store(&(pData->reInitGainTables), 1);
     for(ch=0; ch<MAX_NUM_INPUTS; ch++)
         pData->recalc_gainsFLAG[ch] = 1;
     panner_setCodecStatus(hPan, CODEC_STATUS_NOT_INITIALISED);
@@ -395,7 +458,7 @@ void panner_setLoudspeakerAzi_deg(void* const hPan, int index, float newAzi_deg)
     newAzi_deg = SAF_MIN(newAzi_deg, 180.0f);
     if(pData->loudpkrs_dirs_deg[index][0] != newAzi_deg){
         pData->loudpkrs_dirs_deg[index][0] = newAzi_deg;
-        pData->reInitGainTables=1;
+        saf_atomic_store(&(pData->reInitGainTables), 1);
         for(ch=0; ch<MAX_NUM_INPUTS; ch++)
             pData->recalc_gainsFLAG[ch] = 1;
         pData->recalc_M_rotFLAG = 1;
@@ -411,7 +474,7 @@ void panner_setLoudspeakerElev_deg(void* const hPan, int index, float newElev_de
     newElev_deg = SAF_MIN(newElev_deg, 90.0f);
     if(pData->loudpkrs_dirs_deg[index][1] != newElev_deg){
         pData->loudpkrs_dirs_deg[index][1] = newElev_deg;
-        pData->reInitGainTables=1;
+        saf_atomic_store(&(pData->reInitGainTables), 1);
         for(ch=0; ch<MAX_NUM_INPUTS; ch++)
             pData->recalc_gainsFLAG[ch] = 1;
         pData->recalc_M_rotFLAG = 1;
@@ -427,7 +490,7 @@ void panner_setNumLoudspeakers(void* const hPan, int new_nLoudspeakers)
     new_nLoudspeakers  = new_nLoudspeakers > MAX_NUM_OUTPUTS ? MAX_NUM_OUTPUTS : new_nLoudspeakers;
     if(pData->new_nLoudpkrs != new_nLoudspeakers){
         pData->new_nLoudpkrs = new_nLoudspeakers;
-        pData->reInitGainTables=1;
+        saf_atomic_store(&(pData->reInitGainTables), 1);
         for(ch=0; ch<MAX_NUM_INPUTS; ch++)
             pData->recalc_gainsFLAG[ch] = 1;
         pData->recalc_M_rotFLAG = 1;
@@ -440,7 +503,7 @@ void panner_setOutputConfigPreset(void* const hPan, int newPresetID)
     panner_data *pData = (panner_data*)(hPan);
     int ch, dummy;
     panner_loadLoudspeakerPreset(newPresetID, pData->loudpkrs_dirs_deg, &(pData->new_nLoudpkrs), &dummy);
-    pData->reInitGainTables=1;
+    saf_atomic_store(&(pData->reInitGainTables), 1);
     for(ch=0; ch<MAX_NUM_INPUTS; ch++)
         pData->recalc_gainsFLAG[ch] = 1;
     pData->recalc_M_rotFLAG = 1;
@@ -478,7 +541,7 @@ void panner_setSpread(void* const hPan, float newValue)
     int ch;
     if(pData->spread_deg!=newValue){
         pData->spread_deg = SAF_CLAMP(newValue, PANNER_SPREAD_MIN_VALUE, PANNER_SPREAD_MAX_VALUE);
-        pData->reInitGainTables=1;
+        saf_atomic_store(&(pData->reInitGainTables), 1);
         for(ch=0; ch<MAX_NUM_INPUTS; ch++)
             pData->recalc_gainsFLAG[ch] = 1;
         pData->recalc_M_rotFLAG = 1;
@@ -545,7 +608,7 @@ int panner_getFrameSize(void)
 CODEC_STATUS panner_getCodecStatus(void* const hPan)
 {
     panner_data *pData = (panner_data*)(hPan);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float panner_getProgressBar0_1(void* const hPan)
@@ -660,7 +723,8 @@ int panner_getFlipRoll(void* const hBin)
     return pData->bFlipRoll;
 }
 
-int panner_getProcessingDelay()
+int panner_getProcessingDelay(void* const hPan)
 {
-    return 12*HOP_SIZE;
+    panner_data *pData = (panner_data*)(hPan);
+    return 12*HOP_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
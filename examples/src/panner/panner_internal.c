@@ -47,15 +47,44 @@
 void panner_setCodecStatus(void* const hPan, CODEC_STATUS newStatus)
 {
     panner_data *pData = (panner_data*)(hPan);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next panner_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void panner_createRenderState(panner_renderState** const pState)
+{
+    panner_renderState* state = (panner_renderState*)malloc1d(sizeof(panner_renderState));
+    *pState = state;
+
+    state->nSources = state->nLoudpkrs = 0;
+    state->output_nDims = 3;
+    state->hSTFT = NULL;
+    state->vbapTableRes[0] = state->vbapTableRes[1] = 0;
+    state->vbap_gtable = NULL;
+    state->N_vbap_gtable = 0;
+    state->recalc_gainsFLAG = 1;
+}
+
+void panner_destroyRenderState(panner_renderState** const pState)
+{
+    panner_renderState* state = *pState;
+
+    if(state!=NULL){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        free(state->vbap_gtable);
+        free(state);
+        state = NULL;
+        *pState = NULL;
     }
-    pData->codecStatus = newStatus;
 }
 
-void panner_initGainTables(void* const hPan)
+void panner_initGainTables
+(
+    void* const hPan,
+    panner_renderState* const state
+)
 {
     panner_data *pData = (panner_data*)(hPan);
 #ifndef FORCE_3D_LAYOUT
@@ -64,53 +93,68 @@ void panner_initGainTables(void* const hPan)
     
     /* determine dimensionality */
     sum_elev = 0.0f;
-    for(i=0; i<pData->nLoudpkrs; i++)
+    for(i=0; i<state->nLoudpkrs; i++)
         sum_elev += fabsf(pData->loudpkrs_dirs_deg[i][1]); 
     if(sum_elev < 0.01f)
-        pData->output_nDims = 2;
+        state->output_nDims = 2;
     else
-        pData->output_nDims = 3;
+        state->output_nDims = 3;
 #endif
     
     /* generate VBAP gain table */
-    free(pData->vbap_gtable);
-    pData->vbapTableRes[0] = 1;
-    pData->vbapTableRes[1] = 1;
+    free(state->vbap_gtable);
+    state->vbap_gtable = NULL;
+    state->vbapTableRes[0] = 1;
+    state->vbapTableRes[1] = 1;
 #ifdef FORCE_3D_LAYOUT
-    pData->output_nDims = 3;
-    generateVBAPgainTable3D((float*)pData->loudpkrs_dirs_deg, pData->nLoudpkrs, pData->vbapTableRes[0], pData->vbapTableRes[1], 1, 1, pData->spread_deg,
-                            &(pData->vbap_gtable), &(pData->N_vbap_gtable), &(pData->nTriangles));
+    state->output_nDims = 3;
+    generateVBAPgainTable3D((float*)pData->loudpkrs_dirs_deg, state->nLoudpkrs, state->vbapTableRes[0], state->vbapTableRes[1], 1, 1, pData->spread_deg,
+                            &(state->vbap_gtable), &(state->N_vbap_gtable), &(pData->nTriangles));
 #else
-    if(pData->output_nDims==2)
-        generateVBAPgainTable2D((float*)pData->loudpkrs_dirs_deg, pData->nLoudpkrs, pData->vbapTableRes[0],
-                                &(pData->vbap_gtable), &(pData->N_vbap_gtable), &(pData->nTriangles));
+    if(state->output_nDims==2)
+        generateVBAPgainTable2D((float*)pData->loudpkrs_dirs_deg, state->nLoudpkrs, state->vbapTableRes[0],
+                                &(state->vbap_gtable), &(state->N_vbap_gtable), &(pData->nTriangles));
     else{
-        generateVBAPgainTable3D((float*)pData->loudpkrs_dirs_deg, pData->nLoudpkrs, pData->vbapTableRes[0], pData->vbapTableRes[1], 1, 1, pData->spread_deg,
-                                &(pData->vbap_gtable), &(pData->N_vbap_gtable), &(pData->nTriangles));
-        if(pData->vbap_gtable==NULL){
+        generateVBAPgainTable3D((float*)pData->loudpkrs_dirs_deg, state->nLoudpkrs, state->vbapTableRes[0], state->vbapTableRes[1], 1, 1, pData->spread_deg,
+                                &(state->vbap_gtable), &(state->N_vbap_gtable), &(pData->nTriangles));
+        if(state->vbap_gtable==NULL){
             /* if generating vbap gain tabled failed, re-calculate with 2D VBAP */
-            pData->output_nDims = 2;
-            panner_initGainTables(hPan);
+            state->output_nDims = 2;
+            generateVBAPgainTable2D((float*)pData->loudpkrs_dirs_deg, state->nLoudpkrs, state->vbapTableRes[0],
+                                    &(state->vbap_gtable), &(state->N_vbap_gtable), &(pData->nTriangles));
         }
     }
 #endif
+    pData->output_nDims = state->output_nDims;
 }
 
 void panner_initTFT
 (
-    void* const hPan
+    void* const hPan,
+    panner_renderState* const state
 )
 {
     panner_data *pData = (panner_data*)(hPan);
-    
-    if(pData->hSTFT==NULL)
-        afSTFT_create(&(pData->hSTFT), pData->new_nSources, pData->new_nLoudpkrs, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-    else if (pData->new_nSources!=pData->nSources || pData->new_nLoudpkrs!=pData->nLoudpkrs){
-        afSTFT_channelChange(pData->hSTFT, pData->new_nSources, pData->new_nLoudpkrs);
-        afSTFT_clearBuffers(pData->hSTFT); 
+    panner_renderState* live = pData->liveState;
+    int nSources = pData->new_nSources;
+    int nLoudpkrs = pData->new_nLoudpkrs;
+
+    /* If the number of channels is unchanged, then the filterbank currently in use is passed on to the new render state,
+     * so that its buffered signals carry over and the audio continues seamlessly */
+    if(live!=NULL && live->nSources == nSources && live->nLoudpkrs == nLoudpkrs){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        state->hSTFT = live->hSTFT;
+    }
+    else if(state->hSTFT==NULL)
+        afSTFT_create(&(state->hSTFT), nSources, nLoudpkrs, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    else {
+        if(state->nSources != nSources || state->nLoudpkrs != nLoudpkrs) /* Change the number of channels */
+            afSTFT_channelChange(state->hSTFT, nSources, nLoudpkrs);
+        afSTFT_clearBuffers(state->hSTFT); /* (the spare state still holds the signals from when it was last used) */
     }
-    pData->nSources = pData->new_nSources;
-    pData->nLoudpkrs = pData->new_nLoudpkrs;
+    state->nSources = pData->nSources = nSources;
+    state->nLoudpkrs = pData->nLoudpkrs = nLoudpkrs;
 }
 
 void panner_loadSourcePreset
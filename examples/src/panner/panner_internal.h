@@ -67,6 +67,7 @@ extern "C" {
 #define HOP_SIZE ( 128 )                            /**< STFT hop size */
 #define HYBRID_BANDS ( HOP_SIZE + 5 )               /**< Number of frequency bands */
 #define TIME_SLOTS ( PANNER_FRAME_SIZE / HOP_SIZE ) /**< Number of STFT timeslots */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
 
 /* Checks: */
 #if (PANNER_FRAME_SIZE % HOP_SIZE != 0)
@@ -77,6 +78,27 @@ extern "C" {
 /*                                 Structures                                 */
 /* ========================================================================== */
 
+/**
+ * Everything that panner_processFrame() needs from an initialisation
+ *
+ * A new render state is built by panner_initCodec() (while the audio thread
+ * keeps rendering with the current one), and then handed over to the audio
+ * thread via a saf_stateSwap. Once published, only the audio thread may touch
+ * it, until it is handed back by the next initialisation.
+ */
+typedef struct _panner_renderState
+{
+    int nSources;                   /**< Number of inputs/sources */
+    int nLoudpkrs;                  /**< Number of loudspeakers in the array */
+    int output_nDims;               /**< Dimensionality of the loudspeaker array, 2: 2-D, 3: 3-D */
+    void* hSTFT;                    /**< afSTFT handle (passed on to the next render state, if it has the same number of channels) */
+    int vbapTableRes[2];            /**< [0] azimuth, and [1] elevation grid resolution, in degrees */
+    float* vbap_gtable;             /**< VBAP gains; FLAT: N_vbap_gtable x nLoudpkrs */
+    int N_vbap_gtable;              /**< Number of directions in the VBAP gain table */
+    int recalc_gainsFLAG;           /**< 1: the panning gains of all sources are yet to be computed from this render state, 0: they have been */
+
+} panner_renderState;
+
 /**
  * Main structure for panner. Contains variables for audio buffers, afSTFT,
  * internal variables, flags, user parameters
@@ -84,6 +106,7 @@ extern "C" {
 typedef struct _panner
 {
     /* audio buffers */
+    void* hBlockAdapter;            /**< Block adapter handle (for arbitrary host block sizes) */
     float** inputFrameTD;           /**< Input signals, in the time-domain; #MAX_NUM_INPUTS x #PANNER_FRAME_SIZE */
     float** outputFrameTD;          /**< Output signals, in the time-domain; #MAX_NUM_OUTPUTS x #PANNER_FRAME_SIZE */
     float_complex*** inputframeTF;  /**< Input signals, in the time-frequency domain; #HYBRID_BANDS x #MAX_NUM_INPUTS x #TIME_SLOTS */
@@ -92,29 +115,28 @@ typedef struct _panner
     
     /* time-frequency transform */
     float freqVector[HYBRID_BANDS]; /**< Frequency vector (centre frequencies) */
-    void* hSTFT;                    /**< afSTFT handle */
     
     /* Internal */
-    int vbapTableRes[2];            /**< [0] azimuth, and [1] elevation grid resolution, in degrees */
-    float* vbap_gtable;             /**< Current VBAP gains; FLAT: N_hrtf_vbap_gtable x nLoudpkrs */
-    int N_vbap_gtable;              /**< Number of directions in the VBAP gain table */
+    void* hStateSwap;               /**< saf_stateSwap handle, via which new render states are handed over to the audio thread */
+    panner_renderState* liveState;  /**< The last published render state (or NULL); read-only, until it is handed back */
+    panner_renderState* spareState; /**< The previous render state (or NULL), in which the next one is built */
     float_complex G_src[HYBRID_BANDS][MAX_NUM_INPUTS][MAX_NUM_OUTPUTS];  /**< Current VBAP gains per source */
     
     /* flags */
-    CODEC_STATUS codecStatus;       /**< see #CODEC_STATUS */
-    PROC_STATUS procStatus;         /**< see #PROC_STATUS */
+    volatile long codecStatus;      /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;         /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;           /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;          /**< Current (re)initialisation step, string */
     int recalc_gainsFLAG[MAX_NUM_INPUTS]; /**< 1: VBAP gains need to be recalculated for this source, 0: do not */
     int recalc_M_rotFLAG;           /**< 1: recalculate the rotation matrix, 0: do not */
-    int reInitGainTables;           /**< 1: reinitialise the VBAP gain table, 0: do not */
+    volatile long reInitGainTables; /**< 1: reinitialise the VBAP gain table, 0: do not (only accessed via the saf_atomic functions) */
     
     /* misc. */
     float src_dirs_rot_deg[MAX_NUM_INPUTS][2]; /**< Intermediate rotated source directions, in degrees */
     float src_dirs_rot_xyz[MAX_NUM_INPUTS][3]; /**< Intermediate rotated source directions, as unit-length Cartesian coordinates */
     float src_dirs_xyz[MAX_NUM_INPUTS][3];     /**< Intermediate source directions, as unit-length Cartesian coordinates */
     int nTriangles;                 /**< Number of loudspeaker triangles */
-    int output_nDims;               /**< Dimensionality of the loudspeaker array, 2: 2-D, 3: 3-D */
+    int output_nDims;               /**< Dimensionality of the loudspeaker array of the last built render state, 2: 2-D, 3: 3-D */
     int new_nLoudpkrs;              /**< New number of loudspeakers in the array */
     int new_nSources;               /**< New number of inputs/sources */
     
@@ -122,11 +144,11 @@ typedef struct _panner
     float pValue[HYBRID_BANDS];     /**< Used for the frequency-dependent panning normalisation */
     
     /* user parameters */
-    int nSources;                   /**< Current number of inputs/sources */
+    int nSources;                   /**< Number of inputs/sources of the last built render state */
     float src_dirs_deg[MAX_NUM_INPUTS][2]; /**< Current source directions */
     float DTT;                      /**< Room coefficient [3] */
     float spread_deg;               /**< Source spread/MDAP [2] */
-    int nLoudpkrs;                  /**< Current number of loudspeakers in the array */
+    int nLoudpkrs;                  /**< Number of loudspeakers of the last built render state */
     float loudpkrs_dirs_deg[MAX_NUM_OUTPUTS][2]; /**< Current loudspeaker directions */
     float yaw;                      /**< yaw (Euler) rotation angle, in degrees */
     float roll;                     /**< roll (Euler) rotation angle, in degrees */
@@ -145,19 +167,29 @@ typedef struct _panner
 /** Sets codec status (see #CODEC_STATUS enum) */
 void panner_setCodecStatus(void* const hPan, CODEC_STATUS newStatus);
     
+/** Creates an (empty) render state; see #panner_renderState */
+void panner_createRenderState(panner_renderState** const pState);
+
+/** Destroys a render state (if not NULL) */
+void panner_destroyRenderState(panner_renderState** const pState);
+
 /**
- * Intialises the VBAP gain table used for panning.
+ * Intialises the VBAP gain table used for panning (written to the given render
+ * state).
  *
- * @note Call ambi_dec_initTFT() (if needed) before calling this function
+ * @note Call panner_initTFT() (if needed) before calling this function
  */
-void panner_initGainTables(void* const hPan);
+void panner_initGainTables(void* const hPan,
+                           panner_renderState* const state);
     
 /**
- * Initialise the filterbank used by panner.
+ * Initialise the filterbank of a new render state. If the number of channels
+ * is unchanged, then the filterbank of the current render state is passed on.
  *
  * @note Call this function before panner_initGainTables()
  */
-void panner_initTFT(void* const hPan);
+void panner_initTFT(void* const hPan,
+                    panner_renderState* const state);
     
 /**
  * Loads source directions from preset
@@ -41,7 +41,8 @@ void pitch_shifter_create
     pData->fftsize_option = PITCH_SHIFTER_FFTSIZE_4096;
 
     /* internals */
-    pData->hSmb = NULL;
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
     pData->progressBar0_1 = 0.0f;
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
@@ -50,16 +51,12 @@ void pitch_shifter_create
     pData->stepsize = 1024; /* same here */
 
     /* flags */
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
+    pData->initLock = 0;
 
-    /* set FIFO buffers */
+    /* for passing arbitrary host block sizes through pitch_shifter_processFrame() */
     pData->sampleRate = 48000.0f;
-    pData->FIFO_idx = 0;
-    pData->inFIFO = (float**)calloc2d(MAX_NUM_CHANNELS, PITCH_SHIFTER_FRAME_SIZE, sizeof(float));
-    pData->outFIFO = (float**)calloc2d(MAX_NUM_CHANNELS, PITCH_SHIFTER_FRAME_SIZE, sizeof(float));
-    //memset(FLATTEN2D(pData->inFIFO), 0, MAX_NUM_CHANNELS*PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
-    //memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
+    saf_blockAdapter_create(&(pData->hBlockAdapter), PITCH_SHIFTER_FRAME_SIZE, MAX_NUM_CHANNELS, MAX_NUM_CHANNELS);
 }
 
 void pitch_shifter_destroy
@@ -68,18 +65,20 @@ void pitch_shifter_destroy
 )
 {
     pitch_shifter_data *pData = (pitch_shifter_data*)(*phPS);
+    pitch_shifter_renderState* state;
 
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
-
-        if (pData->hSmb != NULL)
-            smb_pitchShift_destroy(&(pData->hSmb));
-        free(pData->inFIFO);
-        free(pData->outFIFO);
+        /* Wait for any on-going initialisation to complete, and then take back the current render state (which also
+         * waits for the audio thread to let go of it) */
+        saf_spinLock_lock(&(pData->initLock));
+        state = (pitch_shifter_renderState*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(state==pData->liveState, "Unexpected render state");
+        pitch_shifter_destroyRenderState(&state);
+        pitch_shifter_destroyRenderState(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
+
+        free(pData->progressBarText);
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phPS = NULL;
@@ -89,7 +88,8 @@ void pitch_shifter_destroy
 void pitch_shifter_init
 (
     void * const hPS,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     pitch_shifter_data *pData = (pitch_shifter_data*)(hPS);
@@ -98,6 +98,7 @@ void pitch_shifter_init
         pData->sampleRate = (float)sampleRate;
         pitch_shifter_setCodecStatus(hPS, CODEC_STATUS_NOT_INITIALISED);
     } 
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
 void pitch_shifter_initCodec
@@ -106,26 +107,29 @@ void pitch_shifter_initCodec
 )
 {
     pitch_shifter_data *pData = (pitch_shifter_data*)(hPS);
+    pitch_shifter_renderState* state;
     int nChannels, fftSize, osamp;
 
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
 
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Initialising pitch shifter");
     pData->progressBar0_1 = 0.0f;
 
     nChannels = pData->new_nChannels;
 
-    /* destroy current handle*/
-    if (pData->hSmb != NULL)
-        smb_pitchShift_destroy(&(pData->hSmb));
+    /* The new render state is built in the spare one, while the audio thread keeps rendering with the current one */
+    if(pData->spareState==NULL)
+        pitch_shifter_createRenderState(&(pData->spareState));
+    state = pData->spareState;
+    if (state->hSmb != NULL)
+        smb_pitchShift_destroy(&(state->hSmb));
 
     /* Config */
     switch(pData->osamp_option){
@@ -151,16 +155,23 @@ void pitch_shifter_initCodec
     pData->stepsize = fftSize/osamp;
 
     /* Create new handle */
-    smb_pitchShift_create(&(pData->hSmb), nChannels, fftSize, osamp, pData->sampleRate);
-    pData->nChannels = nChannels;
+    smb_pitchShift_create(&(state->hSmb), nChannels, fftSize, osamp, pData->sampleRate);
+    state->nChannels = pData->nChannels = nChannels;
 
-    /* done! */
+    /* Hand the new render state over to the audio thread, and keep the previous one as the spare, once it is no longer
+     * being used */
+    pData->spareState = (pitch_shifter_renderState*)saf_stateSwap_publish(pData->hStateSwap, (void*)state);
+    pData->liveState = state;
+
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
-void pitch_shifter_process
+/** Processes one frame of #PITCH_SHIFTER_FRAME_SIZE samples (see pitch_shifter_process()) */
+static void pitch_shifter_processFrame
 (
     void        *  const hPS,
     const float *const * inputs,
@@ -171,50 +182,53 @@ void pitch_shifter_process
 )
 {
     pitch_shifter_data *pData = (pitch_shifter_data*)(hPS);
-    int s, ch, nChannels;
-    nChannels = pData->nChannels;
+    pitch_shifter_renderState* state;
+    int ch, nChannels;
+    SAF_UNUSED(nSamples);
+
+    /* The current render state remains valid (and untouched by pitch_shifter_initCodec()) until it is released */
+    state = (pitch_shifter_renderState*)saf_stateSwap_acquire(pData->hStateSwap);
+    nChannels = state!=NULL ? state->nChannels : 0;
 
-    /* Loop over all samples */
-    for(s=0; s<nSamples; s++){
-        /* Load input signals into inFIFO buffer */
+    /* Process frame if codec is ready for it */
+    if (state!=NULL) {
+        /* load input */
         for(ch=0; ch<SAF_MIN(nInputs,nChannels); ch++)
-            pData->inFIFO[ch][pData->FIFO_idx] = inputs[ch][s];
+            memcpy(pData->inputFrame[ch], inputs[ch], PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
         for(; ch<nChannels; ch++) /* Zero any channels that were not given */
-            pData->inFIFO[ch][pData->FIFO_idx] = 0.0f;
+            memset(pData->inputFrame[ch], 0, PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
 
-        /* Pull output signals from outFIFO buffer */
-        for(ch=0; ch<SAF_MIN(nOutputs, nChannels); ch++)
-            outputs[ch][s] = pData->outFIFO[ch][pData->FIFO_idx];
+        /* Apply pitch shifting */
+        smb_pitchShift_apply(state->hSmb, pData->pitchShift_factor, PITCH_SHIFTER_FRAME_SIZE, (float*)pData->inputFrame, (float*)pData->outputFrame);
+
+        /* Copy to output */
+        for(ch=0; ch<SAF_MIN(nOutputs,nChannels); ch++)
+            memcpy(outputs[ch], pData->outputFrame[ch], PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
         for(; ch<nOutputs; ch++) /* Zero any extra channels */
-            outputs[ch][s] = 0.0f;
-
-        /* Increment buffer index */
-        pData->FIFO_idx++;
-
-        /* Process frame if inFIFO is full and codec is ready for it */
-        if (pData->FIFO_idx >= PITCH_SHIFTER_FRAME_SIZE && (pData->codecStatus == CODEC_STATUS_INITIALISED) ) {
-            pData->FIFO_idx = 0;
-            pData->procStatus = PROC_STATUS_ONGOING;
-
-            /* load input */
-            for(ch=0; ch<nChannels; ch++)
-                memcpy(pData->inputFrame[ch], pData->inFIFO[ch], PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
-
-            /* Apply pitch shifting */
-            smb_pitchShift_apply(pData->hSmb, pData->pitchShift_factor, PITCH_SHIFTER_FRAME_SIZE, (float*)pData->inputFrame, (float*)pData->outputFrame);
-
-            /* Copy to output */
-            for(ch=0; ch<nChannels; ch++)
-                memcpy(pData->outFIFO[ch], pData->outputFrame[ch], PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
-        }
-        else if(pData->FIFO_idx >= PITCH_SHIFTER_FRAME_SIZE){
-            /* clear outFIFO if codec was not ready */
-            pData->FIFO_idx = 0;
-            memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
-        }
+            memset(outputs[ch], 0, PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
+    }
+    else{
+        for(ch=0; ch<nOutputs; ch++)
+            memset(outputs[ch], 0, PITCH_SHIFTER_FRAME_SIZE*sizeof(float));
     }
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void pitch_shifter_process
+(
+    void        *  const hPS,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    pitch_shifter_data *pData = (pitch_shifter_data*)(hPS);
+
+    /* Process the host buffers in frames of #PITCH_SHIFTER_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, pitch_shifter_processFrame, hPS);
 }
 
 /* sets */
@@ -270,7 +284,7 @@ int pitch_shifter_getFrameSize(void)
 CODEC_STATUS pitch_shifter_getCodecStatus(void* const hBin)
 {
     pitch_shifter_data *pData = (pitch_shifter_data*)(hBin);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float pitch_shifter_getProgressBar0_1(void* const hBin)
@@ -312,6 +326,6 @@ int pitch_shifter_getNCHrequired(void* const hPS)
 int pitch_shifter_getProcessingDelay(void* const hPS)
 {
     pitch_shifter_data *pData = (pitch_shifter_data*)(hPS);
-    return PITCH_SHIFTER_FRAME_SIZE + pData->fftFrameSize - (pData->stepsize);
+    return pData->fftFrameSize - (pData->stepsize) + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
 
@@ -29,11 +29,30 @@
 void pitch_shifter_setCodecStatus(void* const hPS, CODEC_STATUS newStatus)
 {
     pitch_shifter_data *pData = (pitch_shifter_data*)(hPS);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next pitch_shifter_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void pitch_shifter_createRenderState(pitch_shifter_renderState** const pState)
+{
+    pitch_shifter_renderState* state = (pitch_shifter_renderState*)malloc1d(sizeof(pitch_shifter_renderState));
+    *pState = state;
+
+    state->nChannels = 0;
+    state->hSmb = NULL;
+}
+
+void pitch_shifter_destroyRenderState(pitch_shifter_renderState** const pState)
+{
+    pitch_shifter_renderState* state = *pState;
+
+    if(state!=NULL){
+        if(state->hSmb!=NULL)
+            smb_pitchShift_destroy(&(state->hSmb));
+        free(state);
+        state = NULL;
+        *pState = NULL;
     }
-    pData->codecStatus = newStatus;
 }
 
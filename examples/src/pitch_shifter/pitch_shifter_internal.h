@@ -50,20 +50,35 @@ extern "C" {
 /*                                 Structures                                 */
 /* ========================================================================== */
 
+/**
+ * Everything that pitch_shifter_process() needs from an initialisation
+ *
+ * A new render state is built by pitch_shifter_initCodec() (while the audio
+ * thread keeps rendering with the current one), and then handed over to the
+ * audio thread via a saf_stateSwap. Once published, only the audio thread may
+ * touch it, until it is handed back by the next initialisation.
+ */
+typedef struct _pitch_shifter_renderState
+{
+    int nChannels;                  /**< Number of input/output channels */
+    void* hSmb;                     /**< pitch-shifter handle */
+
+}pitch_shifter_renderState;
+
 /** Main struct for the pitch_shifter */
 typedef struct _pitch_shifter
 {
-    /* FIFO buffers */
-    int FIFO_idx;                   /**< FIFO buffer index */
-    float** inFIFO;                 /**< Input FIFO buffer */
-    float** outFIFO;                /**< Output FIFO buffer */
+    /* Block adapter */
+    void* hBlockAdapter;            /**< Block adapter handle (for arbitrary host block sizes) */
 
     /* internal */
-    void* hSmb;                     /**< pitch-shifter handle */
-    CODEC_STATUS codecStatus;       /**< see #CODEC_STATUS */
+    volatile long codecStatus;      /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;         /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;           /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;          /**< Current (re)initialisation step, string */
-    PROC_STATUS procStatus;         /**< see #PROC_STATUS */
+    void* hStateSwap;               /**< saf_stateSwap handle, via which new render states are handed over to the audio thread */
+    pitch_shifter_renderState* liveState;  /**< The last published render state (or NULL); read-only, until it is handed back */
+    pitch_shifter_renderState* spareState; /**< The previous render state (or NULL), in which the next one is built */
     float sampleRate;               /**< Host sampling rate, in Hz */
     float inputFrame[MAX_NUM_CHANNELS][PITCH_SHIFTER_FRAME_SIZE];  /**< Current input frame */
     float outputFrame[MAX_NUM_CHANNELS][PITCH_SHIFTER_FRAME_SIZE]; /**< Current output frame */
@@ -72,7 +87,7 @@ typedef struct _pitch_shifter
     int stepsize;                   /**< Hop size in samples*/
 
     /* user parameters */
-    int nChannels;                  /**< Current number of input/output channels */
+    int nChannels;                  /**< Number of input/output channels of the last built render state */
     float pitchShift_factor;        /**< 1: no shift, 0.5: down one octave, 2: up one octave */
     PITCH_SHIFTER_FFTSIZE_OPTIONS fftsize_option; /**< see #PITCH_SHIFTER_FFTSIZE_OPTIONS */
     PITCH_SHIFTER_OSAMP_OPTIONS osamp_option;     /**< see #PITCH_SHIFTER_OSAMP_OPTIONS */
@@ -87,6 +102,12 @@ typedef struct _pitch_shifter
 /** Sets codec status (see #CODEC_STATUS enum) */
 void pitch_shifter_setCodecStatus(void* const hPS,
                                   CODEC_STATUS newStatus);
+
+/** Creates an (empty) render state; see #pitch_shifter_renderState */
+void pitch_shifter_createRenderState(pitch_shifter_renderState** const pState);
+
+/** Destroys a render state (if not NULL) */
+void pitch_shifter_destroyRenderState(pitch_shifter_renderState** const pState);
     
     
 #ifdef __cplusplus
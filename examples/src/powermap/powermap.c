@@ -39,7 +39,7 @@ void powermap_create
 {
     powermap_data* pData = (powermap_data*)malloc1d(sizeof(powermap_data));
     *phPm = (void*)pData;
-    int n, i, band;
+    int band;
 
     /* Default user parameters */
     pData->masterOrder = pData->new_masterOrder = SH_ORDER_FIRST;
@@ -56,40 +56,34 @@ void powermap_create
     pData->chOrdering = CH_ACN;
     pData->norm = NORM_SN3D;
     
-    afSTFT_create(&(pData->hSTFT), MAX_NUM_SH_SIGNALS, 0, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-    pData->SHframeTD = (float**)malloc2d(MAX_NUM_SH_SIGNALS, POWERMAP_FRAME_SIZE, sizeof(float));
-    pData->SHframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
-
-    /* codec data */
-    pData->pars = (powermap_codecPars*)malloc1d(sizeof(powermap_codecPars));
-    powermap_codecPars* pars = pData->pars;
-    pars->interp_dirs_deg = NULL;
-    for(n=0; n<MAX_SH_ORDER; n++){
-        pars->Y_grid[n] = NULL;
-        pars->Y_grid_cmplx[n] = NULL;
-    }
-    pars->interp_table = NULL;
+    pData->SHframeTD = (float**)calloc2d_aligned(MAX_NUM_SH_SIGNALS, POWERMAP_FRAME_SIZE, sizeof(float));
+    pData->SHframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
+
+    /* codec data (built by powermap_initCodec()) */
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
     
     /* internal */
     pData->progressBar0_1 = 0.0f;
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    pData->initLock = 0;
+    pData->resetAvgFLAG = 0;
+    pData->Cx_nSH = 0;
     pData->dispWidth = 140;
+    pData->nThreads = pData->new_nThreads = 1;
+    pData->hThreadPool = NULL;
 
     /* display */
-    pData->pmap = NULL;
-    pData->prev_pmap = NULL;
-    for(i=0; i<NUM_DISP_SLOTS; i++)
-        pData->pmap_grid[i] = NULL;
+    pData->dispSlotIdx = 0;
     pData->pmapReady = 0;
     pData->recalcPmap = 1;
 
-    /* set FIFO buffer */
+    /* for passing arbitrary host block sizes through powermap_analysisFrame() */
     pData->fs = 48000.0f;
-    pData->FIFO_idx = 0;
-    memset(pData->inFIFO, 0, MAX_NUM_SH_SIGNALS*POWERMAP_FRAME_SIZE*sizeof(float));
+    pData->isPlaying = 0;
+    saf_blockAdapter_create(&(pData->hBlockAdapter), POWERMAP_FRAME_SIZE, MAX_NUM_SH_SIGNALS, 0);
 }
 
 void powermap_destroy
@@ -99,34 +93,24 @@ void powermap_destroy
 {
     powermap_data *pData = (powermap_data*)(*phPm);
     powermap_codecPars* pars;
-    int i;
     
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
-
-        pars = pData->pars;
-
-        /* free afSTFT and buffers */
-        afSTFT_destroy(&(pData->hSTFT));
-        free(pData->SHframeTD);
-        free(pData->SHframeTF);
-        
-        free(pData->pmap);
-        free(pData->prev_pmap);
-        for(i=0; i<NUM_DISP_SLOTS; i++)
-            free(pData->pmap_grid[i]);
-        free(pars->interp_dirs_deg);
-        for(i=0; i<MAX_SH_ORDER; i++){
-            free(pars->Y_grid[i]);
-            free(pars->Y_grid_cmplx[i]);
-        }
-        free(pars->interp_table);
-        free(pData->pars);
+        /* Wait for any on-going initialisation to complete, and then take back the current codec parameters (which
+         * also waits for the analysis to let go of them) */
+        saf_spinLock_lock(&(pData->initLock));
+        pars = (powermap_codecPars*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(pars==pData->liveState, "Unexpected codec parameters");
+        powermap_destroyCodecPars(&pars);
+        powermap_destroyCodecPars(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
+
+        /* free buffers */
+        free2d_aligned((void**)pData->SHframeTD);
+        free3d_aligned((void***)pData->SHframeTF);
         free(pData->progressBarText);
+        if(pData->hThreadPool!=NULL)
+            saf_threadPool_destroy(&(pData->hThreadPool));
         free(pData);
         pData = NULL;
         *phPm = NULL;
@@ -140,17 +124,15 @@ void powermap_init
 )
 {
     powermap_data *pData = (powermap_data*)(hPm);
-    powermap_codecPars* pars = pData->pars;
     
     pData->fs = sampleRate;
+    saf_blockAdapter_reset(pData->hBlockAdapter, 0);
     
     /* specify frequency vector and determine the number of bands */
-    afSTFT_getCentreFreqs(pData->hSTFT, sampleRate, HYBRID_BANDS, pData->freqVector);
+    afSTFT_getCentreFreqs(NULL, sampleRate, HYBRID_BANDS, pData->freqVector);
     
-    /* intialise parameters */
-    memset(pData->Cx, 0 , MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS*HYBRID_BANDS*sizeof(float_complex));
-    if(pData->prev_pmap!=NULL)
-        memset(pData->prev_pmap, 0, pars->grid_nDirs*sizeof(float));
+    /* intialise parameters (the temporal averaging buffers are cleared by the analysis thread) */
+    saf_atomic_store(&(pData->resetAvgFLAG), 1);
     pData->pmapReady = 0;
     pData->dispSlotIdx = 0;
 }
@@ -161,44 +143,110 @@ void powermap_initCodec
 )
 {
     powermap_data *pData = (powermap_data*)(hPm);
+    powermap_codecPars* pars;
+    void* hPrevThreadPool;
     
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
     
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Initialising");
     pData->progressBar0_1 = 0.0f;
+
+    /* The new codec parameters are built in the spare set, while the analysis keeps running with the current one */
+    if(pData->spareState==NULL)
+        powermap_createCodecPars(&(pData->spareState));
+    pars = pData->spareState;
+
+    /* (Re)create the thread pool; the host thread is one of the threads (the previous pool is only destroyed once the
+     * analysis thread has switched over to the new codec parameters) */
+    hPrevThreadPool = NULL;
+    if(pData->new_nThreads != pData->nThreads){
+        hPrevThreadPool = pData->hThreadPool;
+        pData->hThreadPool = NULL;
+        if(pData->new_nThreads>1)
+            saf_threadPool_create(&(pData->hThreadPool), pData->new_nThreads-1);
+        pData->nThreads = pData->new_nThreads;
+    }
+    pars->hThreadPool = pData->hThreadPool;
     
-    powermap_initTFT(hPm);
-    powermap_initAna(hPm);
+    powermap_initTFT(hPm, pars);
+    powermap_initAna(hPm, pars);
+
+    /* Hand the new codec parameters over to the analysis thread, and keep the previous ones as the spare set, once
+     * they are no longer being used */
+    pData->spareState = (powermap_codecPars*)saf_stateSwap_publish(pData->hStateSwap, (void*)pars);
+    pData->liveState = pars;
+    if(pData->spareState!=NULL && pData->spareState->hSTFT == pars->hSTFT)
+        pData->spareState->hSTFT = NULL; /* (passed on to the new codec parameters) */
+    if(hPrevThreadPool!=NULL)
+        saf_threadPool_destroy(&hPrevThreadPool);
+    pData->masterOrder = pars->masterOrder;
     
-    /* done! */
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
-void powermap_analysis
+/** Arguments for powermap_updateCovBands() */
+typedef struct _powermap_covArgs {
+    powermap_data* pData;
+    int nSH;
+    float covAvgCoeff;
+} powermap_covArgs;
+
+/**
+ * Updates the (time-averaged) covariance matrices of frequency bands
+ * start..end-1 (see saf_threadPool_parallelFor())
+ */
+static void powermap_updateCovBands
+(
+    void* arg,
+    int start,
+    int end
+)
+{
+    powermap_covArgs* a = (powermap_covArgs*)arg;
+    powermap_data *pData = a->pData;
+    int band;
+    const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
+    float_complex new_Cx[MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS];
+
+    for(band=start; band<end; band++){
+        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, a->nSH, a->nSH, TIME_SLOTS, &calpha,
+                    FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS_STRIDE,
+                    FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS_STRIDE, &cbeta,
+                    new_Cx, a->nSH);
+
+        /* average over time */
+        cblas_sscal(a->nSH*a->nSH*2, a->covAvgCoeff, (float*)pData->Cx[band], 1);
+        cblas_saxpy(a->nSH*a->nSH*2, 1.0f-a->covAvgCoeff, (float*)new_Cx, 1, (float*)pData->Cx[band], 1);
+    }
+}
+
+/** Analyses one frame of #POWERMAP_FRAME_SIZE samples (see powermap_analysis()) */
+static void powermap_analysisFrame
 (
     void        *  const hPm,
     const float *const * inputs,
+    float* const*  const outputs,
     int                  nInputs,
-    int                  nSamples,
-    int                  isPlaying
+    int                  nOutputs,
+    int                  nSamples
 )
 {
     powermap_data *pData = (powermap_data*)(hPm);
-    powermap_codecPars* pars = pData->pars;
-    int s, i, j, ch, band, nSH_order, order_band, nSH_maxOrder, maxOrder;
+    powermap_codecPars* pars;
+    int i, j, ch, band, nSH_order, order_band, nSH_maxOrder, maxOrder;
     float C_grp_trace, pmapEQ_band;
-    const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
-    float_complex new_Cx[MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS];
+    powermap_covArgs covArgs;
     float_complex C_grp[MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS];
     
     /* local parameters */
@@ -217,168 +265,174 @@ void powermap_analysis
     covAvgCoeff = SAF_MIN(pData->covAvgCoeff, MAX_COV_AVG_COEFF);
     pmapAvgCoeff = pData->pmapAvgCoeff;
     pmap_mode = pData->pmap_mode;
-    masterOrder = pData->masterOrder;
+    SAF_UNUSED(outputs);
+    SAF_UNUSED(nOutputs);
+    SAF_UNUSED(nSamples);
+
+    /* The codec parameters may only be swapped between calls */
+    pars = (powermap_codecPars*)saf_stateSwap_acquire(pData->hStateSwap);
+    masterOrder = pars!=NULL ? pars->masterOrder : SH_ORDER_FIRST;
     nSH = (masterOrder+1)*(masterOrder+1);
 
-    /* Loop over all samples */
-    for(s=0; s<nSamples; s++){
-        /* Load input signals into inFIFO buffer */
+    /* Clear the temporal averaging buffers, if requested (or if the number of channels has changed) */
+    if(pars!=NULL && (saf_atomic_compareExchange(&(pData->resetAvgFLAG), 1, 0) || pData->Cx_nSH != nSH)){
+        memset(pData->Cx, 0 , MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS*HYBRID_BANDS*sizeof(float_complex));
+        memset(pars->prev_pmap, 0, pars->grid_nDirs*sizeof(float));
+        pData->Cx_nSH = nSH;
+    }
+
+    /* Process frame if the codec is ready for it */
+    if (pars!=NULL && pData->isPlaying) {
+        /* Load time-domain data */
         for(ch=0; ch<SAF_MIN(nInputs,nSH); ch++)
-            pData->inFIFO[ch][pData->FIFO_idx] = inputs[ch][s];
+            memcpy(pData->SHframeTD[ch], inputs[ch], POWERMAP_FRAME_SIZE*sizeof(float));
         for(; ch<nSH; ch++) /* Zero any channels that were not given */
-            pData->inFIFO[ch][pData->FIFO_idx] = 0.0f;
-
-        /* Increment buffer index */
-        pData->FIFO_idx++;
-
-        /* Process frame if inFIFO is full and codec is ready for it */
-        if (pData->FIFO_idx >= POWERMAP_FRAME_SIZE && (pData->codecStatus == CODEC_STATUS_INITIALISED) && isPlaying ) {
-            pData->FIFO_idx = 0;
-            pData->procStatus = PROC_STATUS_ONGOING;
+            memset(pData->SHframeTD[ch], 0, POWERMAP_FRAME_SIZE*sizeof(float));
 
-            /* Load time-domain data */
-            for(ch=0; ch<nSH; ch++)
-                memcpy(pData->SHframeTD[ch], pData->inFIFO[ch], POWERMAP_FRAME_SIZE*sizeof(float));
+        /* account for input channel order */
+        switch(chOrdering){
+            case CH_ACN:  /* already ACN */ break; /* Otherwise, convert to ACN... */
+            case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHframeTD), masterOrder, POWERMAP_FRAME_STRIDE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
+        }
 
-            /* account for input channel order */
-            switch(chOrdering){
-                case CH_ACN:  /* already ACN */ break; /* Otherwise, convert to ACN... */
-                case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHframeTD), masterOrder, POWERMAP_FRAME_SIZE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
-            }
+        /* account for input normalisation scheme */
+        switch(norm){
+            case NORM_N3D:  /* already in N3D, do nothing */ break; /* Otherwise, convert to N3D... */
+            case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), masterOrder, POWERMAP_FRAME_STRIDE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
+            case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), masterOrder, POWERMAP_FRAME_STRIDE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
+        }
 
-            /* account for input normalisation scheme */
-            switch(norm){
-                case NORM_N3D:  /* already in N3D, do nothing */ break; /* Otherwise, convert to N3D... */
-                case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), masterOrder, POWERMAP_FRAME_SIZE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
-                case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), masterOrder, POWERMAP_FRAME_SIZE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
+        /* apply the time-frequency transform */
+        afSTFT_forward_knownDimensions(pars->hSTFT, pData->SHframeTD, POWERMAP_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS_STRIDE, pData->SHframeTF);
+
+        /* Update covarience matrix per band (with the bands split across the thread pool) */
+        covArgs.pData = pData;
+        covArgs.nSH = nSH;
+        covArgs.covAvgCoeff = covAvgCoeff;
+        saf_threadPool_parallelFor(pars->hThreadPool, HYBRID_BANDS, powermap_updateCovBands, (void*)&covArgs);
+
+        /* update the powermap */
+        if(pData->recalcPmap==1){
+            pData->recalcPmap = 0;
+            pData->pmapReady = 0;
+
+            /* determine maximum analysis order */
+            maxOrder = 1;
+            for(i=0; i<HYBRID_BANDS; i++)
+                maxOrder = SAF_MAX(maxOrder, SAF_MIN(analysisOrderPerBand[i], masterOrder));
+            nSH_maxOrder = (maxOrder+1)*(maxOrder+1);
+
+            /* group covarience matrices */
+            memset(C_grp, 0, nSH_maxOrder*nSH_maxOrder*sizeof(float_complex));
+            for (band=0; band<HYBRID_BANDS; band++){
+                order_band = SAF_MAX(SAF_MIN(pData->analysisOrderPerBand[band], masterOrder),1);
+                nSH_order = (order_band+1)*(order_band+1);
+                pmapEQ_band = SAF_MIN(SAF_MAX(pmapEQ[band], 0.0f), 2.0f);
+                for(i=0; i<nSH_order; i++)
+                    for(j=0; j<nSH_order; j++)
+                        C_grp[i*nSH_maxOrder+j] = ccaddf(C_grp[i*nSH_maxOrder+j], crmulf(pData->Cx[band][i*nSH+j], 1e3f*pmapEQ_band));
             }
 
-            /* apply the time-frequency transform */
-            afSTFT_forward_knownDimensions(pData->hSTFT, pData->SHframeTD, POWERMAP_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS, pData->SHframeTF);
-
-            /* Update covarience matrix per band */
-            for(band=0; band<HYBRID_BANDS; band++){
-                cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, nSH, nSH, TIME_SLOTS, &calpha,
-                            FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS,
-                            FLATTEN2D(pData->SHframeTF[band]), TIME_SLOTS, &cbeta,
-                            new_Cx, nSH);
-
-                /* average over time */
-                cblas_sscal(nSH*nSH*2, covAvgCoeff, (float*)pData->Cx[band], 1);
-                cblas_saxpy(nSH*nSH*2, 1.0f-covAvgCoeff, (float*)new_Cx, 1, (float*)pData->Cx[band], 1);
+            /* generate powermap */
+            C_grp_trace = 0.0f;
+            for(i=0; i<nSH_maxOrder; i++)
+                C_grp_trace+=crealf(C_grp[i*nSH_maxOrder+ i]);
+            switch(pmap_mode){
+                default:
+                case PM_MODE_PWD:
+                    generatePWDmap(pars->hMapWork, maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], pars->grid_nDirs, pars->pmap);
+                    break;
+
+                case PM_MODE_MVDR:
+                    if(C_grp_trace>1e-8f)
+                        generateMVDRmap(pars->hMapWork, maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], pars->grid_nDirs, 8.0f, pars->pmap, NULL);
+                    else
+                        memset(pars->pmap, 0, pars->grid_nDirs*sizeof(float));
+                    break;
+
+                case PM_MODE_CROPAC_LCMV:
+                    if(C_grp_trace>1e-8f)
+                        generateCroPaCLCMVmap(pars->hMapWork, maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], pars->grid_nDirs, 8.0f, 0.0f, pars->pmap);
+                    else
+                        memset(pars->pmap, 0, pars->grid_nDirs*sizeof(float));
+                    break;
+
+                case PM_MODE_MUSIC:
+                    if(C_grp_trace>1e-8f)
+                        generateMUSICmap(pars->hMapWork, maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], nSources, pars->grid_nDirs, 0, pars->pmap);
+                    else
+                        memset(pars->pmap, 0, pars->grid_nDirs*sizeof(float));
+                    break;
+
+                case PM_MODE_MUSIC_LOG:
+                    if(C_grp_trace>1e-8f)
+                        generateMUSICmap(pars->hMapWork, maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], nSources, pars->grid_nDirs, 1, pars->pmap);
+                    else
+                        memset(pars->pmap, 0, pars->grid_nDirs*sizeof(float));
+                    break;
+
+                case PM_MODE_MINNORM:
+                    if(C_grp_trace>1e-8f)
+                        generateMinNormMap(pars->hMapWork, maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], nSources, pars->grid_nDirs, 0, pars->pmap);
+                    else
+                        memset(pars->pmap, 0, pars->grid_nDirs*sizeof(float));
+                    break;
+
+                case PM_MODE_MINNORM_LOG:
+                    if(C_grp_trace>1e-8f)
+                        generateMinNormMap(pars->hMapWork, maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], nSources, pars->grid_nDirs, 1, pars->pmap);
+                    else
+                        memset(pars->pmap, 0, pars->grid_nDirs*sizeof(float));
+                    break;
             }
 
-            /* update the powermap */
-            if(pData->recalcPmap==1){
-                pData->recalcPmap = 0;
-                pData->pmapReady = 0;
-
-                /* determine maximum analysis order */
-                maxOrder = 1;
-                for(i=0; i<HYBRID_BANDS; i++)
-                    maxOrder = SAF_MAX(maxOrder, SAF_MIN(analysisOrderPerBand[i], masterOrder));
-                nSH_maxOrder = (maxOrder+1)*(maxOrder+1);
-
-                /* group covarience matrices */
-                memset(C_grp, 0, nSH_maxOrder*nSH_maxOrder*sizeof(float_complex));
-                for (band=0; band<HYBRID_BANDS; band++){
-                    order_band = SAF_MAX(SAF_MIN(pData->analysisOrderPerBand[band], masterOrder),1);
-                    nSH_order = (order_band+1)*(order_band+1);
-                    pmapEQ_band = SAF_MIN(SAF_MAX(pmapEQ[band], 0.0f), 2.0f);
-                    for(i=0; i<nSH_order; i++)
-                        for(j=0; j<nSH_order; j++)
-                            C_grp[i*nSH_maxOrder+j] = ccaddf(C_grp[i*nSH_maxOrder+j], crmulf(pData->Cx[band][i*nSH+j], 1e3f*pmapEQ_band));
-                }
-
-                /* generate powermap */
-                C_grp_trace = 0.0f;
-                for(i=0; i<nSH_maxOrder; i++)
-                    C_grp_trace+=crealf(C_grp[i*nSH_maxOrder+ i]);
-                switch(pmap_mode){
-                    default:
-                    case PM_MODE_PWD:
-                        generatePWDmap(maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], pars->grid_nDirs, pData->pmap);
-                        break;
-
-                    case PM_MODE_MVDR:
-                        if(C_grp_trace>1e-8f)
-                            generateMVDRmap(maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], pars->grid_nDirs, 8.0f, pData->pmap, NULL);
-                        else
-                            memset(pData->pmap, 0, pars->grid_nDirs*sizeof(float));
-                        break;
-
-                    case PM_MODE_CROPAC_LCMV:
-                        if(C_grp_trace>1e-8f)
-                            generateCroPaCLCMVmap(maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], pars->grid_nDirs, 8.0f, 0.0f, pData->pmap);
-                        else
-                            memset(pData->pmap, 0, pars->grid_nDirs*sizeof(float));
-                        break;
-
-                    case PM_MODE_MUSIC:
-                        if(C_grp_trace>1e-8f)
-                            generateMUSICmap(maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], nSources, pars->grid_nDirs, 0, pData->pmap);
-                        else
-                            memset(pData->pmap, 0, pars->grid_nDirs*sizeof(float));
-                        break;
-
-                    case PM_MODE_MUSIC_LOG:
-                        if(C_grp_trace>1e-8f)
-                            generateMUSICmap(maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], nSources, pars->grid_nDirs, 1, pData->pmap);
-                        else
-                            memset(pData->pmap, 0, pars->grid_nDirs*sizeof(float));
-                        break;
-
-                    case PM_MODE_MINNORM:
-                        if(C_grp_trace>1e-8f)
-                            generateMinNormMap(maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], nSources, pars->grid_nDirs, 0, pData->pmap);
-                        else
-                            memset(pData->pmap, 0, pars->grid_nDirs*sizeof(float));
-                        break;
-
-                    case PM_MODE_MINNORM_LOG:
-                        if(C_grp_trace>1e-8f)
-                            generateMinNormMap(maxOrder, (float_complex*)C_grp, pars->Y_grid_cmplx[maxOrder-1], nSources, pars->grid_nDirs, 1, pData->pmap);
-                        else
-                            memset(pData->pmap, 0, pars->grid_nDirs*sizeof(float));
-                        break;
-                }
-
-                /* average powermap over time */
-                for(i=0; i<pars->grid_nDirs; i++)
-                    pData->pmap[i] =  (1.0f-pmapAvgCoeff) * (pData->pmap[i] )+ pmapAvgCoeff * (pData->prev_pmap[i]);
-                utility_svvcopy(pData->pmap, pars->grid_nDirs, pData->prev_pmap);
-
-                /* interpolate powermap */
-                cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->interp_nDirs, 1, pars->grid_nDirs, 1.0f,
-                            pars->interp_table, pars->grid_nDirs,
-                            pData->pmap, 1, 0.0f,
-                            pData->pmap_grid[pData->dispSlotIdx], 1);
-
-                /* ascertain minimum and maximum values for powermap colour scaling */
-                int ind;
-                utility_siminv(pData->pmap_grid[pData->dispSlotIdx], pars->interp_nDirs, &ind);
-                pData->pmap_grid_minVal = pData->pmap_grid[pData->dispSlotIdx][ind];
-                utility_simaxv(pData->pmap_grid[pData->dispSlotIdx], pars->interp_nDirs, &ind);
-                pData->pmap_grid_maxVal = pData->pmap_grid[pData->dispSlotIdx][ind];
-
-                /* normalise the powermap to 0..1 */
-                for(i=0; i<pars->interp_nDirs; i++)
-                    pData->pmap_grid[pData->dispSlotIdx][i] = (pData->pmap_grid[pData->dispSlotIdx][i]-pData->pmap_grid_minVal)/(pData->pmap_grid_maxVal-pData->pmap_grid_minVal+1e-11f);
-
-                /* signify that the powermap in current slot is ready for plotting */
-                pData->dispSlotIdx++;
-                if(pData->dispSlotIdx>=NUM_DISP_SLOTS)
-                    pData->dispSlotIdx = 0;
-                pData->pmapReady = 1;
-            }
-        }
-        else if(pData->FIFO_idx >= POWERMAP_FRAME_SIZE){
-            /* reset FIFO_idx if codec was not ready */
-            pData->FIFO_idx = 0;
+            /* average powermap over time */
+            for(i=0; i<pars->grid_nDirs; i++)
+                pars->pmap[i] =  (1.0f-pmapAvgCoeff) * (pars->pmap[i] )+ pmapAvgCoeff * (pars->prev_pmap[i]);
+            utility_svvcopy(pars->pmap, pars->grid_nDirs, pars->prev_pmap);
+
+            /* interpolate powermap */
+            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pars->interp_nDirs, 1, pars->grid_nDirs, 1.0f,
+                        pars->interp_table, pars->grid_nDirs,
+                        pars->pmap, 1, 0.0f,
+                        pars->pmap_grid[pData->dispSlotIdx], 1);
+
+            /* ascertain minimum and maximum values for powermap colour scaling */
+            int ind;
+            utility_siminv(pars->pmap_grid[pData->dispSlotIdx], pars->interp_nDirs, &ind);
+            pData->pmap_grid_minVal = pars->pmap_grid[pData->dispSlotIdx][ind];
+            utility_simaxv(pars->pmap_grid[pData->dispSlotIdx], pars->interp_nDirs, &ind);
+            pData->pmap_grid_maxVal = pars->pmap_grid[pData->dispSlotIdx][ind];
+
+            /* normalise the powermap to 0..1 */
+            for(i=0; i<pars->interp_nDirs; i++)
+                pars->pmap_grid[pData->dispSlotIdx][i] = (pars->pmap_grid[pData->dispSlotIdx][i]-pData->pmap_grid_minVal)/(pData->pmap_grid_maxVal-pData->pmap_grid_minVal+1e-11f);
+
+            /* signify that the powermap in current slot is ready for plotting */
+            pData->dispSlotIdx++;
+            if(pData->dispSlotIdx>=NUM_DISP_SLOTS)
+                pData->dispSlotIdx = 0;
+            pData->pmapReady = 1;
         }
     }
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void powermap_analysis
+(
+    void        *  const hPm,
+    const float *const * inputs,
+    int                  nInputs,
+    int                  nSamples,
+    int                  isPlaying
+)
+{
+    powermap_data *pData = (powermap_data*)(hPm);
+
+    /* Analyse the host buffers in frames of #POWERMAP_FRAME_SIZE samples */
+    pData->isPlaying = isPlaying;
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, NULL, nInputs, 0, nSamples, powermap_analysisFrame, hPm);
 }
 
 /* SETS */
@@ -391,10 +445,8 @@ void powermap_refreshSettings(void* const hPm)
 void powermap_setPowermapMode(void* const hPm, int newMode)
 {
     powermap_data *pData = (powermap_data*)(hPm);
-    powermap_codecPars* pars = pData->pars;
     pData->pmap_mode = (POWERMAP_MODES)newMode;
-    if(pData->prev_pmap!=NULL)
-        memset(pData->prev_pmap, 0, pars->grid_nDirs*sizeof(float));
+    saf_atomic_store(&(pData->resetAvgFLAG), 1);
 }
 
 void powermap_setMasterOrder(void* const hPm,  int newValue)
@@ -570,6 +622,16 @@ void powermap_requestPmapUpdate(void* const hPm)
     pData->recalcPmap = 1;
 }
 
+void powermap_setNumThreads(void* const hPm, int newValue)
+{
+    powermap_data *pData = (powermap_data*)(hPm);
+    newValue = SAF_CLAMP(newValue, 1, SAF_THREADPOOL_MAX_NUM_FOR_JOBS+1);
+    if(pData->new_nThreads != newValue){
+        pData->new_nThreads = newValue;
+        powermap_setCodecStatus(hPm, CODEC_STATUS_NOT_INITIALISED);
+    }
+}
+
 /* GETS */
 
 int powermap_getFrameSize(void)
@@ -580,7 +642,7 @@ int powermap_getFrameSize(void)
 CODEC_STATUS powermap_getCodecStatus(void* const hPm)
 {
     powermap_data *pData = (powermap_data*)(hPm);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float powermap_getProgressBar0_1(void* const hPm)
@@ -721,10 +783,10 @@ float powermap_getPowermapAvgCoeff(void* const hPm)
 int powermap_getPmap(void* const hPm, float** grid_dirs, float** pmap, int* nDirs,int* pmapWidth, int* hfov, int* aspectRatio) //TODO: hfov and aspectRatio should be float, if 16:9 etc options are added
 {
     powermap_data *pData = (powermap_data*)(hPm);
-    powermap_codecPars* pars = pData->pars;
-    if((pData->codecStatus == CODEC_STATUS_INITIALISED) && pData->pmapReady){
+    powermap_codecPars* pars = pData->liveState;
+    if((saf_atomic_load(&(pData->codecStatus)) == CODEC_STATUS_INITIALISED) && pData->pmapReady){
         (*grid_dirs) = pars->interp_dirs_deg;
-        (*pmap) = pData->pmap_grid[pData->dispSlotIdx-1 < 0 ? NUM_DISP_SLOTS-1 : pData->dispSlotIdx-1];
+        (*pmap) = pars->pmap_grid[pData->dispSlotIdx-1 < 0 ? NUM_DISP_SLOTS-1 : pData->dispSlotIdx-1];
         (*nDirs) = pars->interp_nDirs;
         (*pmapWidth) = pData->dispWidth;
         switch(pData->HFOVoption){
@@ -743,6 +805,12 @@ int powermap_getPmap(void* const hPm, float** grid_dirs, float** pmap, int* nDir
     return pData->pmapReady;
 }
 
+int powermap_getNumThreads(void* const hPm)
+{
+    powermap_data *pData = (powermap_data*)(hPm);
+    return pData->new_nThreads;
+}
+
 int powermap_getProcessingDelay()
 {
     return POWERMAP_FRAME_SIZE + 12*HOP_SIZE;
@@ -35,23 +35,71 @@
 void powermap_setCodecStatus(void* const hPm, CODEC_STATUS newStatus)
 {
     powermap_data *pData = (powermap_data*)(hPm);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next powermap_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void powermap_createCodecPars(powermap_codecPars** const pPars)
+{
+    powermap_codecPars* pars = (powermap_codecPars*)malloc1d(sizeof(powermap_codecPars));
+    int i;
+    *pPars = pars;
+
+    pars->masterOrder = pars->nSH = 0;
+    pars->hSTFT = NULL;
+    pars->hThreadPool = NULL;
+    pars->grid_nDirs = pars->interp_nDirs = 0;
+    pars->interp_dirs_deg = NULL;
+    for(i=0; i<MAX_SH_ORDER; i++){
+        pars->Y_grid[i] = NULL;
+        pars->Y_grid_cmplx[i] = NULL;
     }
-    pData->codecStatus = newStatus;
+    pars->interp_table = NULL;
+    pars->hMapWork = NULL;
+    pars->pmap = NULL;
+    pars->prev_pmap = NULL;
+    for(i=0; i<NUM_DISP_SLOTS; i++)
+        pars->pmap_grid[i] = NULL;
 }
 
-void powermap_initAna(void* const hPm)
+void powermap_destroyCodecPars(powermap_codecPars** const pPars)
+{
+    powermap_codecPars* pars = *pPars;
+    int i;
+
+    if(pars!=NULL){
+        if(pars->hSTFT!=NULL)
+            afSTFT_destroy(&(pars->hSTFT));
+        free(pars->interp_dirs_deg);
+        for(i=0; i<MAX_SH_ORDER; i++){
+            free(pars->Y_grid[i]);
+            free(pars->Y_grid_cmplx[i]);
+        }
+        free(pars->interp_table);
+        generateMap_destroy(&(pars->hMapWork));
+        free(pars->pmap);
+        free(pars->prev_pmap);
+        for(i=0; i<NUM_DISP_SLOTS; i++)
+            free(pars->pmap_grid[i]);
+        free(pars);
+        pars = NULL;
+        *pPars = NULL;
+    }
+}
+
+void powermap_initAna
+(
+    void* const hPm,
+    powermap_codecPars* const pars
+)
 {
     powermap_data *pData = (powermap_data*)(hPm);
-    powermap_codecPars* pars = pData->pars;
     int i, j, n, N_azi, N_ele, nSH_order, order;
     float scaleY, hfov, vfov, fi, aspectRatio;
     float* Y_grid_N, *grid_x_axis, *grid_y_axis;
     
-    order = pData->new_masterOrder;
+    order = pars->masterOrder;
     
     /* Store Y_grid per order */
     int geosphere_ico_freq = 9;
@@ -73,6 +121,10 @@ void powermap_initAna(void* const hPm)
                 pars->Y_grid_cmplx[n-1][i*(pars->grid_nDirs)+j] = cmplxf(pars->Y_grid[n-1][i*(pars->grid_nDirs)+j], 0.0f);
     }
 
+    /* Pre-allocate the map generators, so that they do not allocate memory during processing */
+    generateMap_destroy(&(pars->hMapWork));
+    generateMap_create(&(pars->hMapWork), order, pars->grid_nDirs);
+
     /* generate interpolation table for current display settings */
     switch(pData->HFOVoption){
         default:
@@ -104,17 +156,15 @@ void powermap_initAna(void* const hPm)
     VBAPgainTable2InterpTable(pars->interp_table, pars->interp_nDirs, pars->grid_nDirs);
     
     /* reallocate memory for storing the powermaps */
-    free(pData->pmap);
-    pData->pmap = malloc1d(pars->grid_nDirs*sizeof(float));
-    free(pData->prev_pmap);
-    pData->prev_pmap = calloc1d(pars->grid_nDirs, sizeof(float));
+    free(pars->pmap);
+    pars->pmap = malloc1d(pars->grid_nDirs*sizeof(float));
+    free(pars->prev_pmap);
+    pars->prev_pmap = calloc1d(pars->grid_nDirs, sizeof(float));
     for(i=0; i<NUM_DISP_SLOTS; i++){
-        free(pData->pmap_grid[i]);
-        pData->pmap_grid[i] = calloc1d(pars->interp_nDirs,sizeof(float));
+        free(pars->pmap_grid[i]);
+        pars->pmap_grid[i] = calloc1d(pars->interp_nDirs,sizeof(float));
     }
     
-    pData->masterOrder = order;
-    
     free(Y_grid_N);
     free(grid_x_axis);
     free(grid_y_axis);
@@ -122,19 +172,30 @@ void powermap_initAna(void* const hPm)
 
 void powermap_initTFT
 (
-    void* const hPm
+    void* const hPm,
+    powermap_codecPars* const pars
 )
 {
     powermap_data *pData = (powermap_data*)(hPm);
-    int nSH, new_nSH;
+    powermap_codecPars* live = pData->liveState;
+    int order, nSH;
     
-    nSH = (pData->masterOrder+1)*(pData->masterOrder+1);
-    new_nSH = (pData->new_masterOrder+1)*(pData->new_masterOrder+1);
-    if(pData->hSTFT==NULL)
-        afSTFT_create(&(pData->hSTFT), new_nSH, 0, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-    else if(nSH!=new_nSH){
-        afSTFT_channelChange(pData->hSTFT, new_nSH, 0);
-        afSTFT_clearBuffers(pData->hSTFT);
-        memset(pData->Cx, 0 , MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS*HYBRID_BANDS*sizeof(float_complex));
+    /* If the number of channels is unchanged, then the filterbank currently in use is passed on to the new codec
+     * parameters, so that its buffered signals (and the covariance matrices) carry over */
+    order = pData->new_masterOrder;
+    nSH = (order+1)*(order+1);
+    if(live!=NULL && live->nSH == nSH){
+        if(pars->hSTFT!=NULL)
+            afSTFT_destroy(&(pars->hSTFT));
+        pars->hSTFT = live->hSTFT;
+    }
+    else if(pars->hSTFT==NULL)
+        afSTFT_create(&(pars->hSTFT), nSH, 0, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    else {
+        if(pars->nSH != nSH) /* Change the number of channels */
+            afSTFT_channelChange(pars->hSTFT, nSH, 0);
+        afSTFT_clearBuffers(pars->hSTFT); /* (the spare set still holds the signals from when it was last used) */
     }
+    pars->masterOrder = order;
+    pars->nSH = nSH;
 }
@@ -54,6 +54,8 @@ extern "C" {
 #define HOP_SIZE ( 128 )                              /**< STFT hop size */
 #define HYBRID_BANDS ( HOP_SIZE + 5 )                 /**< Number of frequency bands */
 #define TIME_SLOTS ( POWERMAP_FRAME_SIZE / HOP_SIZE ) /**< Number of STFT timeslots */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
+#define POWERMAP_FRAME_STRIDE ( (int)md_alignedStride(POWERMAP_FRAME_SIZE, sizeof(float)) ) /**< Distance between the rows of the time-domain frames (#POWERMAP_FRAME_SIZE, padded to whole cache lines) */
 #define NUM_DISP_SLOTS ( 2 )                          /**< Number of display slots */
 #define MAX_COV_AVG_COEFF ( 0.45f )                   /**< Maximum supported covariance averaging coefficient  */
 
@@ -66,9 +68,21 @@ extern "C" {
 /*                                 Structures                                 */
 /* ========================================================================== */
 
-/** Contains variables for scanning grids, and beamforming */
+/**
+ * Contains variables for scanning grids, and beamforming; i.e. everything that
+ * powermap_analysis() needs from an initialisation
+ *
+ * A new set is built by powermap_initCodec() (while the analysis keeps running
+ * with the current one), and then handed over to the analysis thread via a
+ * saf_stateSwap. Once published, only the analysis thread may touch it, until
+ * it is handed back by the next initialisation.
+ */
 typedef struct _powermap_codecPars
 {
+    int masterOrder;        /**< Maximum/master SH analysis order */
+    int nSH;                /**< Number of SH signals, (masterOrder+1)^2 */
+    void* hSTFT;            /**< afSTFT handle (passed on to the next codec parameters, if they have the same number of channels) */
+    void* hThreadPool;      /**< saf_threadPool handle (owned by powermap_data); NULL if nThreads==1 */
     float* grid_dirs_deg;   /**< Spherical scanning grid directions, in degrees; FLAT: grid_nDirs x 2 */
     int grid_nDirs;         /**< Number of scanning directions */
     float* interp_dirs_deg; /**< 2D rectangular window interpolation directions, in degrees; FLAT: interp_nDirs x 2 */
@@ -77,6 +91,12 @@ typedef struct _powermap_codecPars
     int interp_nTri;        /**< Number of triangles in the spherical triangulared grid */
     float* Y_grid[MAX_SH_ORDER];                 /**< real SH basis (real datatype); MAX_NUM_SH_SIGNALS x grid_nDirs */
     float_complex* Y_grid_cmplx[MAX_SH_ORDER];   /**< real SH basis (complex datatype); MAX_NUM_SH_SIGNALS x grid_nDirs */
+    void* hMapWork;         /**< Work handle for the map generators (see generateMap_create()) */
+
+    /* display */
+    float* pmap;            /**< grid_nDirs x 1 */
+    float* prev_pmap;       /**< grid_nDirs x 1 */
+    float* pmap_grid[NUM_DISP_SLOTS]; /**< powermap interpolated to grid; interp_nDirs x 1 */
     
 }powermap_codecPars;
     
@@ -86,33 +106,35 @@ typedef struct _powermap_codecPars
  */
 typedef struct _powermap
 {
-    /* FIFO buffers */
-    int FIFO_idx;                   /**< FIFO buffer index */
-    float inFIFO[MAX_NUM_SH_SIGNALS][POWERMAP_FRAME_SIZE]; /**< Input FIFO buffer */
+    /* Block adapter */
+    void* hBlockAdapter;            /**< Block adapter handle (for arbitrary host block sizes) */
+    int isPlaying;                  /**< Flag passed on to powermap_analysisFrame() */
 
     /* TFT */
     float** SHframeTD;              /**< time-domain SH input frame; #MAX_NUM_SH_SIGNALS x #POWERMAP_FRAME_SIZE */
     float_complex*** SHframeTF;     /**< time-frequency domain SH input frame; #HYBRID_BANDS x #MAX_NUM_SH_SIGNALS x #TIME_SLOTS */
-    void* hSTFT;                    /**< afSTFT handle */
     float freqVector[HYBRID_BANDS]; /**< Frequency vector (filterbank centre frequencies) */
     float fs;                       /**< Host sample rate, in Hz*/
     
     /* internal */
     float_complex Cx[HYBRID_BANDS][MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS];     /**< covariance matrices per band */
+    int Cx_nSH;                     /**< Number of channels of the covariance matrices (only accessed by the analysis thread) */
     int new_masterOrder;            /**< New maximum/master SH analysis order (current value will be replaced by this after next re-init) */
+    int new_nThreads;               /**< New number of threads (current value will be replaced by this after next re-init) */
+    void* hThreadPool;              /**< saf_threadPool handle, across which the covariance matrices are computed (NULL if nThreads==1) */
+    volatile long resetAvgFLAG;     /**< 1: the analysis thread clears its temporal averaging buffers (only accessed via the saf_atomic functions) */
     int dispWidth;                  /**< Number of pixels on the horizontal in the 2D interpolated powermap image */
     
     /* ana configuration */
-    CODEC_STATUS codecStatus;       /**< see #CODEC_STATUS */
-    PROC_STATUS procStatus;         /**< see #PROC_STATUS */
+    volatile long codecStatus;      /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;         /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;           /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;          /**< Current (re)initialisation step, string */
-    powermap_codecPars* pars;       /**< codec parameters */
+    void* hStateSwap;               /**< saf_stateSwap handle, via which new codec parameters are handed over to the analysis thread */
+    powermap_codecPars* liveState;  /**< The last published codec parameters (or NULL); read-only, until they are handed back */
+    powermap_codecPars* spareState; /**< The previous codec parameters (or NULL), in which the next ones are built */
     
     /* display */
-    float* pmap;                    /**< grid_nDirs x 1 */
-    float* prev_pmap;               /**< grid_nDirs x 1 */
-    float* pmap_grid[NUM_DISP_SLOTS]; /**< powermap interpolated to grid; interp_nDirs x 1 */
     int dispSlotIdx;                /**< Current display slot */
     float pmap_grid_minVal;         /**< Current minimum value in pmap (used to normalise [0..1]) */
     float pmap_grid_maxVal;         /**< Current maximum value in pmap (used to normalise [0..1]) */
@@ -120,7 +142,7 @@ typedef struct _powermap
     int pmapReady;                  /**< 0: powermap not started yet, 1: powermap is ready for plotting*/
     
     /* User parameters */
-    int masterOrder;                /**< Current maximum/master SH analysis order */
+    int masterOrder;                /**< Maximum/master SH analysis order of the last built codec parameters */
     int analysisOrderPerBand[HYBRID_BANDS]; /**< SH analysis order per frequency band */
     float pmapEQ[HYBRID_BANDS];     /**< Equalisation/weights per band */
     HFOV_OPTIONS HFOVoption;        /**< see #HFOV_OPTIONS */
@@ -131,6 +153,7 @@ typedef struct _powermap
     POWERMAP_MODES pmap_mode;       /**< see #POWERMAP_MODES*/
     CH_ORDER chOrdering;            /**< Ambisonic channel order convention (see #CH_ORDER) */
     NORM_TYPES norm;                /**< Ambisonic normalisation convention (see #NORM_TYPES) */
+    int nThreads;                   /**< Number of threads computing the covariance matrices (including the host thread) */
     
 } powermap_data;
 
@@ -142,15 +165,27 @@ typedef struct _powermap
 /** Sets codec status (see #CODEC_STATUS enum) */
 void powermap_setCodecStatus(void* const hPm, CODEC_STATUS newStatus);
 
-/** Intialises the codec variables, based on current global/user parameters */
-void powermap_initAna(void* const hPm);
+/** Creates an (empty) set of codec parameters; see #powermap_codecPars */
+void powermap_createCodecPars(powermap_codecPars** const pPars);
+
+/** Destroys a set of codec parameters (if not NULL) */
+void powermap_destroyCodecPars(powermap_codecPars** const pPars);
+
+/**
+ * Intialises the codec variables, based on current global/user parameters
+ * (written to the given set of codec parameters)
+ */
+void powermap_initAna(void* const hPm,
+                      powermap_codecPars* const pars);
 
 /**
- * Initialise the filterbank used by powermap.
+ * Initialise the filterbank of a new set of codec parameters. If the number of
+ * channels is unchanged, then the filterbank currently in use is passed on.
  *
  * @note Call this function before powermap_initAna()
  */
-void powermap_initTFT(void* const hPm);
+void powermap_initTFT(void* const hPm,
+                      powermap_codecPars* const pars);
 
 
 #ifdef __cplusplus
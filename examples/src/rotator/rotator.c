@@ -61,6 +61,9 @@ void rotator_create
     pData->norm = NORM_SN3D;
     pData->useRollPitchYawFlag = 0;
     rotator_setOrder(*phRot, SH_ORDER_FIRST);
+
+    /* for passing arbitrary host block sizes through rotator_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), ROTATOR_FRAME_SIZE, MAX_NUM_SH_SIGNALS, MAX_NUM_SH_SIGNALS);
 }
 
 void rotator_destroy
@@ -71,6 +74,7 @@ void rotator_destroy
     rotator_data *pData = (rotator_data*)(*phRot);
 
     if (pData != NULL) {
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
     }
@@ -79,7 +83,8 @@ void rotator_destroy
 void rotator_init
 (
     void * const hRot,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     rotator_data *pData = (rotator_data*)(hRot);
@@ -96,9 +101,13 @@ void rotator_init
     memset(pData->prev_M_rot, 0, MAX_NUM_SH_SIGNALS*MAX_NUM_SH_SIGNALS*sizeof(float));
     memset(pData->prev_inputFrameTD, 0, MAX_NUM_SH_SIGNALS*ROTATOR_FRAME_SIZE*sizeof(float));
     pData->M_rot_status = M_ROT_RECOMPUTE_EULER;//M_ROT_RECOMPUTE_QUATERNION;
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
-void rotator_process
+/** Processes one frame of #ROTATOR_FRAME_SIZE samples (see rotator_process()) */
+static void rotator_processFrame
 (
     void        *  const hRot,
     const float *const * inputs,
@@ -205,6 +214,22 @@ void rotator_process
     }
 }
 
+void rotator_process
+(
+    void        *  const hRot,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    rotator_data *pData = (rotator_data*)(hRot);
+
+    /* Process the host buffers in frames of #ROTATOR_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, rotator_processFrame, hRot);
+}
+
 
 /*sets*/
 
@@ -431,7 +456,8 @@ int rotator_getNSHrequired(void* const hRot)
     return (pData->inputOrder+1)*(pData->inputOrder+1);
 }
 
-int rotator_getProcessingDelay()
+int rotator_getProcessingDelay(void* const hRot)
 {
-    return ROTATOR_FRAME_SIZE;
+    rotator_data *pData = (rotator_data*)(hRot);
+    return ROTATOR_FRAME_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
@@ -69,6 +69,7 @@ typedef enum {
 typedef struct _rotator
 {
     /* Internal buffers */
+    void* hBlockAdapter;                                                /**< Block adapter handle (for arbitrary host block sizes) */
     float inputFrameTD[MAX_NUM_SH_SIGNALS][ROTATOR_FRAME_SIZE];         /**< Input frame of signals */
     float prev_inputFrameTD[MAX_NUM_SH_SIGNALS][ROTATOR_FRAME_SIZE];    /**< Previous frame of signals */
     float tempFrame[MAX_NUM_SH_SIGNALS][ROTATOR_FRAME_SIZE];            /**< Temporary frame */
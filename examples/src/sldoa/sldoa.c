@@ -68,18 +68,20 @@ void sldoa_create
     pData->norm = NORM_SN3D;
 
     /* TFT */
-    afSTFT_create(&(pData->hSTFT), MAX_NUM_SH_SIGNALS, 0, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-    pData->SHframeTD = (float**)malloc2d(MAX_NUM_SH_SIGNALS, SLDOA_FRAME_SIZE, sizeof(float));
-    pData->SHframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
+    pData->SHframeTD = (float**)calloc2d_aligned(MAX_NUM_SH_SIGNALS, SLDOA_FRAME_SIZE, sizeof(float));
+    pData->SHframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_SH_SIGNALS, TIME_SLOTS, sizeof(float_complex));
 
     /* internal */
     pData->progressBar0_1 = 0.0f;
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
-    for(i=0; i<MAX_SH_ORDER-1; i++)
-        pData->secCoeffs[i] = NULL;
+    pData->initLock = 0;
+    pData->resetAvgFLAG = 0;
+
+    /* codec data (built by sldoa_initCodec()) */
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
 
     /* Grid/basis stuff */
     pData->nGrid = __Tdesign_degree_70_nPoints;
@@ -94,16 +96,17 @@ void sldoa_create
 
     /* display */
     for(i=0; i<NUM_DISP_SLOTS; i++){
-        pData->azi_deg[i] = malloc1d(HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
-        pData->elev_deg[i] = malloc1d(HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
-        pData->colourScale[i] = malloc1d(HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
-        pData->alphaScale[i] = malloc1d(HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
+        pData->azi_deg[i] = calloc1d(HYBRID_BANDS*MAX_NUM_SECTORS, sizeof(float));
+        pData->elev_deg[i] = calloc1d(HYBRID_BANDS*MAX_NUM_SECTORS, sizeof(float));
+        pData->colourScale[i] = calloc1d(HYBRID_BANDS*MAX_NUM_SECTORS, sizeof(float));
+        pData->alphaScale[i] = calloc1d(HYBRID_BANDS*MAX_NUM_SECTORS, sizeof(float));
     }
+    pData->current_disp_idx = 0;
 
-    /* set FIFO buffer */
+    /* for passing arbitrary host block sizes through sldoa_analysisFrame() */
     pData->fs = 48000.0f;
-    pData->FIFO_idx = 0;
-    pData->inFIFO = (float**)calloc2d(MAX_NUM_SH_SIGNALS, SLDOA_FRAME_SIZE, sizeof(float));
+    pData->isPlaying = 0;
+    saf_blockAdapter_create(&(pData->hBlockAdapter), SLDOA_FRAME_SIZE, MAX_NUM_SH_SIGNALS, 0);
 }
 
 void sldoa_destroy
@@ -112,19 +115,23 @@ void sldoa_destroy
 )
 {
     sldoa_data *pData = (sldoa_data*)(*phSld);
+    sldoa_codecPars* pars;
     int i;
 
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
+        /* Wait for any on-going initialisation to complete, and then take back the current codec parameters (which
+         * also waits for the analysis to let go of them) */
+        saf_spinLock_lock(&(pData->initLock));
+        pars = (sldoa_codecPars*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(pars==pData->liveState, "Unexpected codec parameters");
+        sldoa_destroyCodecPars(&pars);
+        sldoa_destroyCodecPars(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         
-        /* free afSTFT and buffers */
-        afSTFT_destroy(&(pData->hSTFT));
-        free(pData->SHframeTD);
-        free(pData->SHframeTF);
+        /* free buffers */
+        free2d_aligned((void**)pData->SHframeTD);
+        free3d_aligned((void***)pData->SHframeTF);
 
         for(i=0; i<NUM_DISP_SLOTS; i++){
             free(pData->azi_deg[i]);
@@ -139,8 +146,6 @@ void sldoa_destroy
         free(pData->grid_Y_dipoles_norm);
         free(pData->grid_dirs_deg);
 
-        free(pData->inFIFO);
-
         free(pData);
         pData = NULL;
         *phSld = NULL;
@@ -154,23 +159,16 @@ void sldoa_init
 )
 {
     sldoa_data *pData = (sldoa_data*)(hSld);
-    int i;
     
     pData->fs = sampleRate;
+    saf_blockAdapter_reset(pData->hBlockAdapter, 0);
     
     /* specify frequency vector and determine the number of bands */
-    afSTFT_getCentreFreqs(pData->hSTFT, sampleRate, HYBRID_BANDS, pData->freqVector);
+    afSTFT_getCentreFreqs(NULL, sampleRate, HYBRID_BANDS, pData->freqVector);
 
-    /* intialise display parameters */
+    /* intialise display parameters (the averaging and display buffers are cleared by the analysis thread) */
     pData->current_disp_idx = 0;
-    memset(pData->doa_rad, 0, HYBRID_BANDS*MAX_NUM_SECTORS*2* sizeof(float));
-    memset(pData->energy, 0, HYBRID_BANDS*MAX_NUM_SECTORS* sizeof(float));
-    for(i=0; i<NUM_DISP_SLOTS; i++){
-        memset(pData->azi_deg[i], 0, HYBRID_BANDS*MAX_NUM_SECTORS* sizeof(float));
-        memset(pData->elev_deg[i], 0, HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
-        memset(pData->colourScale[i], 0, HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
-        memset(pData->alphaScale[i], 0, HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
-    }
+    saf_atomic_store(&(pData->resetAvgFLAG), 1);
 }
 
 void sldoa_initCodec
@@ -179,40 +177,56 @@ void sldoa_initCodec
 )
 {
     sldoa_data *pData = (sldoa_data*)(hSld);
+    sldoa_codecPars* pars;
     
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
     
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Initialising");
     pData->progressBar0_1 = 0.0f;
+
+    /* The new codec parameters are built in the spare set, while the analysis keeps running with the current one */
+    if(pData->spareState==NULL)
+        sldoa_createCodecPars(&(pData->spareState));
+    pars = pData->spareState;
+    sldoa_initTFT(hSld, pars);
+    sldoa_initAna(hSld, pars);
+
+    /* Hand the new codec parameters over to the analysis thread, and keep the previous ones as the spare set, once
+     * they are no longer being used */
+    pData->spareState = (sldoa_codecPars*)saf_stateSwap_publish(pData->hStateSwap, (void*)pars);
+    pData->liveState = pars;
+    if(pData->spareState!=NULL && pData->spareState->hSTFT == pars->hSTFT)
+        pData->spareState->hSTFT = NULL; /* (passed on to the new codec parameters) */
+    pData->masterOrder = pars->masterOrder;
     
-    sldoa_initTFT(hSld);
-    sldoa_initAna(hSld);
-    
-    /* done! */
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
-void sldoa_analysis
+/** Analyses one frame of #SLDOA_FRAME_SIZE samples (see sldoa_analysis()) */
+static void sldoa_analysisFrame
 (
     void        *  const hSld,
     const float *const * inputs,
+    float* const*  const outputs,
     int                  nInputs,
-    int                  nSamples,
-    int                  isPlaying 
+    int                  nOutputs,
+    int                  nSamples
 )
 {
     sldoa_data *pData = (sldoa_data*)(hSld);
-    int s, i, j, t, ch, band, nSectors, min_band, numAnalysisBands, current_disp_idx;
+    sldoa_codecPars* pars;
+    int i, j, t, ch, band, nSectors, min_band, numAnalysisBands, current_disp_idx;
     float avgCoeff, max_en[HYBRID_BANDS], min_en[HYBRID_BANDS];
     float new_doa[MAX_NUM_SECTORS][TIME_SLOTS][2], new_doa_xyz[3], doa_xyz[3], avg_xyz[3];
     float new_energy[MAX_NUM_SECTORS][TIME_SLOTS];
@@ -224,133 +238,155 @@ void sldoa_analysis
     float minFreq, maxFreq, avg_ms;
     CH_ORDER chOrdering;
     NORM_TYPES norm;
-    memcpy(analysisOrderPerBand, pData->analysisOrderPerBand, HYBRID_BANDS*sizeof(int));
-    memcpy(nSectorsPerBand, pData->nSectorsPerBand, HYBRID_BANDS*sizeof(int));
     minFreq = pData->minFreq;
     maxFreq = pData->maxFreq;
     avg_ms = pData->avg_ms;
     chOrdering = pData->chOrdering;
     norm = pData->norm;
-    masterOrder = pData->masterOrder;
+    SAF_UNUSED(outputs);
+    SAF_UNUSED(nOutputs);
+    SAF_UNUSED(nSamples);
+
+    /* The codec parameters may only be swapped between calls */
+    pars = (sldoa_codecPars*)saf_stateSwap_acquire(pData->hStateSwap);
+    masterOrder = pars!=NULL ? pars->masterOrder : SH_ORDER_FIRST;
     nSH = ORDER2NSH(masterOrder);
 
-    /* Loop over all samples */
-    for(s=0; s<nSamples; s++){
-        /* Load input signals into inFIFO buffer */
-        for(ch=0; ch<SAF_MIN(nInputs,nSH); ch++)
-            pData->inFIFO[ch][pData->FIFO_idx] = inputs[ch][s];
-        for(; ch<nSH; ch++) /* Zero any channels that were not given */
-            pData->inFIFO[ch][pData->FIFO_idx] = 0.0f;
+    /* The analysis orders may have been raised for codec parameters that are yet to be built */
+    for(band=0; band<HYBRID_BANDS; band++){
+        analysisOrderPerBand[band] = SAF_MIN(pData->analysisOrderPerBand[band], masterOrder);
+        nSectorsPerBand[band] = SAF_MIN(ORDER2NUMSECTORS(analysisOrderPerBand[band]), MAX_NUM_SECTORS);
+    }
 
-        /* Increment buffer index */
-        pData->FIFO_idx++;
+    /* Clear the temporal averaging and display buffers, if requested */
+    if(saf_atomic_compareExchange(&(pData->resetAvgFLAG), 1, 0)){
+        memset(pData->doa_rad, 0, HYBRID_BANDS*MAX_NUM_SECTORS*2* sizeof(float));
+        memset(pData->energy, 0, HYBRID_BANDS*MAX_NUM_SECTORS* sizeof(float));
+        for(i=0; i<NUM_DISP_SLOTS; i++){
+            memset(pData->azi_deg[i], 0, HYBRID_BANDS*MAX_NUM_SECTORS* sizeof(float));
+            memset(pData->elev_deg[i], 0, HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
+            memset(pData->colourScale[i], 0, HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
+            memset(pData->alphaScale[i], 0, HYBRID_BANDS*MAX_NUM_SECTORS * sizeof(float));
+        }
+    }
 
-        /* Process frame if inFIFO is full and codec is ready for it */
-        if (pData->FIFO_idx >= SLDOA_FRAME_SIZE && (pData->codecStatus == CODEC_STATUS_INITIALISED) && isPlaying) {
-            pData->FIFO_idx = 0;
-            pData->procStatus = PROC_STATUS_ONGOING;
-            current_disp_idx = pData->current_disp_idx;
+    /* Process frame if the codec is ready for it */
+    if (pars!=NULL && pData->isPlaying) {
+        current_disp_idx = pData->current_disp_idx;
 
-            /* Load time-domain data */
-            for(ch=0; ch<nSH; ch++)
-                memcpy(pData->SHframeTD[ch],pData->inFIFO[ch], SLDOA_FRAME_SIZE*sizeof(float));
+        /* Load time-domain data */
+        for(ch=0; ch<SAF_MIN(nInputs,nSH); ch++)
+            memcpy(pData->SHframeTD[ch], inputs[ch], SLDOA_FRAME_SIZE*sizeof(float));
+        for(; ch<nSH; ch++) /* Zero any channels that were not given */
+            memset(pData->SHframeTD[ch], 0, SLDOA_FRAME_SIZE*sizeof(float));
 
-            /* account for input channel order */
-            switch(chOrdering){
-                case CH_ACN:  /* already ACN */ break; /* Otherwise, convert to ACN... */
-                case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHframeTD), masterOrder, SLDOA_FRAME_SIZE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
-            }
+        /* account for input channel order */
+        switch(chOrdering){
+            case CH_ACN:  /* already ACN */ break; /* Otherwise, convert to ACN... */
+            case CH_FUMA: convertHOAChannelConvention(FLATTEN2D(pData->SHframeTD), masterOrder, SLDOA_FRAME_STRIDE, HOA_CH_ORDER_FUMA, HOA_CH_ORDER_ACN); break;
+        }
 
-            /* account for input normalisation scheme */
-            switch(norm){
-                case NORM_N3D:  /* already in N3D, do nothing */ break; /* Otherwise, convert to N3D... */
-                case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), masterOrder, SLDOA_FRAME_SIZE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
-                case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), masterOrder, SLDOA_FRAME_SIZE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
-            }
-        
-            /* apply the time-frequency transform */
-            afSTFT_forward_knownDimensions(pData->hSTFT, pData->SHframeTD, SLDOA_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS, pData->SHframeTF);
-
-            /* apply sector-based, frequency-dependent DOA analysis */
-            numAnalysisBands = 0;
-            min_band = 0;
-            for(band=1/* ignore DC */; band<HYBRID_BANDS; band++){
-                if(pData->freqVector[band] <= minFreq)
-                    min_band = band;
-                if(pData->freqVector[band] >= minFreq && pData->freqVector[band]<=maxFreq){
-                    nSectors = nSectorsPerBand[band];
-                    avgCoeff = avg_ms < 10.0f ? 1.0f : 1.0f / ((avg_ms/1e3f) / (1.0f/(float)HOP_SIZE) + 2.23e-9f);
-                    avgCoeff = SAF_MAX(SAF_MIN(avgCoeff, 0.99999f), 0.0f); /* ensures stability */
-                    sldoa_estimateDoA(pData->SHframeTF[band],
-                                      analysisOrderPerBand[band],
-                                      pData->secCoeffs[analysisOrderPerBand[band]-2], /* -2, as first order is skipped */
-                                      new_doa,
-                                      new_energy);
-
-                    /* average the raw data over time */
-                    for(i=0; i<nSectors; i++){
-                        for( t = 0; t<TIME_SLOTS; t++){
-                            /* avg doa estimate */
-                            unitSph2cart((float*)new_doa[i][t], 1, 0, (float*)new_doa_xyz);
-                            unitSph2cart((float*)pData->doa_rad[band][i], 1, 0, (float*)doa_xyz);
-                            for(j=0; j<3; j++)
-                                avg_xyz[j] = new_doa_xyz[j]*avgCoeff + doa_xyz[j] * (1.0f-avgCoeff); 
-                            unitCart2sph((float*)avg_xyz, 1, 0, (float*)pData->doa_rad[band][i]);
-
-                            /* avg energy */
-                            pData->energy[band][i] = new_energy[i][t]*avgCoeff + pData->energy[band][i] * (1.0f-avgCoeff);
-                        }
+        /* account for input normalisation scheme */
+        switch(norm){
+            case NORM_N3D:  /* already in N3D, do nothing */ break; /* Otherwise, convert to N3D... */
+            case NORM_SN3D: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), masterOrder, SLDOA_FRAME_STRIDE, HOA_NORM_SN3D, HOA_NORM_N3D); break;
+            case NORM_FUMA: convertHOANormConvention(FLATTEN2D(pData->SHframeTD), masterOrder, SLDOA_FRAME_STRIDE, HOA_NORM_FUMA, HOA_NORM_N3D); break;
+        }
+    
+        /* apply the time-frequency transform */
+        afSTFT_forward_knownDimensions(pars->hSTFT, pData->SHframeTD, SLDOA_FRAME_SIZE, MAX_NUM_SH_SIGNALS, TIME_SLOTS_STRIDE, pData->SHframeTF);
+
+        /* apply sector-based, frequency-dependent DOA analysis */
+        numAnalysisBands = 0;
+        min_band = 0;
+        for(band=1/* ignore DC */; band<HYBRID_BANDS; band++){
+            if(pData->freqVector[band] <= minFreq)
+                min_band = band;
+            if(pData->freqVector[band] >= minFreq && pData->freqVector[band]<=maxFreq){
+                nSectors = nSectorsPerBand[band];
+                avgCoeff = avg_ms < 10.0f ? 1.0f : 1.0f / ((avg_ms/1e3f) / (1.0f/(float)HOP_SIZE) + 2.23e-9f);
+                avgCoeff = SAF_MAX(SAF_MIN(avgCoeff, 0.99999f), 0.0f); /* ensures stability */
+                sldoa_estimateDoA(pData->SHframeTF[band],
+                                  analysisOrderPerBand[band],
+                                  analysisOrderPerBand[band]>1 ? pars->secCoeffs[analysisOrderPerBand[band]-2] : NULL, /* -2, as first order is skipped */
+                                  new_doa,
+                                  new_energy);
+
+                /* average the raw data over time */
+                for(i=0; i<nSectors; i++){
+                    for( t = 0; t<TIME_SLOTS; t++){
+                        /* avg doa estimate */
+                        unitSph2cart((float*)new_doa[i][t], 1, 0, (float*)new_doa_xyz);
+                        unitSph2cart((float*)pData->doa_rad[band][i], 1, 0, (float*)doa_xyz);
+                        for(j=0; j<3; j++)
+                            avg_xyz[j] = new_doa_xyz[j]*avgCoeff + doa_xyz[j] * (1.0f-avgCoeff); 
+                        unitCart2sph((float*)avg_xyz, 1, 0, (float*)pData->doa_rad[band][i]);
+
+                        /* avg energy */
+                        pData->energy[band][i] = new_energy[i][t]*avgCoeff + pData->energy[band][i] * (1.0f-avgCoeff);
                     }
-                    numAnalysisBands++;
                 }
+                numAnalysisBands++;
             }
+        }
 
-            /* determine the minimum and maximum sector energies per frequency (to scale them 0..1) */
-            for(band=1/* ignore DC */; band<HYBRID_BANDS; band++){
-                if(pData->freqVector[band] >= minFreq && pData->freqVector[band]<=maxFreq){
-                    nSectors = nSectorsPerBand[band];
-                    max_en[band] = 2.3e-13f; min_en[band] = 2.3e13f; /* starting values */
-                    for(i=0; i<nSectors; i++){
-                        max_en[band] = pData->energy[band][i] > max_en[band] ? pData->energy[band][i] : max_en[band];
-                        min_en[band] = pData->energy[band][i] < min_en[band] ? pData->energy[band][i] : min_en[band];
-                    }
+        /* determine the minimum and maximum sector energies per frequency (to scale them 0..1) */
+        for(band=1/* ignore DC */; band<HYBRID_BANDS; band++){
+            if(pData->freqVector[band] >= minFreq && pData->freqVector[band]<=maxFreq){
+                nSectors = nSectorsPerBand[band];
+                max_en[band] = 2.3e-13f; min_en[band] = 2.3e13f; /* starting values */
+                for(i=0; i<nSectors; i++){
+                    max_en[band] = pData->energy[band][i] > max_en[band] ? pData->energy[band][i] : max_en[band];
+                    min_en[band] = pData->energy[band][i] < min_en[band] ? pData->energy[band][i] : min_en[band];
                 }
             }
+        }
 
-            /* prep data for plotting */
-            for(band=1/* ignore DC */; band<HYBRID_BANDS; band++){
-                if(pData->freqVector[band] >= minFreq && pData->freqVector[band]<=maxFreq){
-                    nSectors = nSectorsPerBand[band];
-                    /* store averaged values */
-                    for(i=0; i<nSectors; i++){
-                        pData->azi_deg [current_disp_idx][band*MAX_NUM_SECTORS + i] = pData->doa_rad[band][i][0]*180.0f/SAF_PI;
-                        pData->elev_deg[current_disp_idx][band*MAX_NUM_SECTORS + i] = pData->doa_rad[band][i][1]*180.0f/SAF_PI;
-
-                        /* colour should indicate the different frequencies */
-                        pData->colourScale[current_disp_idx][band*MAX_NUM_SECTORS + i] = (float)(band-min_band)/(float)(numAnalysisBands+1);
-
-                        /* transparancy should indicate the energy of the sector for each DoA estimate, for each frequency */
-                        if( analysisOrderPerBand[band]==1  )
-                            pData->alphaScale[current_disp_idx][band*MAX_NUM_SECTORS + i] = 1.0f;
-                        else
-                            pData->alphaScale[current_disp_idx][band*MAX_NUM_SECTORS + i] = SAF_MIN(SAF_MAX((pData->energy[band][i]-min_en[band])/(max_en[band]-min_en[band]+2.3e-10f), 0.05f),1.0f);
-                    }
-                }
-                else{
-                    memset(&(pData->azi_deg [current_disp_idx][band*MAX_NUM_SECTORS]), 0, MAX_NUM_SECTORS*sizeof(float));
-                    memset(&(pData->elev_deg [current_disp_idx][band*MAX_NUM_SECTORS]), 0, MAX_NUM_SECTORS*sizeof(float));
-                    memset(&(pData->colourScale [current_disp_idx][band*MAX_NUM_SECTORS]), 0, MAX_NUM_SECTORS*sizeof(float));
-                    memset(&(pData->alphaScale [current_disp_idx][band*MAX_NUM_SECTORS]), 0, MAX_NUM_SECTORS*sizeof(float));
+        /* prep data for plotting */
+        for(band=1/* ignore DC */; band<HYBRID_BANDS; band++){
+            if(pData->freqVector[band] >= minFreq && pData->freqVector[band]<=maxFreq){
+                nSectors = nSectorsPerBand[band];
+                /* store averaged values */
+                for(i=0; i<nSectors; i++){
+                    pData->azi_deg [current_disp_idx][band*MAX_NUM_SECTORS + i] = pData->doa_rad[band][i][0]*180.0f/SAF_PI;
+                    pData->elev_deg[current_disp_idx][band*MAX_NUM_SECTORS + i] = pData->doa_rad[band][i][1]*180.0f/SAF_PI;
+
+                    /* colour should indicate the different frequencies */
+                    pData->colourScale[current_disp_idx][band*MAX_NUM_SECTORS + i] = (float)(band-min_band)/(float)(numAnalysisBands+1);
+
+                    /* transparancy should indicate the energy of the sector for each DoA estimate, for each frequency */
+                    if( analysisOrderPerBand[band]==1  )
+                        pData->alphaScale[current_disp_idx][band*MAX_NUM_SECTORS + i] = 1.0f;
+                    else
+                        pData->alphaScale[current_disp_idx][band*MAX_NUM_SECTORS + i] = SAF_MIN(SAF_MAX((pData->energy[band][i]-min_en[band])/(max_en[band]-min_en[band]+2.3e-10f), 0.05f),1.0f);
                 }
             }
-        }
-        else if(pData->FIFO_idx >= SLDOA_FRAME_SIZE){
-            /* reset FIFO_idx if codec was not ready */
-            pData->FIFO_idx = 0;
+            else{
+                memset(&(pData->azi_deg [current_disp_idx][band*MAX_NUM_SECTORS]), 0, MAX_NUM_SECTORS*sizeof(float));
+                memset(&(pData->elev_deg [current_disp_idx][band*MAX_NUM_SECTORS]), 0, MAX_NUM_SECTORS*sizeof(float));
+                memset(&(pData->colourScale [current_disp_idx][band*MAX_NUM_SECTORS]), 0, MAX_NUM_SECTORS*sizeof(float));
+                memset(&(pData->alphaScale [current_disp_idx][band*MAX_NUM_SECTORS]), 0, MAX_NUM_SECTORS*sizeof(float));
+            }
         }
     }
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void sldoa_analysis
+(
+    void        *  const hSld,
+    const float *const * inputs,
+    int                  nInputs,
+    int                  nSamples,
+    int                  isPlaying
+)
+{
+    sldoa_data *pData = (sldoa_data*)(hSld);
+
+    /* Analyse the host buffers in frames of #SLDOA_FRAME_SIZE samples */
+    pData->isPlaying = isPlaying;
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, NULL, nInputs, 0, nSamples, sldoa_analysisFrame, hSld);
 }
 
 /* SETS */
@@ -510,7 +546,7 @@ int sldoa_getFrameSize(void)
 CODEC_STATUS sldoa_getCodecStatus(void* const hSld)
 {
     sldoa_data *pData = (sldoa_data*)(hSld);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float sldoa_getProgressBar0_1(void* const hSld)
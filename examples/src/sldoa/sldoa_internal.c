@@ -49,15 +49,44 @@
 void sldoa_setCodecStatus(void* const hSld, CODEC_STATUS newStatus)
 {
     sldoa_data *pData = (sldoa_data*)(hSld);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next sldoa_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void sldoa_createCodecPars(sldoa_codecPars** const pPars)
+{
+    sldoa_codecPars* pars = (sldoa_codecPars*)malloc1d(sizeof(sldoa_codecPars));
+    int i;
+    *pPars = pars;
+
+    pars->masterOrder = pars->nSH = 0;
+    pars->hSTFT = NULL;
+    for(i=0; i<MAX_SH_ORDER-1; i++)
+        pars->secCoeffs[i] = NULL;
+}
+
+void sldoa_destroyCodecPars(sldoa_codecPars** const pPars)
+{
+    sldoa_codecPars* pars = *pPars;
+    int i;
+
+    if(pars!=NULL){
+        if(pars->hSTFT!=NULL)
+            afSTFT_destroy(&(pars->hSTFT));
+        for(i=0; i<MAX_SH_ORDER-1; i++)
+            free(pars->secCoeffs[i]);
+        free(pars);
+        pars = NULL;
+        *pPars = NULL;
     }
-    pData->codecStatus = newStatus;
 }
 
-void sldoa_initAna(void* const hSld)
+void sldoa_initAna
+(
+    void* const hSld,
+    sldoa_codecPars* const pars
+)
 {
     sldoa_data *pData = (sldoa_data*)(hSld);
     int i, n, j, k, order, nSectors, nSH, grid_N_vbap_gtable, grid_nGroups, maxOrder;
@@ -66,7 +95,7 @@ void sldoa_initAna(void* const hSld)
 
     secPatterns = (float**)calloc2d(4, pData->nGrid, sizeof(float));
 
-    maxOrder = pData->new_masterOrder;
+    maxOrder = pars->masterOrder;
     
     grid_vbap_gtable_T = malloc1d(ORDER2NUMSECTORS(maxOrder) * pData->nGrid * sizeof(float));
     
@@ -91,9 +120,8 @@ void sldoa_initAna(void* const hSld)
                 grid_vbap_gtable_T[n*pData->nGrid+j] = grid_vbap_gtable[j*nSectors+n];
         
         /* generate sector coefficients */
-        if(pData->secCoeffs[i]!=NULL)
-            free(pData->secCoeffs[i]);
-        pData->secCoeffs[i] = malloc1d(4 * (nSH*nSectors) * sizeof(float_complex));
+        free(pars->secCoeffs[i]);
+        pars->secCoeffs[i] = malloc1d(4 * (nSH*nSectors) * sizeof(float_complex));
         w_SG = malloc1d(4 * (nSH) * sizeof(float));
         pinv_Y = malloc1d(pData->nGrid*nSH*sizeof(float));
         for(n=0; n<nSectors; n++){ 
@@ -109,7 +137,7 @@ void sldoa_initAna(void* const hSld)
             /* stack the sector coefficients */
             for(j=0; j<4; j++)
                 for(k=0; k<nSH; k++)
-                    pData->secCoeffs[i][j*(nSectors*nSH)+n*nSH+k] = cmplxf(w_SG[j*nSH+k], 0.0f);
+                    pars->secCoeffs[i][j*(nSectors*nSH)+n*nSH+k] = cmplxf(w_SG[j*nSH+k], 0.0f);
         }
         free(w_SG);
         free(pinv_Y);
@@ -118,28 +146,38 @@ void sldoa_initAna(void* const hSld)
     }
     
     free(grid_vbap_gtable_T);
-    
-    pData->masterOrder = maxOrder;
 
     free(secPatterns);
 }
 
 void sldoa_initTFT
 (
-    void* const hSld
+    void* const hSld,
+    sldoa_codecPars* const pars
 )
 {
     sldoa_data *pData = (sldoa_data*)(hSld);
-    int nSH, new_nSH;
+    sldoa_codecPars* live = pData->liveState;
+    int order, nSH;
     
-    nSH = (pData->masterOrder+1)*(pData->masterOrder+1);
-    new_nSH = (pData->new_masterOrder+1)*(pData->new_masterOrder+1);
-    if(pData->hSTFT==NULL)
-        afSTFT_create(&(pData->hSTFT), new_nSH, 0, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
-    else if(nSH!=new_nSH){
-        afSTFT_channelChange(pData->hSTFT, new_nSH, 0);
-        afSTFT_clearBuffers(pData->hSTFT);
+    /* If the number of channels is unchanged, then the filterbank currently in use is passed on to the new codec
+     * parameters, so that its buffered signals carry over */
+    order = pData->new_masterOrder;
+    nSH = (order+1)*(order+1);
+    if(live!=NULL && live->nSH == nSH){
+        if(pars->hSTFT!=NULL)
+            afSTFT_destroy(&(pars->hSTFT));
+        pars->hSTFT = live->hSTFT;
+    }
+    else if(pars->hSTFT==NULL)
+        afSTFT_create(&(pars->hSTFT), nSH, 0, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    else {
+        if(pars->nSH != nSH) /* Change the number of channels */
+            afSTFT_channelChange(pars->hSTFT, nSH, 0);
+        afSTFT_clearBuffers(pars->hSTFT); /* (the spare set still holds the signals from when it was last used) */
     }
+    pars->masterOrder = order;
+    pars->nSH = nSH;
 }
 
 void sldoa_estimateDoA
@@ -176,7 +214,7 @@ void sldoa_estimateDoA
                     sec_c[i*nSH+j] = secCoeffs[i*(nSectors*nSH)+n*nSH+j];
             cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, 4, TIME_SLOTS, nSH, &calpha,
                         sec_c, nSH,
-                        FLATTEN2D(SHframeTF), TIME_SLOTS, &cbeta,
+                        FLATTEN2D(SHframeTF), TIME_SLOTS_STRIDE, &cbeta,
                         secSig, TIME_SLOTS);
         }
         
@@ -69,6 +69,8 @@ extern "C" {
 #define HOP_SIZE ( 128 )                   /**< STFT hop size */
 #define HYBRID_BANDS ( HOP_SIZE + 5 )      /**< hybrid mode incurs an additional 5 bands  */
 #define TIME_SLOTS ( SLDOA_FRAME_SIZE / HOP_SIZE )          /**< Processing relies on fdHop = 16 */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
+#define SLDOA_FRAME_STRIDE ( (int)md_alignedStride(SLDOA_FRAME_SIZE, sizeof(float)) ) /**< Distance between the rows of the time-domain frames (#SLDOA_FRAME_SIZE, padded to whole cache lines) */
 #define MAX_NUM_SECTORS ( 64 )             /**< maximum number of sectors, TODO: expand beyond 64 (which is the max possible in the spherecovering grids we currently use) */
 #define NUM_DISP_SLOTS ( 2 )               /**< Number of display slots; needs to be at least 2. On slower systems that skip frames, consider adding more slots.  */
 
@@ -81,32 +83,52 @@ extern "C" {
 /*                                 Structures                                 */
 /* ========================================================================== */
    
+/**
+ * Contains the filterbank and sector beamforming coefficients; i.e. everything
+ * that sldoa_analysis() needs from an initialisation
+ *
+ * A new set is built by sldoa_initCodec() (while the analysis keeps running
+ * with the current one), and then handed over to the analysis thread via a
+ * saf_stateSwap. Once published, only the analysis thread may touch it, until
+ * it is handed back by the next initialisation.
+ */
+typedef struct _sldoa_codecPars
+{
+    int masterOrder;                /**< Master/maximum analysis order */
+    int nSH;                        /**< Number of SH signals, (masterOrder+1)^2 */
+    void* hSTFT;                    /**< afSTFT handle (passed on to the next codec parameters, if they have the same number of channels) */
+    float_complex* secCoeffs[MAX_SH_ORDER-1]; /**< Sector beamforming weights/coefficients, for orders 2..masterOrder */
+
+}sldoa_codecPars;
+
 /** Main struct for sldoa */
 typedef struct _sldoa
 {
-    /* FIFO buffers */
-    int FIFO_idx;                   /**< FIFO buffer index */
-    float** inFIFO;                 /**< FIFO buffer */
+    /* Block adapter */
+    void* hBlockAdapter;            /**< Block adapter handle (for arbitrary host block sizes) */
+    int isPlaying;                  /**< Flag passed on to sldoa_analysisFrame() */
 
     /* TFT */
     float** SHframeTD;              /**< time-domain SH input frame; #MAX_NUM_SH_SIGNALS x #SLDOA_FRAME_SIZE */
     float_complex*** SHframeTF;     /**< time-frequency domain SH input frame; #HYBRID_BANDS x #MAX_NUM_SH_SIGNALS x #TIME_SLOTS */
-    void* hSTFT;                    /**< afSTFT handle */
     float freqVector[HYBRID_BANDS]; /**< Frequency vector (filterbank centre frequencies) */
     float fs;                       /**< Host sampling rate, in Hz */
       
     /* ana configuration */
-    CODEC_STATUS codecStatus;       /**< see #CODEC_STATUS */
-    PROC_STATUS procStatus;         /**< see #PROC_STATUS */
+    volatile long codecStatus;      /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;         /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;           /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;          /**< Current (re)initialisation step, string */
+    void* hStateSwap;               /**< saf_stateSwap handle, via which new codec parameters are handed over to the analysis thread */
+    sldoa_codecPars* liveState;     /**< The last published codec parameters (or NULL); read-only, until they are handed back */
+    sldoa_codecPars* spareState;    /**< The previous codec parameters (or NULL), in which the next ones are built */
+    volatile long resetAvgFLAG;     /**< 1: the analysis thread clears its temporal averaging and display buffers (only accessed via the saf_atomic functions) */
     
     /* internal */
     int nGrid;                      /**< Number of grid directions */
     float** grid_Y;                 /**< SH basis */
     float** grid_Y_dipoles_norm;    /**< SH basis */
     float** grid_dirs_deg;          /**< Grid directions, in degrees */
-    float_complex* secCoeffs[MAX_SH_ORDER-1];        /**< Sector beamforming weights/coefficients */
     float doa_rad[HYBRID_BANDS][MAX_NUM_SECTORS][2]; /**< Current DoA estimates per band and sector, in radians */
     float energy [HYBRID_BANDS][MAX_NUM_SECTORS];    /**< Current Sector energies */
     int nSectorsPerBand[HYBRID_BANDS];               /**< Number of sectors per band */
@@ -120,7 +142,7 @@ typedef struct _sldoa
     int current_disp_idx;                /**< Current display slot */
     
     /* User parameters */
-    int masterOrder;                     /**< Current master/maximum analysis order */
+    int masterOrder;                     /**< Master/maximum analysis order of the last built codec parameters */
     int analysisOrderPerBand[HYBRID_BANDS]; /**< Analysis order MIN(anaPerBand, masterOrder) for each frequency band */
     float maxFreq;                       /**< Maximum display frequency, in Hz */
     float minFreq;                       /**< Minimum display frequency, in Hz */
@@ -138,8 +160,15 @@ typedef struct _sldoa
 /** Sets codec status (see #CODEC_STATUS enum) */
 void sldoa_setCodecStatus(void* const hSld, CODEC_STATUS newStatus);
 
+/** Creates an (empty) set of codec parameters; see #sldoa_codecPars */
+void sldoa_createCodecPars(sldoa_codecPars** const pPars);
+
+/** Destroys a set of codec parameters (if not NULL) */
+void sldoa_destroyCodecPars(sldoa_codecPars** const pPars);
+
 /**
- * Intialises the codec variables, based on current global/user parameters.
+ * Intialises the codec variables, based on current global/user parameters
+ * (written to the given set of codec parameters).
  *
  * The formulae for calculating the sector coefficients can be found in [1,2].
  *
@@ -154,17 +183,21 @@ void sldoa_setCodecStatus(void* const hSld, CODEC_STATUS newStatus);
  *          Visualization. Journal of the Audio Engineering Society, 67(11),
  *          pp.840-854.
  */
-void sldoa_initAna(void* const hSld);
+void sldoa_initAna(void* const hSld,
+                   sldoa_codecPars* const pars);
     
 /**
- * Initialise the filterbank used by sldoa.
+ * Initialise the filterbank of a new set of codec parameters. If the number of
+ * channels is unchanged, then the filterbank currently in use is passed on.
  *
  * @note Call this function before sldoa_initAna()
  *
  * Input Arguments:
  *     hSld - sldoa handle
+ *     pars - codec parameters to initialise
  */
-void sldoa_initTFT(void* const hSld);
+void sldoa_initTFT(void* const hSld,
+                   sldoa_codecPars* const pars);
   
 /**
  * Estimates the DoA using the active intensity vectors derived from spatially
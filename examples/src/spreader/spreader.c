@@ -38,7 +38,7 @@ void spreader_create
 {
     spreader_data* pData = (spreader_data*)malloc1d(sizeof(spreader_data));
     *phSpr = (void*)pData;
-    int band, t, src;
+    int t;
 
     /* user parameters */
     pData->sofa_filepath = NULL;
@@ -51,39 +51,18 @@ void spreader_create
 
     /* time-frequency transform + buffers */
     pData->fs = 48000.0f;
-    pData->hSTFT = NULL;
-    pData->inputFrameTD = (float**)malloc2d(MAX_NUM_INPUTS, SPREADER_FRAME_SIZE, sizeof(float));
-    pData->outframeTD = (float**)malloc2d(MAX_NUM_OUTPUTS, SPREADER_FRAME_SIZE, sizeof(float));
-    pData->inputframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_INPUTS, TIME_SLOTS, sizeof(float_complex));
-    pData->protoframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
-    pData->decorframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
-    pData->spreadframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
-    pData->outputframeTF = (float_complex***)malloc3d(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
+    pData->inputFrameTD = (float**)malloc2d_aligned(MAX_NUM_INPUTS, SPREADER_FRAME_SIZE, sizeof(float));
+    pData->outframeTD = (float**)malloc2d_aligned(MAX_NUM_OUTPUTS, SPREADER_FRAME_SIZE, sizeof(float));
+    pData->inputframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_INPUTS, TIME_SLOTS, sizeof(float_complex));
+    pData->protoframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
+    pData->decorframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
+    pData->spreadframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
+    pData->outputframeTF = (float_complex***)calloc3d_aligned(HYBRID_BANDS, MAX_NUM_OUTPUTS, TIME_SLOTS, sizeof(float_complex));
     
     /* Internal */
+    pData->hThreadPool = NULL;
     pData->Q = pData->nGrid = pData->h_len = 0;
     pData->h_fs = 0.0f;
-    pData->h_grid = NULL;
-    pData->H_grid = NULL;
-    for(band=0; band<HYBRID_BANDS; band++)
-        pData->HHH[band] = NULL;
-    pData->grid_dirs_deg = NULL;
-    pData->grid_dirs_xyz = NULL;
-    pData->weights = NULL;
-    pData->angles = NULL;
-    for(src=0; src<SPREADER_MAX_NUM_SOURCES; src++){
-        pData->hDecor[src] = NULL;
-        pData->Cy[src] = NULL;
-        pData->Cproto[src] = NULL;
-        pData->prev_M[src] = NULL;
-        pData->prev_Mr[src] = NULL;
-        pData->dirActive[src] = NULL;
-    }
-    pData->new_M = NULL;
-    pData->new_Mr = NULL;
-    pData->interp_M = NULL;
-    pData->interp_Mr = NULL;
-    pData->interp_Mr_cmplx = NULL;
     for(t=0; t<TIME_SLOTS; t++){
         pData->interpolatorFadeIn[t] = ((float)t+1.0f)/(float)TIME_SLOTS;
         pData->interpolatorFadeOut[t] = 1.0f - ((float)t+1.0f)/(float)TIME_SLOTS;
@@ -94,26 +73,22 @@ void spreader_create
     pData->_H_tmp = malloc1d(MAX_NUM_CHANNELS *sizeof(float_complex));
     pData->_Cy = malloc1d(MAX_NUM_CHANNELS*MAX_NUM_CHANNELS *sizeof(float_complex));
     pData->_E_dir = malloc1d(MAX_NUM_CHANNELS*MAX_NUM_CHANNELS *sizeof(float_complex));
-    pData->_V = malloc1d(MAX_NUM_OUTPUTS*MAX_NUM_OUTPUTS *sizeof(float_complex));
-    pData->_D = malloc1d(MAX_NUM_OUTPUTS*MAX_NUM_OUTPUTS *sizeof(float_complex));
     pData->_Cproto = malloc1d(MAX_NUM_OUTPUTS*MAX_NUM_OUTPUTS *sizeof(float_complex));
 
-    /* Optimal mixing */
-    pData->hCdf = NULL;
-    pData->hCdf_res = NULL;
-    pData->Qmix = NULL;
-    pData->Qmix_cmplx = NULL;
-    pData->Cr = NULL;
-    pData->Cr_cmplx = NULL;
-
     /* flags/status */
     pData->new_procMode = pData->procMode;
     pData->new_nSources = pData->nSources;
+    pData->nThreads = pData->new_nThreads = 1;
     pData->progressBar0_1 = 0.0f;
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    pData->initLock = 0;
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
+
+    /* for passing arbitrary host block sizes through spreader_processFrame() */
+    saf_blockAdapter_create(&(pData->hBlockAdapter), SPREADER_FRAME_SIZE, MAX_NUM_INPUTS, MAX_NUM_OUTPUTS);
 }
 
 void spreader_destroy
@@ -122,69 +97,43 @@ void spreader_destroy
 )
 {
     spreader_data *pData = (spreader_data*)(*phSpr);
-    int band, src;
+    spreader_renderState *state;
 
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
-
-    free(pData->sofa_filepath);
+        /* Wait for any on-going initialisation to complete, and then take back the current render state (which also
+         * waits for the processing loop to let go of it) */
+        saf_spinLock_lock(&(pData->initLock));
+        state = (spreader_renderState*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(state==pData->liveState, "Unexpected render state");
+        spreader_destroyRenderState(&state);
+        spreader_destroyRenderState(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
+
+        free(pData->sofa_filepath);
         
-        /* free afSTFT and buffers */
-        if(pData->hSTFT !=NULL)
-            afSTFT_destroy(&(pData->hSTFT));
-        free(pData->inputFrameTD);
-        free(pData->outframeTD);
-        free(pData->inputframeTF);
-        free(pData->decorframeTF);
-        free(pData->spreadframeTF);
-        free(pData->outputframeTF);
+        /* free buffers */
+        free2d_aligned((void**)pData->inputFrameTD);
+        free2d_aligned((void**)pData->outframeTD);
+        free3d_aligned((void***)pData->inputframeTF);
+        free3d_aligned((void***)pData->protoframeTF);
+        free3d_aligned((void***)pData->decorframeTF);
+        free3d_aligned((void***)pData->spreadframeTF);
+        free3d_aligned((void***)pData->outputframeTF);
 
         /* internal */
-        free(pData->h_grid);
-        free(pData->H_grid);
-        for(band=0; band<HYBRID_BANDS; band++)
-            free(pData->HHH[band]);
-        free(pData->grid_dirs_deg);
-        free(pData->grid_dirs_xyz);
-        free(pData->weights);
-        free(pData->angles);
-        for(src=0; src<SPREADER_MAX_NUM_SOURCES; src++){
-            latticeDecorrelator_destroy(&(pData->hDecor[src]));
-            free(pData->Cy[src]);
-            free(pData->Cproto[src]);
-            free(pData->prev_M[src]);
-            free(pData->prev_Mr[src]);
-            free(pData->dirActive[src]);
-        }
-        free(pData->new_M);
-        free(pData->new_Mr);
-        free(pData->interp_M);
-        free(pData->interp_Mr);
-        free(pData->interp_Mr_cmplx);
+        if(pData->hThreadPool!=NULL)
+            saf_threadPool_destroy(&(pData->hThreadPool));
 
         // Hotfix:
         free(pData->_tmpFrame);
         free(pData->_H_tmp);
         free(pData->_Cy);
         free(pData->_E_dir);
-        free(pData->_V);
-        free(pData->_D);
         free(pData->_Cproto);
-        
-        /* Optimal mixing */
-        cdf4sap_cmplx_destroy(&(pData->hCdf));
-        cdf4sap_destroy(&(pData->hCdf_res));
-        free(pData->Qmix);
-        free(pData->Qmix_cmplx);
-        free(pData->Cr);
-        free(pData->Cr_cmplx);
 
         free(pData->progressBarText);
          
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData);
         pData = NULL;
         *phSpr = NULL;
@@ -194,14 +143,18 @@ void spreader_destroy
 void spreader_init
 (
     void * const hSpr,
-    int          sampleRate
+    int          sampleRate,
+    int          blockSize
 )
 {
     spreader_data *pData = (spreader_data*)(hSpr);
     
     /* define frequency vector */
     pData->fs = sampleRate;
-    afSTFT_getCentreFreqs(pData->hSTFT, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
+    afSTFT_getCentreFreqs(NULL, (float)sampleRate, HYBRID_BANDS, pData->freqVector);
+
+    /* flush the block adapter, and set its latency for this host block size */
+    saf_blockAdapter_reset(pData->hBlockAdapter, blockSize);
 }
 
 void spreader_initCodec
@@ -210,7 +163,10 @@ void spreader_initCodec
 )
 {
     spreader_data *pData = (spreader_data*)(hSpr);
-    int q, band, ng, nSources, src;
+    spreader_renderState* state, *live;
+    void* hPrevThreadPool;
+    int q, band, ng, nSources, src, Q, h_len, nGrid;
+    float h_fs;
     float_complex scaleC;
 #ifdef SAF_ENABLE_SOFA_READER_MODULE
     saf_sofa_container sofa;
@@ -220,144 +176,264 @@ void spreader_initCodec
     float_complex H_tmp[MAX_NUM_CHANNELS];
     const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
 
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
 
     nSources = pData->new_nSources;
     procMode = pData->new_procMode;
     
     /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Initialising");
     pData->progressBar0_1 = 0.0f;
 
-    /* Load measurements (e.g. HRIRs, Microphone array IRs etc.) */
-#ifndef SAF_ENABLE_SOFA_READER_MODULE
-    pData->useDefaultHRIRsFLAG = 1;
-#endif
-    if(pData->useDefaultHRIRsFLAG){
-        /* Load default HRIR data */
-        pData->Q = NUM_EARS;
-        pData->nGrid = __default_N_hrir_dirs;
-        pData->h_len = __default_hrir_len;
-        pData->h_fs = (float)__default_hrir_fs;
-        pData->h_grid = realloc1d(pData->h_grid, pData->nGrid * (pData->Q) * (pData->h_len) * sizeof(float));
-        memcpy(pData->h_grid, (float*)__default_hrirs, pData->nGrid * (pData->Q) * (pData->h_len) * sizeof(float));
-        pData->grid_dirs_deg = realloc1d(pData->grid_dirs_deg, pData->nGrid * 2 * sizeof(float));
-        memcpy(pData->grid_dirs_deg, (float*)__default_hrir_dirs_deg, pData->nGrid * 2 * sizeof(float));
+    /* The new render state is built in the spare one, while the audio thread keeps rendering with the current one */
+    if(pData->spareState==NULL)
+        spreader_createRenderState(&(pData->spareState));
+    state = pData->spareState;
+    live = pData->liveState;
+
+    /* (Re)create the thread pool, if the number of threads has changed (the previous pool is only destroyed once the
+     * audio thread has switched over to the new render state) */
+    hPrevThreadPool = NULL;
+    if(pData->new_nThreads != pData->nThreads){
+        hPrevThreadPool = pData->hThreadPool;
+        pData->hThreadPool = NULL;
+        if(pData->new_nThreads>1)
+            saf_threadPool_create(&(pData->hThreadPool), pData->new_nThreads-1);
+        pData->nThreads = pData->new_nThreads;
     }
+    state->hThreadPool = pData->hThreadPool;
+
+    /* Release all of the previous tables/buffers of this state at once (the memory is re-used) */
+    saf_arena_reset(state->hArena);
+
+    /* Load measurements (e.g. HRIRs, Microphone array IRs etc.) */
 #ifdef SAF_ENABLE_SOFA_READER_MODULE
-    else{
+    if(!pData->useDefaultHRIRsFLAG && pData->sofa_filepath!=NULL){
         /* Use sofa loader */
         error = saf_sofa_open(&sofa, pData->sofa_filepath, SAF_SOFA_READER_OPTION_DEFAULT);
-        if(error!=SAF_SOFA_OK){
-            /* if failed, then load default data instead */
+
+        /* Load defaults instead */
+        if(error!=SAF_SOFA_OK || sofa.nReceivers>MAX_NUM_OUTPUTS){
+            saf_sofa_close(&sofa);
             pData->useDefaultHRIRsFLAG = 1;
-            saf_print_warning("Unable to load the specified SOFA file. Using default HRIR data instead");
-            spreader_initCodec(hSpr);
+            saf_print_warning("Unable to load the specified SOFA file, or it contained too many channels. Using default HRIR data instead");
         }
-        pData->h_fs = sofa.DataSamplingRate;
-        pData->h_len = sofa.DataLengthIR;
-        pData->nGrid = sofa.nSources;
-        pData->h_grid = realloc1d(pData->h_grid, pData->nGrid*(pData->Q)*(pData->h_len)*sizeof(float));
-        memcpy(pData->h_grid, sofa.DataIR, pData->nGrid*(pData->Q)*(pData->h_len)*sizeof(float));
-        pData->grid_dirs_deg = realloc1d(pData->grid_dirs_deg, pData->nGrid*2*sizeof(float));
-        cblas_scopy(pData->nGrid, sofa.SourcePosition, 3, pData->grid_dirs_deg, 2); /* azi */
-        cblas_scopy(pData->nGrid, &sofa.SourcePosition[1], 3, &pData->grid_dirs_deg[1], 2); /* elev */
+    }
+    if(!pData->useDefaultHRIRsFLAG && pData->sofa_filepath!=NULL){
+        /* Copy SOFA data */
+        Q = sofa.nReceivers;
+        h_fs = sofa.DataSamplingRate;
+        h_len = sofa.DataLengthIR;
+        nGrid = sofa.nSources;
+        state->h_grid = saf_arena_malloc1d(state->hArena, nGrid*Q*h_len*sizeof(float));
+        memcpy(state->h_grid, sofa.DataIR, nGrid*Q*h_len*sizeof(float));
+        state->grid_dirs_deg = saf_arena_malloc1d(state->hArena, nGrid*2*sizeof(float));
+        cblas_scopy(nGrid, sofa.SourcePosition, 3, state->grid_dirs_deg, 2); /* azi */
+        cblas_scopy(nGrid, &sofa.SourcePosition[1], 3, &state->grid_dirs_deg[1], 2); /* elev */
+
+        /* Clean-up */
         saf_sofa_close(&sofa);
     }
+    else
+#else
+    pData->useDefaultHRIRsFLAG = 1; /* Can only load the default HRIR data */
 #endif
+    {
+        /* Load default HRIR data (also the fallback, if the SOFA file could not be loaded) */
+        Q = NUM_EARS;
+        nGrid = __default_N_hrir_dirs;
+        h_len = __default_hrir_len;
+        h_fs = (float)__default_hrir_fs;
+        state->h_grid = saf_arena_malloc1d(state->hArena, nGrid*Q*h_len*sizeof(float));
+        memcpy(state->h_grid, (float*)__default_hrirs, nGrid*Q*h_len*sizeof(float));
+        state->grid_dirs_deg = saf_arena_malloc1d(state->hArena, nGrid*2*sizeof(float));
+        memcpy(state->grid_dirs_deg, (float*)__default_hrir_dirs_deg, nGrid*2*sizeof(float));
+    }
 
     /* Convert from the 0..360 convention, to -180..180, and pre-compute unit Cartesian vectors */
-    convert_0_360To_m180_180(pData->grid_dirs_deg, pData->nGrid);
-    pData->grid_dirs_xyz = realloc1d(pData->grid_dirs_xyz, pData->nGrid*3*sizeof(float));
-    unitSph2cart(pData->grid_dirs_deg, pData->nGrid, 1, pData->grid_dirs_xyz);
+    convert_0_360To_m180_180(state->grid_dirs_deg, nGrid);
+    state->grid_dirs_xyz = saf_arena_malloc1d(state->hArena, nGrid*3*sizeof(float));
+    unitSph2cart(state->grid_dirs_deg, nGrid, 1, state->grid_dirs_xyz);
+
+    /* (Re)Initialise afSTFT. If the number of channels is unchanged, then the filterbank currently in use is passed on
+     * to the new render state, so that its buffered signals carry over and the audio continues seamlessly */
+    if(live!=NULL && live->nSources == nSources && live->Q == Q){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        state->hSTFT = live->hSTFT;
+    }
+    else if(state->hSTFT==NULL)
+        afSTFT_create(&(state->hSTFT), nSources, Q, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    else {
+        if(state->nSources != nSources || state->Q != Q) /* Change the number of channels */
+            afSTFT_channelChange(state->hSTFT, nSources, Q);
+        afSTFT_clearBuffers(state->hSTFT); /* (the spare state still holds the signals from when it was last used) */
+    }
 
-    /* Initialise time-frequency transform and decorrelators */
-    afSTFT_destroy(&(pData->hSTFT));
-    afSTFT_create(&(pData->hSTFT), nSources, pData->Q, HOP_SIZE, 0, 1, AFSTFT_BANDS_CH_TIME);
+    /* Initialise decorrelators */
     int orders[4] = {20, 15, 6, 6}; /* 20th order up to 700Hz, 15th->2.4kHz, 6th->4kHz, 3rd->12kHz, NONE(only delays)->Nyquist */
     //float freqCutoffs[4] = {600.0f, 2.6e3f, 4.5e3f, 12e3f};
     float freqCutoffs[4] = {900.0f, 6.8e3f, 12e3f, 24e3f};
     const int maxDelay = 12;
     for(src=0; src<SPREADER_MAX_NUM_SOURCES; src++){
-        latticeDecorrelator_destroy(&(pData->hDecor[src]));
-        latticeDecorrelator_create(&(pData->hDecor[src]), (float)pData->fs, HOP_SIZE, pData->freqVector, HYBRID_BANDS, pData->Q, orders, freqCutoffs, 4, maxDelay, 0, 0.75f);
+        latticeDecorrelator_destroy(&(state->hDecor[src]));
+        latticeDecorrelator_create(&(state->hDecor[src]), (float)pData->fs, HOP_SIZE, pData->freqVector, HYBRID_BANDS, Q, orders, freqCutoffs, 4, maxDelay, 0, 0.75f);
     }
 
     /* Convert to filterbank coefficients and pre-compute outer products */
-    pData->H_grid = realloc1d(pData->H_grid, HYBRID_BANDS*(pData->Q)*pData->nGrid*sizeof(float_complex));
-    afSTFT_FIRtoFilterbankCoeffs(pData->h_grid, pData->nGrid, pData->Q, pData->h_len, HOP_SIZE, 0, 1, pData->H_grid);
-    pData->weights = realloc1d(pData->weights, pData->nGrid*sizeof(float));
-    getVoronoiWeights(pData->grid_dirs_deg, pData->nGrid, 0, pData->weights);
-    cblas_sscal(pData->nGrid, 1.0f/FOURPI, pData->weights, 1);
+    state->H_grid = saf_arena_malloc1d(state->hArena, HYBRID_BANDS*Q*nGrid*sizeof(float_complex));
+    afSTFT_FIRtoFilterbankCoeffs(state->h_grid, nGrid, Q, h_len, HOP_SIZE, 0, 1, state->H_grid);
+    state->weights = saf_arena_malloc1d(state->hArena, nGrid*sizeof(float));
+    getVoronoiWeights(state->grid_dirs_deg, nGrid, 0, state->weights);
+    cblas_sscal(nGrid, 1.0f/FOURPI, state->weights, 1);
     for(band=0; band<HYBRID_BANDS; band++){
-        pData->HHH[band] = (float_complex**)realloc2d((void**)pData->HHH[band], pData->nGrid, pData->Q * (pData->Q), sizeof(float_complex));
-        for(ng=0; ng<pData->nGrid; ng++){
-            for(q=0; q<pData->Q; q++)
-                H_tmp[q] = pData->H_grid[band*(pData->Q)*pData->nGrid + q*pData->nGrid + ng];
-            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, pData->Q, pData->Q, 1, &calpha,
+        state->HHH[band] = (float_complex**)saf_arena_malloc2d(state->hArena, nGrid, Q*Q, sizeof(float_complex));
+        for(ng=0; ng<nGrid; ng++){
+            for(q=0; q<Q; q++)
+                H_tmp[q] = state->H_grid[band*Q*nGrid + q*nGrid + ng];
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, Q, Q, 1, &calpha,
                         H_tmp, 1,
                         H_tmp, 1, &cbeta,
-                        pData->HHH[band][ng], pData->Q);
-            scaleC = cmplxf(pData->weights[ng], 0.0f);
-            cblas_cscal(pData->Q * (pData->Q), &scaleC, pData->HHH[band][ng], 1);
+                        state->HHH[band][ng], Q);
+            scaleC = cmplxf(state->weights[ng], 0.0f);
+            cblas_cscal(Q*Q, &scaleC, state->HHH[band][ng], 1);
         }
     }
-    pData->angles = realloc1d(pData->angles, pData->nGrid*sizeof(float));
+    state->angles = saf_arena_malloc1d(state->hArena, nGrid*sizeof(float));
 
     /* OM structures */
-    cdf4sap_cmplx_destroy(&(pData->hCdf));
-    cdf4sap_cmplx_create(&(pData->hCdf), pData->Q, pData->Q);
-    cdf4sap_destroy(&(pData->hCdf_res));
-    cdf4sap_create(&(pData->hCdf_res), pData->Q, pData->Q);
-    pData->Qmix = realloc1d(pData->Qmix, pData->Q*(pData->Q)*sizeof(float));
-    memset(pData->Qmix, 0, pData->Q*(pData->Q)*sizeof(float));
-    pData->Qmix_cmplx = realloc1d(pData->Qmix_cmplx, pData->Q*(pData->Q)*sizeof(float_complex));
-    memset(pData->Qmix_cmplx, 0, pData->Q*(pData->Q)*sizeof(float_complex));
-    for(q=0; q<pData->Q; q++){
-        pData->Qmix[q*(pData->Q)+q] = 1.0f;
-        pData->Qmix_cmplx[q*(pData->Q)+q] = cmplxf(1.0f, 0.0f);
+    cdf4sap_cmplx_destroy(&(state->hCdf));
+    cdf4sap_cmplx_create(&(state->hCdf), Q, Q);
+    cdf4sap_destroy(&(state->hCdf_res));
+    cdf4sap_create(&(state->hCdf_res), Q, Q);
+    utility_cseig_destroy(&(state->hCseig));
+    utility_cseig_create(&(state->hCseig), Q);
+    state->Qmix = saf_arena_malloc1d(state->hArena, Q*Q*sizeof(float));
+    memset(state->Qmix, 0, Q*Q*sizeof(float));
+    state->Qmix_cmplx = saf_arena_malloc1d(state->hArena, Q*Q*sizeof(float_complex));
+    memset(state->Qmix_cmplx, 0, Q*Q*sizeof(float_complex));
+    for(q=0; q<Q; q++){
+        state->Qmix[q*Q+q] = 1.0f;
+        state->Qmix_cmplx[q*Q+q] = cmplxf(1.0f, 0.0f);
     }
-    pData->Cr = realloc1d(pData->Cr, pData->Q*(pData->Q)*sizeof(float));
-    pData->Cr_cmplx = realloc1d(pData->Cr_cmplx, pData->Q*(pData->Q)*sizeof(float_complex));
+    state->Cr = saf_arena_malloc1d(state->hArena, Q*Q*sizeof(float));
+    state->Cr_cmplx = saf_arena_malloc1d(state->hArena, Q*Q*sizeof(float_complex));
+    state->V_evd = saf_arena_malloc1d(state->hArena, HYBRID_BANDS*Q*Q*sizeof(float_complex));
+    state->eig_evd = saf_arena_malloc1d(state->hArena, HYBRID_BANDS*Q*sizeof(float));
 
     /* mixing matrices and buffers */
     for(src=0; src<SPREADER_MAX_NUM_SOURCES; src++){
-        pData->Cy[src] = (float_complex**)realloc2d((void**)pData->Cy[src], HYBRID_BANDS, (pData->Q)*(pData->Q), sizeof(float_complex));
-        memset(FLATTEN2D(pData->Cy[src]), 0, HYBRID_BANDS * (pData->Q)*(pData->Q) * sizeof(float_complex));
-        pData->Cproto[src] = (float_complex**)realloc2d((void**)pData->Cproto[src], HYBRID_BANDS, (pData->Q)*(pData->Q), sizeof(float_complex));
-        memset(FLATTEN2D(pData->Cproto[src]), 0, HYBRID_BANDS * (pData->Q)*(pData->Q) * sizeof(float_complex));
-        pData->prev_M[src] = (float_complex**)realloc2d((void**)pData->prev_M[src], HYBRID_BANDS, (pData->Q)*(pData->Q), sizeof(float_complex));
-        memset(FLATTEN2D(pData->prev_M[src]), 0, HYBRID_BANDS * (pData->Q)*(pData->Q) * sizeof(float_complex));
-        pData->prev_Mr[src] = (float**)realloc2d((void**)pData->prev_Mr[src], HYBRID_BANDS, (pData->Q)*(pData->Q), sizeof(float));
-        memset(FLATTEN2D(pData->prev_Mr[src]), 0, HYBRID_BANDS * (pData->Q)*(pData->Q) * sizeof(float));
-        pData->dirActive[src] = realloc1d(pData->dirActive[src], pData->nGrid * sizeof(int));
-        memset(pData->dirActive[src], 0, pData->nGrid*sizeof(int));
+        state->Cy[src] = (float_complex**)saf_arena_malloc2d(state->hArena, HYBRID_BANDS, Q*Q, sizeof(float_complex));
+        memset(FLATTEN2D(state->Cy[src]), 0, HYBRID_BANDS*Q*Q*sizeof(float_complex));
+        state->Cproto[src] = (float_complex**)saf_arena_malloc2d(state->hArena, HYBRID_BANDS, Q*Q, sizeof(float_complex));
+        memset(FLATTEN2D(state->Cproto[src]), 0, HYBRID_BANDS*Q*Q*sizeof(float_complex));
+        state->prev_M[src] = (float_complex**)saf_arena_malloc2d(state->hArena, HYBRID_BANDS, Q*Q, sizeof(float_complex));
+        memset(FLATTEN2D(state->prev_M[src]), 0, HYBRID_BANDS*Q*Q*sizeof(float_complex));
+        state->prev_Mr[src] = (float**)saf_arena_malloc2d(state->hArena, HYBRID_BANDS, Q*Q, sizeof(float));
+        memset(FLATTEN2D(state->prev_Mr[src]), 0, HYBRID_BANDS*Q*Q*sizeof(float));
+        state->dirActive[src] = saf_arena_malloc1d(state->hArena, nGrid*sizeof(int));
+        memset(state->dirActive[src], 0, nGrid*sizeof(int));
     }
-    pData->new_M = (float_complex**)realloc2d((void**)pData->new_M, HYBRID_BANDS, (pData->Q)*(pData->Q), sizeof(float_complex));
-    pData->new_Mr = (float**)realloc2d((void**)pData->new_Mr, HYBRID_BANDS, (pData->Q)*(pData->Q), sizeof(float));
-    pData->interp_M = realloc1d(pData->interp_M, (pData->Q)*(pData->Q) * sizeof(float_complex));
-    pData->interp_Mr = realloc1d(pData->interp_Mr, (pData->Q)*(pData->Q) * sizeof(float));
-    pData->interp_Mr_cmplx = realloc1d(pData->interp_Mr_cmplx, (pData->Q)*(pData->Q) * sizeof(float_complex));
-    memset(pData->interp_Mr_cmplx, 0, (pData->Q)*(pData->Q) * sizeof(float_complex));
+    state->new_M = (float_complex**)saf_arena_malloc2d(state->hArena, HYBRID_BANDS, Q*Q, sizeof(float_complex));
+    state->new_Mr = (float**)saf_arena_malloc2d(state->hArena, HYBRID_BANDS, Q*Q, sizeof(float));
+    state->interp_M = saf_arena_malloc1d(state->hArena, HYBRID_BANDS*Q*Q*sizeof(float_complex));
+    state->interp_Mr = saf_arena_malloc1d(state->hArena, HYBRID_BANDS*Q*Q*sizeof(float));
+    state->interp_Mr_cmplx = saf_arena_malloc1d(state->hArena, HYBRID_BANDS*Q*Q*sizeof(float_complex));
+    memset(state->interp_Mr_cmplx, 0, HYBRID_BANDS*Q*Q*sizeof(float_complex));
 
     /* New config */
-    pData->nSources = nSources;
-    pData->procMode = procMode;
-
-    /* done! */
+    state->nSources = pData->nSources = nSources;
+    state->procMode = pData->procMode = procMode;
+    state->Q = pData->Q = Q;
+    state->nGrid = pData->nGrid = nGrid;
+    pData->h_len = h_len;
+    pData->h_fs = h_fs;
+
+    /* Hand the new render state over to the audio thread, and keep the previous one as the spare, once it is no longer
+     * being used */
+    pData->spareState = (spreader_renderState*)saf_stateSwap_publish(pData->hStateSwap, (void*)state);
+    pData->liveState = state;
+    if(pData->spareState!=NULL && pData->spareState->hSTFT == state->hSTFT)
+        pData->spareState->hSTFT = NULL; /* (passed on to the new render state) */
+    if(hPrevThreadPool!=NULL)
+        saf_threadPool_destroy(&hPrevThreadPool);
+
+    /* done! (unless new parameters were set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
-void spreader_process
+/** Arguments for spreader_mixBands() */
+typedef struct _spreader_mixArgs {
+    spreader_data* pData;
+    spreader_renderState* state;
+    int src, Q;
+    SPREADER_PROC_MODES procMode;
+} spreader_mixArgs;
+
+/**
+ * Applies the (interpolated) mixing matrices of the current source to
+ * frequency bands start..end-1 of the current frame (see
+ * saf_threadPool_parallelFor())
+ */
+static void spreader_mixBands
+(
+    void* arg,
+    int start,
+    int end
+)
+{
+    spreader_mixArgs* a = (spreader_mixArgs*)arg;
+    spreader_data *pData = a->pData;
+    spreader_renderState *state = a->state;
+    int i, t, band;
+    const int src = a->src, Q = a->Q;
+    float_complex scaleC, tmp;
+    float_complex* interp_M, *interp_Mr_cmplx;
+    float* interp_Mr;
+
+    for(band=start; band<end; band++){
+        interp_M = &(state->interp_M[band*Q*Q]);
+        interp_Mr = &(state->interp_Mr[band*Q*Q]);
+        interp_Mr_cmplx = &(state->interp_Mr_cmplx[band*Q*Q]);
+        for(t=0; t<TIME_SLOTS; t++){
+            scaleC = cmplxf(pData->interpolatorFadeIn[t], 0.0f);
+            utility_cvsmul(state->new_M[band], &scaleC, Q*Q, interp_M);
+            cblas_saxpy(/*re+im*/2*Q*Q, pData->interpolatorFadeOut[t], (float*)state->prev_M[src][band], 1, (float*)interp_M, 1);
+            for(i=0; i<Q; i++) {
+                cblas_cdotu_sub(Q, (float_complex*)(&(interp_M[i*Q])), 1,
+                                FLATTEN2D((a->procMode == SPREADER_MODE_EVD ? pData->decorframeTF[band] : pData->protoframeTF[band])) + t,
+                                TIME_SLOTS_STRIDE, &(pData->spreadframeTF[band][i][t]));
+            }
+        }
+
+        /* Also mix in the residual part */
+        if(a->procMode == SPREADER_MODE_OM){
+            if(pData->freqVector[band]<MAX_SPREAD_FREQ){
+                for(t=0; t<TIME_SLOTS; t++){
+                    utility_svsmul(state->new_Mr[band], &(pData->interpolatorFadeIn[t]), Q*Q, interp_Mr);
+                    cblas_saxpy(Q*Q, pData->interpolatorFadeOut[t], state->prev_Mr[src][band], 1, interp_Mr, 1);
+                    cblas_scopy(Q*Q, interp_Mr, 1, (float*)interp_Mr_cmplx, 2);
+                    for(i=0; i<Q; i++){
+                        cblas_cdotu_sub(Q, (float_complex*)(&(interp_Mr_cmplx[i*Q])), 1, FLATTEN2D(pData->decorframeTF[band]) + t, TIME_SLOTS_STRIDE, &tmp);
+                        pData->spreadframeTF[band][i][t] = ccaddf(pData->spreadframeTF[band][i][t], tmp);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** Processes one frame of #SPREADER_FRAME_SIZE samples (see spreader_process()) */
+static void spreader_processFrame
 (
     void        *  const hSpr,
     const float *const * inputs,
@@ -368,10 +444,12 @@ void spreader_process
 )
 {
     spreader_data *pData = (spreader_data*)(hSpr);
-    int q, src, ng, ch, i, j, band, t, nSources, Q, centre_ind, nSpread;
+    spreader_renderState* state;
+    int q, src, ng, ch, i, j, band, nSources, Q, centre_ind, nSpread;
     float trace, Ey, Eproto, Gcomp;
     float src_dirs_deg[SPREADER_MAX_NUM_SOURCES][2], src_dir_xyz[3], CprotoDiag[MAX_NUM_OUTPUTS*MAX_NUM_OUTPUTS], src_spread[MAX_NUM_OUTPUTS];
-    float_complex scaleC, tmp;
+    float_complex sqrtD;
+    spreader_mixArgs mixArgs;
 #if 0
     float_complex Cx[MAX_NUM_OUTPUTS*MAX_NUM_OUTPUTS];
     float CxDiag[MAX_NUM_OUTPUTS*MAX_NUM_OUTPUTS];
@@ -379,16 +457,17 @@ void spreader_process
     SPREADER_PROC_MODES procMode;
     const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
 
-    /* copy user parameters to local variables */
-    procMode = pData->procMode;
-    nSources = pData->nSources;
-    Q = pData->Q;
-    memcpy((float*)src_dirs_deg, pData->src_dirs_deg, nSources*2*sizeof(float));
-    memcpy((float*)src_spread, pData->src_spread, nSources*sizeof(float));
+    /* The current render state remains valid (and untouched by spreader_initCodec()) until it is released */
+    state = (spreader_renderState*)saf_stateSwap_acquire(pData->hStateSwap);
 
     /* apply binaural panner */
-    if ((nSamples == SPREADER_FRAME_SIZE) && (pData->codecStatus==CODEC_STATUS_INITIALISED) ){
-        pData->procStatus = PROC_STATUS_ONGOING;
+    if ((nSamples == SPREADER_FRAME_SIZE) && (state!=NULL)){
+        /* copy user parameters to local variables */
+        procMode = state->procMode;
+        nSources = state->nSources;
+        Q = state->Q;
+        memcpy((float*)src_dirs_deg, pData->src_dirs_deg, nSources*2*sizeof(float));
+        memcpy((float*)src_spread, pData->src_spread, nSources*sizeof(float));
 
         /* Load time-domain data */
         for(i=0; i < SAF_MIN(nSources,nInputs); i++)
@@ -397,23 +476,23 @@ void spreader_process
             memset(pData->inputFrameTD[i], 0, SPREADER_FRAME_SIZE * sizeof(float));
 
         /* Apply time-frequency transform (TFT) */
-        afSTFT_forward_knownDimensions(pData->hSTFT, pData->inputFrameTD, SPREADER_FRAME_SIZE, MAX_NUM_INPUTS, TIME_SLOTS, pData->inputframeTF);
+        afSTFT_forward_knownDimensions(state->hSTFT, pData->inputFrameTD, SPREADER_FRAME_SIZE, MAX_NUM_INPUTS, TIME_SLOTS_STRIDE, pData->inputframeTF);
 
         /* Zero output buffer */
         for(band=0; band<HYBRID_BANDS; band++)
-            memset(FLATTEN2D(pData->outputframeTF[band]), 0, Q*TIME_SLOTS*sizeof(float_complex));
+            memset(FLATTEN2D(pData->outputframeTF[band]), 0, Q*TIME_SLOTS_STRIDE*sizeof(float_complex));
 
         /* Loop over sources */
         for(src=0; src<nSources; src++){
             /* Find the "spread" indices */
             unitSph2cart(src_dirs_deg[src], 1, 1, src_dir_xyz);
-            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, pData->nGrid, 1, 3, 1.0f,
-                        pData->grid_dirs_xyz, 3,
+            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, state->nGrid, 1, 3, 1.0f,
+                        state->grid_dirs_xyz, 3,
                         src_dir_xyz, 1, 0.0f,
-                        pData->angles, 1);
-            for(i=0; i<pData->nGrid; i++)
-                pData->angles[i] = acosf(SAF_MIN(pData->angles[i], 0.9999999f))*180.0f/SAF_PI;
-            utility_siminv(pData->angles, pData->nGrid, &centre_ind);
+                        state->angles, 1);
+            for(i=0; i<state->nGrid; i++)
+                state->angles[i] = acosf(SAF_MIN(state->angles[i], 0.9999999f))*180.0f/SAF_PI;
+            utility_siminv(state->angles, state->nGrid, &centre_ind);
 
             /* Define Prototype signals */
              switch(procMode){
@@ -423,15 +502,15 @@ void spreader_process
                         if(pData->freqVector[band]<MAX_SPREAD_FREQ){
                             /* Loop over all angles, and sum the H_grid's within the spreading area */
                             memset(pData->_H_tmp, 0, Q*sizeof(float_complex));
-                            for(ng=0,nSpread=0; ng<pData->nGrid; ng++){
-                                if(pData->angles[ng] <= (src_spread[src]/2.0f)){
+                            for(ng=0,nSpread=0; ng<state->nGrid; ng++){
+                                if(state->angles[ng] <= (src_spread[src]/2.0f)){
                                     for(q=0; q<Q; q++)
-                                        pData->_H_tmp[q] = ccaddf(pData->_H_tmp[q], pData->H_grid[band*Q*pData->nGrid + q*pData->nGrid + ng]);
+                                        pData->_H_tmp[q] = ccaddf(pData->_H_tmp[q], state->H_grid[band*Q*state->nGrid + q*state->nGrid + ng]);
                                     nSpread++;
-                                    pData->dirActive[src][ng] = 1;
+                                    state->dirActive[src][ng] = 1;
                                 }
                                 else
-                                    pData->dirActive[src][ng] = 0;
+                                    state->dirActive[src][ng] = 0;
                             }
                         }
                         else
@@ -440,7 +519,7 @@ void spreader_process
                         /* If no directions found in the spread area, then just include the nearest one */
                         if(nSpread==0){
                             for(q=0; q<Q; q++)
-                                pData->_H_tmp[q] = pData->H_grid[band*Q*pData->nGrid + q*pData->nGrid + centre_ind];
+                                pData->_H_tmp[q] = state->H_grid[band*Q*state->nGrid + q*state->nGrid + centre_ind];
                             nSpread=1;
                         }
 
@@ -448,10 +527,10 @@ void spreader_process
                         cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, Q, TIME_SLOTS, 1, &calpha,
                                     pData->_H_tmp, 1,
                                     pData->inputframeTF[band][src], TIME_SLOTS, &cbeta,
-                                    FLATTEN2D(pData->protoframeTF[band]), TIME_SLOTS);
+                                    FLATTEN2D(pData->protoframeTF[band]), TIME_SLOTS_STRIDE);
 
                         /* Scale by number of spreading directions */
-                        cblas_sscal(/*re+im*/2*Q*TIME_SLOTS, 1.0f/(float)nSpread, (float*)FLATTEN2D(pData->protoframeTF[band]), 1);
+                        cblas_sscal(/*re+im*/2*Q*TIME_SLOTS_STRIDE, 1.0f/(float)nSpread, (float*)FLATTEN2D(pData->protoframeTF[band]), 1);
                     }
                     break;
 #if 0
@@ -459,11 +538,11 @@ void spreader_process
                      /* Use the centre direction as the prototype */
                      for(band=0; band<HYBRID_BANDS; band++){
                          for(q=0; q<Q; q++)
-                             H_tmp[q] = pData->H_grid[band*Q*pData->nGrid + q*pData->nGrid + centre_ind];
+                             H_tmp[q] = state->H_grid[band*Q*state->nGrid + q*state->nGrid + centre_ind];
                          cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, Q, TIME_SLOTS, 1, &calpha,
                                      H_tmp, 1,
                                      pData->inputframeTF[band][src], TIME_SLOTS, &cbeta,
-                                     FLATTEN2D(pData->protoframeTF[band]), TIME_SLOTS);
+                                     FLATTEN2D(pData->protoframeTF[band]), TIME_SLOTS_STRIDE);
                      }
                      break;
 #endif
@@ -480,20 +559,20 @@ void spreader_process
             if(procMode==SPREADER_MODE_NAIVE) {
                 /* If naive mode, then we're already done... */
                 for(band=0; band<HYBRID_BANDS; band++)
-                    memcpy(FLATTEN2D(pData->spreadframeTF[band]), FLATTEN2D(pData->protoframeTF[band]), Q*TIME_SLOTS*sizeof(float_complex));
+                    memcpy(FLATTEN2D(pData->spreadframeTF[band]), FLATTEN2D(pData->protoframeTF[band]), Q*TIME_SLOTS_STRIDE*sizeof(float_complex));
             }
             else{
                 /* Apply decorrelation of prototype signals */
-                latticeDecorrelator_apply(pData->hDecor[src], pData->protoframeTF, TIME_SLOTS, pData->decorframeTF);
+                latticeDecorrelator_apply(state->hDecor[src], pData->protoframeTF, TIME_SLOTS, pData->decorframeTF);
 
                 /* Compute prototype covariance matrix and average over time */
                 for(band=0; band<HYBRID_BANDS; band++){
                     cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, Q, Q, TIME_SLOTS, &calpha,
-                                FLATTEN2D(pData->protoframeTF[band]), TIME_SLOTS,
-                                FLATTEN2D(pData->protoframeTF[band]), TIME_SLOTS, &cbeta,
+                                FLATTEN2D(pData->protoframeTF[band]), TIME_SLOTS_STRIDE,
+                                FLATTEN2D(pData->protoframeTF[band]), TIME_SLOTS_STRIDE, &cbeta,
                                 pData->_Cproto, Q);
-                    cblas_sscal(/*re+im*/2*Q*Q, pData->covAvgCoeff, (float*)pData->Cproto[src][band], 1);
-                    cblas_saxpy(/*re+im*/2*Q*Q, 1.0f-pData->covAvgCoeff, (float*)pData->_Cproto, 1, (float*)pData->Cproto[src][band], 1);
+                    cblas_sscal(/*re+im*/2*Q*Q, pData->covAvgCoeff, (float*)state->Cproto[src][band], 1);
+                    cblas_saxpy(/*re+im*/2*Q*Q, 1.0f-pData->covAvgCoeff, (float*)pData->_Cproto, 1, (float*)state->Cproto[src][band], 1);
                 }
 
                 /* Define target covariance matrices */
@@ -502,16 +581,16 @@ void spreader_process
                     if(pData->freqVector[band]<MAX_SPREAD_FREQ){
                         memset(pData->_Cy, 0, Q*Q*sizeof(float_complex));
                         memset(pData->_H_tmp, 0, Q*sizeof(float_complex));
-                        for(ng=0, nSpread=0; ng<pData->nGrid; ng++){
-                            if(pData->angles[ng] <= (src_spread[src]/2.0f)){
-                                cblas_caxpy(Q*Q, &calpha, pData->HHH[band][ng], 1, pData->_Cy, 1);
+                        for(ng=0, nSpread=0; ng<state->nGrid; ng++){
+                            if(state->angles[ng] <= (src_spread[src]/2.0f)){
+                                cblas_caxpy(Q*Q, &calpha, state->HHH[band][ng], 1, pData->_Cy, 1);
                                 for(q=0; q<Q; q++)
-                                    pData->_H_tmp[q] = ccaddf(pData->_H_tmp[q], pData->H_grid[band*Q*pData->nGrid + q*pData->nGrid + ng]);
+                                    pData->_H_tmp[q] = ccaddf(pData->_H_tmp[q], state->H_grid[band*Q*state->nGrid + q*state->nGrid + ng]);
                                 nSpread++;
-                                pData->dirActive[src][ng] = 1;
+                                state->dirActive[src][ng] = 1;
                             }
                             else
-                                pData->dirActive[src][ng] = 0;
+                                state->dirActive[src][ng] = 0;
                         }
                     }
                     else
@@ -519,9 +598,9 @@ void spreader_process
 
                     /* If no directions found in the spread area, then just include the nearest one */
                     if(nSpread==0) {
-                        cblas_caxpy(Q*Q, &calpha, pData->HHH[band][centre_ind], 1, pData->_Cy, 1);
+                        cblas_caxpy(Q*Q, &calpha, state->HHH[band][centre_ind], 1, pData->_Cy, 1);
                         for(q=0; q<Q; q++)
-                            pData->_H_tmp[q] = pData->H_grid[band*Q*pData->nGrid + q*pData->nGrid + centre_ind];
+                            pData->_H_tmp[q] = state->H_grid[band*Q*state->nGrid + q*state->nGrid + centre_ind];
                         nSpread++;
                     }
 #if 1
@@ -535,7 +614,7 @@ void spreader_process
 
                         /* Compute signals for the centre of the spread */
                         for(q=0; q<Q; q++)
-                            pData->_H_tmp[q] = pData->H_grid[band*Q*pData->nGrid + q*pData->nGrid + centre_ind];
+                            pData->_H_tmp[q] = state->H_grid[band*Q*state->nGrid + q*state->nGrid + centre_ind];
                         cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, Q, TIME_SLOTS, 1, &calpha,
                                     pData->_H_tmp, 1,
                                     pData->inputframeTF[band][src], TIME_SLOTS, &cbeta,
@@ -553,8 +632,8 @@ void spreader_process
                     }
 #endif
                     /* Average over time */
-                    cblas_sscal(/*re+im*/2*Q*Q, pData->covAvgCoeff, (float*)pData->Cy[src][band], 1);
-                    cblas_saxpy(/*re+im*/2*Q*Q, 1.0f-pData->covAvgCoeff, (float*)pData->_Cy, 1, (float*)pData->Cy[src][band], 1);
+                    cblas_sscal(/*re+im*/2*Q*Q, pData->covAvgCoeff, (float*)state->Cy[src][band], 1);
+                    cblas_saxpy(/*re+im*/2*Q*Q, 1.0f-pData->covAvgCoeff, (float*)pData->_Cy, 1, (float*)state->Cy[src][band], 1);
                 }
 
                 /* Formulate mixing matrices */
@@ -565,24 +644,24 @@ void spreader_process
                         Ey = Eproto = 0.0f;
                         for(band=0; band<HYBRID_BANDS; band++){
                             for(i=0; i<Q; i++){
-                                Ey += crealf(pData->Cy[src][band][i*Q+i]);
-                                Eproto += crealf(pData->Cproto[src][band][i*Q+i])+0.000001f;
+                                Ey += crealf(state->Cy[src][band][i*Q+i]);
+                                Eproto += crealf(state->Cproto[src][band][i*Q+i])+0.000001f;
                             }
                         }
                         Gcomp = sqrtf(Eproto/(Ey+2.23e-9f));
 
-                        /* Compute mixing matrix per band */
+                        /* EVD of all the (normalised) Cy matrices at once (new_M is used as scratch) */
+                        cblas_ccopy(HYBRID_BANDS*Q*Q, FLATTEN2D(state->Cy[src]), 1, FLATTEN2D(state->new_M), 1);
+                        cblas_sscal(/*re+im*/2*HYBRID_BANDS*Q*Q, Gcomp, (float*)FLATTEN2D(state->new_M), 1);
+                        utility_cseig_batch(state->hCseig, FLATTEN2D(state->new_M), Q, HYBRID_BANDS, 1, state->V_evd, NULL, state->eig_evd);
+
+                        /* Mixing matrix per band: M = V D^(1/2) */
                         for(band=0; band<HYBRID_BANDS; band++){
-                            memcpy(pData->_Cy, pData->Cy[src][band], Q*Q*sizeof(float_complex));
-                            cblas_sscal(/*re+im*/2*Q*Q, Gcomp, (float*)pData->_Cy, 1);
-                            utility_cseig(NULL, pData->_Cy, Q, 1, pData->_V, pData->_D, NULL);
-                            for(i=0; i<Q; i++)
-                                for(j=0; j<Q; j++)
-                                    pData->_D[i*Q+j] = i==j ? csqrtf(pData->_D[i*Q+j]) : cmplxf(0.0f, 0.0f);
-                            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, Q, Q, Q, &calpha,
-                                        pData->_V, Q,
-                                        pData->_D, Q, &cbeta,
-                                        pData->new_M[band], Q);
+                            for(j=0; j<Q; j++){
+                                sqrtD = csqrtf(cmplxf(state->eig_evd[band*Q+j], 0.0f));
+                                for(i=0; i<Q; i++)
+                                    state->new_M[band][i*Q+j] = ccmulf(state->V_evd[band*Q*Q+i*Q+j], sqrtD);
+                            }
                         }
                         break;
 
@@ -591,7 +670,7 @@ void spreader_process
                             if(pData->freqVector[band]<MAX_SPREAD_FREQ){
 #if 1
                                 /* Diagonalise and diagonally load the Cproto matrices */
-                                cblas_ccopy(Q*Q, pData->Cproto[src][band], 1, pData->_Cproto, 1);
+                                cblas_ccopy(Q*Q, state->Cproto[src][band], 1, pData->_Cproto, 1);
                                 for(i=0; i<Q; i++){
                                     for(j=0; j<Q; j++){
                                         if(i==j)
@@ -601,13 +680,13 @@ void spreader_process
                                 }
 
                                 /* Compute mixing matrices */
-                                formulate_M_and_Cr_cmplx(pData->hCdf, pData->_Cproto, pData->Cy[src][band], pData->Qmix_cmplx, 0, 0.2f, pData->new_M[band], pData->Cr_cmplx);
+                                formulate_M_and_Cr_cmplx(state->hCdf, pData->_Cproto, state->Cy[src][band], state->Qmix_cmplx, 0, 0.2f, state->new_M[band], state->Cr_cmplx);
                                 for(i=0; i<Q*Q; i++)
-                                    pData->Cr[i] = crealf(pData->Cr_cmplx[i]);
-                                formulate_M_and_Cr(pData->hCdf_res, CprotoDiag, pData->Cr, pData->Qmix, 0, 0.2f, pData->new_Mr[band], NULL);
+                                    state->Cr[i] = crealf(state->Cr_cmplx[i]);
+                                formulate_M_and_Cr(state->hCdf_res, CprotoDiag, state->Cr, state->Qmix, 0, 0.2f, state->new_Mr[band], NULL);
 #else
                                 for(q=0; q<Q; q++)
-                                    H_tmp[q] = pData->H_grid[band*Q*pData->nGrid + q*pData->nGrid + centre_ind];
+                                    H_tmp[q] = state->H_grid[band*Q*state->nGrid + q*state->nGrid + centre_ind];
                                 cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, Q, Q, 1, &calpha,
                                             H_tmp, 1,
                                             H_tmp, 1, &cbeta,
@@ -617,61 +696,40 @@ void spreader_process
                                     CxDiag[i*Q+i] = crealf(Cx[i*Q+i]);
 
                                 /* Compute mixing matrices */
-                                formulate_M_and_Cr_cmplx(pData->hCdf, Cx, pData->Cy[src][band], pData->Qmix_cmplx, 0, 0.2f, pData->new_M[band], pData->Cr_cmplx);
+                                formulate_M_and_Cr_cmplx(state->hCdf, Cx, state->Cy[src][band], state->Qmix_cmplx, 0, 0.2f, state->new_M[band], state->Cr_cmplx);
                                 for(i=0; i<Q*Q; i++)
-                                    pData->Cr[i] = crealf(pData->Cr_cmplx[i]);
-                                formulate_M_and_Cr(pData->hCdf_res, CxDiag, pData->Cr, pData->Qmix, 0, 0.2f, pData->new_Mr[band], NULL);
+                                    state->Cr[i] = crealf(state->Cr_cmplx[i]);
+                                formulate_M_and_Cr(state->hCdf_res, CxDiag, state->Cr, state->Qmix, 0, 0.2f, state->new_Mr[band], NULL);
 #endif
                             }
                             else{
-                                memcpy(pData->new_M[band], pData->Qmix_cmplx, Q*Q*sizeof(float_complex));
-                                memset(pData->new_Mr[band], 0, Q*Q*sizeof(float));
+                                memcpy(state->new_M[band], state->Qmix_cmplx, Q*Q*sizeof(float_complex));
+                                memset(state->new_Mr[band], 0, Q*Q*sizeof(float));
                             }
                         }
                         break;
                 }
 
-                /* Apply mixing matrices */
-                for(band=0; band<HYBRID_BANDS; band++){
-                    for(t=0; t<TIME_SLOTS; t++){
-                        scaleC = cmplxf(pData->interpolatorFadeIn[t], 0.0f);
-                        utility_cvsmul(pData->new_M[band], &scaleC, Q*Q, pData->interp_M);
-                        cblas_saxpy(/*re+im*/2*Q*Q, pData->interpolatorFadeOut[t], (float*)pData->prev_M[src][band], 1, (float*)pData->interp_M, 1);
-                        for(i=0; i<Q; i++) {
-                            cblas_cdotu_sub(Q, (float_complex*)(&(pData->interp_M[i*Q])), 1,
-                                            FLATTEN2D((procMode == SPREADER_MODE_EVD ? pData->decorframeTF[band] : pData->protoframeTF[band])) + t,
-                                            TIME_SLOTS, &(pData->spreadframeTF[band][i][t]));
-                        }
-                    }
-
-                    /* Also mix in the residual part */
-                    if(procMode == SPREADER_MODE_OM){
-                        if(pData->freqVector[band]<MAX_SPREAD_FREQ){
-                            for(t=0; t<TIME_SLOTS; t++){
-                                utility_svsmul(pData->new_Mr[band], &(pData->interpolatorFadeIn[t]), Q*Q, pData->interp_Mr);
-                                cblas_saxpy(Q*Q, pData->interpolatorFadeOut[t], pData->prev_Mr[src][band], 1, pData->interp_Mr, 1);
-                                cblas_scopy(Q*Q, pData->interp_Mr, 1, (float*)pData->interp_Mr_cmplx, 2);
-                                for(i=0; i<Q; i++){
-                                    cblas_cdotu_sub(Q, (float_complex*)(&(pData->interp_Mr_cmplx[i*Q])), 1, FLATTEN2D(pData->decorframeTF[band]) + t, TIME_SLOTS, &tmp);
-                                    pData->spreadframeTF[band][i][t] = ccaddf(pData->spreadframeTF[band][i][t], tmp);
-                                }
-                            }
-                        }
-                    }
-                }
+                /* Apply mixing matrices, with the bands split across the thread pool */
+                mixArgs.pData = pData;
+                mixArgs.state = state;
+                mixArgs.src = src;
+                mixArgs.Q = Q;
+                mixArgs.procMode = procMode;
+                saf_threadPool_parallelFor(state->hThreadPool, HYBRID_BANDS, spreader_mixBands, (void*)&mixArgs);
             }
 
             /* Add the spread frame to the output frame, then move onto the next source... */
             for(band=0; band<HYBRID_BANDS; band++)
-                cblas_saxpy(/*re+im*/2*Q*TIME_SLOTS, 1.0f, (float*)FLATTEN2D(pData->spreadframeTF[band]), 1, (float*)FLATTEN2D(pData->outputframeTF[band]), 1);
+                cblas_saxpy(/*re+im*/2*Q*TIME_SLOTS_STRIDE, 1.0f, (float*)FLATTEN2D(pData->spreadframeTF[band]), 1, (float*)FLATTEN2D(pData->outputframeTF[band]), 1);
 
             /* For next frame */
-            cblas_ccopy(HYBRID_BANDS*Q*Q, FLATTEN2D(pData->new_M), 1, FLATTEN2D(pData->prev_M[src]), 1);
-            cblas_scopy(HYBRID_BANDS*Q*Q, FLATTEN2D(pData->new_Mr), 1, FLATTEN2D(pData->prev_Mr[src]), 1);
+            cblas_ccopy(HYBRID_BANDS*Q*Q, FLATTEN2D(state->new_M), 1, FLATTEN2D(state->prev_M[src]), 1);
+            cblas_scopy(HYBRID_BANDS*Q*Q, FLATTEN2D(state->new_Mr), 1, FLATTEN2D(state->prev_Mr[src]), 1);
         }
 
         /* inverse-TFT */
-        afSTFT_backward_knownDimensions(pData->hSTFT, pData->outputframeTF, SPREADER_FRAME_SIZE, MAX_NUM_OUTPUTS, TIME_SLOTS, pData->outframeTD);
+        afSTFT_backward_knownDimensions(state->hSTFT, pData->outputframeTF, SPREADER_FRAME_SIZE, MAX_NUM_OUTPUTS, TIME_SLOTS_STRIDE, pData->outframeTD);
 
         /* Copy to output buffer */
         for (ch = 0; ch < SAF_MIN(Q, nOutputs); ch++)
@@ -684,7 +742,23 @@ void spreader_process
             memset(outputs[ch],0, SPREADER_FRAME_SIZE*sizeof(float));
     }
 
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    saf_stateSwap_release(pData->hStateSwap);
+}
+
+void spreader_process
+(
+    void        *  const hSpr,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
+)
+{
+    spreader_data *pData = (spreader_data*)(hSpr);
+
+    /* Process the host buffers in frames of #SPREADER_FRAME_SIZE samples */
+    saf_blockAdapter_process(pData->hBlockAdapter, inputs, outputs, nInputs, nOutputs, nSamples, spreader_processFrame, hSpr);
 }
 
 /* Set Functions */
@@ -755,6 +829,16 @@ void spreader_setUseDefaultHRIRsflag(void* const hSpr, int newState)
     }
 }
 
+void spreader_setNumThreads(void* const hSpr, int newValue)
+{
+    spreader_data *pData = (spreader_data*)(hSpr);
+    newValue = SAF_CLAMP(newValue, 1, SAF_THREADPOOL_MAX_NUM_FOR_JOBS+1);
+    if(pData->new_nThreads != newValue){
+        pData->new_nThreads = newValue;
+        spreader_setCodecStatus(hSpr, CODEC_STATUS_NOT_INITIALISED);
+    }
+}
+
 void spreader_setSofaFilePath(void* const hSpr, const char* path)
 {
     spreader_data *pData = (spreader_data*)(hSpr);
@@ -776,7 +860,7 @@ int spreader_getFrameSize(void)
 CODEC_STATUS spreader_getCodecStatus(void* const hSpr)
 {
     spreader_data *pData = (spreader_data*)(hSpr);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
 
 float spreader_getProgressBar0_1(void* const hSpr)
@@ -794,7 +878,10 @@ void spreader_getProgressBarText(void* const hSpr, char* text)
 int* spreader_getDirectionActivePtr(void* const hSpr, int index)
 {
     spreader_data *pData = (spreader_data*)(hSpr);
-    return pData->dirActive[index];
+    if(pData->liveState!=NULL)
+        return pData->liveState->dirActive[index];
+    else
+        return NULL;
 }
 
 int spreader_getSpreadingMode(void* const hSpr)
@@ -856,8 +943,8 @@ int spreader_getNDirs(void* const hSpr)
 float spreader_getIRAzi_deg(void* const hSpr, int index)
 {
     spreader_data *pData = (spreader_data*)(hSpr);
-    if(pData->grid_dirs_deg!=NULL)
-        return pData->grid_dirs_deg[index*2+0];
+    if(pData->liveState!=NULL)
+        return pData->liveState->grid_dirs_deg[index*2+0];
     else
         return 0.0f;
 }
@@ -865,8 +952,8 @@ float spreader_getIRAzi_deg(void* const hSpr, int index)
 float spreader_getIRElev_deg(void* const hSpr, int index)
 {
     spreader_data *pData = (spreader_data*)(hSpr);
-    if(pData->grid_dirs_deg!=NULL)
-        return pData->grid_dirs_deg[index*2+1];
+    if(pData->liveState!=NULL)
+        return pData->liveState->grid_dirs_deg[index*2+1];
     else
         return 0.0f;
 }
@@ -889,6 +976,12 @@ int spreader_getUseDefaultHRIRsflag(void* const hSpr)
     return pData->useDefaultHRIRsFLAG;
 }
 
+int spreader_getNumThreads(void* const hSpr)
+{
+    spreader_data *pData = (spreader_data*)(hSpr);
+    return pData->new_nThreads;
+}
+
 char* spreader_getSofaFilePath(void* const hSpr)
 {
     spreader_data *pData = (spreader_data*)(hSpr);
@@ -905,7 +998,8 @@ int spreader_getDAWsamplerate(void* const hSpr)
     return pData->fs;
 }
 
-int spreader_getProcessingDelay()
+int spreader_getProcessingDelay(void* const hSpr)
 {
-    return 12*HOP_SIZE;
+    spreader_data *pData = (spreader_data*)(hSpr);
+    return 12*HOP_SIZE + saf_blockAdapter_getLatency(pData->hBlockAdapter);
 }
@@ -34,19 +34,71 @@
 void spreader_setCodecStatus(void* const hSpr, CODEC_STATUS newStatus)
 {
     spreader_data *pData = (spreader_data*)(hSpr);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
-    }
-    pData->codecStatus = newStatus;
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next spreader_initCodec() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
 }
-  
-
-
-
 
+void spreader_createRenderState(spreader_renderState** const pState)
+{
+    spreader_renderState* state = (spreader_renderState*)malloc1d(sizeof(spreader_renderState));
+    int band, src;
+    *pState = state;
 
+    state->nSources = 0;
+    state->procMode = SPREADER_MODE_OM;
+    state->hSTFT = NULL;
+    state->hThreadPool = NULL;
+    saf_arena_create(&(state->hArena), 0); /* (sized by the first spreader_initCodec() call that uses this state) */
+    state->Q = state->nGrid = 0;
+    state->h_grid = NULL;
+    state->H_grid = NULL;
+    for(band=0; band<HYBRID_BANDS; band++)
+        state->HHH[band] = NULL;
+    state->grid_dirs_deg = NULL;
+    state->grid_dirs_xyz = NULL;
+    state->weights = NULL;
+    state->angles = NULL;
+    for(src=0; src<SPREADER_MAX_NUM_SOURCES; src++){
+        state->hDecor[src] = NULL;
+        state->Cy[src] = NULL;
+        state->Cproto[src] = NULL;
+        state->prev_M[src] = NULL;
+        state->prev_Mr[src] = NULL;
+        state->dirActive[src] = NULL;
+    }
+    state->new_M = NULL;
+    state->new_Mr = NULL;
+    state->interp_M = NULL;
+    state->interp_Mr = NULL;
+    state->interp_Mr_cmplx = NULL;
+    state->hCdf = NULL;
+    state->hCdf_res = NULL;
+    state->hCseig = NULL;
+    state->Qmix = NULL;
+    state->Qmix_cmplx = NULL;
+    state->Cr = NULL;
+    state->Cr_cmplx = NULL;
+    state->V_evd = NULL;
+    state->eig_evd = NULL;
+}
 
+void spreader_destroyRenderState(spreader_renderState** const pState)
+{
+    spreader_renderState* state = *pState;
+    int src;
 
- 
+    if(state!=NULL){
+        if(state->hSTFT!=NULL)
+            afSTFT_destroy(&(state->hSTFT));
+        for(src=0; src<SPREADER_MAX_NUM_SOURCES; src++)
+            latticeDecorrelator_destroy(&(state->hDecor[src]));
+        cdf4sap_cmplx_destroy(&(state->hCdf));
+        cdf4sap_destroy(&(state->hCdf_res));
+        utility_cseig_destroy(&(state->hCseig));
+        saf_arena_destroy(&(state->hArena));
+        free(state);
+        state = NULL;
+        *pState = NULL;
+    }
+}
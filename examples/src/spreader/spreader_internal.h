@@ -55,6 +55,7 @@ extern "C" {
 #define HOP_SIZE ( 128 )                              /**< STFT hop size */
 #define HYBRID_BANDS ( HOP_SIZE + 5 )                 /**< Number of frequency bands */
 #define TIME_SLOTS ( SPREADER_FRAME_SIZE / HOP_SIZE ) /**< Number of STFT timeslots */
+#define TIME_SLOTS_STRIDE ( (int)md_alignedStride(TIME_SLOTS, sizeof(float_complex)) ) /**< Distance between the rows of the time-frequency frames (#TIME_SLOTS, padded to whole cache lines) */
 
 /* Checks: */
 #if (SPREADER_FRAME_SIZE % HOP_SIZE != 0)
@@ -66,28 +67,22 @@ extern "C" {
 /* ========================================================================== */
 
 /**
- * Main structure for spreader. Contains variables for audio buffers,
- * afSTFT, HRTFs, internal variables, flags, user parameters
+ * Everything that spreader_processFrame() needs from an initialisation
+ *
+ * A new render state is built by spreader_initCodec() (while the audio thread
+ * keeps rendering with the current one), and then handed over to the audio
+ * thread via a saf_stateSwap. Once published, only the audio thread may touch
+ * it, until it is handed back by the next initialisation.
  */
-typedef struct _spreader
+typedef struct _spreader_renderState
 {
-    /* audio buffers and time-frequency transform */
-    float** inputFrameTD;              /**< time-domain input frame; #MAX_NUM_INPUTS x #SPREADER_FRAME_SIZE */
-    float** outframeTD;                /**< time-domain output frame; #MAX_NUM_OUTPUTS x #SPREADER_FRAME_SIZE */
-    float_complex*** inputframeTF;     /**< time-frequency domain input frame; #HYBRID_BANDS x #MAX_NUM_INPUTS x #TIME_SLOTS */
-    float_complex*** protoframeTF;     /**< time-frequency domain prototype frame; #HYBRID_BANDS x #MAX_NUM_OUTPUTS x #TIME_SLOTS */
-    float_complex*** decorframeTF;     /**< time-frequency domain decorrelated frame; #HYBRID_BANDS x #MAX_NUM_OUTPUTS x #TIME_SLOTS */
-    float_complex*** spreadframeTF;    /**< time-frequency domain spread frame; #HYBRID_BANDS x #MAX_NUM_OUTPUTS x #TIME_SLOTS */
-    float_complex*** outputframeTF;    /**< time-frequency domain output frame; #HYBRID_BANDS x #MAX_NUM_OUTPUTS x #TIME_SLOTS */
-    int fs;                            /**< Host sampling rate, in Hz */
-    float freqVector[HYBRID_BANDS];    /**< Frequency vector (filterbank centre frequencies) */
-    void* hSTFT;                       /**< afSTFT handle */
-
-    /* Internal */
+    int nSources;                      /**< Number of input signals */
+    SPREADER_PROC_MODES procMode;      /**< See #SPREADER_PROC_MODES */
+    void* hSTFT;                       /**< afSTFT handle (passed on to the next render state, if it has the same number of channels) */
+    void* hThreadPool;                 /**< saf_threadPool handle (owned by spreader_data); NULL if nThreads==1 */
+    void* hArena;                      /**< Arena, from which all of the tables/buffers below (which depend on the configuration) are allocated */
     int Q;                             /**< Number of channels in the target playback setup; for example: 2 for binaural */
     int nGrid;                         /**< Number of directions/measurements/HRTFs etc. */
-    int h_len;                         /**< Length of time-domain filters, in samples */
-    float h_fs;                        /**< Sample rate used to measure the filters */
     float* h_grid;                     /**< FLAT: nGrid x Q x h_len */
     float_complex* H_grid;             /**< FLAT: HYBRID_BANDS x Q x nGrid */
     float_complex** HHH[HYBRID_BANDS]; /**< Pre-computed array outer-products; HYBRID_BANDS x nGrid x FLAT: (Q x Q) */
@@ -102,11 +97,9 @@ typedef struct _spreader
     float** prev_Mr[SPREADER_MAX_NUM_SOURCES];        /**< previous residual mixing matrices; HYBRID_BANDS x FLAT:(Q x Q) */
     float_complex** new_M;             /**< mixing matrices; HYBRID_BANDS x FLAT:(Q x Q) */
     float** new_Mr;                    /**< residual mixing matrices; HYBRID_BANDS x FLAT:(Q x Q) */
-    float_complex* interp_M;           /**< Interpolated mixing matrix; FLAT:(Q x Q) */
-    float* interp_Mr;                  /**< Interpolated residual mixing matrix; FLAT:(Q x Q) */
-    float_complex* interp_Mr_cmplx;    /**< Complex variant of interp_Mr */ 
-    float interpolatorFadeIn[TIME_SLOTS];  /**< Linear Interpolator - Fade in */
-    float interpolatorFadeOut[TIME_SLOTS]; /**< Linear Interpolator - Fade out */
+    float_complex* interp_M;           /**< Interpolated mixing matrices (one per band, so that the bands may be mixed in parallel); FLAT:(HYBRID_BANDS x Q x Q) */
+    float* interp_Mr;                  /**< Interpolated residual mixing matrices; FLAT:(HYBRID_BANDS x Q x Q) */
+    float_complex* interp_Mr_cmplx;    /**< Complex variant of interp_Mr; FLAT:(HYBRID_BANDS x Q x Q) */
 
     /* For visualisation */
     int* dirActive[SPREADER_MAX_NUM_SOURCES]; /**< 1: IR direction currently used for spreading, 0: not */
@@ -114,32 +107,69 @@ typedef struct _spreader
     /* Optimal mixing solution */
     void* hCdf;                        /**< covariance domain framework handle */
     void* hCdf_res;                    /**< covariance domain framework handle for the residual */
+    void* hCseig;                      /**< work handle for utility_cseig_batch() */
+    float_complex* V_evd;              /**< Eigen vectors of Cy, per band; FLAT: HYBRID_BANDS x Q x Q */
+    float* eig_evd;                    /**< Eigen values of Cy, per band; FLAT: HYBRID_BANDS x Q */
     float* Qmix;                       /**< Identity; FLAT: Q x Q */
     float_complex* Qmix_cmplx;         /**< Identity; FLAT: Q x Q */
     float* Cr;                         /**< Residual covariance; FLAT: Q x Q */
     float_complex* Cr_cmplx;           /**< Residual covariance; FLAT: Q x Q */
-    
+
+}spreader_renderState;
+
+/**
+ * Main structure for spreader. Contains variables for audio buffers,
+ * afSTFT, HRTFs, internal variables, flags, user parameters
+ */
+typedef struct _spreader
+{
+    /* audio buffers and time-frequency transform */
+    void* hBlockAdapter;               /**< Block adapter handle (for arbitrary host block sizes) */
+    float** inputFrameTD;              /**< time-domain input frame; #MAX_NUM_INPUTS x #SPREADER_FRAME_SIZE */
+    float** outframeTD;                /**< time-domain output frame; #MAX_NUM_OUTPUTS x #SPREADER_FRAME_SIZE */
+    float_complex*** inputframeTF;     /**< time-frequency domain input frame; #HYBRID_BANDS x #MAX_NUM_INPUTS x #TIME_SLOTS */
+    float_complex*** protoframeTF;     /**< time-frequency domain prototype frame; #HYBRID_BANDS x #MAX_NUM_OUTPUTS x #TIME_SLOTS */
+    float_complex*** decorframeTF;     /**< time-frequency domain decorrelated frame; #HYBRID_BANDS x #MAX_NUM_OUTPUTS x #TIME_SLOTS */
+    float_complex*** spreadframeTF;    /**< time-frequency domain spread frame; #HYBRID_BANDS x #MAX_NUM_OUTPUTS x #TIME_SLOTS */
+    float_complex*** outputframeTF;    /**< time-frequency domain output frame; #HYBRID_BANDS x #MAX_NUM_OUTPUTS x #TIME_SLOTS */
+    int fs;                            /**< Host sampling rate, in Hz */
+    float freqVector[HYBRID_BANDS];    /**< Frequency vector (filterbank centre frequencies) */
+
+    /* Internal */
+    void* hThreadPool;                 /**< saf_threadPool handle, across which the mixing is applied to the frequency bands; NULL if nThreads==1 */
+    int Q;                             /**< Number of channels in the target playback setup of the last built render state */
+    int nGrid;                         /**< Number of directions/measurements/HRTFs etc. of the last built render state */
+    int h_len;                         /**< Length of time-domain filters, in samples */
+    float h_fs;                        /**< Sample rate used to measure the filters */
+    float interpolatorFadeIn[TIME_SLOTS];  /**< Linear Interpolator - Fade in */
+    float interpolatorFadeOut[TIME_SLOTS]; /**< Linear Interpolator - Fade out */
+
     // Hotfix:
     float_complex* _tmpFrame, *_H_tmp, *_Cy;
-    float_complex* _E_dir, *_V, *_D;
+    float_complex* _E_dir;
     float_complex* _Cproto;
  
     /* flags/status */
-    CODEC_STATUS codecStatus;          /**< see #CODEC_STATUS */
+    volatile long codecStatus;         /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;            /**< spin lock, which ensures that only one thread initialises the codec at a time */
     float progressBar0_1;              /**< Current (re)initialisation progress, between [0..1] */
     char* progressBarText;             /**< Current (re)initialisation step, string */
-    PROC_STATUS procStatus;            /**< see #PROC_STATUS */
+    void* hStateSwap;                  /**< saf_stateSwap handle, via which new render states are handed over to the audio thread */
+    spreader_renderState* liveState;   /**< The last published render state (or NULL); read-only, until it is handed back */
+    spreader_renderState* spareState;  /**< The previous render state (or NULL), in which the next one is built */
     int new_nSources;                  /**< New number of input signals (current value will be replaced by this after next re-init) */
     SPREADER_PROC_MODES new_procMode;  /**< See #SPREADER_PROC_MODES (current value will be replaced by this after next re-init) */
+    int new_nThreads;                  /**< New number of processing threads (current value will be replaced by this after next re-init) */
 
     /* user parameters */
-    SPREADER_PROC_MODES procMode;      /**< See #SPREADER_PROC_MODES */
+    SPREADER_PROC_MODES procMode;      /**< See #SPREADER_PROC_MODES (of the last built render state) */
     char* sofa_filepath;               /**< SOFA file path */
-    int nSources;                      /**< Current number of input signals */
+    int nSources;                      /**< Number of input signals of the last built render state */
     float src_spread[SPREADER_MAX_NUM_SOURCES];      /**< Source spreading, in degrees */
     float src_dirs_deg[SPREADER_MAX_NUM_SOURCES][2]; /**< Source directions, in degrees */
     int useDefaultHRIRsFLAG;           /**< 1: use default HRIRs in database, 0: use the measurements from SOFA file (can be anything, not just HRTFs) */
     float covAvgCoeff;                 /**< Covariance matrix averaging coefficient, [0..1] */
+    int nThreads;                      /**< Number of threads, across which the mixing is applied to the frequency bands (including the host thread) */
 
 } spreader_data;
 
@@ -152,6 +182,12 @@ typedef struct _spreader
 void spreader_setCodecStatus(void* const hSpr,
                              CODEC_STATUS newStatus);
 
+/** Creates an (empty) render state; see #spreader_renderState */
+void spreader_createRenderState(spreader_renderState** const pState);
+
+/** Destroys a render state (if not NULL) */
+void spreader_destroyRenderState(spreader_renderState** const pState);
+
 
 #ifdef __cplusplus
 } /* extern "C" { */
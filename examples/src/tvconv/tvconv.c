@@ -37,9 +37,7 @@ void tvconv_create
 
     /* internal values */
     pData->hostBlockSize = -1; /* force initialisation */
-    pData->inputFrameTD = NULL;
-    pData->outputFrameTD = NULL;
-    pData->hTVConv = NULL;
+    pData->hostBlockSize_clamped = MIN_FRAME_SIZE;
     pData->irs = NULL;
     pData->reInitFilters = 1;
     pData->nIrChannels = 0;
@@ -49,13 +47,9 @@ void tvconv_create
     pData->sofa_filepath = NULL;
     pData->sofa_file_error = SAF_TVCONV_NOT_INIT;
 
-    /* set FIFO buffers */
+    /* for passing arbitrary host block sizes through tvconv_processFrame() (created by tvconv_init()) */
     pData->host_fs = 48000.0f;
-    pData->FIFO_idx = 0;
-    pData->inFIFO = (float**)calloc2d(MAX_NUM_CHANNELS, MAX_FRAME_SIZE, sizeof(float));
-    pData->outFIFO = (float**)calloc2d(MAX_NUM_CHANNELS, MAX_FRAME_SIZE, sizeof(float));
-    //memset(FLATTEN2D(pData->inFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
-    //memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
+    pData->hBlockAdapter = NULL;
     
     /* positions */
     pData->listenerPositions = NULL;
@@ -73,7 +67,9 @@ void tvconv_create
     pData->progressBarText = malloc1d(PROGRESSBARTEXT_CHAR_LENGTH*sizeof(char));
     strcpy(pData->progressBarText,"");
     pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    pData->initLock = 0;
+    saf_stateSwap_create(&(pData->hStateSwap));
+    pData->liveState = pData->spareState = NULL;
 }
 
 void tvconv_destroy
@@ -82,20 +78,23 @@ void tvconv_destroy
 )
 {
     tvconv_data* pData = (tvconv_data*)(*phTVCnv);
+    tvconv_renderState *state;
     
     if (pData != NULL){
-        /* not safe to free memory during intialisation/processing loop */
-        while (pData->codecStatus == CODEC_STATUS_INITIALISING ||
-               pData->procStatus == PROC_STATUS_ONGOING){
-            SAF_SLEEP(10);
-        }
-        free(pData->inFIFO);
-        free(pData->outFIFO);
-        free(pData->inputFrameTD);
-        free(pData->outputFrameTD);
+        /* Wait for any on-going initialisation to complete, and then take back the current render state (which also
+         * waits for the processing loop to let go of it) */
+        saf_spinLock_lock(&(pData->initLock));
+        state = (tvconv_renderState*)saf_stateSwap_publish(pData->hStateSwap, NULL);
+        saf_assert(state==pData->liveState, "Unexpected render state");
+        tvconv_destroyRenderState(&state);
+        tvconv_destroyRenderState(&(pData->spareState));
+        saf_stateSwap_destroy(&(pData->hStateSwap));
+
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
         free(pData->irs);
         free(pData->listenerPositions);
-        saf_TVConv_destroy(&(pData->hTVConv));
+        free(pData->sofa_filepath);
+        free(pData->progressBarText);
         free(pData);
         pData = NULL;
         *phTVCnv = NULL;
@@ -116,78 +115,90 @@ void tvconv_init
     if(pData->hostBlockSize != hostBlockSize){
         pData->hostBlockSize = hostBlockSize;
         pData->hostBlockSize_clamped = SAF_CLAMP(pData->hostBlockSize, MIN_FRAME_SIZE, MAX_FRAME_SIZE);
-        pData->reInitFilters = 1;
-        tvconv_setCodecStatus(hTVCnv, CODEC_STATUS_NOT_INITIALISED);
+        saf_atomic_store(&(pData->reInitFilters), 1);
+
+        /* The host blocks are passed through the convolver in frames of hostBlockSize_clamped samples */
+        saf_blockAdapter_destroy(&(pData->hBlockAdapter));
+        saf_blockAdapter_create(&(pData->hBlockAdapter), pData->hostBlockSize_clamped, MAX_NUM_CHANNELS, MAX_NUM_CHANNELS);
+        saf_blockAdapter_reset(pData->hBlockAdapter, pData->hostBlockSize);
     }
     tvconv_checkReInit(hTVCnv);
 }
 
-void tvconv_process
+/** Processes one frame of hostBlockSize_clamped samples (see tvconv_process()) */
+static void tvconv_processFrame
 (
-    void  *  const hTVCnv,
-    float* const* const inputs,
-    float* const* const outputs,
-    int            nInputs,
-    int            nOutputs,
-    int            nSamples
+    void        *  const hTVCnv,
+    const float *const * inputs,
+    float* const*  const outputs,
+    int                  nInputs,
+    int                  nOutputs,
+    int                  nSamples
 )
 {
     tvconv_data *pData = (tvconv_data*)(hTVCnv);
-    int s, ch, i;
+    tvconv_renderState* state;
+    int ch;
     int numInputChannels, numOutputChannels;
- 
-    tvconv_checkReInit(hTVCnv);
-    pData->procStatus = PROC_STATUS_ONGOING;
+
+    /* The current render state remains valid (and untouched by tvconv_checkReInit()) until it is released */
+    state = (tvconv_renderState*)saf_stateSwap_acquire(pData->hStateSwap);
    
     numInputChannels = pData->nInputChannels;
-    numOutputChannels = pData->nOutputChannels;
+    numOutputChannels = state!=NULL ? state->nOutputChannels : 0;
 
-    for(s=0; s<nSamples; s++){
-        /* Load input signals into inFIFO buffer */
-        for(ch=0; ch<SAF_MIN(SAF_MIN(nInputs,numInputChannels),MAX_NUM_CHANNELS); ch++)
-            pData->inFIFO[ch][pData->FIFO_idx] = inputs[ch][s];
+    /* Process frame if a convolver has been created for the current frame size */
+    if (state!=NULL && state->hostBlockSize_clamped == nSamples) {
+        /* Load time-domain data */
+        for(ch=0; ch<SAF_MIN(nInputs,numInputChannels); ch++)
+            utility_svvcopy(inputs[ch], nSamples, state->inputFrameTD[ch]);
         for(; ch<numInputChannels; ch++) /* Zero any channels that were not given */
-            pData->inFIFO[ch][pData->FIFO_idx] = 0.0f;
-
-        /* Pull output signals from outFIFO buffer */
-        for(ch=0; ch<SAF_MIN(SAF_MIN(nOutputs, numOutputChannels),MAX_NUM_CHANNELS); ch++)
-            outputs[ch][s] = pData->outFIFO[ch][pData->FIFO_idx];
-        for(; ch<nOutputs; ch++) /* Zero any extra channels */
-            outputs[ch][s] = 0.0f;
+            memset(state->inputFrameTD[ch], 0, nSamples*sizeof(float));
 
-        /* Increment buffer index */
-        pData->FIFO_idx++;
+        if(state->hTVConv != NULL){
+         saf_TVConv_apply(state->hTVConv,
+                          FLATTEN2D(state->inputFrameTD),
+                          FLATTEN2D(state->outputFrameTD),
+                          SAF_MIN(pData->position_idx, state->nListenerPositions-1));
+        }
+        /* if the convolver has not been created (i.e. no filters have been loaded) then zero the output */
+        else
+            memset(FLATTEN2D(state->outputFrameTD), 0, MAX_NUM_CHANNELS * nSamples*sizeof(float));
 
-        /* Process frame if inFIFO is full and filters are loaded and saf_matrixConv_apply is ready for it */
-        if (pData->FIFO_idx >= pData->hostBlockSize_clamped && pData->reInitFilters == 0 &&
-            pData->codecStatus == CODEC_STATUS_INITIALISED) {
-            pData->FIFO_idx = 0;
+        /* copy signals to output buffer */
+        for(ch=0; ch<SAF_MIN(nOutputs,numOutputChannels); ch++)
+            utility_svvcopy(state->outputFrameTD[ch], nSamples, outputs[ch]);
+        for(; ch<nOutputs; ch++) /* Zero any extra channels */
+            memset(outputs[ch], 0, nSamples*sizeof(float));
+    }
+    else{
+        for(ch=0; ch<nOutputs; ch++)
+            memset(outputs[ch], 0, nSamples*sizeof(float));
+    }
 
-            /* Load time-domain data */
-            for(i=0; i < numInputChannels; i++)
-                utility_svvcopy(pData->inFIFO[i], pData->hostBlockSize_clamped, pData->inputFrameTD[i]);
+    saf_stateSwap_release(pData->hStateSwap);
+}
 
-            if(pData->hTVConv != NULL && pData->ir_length>0){
-             saf_TVConv_apply(pData->hTVConv,
-                              FLATTEN2D(pData->inputFrameTD),
-                              FLATTEN2D(pData->outputFrameTD),
-                              pData->position_idx);
-            }
-            /* if the matrix convolver handle has not been initialised yet (i.e. no filters have been loaded) then zero the output */
-            else
-                memset(FLATTEN2D(pData->outputFrameTD), 0, MAX_NUM_CHANNELS * (pData->hostBlockSize_clamped)*sizeof(float));
-            
-            /* copy signals to output buffer */
-            for (i = 0; i < SAF_MIN(numOutputChannels, MAX_NUM_CHANNELS); i++)
-                utility_svvcopy(pData->outputFrameTD[i], pData->hostBlockSize_clamped, pData->outFIFO[i]);
-        }
-        else if(pData->FIFO_idx >= pData->hostBlockSize_clamped){
-            /* clear outFIFO if codec was not ready */
-            pData->FIFO_idx = 0;
-            memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
-        }
+void tvconv_process
+(
+    void  *  const hTVCnv,
+    float* const* const inputs,
+    float* const* const outputs,
+    int            nInputs,
+    int            nOutputs,
+    int            nSamples
+)
+{
+    tvconv_data *pData = (tvconv_data*)(hTVCnv);
+    int ch;
+
+    /* Process the host buffers in frames of hostBlockSize_clamped samples (once tvconv_init() has been called) */
+    if(pData->hBlockAdapter != NULL)
+        saf_blockAdapter_process(pData->hBlockAdapter, (const float* const*)inputs, outputs, nInputs, nOutputs, nSamples, tvconv_processFrame, hTVCnv);
+    else{
+        for(ch=0; ch<nOutputs; ch++)
+            memset(outputs[ch], 0, nSamples*sizeof(float));
     }
-    pData->procStatus = PROC_STATUS_NOT_ONGOING;
 }
 
 
@@ -196,48 +207,58 @@ void tvconv_process
 void tvconv_refreshParams(void* const hTVCnv)
 {
     tvconv_data *pData = (tvconv_data*)(hTVCnv);
-    pData->reInitFilters = 1;
-    //tvconv_setCodecStatus(hTVCnv, CODEC_STATUS_NOT_INITIALISED);
+    saf_atomic_store(&(pData->reInitFilters), 1);
+    tvconv_checkReInit(hTVCnv);
 }
 
 void tvconv_checkReInit(void* const hTVCnv)
 {
     tvconv_data *pData = (tvconv_data*)(hTVCnv);
+    tvconv_renderState* state;
     
-    while (pData->procStatus == CODEC_STATUS_INITIALISING){
-        SAF_SLEEP(10);
-    }
     /* reinitialise if needed */
-    if ((pData->reInitFilters == 1) && (pData->irs != NULL)) {
-        pData->reInitFilters = 2;
-        saf_TVConv_destroy(&(pData->hTVConv));
-        pData->hTVConv = NULL;
-        /* if length of the loaded sofa file was not divisable by the specified number of inputs, then the handle remains NULL,
-         * and no convolution is applied */
-        pData->hostBlockSize_clamped = SAF_CLAMP(pData->hostBlockSize, MIN_FRAME_SIZE, MAX_FRAME_SIZE);
-        if(pData->ir_length>0){
-            saf_TVConv_create(&(pData->hTVConv),
-                              pData->hostBlockSize_clamped,
-                              pData->irs,
-                              pData->ir_length,
-                              pData->nListenerPositions,
-                              pData->nOutputChannels,
-                              pData->position_idx);
-        }
+    if (saf_atomic_load(&(pData->reInitFilters)) != 1)
+        return;
+    saf_spinLock_lock(&(pData->initLock));
+    if ((pData->irs == NULL) || !saf_atomic_compareExchange(&(pData->reInitFilters), 1, 2)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* no filters loaded yet, or another thread has just done it */
+    }
 
-        /* Resize buffers */
-        pData->inputFrameTD  = (float**)realloc2d((void**)pData->inputFrameTD, MAX_NUM_CHANNELS, pData->hostBlockSize_clamped, sizeof(float));
-        pData->outputFrameTD = (float**)realloc2d((void**)pData->outputFrameTD, MAX_NUM_CHANNELS, pData->hostBlockSize_clamped, sizeof(float));
-        memset(FLATTEN2D(pData->inputFrameTD), 0, MAX_NUM_CHANNELS*(pData->hostBlockSize_clamped)*sizeof(float));
+    /* The new render state is built in the spare one, while the audio thread keeps rendering with the current one */
+    if(pData->spareState==NULL)
+        tvconv_createRenderState(&(pData->spareState));
+    state = pData->spareState;
+
+    /* if length of the loaded sofa file was not divisable by the specified number of inputs, then the handle remains NULL,
+     * and no convolution is applied */
+    saf_TVConv_destroy(&(state->hTVConv));
+    state->hostBlockSize_clamped = pData->hostBlockSize_clamped;
+    state->nOutputChannels = pData->nOutputChannels;
+    state->nListenerPositions = pData->nListenerPositions;
+    if(pData->ir_length>0){
+        saf_TVConv_create(&(state->hTVConv),
+                          state->hostBlockSize_clamped,
+                          pData->irs,
+                          pData->ir_length,
+                          pData->nListenerPositions,
+                          pData->nOutputChannels,
+                          pData->position_idx);
+    }
 
-        /* reset FIFO buffers */
-        pData->FIFO_idx = 0;
-        memset(FLATTEN2D(pData->inFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
-        memset(FLATTEN2D(pData->outFIFO), 0, MAX_NUM_CHANNELS*MAX_FRAME_SIZE*sizeof(float));
+    /* Resize buffers */
+    state->inputFrameTD  = (float**)realloc2d((void**)state->inputFrameTD, MAX_NUM_CHANNELS, state->hostBlockSize_clamped, sizeof(float));
+    state->outputFrameTD = (float**)realloc2d((void**)state->outputFrameTD, MAX_NUM_CHANNELS, state->hostBlockSize_clamped, sizeof(float));
+    memset(FLATTEN2D(state->inputFrameTD), 0, MAX_NUM_CHANNELS*(state->hostBlockSize_clamped)*sizeof(float));
 
-        pData->reInitFilters = 0;
-        pData->codecStatus = CODEC_STATUS_INITIALISED;
-    }
+    /* Hand the new render state over to the audio thread, and keep the previous one as the spare, once it is no longer
+     * being used */
+    pData->spareState = (tvconv_renderState*)saf_stateSwap_publish(pData->hStateSwap, (void*)state);
+    pData->liveState = state;
+
+    /* done! (unless a refresh was requested in the meantime, in which case the flag is left raised) */
+    saf_atomic_compareExchange(&(pData->reInitFilters), 2, 0);
+    saf_spinLock_unlock(&(pData->initLock));
 }
 
 void tvconv_setFiltersAndPositions( void* const hTVCnv )
@@ -250,16 +271,16 @@ void tvconv_setFiltersAndPositions( void* const hTVCnv )
     saf_sofa_container sofa;
 #endif
     
-    if (pData->codecStatus != CODEC_STATUS_NOT_INITIALISED)
+    if (saf_atomic_load(&(pData->codecStatus)) != CODEC_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
-    while (pData->procStatus == PROC_STATUS_ONGOING){
-        /* re-init required, but we need to wait for the current processing loop to end */
-        pData->codecStatus = CODEC_STATUS_INITIALISING; /* indicate that we want to init */
-        SAF_SLEEP(10);
+    saf_spinLock_lock(&(pData->initLock));
+    if (!saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_NOT_INITIALISED, CODEC_STATUS_INITIALISING)){
+        saf_spinLock_unlock(&(pData->initLock));
+        return; /* another thread has just done it */
     }
     
-    /* for progress bar */
-    pData->codecStatus = CODEC_STATUS_INITIALISING;
+    /* for progress bar (the filters and positions are only touched with the initLock held, and the audio thread keeps
+     * rendering with the current render state in the meantime) */
     strcpy(pData->progressBarText,"Initialising");
     pData->progressBar0_1 = 0.0f;
 
@@ -317,8 +338,8 @@ void tvconv_setFiltersAndPositions( void* const hTVCnv )
                 pData->sofa_file_error = SAF_TVCONV_SOFA_ERROR_NETCDF_IN_USE;
                 break;
         }
+        saf_sofa_close(&sofa);
     }
-    saf_sofa_close(&sofa);
     pData->nOutputChannels = SAF_MIN(pData->nIrChannels, MAX_NUM_CHANNELS);
     tvconv_setMinMaxDimensions(hTVCnv);
 #else
@@ -327,21 +348,25 @@ void tvconv_setFiltersAndPositions( void* const hTVCnv )
 #endif
 
     pData->position_idx = 0;
-    pData->codecStatus = CODEC_STATUS_INITIALISED;
-    pData->reInitFilters = 1;
+    saf_atomic_store(&(pData->reInitFilters), 1);
     
-    /* done! */
+    /* done! (unless a new file was set in the meantime, in which case the codec is left uninitialised) */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
+    saf_atomic_compareExchange(&(pData->codecStatus), CODEC_STATUS_INITIALISING, CODEC_STATUS_INITIALISED);
+    saf_spinLock_unlock(&(pData->initLock));
+
+    /* Create the convolver for the new filters, and hand it over to the audio thread */
+    tvconv_checkReInit(hTVCnv);
 }
 
 void tvconv_setSofaFilePath(void* const hTVCnv, const char* path)
 {
     tvconv_data *pData = (tvconv_data*)(hTVCnv);
     pData->sofa_file_error = SAF_TVCONV_SOFA_LOADING;
-    pData->sofa_filepath = malloc1d(strlen(path) + 1);
+    pData->sofa_filepath = realloc1d(pData->sofa_filepath, strlen(path) + 1);
     strcpy(pData->sofa_filepath, path);
-    pData->codecStatus = CODEC_STATUS_NOT_INITIALISED;
+    tvconv_setCodecStatus(hTVCnv, CODEC_STATUS_NOT_INITIALISED);
     tvconv_setFiltersAndPositions(hTVCnv);
 
 }
@@ -384,13 +409,13 @@ int tvconv_getNumListenerPositions(void* const hTVCnv)
 {
     tvconv_data *pData = (tvconv_data*)(hTVCnv);
 
-    return pData->codecStatus==CODEC_STATUS_INITIALISED ? pData->nListenerPositions : 0;
+    return saf_atomic_load(&(pData->codecStatus))==CODEC_STATUS_INITIALISED ? pData->nListenerPositions : 0;
 }
 
 float tvconv_getListenerPosition(void* const hTVCnv, int index, int dim)
 {
     tvconv_data *pData = (tvconv_data*)(hTVCnv);
-    return pData->codecStatus==CODEC_STATUS_INITIALISED ? pData->listenerPositions[index][dim] : 0.0f;
+    return saf_atomic_load(&(pData->codecStatus))==CODEC_STATUS_INITIALISED ? pData->listenerPositions[index][dim] : 0.0f;
 }
 
 int tvconv_getListenerPositionIdx(void* const hTVCnv)
@@ -448,7 +473,7 @@ int tvconv_getHostFs(void* const hTVCnv)
 int tvconv_getProcessingDelay(void* const hTVCnv)
 {
     tvconv_data *pData = (tvconv_data*)(hTVCnv);
-    return pData->hostBlockSize_clamped;
+    return pData->hBlockAdapter != NULL ? saf_blockAdapter_getLatency(pData->hBlockAdapter) : 0;
 }
 
 char* tvconv_getSofaFilePath(void* const hTVCnv)
@@ -469,5 +494,5 @@ SAF_TVCONV_ERROR_CODES tvconv_getSofaErrorState(void* const hTVCnv)
 CODEC_STATUS tvconv_getCodecStatus(void* const hTVCnv)
 {
     tvconv_data *pData = (tvconv_data*)(hTVCnv);
-    return pData->codecStatus;
+    return (CODEC_STATUS)saf_atomic_load(&(pData->codecStatus));
 }
@@ -26,12 +26,36 @@
 void tvconv_setCodecStatus(void* const hTVCnv, CODEC_STATUS newStatus)
 {
     tvconv_data *pData = (tvconv_data*)(hTVCnv);
-    if(newStatus==CODEC_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->codecStatus == CODEC_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+    /* No need to wait for an on-going initialisation to complete; it will see that the status has changed, and leave
+     * the codec uninitialised, so that the next tvconv_setFiltersAndPositions() call picks up the new parameters */
+    saf_atomic_store(&(pData->codecStatus), (long)newStatus);
+}
+
+void tvconv_createRenderState(tvconv_renderState** const pState)
+{
+    tvconv_renderState* state = (tvconv_renderState*)malloc1d(sizeof(tvconv_renderState));
+    *pState = state;
+
+    state->hTVConv = NULL;
+    state->hostBlockSize_clamped = 0;
+    state->nOutputChannels = 0;
+    state->nListenerPositions = 0;
+    state->inputFrameTD = NULL;
+    state->outputFrameTD = NULL;
+}
+
+void tvconv_destroyRenderState(tvconv_renderState** const pState)
+{
+    tvconv_renderState* state = *pState;
+
+    if(state!=NULL){
+        saf_TVConv_destroy(&(state->hTVConv));
+        free(state->inputFrameTD);
+        free(state->outputFrameTD);
+        free(state);
+        state = NULL;
+        *pState = NULL;
     }
-    pData->codecStatus = newStatus;
 }
 
 void tvconv_findNearestNeigbour(void* const hTVCnv)
@@ -51,24 +51,36 @@ extern "C" {
 /** Structure for a vector */
 typedef float vectorND[NUM_DIMENSIONS];
 
+/**
+ * Everything that tvconv_process() needs from an initialisation
+ *
+ * A new render state is built by tvconv_checkReInit() (while the audio thread
+ * keeps rendering with the current one), and then handed over to the audio
+ * thread via a saf_stateSwap. Once published, only the audio thread may touch
+ * it, until it is handed back by the next initialisation.
+ */
+typedef struct _tvconv_renderState
+{
+    void* hTVConv;             /**< saf_TVConv handle; NULL if no filters are loaded */
+    int hostBlockSize_clamped; /**< Frame size that hTVConv was created for */
+    int nOutputChannels;       /**< number of output channels */
+    int nListenerPositions;    /**< number of listener positions that hTVConv was created with */
+    float** inputFrameTD;      /**< #MAX_NUM_CHANNELS x hostBlockSize_clamped */
+    float** outputFrameTD;     /**< #MAX_NUM_CHANNELS x hostBlockSize_clamped */
+
+} tvconv_renderState;
+
 /** Main structure for tvconv  */
 typedef struct _tvconv
 {
-    /* FIFO buffers */
-    int FIFO_idx;
-    float** inFIFO;
-    float** outFIFO;
-
-    /* Internal buffers */
-    float** inputFrameTD;
-    float** outputFrameTD;
+    /* Block adapter */
+    void* hBlockAdapter;   /**< Block adapter handle (for arbitrary host block sizes); frame size: hostBlockSize_clamped */
     
     /* internal */
-    void* hTVConv;     /**< saf_TVConv handle */
     int hostBlockSize;     /**< current host block size */
     int hostBlockSize_clamped; /**< Clamped between MIN and #MAX_FRAME_SIZE */
     int host_fs;           /**< current samplerate of the host */
-    int reInitFilters;     /**< FLAG: 0: do not reinit, 1: reinit, 2: reinit in progress */
+    volatile long reInitFilters; /**< FLAG: 0: do not reinit, 1: reinit, 2: reinit in progress (only accessed via the saf_atomic functions) */
     int nOutputChannels;   /**< number of output channels (same as the number of channels in the loaded wav) */
     
     int ir_fs;
@@ -85,10 +97,13 @@ typedef struct _tvconv
     vectorND sourcePosition;
     
     /* flags/status */
-    CODEC_STATUS codecStatus;
+    volatile long codecStatus;     /**< see #CODEC_STATUS (only accessed via the saf_atomic functions) */
+    volatile long initLock;        /**< spin lock, which ensures that only one thread loads filters or initialises at a time */
     float progressBar0_1;
     char* progressBarText;
-    PROC_STATUS procStatus;
+    void* hStateSwap;                /**< saf_stateSwap handle, via which new render states are handed over to the audio thread */
+    tvconv_renderState* liveState;   /**< The last published render state (or NULL); read-only, until it is handed back */
+    tvconv_renderState* spareState;  /**< The previous render state (or NULL), in which the next one is built */
     
     /* user parameters */
     int nInputChannels;        /**< number of input channels */
@@ -105,6 +120,13 @@ typedef struct _tvconv
 /** Sets codec status (see #CODEC_STATUS enum) */
 void tvconv_setCodecStatus(void* const hTVCnv,
                                  CODEC_STATUS newStatus);
+
+/** Creates an (empty) render state; see #tvconv_renderState */
+void tvconv_createRenderState(tvconv_renderState** const pState);
+
+/** Destroys a render state (if not NULL) */
+void tvconv_destroyRenderState(tvconv_renderState** const pState);
+
 /** Finds the index holding the nearest neigbour to the selected position */
 void tvconv_findNearestNeigbour(void* const hTVCnv);
 
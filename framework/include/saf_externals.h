@@ -53,9 +53,7 @@
  *   FFTW may be optionally employed with the flag: SAF_USE_FFTW
  *
  *   SIMD intrinsics utilisation may be enabled with: SAF_ENABLE_SIMD
- *    - SSE/SSE2/SSE3 intrinsics are used by default
- *    - AVX/AVX2 intrinsics are enabled with compiler flag: -mavx2
- *    - AVX-512  intrinsics are enabled with compiler flag: -mavx512f
+ *    - SSE/SSE2/SSE3, AVX/AVX2, and AVX-512 kernels are selected at run-time
  *   (Note that intrinsics require a CPU that supports them)
  *
  * @author Leo McCormack
@@ -246,29 +244,22 @@ extern "C" {
  * back option(s).
  * SIMD accelerated fall-back options may be enabled with: SAF_ENABLE_SIMD
  *
- * By default SSE, SSE2, and SSE3 intrinsics are employed, unless one of the
- * following compiler flags are given:
- *    - AVX/AVX2 intrinsics are enabled with: -mavx2
- *    - AVX-512  intrinsics are enabled with: -mavx512f
+ * The SIMD kernels are compiled for SSE3, AVX2, and AVX-512 (no additional
+ * compiler flags are required), and the widest variant supported by the host
+ * CPU is selected at run-time; see saf_getSIMDLevel(). Therefore, the same
+ * binary may be deployed on any x86_64 machine.
  *
- * Note that intrinsics require a CPU that supports them (x86_64 architecture)
  * To find out which SIMD intrinsics are supported by your own CPU, use the
  * following terminal command on macOS: $ sysctl -a | grep machdep.cpu.features
  * Or on Linux, use: $ lscpu
  */
-# if (defined(__AVX__) && defined(__AVX2__)) || defined(__AVX512F__)
-/*
- * Note that AVX/AVX2 requires the '-mavx2' compiler flag
- * Whereas AVX-512 requires the '-mavx512f' compiler flag
- */
-#  include <immintrin.h> /* for AVX, AVX2, and/or AVX-512 */
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-#  include <xmmintrin.h>  /* for SSE  */
-#  include <emmintrin.h>  /* for SSE2 */
-#  include <pmmintrin.h>  /* for SSE3 */
+# if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  include <immintrin.h> /* for SSE, SSE2, SSE3, AVX, AVX2, and AVX-512 */
+#  if defined(_MSC_VER)
+#   include <intrin.h>   /* for __cpuid() */
+#  endif
 # else
-#  error SAF_ENABLE_SIMD requires at least SSE, SSE2 and SSE3 support
+#  error SAF_ENABLE_SIMD requires an x86 CPU (x86_64 architecture)
 # endif
 #endif
 
@@ -336,16 +327,8 @@ extern "C" {
 /* Status of SIMD intrinsics */
 #if defined(SAF_ENABLE_SIMD)
 # define SAF_SIMD_STATUS_STRING "Enabled"
-/* Which SIMD intrinsics are currently enabled? */
-# if defined(__AVX512F__)
-#  define SAF_ENABLED_SIMD_INTRINSICS_STRING "SSE, SSE2, SSE3, AVX, AVX2, AVX512F"
-# elif defined(__AVX__) && defined(__AVX2__)
-#  define SAF_ENABLED_SIMD_INTRINSICS_STRING "SSE, SSE2, SSE3, AVX, AVX2"
-# elif defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-#  define SAF_ENABLED_SIMD_INTRINSICS_STRING "SSE, SSE2, SSE3"
-# else
-#  define SAF_ENABLED_SIMD_INTRINSICS_STRING "None"
-# endif
+/* Which SIMD intrinsics may be employed? (selected at run-time) */
+# define SAF_ENABLED_SIMD_INTRINSICS_STRING "SSE, SSE2, SSE3, AVX, AVX2, AVX512F (run-time dispatch)"
 #else
 # define SAF_SIMD_STATUS_STRING "Disabled"
 # define SAF_ENABLED_SIMD_INTRINSICS_STRING "None"
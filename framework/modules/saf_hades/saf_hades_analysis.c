@@ -96,19 +96,14 @@ void hades_analysis_create
 
     /* Initialise time-frequency transform  */
     a->timeSlots = a->blocksize/a->hopsize;
-    switch(a->fbOpt){
-        case HADES_USE_AFSTFT_LD: /* fall through */
-        case HADES_USE_AFSTFT:
-            afSTFT_create(&(a->hFB_enc), a->nMics, 0, a->hopsize, a->fbOpt==HADES_USE_AFSTFT_LD ? 1 : 0, a->hybridmode, AFSTFT_BANDS_CH_TIME);
-            a->nBands = afSTFT_getNBands(a->hFB_enc);
-            a->freqVector = malloc1d(a->nBands*sizeof(float));
-            a->filterbankDelay = afSTFT_getProcDelay(a->hFB_enc);
-            afSTFT_getCentreFreqs(a->hFB_enc, a->fs, a->nBands, a->freqVector);
-            a->H_array = malloc1d(a->nBands*(a->nMics)*(a->nGrid)*sizeof(float_complex));
-            a->H_array_w = malloc1d(a->nBands*(a->nMics)*(a->nGrid)*sizeof(float_complex));
-            afSTFT_FIRtoFilterbankCoeffs(a->h_array, a->nGrid, a->nMics, a->h_len, a->hopsize, a->fbOpt==HADES_USE_AFSTFT_LD ? 1 : 0, a->hybridmode, a->H_array);
-            break;
-    }
+    saf_filterbank_create(&(a->hFB_enc), hades_getFilterbankType(a->fbOpt), a->nMics, 0, a->hopsize, a->hybridmode);
+    a->nBands = saf_filterbank_getNBands(a->hFB_enc);
+    a->freqVector = malloc1d(a->nBands*sizeof(float));
+    a->filterbankDelay = saf_filterbank_getProcDelay(a->hFB_enc);
+    saf_filterbank_getCentreFreqs(a->hFB_enc, a->fs, a->nBands, a->freqVector);
+    a->H_array = malloc1d(a->nBands*(a->nMics)*(a->nGrid)*sizeof(float_complex));
+    a->H_array_w = malloc1d(a->nBands*(a->nMics)*(a->nGrid)*sizeof(float_complex));
+    saf_filterbank_FIRtoFilterbankCoeffs(hades_getFilterbankType(a->fbOpt), a->h_array, a->nGrid, a->nMics, a->h_len, a->hopsize, a->hybridmode, a->H_array);
 
     /* Initialise DoA estimator */
     utility_cseig_create(&(a->hEig), a->nMics);
@@ -173,9 +168,10 @@ void hades_analysis_create
     /* Run-time variables */
     a->inputBlock = (float**)malloc2d(a->nMics, a->blocksize, sizeof(float));
     a->Cx = malloc1d(a->nBands*sizeof(CxMic));
-    a->V  = malloc1d((a->nMics)*(a->nMics)*sizeof(float_complex));
+    a->T_Cx_TH = malloc1d(a->nBands*(a->nMics)*(a->nMics)*sizeof(float_complex));
+    a->V  = malloc1d(a->nBands*(a->nMics)*(a->nMics)*sizeof(float_complex));
     a->Vn = malloc1d((a->nMics)*(a->nMics)*sizeof(float_complex));
-    a->lambda = malloc1d((a->nMics)*sizeof(float));
+    a->lambda = malloc1d(a->nBands*(a->nMics)*sizeof(float));
 
     /* Flush run-time buffers with zeros */
     hades_analysis_reset((*phAna));
@@ -199,10 +195,7 @@ void hades_analysis_destroy
         free(a->grid_dirs_deg);
 
         /* Destroy time-frequency transform  */
-        switch(a->fbOpt){
-            case HADES_USE_AFSTFT_LD: /* fall through */
-            case HADES_USE_AFSTFT:    afSTFT_destroy(&(a->hFB_enc)); break;
-        }
+        saf_filterbank_destroy(&(a->hFB_enc));
         free(a->freqVector);
 
         /* Destroy DoA estimator */
@@ -216,6 +209,7 @@ void hades_analysis_destroy
         /* Free run-time variables */
         free(a->inputBlock);
         free(a->Cx);
+        free(a->T_Cx_TH);
         free(a->V);
         free(a->Vn);
         free(a->lambda);
@@ -256,7 +250,7 @@ void hades_analysis_apply
     hades_signal_container_data *scon = (hades_signal_container_data*)(hSCon);
     int i, j, k, ch, band, est_idx;
     float diffuseness;
-    CxMic Cx_new, T_Cx, T_Cx_TH;
+    CxMic Cx_new, T_Cx;
     const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
 
     assert(blocksize==a->blocksize);
@@ -268,10 +262,7 @@ void hades_analysis_apply
         memset(a->inputBlock[ch], 0, blocksize*sizeof(float));
 
     /* Forward time-frequency transform */
-    switch(a->fbOpt){
-        case HADES_USE_AFSTFT_LD: /* fall through */
-        case HADES_USE_AFSTFT:    afSTFT_forward_knownDimensions(a->hFB_enc, a->inputBlock, blocksize, a->nMics, a->timeSlots, scon->inTF); break;
-    }
+    saf_filterbank_forward(a->hFB_enc, a->inputBlock, blocksize, a->nMics, a->timeSlots, scon->inTF);
 
     /* Update covarience matrix per band */
     for(band=0; band<a->nBands; band++){
@@ -288,9 +279,8 @@ void hades_analysis_apply
         cblas_saxpy(/*re+im*/2*(a->nMics) * (a->nMics), 1.0f-SAF_CLAMP(a->covAvgCoeff, 0.0f, 0.999f), (float*)Cx_new.Cx, 1, (float*)a->Cx[band].Cx, 1);
     }
 
-    /* Spatial parameter estimation per band */
+    /* Apply diffuse whitening process per band */
     for (band = 0; band < a->nBands; band++) {
-        /* Apply diffuse whitening process */
         cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, a->nMics, a->nMics, a->nMics, &calpha,
                     a->T[band], a->nMics,
                     a->Cx[band].Cx, a->nMics, &cbeta,
@@ -298,13 +288,18 @@ void hades_analysis_apply
         cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, a->nMics, a->nMics, a->nMics, &calpha,
                     T_Cx.Cx, a->nMics,
                     a->T[band], a->nMics, &cbeta,
-                    T_Cx_TH.Cx, a->nMics);
-        utility_cseig(a->hEig, T_Cx_TH.Cx, a->nMics, 1, a->V, NULL, a->lambda);
+                    &(a->T_Cx_TH[band*(a->nMics)*(a->nMics)]), a->nMics);
+    }
+
+    /* Decompose the whitened covariance matrices of all bands in one go */
+    utility_cseig_batch(a->hEig, a->T_Cx_TH, a->nMics, a->nBands, 1, a->V, NULL, a->lambda);
 
+    /* Spatial parameter estimation per band */
+    for (band = 0; band < a->nBands; band++) {
         /* Estimate diffuseness */
         diffuseness = 0.0f;
         switch(a->diffOpt){
-            case HADES_USE_COMEDIE: diffuseness = hades_comedie(a->lambda, a->nMics); break;
+            case HADES_USE_COMEDIE: diffuseness = hades_comedie(&(a->lambda[band*(a->nMics)]), a->nMics); break;
         }
 
         /* Store diffuseness and source number estimates */
@@ -317,7 +312,7 @@ void hades_analysis_apply
                 /* perform sphMUSIC on the noise subspace */
                 for(i=0; i<a->nMics; i++)
                     for(j=0, k=1; j<a->nMics-1; j++, k++)
-                        a->Vn[i*(a->nMics-1)+j] = a->V[i*(a->nMics)+k];
+                        a->Vn[i*(a->nMics-1)+j] = a->V[band*(a->nMics)*(a->nMics) + i*(a->nMics)+k];
                 hades_sdMUSIC_compute(a->hDoA, &(a->H_array_w[band*(a->nMics)*(a->nGrid)]), a->Vn, 1, NULL, &est_idx);
                 break;
         }
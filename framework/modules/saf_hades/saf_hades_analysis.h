@@ -79,7 +79,9 @@ typedef enum {
 /** Filterbank options */
 typedef enum {
     HADES_USE_AFSTFT_LD, /**< Alias-free STFT filterbank (low delay) */
-    HADES_USE_AFSTFT     /**< Alias-free STFT filterbank */
+    HADES_USE_AFSTFT,    /**< Alias-free STFT filterbank */
+    HADES_USE_QMF,       /**< Complex quadrature mirror filterbank */
+    HADES_USE_STFT       /**< STFT (no hybrid-filtering; hopsize*2+1 bands) */
 }HADES_FILTERBANKS;
 
 
@@ -57,10 +57,8 @@ void hades_getInterpolatedHRTFs
 
     /* Pass HRIRs through the filterbank */
     hrtf_fb = (float_complex***)malloc3d(a->nBands, NUM_EARS, binConfig->nHRIR, sizeof(float_complex));
-    switch(a->fbOpt){
-        case HADES_USE_AFSTFT_LD: HRIRs2HRTFs_afSTFT(binConfig->hrirs, binConfig->nHRIR, binConfig->lHRIR, a->hopsize, 1, a->hybridmode, FLATTEN3D(hrtf_fb)); break;
-        case HADES_USE_AFSTFT:    HRIRs2HRTFs_afSTFT(binConfig->hrirs, binConfig->nHRIR, binConfig->lHRIR, a->hopsize, 0, a->hybridmode, FLATTEN3D(hrtf_fb)); break;
-    }
+    saf_filterbank_FIRtoFilterbankCoeffs(hades_getFilterbankType(a->fbOpt), binConfig->hrirs, binConfig->nHRIR, NUM_EARS, binConfig->lHRIR,
+                                         a->hopsize, a->hybridmode, FLATTEN3D(hrtf_fb));
 
     /* Integration weights */
     if (cblas_sasum(nTargetDirs, target_dirs_deg+1, 2)/(float)nTargetDirs<0.0001)
@@ -267,4 +265,18 @@ float hades_comedie
     }
 }
 
+SAF_FILTERBANK_TYPES hades_getFilterbankType
+(
+    HADES_FILTERBANKS fbOpt
+)
+{
+    switch(fbOpt){
+        case HADES_USE_AFSTFT_LD: return SAF_FILTERBANK_AFSTFT_LD;
+        case HADES_USE_AFSTFT:    return SAF_FILTERBANK_AFSTFT;
+        case HADES_USE_QMF:       return SAF_FILTERBANK_QMF;
+        case HADES_USE_STFT:      return SAF_FILTERBANK_STFT;
+    }
+    return SAF_FILTERBANK_AFSTFT;
+}
+
 #endif /* SAF_ENABLE_HADES_MODULE */
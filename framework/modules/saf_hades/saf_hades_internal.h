@@ -101,9 +101,10 @@ typedef struct _hades_analysis_data
     /* Run-time variables */
     float** inputBlock;                   /**< Input frame; nMics x blocksize */
     CxMic* Cx;                            /**< Current (time-averaged) covariance matrix per band; nBands x 1 */
-    float_complex* V;                     /**< Eigen vectors; FLAT: nMics x nMics */
+    float_complex* T_Cx_TH;               /**< Whitened covariance matrices; FLAT: nBands x nMics x nMics */
+    float_complex* V;                     /**< Eigen vectors; FLAT: nBands x nMics x nMics */
     float_complex* Vn;                    /**< Noise subspace; FLAT: nMics x (nMics-1) */
-    float* lambda;                        /**< Eigenvalues; nMics x 1 */
+    float* lambda;                        /**< Eigenvalues; FLAT: nBands x nMics */
 
 }hades_analysis_data;
 
@@ -147,7 +148,7 @@ typedef struct _hades_synthesis_data
 
     /* Run-time variables */
     void* hPinv;                     /**< Handle for computing the Moore-Penrose pseudo inverse */
-    void* hLinSolve;                 /**< Handle for solving linear equations (Ax=b) */
+    void* hLinSolve;                 /**< Handle for solving the (Hermitian) linear equations (Ax=b) of all bands at once */
     void* hCDF;                      /**< Handle for solving the covariance matching problem */
     float_complex* As;               /**< Array steering vector for DoA; FLAT: nMics x 1 */
     float_complex* As_l;             /**< Array steering vector relative to left reference sensor; FLAT: nMics x 1 */
@@ -156,6 +157,10 @@ typedef struct _hades_synthesis_data
     float_complex* Q_dir;            /**< Mixing matrix for the direct stream; FLAT: #NUM_EARS x nMics */
     float_complex* Q;                /**< Mixing matrix for the direct and diffuse streams combined (based on the diffuseness value); FLAT: #NUM_EARS x nMics */
     float_complex* Cy;               /**< Target binaural spatial covariance matrix; FLAT: #NUM_EARS x #NUM_EARS */
+    float_complex* Cx_reg;           /**< Regularised array covariance matrices (for the MVDR weights); FLAT: nBands x nMics x nMics */
+    float_complex* conj_As_lr;       /**< Conjugated left/right RTFs (for the MVDR weights); FLAT: nBands x nMics x #NUM_EARS */
+    float_complex* AsH_invCx_lr;     /**< Solutions Cx_reg^-1 conj_As_lr (for the MVDR weights); FLAT: nBands x nMics x #NUM_EARS */
+    int* validMVDR;                  /**< 1: MVDR weights may be computed for this band, 0: not; nBands x 1 */
     float_complex* new_M;            /**< New mixing matrix (not yet temporally averaged); FLAT: #NUM_EARS x nMics */
     float_complex** M;               /**< Mixing matrix per band; nBands x FLAT: (#NUM_EARS x nMics) */
 
@@ -289,6 +294,9 @@ void hades_sdMUSIC_compute(/* Input arguments */
 float hades_comedie(float* lambda,
                     int N);
 
+/** Returns the saf_filterbank type corresponding to a #HADES_FILTERBANKS option */
+SAF_FILTERBANK_TYPES hades_getFilterbankType(HADES_FILTERBANKS fbOpt);
+
 #endif /* SAF_ENABLE_HADES_MODULE */
 
 
@@ -160,10 +160,7 @@ void hades_synthesis_create
     memcpy(s->freqVector, a->freqVector, s->nBands*sizeof(float));
 
     /* Time-frequency transform */
-    switch(s->fbOpt){
-        case HADES_USE_AFSTFT_LD: afSTFT_create(&(s->hFB_dec), 0, NUM_EARS, s->hopsize, 1, a->hybridmode, AFSTFT_BANDS_CH_TIME); break;
-        case HADES_USE_AFSTFT:    afSTFT_create(&(s->hFB_dec), 0, NUM_EARS, s->hopsize, 0, a->hybridmode, AFSTFT_BANDS_CH_TIME); break;
-    }
+    saf_filterbank_create(&(s->hFB_dec), hades_getFilterbankType(s->fbOpt), 0, NUM_EARS, s->hopsize, a->hybridmode);
  
     /* Copy binaural configuration */
     s->binConfig = malloc1d(sizeof(hades_binaural_config));
@@ -211,7 +208,7 @@ void hades_synthesis_create
 
     /* Run-time variables */
     utility_cpinv_create(&(s->hPinv), s->nMics, s->nMics);
-    utility_cglslv_create(&(s->hLinSolve), s->nMics, s->nMics);
+    utility_cslslv_create(&(s->hLinSolve), s->nMics, NUM_EARS);
     cdf4sap_cmplx_create(&(s->hCDF), s->nMics, NUM_EARS);
     s->As   = malloc1d(s->nMics*sizeof(float_complex));
     s->As_l = malloc1d(s->nMics*sizeof(float_complex));
@@ -220,6 +217,10 @@ void hades_synthesis_create
     s->Q_dir  = malloc1d(NUM_EARS*(s->nMics)*sizeof(float_complex));
     s->Q      = malloc1d(NUM_EARS*(s->nMics)*sizeof(float_complex));
     s->Cy = malloc1d(NUM_EARS*NUM_EARS*sizeof(float_complex));
+    s->Cx_reg = malloc1d(s->nBands*(s->nMics)*(s->nMics)*sizeof(float_complex));
+    s->conj_As_lr = malloc1d(s->nBands*(s->nMics)*NUM_EARS*sizeof(float_complex));
+    s->AsH_invCx_lr = malloc1d(s->nBands*(s->nMics)*NUM_EARS*sizeof(float_complex));
+    s->validMVDR = malloc1d(s->nBands*sizeof(int));
     s->new_M = malloc1d(NUM_EARS*(s->nMics)*sizeof(float_complex));
     s->M  = (float_complex**)malloc2d(s->nBands, NUM_EARS*(s->nMics), sizeof(float_complex));
 
@@ -253,10 +254,7 @@ void hades_synthesis_destroy
         free(s->freqVector);
 
         /* Free time-frequency transform */
-        switch(s->fbOpt){
-            case HADES_USE_AFSTFT_LD: /* fall through */
-            case HADES_USE_AFSTFT:    afSTFT_destroy(&(s->hFB_dec)); break;
-        }
+        saf_filterbank_destroy(&(s->hFB_dec));
 
         /* HRTF and diffuse rendering variables */
         free(s->H_bin);
@@ -265,7 +263,7 @@ void hades_synthesis_destroy
 
         /* Run-time variables */
         utility_cpinv_destroy(&(s->hPinv));
-        utility_cglslv_destroy(&(s->hLinSolve));
+        utility_cslslv_destroy(&(s->hLinSolve));
         cdf4sap_cmplx_destroy(&(s->hCDF));
         free(s->As);
         free(s->As_l);
@@ -274,6 +272,10 @@ void hades_synthesis_destroy
         free(s->Q_dir);
         free(s->Q);
         free(s->Cy);
+        free(s->Cx_reg);
+        free(s->conj_As_lr);
+        free(s->AsH_invCx_lr);
+        free(s->validMVDR);
         free(s->new_M);
         free(s->M);
 
@@ -298,10 +300,7 @@ void hades_synthesis_reset
     s = (hades_synthesis_data*)(hSyn);
 
     /* Zero buffers, matrices etc. */
-    switch(s->fbOpt){
-        case HADES_USE_AFSTFT_LD: /* fall through */
-        case HADES_USE_AFSTFT:    afSTFT_clearBuffers(s->hFB_dec); break;
-    }
+    saf_filterbank_clearBuffers(s->hFB_dec);
     memset(FLATTEN2D(s->M), 0, s->nBands*NUM_EARS*(s->nMics)*sizeof(float_complex));
 }
 
@@ -321,12 +320,46 @@ void hades_synthesis_apply
     int i, j, ch, nMics, band, doa_idx, gain_idx;
     float a, b, diffuseness, synAvgCoeff, streamBalance, eq, gain_dir, gain_diff, trace_M, reg_M, sum_As, targetEnergy;
     float_complex g_l, g_r, h_dir[NUM_EARS], AsH_invCx_As;
-    float_complex Cx[HADES_MAX_NMICS*HADES_MAX_NMICS], conj_As[HADES_MAX_NMICS], AsH_invCx[HADES_MAX_NMICS*HADES_MAX_NMICS];
+    float_complex AsH_invCx[HADES_MAX_NMICS];
+    float_complex* Cx;
     const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
 
     nMics = s->nMics;
     synAvgCoeff = SAF_CLAMP((s->synAvgCoeff), 0.0f, 0.99f);
 
+    /* The MVDR beamformers require solving Cx^-1 conj(As) for each ear, which is done for all bands at once */
+    if(s->beamOption==HADES_BEAMFORMER_BMVDR){
+        for (band = 0; band < s->nBands; band++) {
+            /* Source array steering vector for the estimated DoA */
+            doa_idx = pcon->doa_idx[band];
+            for(i=0; i<nMics; i++)
+                s->As[i] = s->H_array[band*nMics*(s->nGrid) + i*(s->nGrid) + doa_idx];
+
+            /* prep */
+            Cx = &(s->Cx_reg[band*nMics*nMics]);
+            cblas_ccopy(nMics*nMics, scon->Cx[band].Cx, 1, Cx, 1);
+            trace_M = 0.0f;
+            for(i=0; i<nMics; i++)
+                trace_M += crealf(Cx[i*nMics+i]);
+            sum_As = cblas_scasum(nMics, s->As, 1);
+
+            /* Beamforming weights are only computed if checks pass */
+            s->validMVDR[band] = trace_M < 0.0001f || sum_As < 0.0001f ? 0 : 1;
+
+            /* Regularise Cx (which also keeps it positive-definate for the bands that do not pass) */
+            reg_M = (trace_M/(float)nMics) * 10.0f + 0.0001f;
+            for(i=0; i<nMics; i++)
+                Cx[i*nMics+i] = craddf(Cx[i*nMics+i], reg_M);
+
+            /* Conjugated anechoic relative transfer functions (RTFs), w.r.t the reference sensor at each ear */
+            for(i=0; i<nMics; i++){
+                for(j=0; j<NUM_EARS; j++)
+                    s->conj_As_lr[band*nMics*NUM_EARS + i*NUM_EARS + j] = conjf(ccdivf(s->As[i], s->As[s->refIndices[j]]));
+            }
+        }
+        utility_cslslv_batch(s->hLinSolve, s->Cx_reg, nMics, s->conj_As_lr, NUM_EARS, s->nBands, s->AsH_invCx_lr);
+    }
+
     /* Loop over bands and compute the mixing matrices */
     for (band = 0; band < s->nBands; band++) {
         /* Pull estimated (and possibly modified) spatial parameters for this band */
@@ -388,27 +421,14 @@ void hades_synthesis_apply
                 break;
 
             case HADES_BEAMFORMER_BMVDR:
-                /* prep */
-                cblas_ccopy(nMics*nMics, scon->Cx[band].Cx, 1, Cx, 1);
-                trace_M = 0.0f;
-                for(i=0; i<nMics; i++)
-                    trace_M += crealf(Cx[i*nMics+i]);
-                sum_As = cblas_scasum(nMics, s->As, 1);
-
                 /* Compute beamforming weights if checks pass */
-                if( trace_M < 0.0001f || sum_As < 0.0001f)
+                if(!s->validMVDR[band])
                     memset(s->Q_dir, 0, NUM_EARS*nMics*sizeof(float_complex));
                 else{
-                    /* Regularise Cx */
-                    reg_M = (trace_M/(float)nMics) * 10.0f + 0.0001f;
-                    for(i=0; i<nMics; i++)
-                        Cx[i*nMics+i] = craddf(Cx[i*nMics+i], reg_M);
-
                     /* Compute MVDR weights w.r.t the reference sensor at each ear, [As^H Cx^-1 As]^-1 As^H Cx^-1  */
                     for(j=0; j<NUM_EARS; j++){
-                        /* Solve As^H Cx-1 */
-                        utility_cvconj(j==0 ? s->As_l : s->As_r, nMics, conj_As);
-                        utility_cglslv(s->hLinSolve, Cx, nMics, conj_As, 1, AsH_invCx);
+                        /* As^H Cx-1 (solved for all bands above) */
+                        cblas_ccopy(nMics, &(s->AsH_invCx_lr[band*nMics*NUM_EARS + j]), NUM_EARS, AsH_invCx, 1);
 
                         /* Compute As^H Cx-1 As */
                         utility_cvvdot(AsH_invCx, j==0 ? s->As_l : s->As_r, nMics, NO_CONJ, &AsH_invCx_As);
@@ -484,10 +504,7 @@ void hades_synthesis_apply
     }
 
     /* inverse time-frequency transform */
-    switch(s->fbOpt){
-        case HADES_USE_AFSTFT_LD: /* fall through */
-        case HADES_USE_AFSTFT:    afSTFT_backward_knownDimensions(s->hFB_dec, s->outTF, blocksize, NUM_EARS, s->timeSlots, s->outTD);   break;
-    }
+    saf_filterbank_backward(s->hFB_dec, s->outTF, blocksize, NUM_EARS, s->timeSlots, s->outTD);
 
     /* Copy to output */
     for(ch=0; ch<SAF_MIN(nChannels, NUM_EARS); ch++)
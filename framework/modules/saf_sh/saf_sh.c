@@ -1653,8 +1653,95 @@ void sphESPRIT_estimateDirs
     }
 }
 
+void generateMap_create
+(
+    void ** const phWork,
+    int maxOrder,
+    int maxNGrid_dirs
+)
+{
+    *phWork = malloc1d(sizeof(generateMap_data));
+    generateMap_data *h = (generateMap_data*)(*phWork);
+    int N, G;
+
+    h->maxOrder = maxOrder;
+    h->maxNSH = N = ORDER2NSH(maxOrder);
+    h->maxNGrid = G = maxNGrid_dirs;
+
+    /* solver work handles */
+    utility_cslslv_create(&(h->hCslslvGrid), N, G);
+    utility_cslslv_create(&(h->hCslslvA), N, 2);
+    utility_cglslv_create(&(h->hCglslv), 2, N);
+    utility_cseig_create(&(h->hCseig), N);
+    utility_ceig_create(&(h->hCeig), N);
+
+    /* run-time buffers */
+    h->Cx_Y = malloc1d(N*G*sizeof(float_complex));
+    h->Y_Cx_Y = malloc1d(G*sizeof(float_complex));
+    h->Cx_Y_s = malloc1d(N*sizeof(float_complex));
+    h->Y_grid_s = malloc1d(N*sizeof(float_complex));
+    h->w_MVDR = malloc1d(N*G*sizeof(float_complex));
+    h->Cx_d = malloc1d(N*N*sizeof(float_complex));
+    h->invCx_Ygrid = malloc1d(N*G*sizeof(float_complex));
+    h->invCx_Ygrid_s = malloc1d(N*sizeof(float_complex));
+    h->A = malloc1d(N*2*sizeof(float_complex));
+    h->invCxd_A = malloc1d(N*2*sizeof(float_complex));
+    h->invCxd_A_tmp = malloc1d(N*2*sizeof(float_complex));
+    h->w_LCMV_s = malloc1d(2*N*sizeof(float_complex));
+    h->w_CroPaC = malloc1d(N*G*sizeof(float_complex));
+    h->wo = malloc1d(N*sizeof(float_complex));
+    h->mvdr_map = malloc1d(G*sizeof(float));
+    h->V = malloc1d(N*N*sizeof(float_complex));
+    h->Vn = malloc1d(N*N*sizeof(float_complex));
+    h->Vn_Y = malloc1d(N*G*sizeof(float_complex));
+    h->Vn1 = malloc1d(N*sizeof(float_complex));
+    h->Un = malloc1d(N*sizeof(float_complex));
+    h->Un_Y = malloc1d(G*sizeof(float_complex));
+}
+
+void generateMap_destroy
+(
+    void ** const phWork
+)
+{
+    generateMap_data *h = (generateMap_data*)(*phWork);
+
+    if(h!=NULL){
+        utility_cslslv_destroy(&(h->hCslslvGrid));
+        utility_cslslv_destroy(&(h->hCslslvA));
+        utility_cglslv_destroy(&(h->hCglslv));
+        utility_cseig_destroy(&(h->hCseig));
+        utility_ceig_destroy(&(h->hCeig));
+        free(h->Cx_Y);
+        free(h->Y_Cx_Y);
+        free(h->Cx_Y_s);
+        free(h->Y_grid_s);
+        free(h->w_MVDR);
+        free(h->Cx_d);
+        free(h->invCx_Ygrid);
+        free(h->invCx_Ygrid_s);
+        free(h->A);
+        free(h->invCxd_A);
+        free(h->invCxd_A_tmp);
+        free(h->w_LCMV_s);
+        free(h->w_CroPaC);
+        free(h->wo);
+        free(h->mvdr_map);
+        free(h->V);
+        free(h->Vn);
+        free(h->Vn_Y);
+        free(h->Vn1);
+        free(h->Un);
+        free(h->Un_Y);
+        free(h);
+        h=NULL;
+        *phWork = NULL;
+    }
+}
+
 void generatePWDmap
 (
+    void* const hWork,
     int order,
     float_complex* Cx,
     float_complex* Y_grid,
@@ -1662,41 +1749,46 @@ void generatePWDmap
     float* pmap
 )
 {
+    generateMap_data *h;
     int i, j, nSH;
-    float_complex* Cx_Y, *Y_Cx_Y, *Cx_Y_s, *Y_grid_s;
     const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
     
     nSH = ORDER2NSH(order);
-    Cx_Y = malloc1d(nSH * nGrid_dirs * sizeof(float_complex));
-    Y_Cx_Y = malloc1d(nGrid_dirs*sizeof(float_complex));
-    Cx_Y_s = malloc1d(nSH*sizeof(float_complex));
-    Y_grid_s = malloc1d(nSH*sizeof(float_complex));
+
+    /* Work struct */
+    if(hWork==NULL)
+        generateMap_create((void**)&h, order, nGrid_dirs);
+    else{
+        h = (generateMap_data*)(hWork);
+#ifndef NDEBUG
+        saf_assert(order<=h->maxOrder && nGrid_dirs<=h->maxNGrid, "order/nGrid_dirs exceed the maximum specified");
+#endif
+    }
     
     /* Calculate PWD powermap: real(diag(Y_grid.'*C_x*Y_grid)) */
     cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nSH, nGrid_dirs, nSH, &calpha,
                 Cx, nSH,
                 Y_grid, nGrid_dirs, &cbeta,
-                Cx_Y, nGrid_dirs);
+                h->Cx_Y, nGrid_dirs);
     for(i=0; i<nGrid_dirs; i++){
         for(j=0; j<nSH; j++){
-            Cx_Y_s[j] = Cx_Y[j*nGrid_dirs+i];
-            Y_grid_s[j] = Y_grid[j*nGrid_dirs+i];
+            h->Cx_Y_s[j] = h->Cx_Y[j*nGrid_dirs+i];
+            h->Y_grid_s[j] = Y_grid[j*nGrid_dirs+i];
         }
         /* faster to perform the dot-product for each vector seperately */
-        utility_cvvdot(Y_grid_s, Cx_Y_s, nSH, NO_CONJ, &Y_Cx_Y[i]);
+        utility_cvvdot(h->Y_grid_s, h->Cx_Y_s, nSH, NO_CONJ, &(h->Y_Cx_Y[i]));
     }
     
     for(i=0; i<nGrid_dirs; i++)
-        pmap[i] = crealf(Y_Cx_Y[i]);
-    
-    free(Cx_Y);
-    free(Y_Cx_Y);
-    free(Cx_Y_s);
-    free(Y_grid_s);
+        pmap[i] = crealf(h->Y_Cx_Y[i]);
+
+    if(hWork==NULL)
+        generateMap_destroy((void**)&h);
 }
 
 void generateMVDRmap
 (
+    void* const hWork,
     int order,
     float_complex* Cx,
     float_complex* Y_grid,
@@ -1706,55 +1798,57 @@ void generateMVDRmap
     float_complex* w_MVDR_out
 )
 {
+    generateMap_data *h;
     int i, j, nSH;
     float Cx_trace;
-    float_complex *Cx_d, *invCx_Ygrid, *w_MVDR, *invCx_Ygrid_s, *Y_grid_s;
     float_complex denum;
     
     nSH = ORDER2NSH(order);
-    w_MVDR = malloc1d(nSH * nGrid_dirs*sizeof(float_complex));
-    Cx_d = malloc1d(nSH*nSH*sizeof(float_complex));
-    invCx_Ygrid = malloc1d(nSH*nGrid_dirs*sizeof(float_complex));
-    invCx_Ygrid_s = malloc1d(nSH*sizeof(float_complex));
-    Y_grid_s = malloc1d(nSH*sizeof(float_complex));
+
+    /* Work struct */
+    if(hWork==NULL)
+        generateMap_create((void**)&h, order, nGrid_dirs);
+    else{
+        h = (generateMap_data*)(hWork);
+#ifndef NDEBUG
+        saf_assert(order<=h->maxOrder && nGrid_dirs<=h->maxNGrid, "order/nGrid_dirs exceed the maximum specified");
+#endif
+    }
     
     /* apply diagonal loading */
     Cx_trace = 0.0f;
     for(i=0; i<nSH; i++)
         Cx_trace += crealf(Cx[i*nSH+i]);
     Cx_trace /= (float)nSH;
-    memcpy(Cx_d, Cx, nSH*nSH*sizeof(float_complex));
+    memcpy(h->Cx_d, Cx, nSH*nSH*sizeof(float_complex));
     for(i=0; i<nSH; i++)
-        Cx_d[i*nSH+i] = craddf(Cx_d[i*nSH+i], regPar*Cx_trace);
+        h->Cx_d[i*nSH+i] = craddf(h->Cx_d[i*nSH+i], regPar*Cx_trace);
     
     /* solve the numerator part of the MVDR weights for all grid directions: Cx^-1 * Y */
-    utility_cslslv(NULL, Cx_d, nSH, Y_grid, nGrid_dirs, invCx_Ygrid);
+    utility_cslslv(h->hCslslvGrid, h->Cx_d, nSH, Y_grid, nGrid_dirs, h->invCx_Ygrid);
     for(i=0; i<nGrid_dirs; i++){
         /* solve the denumerator part of the MVDR weights for each grid direction: Y^T * Cx^-1 * Y */
         for(j=0; j<nSH; j++){
-            invCx_Ygrid_s[j] = conjf(invCx_Ygrid[j*nGrid_dirs+i]);
-            Y_grid_s[j] = Y_grid[j*nGrid_dirs+i];
+            h->invCx_Ygrid_s[j] = conjf(h->invCx_Ygrid[j*nGrid_dirs+i]);
+            h->Y_grid_s[j] = Y_grid[j*nGrid_dirs+i];
         }
         /* faster to perform the dot-product for each vector seperately */
-        utility_cvvdot(Y_grid_s, invCx_Ygrid_s, nSH, NO_CONJ, &denum);
+        utility_cvvdot(h->Y_grid_s, h->invCx_Ygrid_s, nSH, NO_CONJ, &denum);
         
         /* calculate the MVDR weights per grid direction: (Cx^-1 * Y) * (Y^T * Cx^-1 * Y)^-1 */
         for(j=0; j<nSH; j++)
-            w_MVDR[j*nGrid_dirs +i] = ccdivf(invCx_Ygrid[j*nGrid_dirs +i], denum);
+            h->w_MVDR[j*nGrid_dirs +i] = ccdivf(h->invCx_Ygrid[j*nGrid_dirs +i], denum);
     }
     
     /* generate MVDR powermap, by using the generatePWDmap function with the MVDR weights instead */
-    generatePWDmap(order, Cx, w_MVDR, nGrid_dirs, pmap);
+    generatePWDmap(h, order, Cx, h->w_MVDR, nGrid_dirs, pmap);
     
     /* optional output of the beamforming weights */
     if (w_MVDR_out!=NULL)
-        memcpy(w_MVDR_out, w_MVDR, nSH * nGrid_dirs*sizeof(float_complex));
-    
-    free(w_MVDR);
-    free(Cx_d);
-    free(invCx_Ygrid);
-    free(invCx_Ygrid_s);
-    free(Y_grid_s);
+        memcpy(w_MVDR_out, h->w_MVDR, nSH * nGrid_dirs*sizeof(float_complex));
+
+    if(hWork==NULL)
+        generateMap_destroy((void**)&h);
 }
 
 /* EXPERIMENTAL
@@ -1763,6 +1857,7 @@ void generateMVDRmap
  * Speech and Language Processing (TASLP), 24(9), 1507-1519. */
 void generateCroPaCLCMVmap
 (
+    void* const hWork,
     int order,
     float_complex* Cx,
     float_complex* Y_grid,
@@ -1772,10 +1867,9 @@ void generateCroPaCLCMVmap
     float* pmap  
 )
 {
+    generateMap_data *h;
     int i, j, k, nSH;
     float Cx_trace, S, G;
-    float* mvdr_map;
-    float_complex* Cx_d, *A, *invCxd_A, *invCxd_A_tmp, *w_LCMV_s, *w_CroPaC, *wo, *Cx_Y, *Cx_Y_s;
     float_complex b[2]; 
     const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
     float_complex A_invCxd_A[2][2];
@@ -1784,89 +1878,82 @@ void generateCroPaCLCMVmap
     b[0] = cmplxf(1.0f, 0.0f);
     b[1] = cmplxf(0.0f, 0.0f);
     nSH = ORDER2NSH(order);
-    Cx_Y = malloc1d(nSH * nGrid_dirs * sizeof(float_complex));
-    Cx_d = malloc1d(nSH*nSH*sizeof(float_complex));
-    A = malloc1d(nSH*2*sizeof(float_complex));
-    invCxd_A = malloc1d(nSH*2*sizeof(float_complex));
-    invCxd_A_tmp = malloc1d(nSH*2*sizeof(float_complex));
-    w_LCMV_s = malloc1d(2*nGrid_dirs*sizeof(float_complex));
-    w_CroPaC = malloc1d(nSH*nGrid_dirs*sizeof(float_complex));
-    wo = malloc1d(nSH*sizeof(float_complex));
-    mvdr_map = malloc1d(nGrid_dirs*sizeof(float));
-    Cx_Y_s = malloc1d(nSH*sizeof(float_complex));
+
+    /* Work struct */
+    if(hWork==NULL)
+        generateMap_create((void**)&h, order, nGrid_dirs);
+    else{
+        h = (generateMap_data*)(hWork);
+#ifndef NDEBUG
+        saf_assert(order<=h->maxOrder && nGrid_dirs<=h->maxNGrid, "order/nGrid_dirs exceed the maximum specified");
+#endif
+    }
     
     /* generate MVDR map and weights to use as a basis */
-    generateMVDRmap(order, Cx, Y_grid, nGrid_dirs, regPar, mvdr_map, w_CroPaC);
+    generateMVDRmap(h, order, Cx, Y_grid, nGrid_dirs, regPar, h->mvdr_map, h->w_CroPaC);
     
     /* first half of the cross-spectrum */
     cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nSH, nGrid_dirs, nSH, &calpha,
                 Cx, nSH,
                 Y_grid, nGrid_dirs, &cbeta,
-                Cx_Y, nGrid_dirs);
+                h->Cx_Y, nGrid_dirs);
     
     /* apply diagonal loading to cov matrix */
     Cx_trace = 0.0f;
     for(i=0; i<nSH; i++)
         Cx_trace += crealf(Cx[i*nSH+i]);
     Cx_trace /= (float)nSH;
-    memcpy(Cx_d, Cx, nSH*nSH*sizeof(float_complex));
+    memcpy(h->Cx_d, Cx, nSH*nSH*sizeof(float_complex));
     for(i=0; i<nSH; i++)
-        Cx_d[i*nSH+i] = craddf(Cx_d[i*nSH+i], regPar*Cx_trace);
+        h->Cx_d[i*nSH+i] = craddf(h->Cx_d[i*nSH+i], regPar*Cx_trace);
     
     /* calculate CroPaC beamforming weights for each grid direction */
     for(i=0; i<nGrid_dirs; i++){
         for(j=0; j<nSH; j++){
-            A[j*2] = Y_grid[j*nGrid_dirs+i];
-            A[j*2+1] = ccmulf(A[j*2], Cx[j*nSH+j]);
+            h->A[j*2] = Y_grid[j*nGrid_dirs+i];
+            h->A[j*2+1] = ccmulf(h->A[j*2], Cx[j*nSH+j]);
         }
         
         /* solve for minimisation problem for LCMV weights: (Cx^-1 * A) * (A^H * Cx^-1 * A)^-1 * b */
-        utility_cslslv(NULL, Cx_d, nSH, A, 2, invCxd_A);
+        utility_cslslv(h->hCslslvA, h->Cx_d, nSH, h->A, 2, h->invCxd_A);
         for(j=0; j<nSH*2; j++)
-            invCxd_A_tmp[j] = conjf(invCxd_A[j]);
+            h->invCxd_A_tmp[j] = conjf(h->invCxd_A[j]);
         cblas_cgemm(CblasRowMajor, CblasConjTrans, CblasNoTrans, 2, 2, nSH, &calpha,
-                    A, 2,
-                    invCxd_A_tmp, 2, &cbeta,
+                    h->A, 2,
+                    h->invCxd_A_tmp, 2, &cbeta,
                     A_invCxd_A, 2);
         for(j=0; j<nSH; j++)
             for(k=0; k<2; k++)
-                invCxd_A_tmp[k*nSH+j] = invCxd_A[j*2+k];
-        utility_cglslv(NULL, (float_complex*)A_invCxd_A, 2, invCxd_A_tmp, nSH, w_LCMV_s);
+                h->invCxd_A_tmp[k*nSH+j] = h->invCxd_A[j*2+k];
+        utility_cglslv(h->hCglslv, (float_complex*)A_invCxd_A, 2, h->invCxd_A_tmp, nSH, h->w_LCMV_s);
         cblas_cgemm(CblasRowMajor, CblasTrans, CblasNoTrans, nSH, 1, 2, &calpha,
-                    w_LCMV_s, nSH,
+                    h->w_LCMV_s, nSH,
                     b, 1, &cbeta,
-                    wo, 1);
+                    h->wo, 1);
         
         /* calculate the cross-spectrum between static beam Y, and adaptive beam wo (LCMV) */
         for(j=0; j<nSH; j++)
-            Cx_Y_s[j] = Cx_Y[j*nGrid_dirs+i];
-        utility_cvvdot(wo, Cx_Y_s, nSH, NO_CONJ, &Y_wo_xspec);
+            h->Cx_Y_s[j] = h->Cx_Y[j*nGrid_dirs+i];
+        utility_cvvdot(h->wo, h->Cx_Y_s, nSH, NO_CONJ, &Y_wo_xspec);
         
         /* derive CroPaC weights  */
-        S = SAF_MIN(cabsf(Y_wo_xspec), mvdr_map[i]); /* ensures distortionless response */
-        G = sqrtf(S/(mvdr_map[i]+2.23e-10f));
+        S = SAF_MIN(cabsf(Y_wo_xspec), h->mvdr_map[i]); /* ensures distortionless response */
+        G = sqrtf(S/(h->mvdr_map[i]+2.23e-10f));
         G = SAF_MAX(lambda, G); /* optional spectral floor parameter, to control harshness of attenuation (good for demos) */
         for(j=0; j<nSH; j++)
-            w_CroPaC[j*nGrid_dirs + i] = crmulf(w_CroPaC[j*nGrid_dirs + i], G);
+            h->w_CroPaC[j*nGrid_dirs + i] = crmulf(h->w_CroPaC[j*nGrid_dirs + i], G);
     }
     
     /* generate CroPaC powermap, by using the generatePWDmap function with the CroPaC weights instead */
-    generatePWDmap(order, Cx, w_CroPaC, nGrid_dirs, pmap);
-    
-    free(mvdr_map);
-    free(Cx_d);
-    free(A);
-    free(invCxd_A);
-    free(invCxd_A_tmp);
-    free(w_LCMV_s);
-    free(w_CroPaC);
-    free(wo);
-    free(Cx_Y);
-    free(Cx_Y_s);
+    generatePWDmap(h, order, Cx, h->w_CroPaC, nGrid_dirs, pmap);
+
+    if(hWork==NULL)
+        generateMap_destroy((void**)&h);
 }
 
 void generateMUSICmap
 (
+    void* const hWork,
     int order,
     float_complex* Cx,
     float_complex* Y_grid,
@@ -1876,45 +1963,52 @@ void generateMUSICmap
     float* pmap
 )
 {
+    generateMap_data *h;
     int i, j, nSH;
-    float_complex* V, *Vn, *Vn_Y;
     const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
     float_complex tmp;
     
     nSH = ORDER2NSH(order);
     nSources = SAF_MIN(nSources, nSH/2);
-    V = malloc1d(nSH*nSH*sizeof(float_complex));
-    Vn = malloc1d(nSH*(nSH-nSources)*sizeof(float_complex));
-    Vn_Y = malloc1d((nSH-nSources)*nGrid_dirs*sizeof(float_complex));
+
+    /* Work struct */
+    if(hWork==NULL)
+        generateMap_create((void**)&h, order, nGrid_dirs);
+    else{
+        h = (generateMap_data*)(hWork);
+#ifndef NDEBUG
+        saf_assert(order<=h->maxOrder && nGrid_dirs<=h->maxNGrid, "order/nGrid_dirs exceed the maximum specified");
+#endif
+    }
     
     /* obtain eigenvectors */
     //utility_ceig(Cx, nSH, 1, NULL, V, NULL, NULL);
-    utility_cseig(NULL, Cx, nSH, 1, V, NULL, NULL);
+    utility_cseig(h->hCseig, Cx, nSH, 1, h->V, NULL, NULL);
     
     /* truncate, to obtain noise sub-space */
     for (i = 0; i < nSH; i++)
         for (j = 0; j < nSH - nSources; j++)
-            Vn[i*(nSH - nSources) + j] = V[i*nSH + j + nSources];
+            h->Vn[i*(nSH - nSources) + j] = h->V[i*nSH + j + nSources];
     
     /* derive the pseudo-spectrum value for each grid direction */
     cblas_cgemm(CblasRowMajor, CblasTrans, CblasNoTrans, nSH-nSources, nGrid_dirs, nSH, &calpha,
-                Vn, nSH-nSources,
+                h->Vn, nSH-nSources,
                 Y_grid, nGrid_dirs, &cbeta,
-                Vn_Y, nGrid_dirs);
+                h->Vn_Y, nGrid_dirs);
     for(i=0; i<nGrid_dirs; i++){
         tmp = cmplxf(0.0f,0.0f);
         for(j=0; j<nSH-nSources; j++)
-            tmp = ccaddf(tmp, ccmulf(conjf(Vn_Y[j*nGrid_dirs+i]),Vn_Y[j*nGrid_dirs+i]));
+            tmp = ccaddf(tmp, ccmulf(conjf(h->Vn_Y[j*nGrid_dirs+i]),h->Vn_Y[j*nGrid_dirs+i]));
         pmap[i] = logScaleFlag ? logf(1.0f/(crealf(tmp)+2.23e-10f)) : 1.0f/(crealf(tmp)+2.23e-10f);
     }
-    
-    free(V);
-    free(Vn);
-    free(Vn_Y);
+
+    if(hWork==NULL)
+        generateMap_destroy((void**)&h);
 }
 
 void generateMinNormMap
 (
+    void* const hWork,
     int order,
     float_complex* Cx,
     float_complex* Y_grid,
@@ -1924,51 +2018,52 @@ void generateMinNormMap
     float* pmap
 )
 {
+    generateMap_data *h;
     int i, j, nSH;
-    float_complex* V, *Vn, *Vn1, *Un, *Un_Y;
     const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
     float_complex Vn1_Vn1H;
     
     nSH = ORDER2NSH(order);
     nSources = SAF_MIN(nSources, nSH/2);
-    V = malloc1d(nSH*nSH*sizeof(float_complex));
-    Vn = malloc1d(nSH*(nSH-nSources)*sizeof(float_complex));
-    Vn1 = malloc1d((nSH-nSources)*sizeof(float_complex));
-    Un = malloc1d(nSH*sizeof(float_complex));
-    Un_Y = malloc1d(nGrid_dirs*sizeof(float_complex));
+
+    /* Work struct */
+    if(hWork==NULL)
+        generateMap_create((void**)&h, order, nGrid_dirs);
+    else{
+        h = (generateMap_data*)(hWork);
+#ifndef NDEBUG
+        saf_assert(order<=h->maxOrder && nGrid_dirs<=h->maxNGrid, "order/nGrid_dirs exceed the maximum specified");
+#endif
+    }
     
     /* obtain eigenvectors */
-    utility_ceig(NULL, Cx, nSH, NULL, V, NULL, NULL);
+    utility_ceig(h->hCeig, Cx, nSH, NULL, h->V, NULL, NULL);
     
     /* truncate, to obtain noise sub-space */
     for(i=0; i<nSH; i++)
         for(j=0; j<nSH-nSources; j++)
-            Vn[i*(nSH-nSources)+j] = V[i*nSH + j + nSources];
+            h->Vn[i*(nSH-nSources)+j] = h->V[i*nSH + j + nSources];
     for(j=0; j<nSH-nSources; j++)
-        Vn1[j] = V[j + nSources];
+        h->Vn1[j] = h->V[j + nSources];
     
     /* derive the pseudo-spectrum value for each grid direction */
-    utility_cvvdot(Vn1, Vn1, nSH-nSources, NO_CONJ, &Vn1_Vn1H);
+    utility_cvvdot(h->Vn1, h->Vn1, nSH-nSources, NO_CONJ, &Vn1_Vn1H);
     cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, nSH, 1, nSH-nSources, &calpha,
-                Vn, nSH-nSources,
-                Vn1, nSH-nSources, &cbeta,
-                Un, 1);
+                h->Vn, nSH-nSources,
+                h->Vn1, nSH-nSources, &cbeta,
+                h->Un, 1);
     for(i=0; i<nSH; i++)
-        Un[i] = ccdivf(Un[i], craddf(Vn1_Vn1H, 2.23e-9f));
+        h->Un[i] = ccdivf(h->Un[i], craddf(Vn1_Vn1H, 2.23e-9f));
     cblas_cgemm(CblasRowMajor, CblasConjTrans, CblasNoTrans, 1, nGrid_dirs, nSH, &calpha,
-                Un, 1,
+                h->Un, 1,
                 Y_grid, nGrid_dirs, &cbeta,
-                Un_Y, nGrid_dirs);
+                h->Un_Y, nGrid_dirs);
     for(i=0; i<nGrid_dirs; i++)
-        pmap[i] = logScaleFlag ? logf(1.0f/(powf(cabsf(Un_Y[i]),2.0f) + 2.23e-9f)) : 1.0f/(powf(cabsf(Un_Y[i]),2.0f) + 2.23e-9f);
-    
-    free(V);
-    free(Vn);
-    free(Vn1);
-    free(Un);
-    free(Un_Y);
-}
+        pmap[i] = logScaleFlag ? logf(1.0f/(powf(cabsf(h->Un_Y[i]),2.0f) + 2.23e-9f)) : 1.0f/(powf(cabsf(h->Un_Y[i]),2.0f) + 2.23e-9f);
 
+    if(hWork==NULL)
+        generateMap_destroy((void**)&h);
+}
 
 /* ========================================================================== */
 /*              Microphone/Hydrophone array processing functions              */
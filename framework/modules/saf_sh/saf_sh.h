@@ -852,10 +852,33 @@ void sphESPRIT_estimateDirs(/* Input arguments */
                             /* Output arguments */
                             float* src_dirs_rad);
 
+/**
+ * (Optional) Pre-allocates the working struct used by the map generators:
+ * generatePWDmap(), generateMVDRmap(), generateCroPaCLCMVmap(),
+ * generateMUSICmap() and generateMinNormMap()
+ *
+ * When given this work handle, the map generators do not allocate any memory,
+ * and may therefore be called from a real-time thread.
+ *
+ * @param[in] phWork        (&) address of work handle, to give to the map
+ *                          generators
+ * @param[in] maxOrder      Max 'order' when calling the map generators
+ * @param[in] maxNGrid_dirs Max 'nGrid_dirs' when calling the map generators
+ */
+void generateMap_create(void ** const phWork,
+                        int maxOrder,
+                        int maxNGrid_dirs);
+
+/** De-allocate the working struct used by the map generators */
+void generateMap_destroy(void ** const phWork);
+
 /**
  * Generates a powermap based on the energy of a plane-wave decomposition (PWD)
  * (i.e. hyper-cardioid) beamformers
  *
+ * @param[in]  hWork      Handle for the work struct (set to NULL if not
+ *                        available, in which case memory is allocated on the
+ *                        fly); see generateMap_create()
  * @param[in]  order      Analysis order
  * @param[in]  Cx         Correlation/covariance matrix;
  *                        FLAT: (order+1)^2 x (order+1)^2
@@ -865,6 +888,7 @@ void sphESPRIT_estimateDirs(/* Input arguments */
  * @param[out] pmap       Resulting PWD powermap; nGrid_dirs x 1
  */
 void generatePWDmap(/* Input arguments */
+                    void* const hWork,
                     int order,
                     float_complex* Cx,
                     float_complex* Y_grid,
@@ -876,6 +900,9 @@ void generatePWDmap(/* Input arguments */
  * Generates a powermap based on the energy of adaptive Minimum-Variance
  * Distortion-less Response (MVDR) beamformers
  *
+ * @param[in]  hWork      Handle for the work struct (set to NULL if not
+ *                        available, in which case memory is allocated on the
+ *                        fly); see generateMap_create()
  * @param[in]  order      Analysis order
  * @param[in]  Cx         Correlation/covariance matrix;
  *                        FLAT: (order+1)^2 x (order+1)^2
@@ -888,6 +915,7 @@ void generatePWDmap(/* Input arguments */
  *                        it's NULL; FLAT: nSH x nGrid_dirs || NULL
  */
 void generateMVDRmap(/* Input arguments */
+                     void* const hWork,
                      int order,
                      float_complex* Cx,
                      float_complex* Y_grid,
@@ -910,6 +938,9 @@ void generateMVDRmap(/* Input arguments */
  * microphone array signal domain, like in the paper. Otherwise, the algorithm
  * is the same.
  *
+ * @param[in]  hWork      Handle for the work struct (set to NULL if not
+ *                        available, in which case memory is allocated on the
+ *                        fly); see generateMap_create()
  * @param[in]  order      Analysis order
  * @param[in]  Cx         Correlation/covariance matrix;
  *                        FLAT: (order+1)^2 x (order+1)^2
@@ -927,6 +958,7 @@ void generateMVDRmap(/* Input arguments */
  *          Speech and Language Processing (TASLP), 24(9), 1507-1519.
  */
 void generateCroPaCLCMVmap(/* Input arguments */
+                           void* const hWork,
                            int order,
                            float_complex* Cx,
                            float_complex* Y_grid,
@@ -940,6 +972,9 @@ void generateCroPaCLCMVmap(/* Input arguments */
  * Generates an activity-map based on the sub-space multiple-signal
  * classification (MUSIC) method
  *
+ * @param[in]  hWork        Handle for the work struct (set to NULL if not
+ *                          available, in which case memory is allocated on the
+ *                          fly); see generateMap_create()
  * @param[in]  order        Analysis order
  * @param[in]  Cx           Correlation/covariance matrix;
  *                          FLAT: (order+1)^2 x (order+1)^2
@@ -951,6 +986,7 @@ void generateCroPaCLCMVmap(/* Input arguments */
  * @param[out] pmap         Resulting MUSIC pseudo-spectrum; nGrid_dirs x 1
  */
 void generateMUSICmap(/* Input arguments */
+                      void* const hWork,
                       int order,
                       float_complex* Cx,
                       float_complex* Y_grid,
@@ -964,6 +1000,9 @@ void generateMUSICmap(/* Input arguments */
  * Generates an activity-map based on the sub-space minimum-norm (MinNorm)
  * method
  *
+ * @param[in]  hWork        Handle for the work struct (set to NULL if not
+ *                          available, in which case memory is allocated on the
+ *                          fly); see generateMap_create()
  * @param[in]  order        Analysis order
  * @param[in]  Cx           Correlation/covariance matrix;
  *                          FLAT: (order+1)^2 x (order+1)^2
@@ -975,6 +1014,7 @@ void generateMUSICmap(/* Input arguments */
  * @param[out] pmap         Resulting MinNorm pseudo-spectrum; nGrid_dirs x 1
  */
 void generateMinNormMap(/* Input arguments */
+                        void* const hWork,
                         int order,
                         float_complex* Cx,
                         float_complex* Y_grid,
@@ -95,6 +95,23 @@ typedef struct _sphESPRIT_data {
 
 }sphESPRIT_data;
 
+/** Internal data structure for the map generators (generatePWDmap() etc.) */
+typedef struct _generateMap_data {
+    int maxOrder, maxNSH, maxNGrid;
+
+    /* solver work handles */
+    void* hCslslvGrid, *hCslslvA, *hCglslv, *hCseig, *hCeig;
+
+    /* run-time buffers */
+    float_complex* Cx_Y, *Y_Cx_Y, *Cx_Y_s, *Y_grid_s;             /* PWD */
+    float_complex* w_MVDR, *Cx_d, *invCx_Ygrid, *invCx_Ygrid_s;   /* MVDR */
+    float_complex* A, *invCxd_A, *invCxd_A_tmp, *w_LCMV_s;        /* CroPaC */
+    float_complex* w_CroPaC, *wo;
+    float* mvdr_map;
+    float_complex* V, *Vn, *Vn_Y, *Vn1, *Un, *Un_Y;               /* MUSIC/MinNorm */
+
+}generateMap_data;
+
 
 /* ========================================================================== */
 /*                          Misc. Internal Functions                          */
@@ -159,6 +159,7 @@
  */
 #include "../../resources/kissFFT/kiss_fftr.h"
 #include "../../resources/kissFFT/kiss_fft.h"
+#include "../../resources/kissFFT/kiss_fftr4.h"
 
 /* For computing N-dimensional convex hulls and Delaunay meshes.
  * The original source code can be found here (MIT license):
@@ -239,6 +240,18 @@
 /* Distance variation function filter coefficient functions. */
 #include "saf_utility_dvf.h"
 
+/* A lightweight cross-platform thread pool */
+#include "saf_utility_threads.h"
+
+/* For adapting arbitrary host block sizes to a fixed processing frame size */
+#include "saf_utility_blockAdapter.h"
+
+/* A common interface to the afSTFT, QMF and STFT filterbanks */
+#include "saf_utility_filterbank.h"
+
+/* A per-instance arena allocator */
+#include "saf_utility_arena.h"
+
 
 #endif /* __SAF_UTILITIES_H_INCLUDED__ */
 
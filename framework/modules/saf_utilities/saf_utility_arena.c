@@ -0,0 +1,277 @@
+/*
+ * Copyright 2026 Spatial_Audio_Framework contributors
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * @file saf_utility_arena.c
+ * @ingroup Utilities
+ * @brief A per-instance arena allocator
+ *
+ * The allocations are made by bumping an offset into the current block. If the
+ * block is full, then a new block (at least twice the size) is added; the
+ * previous blocks are kept until the next reset, since their memory may still
+ * be in use.
+ *
+ * @author Spatial_Audio_Framework contributors
+ * @date 16.10.2026
+ * @license ISC
+ */
+
+#include "saf_utilities.h"
+#include "saf_utility_arena.h"
+
+/** Minimum size of a block, in bytes */
+#define SAF_ARENA_MIN_BLOCK_SIZE ( 65536 )
+
+/** A block of memory, from which allocations are made */
+typedef struct _saf_arena_block {
+    struct _saf_arena_block* prev; /**< Previous (full) block; NULL: first block */
+    size_t size;                   /**< Capacity, in bytes */
+    size_t used;                   /**< Number of bytes used */
+    unsigned char* data;           /**< Memory; aligned to MD_MALLOC_ALIGNMENT bytes */
+
+} saf_arena_block;
+
+/** Main structure for saf_arena */
+typedef struct _saf_arena_data {
+    saf_arena_block* current;      /**< Block from which allocations are made; NULL: none */
+    size_t used;                   /**< Bytes allocated since the last reset (over all blocks) */
+
+} saf_arena_data;
+
+/** Allocates a new block, with the previous block "prev" */
+static saf_arena_block* saf_arena_newBlock(saf_arena_block* prev, size_t size)
+{
+    saf_arena_block* block = (saf_arena_block*)malloc1d(sizeof(saf_arena_block));
+    block->prev = prev;
+    block->size = size;
+    block->used = 0;
+    block->data = (unsigned char*)malloc1d_aligned(size);
+    return block;
+}
+
+/** Frees a block, and all of its previous blocks */
+static void saf_arena_freeBlocks(saf_arena_block* block)
+{
+    saf_arena_block* prev;
+    while(block!=NULL){
+        prev = block->prev;
+        free1d_aligned(block->data);
+        free(block);
+        block = prev;
+    }
+}
+
+
+/* ========================================================================== */
+/*                              Arena Allocator                               */
+/* ========================================================================== */
+
+void saf_arena_create
+(
+    void ** const phArena,
+    size_t initSize
+)
+{
+    saf_arena_data* h = (saf_arena_data*)malloc1d(sizeof(saf_arena_data));
+    *phArena = (void*)h;
+    h->current = initSize>0 ? saf_arena_newBlock(NULL, initSize) : NULL;
+    h->used = 0;
+}
+
+void saf_arena_destroy
+(
+    void ** const phArena
+)
+{
+    saf_arena_data *h = (saf_arena_data*)(*phArena);
+
+    if(h!=NULL){
+        saf_arena_freeBlocks(h->current);
+        free(h);
+        h=NULL;
+        *phArena = NULL;
+    }
+}
+
+void saf_arena_reset
+(
+    void * const hArena
+)
+{
+    saf_arena_data *h = (saf_arena_data*)(hArena);
+
+    if(h->current!=NULL && h->current->prev!=NULL){
+        /* Merge the blocks into one, which can hold everything allocated since the last reset */
+        saf_arena_freeBlocks(h->current);
+        h->current = saf_arena_newBlock(NULL, h->used);
+    }
+    else if(h->current!=NULL)
+        h->current->used = 0;
+    h->used = 0;
+}
+
+void* saf_arena_malloc1d
+(
+    void * const hArena,
+    size_t dim1_data_size
+)
+{
+    saf_arena_data *h = (saf_arena_data*)(hArena);
+    saf_arena_block* block;
+    size_t nBytes;
+    void* ptr;
+
+    if(dim1_data_size==0)
+        return NULL;
+
+    /* Round up, such that the next allocation is also aligned */
+    nBytes = ((dim1_data_size + MD_MALLOC_ALIGNMENT - 1)/MD_MALLOC_ALIGNMENT) * MD_MALLOC_ALIGNMENT;
+
+    /* Add a new block, if the current one is full */
+    block = h->current;
+    if(block==NULL || block->used + nBytes > block->size)
+        block = h->current = saf_arena_newBlock(block, SAF_MAX(nBytes, SAF_MAX(SAF_ARENA_MIN_BLOCK_SIZE, block==NULL ? 0 : 2*(block->size))));
+    ptr = &(block->data[block->used]);
+    block->used += nBytes;
+    h->used += nBytes;
+    return ptr;
+}
+
+void* saf_arena_calloc1d
+(
+    void * const hArena,
+    size_t dim1,
+    size_t data_size
+)
+{
+    void* ptr = saf_arena_malloc1d(hArena, dim1*data_size);
+    if(ptr!=NULL)
+        memset(ptr, 0, dim1*data_size);
+    return ptr;
+}
+
+void** saf_arena_malloc2d
+(
+    void * const hArena,
+    size_t dim1,
+    size_t dim2,
+    size_t data_size
+)
+{
+    size_t i, stride;
+    void** ptr;
+    unsigned char* p2;
+    stride = dim2*data_size;
+    ptr = (void**)saf_arena_malloc1d(hArena, dim1*sizeof(void*));
+    p2 = (unsigned char*)saf_arena_malloc1d(hArena, dim1*stride);
+    for(i=0; i<dim1; i++)
+        ptr[i] = &p2[i*stride];
+    return ptr;
+}
+
+void** saf_arena_calloc2d
+(
+    void * const hArena,
+    size_t dim1,
+    size_t dim2,
+    size_t data_size
+)
+{
+    void** ptr = saf_arena_malloc2d(hArena, dim1, dim2, data_size);
+    if(ptr!=NULL && dim2*data_size>0)
+        memset(ptr[0], 0, dim1*dim2*data_size);
+    return ptr;
+}
+
+void*** saf_arena_malloc3d
+(
+    void * const hArena,
+    size_t dim1,
+    size_t dim2,
+    size_t dim3,
+    size_t data_size
+)
+{
+    size_t i, j, stride1, stride2;
+    void*** ptr;
+    void** p2;
+    unsigned char* p3;
+    stride1 = dim2*dim3*data_size;
+    stride2 = dim3*data_size;
+    ptr = (void***)saf_arena_malloc1d(hArena, dim1*sizeof(void**));
+    p2 = (void**)saf_arena_malloc1d(hArena, dim1*dim2*sizeof(void*));
+    p3 = (unsigned char*)saf_arena_malloc1d(hArena, dim1*stride1);
+    for(i=0;i<dim1;i++)
+        ptr[i] = &p2[i*dim2];
+    for(i=0;i<dim1;i++)
+        for(j=0;j<dim2;j++)
+            p2[i*dim2+j] = &p3[i*stride1 + j*stride2];
+    return ptr;
+}
+
+void*** saf_arena_calloc3d
+(
+    void * const hArena,
+    size_t dim1,
+    size_t dim2,
+    size_t dim3,
+    size_t data_size
+)
+{
+    void*** ptr = saf_arena_malloc3d(hArena, dim1, dim2, dim3, data_size);
+    if(ptr!=NULL && dim2*dim3*data_size>0)
+        memset(ptr[0][0], 0, dim1*dim2*dim3*data_size);
+    return ptr;
+}
+
+size_t saf_arena_getUsed
+(
+    void * const hArena
+)
+{
+    saf_arena_data *h = (saf_arena_data*)(hArena);
+    return h->used;
+}
+
+size_t saf_arena_getCapacity
+(
+    void * const hArena
+)
+{
+    saf_arena_data *h = (saf_arena_data*)(hArena);
+    saf_arena_block* block;
+    size_t capacity;
+
+    capacity = 0;
+    for(block=h->current; block!=NULL; block=block->prev)
+        capacity += block->size;
+    return capacity;
+}
+
+int saf_arena_getNumBlocks
+(
+    void * const hArena
+)
+{
+    saf_arena_data *h = (saf_arena_data*)(hArena);
+    saf_arena_block* block;
+    int nBlocks;
+
+    nBlocks = 0;
+    for(block=h->current; block!=NULL; block=block->prev)
+        nBlocks++;
+    return nBlocks;
+}
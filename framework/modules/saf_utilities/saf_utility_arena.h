@@ -0,0 +1,156 @@
+/*
+ * Copyright 2026 Spatial_Audio_Framework contributors
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ *@addtogroup Utilities
+ *@{
+ * @file saf_utility_arena.h
+ * @brief A per-instance arena allocator
+ *
+ * Objects which (re-)initialise many tables and buffers may instead carve them
+ * all from one arena, which is released in one go with saf_arena_reset().
+ * The arena grows (by adding blocks) if it runs out of memory, and the blocks
+ * are then merged into one contiguous block of the required size upon the next
+ * reset. Therefore, re-initialising with the same (or smaller) configuration
+ * requires no calls to malloc, and all of the memory is contiguous.
+ *
+ * An example of re-initialising an object's tables from an arena:
+ * \code{.c}
+ *   saf_arena_reset(hArena); // (all previous allocations are released)
+ *   table1D = (float*)saf_arena_malloc1d(hArena, N*sizeof(float));
+ *   table2D = (float**)saf_arena_calloc2d(hArena, M, N, sizeof(float));
+ *   memset(FLATTEN2D(table2D), 0, M*N*sizeof(float)); // (contiguous, as with malloc2d())
+ * \endcode
+ *
+ * @note The arena is not thread-safe, and the memory is not freed
+ *       individually.
+ *
+ * @author Spatial_Audio_Framework contributors
+ * @date 16.10.2026
+ * @license ISC
+ */
+
+#ifndef SAF_ARENA_H_INCLUDED
+#define SAF_ARENA_H_INCLUDED
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* ========================================================================== */
+/*                              Arena Allocator                               */
+/* ========================================================================== */
+
+/**
+ * Creates an instance of saf_arena
+ *
+ * @test test__saf_arena()
+ *
+ * @param[in] phArena  (&) address of saf_arena handle
+ * @param[in] initSize Initial capacity, in bytes (0: allocate on first use)
+ */
+void saf_arena_create(void ** const phArena,
+                      size_t initSize);
+
+/**
+ * Destroys an instance of saf_arena (and all memory allocated from it)
+ *
+ * @param[in] phArena (&) address of saf_arena handle
+ */
+void saf_arena_destroy(void ** const phArena);
+
+/**
+ * Releases all memory allocated from the arena
+ *
+ * If the arena had grown since the last reset, then its blocks are replaced by
+ * one contiguous block, which is large enough for all of the allocations made
+ * since then.
+ *
+ * @warning All pointers previously returned by the arena become invalid!
+ *
+ * @param[in] hArena saf_arena handle
+ */
+void saf_arena_reset(void * const hArena);
+
+/**
+ * 1-D malloc from the arena (aligned to MD_MALLOC_ALIGNMENT bytes)
+ *
+ * @param[in] hArena          saf_arena handle
+ * @param[in] dim1_data_size  Number of bytes
+ * @returns pointer to the memory; NULL if dim1_data_size==0
+ */
+void* saf_arena_malloc1d(void * const hArena,
+                         size_t dim1_data_size);
+
+/** 1-D calloc from the arena (see saf_arena_malloc1d()) */
+void* saf_arena_calloc1d(void * const hArena,
+                         size_t dim1,
+                         size_t data_size);
+
+/**
+ * 2-D malloc from the arena (contiguous, as with malloc2d(), and the data is
+ * aligned to MD_MALLOC_ALIGNMENT bytes)
+ */
+void** saf_arena_malloc2d(void * const hArena,
+                          size_t dim1,
+                          size_t dim2,
+                          size_t data_size);
+
+/** 2-D calloc from the arena (see saf_arena_malloc2d()) */
+void** saf_arena_calloc2d(void * const hArena,
+                          size_t dim1,
+                          size_t dim2,
+                          size_t data_size);
+
+/**
+ * 3-D malloc from the arena (contiguous, as with malloc3d(), and the data is
+ * aligned to MD_MALLOC_ALIGNMENT bytes)
+ */
+void*** saf_arena_malloc3d(void * const hArena,
+                           size_t dim1,
+                           size_t dim2,
+                           size_t dim3,
+                           size_t data_size);
+
+/** 3-D calloc from the arena (see saf_arena_malloc3d()) */
+void*** saf_arena_calloc3d(void * const hArena,
+                           size_t dim1,
+                           size_t dim2,
+                           size_t dim3,
+                           size_t data_size);
+
+/**
+ * Returns the number of bytes allocated from the arena since the last reset
+ * (including the alignment padding)
+ */
+size_t saf_arena_getUsed(void * const hArena);
+
+/** Returns the total capacity of the arena, in bytes */
+size_t saf_arena_getCapacity(void * const hArena);
+
+/** Returns the number of blocks which the arena currently consists of */
+int saf_arena_getNumBlocks(void * const hArena);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* SAF_ARENA_H_INCLUDED */
+
+/**@} */ /* doxygen addtogroup Utilities */
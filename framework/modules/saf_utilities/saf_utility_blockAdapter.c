@@ -0,0 +1,244 @@
+/*
+ * Copyright 2026 Spatial_Audio_Framework contributors
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * @file saf_utility_blockAdapter.c
+ * @ingroup Utilities
+ * @brief An adapter between arbitrary host block sizes and a fixed processing
+ *        frame size
+ *
+ * The input samples are gathered in a FIFO of one frame, and the processed
+ * frames are appended to an output ring buffer of two frames. The output ring
+ * is primed with "latency" zeros, such that the number of buffered input
+ * samples plus the number of buffered output samples is always equal to the
+ * latency. Given host blocks which are integer multiples of G samples, a
+ * latency of F - gcd(F, G) then guarantees that enough output is available for
+ * every block.
+ *
+ * @author Spatial_Audio_Framework contributors
+ * @date 16.10.2026
+ * @license ISC
+ */
+
+#include "saf_utilities.h"
+#include "saf_utility_blockAdapter.h"
+
+/** Main structure for saf_blockAdapter */
+typedef struct _saf_blockAdapter_data {
+    int frameSize;         /**< Frame size of the processing function */
+    int maxNumInputs;      /**< Maximum number of input channels */
+    int maxNumOutputs;     /**< Maximum number of output channels */
+    int granularity;       /**< Greatest common divisor of the frame size and all block sizes so far; 0: no blocks yet */
+    int latency;           /**< Current latency, in samples */
+    float** inFIFO;        /**< Input FIFO; maxNumInputs x frameSize */
+    int inFill;            /**< Number of samples in inFIFO */
+    float** outFrame;      /**< Output of the processing function; maxNumOutputs x frameSize */
+    float** outRing;       /**< Output ring buffer; maxNumOutputs x (2*frameSize) */
+    int outRead;           /**< Read position in outRing */
+    int outCount;          /**< Number of samples in outRing */
+    const float** inPtrs;  /**< Input pointers for calling the processing function on host buffers; maxNumInputs x 1 */
+    float** outPtrs;       /**< Output pointers for calling the processing function on host buffers; maxNumOutputs x 1 */
+
+} saf_blockAdapter_data;
+
+/** Returns the greatest common divisor of two positive integers */
+static int saf_blockAdapter_gcd(int a, int b)
+{
+    int t;
+    while(b!=0){
+        t = b;
+        b = a % b;
+        a = t;
+    }
+    return a;
+}
+
+
+/* ========================================================================== */
+/*                               Block Adapter                                */
+/* ========================================================================== */
+
+void saf_blockAdapter_create
+(
+    void ** const phBA,
+    int frameSize,
+    int maxNumInputs,
+    int maxNumOutputs
+)
+{
+    saf_blockAdapter_data* h = (saf_blockAdapter_data*)malloc1d(sizeof(saf_blockAdapter_data));
+    *phBA = (void*)h;
+    saf_assert(frameSize>0, "Frame size must be positive");
+    h->frameSize = frameSize;
+    h->maxNumInputs = SAF_MAX(maxNumInputs, 1);
+    h->maxNumOutputs = SAF_MAX(maxNumOutputs, 1);
+    h->inFIFO = (float**)malloc2d(h->maxNumInputs, frameSize, sizeof(float));
+    h->outFrame = (float**)malloc2d(h->maxNumOutputs, frameSize, sizeof(float));
+    h->outRing = (float**)malloc2d(h->maxNumOutputs, 2*frameSize, sizeof(float));
+    h->inPtrs = (const float**)malloc1d(h->maxNumInputs*sizeof(float*));
+    h->outPtrs = (float**)malloc1d(h->maxNumOutputs*sizeof(float*));
+    saf_blockAdapter_reset(*phBA, 0);
+}
+
+void saf_blockAdapter_destroy
+(
+    void ** const phBA
+)
+{
+    saf_blockAdapter_data *h = (saf_blockAdapter_data*)(*phBA);
+
+    if(h!=NULL){
+        free(h->inFIFO);
+        free(h->outFrame);
+        free(h->outRing);
+        free(h->inPtrs);
+        free(h->outPtrs);
+        free(h);
+        h=NULL;
+        *phBA = NULL;
+    }
+}
+
+void saf_blockAdapter_reset
+(
+    void * const hBA,
+    int blockSize
+)
+{
+    saf_blockAdapter_data *h = (saf_blockAdapter_data*)(hBA);
+
+    h->inFill = 0;
+    h->outRead = 0;
+    memset(FLATTEN2D(h->inFIFO), 0, h->maxNumInputs*(h->frameSize)*sizeof(float));
+    memset(FLATTEN2D(h->outRing), 0, h->maxNumOutputs*2*(h->frameSize)*sizeof(float));
+
+    /* Prime the output ring with the latency for this block size (which is
+     * otherwise established by the first block) */
+    if(blockSize>0){
+        h->granularity = saf_blockAdapter_gcd(h->frameSize, blockSize);
+        h->latency = h->frameSize - h->granularity;
+    }
+    else{
+        h->granularity = 0;
+        h->latency = 0;
+    }
+    h->outCount = h->latency;
+}
+
+void saf_blockAdapter_process
+(
+    void * const hBA,
+    const float* const* inputs,
+    float* const* const outputs,
+    int nInputs,
+    int nOutputs,
+    int nSamples,
+    saf_blockAdapter_frameFunc frameFunc,
+    void* const hProc
+)
+{
+    saf_blockAdapter_data *h = (saf_blockAdapter_data*)(hBA);
+    int s, n, ch, g, delta, pos, len1, avail, nIn, nOut;
+    const int F = h->frameSize;
+    const int ringLen = 2*F;
+
+    if(nSamples<=0)
+        return;
+    nIn = SAF_MIN(nInputs, h->maxNumInputs);
+    nOut = SAF_MIN(nOutputs, h->maxNumOutputs);
+
+    /* Increase the latency, if this block is not a multiple of those so far */
+    delta = 0;
+    if(h->granularity==0){
+        g = saf_blockAdapter_gcd(F, nSamples);
+        delta = F - g;
+        h->granularity = g;
+    }
+    else if(nSamples % h->granularity != 0){
+        g = saf_blockAdapter_gcd(h->granularity, nSamples);
+        delta = h->granularity - g;
+        h->granularity = g;
+    }
+    if(delta>0){
+        /* Prepend zeros to the output (rewinding the read position) */
+        h->outRead = (h->outRead - delta + ringLen) % ringLen;
+        len1 = SAF_MIN(delta, ringLen - h->outRead);
+        for(ch=0; ch<h->maxNumOutputs; ch++){
+            memset(&(h->outRing[ch][h->outRead]), 0, len1*sizeof(float));
+            memset(h->outRing[ch], 0, (delta-len1)*sizeof(float));
+        }
+        h->outCount += delta;
+        h->latency += delta;
+    }
+
+    /* Zero any output channels that will not be processed */
+    for(ch=nOut; ch<nOutputs; ch++)
+        memset(outputs[ch], 0, nSamples*sizeof(float));
+
+    /* Process the host buffers directly if they are aligned with the frames */
+    if(h->latency==0 && (nSamples % F)==0){
+        for(s=0; s<nSamples; s+=F){
+            for(ch=0; ch<nIn; ch++)
+                h->inPtrs[ch] = &(inputs[ch][s]);
+            for(ch=0; ch<nOut; ch++)
+                h->outPtrs[ch] = &(outputs[ch][s]);
+            frameFunc(hProc, h->inPtrs, h->outPtrs, nIn, nOut, F);
+        }
+        return;
+    }
+
+    for(s=0; s<nSamples; s+=n){
+        /* Fill the input FIFO */
+        n = SAF_MIN(nSamples - s, F - h->inFill);
+        for(ch=0; ch<nIn; ch++)
+            memcpy(&(h->inFIFO[ch][h->inFill]), &(inputs[ch][s]), n*sizeof(float));
+        h->inFill += n;
+
+        /* Process the frame once the FIFO is full, and append it to the output ring */
+        if(h->inFill==F){
+            frameFunc(hProc, (const float* const*)h->inFIFO, h->outFrame, nIn, nOut, F);
+            pos = (h->outRead + h->outCount) % ringLen;
+            len1 = SAF_MIN(F, ringLen - pos);
+            for(ch=0; ch<nOut; ch++){
+                memcpy(&(h->outRing[ch][pos]), h->outFrame[ch], len1*sizeof(float));
+                memcpy(h->outRing[ch], &(h->outFrame[ch][len1]), (F-len1)*sizeof(float));
+            }
+            h->outCount += F;
+            h->inFill = 0;
+        }
+
+        /* Pull the same number of samples from the output ring (this is always
+         * possible, unless the block sizes violate the granularity) */
+        avail = SAF_MIN(n, h->outCount);
+        len1 = SAF_MIN(avail, ringLen - h->outRead);
+        for(ch=0; ch<nOut; ch++){
+            memset(&(outputs[ch][s]), 0, (n-avail)*sizeof(float));
+            memcpy(&(outputs[ch][s+n-avail]), &(h->outRing[ch][h->outRead]), len1*sizeof(float));
+            memcpy(&(outputs[ch][s+n-avail+len1]), h->outRing[ch], (avail-len1)*sizeof(float));
+        }
+        h->outRead = (h->outRead + avail) % ringLen;
+        h->outCount -= avail;
+    }
+}
+
+int saf_blockAdapter_getLatency
+(
+    void * const hBA
+)
+{
+    saf_blockAdapter_data *h = (saf_blockAdapter_data*)(hBA);
+    return h->latency;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2026 Spatial_Audio_Framework contributors
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ *@addtogroup Utilities
+ *@{
+ * @file saf_utility_blockAdapter.h
+ * @brief An adapter between arbitrary host block sizes and a fixed processing
+ *        frame size
+ *
+ * Many processors operate on frames of a fixed size, whereas audio hosts may
+ * deliver blocks of any size. The block adapter buffers the host signals and
+ * calls a frame processing function whenever a full frame of input is
+ * available, while introducing the minimum latency required to always have
+ * output available.
+ *
+ * For a frame size F, and host blocks which are all integer multiples of G
+ * samples, the latency is F - gcd(F, G) samples. Therefore, no latency is
+ * introduced if the host block size is an integer multiple of the frame size.
+ *
+ * @author Spatial_Audio_Framework contributors
+ * @date 16.10.2026
+ * @license ISC
+ */
+
+#ifndef SAF_BLOCKADAPTER_H_INCLUDED
+#define SAF_BLOCKADAPTER_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Function prototype for frame processing functions driven by a
+ * saf_blockAdapter
+ *
+ * The prototype matches that of the "_process()" functions of the SAF
+ * examples, and the function is always called with nSamples==frameSize.
+ */
+typedef void (*saf_blockAdapter_frameFunc)(void* const hProc,
+                                           const float* const* inputs,
+                                           float* const* const outputs,
+                                           int nInputs,
+                                           int nOutputs,
+                                           int nSamples);
+
+
+/* ========================================================================== */
+/*                               Block Adapter                                */
+/* ========================================================================== */
+
+/**
+ * Creates an instance of saf_blockAdapter
+ *
+ * @test test__saf_blockAdapter()
+ *
+ * @param[in] phBA          (&) address of saf_blockAdapter handle
+ * @param[in] frameSize     Frame size of the processing function, in samples
+ * @param[in] maxNumInputs  Maximum number of input channels
+ * @param[in] maxNumOutputs Maximum number of output channels
+ */
+void saf_blockAdapter_create(void ** const phBA,
+                             int frameSize,
+                             int maxNumInputs,
+                             int maxNumOutputs);
+
+/**
+ * Destroys an instance of saf_blockAdapter
+ *
+ * @param[in] phBA (&) address of saf_blockAdapter handle
+ */
+void saf_blockAdapter_destroy(void ** const phBA);
+
+/**
+ * Flushes the internal buffers, and sets the latency for the given host block
+ * size
+ *
+ * Passing the host block size allows saf_blockAdapter_getLatency() to report
+ * the latency before the first block is processed. If it is 0 (unknown), then
+ * the latency is instead established by the first block.
+ *
+ * @warning This should not be called while saf_blockAdapter_process() is
+ *          on-going!
+ *
+ * @param[in] hBA       saf_blockAdapter handle
+ * @param[in] blockSize Host block size (the largest, if it varies), or 0 if
+ *                      unknown
+ */
+void saf_blockAdapter_reset(void * const hBA,
+                            int blockSize);
+
+/**
+ * Passes a block of host signals through a frame processing function
+ *
+ * The latency is established by saf_blockAdapter_reset() (or by the first
+ * block, if the host block size was not given), and is increased (once, which
+ * causes a short gap in the output) if a later block is not an integer
+ * multiple of the sizes seen so far.
+ *
+ * @note If the latency is 0, and the blocks are integer multiples of the frame
+ *       size, then "frameFunc" is called directly on the host buffers.
+ *       Input/output channels beyond maxNumInputs/maxNumOutputs are ignored and
+ *       zeroed, respectively.
+ *
+ * @param[in]  hBA       saf_blockAdapter handle
+ * @param[in]  inputs    Input channel buffers; 2-D array: nInputs x nSamples
+ * @param[out] outputs   Output channel buffers; 2-D array: nOutputs x nSamples
+ * @param[in]  nInputs   Number of input channels
+ * @param[in]  nOutputs  Number of output channels
+ * @param[in]  nSamples  Number of samples in 'inputs'/'outputs'
+ * @param[in]  frameFunc Frame processing function
+ * @param[in]  hProc     Handle to pass to "frameFunc"
+ */
+void saf_blockAdapter_process(void * const hBA,
+                              const float* const* inputs,
+                              float* const* const outputs,
+                              int nInputs,
+                              int nOutputs,
+                              int nSamples,
+                              saf_blockAdapter_frameFunc frameFunc,
+                              void* const hProc);
+
+/**
+ * Returns the latency introduced by the block adapter, in samples (0 until the
+ * first block has been processed, if saf_blockAdapter_reset() was not given the
+ * host block size)
+ *
+ * @param[in] hBA saf_blockAdapter handle
+ */
+int saf_blockAdapter_getLatency(void * const hBA);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* SAF_BLOCKADAPTER_H_INCLUDED */
+
+/**@} */ /* doxygen addtogroup Utilities */
@@ -48,11 +48,16 @@
 typedef struct _saf_stft_data {
     int winsize, hopsize, fftsize, nCHin, nCHout, nBands;
     void* hFFT;
-    int numOvrlpAddBlocks, bufferlength, nPrevHops;
-    float* window, *insig_rect_win, *insig_win, *outsig_win;
-    float** overlapAddBuffer;
-    float*** prev_inhops;
-    float_complex* tmp_fft;
+    int numOvrlpAddBlocks, bufferlength;
+    int inRingPos;            /* Hop of "inRing" to write next */
+    int ovrlpAddRingPos;      /* Hop of "overlapAddBuffer" to output next */
+    float ovrlpAddGain;       /* Compensates for the summation of the overlapping windows (if enabled) */
+    float* window;
+    float** insig_win;        /* nCHin x fftsize (zero-padded) */
+    float** outsig_win;       /* nCHout x fftsize */
+    float** inRing;           /* Input history, a ring buffer of winsize/hopsize hops; nCHin x winsize */
+    float** overlapAddBuffer; /* A ring buffer of 2*winsize/hopsize hops; nCHout x bufferlength */
+    float_complex* tmp_fft;   /* max(nCHin, nCHout) x nBands */
     SAF_STFT_FDDATA_FORMAT FDformat;
 
 }saf_stft_data;
@@ -62,9 +67,13 @@ typedef struct _saf_rfft_data {
     int N;
     float  Scale;
     int useKissFFT_FLAG;
+    int batchLayout_fwd[3]; /* howMany, input stride, output stride of the batched forward transform (see saf_rfft_prepareBatch()) */
+    int batchLayout_bwd[3]; /* howMany, input stride, output stride of the batched backward transform (see saf_rfft_prepareBatch()) */
 #if defined(SAF_USE_FFTW)
     fftwf_plan p_fwd;
     fftwf_plan p_bwd;
+    fftwf_plan p_fwd_batch;
+    fftwf_plan p_bwd_batch;
     float* fwd_bufferTD;
     float* bwd_bufferTD;
     fftwf_complex* fwd_bufferFD;
@@ -89,11 +98,19 @@ typedef struct _saf_rfft_data {
 # endif
 #elif defined(SAF_USE_INTEL_MKL_LP64) || defined(SAF_USE_INTEL_MKL_ILP64)
     DFTI_DESCRIPTOR_HANDLE MKL_FFT_Handle;
+    DFTI_DESCRIPTOR_HANDLE MKL_FFT_Handle_fwdBatch;
+    DFTI_DESCRIPTOR_HANDLE MKL_FFT_Handle_bwdBatch;
     MKL_LONG input_strides[2], output_strides[2], Status;
 #endif
     /* DEFAULT: */
     kiss_fftr_cfg kissFFThandle_fwd;
     kiss_fftr_cfg kissFFThandle_bkw;
+#ifdef KISS_FFTR4_ENABLED
+    kiss_fftr4_cfg kissFFT4handle_fwd; /* Four transforms at once, for the batched transforms (NULL: not prepared) */
+    kiss_fftr4_cfg kissFFT4handle_bkw;
+    float* kiss4_bufferTD;             /* N x 4 */
+    float* kiss4_bufferFD;             /* (N/2+1) x {4 real parts, 4 imaginary parts} */
+#endif
 
 }saf_rfft_data;
 
@@ -138,6 +155,170 @@ typedef struct _saf_fft_data {
 }saf_fft_data;
 
 
+/* ========================================================================== */
+/*                                FFT Planning                                */
+/* ========================================================================== */
+
+/** Current planner rigour; see #SAF_FFT_PLANNER_RIGOUR */
+static volatile long saf_fft_plannerRigour = (long)SAF_FFT_PLANNER_ESTIMATE;
+
+#if defined(SAF_USE_FFTW)
+/** Types of FFTW plans, which are shared via the plan cache */
+typedef enum {
+    SAF_FFTW_PLAN_R2C,     /**< Real to half-complex */
+    SAF_FFTW_PLAN_C2R,     /**< Half-complex to real */
+    SAF_FFTW_PLAN_C2C_FWD, /**< Complex to complex (forward) */
+    SAF_FFTW_PLAN_C2C_BWD  /**< Complex to complex (backward) */
+
+}SAF_FFTW_PLAN_TYPES;
+
+/** An entry in the FFTW plan cache */
+typedef struct _saf_fftw_cachedPlan {
+    int N;                 /**< FFT size */
+    SAF_FFTW_PLAN_TYPES type; /**< Plan type */
+    unsigned int flags;    /**< Planner flags the plan was made with */
+    int refCount;          /**< Number of instances employing the plan */
+    fftwf_plan plan;       /**< The plan */
+    struct _saf_fftw_cachedPlan* next; /**< Next entry (NULL: last) */
+
+}saf_fftw_cachedPlan;
+
+/** Plans shared by all saf_rfft/saf_fft instances */
+static saf_fftw_cachedPlan* saf_fftw_planCache = NULL;
+/** Guards the plan cache, and all calls to the FFTW planner (which is not thread-safe) */
+static volatile long saf_fftw_plannerLock = 0;
+
+/** Returns the FFTW planner flags for the current planner rigour */
+static unsigned int saf_fftw_getPlannerFlags(void)
+{
+    switch((SAF_FFT_PLANNER_RIGOUR)saf_atomic_load(&saf_fft_plannerRigour)){
+        default: /* fall through */
+        case SAF_FFT_PLANNER_ESTIMATE: return FFTW_ESTIMATE;
+        case SAF_FFT_PLANNER_MEASURE:  return FFTW_MEASURE;
+        case SAF_FFT_PLANNER_PATIENT:  return FFTW_PATIENT;
+    }
+}
+
+/**
+ * Returns a plan of the requested type and size from the plan cache (which is
+ * made if it does not yet exist). The plan must be executed with the new-array
+ * execute functions, on arrays allocated with fftwf_malloc(), and later
+ * released with saf_fftw_releasePlan()
+ */
+static fftwf_plan saf_fftw_acquirePlan
+(
+    int N,
+    SAF_FFTW_PLAN_TYPES type
+)
+{
+    unsigned int flags;
+    saf_fftw_cachedPlan* entry;
+    fftwf_complex* in, *out;
+
+    flags = saf_fftw_getPlannerFlags();
+    saf_spinLock_lock(&saf_fftw_plannerLock);
+    for(entry=saf_fftw_planCache; entry!=NULL; entry=entry->next){
+        if(entry->N==N && entry->type==type && entry->flags==flags){
+            entry->refCount++;
+            saf_spinLock_unlock(&saf_fftw_plannerLock);
+            return entry->plan;
+        }
+    }
+
+    /* Not cached yet. Note that the FFTW_MEASURE/PATIENT planners overwrite the arrays, hence the scratch */
+    in = fftwf_malloc(N*sizeof(fftwf_complex));
+    out = fftwf_malloc(N*sizeof(fftwf_complex));
+    entry = malloc1d(sizeof(saf_fftw_cachedPlan));
+    entry->N = N;
+    entry->type = type;
+    entry->flags = flags;
+    entry->refCount = 1;
+    switch(type){
+        case SAF_FFTW_PLAN_R2C:     entry->plan = fftwf_plan_dft_r2c_1d(N, (float*)in, out, flags); break;
+        case SAF_FFTW_PLAN_C2R:     entry->plan = fftwf_plan_dft_c2r_1d(N, in, (float*)out, flags); break;
+        case SAF_FFTW_PLAN_C2C_FWD: entry->plan = fftwf_plan_dft_1d(N, in, out, FFTW_FORWARD, flags); break;
+        case SAF_FFTW_PLAN_C2C_BWD: entry->plan = fftwf_plan_dft_1d(N, in, out, FFTW_BACKWARD, flags); break;
+    }
+    entry->next = saf_fftw_planCache;
+    saf_fftw_planCache = entry;
+    saf_spinLock_unlock(&saf_fftw_plannerLock);
+    fftwf_free(in);
+    fftwf_free(out);
+    return entry->plan;
+}
+
+/** Releases a plan obtained with saf_fftw_acquirePlan() (destroying it, if it is no longer employed) */
+static void saf_fftw_releasePlan
+(
+    fftwf_plan plan
+)
+{
+    saf_fftw_cachedPlan** pEntry, *entry;
+
+    saf_spinLock_lock(&saf_fftw_plannerLock);
+    for(pEntry=&saf_fftw_planCache; *pEntry!=NULL; pEntry=&((*pEntry)->next)){
+        entry = *pEntry;
+        if(entry->plan==plan){
+            if(--(entry->refCount)==0){
+                *pEntry = entry->next;
+                fftwf_destroy_plan(entry->plan);
+                free(entry);
+            }
+            break;
+        }
+    }
+    saf_spinLock_unlock(&saf_fftw_plannerLock);
+}
+#endif
+
+void saf_fft_setPlannerRigour
+(
+    SAF_FFT_PLANNER_RIGOUR rigour
+)
+{
+    saf_atomic_store(&saf_fft_plannerRigour, (long)rigour);
+}
+
+SAF_FFT_PLANNER_RIGOUR saf_fft_getPlannerRigour(void)
+{
+    return (SAF_FFT_PLANNER_RIGOUR)saf_atomic_load(&saf_fft_plannerRigour);
+}
+
+int saf_fft_importWisdom
+(
+    const char* filename
+)
+{
+#if defined(SAF_USE_FFTW)
+    int success;
+    saf_spinLock_lock(&saf_fftw_plannerLock);
+    success = fftwf_import_wisdom_from_filename(filename);
+    saf_spinLock_unlock(&saf_fftw_plannerLock);
+    return success ? 1 : 0;
+#else
+    SAF_UNUSED(filename);
+    return 0;
+#endif
+}
+
+int saf_fft_exportWisdom
+(
+    const char* filename
+)
+{
+#if defined(SAF_USE_FFTW)
+    int success;
+    saf_spinLock_lock(&saf_fftw_plannerLock);
+    success = fftwf_export_wisdom_to_filename(filename);
+    saf_spinLock_unlock(&saf_fftw_plannerLock);
+    return success ? 1 : 0;
+#else
+    SAF_UNUSED(filename);
+    return 0;
+#endif
+}
+
+
 /* ========================================================================== */
 /*                               Misc. Functions                              */
 /* ========================================================================== */
@@ -154,6 +335,18 @@ void getUniformFreqVector
         freqVector[k] = (float)k * fs/(float)fftSize;
 }
 
+/** Returns the block size for saf_fftconv, for a one-off convolution */
+static int fftconv_getBlockSize(int x_len, int h_len)
+{
+    int fftSize;
+
+    /* Large enough to be efficient, but no larger than one FFT of the whole
+     * output, and bounded for long signals */
+    fftSize = SAF_MAX(nextpow2(4*h_len), 4096);
+    fftSize = SAF_MIN(fftSize, nextpow2(x_len+h_len-1));
+    return fftSize-h_len+1;
+}
+
 void fftconv
 (
     float* x,
@@ -164,47 +357,19 @@ void fftconv
     float* y
 )
 {
-    int i, y_len, fftSize, nBins;
-    float* h0, *x0, *y0;
-    float_complex* H, *X, *Y;
-    void* hfft;
-    
+    int y_len;
+    void* hFC;
+
     /* prep */
     y_len = x_len + h_len - 1;
-    fftSize =  (int)((float)nextpow2(y_len)+0.5f);
-    nBins = fftSize/2+1;
-    h0 = calloc1d(fftSize, sizeof(float));
-    x0 = calloc1d(fftSize, sizeof(float));
-    y0 = malloc1d(fftSize * sizeof(float));
-    H = malloc1d(nBins*sizeof(float_complex));
-    X = malloc1d(nBins*sizeof(float_complex));
-    Y = malloc1d(nBins*sizeof(float_complex));
-    saf_rfft_create(&hfft, fftSize);
-    
-    /* apply convolution per channel */
-    for(i=0; i<nCH; i++){
-        /* zero pad to avoid circular convolution artefacts, prior to fft */
-        memcpy(h0, &h[i*h_len], h_len*sizeof(float));
-        memcpy(x0, &x[i*x_len], x_len*sizeof(float));
-        saf_rfft_forward(hfft, x0, X);
-        saf_rfft_forward(hfft, h0, H);
-        
-        /* multiply the two spectra */
-        utility_cvvmul(X, H, nBins, Y);
-        
-        /* ifft, truncate and store to output */
-        saf_rfft_backward(hfft, Y, y0);
-        memcpy(&y[i*y_len], y0, y_len*sizeof(float));
-    }
-    
+    saf_fftconv_create(&hFC, h, h_len, nCH, fftconv_getBlockSize(x_len, h_len), 1, NULL);
+
+    /* filter the input, and then flush the filter tails */
+    saf_fftconv_apply(hFC, x, x_len, x_len, y, y_len);
+    saf_fftconv_apply(hFC, NULL, 0, h_len-1, &y[x_len], y_len);
+
     /* tidy up */
-    saf_rfft_destroy(&hfft);
-    free(h0);
-    free(x0);
-    free(y0);
-    free(H);
-    free(X);
-    free(Y);
+    saf_fftconv_destroy(&hFC);
 }
 
 void fftfilt
@@ -217,14 +382,11 @@ void fftfilt
     float* y
 )
 {
-    int i;
-    float* y_tmp;
-    
-    y_tmp = malloc1d(nCH*(x_len+h_len-1)*sizeof(float));
-    fftconv(x, h, x_len, h_len, nCH, y_tmp);
-    for(i=0; i<nCH; i++)
-        memcpy(&y[i*x_len], &y_tmp[i*(x_len+h_len-1)], x_len*sizeof(float));
-    free(y_tmp);
+    void* hFC;
+
+    saf_fftconv_create(&hFC, h, h_len, nCH, fftconv_getBlockSize(x_len, h_len), 1, NULL);
+    saf_fftconv_apply(hFC, x, x_len, x_len, y, x_len);
+    saf_fftconv_destroy(&hFC);
 }
 
 void hilbert
@@ -317,17 +479,18 @@ void saf_stft_create
     /* set-up FFT */
     h->fftsize = 2*winsize;
     saf_rfft_create(&(h->hFFT), h->fftsize);
-    h->insig_rect_win = calloc1d(h->fftsize, sizeof(float));
-    h->insig_win = calloc1d(h->fftsize, sizeof(float));
+    saf_rfft_prepareBatch(h->hFFT, h->fftsize, h->nBands, nCHin, nCHout);
 
     /* Intermediate buffers */
-    h->tmp_fft = malloc1d(h->nBands * sizeof(float_complex));
-    h->outsig_win = malloc1d(h->fftsize*sizeof(float));
-    h->nPrevHops = winsize/hopsize-1;
-    if (h->nPrevHops>0)
-        h->prev_inhops = (float***)calloc3d(h->nPrevHops, nCHin, hopsize, sizeof(float));
+    h->insig_win = (float**)calloc2d(nCHin, h->fftsize, sizeof(float)); /* the zero-padding is never overwritten */
+    h->outsig_win = (float**)malloc2d(nCHout, h->fftsize, sizeof(float));
+    h->tmp_fft = malloc1d(SAF_MAX(nCHin, nCHout) * (h->nBands) * sizeof(float_complex));
+    h->numOvrlpAddBlocks = winsize/hopsize;
+    h->inRingPos = 0;
+    if (h->numOvrlpAddBlocks>1)
+        h->inRing = (float**)calloc2d(nCHin, winsize, sizeof(float));
     else
-        h->prev_inhops = NULL;
+        h->inRing = NULL;
 
     /* Windowing function */
     if(winsize==hopsize)
@@ -336,10 +499,11 @@ void saf_stft_create
         h->window = malloc1d(winsize*sizeof(float));
         getWindowingFunction(WINDOWING_FUNCTION_HANN, winsize, h->window);
     }
+    h->ovrlpAddGain = 1.0f; /* (see saf_stft_setOverlapAddNormalisation()) */
 
-    /* Overlap-add buffer */
-    h->numOvrlpAddBlocks = winsize/hopsize;
-    h->bufferlength = h->numOvrlpAddBlocks * (h->fftsize);
+    /* Overlap-add buffer (the inverse FFT output spans 2*numOvrlpAddBlocks hops) */
+    h->bufferlength = h->fftsize;
+    h->ovrlpAddRingPos = 0;
     h->overlapAddBuffer = (float**)calloc2d(nCHout, h->bufferlength, sizeof(float));
 }
 
@@ -353,10 +517,10 @@ void saf_stft_destroy
         saf_rfft_destroy(&(h->hFFT));
         free(h->window);
         free(h->overlapAddBuffer);
-        free(h->insig_rect_win);
         free(h->insig_win);
+        free(h->outsig_win);
         free(h->tmp_fft);
-        free(h->prev_inhops);
+        free(h->inRing);
         free(h);
         h=NULL;
         *phSTFT = NULL;
@@ -373,65 +537,51 @@ void saf_stft_forward
 )
 {
     saf_stft_data *h = (saf_stft_data*)(hSTFT);
-    int ch, j, nHops, t, band, idx, hIdx;
+    int ch, nHops, t, band, lenOld;
 
     saf_assert(framesize % h->hopsize == 0, "framesize must be multiple of hopsize");  
     nHops = framesize/h->hopsize;
 
-    /* For linear time-invariant (LTI) operation (i.e. no previous hops are
-     * required) */
-    if(h->winsize==h->hopsize){
-        for (t = 0; t<nHops; t++){
-            for(ch=0; ch < h->nCHin; ch++){
-                /* Window input signal (Rectangular) */
-                memcpy(h->insig_rect_win, &dataTD[ch][t*(h->hopsize)], h->winsize*sizeof(float));
-
-                /* Apply FFT and copy data to output dataFD buffer */
-                switch(h->FDformat){
-                    case SAF_STFT_TIME_CH_BANDS:
-                        saf_rfft_forward(h->hFFT, h->insig_rect_win, dataFD[t][ch]);
-                        break;
-
-                    case SAF_STFT_BANDS_CH_TIME:
-                        saf_rfft_forward(h->hFFT, h->insig_rect_win, h->tmp_fft);
-                        for(band=0; band<h->nBands; band++)
-                            dataFD[band][ch][t] = h->tmp_fft[band];
-                        break;
-                }
-            }
+    for (t = 0; t<nHops; t++){
+        /* For linear time-invariant (LTI) operation (i.e. no previous hops are
+         * required) */
+        if(h->winsize==h->hopsize){
+            /* Window input signal (Rectangular) */
+            for(ch=0; ch < h->nCHin; ch++)
+                memcpy(h->insig_win[ch], &dataTD[ch][t*(h->hopsize)], h->winsize*sizeof(float));
         }
-    }
-    /* For oversampled TF transforms */
-    else{
-        idx = 0;
-        for (t = 0; t<nHops; t++){
+        /* For oversampled TF transforms */
+        else{
+            /* The new hop overwrites the oldest hop in the input history. The
+             * window is then applied in two parts: the older hops (from the
+             * write position to the end of the ring), followed by the newer
+             * ones; so the history is never shifted */
+            lenOld = h->winsize - (h->inRingPos+1)*(h->hopsize);
             for(ch=0; ch < h->nCHin; ch++){
-                hIdx = 0;
-                /* Window input signal */
-                while (hIdx < h->winsize){
-                    memcpy(&(h->insig_rect_win[hIdx]), h->prev_inhops[0][ch], h->hopsize*sizeof(float));
-                    for(j=0; j< h->nPrevHops-1; j++)
-                        memcpy(h->prev_inhops[j][ch], h->prev_inhops[j+1][ch], h->hopsize*sizeof(float));
-                    memcpy(h->prev_inhops[h->nPrevHops-1][ch], &dataTD[ch][idx], h->hopsize*sizeof(float));
-                    hIdx += h->hopsize;
-                }
-                utility_svvmul(h->insig_rect_win, h->window, h->winsize, h->insig_win);
-
-                /* Apply FFT and copy data to output dataFD buffer */
-                switch(h->FDformat){
-                    case SAF_STFT_TIME_CH_BANDS:
-                        saf_rfft_forward(h->hFFT, h->insig_win, dataFD[t][ch]);
-                        break;
-
-                    case SAF_STFT_BANDS_CH_TIME:
-                        saf_rfft_forward(h->hFFT, h->insig_win, h->tmp_fft);
-                        for(band=0; band<h->nBands; band++)
-                            dataFD[band][ch][t] = h->tmp_fft[band];
-                        break;
-                }
+                memcpy(&(h->inRing[ch][h->inRingPos*(h->hopsize)]), &dataTD[ch][t*(h->hopsize)], h->hopsize*sizeof(float));
+                if(lenOld>0)
+                    utility_svvmul(&(h->inRing[ch][h->winsize-lenOld]), h->window, lenOld, h->insig_win[ch]);
+                utility_svvmul(h->inRing[ch], &(h->window[lenOld]), h->winsize-lenOld, &(h->insig_win[ch][lenOld]));
             }
-            idx += h->hopsize;
-        } 
+            h->inRingPos++;
+            if(h->inRingPos == h->numOvrlpAddBlocks)
+                h->inRingPos = 0;
+        }
+
+        /* Apply FFT and copy data to output dataFD buffer */
+        switch(h->FDformat){
+            case SAF_STFT_TIME_CH_BANDS:
+                for(ch=0; ch < h->nCHin; ch++)
+                    saf_rfft_forward(h->hFFT, h->insig_win[ch], dataFD[t][ch]);
+                break;
+
+            case SAF_STFT_BANDS_CH_TIME:
+                saf_rfft_forward_batch(h->hFFT, FLATTEN2D(h->insig_win), h->fftsize, h->tmp_fft, h->nBands, h->nCHin);
+                for(band=0; band<h->nBands; band++)
+                    for(ch=0; ch < h->nCHin; ch++)
+                        dataFD[band][ch][t] = h->tmp_fft[ch*(h->nBands)+band];
+                break;
+        }
     }
 }
 
@@ -444,35 +594,40 @@ void saf_stft_backward
 )
 {
     saf_stft_data *h = (saf_stft_data*)(hSTFT);
-    int t, ch, nHops, band;
+    int t, ch, nHops, band, pos, lenEnd;
 
     saf_assert(framesize % h->hopsize == 0, "framesize must be multiple of hopsize");
     nHops = framesize/h->hopsize;
 
     for (t = 0; t<nHops; t++){
-        for(ch=0; ch < h->nCHout; ch++){
-            /* Shift data down */
-            memcpy(h->overlapAddBuffer[ch], h->overlapAddBuffer[ch] + h->hopsize, (h->numOvrlpAddBlocks-1)*(h->hopsize)*sizeof(float));
-
-            /* Append with zeros */
-            memset(h->overlapAddBuffer[ch] + (h->numOvrlpAddBlocks-1)*(h->hopsize), 0, h->hopsize*sizeof(float));
-
-            /* Apply inverse FFT */
-            switch(h->FDformat){
-                case SAF_STFT_TIME_CH_BANDS:
-                    saf_rfft_backward(h->hFFT, dataFD[t][ch], h->outsig_win);
-                    break;
-                case SAF_STFT_BANDS_CH_TIME:
-                    for(band=0; band<h->nBands; band++)
-                        h->tmp_fft[band] = dataFD[band][ch][t];
-                    saf_rfft_backward(h->hFFT, h->tmp_fft, h->outsig_win);
-                    break;
-            }
+        /* Apply inverse FFT */
+        switch(h->FDformat){
+            case SAF_STFT_TIME_CH_BANDS:
+                for(ch=0; ch < h->nCHout; ch++)
+                    saf_rfft_backward(h->hFFT, dataFD[t][ch], h->outsig_win[ch]);
+                break;
+            case SAF_STFT_BANDS_CH_TIME:
+                for(band=0; band<h->nBands; band++)
+                    for(ch=0; ch < h->nCHout; ch++)
+                        h->tmp_fft[ch*(h->nBands)+band] = dataFD[band][ch][t];
+                saf_rfft_backward_batch(h->hFFT, h->tmp_fft, h->nBands, FLATTEN2D(h->outsig_win), h->fftsize, h->nCHout);
+                break;
+        }
 
-            /* Overlap-Add 1:hopsize to output buffer */
-            cblas_saxpy(h->fftsize, 1.0f, h->outsig_win, 1, h->overlapAddBuffer[ch], 1);
-            memcpy(dataTD[ch] + t*(h->hopsize), h->overlapAddBuffer[ch], h->hopsize*sizeof(float));
+        /* Overlap-add to the ring buffer (from the current position, and wrapping around to the start), then output the
+         * current hop and clear it, since it becomes the last hop of the ring */
+        pos = h->ovrlpAddRingPos*(h->hopsize);
+        lenEnd = h->bufferlength - pos;
+        for(ch=0; ch < h->nCHout; ch++){
+            cblas_saxpy(lenEnd, h->ovrlpAddGain, h->outsig_win[ch], 1, &(h->overlapAddBuffer[ch][pos]), 1);
+            if(pos>0)
+                cblas_saxpy(pos, h->ovrlpAddGain, &(h->outsig_win[ch][lenEnd]), 1, h->overlapAddBuffer[ch], 1);
+            memcpy(dataTD[ch] + t*(h->hopsize), &(h->overlapAddBuffer[ch][pos]), h->hopsize*sizeof(float));
+            memset(&(h->overlapAddBuffer[ch][pos]), 0, h->hopsize*sizeof(float));
         }
+        h->ovrlpAddRingPos++;
+        if(h->ovrlpAddRingPos == 2*(h->numOvrlpAddBlocks))
+            h->ovrlpAddRingPos = 0;
     }
 }
 
@@ -482,11 +637,24 @@ void saf_stft_flushBuffers
 )
 {
     saf_stft_data *h = (saf_stft_data*)(hSTFT);
-    if(h->nPrevHops > 0)
-        memset(FLATTEN3D(h->prev_inhops), 0, h->nPrevHops * (h->nCHin) * (h->hopsize) * sizeof(float));
+    if(h->inRing!=NULL)
+        memset(FLATTEN2D(h->inRing), 0, (h->nCHin) * (h->winsize) * sizeof(float));
     memset(FLATTEN2D(h->overlapAddBuffer), 0, h->nCHout * (h->bufferlength) * sizeof(float));
 }
 
+void saf_stft_setOverlapAddNormalisation
+(
+    void * const hSTFT,
+    int normaliseFLAG
+)
+{
+    saf_stft_data *h = (saf_stft_data*)(hSTFT);
+    if(normaliseFLAG && h->window!=NULL)
+        h->ovrlpAddGain = 2.0f/(float)h->numOvrlpAddBlocks; /* The Hann windows sum to numOvrlpAddBlocks/2 */
+    else
+        h->ovrlpAddGain = 1.0f;
+}
+
 void saf_stft_channelChange
 (
     void * const hSTFT,
@@ -495,17 +663,23 @@ void saf_stft_channelChange
 )
 {
     saf_stft_data *h = (saf_stft_data*)(hSTFT);
-    int i, ch;
+    int ch;
 
-    if(new_nCHin != h->nCHin && h->nPrevHops > 0){
+    if(SAF_MAX(new_nCHin, new_nCHout) != SAF_MAX(h->nCHin, h->nCHout))
+        h->tmp_fft = realloc1d(h->tmp_fft, SAF_MAX(new_nCHin, new_nCHout) * (h->nBands) * sizeof(float_complex));
+
+    if(new_nCHin != h->nCHin){
         /* Reallocate memory while retaining previous values (which will be
          * truncated if new_nCHin < nCHin) */
-        h->prev_inhops = (float***)realloc3d_r((void***)h->prev_inhops, h->nPrevHops, new_nCHin, h->hopsize,
-                                               h->nPrevHops, h->nCHin, h->hopsize, sizeof(float));
-        /* Zero new channels if new_nCHin > nCHin */
-        for(i=0; i< h->nPrevHops; i++)
+        if(h->inRing!=NULL){
+            h->inRing = (float**)realloc2d_r((void**)h->inRing, new_nCHin, h->winsize, h->nCHin, h->winsize, sizeof(float));
+            /* Zero new channels if new_nCHin > nCHin */
             for(ch=h->nCHin; ch<new_nCHin; ch++)
-                memset(h->prev_inhops[i][ch], 0, h->hopsize * sizeof(float));
+                memset(h->inRing[ch], 0, h->winsize * sizeof(float));
+        }
+        h->insig_win = (float**)realloc2d_r((void**)h->insig_win, new_nCHin, h->fftsize, h->nCHin, h->fftsize, sizeof(float));
+        for(ch=h->nCHin; ch<new_nCHin; ch++)
+            memset(h->insig_win[ch], 0, h->fftsize * sizeof(float));
 
         h->nCHin = new_nCHin;
     }
@@ -518,9 +692,13 @@ void saf_stft_channelChange
         /* Zero new channels if new_nCHout > nCHout */
         for(ch=h->nCHout; ch<new_nCHout; ch++)
             memset(h->overlapAddBuffer[ch], 0, h->bufferlength * sizeof(float));
+        h->outsig_win = (float**)realloc2d((void**)h->outsig_win, new_nCHout, h->fftsize, sizeof(float));
 
         h->nCHout = new_nCHout;
     }
+
+    /* Re-plan the batched transforms for the new channel counts */
+    saf_rfft_prepareBatch(h->hFFT, h->fftsize, h->nBands, h->nCHin, h->nCHout);
 }
 
 
@@ -528,6 +706,21 @@ void saf_stft_channelChange
 /*                Real<->Half-Complex (Conjugate-Symmetric) FFT               */
 /* ========================================================================== */
 
+#ifdef KISS_FFTR4_ENABLED
+/** Frees the four-at-once kissFFT handles and buffers (if any) */
+static void saf_rfft_releaseKiss4(saf_rfft_data* h)
+{
+    if(h->kissFFT4handle_fwd!=NULL)
+        kiss_fftr4_free(h->kissFFT4handle_fwd);
+    if(h->kissFFT4handle_bkw!=NULL)
+        kiss_fftr4_free(h->kissFFT4handle_bkw);
+    free1d_aligned(h->kiss4_bufferTD);
+    free1d_aligned(h->kiss4_bufferFD);
+    h->kissFFT4handle_fwd = h->kissFFT4handle_bkw = NULL;
+    h->kiss4_bufferTD = h->kiss4_bufferFD = NULL;
+}
+#endif
+
 void saf_rfft_create
 (
     void ** const phFFT,
@@ -541,13 +734,20 @@ void saf_rfft_create
     h->Scale = 1.0f/(float)N; /* output scaling after ifft */
     saf_assert(N>=2 && ISEVEN(N), "Only even (non zero) FFT sizes are supported");
     h->useKissFFT_FLAG = 0;
+    memset(h->batchLayout_fwd, 0, 3*sizeof(int));
+    memset(h->batchLayout_bwd, 0, 3*sizeof(int));
+#ifdef KISS_FFTR4_ENABLED
+    h->kissFFT4handle_fwd = h->kissFFT4handle_bkw = NULL;
+    h->kiss4_bufferTD = h->kiss4_bufferFD = NULL;
+#endif
 #if defined(SAF_USE_FFTW)
-    h->fwd_bufferTD = malloc1d(h->N*sizeof(float));
-    h->bwd_bufferTD = malloc1d(h->N*sizeof(float));
-    h->fwd_bufferFD = malloc1d((h->N/2+1)*sizeof(fftwf_complex));
-    h->bwd_bufferFD = malloc1d((h->N/2+1)*sizeof(fftwf_complex));
-    h->p_fwd = fftwf_plan_dft_r2c_1d(h->N, h->fwd_bufferTD, h->fwd_bufferFD, FFTW_ESTIMATE);
-    h->p_bwd = fftwf_plan_dft_c2r_1d(h->N, h->bwd_bufferFD, h->bwd_bufferTD, FFTW_ESTIMATE);
+    h->p_fwd_batch = h->p_bwd_batch = NULL;
+    h->fwd_bufferTD = fftwf_malloc(h->N*sizeof(float));
+    h->bwd_bufferTD = fftwf_malloc(h->N*sizeof(float));
+    h->fwd_bufferFD = fftwf_malloc((h->N/2+1)*sizeof(fftwf_complex));
+    h->bwd_bufferFD = fftwf_malloc((h->N/2+1)*sizeof(fftwf_complex));
+    h->p_fwd = saf_fftw_acquirePlan(h->N, SAF_FFTW_PLAN_R2C);
+    h->p_bwd = saf_fftw_acquirePlan(h->N, SAF_FFTW_PLAN_C2R);
 #elif defined(SAF_USE_INTEL_IPP)
     /* Use ippsFFT if N is 2^x, otherwise, use ippsDFT */
     if((int)(log2f((float)N)+1.0f) == (int)(log2f((float)N))){
@@ -592,6 +792,7 @@ void saf_rfft_create
     }
 #elif defined(SAF_USE_INTEL_MKL_LP64) || defined(SAF_USE_INTEL_MKL_ILP64)
     h->MKL_FFT_Handle = 0;
+    h->MKL_FFT_Handle_fwdBatch = h->MKL_FFT_Handle_bwdBatch = 0;
     h->Status = DftiCreateDescriptor(&(h->MKL_FFT_Handle), DFTI_SINGLE, DFTI_REAL, 1, h->N); /* 1-D, single precision, real_input->fft->half_complex->ifft->real_output */
     h->Status = DftiSetValue(h->MKL_FFT_Handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE); /* Not inplace, i.e. output has its own dedicated memory */
     /* specify output format as complex conjugate-symmetric data. This is the same as MatLab, except only the
@@ -621,12 +822,18 @@ void saf_rfft_destroy
     saf_rfft_data *h = (saf_rfft_data*)(*phFFT);
     if(h!=NULL){
 #if defined(SAF_USE_FFTW)
-        free(h->fwd_bufferTD);
-        free(h->bwd_bufferTD);
-        free(h->fwd_bufferFD);
-        free(h->bwd_bufferFD);
-        fftwf_destroy_plan(h->p_bwd);
-        fftwf_destroy_plan(h->p_fwd);
+        fftwf_free(h->fwd_bufferTD);
+        fftwf_free(h->bwd_bufferTD);
+        fftwf_free(h->fwd_bufferFD);
+        fftwf_free(h->bwd_bufferFD);
+        saf_fftw_releasePlan(h->p_bwd);
+        saf_fftw_releasePlan(h->p_fwd);
+        saf_spinLock_lock(&saf_fftw_plannerLock);
+        if(h->p_fwd_batch!=NULL)
+            fftwf_destroy_plan(h->p_fwd_batch);
+        if(h->p_bwd_batch!=NULL)
+            fftwf_destroy_plan(h->p_bwd_batch);
+        saf_spinLock_unlock(&saf_fftw_plannerLock);
 #elif defined(SAF_USE_INTEL_IPP)
         if(h->useIPPfft_FLAG){
             if(h->memSpec)
@@ -654,11 +861,18 @@ void saf_rfft_destroy
         }
 #elif defined(SAF_USE_INTEL_MKL_LP64) || defined(SAF_USE_INTEL_MKL_ILP64)
         h->Status = DftiFreeDescriptor(&(h->MKL_FFT_Handle));
+        if(h->MKL_FFT_Handle_fwdBatch!=0)
+            h->Status = DftiFreeDescriptor(&(h->MKL_FFT_Handle_fwdBatch));
+        if(h->MKL_FFT_Handle_bwdBatch!=0)
+            h->Status = DftiFreeDescriptor(&(h->MKL_FFT_Handle_bwdBatch));
 #endif
         if(h->useKissFFT_FLAG){
             kiss_fftr_free(h->kissFFThandle_fwd);
             kiss_fftr_free(h->kissFFThandle_bkw);
         }
+#ifdef KISS_FFTR4_ENABLED
+        saf_rfft_releaseKiss4(h);
+#endif
 
         free(h);
         h = NULL;
@@ -677,7 +891,7 @@ void saf_rfft_forward
 
 #if defined(SAF_USE_FFTW)
     cblas_scopy(h->N, inputTD, 1, h->fwd_bufferTD, 1);
-    fftwf_execute(h->p_fwd);
+    fftwf_execute_dft_r2c(h->p_fwd, h->fwd_bufferTD, h->fwd_bufferFD);
     cblas_ccopy(h->N/2+1, h->fwd_bufferFD, 1, outputFD, 1);
 #elif defined(SAF_USE_INTEL_IPP)
     if(h->useIPPfft_FLAG)
@@ -722,7 +936,7 @@ void saf_rfft_backward
     
 #if defined(SAF_USE_FFTW)
     cblas_ccopy(h->N/2+1, inputFD, 1, h->bwd_bufferFD, 1);
-    fftwf_execute(h->p_bwd);
+    fftwf_execute_dft_c2r(h->p_bwd, h->bwd_bufferFD, h->bwd_bufferTD);
     cblas_scopy(h->N, h->bwd_bufferTD, 1, outputTD, 1);
     cblas_sscal(h->N, h->Scale, outputTD, 1);
 #elif defined(SAF_USE_INTEL_IPP)
@@ -753,6 +967,199 @@ void saf_rfft_backward
     }
 }
 
+void saf_rfft_prepareBatch
+(
+    void * const hFFT,
+    int strideTD,
+    int strideFD,
+    int howManyFwd,
+    int howManyBwd
+)
+{
+    saf_rfft_data *h = (saf_rfft_data*)(hFFT);
+
+    saf_assert(strideTD>=h->N && strideFD>=h->N/2+1, "Transforms must not overlap");
+    howManyFwd = SAF_MAX(howManyFwd, 0);
+    howManyBwd = SAF_MAX(howManyBwd, 0);
+#if defined(SAF_USE_FFTW)
+    unsigned int flags;
+    float* bufferTD;
+    fftwf_complex* bufferFD;
+    flags = saf_fftw_getPlannerFlags();
+    saf_spinLock_lock(&saf_fftw_plannerLock);
+    if(h->p_fwd_batch!=NULL)
+        fftwf_destroy_plan(h->p_fwd_batch);
+    if(h->p_bwd_batch!=NULL)
+        fftwf_destroy_plan(h->p_bwd_batch);
+    h->p_fwd_batch = h->p_bwd_batch = NULL;
+    if(howManyFwd>0 || howManyBwd>0){
+        /* Planned on scratch buffers, since the FFTW_MEASURE/PATIENT planners overwrite the arrays (the plans are
+         * later executed on the caller's buffers, hence FFTW_UNALIGNED) */
+        bufferTD = fftwf_malloc(SAF_MAX(howManyFwd, howManyBwd)*strideTD*sizeof(float));
+        bufferFD = fftwf_malloc(SAF_MAX(howManyFwd, howManyBwd)*strideFD*sizeof(fftwf_complex));
+        if(howManyFwd>0)
+            h->p_fwd_batch = fftwf_plan_many_dft_r2c(1, &(h->N), howManyFwd, bufferTD, NULL, 1, strideTD, bufferFD,
+                                                     NULL, 1, strideFD, flags | FFTW_UNALIGNED);
+        if(howManyBwd>0) /* (the input is preserved, as with saf_rfft_backward()) */
+            h->p_bwd_batch = fftwf_plan_many_dft_c2r(1, &(h->N), howManyBwd, bufferFD, NULL, 1, strideFD, bufferTD,
+                                                     NULL, 1, strideTD, flags | FFTW_UNALIGNED | FFTW_PRESERVE_INPUT);
+        fftwf_free(bufferTD);
+        fftwf_free(bufferFD);
+    }
+    saf_spinLock_unlock(&saf_fftw_plannerLock);
+#elif defined(SAF_USE_INTEL_MKL_LP64) || defined(SAF_USE_INTEL_MKL_ILP64)
+    if(h->MKL_FFT_Handle_fwdBatch!=0)
+        h->Status = DftiFreeDescriptor(&(h->MKL_FFT_Handle_fwdBatch));
+    if(h->MKL_FFT_Handle_bwdBatch!=0)
+        h->Status = DftiFreeDescriptor(&(h->MKL_FFT_Handle_bwdBatch));
+    h->MKL_FFT_Handle_fwdBatch = h->MKL_FFT_Handle_bwdBatch = 0;
+    if(howManyFwd>0){
+        h->Status = DftiCreateDescriptor(&(h->MKL_FFT_Handle_fwdBatch), DFTI_SINGLE, DFTI_REAL, 1, h->N);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_fwdBatch, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_fwdBatch, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_fwdBatch, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG)howManyFwd);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_fwdBatch, DFTI_INPUT_DISTANCE, (MKL_LONG)strideTD);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_fwdBatch, DFTI_OUTPUT_DISTANCE, (MKL_LONG)strideFD);
+        h->Status = DftiCommitDescriptor(h->MKL_FFT_Handle_fwdBatch);
+    }
+    if(howManyBwd>0){
+        h->Status = DftiCreateDescriptor(&(h->MKL_FFT_Handle_bwdBatch), DFTI_SINGLE, DFTI_REAL, 1, h->N);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_bwdBatch, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_bwdBatch, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_bwdBatch, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG)howManyBwd);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_bwdBatch, DFTI_INPUT_DISTANCE, (MKL_LONG)strideFD);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_bwdBatch, DFTI_OUTPUT_DISTANCE, (MKL_LONG)strideTD);
+        h->Status = DftiSetValue(h->MKL_FFT_Handle_bwdBatch, DFTI_BACKWARD_SCALE, h->Scale);
+        h->Status = DftiCommitDescriptor(h->MKL_FFT_Handle_bwdBatch);
+    }
+#endif
+#ifdef KISS_FFTR4_ENABLED
+    /* kissFFT has no batched transforms either, but it may perform four (real) transforms at once with SSE */
+    saf_rfft_releaseKiss4(h);
+    if(h->useKissFFT_FLAG && (howManyFwd>=4 || howManyBwd>=4)){
+        if(howManyFwd>=4)
+            h->kissFFT4handle_fwd = kiss_fftr4_alloc(h->N, 0);
+        if(howManyBwd>=4)
+            h->kissFFT4handle_bkw = kiss_fftr4_alloc(h->N, 1);
+        h->kiss4_bufferTD = malloc1d_aligned(4*(h->N)*sizeof(float));
+        h->kiss4_bufferFD = malloc1d_aligned(8*(h->N/2+1)*sizeof(float));
+    }
+#endif
+    h->batchLayout_fwd[0] = howManyFwd; h->batchLayout_fwd[1] = strideTD; h->batchLayout_fwd[2] = strideFD;
+    h->batchLayout_bwd[0] = howManyBwd; h->batchLayout_bwd[1] = strideFD; h->batchLayout_bwd[2] = strideTD;
+}
+
+void saf_rfft_forward_batch
+(
+    void * const hFFT,
+    float* inputTD,
+    int strideTD,
+    float_complex* outputFD,
+    int strideFD,
+    int howMany
+)
+{
+    saf_rfft_data *h = (saf_rfft_data*)(hFFT);
+    int i;
+
+    if(howMany<1)
+        return;
+    saf_assert(howMany==h->batchLayout_fwd[0] && strideTD==h->batchLayout_fwd[1] && strideFD==h->batchLayout_fwd[2],
+               "This layout was not given to saf_rfft_prepareBatch()");
+    if(howMany!=h->batchLayout_fwd[0] || strideTD!=h->batchLayout_fwd[1] || strideFD!=h->batchLayout_fwd[2]){
+        /* Not prepared for this layout (and planning here would not be real-time safe); so one after the other */
+        for(i=0; i<howMany; i++)
+            saf_rfft_forward(hFFT, &inputTD[i*strideTD], &outputFD[i*strideFD]);
+        return;
+    }
+#if defined(SAF_USE_FFTW)
+    fftwf_execute_dft_r2c(h->p_fwd_batch, inputTD, (fftwf_complex*)outputFD);
+#elif defined(SAF_USE_INTEL_MKL_LP64) || defined(SAF_USE_INTEL_MKL_ILP64)
+    h->Status = DftiComputeForward(h->MKL_FFT_Handle_fwdBatch, inputTD, outputFD);
+#else
+    i = 0;
+# ifdef KISS_FFTR4_ENABLED
+    /* Four at a time, interleaved across the SSE lanes */
+    if(h->kissFFT4handle_fwd!=NULL){
+        int j, n, k;
+        float* tdata, *fdata;
+        tdata = h->kiss4_bufferTD;
+        fdata = h->kiss4_bufferFD;
+        for(; i<=howMany-4; i+=4){
+            for(n=0; n<h->N; n++)
+                for(j=0; j<4; j++)
+                    tdata[4*n+j] = inputTD[(i+j)*strideTD+n];
+            kiss_fftr4(h->kissFFT4handle_fwd, tdata, fdata);
+            for(j=0; j<4; j++)
+                for(k=0; k<h->N/2+1; k++)
+                    outputFD[(i+j)*strideFD+k] = cmplxf(fdata[8*k+j], fdata[8*k+4+j]);
+        }
+    }
+# endif
+    /* No native batched real transforms; so (the rest) one after the other */
+    for(; i<howMany; i++)
+        saf_rfft_forward(hFFT, &inputTD[i*strideTD], &outputFD[i*strideFD]);
+#endif
+}
+
+void saf_rfft_backward_batch
+(
+    void * const hFFT,
+    float_complex* inputFD,
+    int strideFD,
+    float* outputTD,
+    int strideTD,
+    int howMany
+)
+{
+    saf_rfft_data *h = (saf_rfft_data*)(hFFT);
+    int i;
+
+    if(howMany<1)
+        return;
+    saf_assert(howMany==h->batchLayout_bwd[0] && strideFD==h->batchLayout_bwd[1] && strideTD==h->batchLayout_bwd[2],
+               "This layout was not given to saf_rfft_prepareBatch()");
+    if(howMany!=h->batchLayout_bwd[0] || strideFD!=h->batchLayout_bwd[1] || strideTD!=h->batchLayout_bwd[2]){
+        /* Not prepared for this layout (and planning here would not be real-time safe); so one after the other */
+        for(i=0; i<howMany; i++)
+            saf_rfft_backward(hFFT, &inputFD[i*strideFD], &outputTD[i*strideTD]);
+        return;
+    }
+#if defined(SAF_USE_FFTW)
+    fftwf_execute_dft_c2r(h->p_bwd_batch, (fftwf_complex*)inputFD, outputTD);
+    for(i=0; i<howMany; i++)
+        cblas_sscal(h->N, h->Scale, &outputTD[i*strideTD], 1);
+#elif defined(SAF_USE_INTEL_MKL_LP64) || defined(SAF_USE_INTEL_MKL_ILP64)
+    h->Status = DftiComputeBackward(h->MKL_FFT_Handle_bwdBatch, inputFD, outputTD);
+#else
+    i = 0;
+# ifdef KISS_FFTR4_ENABLED
+    /* Four at a time, interleaved across the SSE lanes */
+    if(h->kissFFT4handle_bkw!=NULL){
+        int j, n, k;
+        float* tdata, *fdata;
+        tdata = h->kiss4_bufferTD;
+        fdata = h->kiss4_bufferFD;
+        for(; i<=howMany-4; i+=4){
+            for(k=0; k<h->N/2+1; k++){
+                for(j=0; j<4; j++){
+                    fdata[8*k+j]   = crealf(inputFD[(i+j)*strideFD+k]);
+                    fdata[8*k+4+j] = cimagf(inputFD[(i+j)*strideFD+k]);
+                }
+            }
+            kiss_fftri4(h->kissFFT4handle_bkw, fdata, tdata);
+            for(j=0; j<4; j++)
+                for(n=0; n<h->N; n++)
+                    outputTD[(i+j)*strideTD+n] = tdata[4*n+j] * (h->Scale);
+        }
+    }
+# endif
+    /* No native batched real transforms; so (the rest) one after the other */
+    for(; i<howMany; i++)
+        saf_rfft_backward(hFFT, &inputFD[i*strideFD], &outputTD[i*strideTD]);
+#endif
+}
+
 
 /* ========================================================================== */
 /*                            Complex<->Complex FFT                           */
@@ -772,12 +1179,12 @@ void saf_fft_create
     saf_assert(N>=2, "Only even (non zero) FFT sizes are supported");
     h->useKissFFT_FLAG = 0;
 #if defined(SAF_USE_FFTW)
-    h->fwd_bufferTD = malloc1d(h->N*sizeof(fftwf_complex));
-    h->bwd_bufferTD = malloc1d(h->N*sizeof(fftwf_complex));
-    h->fwd_bufferFD = malloc1d(h->N*sizeof(fftwf_complex));
-    h->bwd_bufferFD = malloc1d(h->N*sizeof(fftwf_complex));
-    h->p_fwd = fftwf_plan_dft_1d(h->N, h->fwd_bufferTD, h->fwd_bufferFD, FFTW_FORWARD,  FFTW_ESTIMATE);
-    h->p_bwd = fftwf_plan_dft_1d(h->N, h->bwd_bufferFD, h->bwd_bufferTD, FFTW_BACKWARD, FFTW_ESTIMATE);
+    h->fwd_bufferTD = fftwf_malloc(h->N*sizeof(fftwf_complex));
+    h->bwd_bufferTD = fftwf_malloc(h->N*sizeof(fftwf_complex));
+    h->fwd_bufferFD = fftwf_malloc(h->N*sizeof(fftwf_complex));
+    h->bwd_bufferFD = fftwf_malloc(h->N*sizeof(fftwf_complex));
+    h->p_fwd = saf_fftw_acquirePlan(h->N, SAF_FFTW_PLAN_C2C_FWD);
+    h->p_bwd = saf_fftw_acquirePlan(h->N, SAF_FFTW_PLAN_C2C_BWD);
 #elif defined(SAF_USE_INTEL_IPP)
     /* Use ippsFFT if N is 2^x, otherwise, use ippsDFT */
     if((int)(log2f((float)N) + 1.0f) == (int)(log2f((float)N))){
@@ -849,12 +1256,12 @@ void saf_fft_destroy
     
     if(h!=NULL){
 #if defined(SAF_USE_FFTW)
-        free(h->fwd_bufferTD);
-        free(h->bwd_bufferTD);
-        free(h->fwd_bufferFD);
-        free(h->bwd_bufferFD);
-        fftwf_destroy_plan(h->p_bwd);
-        fftwf_destroy_plan(h->p_fwd);
+        fftwf_free(h->fwd_bufferTD);
+        fftwf_free(h->bwd_bufferTD);
+        fftwf_free(h->fwd_bufferFD);
+        fftwf_free(h->bwd_bufferFD);
+        saf_fftw_releasePlan(h->p_bwd);
+        saf_fftw_releasePlan(h->p_fwd);
 #elif defined(SAF_USE_INTEL_IPP)
         if(h->useIPPfft_FLAG){
             if(h->memSpec)
@@ -905,7 +1312,7 @@ void saf_fft_forward
     
 #if defined(SAF_USE_FFTW)
     cblas_ccopy(h->N, inputTD, 1, h->fwd_bufferTD, 1);
-    fftwf_execute(h->p_fwd);
+    fftwf_execute_dft(h->p_fwd, h->fwd_bufferTD, h->fwd_bufferFD);
     cblas_ccopy(h->N, h->fwd_bufferFD, 1, outputFD, 1);
 #elif defined(SAF_USE_INTEL_IPP)
     if(h->useIPPfft_FLAG)
@@ -942,7 +1349,7 @@ void saf_fft_backward
 
 #if defined(SAF_USE_FFTW)
     cblas_ccopy(h->N, inputFD, 1, h->bwd_bufferFD, 1);
-    fftwf_execute(h->p_bwd);
+    fftwf_execute_dft(h->p_bwd, h->bwd_bufferFD, h->bwd_bufferTD);
     cblas_ccopy(h->N, h->bwd_bufferTD, 1, outputTD, 1);
     cblas_sscal(/*re+im*/2 * h->N, h->Scale, (float*)outputTD, 1);
 #elif defined(SAF_USE_INTEL_IPP)
@@ -971,3 +1378,242 @@ void saf_fft_backward
         cblas_sscal(/*re+im*/2*(h->N), 1.0f/(float)(h->N), (float*)outputTD, 1);
     }
 }
+
+
+/* ========================================================================== */
+/*                      FFT-based Convolution (Overlap-Save)                  */
+/* ========================================================================== */
+
+/** Arguments of a saf_fftconv job; see saf_fftconv_processChannels() */
+typedef struct _saf_fftconv_jobArgs {
+    void* hFC;   /**< saf_fftconv handle */
+    int group;   /**< Index of the channel group to process */
+    float* x;    /**< Input signals (or NULL, for zeros); FLAT: nCH x strideX */
+    int strideX; /**< Distance between the input signals */
+    int x_len;   /**< Number of samples to process */
+    float* y;    /**< Output signals; FLAT: nCH x strideY */
+    int strideY; /**< Distance between the output signals */
+
+} saf_fftconv_jobArgs;
+
+/** Main structure for saf_fftconv */
+typedef struct _saf_fftconv_data {
+    int nCH;                      /**< Number of channels */
+    int h_len;                    /**< Filter length */
+    int blockSize;                /**< Number of samples processed per FFT */
+    int fftSize;                  /**< FFT size */
+    int nBins;                    /**< Number of frequency bins */
+    int fill;                     /**< Number of samples of the current block received so far */
+    float* xFrames;               /**< Previous fftSize-blockSize input samples, followed by the current block; FLAT: nCH x fftSize */
+    float* yFrames;               /**< Inverse FFT output; FLAT: nCH x fftSize */
+    float_complex* H;             /**< Filter spectra; FLAT: nCH x nBins */
+    float_complex* X;             /**< Input spectra; FLAT: nCH x nBins */
+    float_complex* Y;             /**< Output spectra; FLAT: nCH x nBins */
+    int nGroups;                  /**< Number of channel groups (processed in parallel) */
+    int* groupStart;              /**< First channel of each group; (nGroups+1) x 1 */
+    void** hFFT;                  /**< saf_rfft handle per group; nGroups x 1 */
+    void* hThreadPool;            /**< saf_threadPool handle (NULL if nGroups==1) */
+    int ownsThreadPool;           /**< 1: hThreadPool was created by saf_fftconv_create(), 0: it was given */
+    saf_threadPool_job* jobs;     /**< One job per group; nGroups x 1 */
+    saf_fftconv_jobArgs* jobArgs; /**< One set of job arguments per group; nGroups x 1 */
+
+} saf_fftconv_data;
+
+/** Filters x_len samples of the channels in a group (without updating "fill") */
+static void saf_fftconv_processChannels
+(
+    saf_fftconv_data* h,
+    int group,
+    float* x,
+    int strideX,
+    int x_len,
+    float* y,
+    int strideY
+)
+{
+    int s, n, ch, c0, nCHgroup, fill, overlap;
+    float* frame;
+
+    c0 = h->groupStart[group];
+    nCHgroup = h->groupStart[group+1] - c0;
+    overlap = h->fftSize - h->blockSize;
+    fill = h->fill;
+    for(s=0; s<x_len; s+=n){
+        /* Append (up to) the rest of the current block; any samples yet to
+         * arrive are zero, which does not affect the outputs of those that have */
+        n = SAF_MIN(x_len - s, h->blockSize - fill);
+        for(ch=c0; ch<c0+nCHgroup; ch++){
+            frame = &(h->xFrames[ch*(h->fftSize)]);
+            if(x!=NULL)
+                memcpy(&frame[overlap+fill], &x[ch*strideX+s], n*sizeof(float));
+            else
+                memset(&frame[overlap+fill], 0, n*sizeof(float));
+        }
+
+        /* Circular convolution, of which the last blockSize samples are free of aliasing */
+        saf_rfft_forward_batch(h->hFFT[group], &(h->xFrames[c0*(h->fftSize)]), h->fftSize, &(h->X[c0*(h->nBins)]), h->nBins, nCHgroup);
+        utility_cvvmul(&(h->X[c0*(h->nBins)]), &(h->H[c0*(h->nBins)]), nCHgroup*(h->nBins), &(h->Y[c0*(h->nBins)]));
+        saf_rfft_backward_batch(h->hFFT[group], &(h->Y[c0*(h->nBins)]), h->nBins, &(h->yFrames[c0*(h->fftSize)]), h->fftSize, nCHgroup);
+        for(ch=c0; ch<c0+nCHgroup; ch++)
+            memcpy(&y[ch*strideY+s], &(h->yFrames[ch*(h->fftSize)+overlap+fill]), n*sizeof(float));
+
+        /* Once the block is complete, it becomes part of the history */
+        fill += n;
+        if(fill==h->blockSize){
+            for(ch=c0; ch<c0+nCHgroup; ch++){
+                frame = &(h->xFrames[ch*(h->fftSize)]);
+                memmove(frame, &frame[h->blockSize], overlap*sizeof(float));
+                memset(&frame[overlap], 0, h->blockSize*sizeof(float));
+            }
+            fill = 0;
+        }
+    }
+}
+
+/** saf_threadPool job, which calls saf_fftconv_processChannels() */
+static void saf_fftconv_job(void* arg)
+{
+    saf_fftconv_jobArgs* a = (saf_fftconv_jobArgs*)arg;
+    saf_fftconv_processChannels((saf_fftconv_data*)a->hFC, a->group, a->x, a->strideX, a->x_len, a->y, a->strideY);
+}
+
+void saf_fftconv_create
+(
+    void ** const phFC,
+    float* h,
+    int h_len,
+    int nCH,
+    int blockSize,
+    int nThreads,
+    void* hThreadPool
+)
+{
+    saf_fftconv_data* fc = (saf_fftconv_data*)malloc1d(sizeof(saf_fftconv_data));
+    *phFC = (void*)fc;
+    int g, ch;
+    float* h0;
+
+    saf_assert(h_len>0 && nCH>0 && blockSize>0, "Invalid configuration");
+    fc->nCH = nCH;
+    fc->h_len = h_len;
+    fc->blockSize = blockSize;
+    fc->fftSize = nextpow2(blockSize+h_len-1);
+    fc->nBins = fc->fftSize/2+1;
+    fc->xFrames = calloc1d(nCH*(fc->fftSize), sizeof(float));
+    fc->yFrames = malloc1d(nCH*(fc->fftSize)*sizeof(float));
+    fc->H = malloc1d(nCH*(fc->nBins)*sizeof(float_complex));
+    fc->X = malloc1d(nCH*(fc->nBins)*sizeof(float_complex));
+    fc->Y = malloc1d(nCH*(fc->nBins)*sizeof(float_complex));
+
+    /* Channels are divided into (contiguous) groups; one per thread */
+    if(nThreads<=0)
+        nThreads = hThreadPool!=NULL ? saf_threadPool_getNumThreads(hThreadPool)+1 : saf_threadPool_getNumCPUs();
+    fc->nGroups = SAF_MAX(SAF_MIN(nThreads, nCH), 1);
+    fc->groupStart = malloc1d((fc->nGroups+1)*sizeof(int));
+    for(g=0; g<=fc->nGroups; g++)
+        fc->groupStart[g] = (g*nCH)/(fc->nGroups);
+    fc->hFFT = malloc1d(fc->nGroups*sizeof(void*));
+    for(g=0; g<fc->nGroups; g++){
+        saf_rfft_create(&(fc->hFFT[g]), fc->fftSize);
+        saf_rfft_prepareBatch(fc->hFFT[g], fc->fftSize, fc->nBins, fc->groupStart[g+1]-fc->groupStart[g], fc->groupStart[g+1]-fc->groupStart[g]);
+    }
+    fc->hThreadPool = NULL;
+    fc->ownsThreadPool = 0;
+    fc->jobs = NULL;
+    fc->jobArgs = NULL;
+    if(fc->nGroups>1){
+        /* (the calling thread processes the first group itself) */
+        if(hThreadPool!=NULL)
+            fc->hThreadPool = hThreadPool;
+        else{
+            saf_threadPool_create(&(fc->hThreadPool), fc->nGroups-1);
+            fc->ownsThreadPool = 1;
+        }
+        fc->jobs = calloc1d(fc->nGroups, sizeof(saf_threadPool_job));
+        fc->jobArgs = malloc1d(fc->nGroups*sizeof(saf_fftconv_jobArgs));
+    }
+
+    /* Filter spectra */
+    h0 = calloc1d(nCH*(fc->fftSize), sizeof(float));
+    for(ch=0; ch<nCH; ch++)
+        memcpy(&h0[ch*(fc->fftSize)], &h[ch*h_len], h_len*sizeof(float));
+    for(ch=0; ch<nCH; ch++) /* (the handles are prepared for their group sizes, rather than nCH) */
+        saf_rfft_forward(fc->hFFT[0], &h0[ch*(fc->fftSize)], &(fc->H[ch*(fc->nBins)]));
+    free(h0);
+
+    saf_fftconv_reset(*phFC);
+}
+
+void saf_fftconv_destroy
+(
+    void ** const phFC
+)
+{
+    saf_fftconv_data *fc = (saf_fftconv_data*)(*phFC);
+    int g;
+
+    if(fc!=NULL){
+        if(fc->ownsThreadPool)
+            saf_threadPool_destroy(&(fc->hThreadPool));
+        for(g=0; g<fc->nGroups; g++)
+            saf_rfft_destroy(&(fc->hFFT[g]));
+        free(fc->hFFT);
+        free(fc->groupStart);
+        free(fc->jobs);
+        free(fc->jobArgs);
+        free(fc->xFrames);
+        free(fc->yFrames);
+        free(fc->H);
+        free(fc->X);
+        free(fc->Y);
+        free(fc);
+        fc=NULL;
+        *phFC = NULL;
+    }
+}
+
+void saf_fftconv_reset
+(
+    void * const hFC
+)
+{
+    saf_fftconv_data *fc = (saf_fftconv_data*)(hFC);
+    fc->fill = 0;
+    memset(fc->xFrames, 0, fc->nCH*(fc->fftSize)*sizeof(float));
+}
+
+void saf_fftconv_apply
+(
+    void * const hFC,
+    float* x,
+    int strideX,
+    int x_len,
+    float* y,
+    int strideY
+)
+{
+    saf_fftconv_data *fc = (saf_fftconv_data*)(hFC);
+    int g;
+
+    if(x_len<=0)
+        return;
+    if(fc->nGroups==1)
+        saf_fftconv_processChannels(fc, 0, x, strideX, x_len, y, strideY);
+    else{
+        for(g=1; g<fc->nGroups; g++){
+            fc->jobArgs[g].hFC = hFC;
+            fc->jobArgs[g].group = g;
+            fc->jobArgs[g].x = x;
+            fc->jobArgs[g].strideX = strideX;
+            fc->jobArgs[g].x_len = x_len;
+            fc->jobArgs[g].y = y;
+            fc->jobArgs[g].strideY = strideY;
+            saf_threadPool_initJob(&(fc->jobs[g]), saf_fftconv_job, (void*)&(fc->jobArgs[g]));
+            saf_threadPool_submit(fc->hThreadPool, &(fc->jobs[g]));
+        }
+        saf_fftconv_processChannels(fc, 0, x, strideX, x_len, y, strideY);
+        for(g=1; g<fc->nGroups; g++)
+            saf_threadPool_wait(fc->hThreadPool, &(fc->jobs[g]));
+    }
+    fc->fill = (fc->fill + x_len) % (fc->blockSize);
+}
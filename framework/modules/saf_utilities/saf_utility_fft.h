@@ -52,6 +52,67 @@ typedef enum {
 
 }SAF_STFT_FDDATA_FORMAT;
 
+/** Options for how thoroughly FFT plans are optimised; see
+ *  saf_fft_setPlannerRigour() */
+typedef enum {
+    SAF_FFT_PLANNER_ESTIMATE, /**< Plans are chosen heuristically (default) */
+    SAF_FFT_PLANNER_MEASURE,  /**< Plans are chosen by timing several
+                               *   candidate algorithms */
+    SAF_FFT_PLANNER_PATIENT   /**< As MEASURE, but considering many more
+                               *   candidate algorithms */
+}SAF_FFT_PLANNER_RIGOUR;
+
+/* ========================================================================== */
+/*                                FFT Planning                                */
+/* ========================================================================== */
+
+/**
+ * Sets how thoroughly the FFT plans of saf_rfft and saf_fft instances, which
+ * are created from then on, are optimised
+ *
+ * This currently only has an effect when using FFTW, in which case all
+ * instances of the same transform type, size and rigour share one plan (i.e.
+ * planning only happens once per process, and is guarded such that instances
+ * may be created by different threads). Higher rigours may take a long time to
+ * plan for; this may be avoided by importing wisdom from an earlier run; see
+ * saf_fft_importWisdom().
+ *
+ * @note The batched transforms (e.g. saf_rfft_forward_batch()) are planned
+ *       with the rigour in effect when saf_rfft_prepareBatch() is called.
+ *       These plans are specific to the instance (and its strides), so they
+ *       are not shared, but they do benefit from imported wisdom.
+ *
+ * @param[in] rigour See #SAF_FFT_PLANNER_RIGOUR
+ */
+void saf_fft_setPlannerRigour(SAF_FFT_PLANNER_RIGOUR rigour);
+
+/** Returns the current planner rigour; see #SAF_FFT_PLANNER_RIGOUR */
+SAF_FFT_PLANNER_RIGOUR saf_fft_getPlannerRigour(void);
+
+/**
+ * Imports FFT planner "wisdom" from a file (previously written by
+ * saf_fft_exportWisdom() on the same machine)
+ *
+ * When using FFTW, plans covered by the wisdom are then made without any
+ * measurements. Otherwise, this function does nothing.
+ *
+ * @param[in] filename Path to the wisdom file
+ * @returns 1: if the wisdom was imported, 0: otherwise
+ */
+int saf_fft_importWisdom(const char* filename);
+
+/**
+ * Exports the FFT planner "wisdom" accumulated so far to a file
+ *
+ * When using FFTW, this includes that of all plans made with
+ * #SAF_FFT_PLANNER_MEASURE or #SAF_FFT_PLANNER_PATIENT. Otherwise, this
+ * function does nothing.
+ *
+ * @param[in] filename Path to the wisdom file
+ * @returns 1: if the wisdom was exported, 0: otherwise
+ */
+int saf_fft_exportWisdom(const char* filename);
+
 /* ========================================================================== */
 /*                               Misc. Functions                              */
 /* ========================================================================== */
@@ -71,8 +132,8 @@ void getUniformFreqVector(int fftSize,
 /**
  * FFT-based convolution of signal 'x' with filter 'h'
  *
- * Input channels and filters are zero padded to avoid circular convolution
- * artefacts.
+ * The convolution is carried out with saf_fftconv (i.e. overlap-save), with an
+ * FFT size that is bounded for long signals.
  *
  * @note The output must be of size: nCH x (x_len+h_len-1)
  *
@@ -94,8 +155,7 @@ void fftconv(float* x,
  * FFT-based convolution for FIR filters
  *
  * Similar to fftconv, other than only the first x_len samples of y are
- * returned. It has parity with the fftfilt function in Matlab, except it just
- * uses one big FFT (i.e. no overlap-add).
+ * returned. It has parity with the fftfilt function in Matlab.
  *
  * @param[in]  x     Input(s); FLAT: nCH x x_len
  * @param[in]  h     Filter(s); FLAT: nCH x h_len
@@ -137,7 +197,8 @@ void hilbert(float_complex* x,
 /**
  * Creates an instance of saf_stft
  *
- * @test  test__saf_stft_50pc_overlap(), test__saf_stft_LTI()
+ * @test  test__saf_stft_50pc_overlap(), test__saf_stft_high_overlap(),
+ *        test__saf_stft_LTI()
  *
  * @param[in] phSTFT   (&) address of saf_stft handle
  * @param[in] winsize  Window size
@@ -177,6 +238,10 @@ void saf_stft_forward(void * const hSTFT,
 /**
  * Performs the backward-STFT operation for the current frame
  *
+ * @note The overlapping Hann windows sum to (winsize/hopsize)/2, so the output
+ *       is only unity gain for winsize==hopsize or 50% overlap, unless
+ *       saf_stft_setOverlapAddNormalisation() is enabled.
+ *
  * @param[in]  hSTFT     saf_stft handle
  * @param[in]  dataFD    Frequency-domain output; see #SAF_STFT_FDDATA_FORMAT
  * @param[in]  framesize Frame size of time-domain data
@@ -194,6 +259,19 @@ void saf_stft_backward(void * const hSTFT,
  */
 void saf_stft_flushBuffers(void * const hSTFT);
 
+/**
+ * Enables/disables the normalisation of the overlap-add, such that the
+ * backward-STFT is unity gain for any winsize/hopsize ratio (disabled by
+ * default)
+ *
+ * @test  test__saf_stft_high_overlap()
+ *
+ * @param[in] hSTFT         saf_stft handle
+ * @param[in] normaliseFLAG 1: scale by 2/(winsize/hopsize), 0: no scaling
+ */
+void saf_stft_setOverlapAddNormalisation(void * const hSTFT,
+                                         int normaliseFLAG);
+
 /**
  * Changes the number of input/output channels
  *
@@ -275,6 +353,85 @@ void saf_rfft_backward(void * const hFFT,
                        float_complex* inputFD,
                        float* outputTD);
 
+/**
+ * Plans the batched transforms (saf_rfft_forward_batch() and
+ * saf_rfft_backward_batch()) for a given layout
+ *
+ * Planning is not real-time safe, so this should be called when creating or
+ * reconfiguring the owner of the handle, rather than in the processing loop.
+ * It may be called again to re-plan for a different layout. The plans are made
+ * with the current planner rigour (see saf_fft_setPlannerRigour()).
+ *
+ * @test test__saf_rfft_batch()
+ *
+ * @param[in] hFFT       saf_rfft handle
+ * @param[in] strideTD   Distance between the time-domain signals (at least N)
+ * @param[in] strideFD   Distance between the frequency-domain signals (at
+ *                       least N/2+1)
+ * @param[in] howManyFwd Number of forward transforms per call (0: unused)
+ * @param[in] howManyBwd Number of backward transforms per call (0: unused)
+ */
+void saf_rfft_prepareBatch(void * const hFFT,
+                           int strideTD,
+                           int strideFD,
+                           int howManyFwd,
+                           int howManyBwd);
+
+/**
+ * Performs the forward-FFT operation for multiple signals at once
+ *
+ * Transform i takes inputTD[i*strideTD] ... inputTD[i*strideTD+N-1], and writes
+ * outputFD[i*strideFD] ... outputFD[i*strideFD+N/2]. This is mapped onto the
+ * native batched transforms of FFTW and Intel MKL. The default (kissFFT)
+ * implementation performs four transforms at once with SSE, if SAF_ENABLE_SIMD
+ * is defined (GCC/Clang only). Otherwise, the transforms are performed one
+ * after the other.
+ *
+ * @warning The layout (howMany and the strides) must be the one given to
+ *          saf_rfft_prepareBatch(). Otherwise, debug builds will assert, and
+ *          release builds perform the transforms one after the other (i.e.
+ *          without planning anything).
+ *
+ * @test test__saf_rfft_batch()
+ *
+ * @param[in]  hFFT     saf_rfft handle
+ * @param[in]  inputTD  Time-domain inputs; FLAT: howMany x strideTD
+ * @param[in]  strideTD Distance between the inputs (at least N)
+ * @param[out] outputFD Frequency-domain outputs; FLAT: howMany x strideFD
+ * @param[in]  strideFD Distance between the outputs (at least N/2+1)
+ * @param[in]  howMany  Number of transforms
+ */
+void saf_rfft_forward_batch(void * const hFFT,
+                            float* inputTD,
+                            int strideTD,
+                            float_complex* outputFD,
+                            int strideFD,
+                            int howMany);
+
+/**
+ * Performs the backward-FFT operation for multiple signals at once
+ *
+ * Transform i takes inputFD[i*strideFD] ... inputFD[i*strideFD+N/2], and
+ * writes outputTD[i*strideTD] ... outputTD[i*strideTD+N-1].
+ *
+ * @note See saf_rfft_forward_batch() for more details.
+ *
+ * @test test__saf_rfft_batch()
+ *
+ * @param[in]  hFFT     saf_rfft handle
+ * @param[in]  inputFD  Frequency-domain inputs; FLAT: howMany x strideFD
+ * @param[in]  strideFD Distance between the inputs (at least N/2+1)
+ * @param[out] outputTD Time-domain outputs; FLAT: howMany x strideTD
+ * @param[in]  strideTD Distance between the outputs (at least N)
+ * @param[in]  howMany  Number of transforms
+ */
+void saf_rfft_backward_batch(void * const hFFT,
+                             float_complex* inputFD,
+                             int strideFD,
+                             float* outputTD,
+                             int strideTD,
+                             int howMany);
+
 
 /* ========================================================================== */
 /*                            Complex<->Complex FFT                           */
@@ -323,6 +480,88 @@ void saf_fft_backward(void * const hFFT,
                       float_complex* outputTD);
 
 
+/* ========================================================================== */
+/*                      FFT-based Convolution (Overlap-Save)                  */
+/* ========================================================================== */
+
+/**
+ * Creates an instance of saf_fftconv; a streaming multi-channel FIR filter
+ * based on the overlap-save method
+ *
+ * The FFT size is nextpow2(blockSize+h_len-1), and the FFTs and filter spectra
+ * are computed once upon creation; therefore, signals of any length may be
+ * passed through the filters (over any number of calls to saf_fftconv_apply())
+ * using a fixed amount of memory. Larger block sizes require fewer FFTs per
+ * sample, but more memory.
+ *
+ * @test test__saf_fftconv()
+ *
+ * @note If a thread pool is given, then it is not owned by saf_fftconv, and it
+ *       must outlive it. It may be shared with other objects (e.g. several
+ *       saf_fftconv instances, or matrixConv; see
+ *       saf_matrixConv_setThreadPool()). Otherwise, a private thread pool is
+ *       created if more than one thread is requested.
+ *
+ * @param[in] phFC        (&) address of saf_fftconv handle
+ * @param[in] h           Filter(s); FLAT: nCH x h_len
+ * @param[in] h_len       Length of filters, in samples
+ * @param[in] nCH         Number of channels
+ * @param[in] blockSize   Number of samples processed per FFT
+ * @param[in] nThreads    Number of threads to process the channels with (1:
+ *                        only the calling thread; 0 or less: one per CPU core,
+ *                        or one per worker thread of hThreadPool, plus the
+ *                        calling thread)
+ * @param[in] hThreadPool saf_threadPool handle to use (see
+ *                        saf_threadPool_create()), or NULL
+ */
+void saf_fftconv_create(void ** const phFC,
+                        float* h,
+                        int h_len,
+                        int nCH,
+                        int blockSize,
+                        int nThreads,
+                        void* hThreadPool);
+
+/**
+ * Destroys an instance of saf_fftconv
+ *
+ * @param[in] phFC (&) address of saf_fftconv handle
+ */
+void saf_fftconv_destroy(void ** const phFC);
+
+/**
+ * Flushes the internal buffers (i.e. the next call to saf_fftconv_apply() is
+ * treated as the start of a new signal)
+ *
+ * @param[in] hFC saf_fftconv handle
+ */
+void saf_fftconv_reset(void * const hFC);
+
+/**
+ * Filters the next x_len samples of each channel
+ *
+ * The output is the continuation of the convolution from the previous call,
+ * without any latency; i.e. the first x_len samples of fftconv() are obtained
+ * after a reset, and the remaining h_len-1 samples are obtained by then
+ * passing "x" as NULL.
+ *
+ * @note "x" and "y" may be the same buffer (with the same stride).
+ *
+ * @param[in]  hFC     saf_fftconv handle
+ * @param[in]  x       Input signals (or NULL, for zeros); FLAT: nCH x strideX
+ * @param[in]  strideX Distance between the input signals (at least x_len)
+ * @param[in]  x_len   Number of samples to process (any)
+ * @param[out] y       Output signals; FLAT: nCH x strideY
+ * @param[in]  strideY Distance between the output signals (at least x_len)
+ */
+void saf_fftconv_apply(void * const hFC,
+                       float* x,
+                       int strideX,
+                       int x_len,
+                       float* y,
+                       int strideY);
+
+
 #ifdef __cplusplus
 }/* extern "C" */
 #endif /* __cplusplus */
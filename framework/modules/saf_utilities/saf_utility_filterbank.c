@@ -0,0 +1,276 @@
+/*
+ * Copyright 2026 Spatial_Audio_Framework contributors
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * @file saf_utility_filterbank.c
+ * @ingroup Utilities
+ * @brief A common interface to the filterbanks included in SAF
+ *
+ * @author Spatial_Audio_Framework contributors
+ * @date 16.10.2026
+ * @license ISC
+ */
+
+#include "saf_utilities.h"
+#include "saf_utility_filterbank.h"
+
+/** Main structure for saf_filterbank */
+typedef struct _saf_filterbank_data {
+    SAF_FILTERBANK_TYPES type; /**< see #SAF_FILTERBANK_TYPES */
+    int hopsize;               /**< Hop size, in samples */
+    int hybridmode;            /**< 1: hybrid-filtering enabled; 0: disabled */
+    int nBands;                /**< Number of frequency bands */
+    void* hFB;                 /**< afSTFT, qmf, or saf_stft handle */
+
+} saf_filterbank_data;
+
+
+/* ========================================================================== */
+/*                                 Filterbank                                 */
+/* ========================================================================== */
+
+void saf_filterbank_create
+(
+    void ** const phFB,
+    SAF_FILTERBANK_TYPES type,
+    int nCHin,
+    int nCHout,
+    int hopsize,
+    int hybridmode
+)
+{
+    saf_filterbank_data* h = (saf_filterbank_data*)malloc1d(sizeof(saf_filterbank_data));
+    *phFB = (void*)h;
+    h->type = type;
+    h->hopsize = hopsize;
+    h->hybridmode = hybridmode;
+
+    switch(type){
+        case SAF_FILTERBANK_AFSTFT_LD: /* fall through */
+        case SAF_FILTERBANK_AFSTFT:
+            afSTFT_create(&(h->hFB), nCHin, nCHout, hopsize, type==SAF_FILTERBANK_AFSTFT_LD ? 1 : 0, hybridmode, AFSTFT_BANDS_CH_TIME);
+            h->nBands = afSTFT_getNBands(h->hFB);
+            break;
+        case SAF_FILTERBANK_QMF:
+            qmf_create(&(h->hFB), nCHin, nCHout, hopsize, hybridmode, QMF_BANDS_CH_TIME);
+            h->nBands = qmf_getNBands(h->hFB);
+            break;
+        case SAF_FILTERBANK_STFT:
+            saf_stft_create(&(h->hFB), 2*hopsize, hopsize, nCHin, nCHout, SAF_STFT_BANDS_CH_TIME);
+            h->nBands = 2*hopsize+1;
+            break;
+    }
+}
+
+void saf_filterbank_destroy
+(
+    void ** const phFB
+)
+{
+    saf_filterbank_data *h = (saf_filterbank_data*)(*phFB);
+
+    if(h!=NULL){
+        switch(h->type){
+            case SAF_FILTERBANK_AFSTFT_LD: /* fall through */
+            case SAF_FILTERBANK_AFSTFT: afSTFT_destroy(&(h->hFB)); break;
+            case SAF_FILTERBANK_QMF:    qmf_destroy(&(h->hFB)); break;
+            case SAF_FILTERBANK_STFT:   saf_stft_destroy(&(h->hFB)); break;
+        }
+        free(h);
+        h=NULL;
+        *phFB = NULL;
+    }
+}
+
+void saf_filterbank_forward
+(
+    void * const hFB,
+    float** dataTD,
+    int framesize,
+    int dataFD_nCH,
+    int dataFD_nHops,
+    float_complex*** dataFD
+)
+{
+    saf_filterbank_data *h = (saf_filterbank_data*)(hFB);
+
+    /* (qmf and saf_stft index dataFD via its pointers, so they do not need the dimensions) */
+    switch(h->type){
+        case SAF_FILTERBANK_AFSTFT_LD: /* fall through */
+        case SAF_FILTERBANK_AFSTFT: afSTFT_forward_knownDimensions(h->hFB, dataTD, framesize, dataFD_nCH, dataFD_nHops, dataFD); break;
+        case SAF_FILTERBANK_QMF:    qmf_analysis(h->hFB, dataTD, framesize, dataFD); break;
+        case SAF_FILTERBANK_STFT:   saf_stft_forward(h->hFB, dataTD, framesize, dataFD); break;
+    }
+}
+
+void saf_filterbank_backward
+(
+    void * const hFB,
+    float_complex*** dataFD,
+    int framesize,
+    int dataFD_nCH,
+    int dataFD_nHops,
+    float** dataTD
+)
+{
+    saf_filterbank_data *h = (saf_filterbank_data*)(hFB);
+
+    switch(h->type){
+        case SAF_FILTERBANK_AFSTFT_LD: /* fall through */
+        case SAF_FILTERBANK_AFSTFT: afSTFT_backward_knownDimensions(h->hFB, dataFD, framesize, dataFD_nCH, dataFD_nHops, dataTD); break;
+        case SAF_FILTERBANK_QMF:    qmf_synthesis(h->hFB, dataFD, framesize, dataTD); break;
+        case SAF_FILTERBANK_STFT:   saf_stft_backward(h->hFB, dataFD, framesize, dataTD); break;
+    }
+}
+
+void saf_filterbank_channelChange
+(
+    void * const hFB,
+    int new_nCHin,
+    int new_nCHout
+)
+{
+    saf_filterbank_data *h = (saf_filterbank_data*)(hFB);
+
+    switch(h->type){
+        case SAF_FILTERBANK_AFSTFT_LD: /* fall through */
+        case SAF_FILTERBANK_AFSTFT: afSTFT_channelChange(h->hFB, new_nCHin, new_nCHout); break;
+        case SAF_FILTERBANK_QMF:    qmf_channelChange(h->hFB, new_nCHin, new_nCHout); break;
+        case SAF_FILTERBANK_STFT:   saf_stft_channelChange(h->hFB, new_nCHin, new_nCHout); break;
+    }
+}
+
+void saf_filterbank_clearBuffers
+(
+    void * const hFB
+)
+{
+    saf_filterbank_data *h = (saf_filterbank_data*)(hFB);
+
+    switch(h->type){
+        case SAF_FILTERBANK_AFSTFT_LD: /* fall through */
+        case SAF_FILTERBANK_AFSTFT: afSTFT_clearBuffers(h->hFB); break;
+        case SAF_FILTERBANK_QMF:    qmf_clearBuffers(h->hFB); break;
+        case SAF_FILTERBANK_STFT:   saf_stft_flushBuffers(h->hFB); break;
+    }
+}
+
+SAF_FILTERBANK_TYPES saf_filterbank_getType
+(
+    void * const hFB
+)
+{
+    saf_filterbank_data *h = (saf_filterbank_data*)(hFB);
+    return h->type;
+}
+
+int saf_filterbank_getNBands
+(
+    void * const hFB
+)
+{
+    saf_filterbank_data *h = (saf_filterbank_data*)(hFB);
+    return h->nBands;
+}
+
+int saf_filterbank_getProcDelay
+(
+    void * const hFB
+)
+{
+    saf_filterbank_data *h = (saf_filterbank_data*)(hFB);
+
+    switch(h->type){
+        case SAF_FILTERBANK_AFSTFT_LD: /* fall through */
+        case SAF_FILTERBANK_AFSTFT: return afSTFT_getProcDelay(h->hFB);
+        case SAF_FILTERBANK_QMF:    return qmf_getProcDelay(h->hFB);
+        case SAF_FILTERBANK_STFT:   return h->hopsize; /* (window size minus hop size) */
+    }
+    return 0;
+}
+
+void saf_filterbank_getCentreFreqs
+(
+    void * const hFB,
+    float fs,
+    int nBands,
+    float* freqVector
+)
+{
+    saf_filterbank_data *h = (saf_filterbank_data*)(hFB);
+    int band;
+
+    switch(h->type){
+        case SAF_FILTERBANK_AFSTFT_LD: /* fall through */
+        case SAF_FILTERBANK_AFSTFT: afSTFT_getCentreFreqs(h->hFB, fs, nBands, freqVector); break;
+        case SAF_FILTERBANK_QMF:    qmf_getCentreFreqs(h->hFB, fs, nBands, freqVector); break;
+        case SAF_FILTERBANK_STFT:
+            /* Bin frequencies of the FFT (of size 2*window size) */
+            for(band=0; band<SAF_MIN(nBands, h->nBands); band++)
+                freqVector[band] = (float)band * fs/(float)(4*(h->hopsize));
+            break;
+    }
+}
+
+void saf_filterbank_FIRtoFilterbankCoeffs
+(
+    SAF_FILTERBANK_TYPES type,
+    float* hIR,
+    int N_dirs,
+    int nCH,
+    int ir_len,
+    int hopsize,
+    int hybridmode,
+    float_complex* hFB
+)
+{
+    int i, j, n, band, fftSize, nBands;
+    float* ir_fold;
+    float_complex* H;
+    void* hFFT;
+
+    switch(type){
+        case SAF_FILTERBANK_AFSTFT_LD: /* fall through */
+        case SAF_FILTERBANK_AFSTFT:
+            afSTFT_FIRtoFilterbankCoeffs(hIR, N_dirs, nCH, ir_len, hopsize, type==SAF_FILTERBANK_AFSTFT_LD ? 1 : 0, hybridmode, hFB);
+            break;
+        case SAF_FILTERBANK_QMF:
+            qmf_FIRtoFilterbankCoeffs(hIR, N_dirs, nCH, ir_len, hopsize, hybridmode, hFB);
+            break;
+        case SAF_FILTERBANK_STFT:
+            /* The frequency responses, sampled at the bin frequencies (i.e.
+             * the FFT of the FIRs, time-aliased to the FFT size) */
+            fftSize = 4*hopsize;
+            nBands = fftSize/2+1;
+            ir_fold = malloc1d(fftSize*sizeof(float));
+            H = malloc1d(nBands*sizeof(float_complex));
+            saf_rfft_create(&hFFT, fftSize);
+            for(i=0; i<N_dirs; i++){
+                for(j=0; j<nCH; j++){
+                    memset(ir_fold, 0, fftSize*sizeof(float));
+                    for(n=0; n<ir_len; n++)
+                        ir_fold[n % fftSize] += hIR[i*nCH*ir_len + j*ir_len + n];
+                    saf_rfft_forward(hFFT, ir_fold, H);
+                    for(band=0; band<nBands; band++)
+                        hFB[band*nCH*N_dirs + j*N_dirs + i] = H[band];
+                }
+            }
+            saf_rfft_destroy(&hFFT);
+            free(ir_fold);
+            free(H);
+            break;
+    }
+}
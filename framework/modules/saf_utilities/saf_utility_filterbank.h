@@ -0,0 +1,193 @@
+/*
+ * Copyright 2026 Spatial_Audio_Framework contributors
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ *@addtogroup Utilities
+ *@{
+ * @file saf_utility_filterbank.h
+ * @brief A common interface to the filterbanks included in SAF
+ *
+ * The alias-free STFT (afSTFTlib.h), the complex QMF (saf_utility_qmf.h), and
+ * the STFT (saf_stft) each have their own create/forward/backward functions.
+ * This interface wraps them, such that the filterbank may be selected at
+ * run-time; e.g. a cheaper filterbank for CPU-bound applications, or one with
+ * a smaller hop size for latency-bound applications.
+ *
+ * The frequency-domain data is always in the "bands x channels x time-slots"
+ * format.
+ *
+ * @author Spatial_Audio_Framework contributors
+ * @date 16.10.2026
+ * @license ISC
+ */
+
+#ifndef SAF_FILTERBANK_H_INCLUDED
+#define SAF_FILTERBANK_H_INCLUDED
+
+#include "saf_utility_complex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** Available filterbanks */
+typedef enum {
+    SAF_FILTERBANK_AFSTFT,    /**< Alias-free STFT filterbank */
+    SAF_FILTERBANK_AFSTFT_LD, /**< Alias-free STFT filterbank (low-delay mode) */
+    SAF_FILTERBANK_QMF,       /**< Complex quadrature mirror filterbank */
+    SAF_FILTERBANK_STFT       /**< STFT with 50% overlapping Hann windows of
+                               *   2*hopsize (hybrid-filtering is not
+                               *   supported) */
+}SAF_FILTERBANK_TYPES;
+
+
+/* ========================================================================== */
+/*                                 Filterbank                                 */
+/* ========================================================================== */
+
+/**
+ * Creates an instance of saf_filterbank
+ *
+ * @test test__saf_filterbank()
+ *
+ * @param[in] phFB       (&) address of saf_filterbank handle
+ * @param[in] type       Filterbank to use (see #SAF_FILTERBANK_TYPES)
+ * @param[in] nCHin      Number of input channels
+ * @param[in] nCHout     Number of output channels
+ * @param[in] hopsize    Hop size, in samples
+ * @param[in] hybridmode 0: disabled, 1: hybrid-filtering enabled
+ */
+void saf_filterbank_create(void ** const phFB,
+                           SAF_FILTERBANK_TYPES type,
+                           int nCHin,
+                           int nCHout,
+                           int hopsize,
+                           int hybridmode);
+
+/**
+ * Destroys an instance of saf_filterbank
+ *
+ * @param[in] phFB (&) address of saf_filterbank handle
+ */
+void saf_filterbank_destroy(void ** const phFB);
+
+/**
+ * Performs the forward transform (analysis)
+ *
+ * @param[in]  hFB          saf_filterbank handle
+ * @param[in]  dataTD       Time-domain input; nCHin x framesize
+ * @param[in]  framesize    Frame size of time-domain data (a multiple of the
+ *                          hop size)
+ * @param[in]  dataFD_nCH   Number of channels dataFD is allocated (the max)
+ * @param[in]  dataFD_nHops Number of time-slots dataFD is allocated (the max)
+ * @param[out] dataFD       Frequency-domain output;
+ *                          nBands x dataFD_nCH x dataFD_nHops
+ */
+void saf_filterbank_forward(void * const hFB,
+                            float** dataTD,
+                            int framesize,
+                            int dataFD_nCH,
+                            int dataFD_nHops,
+                            float_complex*** dataFD);
+
+/**
+ * Performs the backward transform (synthesis)
+ *
+ * @param[in]  hFB          saf_filterbank handle
+ * @param[in]  dataFD       Frequency-domain input;
+ *                          nBands x dataFD_nCH x dataFD_nHops
+ * @param[in]  framesize    Frame size of time-domain data (a multiple of the
+ *                          hop size)
+ * @param[in]  dataFD_nCH   Number of channels dataFD is allocated (the max)
+ * @param[in]  dataFD_nHops Number of time-slots dataFD is allocated (the max)
+ * @param[out] dataTD       Time-domain output; nCHout x framesize
+ */
+void saf_filterbank_backward(void * const hFB,
+                             float_complex*** dataFD,
+                             int framesize,
+                             int dataFD_nCH,
+                             int dataFD_nHops,
+                             float** dataTD);
+
+/**
+ * Changes the number of input and/or output channels
+ *
+ * @param[in] hFB        saf_filterbank handle
+ * @param[in] new_nCHin  New number of input channels
+ * @param[in] new_nCHout New number of output channels
+ */
+void saf_filterbank_channelChange(void * const hFB,
+                                  int new_nCHin,
+                                  int new_nCHout);
+
+/** Flushes the internal buffers with zeros */
+void saf_filterbank_clearBuffers(void * const hFB);
+
+/** Returns the filterbank type (see #SAF_FILTERBANK_TYPES) */
+SAF_FILTERBANK_TYPES saf_filterbank_getType(void * const hFB);
+
+/** Returns the number of frequency bands */
+int saf_filterbank_getNBands(void * const hFB);
+
+/** Returns the processing delay (analysis + synthesis), in samples */
+int saf_filterbank_getProcDelay(void * const hFB);
+
+/**
+ * Computes the centre frequencies of the bands
+ *
+ * @param[in]  hFB        saf_filterbank handle
+ * @param[in]  fs         Sampling rate in Hz
+ * @param[in]  nBands     Length of 'freqVector' (see saf_filterbank_getNBands())
+ * @param[out] freqVector The frequency vector; nBands x 1
+ */
+void saf_filterbank_getCentreFreqs(void * const hFB,
+                                   float fs,
+                                   int nBands,
+                                   float* freqVector);
+
+/**
+ * Converts FIR filters into filterbank coefficients for a given filterbank
+ * configuration (as in afSTFT_FIRtoFilterbankCoeffs())
+ *
+ * @param[in]  type       Filterbank (see #SAF_FILTERBANK_TYPES)
+ * @param[in]  hIR        Time-domain FIR; FLAT: N_dirs x nCH x ir_len
+ * @param[in]  N_dirs     Number of FIR sets
+ * @param[in]  nCH        Number of channels per FIR set
+ * @param[in]  ir_len     Length of the FIR
+ * @param[in]  hopsize    Hop size
+ * @param[in]  hybridmode 0: disabled, 1: enabled
+ * @param[out] hFB        The FIRs as filterbank coefficients;
+ *                        FLAT: nBands x nCH x N_dirs
+ */
+void saf_filterbank_FIRtoFilterbankCoeffs(/* Input Arguments */
+                                          SAF_FILTERBANK_TYPES type,
+                                          float* hIR,
+                                          int N_dirs,
+                                          int nCH,
+                                          int ir_len,
+                                          int hopsize,
+                                          int hybridmode,
+                                          /* Output Arguments */
+                                          float_complex* hFB);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* SAF_FILTERBANK_H_INCLUDED */
+
+/**@} */ /* doxygen addtogroup Utilities */
@@ -27,10 +27,1159 @@
 #include "saf_utilities.h"
 #include "saf_externals.h"
 
+/* ========================================================================== */
+/*                     Background Tail Processing (internal)                  */
+/* ========================================================================== */
+
+/**
+ * A job, which computes the contribution of the filter tails (i.e. all but the
+ * first partition) for a range of output channels, one hop in advance of when
+ * it is needed
+ */
+typedef struct _safConvTailJob {
+    saf_threadPool_job job; /**< Thread pool job */
+    void* hConv;            /**< Parent convolver handle */
+    int start, end;         /**< Range of output channels: start...end-1 */
+
+}safConvTailJob;
+
+/**
+ * Creates one tail job per worker thread (or per output channel, whichever is
+ * fewer), which divide the output channels between them
+ */
+static void saf_convTail_createJobs
+(
+    safConvTailJob** pJobs,
+    int* nJobs,
+    void* hThreadPool,
+    void* hConv,
+    saf_threadPool_jobFunc func,
+    int nCHout
+)
+{
+    safConvTailJob* jobs;
+    int j;
+
+    (*nJobs) = SAF_MIN(saf_threadPool_getNumThreads(hThreadPool), nCHout);
+    jobs = (*pJobs) = malloc1d((*nJobs)*sizeof(safConvTailJob));
+    for(j=0; j<(*nJobs); j++){
+        saf_threadPool_initJob(&(jobs[j].job), func, (void*)&(jobs[j]));
+        jobs[j].hConv = hConv;
+        jobs[j].start = (j*nCHout)/(*nJobs);
+        jobs[j].end = ((j+1)*nCHout)/(*nJobs);
+    }
+}
+
+/** Waits for the tail jobs to complete, and then destroys them */
+static void saf_convTail_destroyJobs
+(
+    safConvTailJob** pJobs,
+    int nJobs,
+    void* hThreadPool
+)
+{
+    int j;
+
+    if(*pJobs!=NULL){
+        for(j=0; j<nJobs; j++)
+            saf_threadPool_wait(hThreadPool, &((*pJobs)[j].job));
+        free(*pJobs);
+        *pJobs = NULL;
+    }
+}
+
+/** Submits the tail jobs to the thread pool */
+static void saf_convTail_submit
+(
+    safConvTailJob* jobs,
+    int nJobs,
+    void* hThreadPool
+)
+{
+    int j;
+    for(j=0; j<nJobs; j++)
+        saf_threadPool_submit(hThreadPool, &(jobs[j].job));
+}
+
+/** Waits for the tail jobs to complete */
+static void saf_convTail_wait
+(
+    safConvTailJob* jobs,
+    int nJobs,
+    void* hThreadPool
+)
+{
+    int j;
+    for(j=0; j<nJobs; j++) /* (first taking on any which have not been started yet) */
+        saf_threadPool_tryRun(hThreadPool, &(jobs[j].job));
+    for(j=0; j<nJobs; j++)
+        saf_threadPool_wait(hThreadPool, &(jobs[j].job));
+}
+
+/** Runs the tail jobs on the calling thread */
+static void saf_convTail_run
+(
+    safConvTailJob* jobs,
+    int nJobs
+)
+{
+    int j;
+    for(j=0; j<nJobs; j++)
+        jobs[j].job.func(jobs[j].job.arg);
+}
+
+
+/* ========================================================================== */
+/*                            Filter Sets (internal)                          */
+/* ========================================================================== */
+
+/**
+ * A set of partitioned filter spectra, along with the lists of the active
+ * (i.e. not skipped) filter partitions
+ *
+ * Sub-filters (and partitions thereof) with a peak absolute value at or below a
+ * threshold (relative to the peak of all filters) are skipped. Filter sets are
+ * always prepared off the audio thread, and then swapped in. The spectra may
+ * also be borrowed from the filter set of a saf_convSpectra object (which are
+ * then never modified), in which case only the active lists are owned.
+ */
+typedef struct _safMatConvFilters {
+    int nFilt;            /**< Number of filters (i.e. outputs; or 1 for diagonal) */
+    int nParts;           /**< Number of partitions */
+    int nCHin;            /**< Number of inputs */
+    int nBins;            /**< Number of frequency bins per partition */
+    float_complex** H_f;  /**< Filter spectra; nFilt x FLAT(nParts x nCHin x nBins) */
+    float maxPeak;        /**< Peak absolute value over all filters */
+    float* blockPeak;     /**< Peak of each filter partition; FLAT: nFilt x nParts x nCHin */
+    int* nActive;         /**< Number of active filter partitions per filter; nFilt x 1 */
+    int* nActiveHead;     /**< Number of those in the first partition; nFilt x 1 */
+    int** activeIdx;      /**< Offsets of the active filter partitions in the FDL/spectra, ordered by partition then input; nFilt x (nParts*nCHin) */
+    int borrowedFLAG;     /**< 1: H_f and blockPeak are borrowed from another filter set, 0: they are owned */
+
+}safMatConvFilters;
+
+/** Returns the peak absolute value of a signal */
+static float saf_matrixConv_peak
+(
+    float* x,
+    int len
+)
+{
+    int ind;
+
+    utility_simaxv(x, len, &ind);
+    return fabsf(x[ind]);
+}
+
+/** Creates an (empty) filter set */
+static void saf_matConvFilters_create
+(
+    safMatConvFilters** pF,
+    int nFilt,
+    int nParts,
+    int nCHin,
+    int nBins
+)
+{
+    safMatConvFilters* F = (*pF) = malloc1d(sizeof(safMatConvFilters));
+
+    F->nFilt = nFilt;
+    F->nParts = nParts;
+    F->nCHin = nCHin;
+    F->nBins = nBins;
+    F->H_f = (float_complex**)malloc2d_aligned(nFilt, nParts*nCHin*nBins, sizeof(float_complex));
+    F->maxPeak = 0.0f;
+    F->blockPeak = calloc1d(nFilt*nParts*nCHin, sizeof(float));
+    F->nActive = calloc1d(nFilt, sizeof(int));
+    F->nActiveHead = calloc1d(nFilt, sizeof(int));
+    F->activeIdx = (int**)malloc2d(nFilt, nParts*nCHin, sizeof(int));
+    F->borrowedFLAG = 0;
+}
+
+/** Creates a filter set, which borrows the spectra of filter set "S" (which must outlive it) */
+static void saf_matConvFilters_borrow
+(
+    safMatConvFilters** pF,
+    safMatConvFilters* S
+)
+{
+    safMatConvFilters* F = (*pF) = malloc1d(sizeof(safMatConvFilters));
+
+    F->nFilt = S->nFilt;
+    F->nParts = S->nParts;
+    F->nCHin = S->nCHin;
+    F->nBins = S->nBins;
+    F->H_f = S->H_f;
+    F->maxPeak = S->maxPeak;
+    F->blockPeak = S->blockPeak;
+    F->nActive = calloc1d(F->nFilt, sizeof(int));
+    F->nActiveHead = calloc1d(F->nFilt, sizeof(int));
+    F->activeIdx = (int**)malloc2d(F->nFilt, (F->nParts)*(F->nCHin), sizeof(int));
+    F->borrowedFLAG = 1;
+}
+
+/** Destroys a filter set */
+static void saf_matConvFilters_destroy
+(
+    safMatConvFilters** pF
+)
+{
+    safMatConvFilters* F = *pF;
+
+    if(F!=NULL){
+        if(!F->borrowedFLAG){
+            free2d_aligned((void**)F->H_f);
+            free(F->blockPeak);
+        }
+        free(F->nActive);
+        free(F->nActiveHead);
+        free(F->activeIdx);
+        free(F);
+        *pF = NULL;
+    }
+}
+
+/**
+ * Ensures that "*pF" is a filter set which owns its spectra (i.e. one which new
+ * filters may be transformed into), creating it if necessary
+ */
+static void saf_matConvFilters_prepare
+(
+    safMatConvFilters** pF,
+    int nFilt,
+    int nParts,
+    int nCHin,
+    int nBins
+)
+{
+    if((*pF)!=NULL && (*pF)->borrowedFLAG)
+        saf_matConvFilters_destroy(pF);
+    if((*pF)==NULL)
+        saf_matConvFilters_create(pF, nFilt, nParts, nCHin, nBins);
+}
+
+/**
+ * Rebuilds the lists of active filter partitions; i.e. those with a peak
+ * absolute value above "threshold" (relative to the peak of all filters)
+ */
+static void saf_matConvFilters_findActive
+(
+    safMatConvFilters* F,
+    float threshold
+)
+{
+    int no, nb, ni;
+
+    threshold *= F->maxPeak;
+    for(no=0; no<F->nFilt; no++){
+        F->nActive[no] = 0;
+        for(nb=0; nb<F->nParts; nb++){
+            for(ni=0; ni<F->nCHin; ni++)
+                if(F->blockPeak[(no*(F->nParts)+nb)*(F->nCHin)+ni] > threshold)
+                    F->activeIdx[no][F->nActive[no]++] = nb*(F->nCHin)*(F->nBins) + ni*(F->nBins);
+            if(nb==0)
+                F->nActiveHead[no] = F->nActive[no];
+        }
+    }
+}
+
+/**
+ * Transforms time-domain filters into a filter set, and finds the active
+ * partitions
+ *
+ * @param[in] F         Filter set
+ * @param[in] hFFT      saf_rfft handle (fftSize)
+ * @param[in] fftSize   FFT size
+ * @param[in] H         Time-domain filters; FLAT: nFilt x nCHin x length_h
+ * @param[in] length_h  Length of the filters
+ * @param[in] offset    Filter offset (in samples) of the first partition
+ * @param[in] blockSize Partition size; partition nb comprises taps
+ *                      offset+nb*blockSize...offset+(nb+1)*blockSize-1 (which
+ *                      are zero-padded to fftSize)
+ * @param[in] threshold See saf_matConvFilters_findActive()
+ */
+static void saf_matConvFilters_transform
+(
+    safMatConvFilters* F,
+    void* hFFT,
+    int fftSize,
+    float* H,
+    int length_h,
+    int offset,
+    int blockSize,
+    float threshold
+)
+{
+    int no, ni, nb, nb_offset, len;
+    float* h_pad;
+
+    h_pad = malloc1d(fftSize*sizeof(float));
+    F->maxPeak = saf_matrixConv_peak(H, (F->nFilt)*(F->nCHin)*length_h);
+    for(no=0; no<F->nFilt; no++){
+        for(ni=0; ni<F->nCHin; ni++){
+            for(nb=0; nb<F->nParts; nb++){
+                memset(h_pad, 0, fftSize*sizeof(float));
+                nb_offset = offset + nb*blockSize;
+                len = SAF_MIN(blockSize, length_h-nb_offset);
+                if(len>0)
+                    memcpy(h_pad, &H[no*(F->nCHin)*length_h+ni*length_h+nb_offset], len*sizeof(float));
+                saf_rfft_forward(hFFT, h_pad, &(F->H_f[no][nb*(F->nCHin)*(F->nBins)+ni*(F->nBins)]));
+                F->blockPeak[(no*(F->nParts)+nb)*(F->nCHin)+ni] = len>0 ? saf_matrixConv_peak(h_pad, len) : 0.0f;
+            }
+        }
+    }
+    saf_matConvFilters_findActive(F, threshold);
+    free(h_pad);
+}
+
+/** Returns the number of active partitions of filter "no", which have offsets below "limit" */
+static int saf_matConvFilters_countBelow
+(
+    safMatConvFilters* F,
+    int no,
+    int limit
+)
+{
+    int k;
+    for(k=0; k<F->nActive[no] && F->activeIdx[no][k]<limit; k++) {}
+    return k;
+}
+
+/**
+ * Multiplies the active filter partitions with the corresponding FDL slots, and
+ * accumulates the result: Z += sum_k H[idx[k]] .* X[idx[k]+xOffset]
+ */
+static void saf_matrixConv_sumActive
+(
+    float_complex* H,
+    float_complex* X,
+    int xOffset,
+    int* idx,
+    int nIdx,
+    int nBins,
+    float_complex* Z
+)
+{
+    int k;
+
+    for(k=0; k<nIdx; k++)
+        utility_cvvmac(&H[idx[k]], &X[idx[k]+xOffset], nBins, NO_CONJ, Z);
+}
+
+
+/* ========================================================================== */
+/*                 Non-Uniform Partitioned Convolution (internal)             */
+/* ========================================================================== */
+
+/** Number of partitions in each level of the non-uniform partitioning (except
+ *  for the final level, which takes whatever remains of the filters) */
+#define NUP_PARTITIONS_PER_LEVEL ( 2 )
+/** Largest block/partition size (in samples) employed by the non-uniform
+ *  partitioning, unless the hopsize is larger than this */
+#define NUP_MAX_BLOCK_SIZE ( 16384 )
+
+/**
+ * One level of the non-uniform partitioning; i.e. a uniformly partitioned
+ * convolution, with its own block size and frequency-domain delay line (FDL),
+ * which covers filter taps: offset ... offset+nParts*blockSize-1
+ *
+ * Three filter sets are rotated when the filters are updated: the current
+ * set, the old set (which is still applied to the FDL slots holding input
+ * blocks that arrived prior to the update), and a staging set.
+ */
+typedef struct _safNupConvLevel {
+    int blockSize;        /**< Block/partition size, in samples */
+    int hopsPerBlock;     /**< blockSize/hopSize */
+    int fftSize;          /**< 2*blockSize */
+    int nBins;            /**< blockSize+1 */
+    int nParts;           /**< Number of partitions in this level */
+    int offset;           /**< Filter offset (in samples) of the first partition */
+    void* hFFT;           /**< saf_rfft handle; fftSize */
+    float_complex* X_n;   /**< FDL; FLAT: nParts x nCHin x nBins */
+    safMatConvFilters* F[3]; /**< Filter sets; see "cur", "old" and "staging" */
+    int cur, old, staging;   /**< Indices of the current, old, and staging filter sets */
+    int nSwitched;        /**< Number of FDL slots (from the first) to which the current filters apply (the rest use the old ones) */
+
+    /* Only used when the level is processed by a worker thread (levels 1 and above) */
+    saf_threadPool_job job; /**< Job which processes this level */
+    void* hNC;            /**< Parent nupConv handle */
+    int deadline;         /**< Number of hops after dispatch, by which the result must be collected */
+    int pending;          /**< Number of hops until the result is collected; 0: nothing pending */
+    int accStart;         /**< Where the result is to be added in the output accumulation buffer */
+    safMatConvFilters* jobF[2]; /**< Current and old filter sets, as of dispatch */
+    int jobSwitched;      /**< nSwitched, as of dispatch */
+    float* x_blk;         /**< Copy of the input block; FLAT: nCHin x blockSize */
+    float* x_pad;         /**< Scratch; FLAT: nCHin x fftSize */
+    float* z_n;           /**< Scratch; fftSize x 1 */
+    float* y_n;           /**< Result; FLAT: nCHout x fftSize */
+    float_complex* Z_n;   /**< Scratch */
+
+}safNupConvLevel;
+
+/**
+ * Data structure for the non-uniform partitioned convolver.
+ *
+ * The first level employs partitions of hopSize, while subsequent levels
+ * double the partition size, up to NUP_MAX_BLOCK_SIZE. A level with block size
+ * B is only computed once every B/hopSize hops, and its first partition is
+ * placed at a filter offset of at least B-hopSize; its output therefore always
+ * arrives in time, and no additional latency is incurred compared to the
+ * uniformly partitioned convolver.
+ *
+ * If a thread pool is assigned, then all levels except the first are instead
+ * processed by worker threads, and their results are only collected by the
+ * time they are due to be output.
+ */
+typedef struct _safNupConv_data {
+    int hopSize, length_h, nCHin, nCHout;
+    int diagFLAG;         /**< 1: input channel i is only convolved with filter i, and sent to output i */
+    int nLevels;
+    safNupConvLevel* levels;
+    int maxBlockSize;     /**< Largest block size (over all levels) */
+    int hopCount;         /**< Hop counter, modulo maxBlockSize/hopSize */
+    float threshold;      /**< Sparsity threshold (see saf_matConvFilters_findActive()) */
+    int accLen, accPos;   /**< Length of, and read position in, the output accumulation buffer */
+    float* x_hist;        /**< Input history; FLAT: nCHin x maxBlockSize */
+    float* y_acc;         /**< Output accumulation buffer; FLAT: nCHout x accLen */
+    float* x_pad, *z_n;
+    float_complex* Z_n;
+    void* hThreadPool;    /**< saf_threadPool handle (not owned); NULL: single-threaded */
+
+}safNupConv_data;
+
+/**
+ * Determines the non-uniform partitioning scheme
+ *
+ * @param[in]  hopSize   Hop size in samples
+ * @param[in]  length_h  Length of the filters
+ * @param[out] blockSize Block size of each level (or NULL); nLevels x 1
+ * @param[out] nParts    Number of partitions of each level (or NULL); nLevels x 1
+ * @param[out] offset    Filter offset of the first partition of each level (or
+ *                       NULL); nLevels x 1
+ * @returns Number of levels
+ */
+static int saf_nupConv_getPartitioning
+(
+    int hopSize,
+    int length_h,
+    int* blockSize,
+    int* nParts,
+    int* offset
+)
+{
+    int nLevels, bs, np, off;
+
+    nLevels = 0;
+    off = 0;
+    bs = hopSize;
+    while(off < length_h){
+        np = (int)ceilf((float)(length_h-off)/(float)bs);
+        if(2*bs<=SAF_MAX(hopSize, NUP_MAX_BLOCK_SIZE) && np>NUP_PARTITIONS_PER_LEVEL)
+            np = NUP_PARTITIONS_PER_LEVEL; /* The next level takes over from here */
+        if(blockSize!=NULL)
+            blockSize[nLevels] = bs;
+        if(nParts!=NULL)
+            nParts[nLevels] = np;
+        if(offset!=NULL)
+            offset[nLevels] = off;
+        nLevels++;
+        off += np*bs;
+        bs *= 2;
+    }
+    return nLevels;
+}
+
+/**
+ * Creates an instance of the non-uniform partitioned convolver
+ *
+ * @param[in] phNC     (&) address of nupConv handle
+ * @param[in] hopSize  Hop size in samples
+ * @param[in] S        Filter sets for each level (see
+ *                     saf_nupConv_getPartitioning()), the spectra of which are
+ *                     borrowed (and must outlive the instance); nLevels x 1
+ * @param[in] length_h Length of the filters
+ * @param[in] nCHin    Number of input channels
+ * @param[in] nCHout   Number of output channels (must equal nCHin if diagFLAG)
+ * @param[in] diagFLAG '1': multi-channel (nCHin==nCHout, one filter per
+ *                     channel), '0': matrix convolution
+ */
+static void saf_nupConv_create
+(
+    void ** const phNC,
+    int hopSize,
+    safMatConvFilters** S,
+    int length_h,
+    int nCHin,
+    int nCHout,
+    int diagFLAG
+)
+{
+    *phNC = malloc1d(sizeof(safNupConv_data));
+    safNupConv_data *h = (safNupConv_data*)(*phNC);
+    safNupConvLevel* lev;
+    int l, maxAccLen;
+    int* blockSize, *nParts, *offset;
+
+    saf_assert(!diagFLAG || nCHin==nCHout, "Number of inputs and outputs must be equal for multi-channel convolution");
+    h->hopSize = hopSize;
+    h->length_h = length_h;
+    h->nCHin = nCHin;
+    h->nCHout = nCHout;
+    h->diagFLAG = diagFLAG;
+    h->threshold = 0.0f;
+
+    /* Determine the partitioning scheme */
+    h->nLevels = saf_nupConv_getPartitioning(hopSize, length_h, NULL, NULL, NULL);
+    saf_assert(h->nLevels>=1, "Number of filter blocks/partitions must be at least 1");
+    blockSize = malloc1d(h->nLevels*sizeof(int));
+    nParts = malloc1d(h->nLevels*sizeof(int));
+    offset = malloc1d(h->nLevels*sizeof(int));
+    saf_nupConv_getPartitioning(hopSize, length_h, blockSize, nParts, offset);
+    h->levels = malloc1d(h->nLevels*sizeof(safNupConvLevel));
+    for(l=0; l<h->nLevels; l++){
+        lev = &(h->levels[l]);
+        lev->blockSize = blockSize[l];
+        lev->hopsPerBlock = blockSize[l]/hopSize;
+        lev->fftSize = 2*blockSize[l];
+        lev->nBins = blockSize[l]+1;
+        lev->nParts = nParts[l];
+        lev->offset = offset[l];
+        lev->deadline = SAF_MAX(SAF_MIN((offset[l]-blockSize[l]+hopSize)/hopSize, lev->hopsPerBlock), 1);
+        lev->pending = 0;
+        lev->hNC = NULL;
+        lev->x_blk = lev->x_pad = lev->z_n = lev->y_n = NULL;
+        lev->Z_n = NULL;
+        saf_assert(offset[l]>=blockSize[l]-hopSize, "Partition would not be ready in time");
+    }
+    h->maxBlockSize = h->levels[h->nLevels-1].blockSize;
+    free(blockSize);
+    free(nParts);
+    free(offset);
+
+    /* Each level adds 2*blockSize samples, starting (offset-blockSize+hopSize) samples into the future */
+    maxAccLen = 0;
+    for(l=0; l<h->nLevels; l++){
+        lev = &(h->levels[l]);
+        maxAccLen = SAF_MAX(maxAccLen, lev->offset + lev->blockSize + hopSize);
+    }
+    h->accLen = (int)ceilf((float)maxAccLen/(float)hopSize)*hopSize;
+
+    /* Allocate memory for buffers */
+    h->x_hist = calloc1d(nCHin * (h->maxBlockSize), sizeof(float));
+    h->y_acc = calloc1d(nCHout * (h->accLen), sizeof(float));
+    h->x_pad = calloc1d(nCHin * 2 * (h->maxBlockSize), sizeof(float));
+    h->z_n = malloc1d(2 * (h->maxBlockSize) * sizeof(float));
+    h->Z_n = malloc1d(((h->maxBlockSize)+1) * sizeof(float_complex));
+    h->hopCount = 0;
+    h->accPos = 0;
+    h->hThreadPool = NULL;
+
+    /* Borrow the partitioned filter spectra, for each level (the other filter sets are only allocated if the filters are updated) */
+    for(l=0; l<h->nLevels; l++){
+        lev = &(h->levels[l]);
+        saf_assert(S[l]->nParts==lev->nParts && S[l]->nBins==lev->nBins, "Filter sets do not match the partitioning scheme");
+        saf_rfft_create(&(lev->hFFT), lev->fftSize);
+        saf_rfft_prepareBatch(lev->hFFT, lev->fftSize, lev->nBins, nCHin, 0);
+        lev->X_n = calloc1d(lev->nParts * nCHin * (lev->nBins), sizeof(float_complex));
+        lev->F[1] = lev->F[2] = NULL;
+        lev->cur = 0;
+        lev->staging = 1;
+        lev->old = 2;
+        lev->nSwitched = lev->nParts;
+        saf_matConvFilters_borrow(&(lev->F[0]), S[l]);
+        saf_matConvFilters_findActive(lev->F[0], h->threshold);
+    }
+}
+
+/**
+ * Destroys an instance of the non-uniform partitioned convolver
+ *
+ * @param[in] phNC (&) address of nupConv handle
+ */
+static void saf_nupConv_destroy
+(
+    void ** const phNC
+)
+{
+    safNupConv_data *h = (safNupConv_data*)(*phNC);
+    int l, i;
+
+    if(h!=NULL){
+        for(l=0; l<h->nLevels; l++){
+            if(h->levels[l].pending>0)
+                saf_threadPool_wait(h->hThreadPool, &(h->levels[l].job));
+            saf_rfft_destroy(&(h->levels[l].hFFT));
+            free(h->levels[l].X_n);
+            for(i=0; i<3; i++)
+                saf_matConvFilters_destroy(&(h->levels[l].F[i]));
+            free(h->levels[l].x_blk);
+            free(h->levels[l].x_pad);
+            free(h->levels[l].z_n);
+            free(h->levels[l].y_n);
+            free(h->levels[l].Z_n);
+        }
+        free(h->levels);
+        free(h->x_hist);
+        free(h->y_acc);
+        free(h->x_pad);
+        free(h->z_n);
+        free(h->Z_n);
+        free(h);
+        h = NULL;
+        *phNC = NULL;
+    }
+}
+
+/**
+ * Flushes the internal buffers of the non-uniform partitioned convolver with
+ * zeros
+ *
+ * @param[in] hNC nupConv handle
+ */
+static void saf_nupConv_reset
+(
+    void * const hNC
+)
+{
+    safNupConv_data *h = (safNupConv_data*)(hNC);
+    int l;
+
+    for(l=0; l<h->nLevels; l++){
+        if(h->levels[l].pending>0){
+            saf_threadPool_wait(h->hThreadPool, &(h->levels[l].job));
+            h->levels[l].pending = 0;
+        }
+        memset(h->levels[l].X_n, 0, h->levels[l].nParts*(h->nCHin)*(h->levels[l].nBins)*sizeof(float_complex));
+    }
+    memset(h->x_hist, 0, (h->nCHin)*(h->maxBlockSize)*sizeof(float));
+    memset(h->y_acc, 0, (h->nCHout)*(h->accLen)*sizeof(float));
+    h->hopCount = 0;
+    h->accPos = 0;
+}
+
+/** Adds "len" samples of "z" into the circular buffer "y" (yLen x 1), starting at "yStart" */
+static void saf_nupConv_overlapAdd
+(
+    float* z,
+    int len,
+    float* y,
+    int yLen,
+    int yStart
+)
+{
+    int len1;
+
+    len1 = SAF_MIN(len, yLen-yStart);
+    cblas_saxpy(len1, 1.0f, z, 1, &y[yStart], 1);
+    if(len1<len)
+        cblas_saxpy(len-len1, 1.0f, &z[len1], 1, y, 1);
+}
+
+/**
+ * Processes one block of input for one level of the non-uniform partitioned
+ * convolver, and overlap-adds the result into a circular buffer
+ *
+ * @param[in]  h         nupConv data
+ * @param[in]  lev       The level to process
+ * @param[in]  Fcur      Current filter set
+ * @param[in]  Fold      Old filter set (only used if nSwitched<nParts)
+ * @param[in]  nSwitched Number of FDL slots (from the first), to which the
+ *                       current filter set applies
+ * @param[in]  x         Latest block of input; nCHin x blockSize (with a stride
+ *                       of xStride between channels)
+ * @param[in]  xStride   Stride between the input channels
+ * @param[in]  x_pad     Scratch; nCHin*fftSize x 1
+ * @param[in]  z_n       Scratch; fftSize x 1
+ * @param[in]  Z_n       Scratch; nBins x 1
+ * @param[out] y         Circular output buffer; FLAT: nCHout x yLen
+ * @param[in]  yLen      Length of the output buffer
+ * @param[in]  yStart    Where to add the result in the output buffer
+ */
+static void saf_nupConv_processLevel
+(
+    safNupConv_data* h,
+    safNupConvLevel* lev,
+    safMatConvFilters* Fcur,
+    safMatConvFilters* Fold,
+    int nSwitched,
+    float* x,
+    int xStride,
+    float* x_pad,
+    float* z_n,
+    float_complex* Z_n,
+    float* y,
+    int yLen,
+    int yStart
+)
+{
+    int ni, no, nNew, nOld, split;
+
+    /* zero-pad the latest block of input signals and perform fft. Store in partition slot 1. */
+    memmove(&(lev->X_n[1*(h->nCHin)*(lev->nBins)]), lev->X_n, (lev->nParts-1)*(h->nCHin)*(lev->nBins)*sizeof(float_complex)); /* shuffle */
+    for(ni=0; ni<h->nCHin; ni++){
+        cblas_scopy(lev->blockSize, &x[ni*xStride], 1, &x_pad[ni*(lev->fftSize)], 1);
+        memset(&(x_pad[ni*(lev->fftSize)+(lev->blockSize)]), 0, (lev->blockSize)*sizeof(float)); /* (may be dirty from another level) */
+    }
+    saf_rfft_forward_batch(lev->hFFT, x_pad, lev->fftSize, lev->X_n, lev->nBins, h->nCHin);
+
+    /* apply convolution, and sum over the frequency-domain delay line (and inputs) prior to the inverse fft */
+    split = nSwitched * (h->nCHin) * (lev->nBins);
+    for(no=0; no<h->nCHout; no++){
+        if(h->diagFLAG)
+            utility_cvvmulsum(&(Fcur->H_f[0][no*(lev->nBins)]), (h->nCHin)*(lev->nBins), &(lev->X_n[no*(lev->nBins)]),
+                              (h->nCHin)*(lev->nBins), lev->nParts, lev->nBins, Z_n);
+        else{
+            /* If the filters were recently updated, then the FDL slots holding older input blocks still use the old filters */
+            if(nSwitched<lev->nParts){
+                nNew = saf_matConvFilters_countBelow(Fcur, no, split);
+                nOld = saf_matConvFilters_countBelow(Fold, no, split);
+            }
+            else{
+                nNew = Fcur->nActive[no];
+                nOld = 0;
+            }
+            if(nNew==0 && (nOld==0 || nSwitched>=lev->nParts || Fold->nActive[no]==nOld))
+                continue; /* (nothing to add) */
+            memset(Z_n, 0, (lev->nBins)*sizeof(float_complex));
+            saf_matrixConv_sumActive(Fcur->H_f[no], lev->X_n, 0, Fcur->activeIdx[no], nNew, lev->nBins, Z_n);
+            if(nSwitched<lev->nParts)
+                saf_matrixConv_sumActive(Fold->H_f[no], lev->X_n, 0, &(Fold->activeIdx[no][nOld]), Fold->nActive[no]-nOld, lev->nBins, Z_n);
+        }
+        saf_rfft_backward(lev->hFFT, Z_n, z_n);
+
+        /* overlap-add into the output buffer */
+        saf_nupConv_overlapAdd(z_n, lev->fftSize, &y[no*yLen], yLen, yStart);
+    }
+}
+
+/** Thread pool job, which processes one level of the non-uniform partitioning */
+static void saf_nupConv_levelJob
+(
+    void* arg
+)
+{
+    safNupConvLevel* lev = (safNupConvLevel*)arg;
+    safNupConv_data *h = (safNupConv_data*)(lev->hNC);
+
+    memset(lev->y_n, 0, (h->nCHout)*(lev->fftSize)*sizeof(float));
+    saf_nupConv_processLevel(h, lev, lev->jobF[0], lev->jobF[1], lev->jobSwitched, lev->x_blk, lev->blockSize,
+                             lev->x_pad, lev->z_n, lev->Z_n, lev->y_n, lev->fftSize, 0);
+}
+
+/** Waits for a level processed by a worker thread, and adds its result into the output accumulation buffer */
+static void saf_nupConv_collectLevel
+(
+    safNupConv_data* h,
+    safNupConvLevel* lev
+)
+{
+    int no;
+
+    saf_threadPool_wait(h->hThreadPool, &(lev->job));
+    for(no=0; no<h->nCHout; no++)
+        saf_nupConv_overlapAdd(&(lev->y_n[no*(lev->fftSize)]), lev->fftSize, &(h->y_acc[no*(h->accLen)]), h->accLen, lev->accStart);
+    lev->pending = 0;
+}
+
+/**
+ * Assigns a thread pool to the non-uniform partitioned convolver (or NULL to
+ * revert back to single-threaded processing)
+ *
+ * @param[in] hNC         nupConv handle
+ * @param[in] hThreadPool saf_threadPool handle, or NULL
+ */
+static void saf_nupConv_setThreadPool
+(
+    void * const hNC,
+    void* hThreadPool
+)
+{
+    safNupConv_data *h = (safNupConv_data*)(hNC);
+    safNupConvLevel* lev;
+    int l;
+
+    for(l=1; l<h->nLevels; l++){
+        lev = &(h->levels[l]);
+
+        /* Collect any results still pending (early, but nothing is lost) */
+        if(lev->pending>0)
+            saf_nupConv_collectLevel(h, lev);
+
+        /* Worker threads require their own buffers, which are kept until destruction */
+        if(hThreadPool!=NULL && lev->x_blk==NULL){
+            lev->hNC = hNC;
+            saf_threadPool_initJob(&(lev->job), saf_nupConv_levelJob, (void*)lev);
+            lev->x_blk = malloc1d((h->nCHin)*(lev->blockSize)*sizeof(float));
+            lev->x_pad = calloc1d((h->nCHin)*(lev->fftSize), sizeof(float));
+            lev->z_n = malloc1d((lev->fftSize)*sizeof(float));
+            lev->y_n = malloc1d((h->nCHout)*(lev->fftSize)*sizeof(float));
+            lev->Z_n = malloc1d((lev->nBins)*sizeof(float_complex));
+        }
+    }
+    h->hThreadPool = hThreadPool;
+}
+
+/**
+ * Sets the threshold, at or below which filter partitions are skipped
+ *
+ * @param[in] hNC       nupConv handle
+ * @param[in] threshold Threshold, relative to the peak of the filters
+ */
+static void saf_nupConv_setSparsityThreshold
+(
+    void * const hNC,
+    float threshold
+)
+{
+    safNupConv_data *h = (safNupConv_data*)(hNC);
+    safNupConvLevel* lev;
+    int l;
+
+    h->threshold = threshold;
+    if(h->diagFLAG)
+        return;
+    for(l=0; l<h->nLevels; l++){
+        lev = &(h->levels[l]);
+        if(lev->pending>0) /* (the result is still collected as usual) */
+            saf_threadPool_wait(h->hThreadPool, &(lev->job));
+        saf_matConvFilters_findActive(lev->F[lev->cur], threshold);
+        if(lev->nSwitched<lev->nParts)
+            saf_matConvFilters_findActive(lev->F[lev->old], threshold);
+    }
+}
+
+/**
+ * Transforms new filters into the staging filter sets (off the audio thread)
+ *
+ * @param[in] hNC      nupConv handle
+ * @param[in] H        New time-domain filters; FLAT: nCHout x nCHin x length_h
+ * @param[in] length_h Length of the new filters (no longer than at creation)
+ */
+static void saf_nupConv_stageFilters
+(
+    void * const hNC,
+    float* H,
+    int length_h
+)
+{
+    safNupConv_data *h = (safNupConv_data*)(hNC);
+    safNupConvLevel* lev;
+    void* hFFT;
+    int l;
+
+    saf_assert(!h->diagFLAG, "Not supported for multi-channel convolution");
+    for(l=0; l<h->nLevels; l++){
+        lev = &(h->levels[l]);
+        saf_matConvFilters_prepare(&(lev->F[lev->staging]), h->nCHout, lev->nParts, h->nCHin, lev->nBins);
+        saf_rfft_create(&hFFT, lev->fftSize); /* (the level's own handle may be in use) */
+        saf_matConvFilters_transform(lev->F[lev->staging], hFFT, lev->fftSize, H, length_h, lev->offset, lev->blockSize, h->threshold);
+        saf_rfft_destroy(&hFFT);
+    }
+}
+
+/**
+ * Returns 1 if the staged filters may be swapped in; i.e. the old filters are
+ * no longer in use, and the next hop starts a new block for all levels (so that
+ * no block contains input from both before and after the swap)
+ */
+static int saf_nupConv_canSwap
+(
+    void * const hNC
+)
+{
+    safNupConv_data *h = (safNupConv_data*)(hNC);
+    int l;
+
+    if(h->hopCount!=0)
+        return 0;
+    for(l=0; l<h->nLevels; l++)
+        if(h->levels[l].nSwitched < h->levels[l].nParts)
+            return 0;
+    return 1;
+}
+
+/**
+ * Swaps in the staged filters. The new filters are applied to each new block
+ * of input, while the old filters continue to be applied to the input blocks
+ * which arrived before the swap (until they leave the FDLs). The transition is
+ * therefore seamless, and the reverberant tail of the old filters is retained.
+ *
+ * @param[in] hNC nupConv handle
+ */
+static void saf_nupConv_swapFilters
+(
+    void * const hNC
+)
+{
+    safNupConv_data *h = (safNupConv_data*)(hNC);
+    safNupConvLevel* lev;
+    int l, tmp;
+
+    for(l=0; l<h->nLevels; l++){
+        lev = &(h->levels[l]);
+        tmp = lev->old;
+        lev->old = lev->cur;
+        lev->cur = lev->staging;
+        lev->staging = tmp;
+        lev->nSwitched = 0;
+    }
+}
+
+/**
+ * Performs the non-uniform partitioned convolution
+ *
+ * @param[in]  hNC        nupConv handle
+ * @param[in]  inputSigs  Input signals;  FLAT: nCHin  x hopSize
+ * @param[out] outputSigs Output signals; FLAT: nCHout x hopSize
+ */
+static void saf_nupConv_apply
+(
+    void * const hNC,
+    float* inputSig,
+    float* outputSig
+)
+{
+    safNupConv_data *h = (safNupConv_data*)(hNC);
+    safNupConvLevel* lev;
+    int l, ni, no, histPos, accStart;
+    float* y_acc;
+
+    /* Collect the results from worker threads, which are due */
+    for(l=1; l<h->nLevels; l++){
+        lev = &(h->levels[l]);
+        if(lev->pending>0 && --(lev->pending)==0)
+            saf_nupConv_collectLevel(h, lev);
+    }
+
+    /* Append the new input signals to the input history */
+    histPos = (h->hopCount)*(h->hopSize);
+    for(ni=0; ni<h->nCHin; ni++)
+        cblas_scopy(h->hopSize, &inputSig[ni*(h->hopSize)], 1, &(h->x_hist[ni*(h->maxBlockSize)+histPos]), 1);
+    histPos += h->hopSize;
+
+    /* Process the levels which have received a complete block of input */
+    for(l=0; l<h->nLevels; l++){
+        lev = &(h->levels[l]);
+        if(((h->hopCount)+1) % (lev->hopsPerBlock) != 0)
+            continue;
+        lev->nSwitched = SAF_MIN(lev->nSwitched+1, lev->nParts); /* (the new block goes into the first slot) */
+
+        /* This block of input started (blockSize-hopSize) samples ago, and the level starts at "offset" samples into the filters */
+        accStart = ((h->accPos) + (lev->offset) - (lev->blockSize) + (h->hopSize)) % (h->accLen);
+
+        if(l>0 && h->hThreadPool!=NULL){
+            /* Hand over to a worker thread. The result is not needed for another "deadline" hops */
+            for(ni=0; ni<h->nCHin; ni++)
+                cblas_scopy(lev->blockSize, &(h->x_hist[ni*(h->maxBlockSize)+histPos-(lev->blockSize)]), 1, &(lev->x_blk[ni*(lev->blockSize)]), 1);
+            lev->jobF[0] = lev->F[lev->cur];
+            lev->jobF[1] = lev->F[lev->old];
+            lev->jobSwitched = lev->nSwitched;
+            lev->accStart = accStart;
+            lev->pending = lev->deadline;
+            saf_threadPool_submit(h->hThreadPool, &(lev->job));
+        }
+        else
+            saf_nupConv_processLevel(h, lev, lev->F[lev->cur], lev->F[lev->old], lev->nSwitched, &(h->x_hist[histPos-(lev->blockSize)]),
+                                     h->maxBlockSize, h->x_pad, h->z_n, h->Z_n, h->y_acc, h->accLen, accStart);
+    }
+
+    /* Output the current hop, and clear it for re-use */
+    for(no=0; no<h->nCHout; no++){
+        y_acc = &(h->y_acc[no*(h->accLen)+(h->accPos)]);
+        cblas_scopy(h->hopSize, y_acc, 1, &outputSig[no*(h->hopSize)], 1);
+        memset(y_acc, 0, (h->hopSize)*sizeof(float));
+    }
+
+    /* for next iteration: */
+    h->accPos = ((h->accPos) + (h->hopSize)) % (h->accLen);
+    h->hopCount = ((h->hopCount)+1) % ((h->maxBlockSize)/(h->hopSize));
+}
+
+/* ========================================================================== */
+/*                            Shared Filter Spectra                           */
+/* ========================================================================== */
+
+/**
+ * Data structure for the shared filter spectra. These are never modified once
+ * created, and are destroyed when the last reference to them is released.
+ */
+typedef struct _safConvSpectra {
+    volatile long refCount; /**< Number of references (the creator's, plus one per attached convolver) */
+    int hopSize, length_h, nCHin, nCHout;
+    int usePartFLAG;        /**< See saf_matrixConv_create() */
+    int diagFLAG;           /**< 1: for saf_multiConv (nCHin==nCHout), 0: for saf_matrixConv */
+    int fftSize;            /**< FFT size (not used for usePartFLAG==2) */
+    int nSets;              /**< Number of filter sets (the number of levels if usePartFLAG==2, otherwise 1) */
+    safMatConvFilters** F;  /**< Filter sets; nSets x 1 */
+
+}safConvSpectra;
+
+/** Adds "delta" to the reference count of a saf_convSpectra object, and returns the new count */
+static long saf_convSpectra_addRef
+(
+    safConvSpectra* s,
+    long delta
+)
+{
+    long count;
+
+    do {
+        count = saf_atomic_load(&(s->refCount));
+    } while(!saf_atomic_compareExchange(&(s->refCount), count, count+delta));
+    return count+delta;
+}
+
+/**
+ * Creates the shared filter spectra
+ *
+ * @param[in] phCS        (&) address of saf_convSpectra handle
+ * @param[in] hopSize     Hop size in samples
+ * @param[in] H           Time-domain filters; FLAT: nCHout x nCHin x length_h,
+ *                        or FLAT: nCH x length_h if diagFLAG==1
+ * @param[in] length_h    Length of the filters
+ * @param[in] nCHin       Number of input channels
+ * @param[in] nCHout      Number of output channels (must equal nCHin if
+ *                        diagFLAG)
+ * @param[in] usePartFLAG See saf_matrixConv_create()
+ * @param[in] diagFLAG    '1': multi-channel, '0': matrix convolution
+ */
+static void saf_convSpectra_create
+(
+    void ** const phCS,
+    int hopSize,
+    float* H,
+    int length_h,
+    int nCHin,
+    int nCHout,
+    int usePartFLAG,
+    int diagFLAG
+)
+{
+    *phCS = malloc1d(sizeof(safConvSpectra));
+    safConvSpectra *s = (safConvSpectra*)(*phCS);
+    int l, nFilt;
+    int* blockSize, *nParts, *offset;
+    void* hFFT;
+
+    saf_assert(!diagFLAG || nCHin==nCHout, "Number of inputs and outputs must be equal for multi-channel convolution");
+    s->refCount = 1;
+    s->hopSize = hopSize;
+    s->length_h = length_h;
+    s->nCHin = nCHin;
+    s->nCHout = nCHout;
+    s->usePartFLAG = usePartFLAG;
+    s->diagFLAG = diagFLAG;
+    nFilt = diagFLAG ? 1 : nCHout;
+
+    /* Determine the partitioning scheme */
+    if(usePartFLAG==2){
+        s->fftSize = 0;
+        s->nSets = saf_nupConv_getPartitioning(hopSize, length_h, NULL, NULL, NULL);
+        blockSize = malloc1d(s->nSets*sizeof(int));
+        nParts = malloc1d(s->nSets*sizeof(int));
+        offset = malloc1d(s->nSets*sizeof(int));
+        saf_nupConv_getPartitioning(hopSize, length_h, blockSize, nParts, offset);
+    }
+    else{
+        s->nSets = 1;
+        blockSize = malloc1d(sizeof(int));
+        nParts = malloc1d(sizeof(int));
+        offset = calloc1d(1, sizeof(int));
+        if(!usePartFLAG){
+            /* One partition, which is zero-padded to avoid circular convolution */
+            s->fftSize = (int)(ceilf((float)(hopSize+length_h-1)/(float)hopSize)+0.1f)*hopSize;
+            blockSize[0] = length_h;
+            nParts[0] = 1;
+        }
+        else{
+            s->fftSize = 2*hopSize;
+            blockSize[0] = hopSize;
+            nParts[0] = (int)ceilf((float)length_h/(float)hopSize);
+        }
+        saf_assert(nParts[0]>=1, "Number of filter blocks/partitions must be at least 1");
+    }
+
+    /* Perform fft on the partitioned filters */
+    s->F = malloc1d(s->nSets*sizeof(safMatConvFilters*));
+    for(l=0; l<s->nSets; l++){
+        if(usePartFLAG==2){
+            saf_rfft_create(&hFFT, 2*blockSize[l]);
+            saf_matConvFilters_create(&(s->F[l]), nFilt, nParts[l], nCHin, blockSize[l]+1);
+            saf_matConvFilters_transform(s->F[l], hFFT, 2*blockSize[l], H, length_h, offset[l], blockSize[l], 0.0f);
+        }
+        else{
+            saf_rfft_create(&hFFT, s->fftSize);
+            saf_matConvFilters_create(&(s->F[l]), nFilt, nParts[l], nCHin, s->fftSize/2+1);
+            saf_matConvFilters_transform(s->F[l], hFFT, s->fftSize, H, length_h, 0, blockSize[l], 0.0f);
+        }
+        saf_rfft_destroy(&hFFT);
+    }
+    free(blockSize);
+    free(nParts);
+    free(offset);
+}
+
+void saf_convSpectra_createMatrix
+(
+    void ** const phCS,
+    int hopSize,
+    float* H,
+    int length_h,
+    int nCHin,
+    int nCHout,
+    int usePartFLAG
+)
+{
+    saf_convSpectra_create(phCS, hopSize, H, length_h, nCHin, nCHout, usePartFLAG, 0);
+}
+
+void saf_convSpectra_createMulti
+(
+    void ** const phCS,
+    int hopSize,
+    float* H,
+    int length_h,
+    int nCH,
+    int usePartFLAG
+)
+{
+    saf_convSpectra_create(phCS, hopSize, H, length_h, nCH, nCH, usePartFLAG, 1);
+}
+
+void saf_convSpectra_destroy
+(
+    void ** const phCS
+)
+{
+    safConvSpectra *s = (safConvSpectra*)(*phCS);
+    int l;
+
+    if(s!=NULL){
+        if(saf_convSpectra_addRef(s, -1)==0){
+            for(l=0; l<s->nSets; l++)
+                saf_matConvFilters_destroy(&(s->F[l]));
+            free(s->F);
+            free(s);
+        }
+        s = NULL;
+        *phCS = NULL;
+    }
+}
+
+
 /* ========================================================================== */
 /*                              Matrix Convolver                              */
 /* ========================================================================== */
 
+/** States of the filter hand-over from saf_matrixConv_updateFilters() to saf_matrixConv_apply() */
+typedef enum {
+    SAF_MATCONV_SWAP_IDLE = 0, /**< No new filters are pending */
+    SAF_MATCONV_SWAP_STAGING,  /**< New filters are being transformed into the staging filter set */
+    SAF_MATCONV_SWAP_READY,    /**< New filters are ready to be swapped in */
+    SAF_MATCONV_SWAP_SWAPPING  /**< New filters are being swapped in by saf_matrixConv_apply() */
+
+} SAF_MATCONV_SWAP_STATES;
+
 /**
  * Data structure for the matrix convolver.
  */
@@ -40,11 +1189,85 @@ typedef struct _safMatConv_data {
     int numFilterBlocks, numOvrlpAddBlocks;
     int usePartFLAG;
     void* hFFT;
-    float* x_pad, *y_pad, *hx_n, *z_n, *ovrlpAddBuffer, *y_n_overlap;
-    float_complex* H_f, *X_n, *HX_n;
-    float_complex** Hpart_f;
+    void* hNupConv;
+    void* hSpectra;             /**< saf_convSpectra handle, which the initial filter spectra are borrowed from (a reference is held) */
+    float* x_pad, *z_n, *ovrlpAddBuffer, *y_n_overlap;
+    float_complex* X_n, *Z_n;
+    safMatConvFilters* F;       /**< Current filters (numFilterBlocks=1 for non-partitioned) */
+    safMatConvFilters* Fstaged; /**< Staged filters (NULL until the filters are first updated) */
+    float threshold;            /**< Sparsity threshold (see saf_matConvFilters_findActive()) */
+    volatile long swapState;    /**< See #SAF_MATCONV_SWAP_STATES */
+    float* z_n_new, *y_n_overlap_new, *out1, *out2, *fadeIn, *fadeOut; /**< For cross-fading to new filters (partitioned) */
+    void* hThreadPool;          /**< saf_threadPool handle (not owned); NULL: single-threaded */
+    safConvTailJob* tailJobs;   /**< Tail jobs; nTailJobs x 1 (NULL if not used) */
+    int nTailJobs;              /**< Number of tail jobs */
+    float_complex* Ztail;       /**< Summed tail partitions for the next hop; FLAT: nCHout x nBins */
     
 }safMatConv_data;
+
+/** Thread pool job, which computes the tail partitions of the matrix convolver */
+static void saf_matrixConv_tailJob
+(
+    void* arg
+)
+{
+    safConvTailJob* job = (safConvTailJob*)arg;
+    safMatConv_data *h = (safMatConv_data*)(job->hConv);
+    safMatConvFilters* F = h->F;
+    int no;
+    float_complex* Ztail;
+
+    /* Partitions 1...N-1 of the filters are applied to partition slots 0...N-2 of the FDL, which become slots 1...N-1 after the next shuffle */
+    for(no=job->start; no<job->end; no++){
+        Ztail = &(h->Ztail[no*(h->nBins)]);
+        memset(Ztail, 0, (h->nBins)*sizeof(float_complex));
+        saf_matrixConv_sumActive(F->H_f[no], h->X_n, -(h->nCHin)*(h->nBins), &(F->activeIdx[no][F->nActiveHead[no]]),
+                                 F->nActive[no]-F->nActiveHead[no], h->nBins, Ztail);
+    }
+}
+
+/** Sums all (active) partitions of the filters for output "no" over the FDL, and performs the inverse fft */
+static void saf_matrixConv_convolve
+(
+    safMatConv_data* h,
+    safMatConvFilters* F,
+    int no,
+    float* z_n
+)
+{
+    if(F->nActive[no]>0){
+        memset(h->Z_n, 0, (h->nBins)*sizeof(float_complex));
+        saf_matrixConv_sumActive(F->H_f[no], h->X_n, 0, F->activeIdx[no], F->nActive[no], h->nBins, h->Z_n); /* This is the bulk of the CPU work */
+        saf_rfft_backward(h->hFFT, h->Z_n, z_n);
+    }
+    else
+        memset(z_n, 0, (h->fftSize)*sizeof(float));
+}
+
+/**
+ * Swaps in the staged filters, if new filters are ready (called by
+ * saf_matrixConv_apply())
+ *
+ * @returns The old filters if they were swapped out (in which case, the swap
+ *          state must be returned to #SAF_MATCONV_SWAP_IDLE once they are no
+ *          longer needed), or NULL otherwise
+ */
+static safMatConvFilters* saf_matrixConv_swapIn
+(
+    safMatConv_data* h
+)
+{
+    safMatConvFilters* Fold;
+
+    if(saf_atomic_load(&(h->swapState))!=SAF_MATCONV_SWAP_READY ||
+       !saf_atomic_compareExchange(&(h->swapState), SAF_MATCONV_SWAP_READY, SAF_MATCONV_SWAP_SWAPPING))
+        return NULL;
+    Fold = h->F;
+    h->F = h->Fstaged;
+    h->Fstaged = Fold;
+    saf_matConvFilters_findActive(h->F, h->threshold); /* (in case the threshold has since changed) */
+    return Fold;
+}
  
 void  saf_matrixConv_create
 (
@@ -56,76 +1279,92 @@ void  saf_matrixConv_create
     int nCHout,
     int usePartFLAG
 )
+{
+    void* hCS;
+
+    /* The instance holds the only other reference, so the spectra are destroyed along with it */
+    saf_convSpectra_createMatrix(&hCS, hopSize, H, length_h, nCHin, nCHout, usePartFLAG);
+    saf_matrixConv_createShared(phMC, hCS);
+    saf_convSpectra_destroy(&hCS);
+}
+
+void  saf_matrixConv_createShared
+(
+    void ** const phMC,
+    void * const hCS
+)
 {
     *phMC = malloc1d(sizeof(safMatConv_data));
     safMatConv_data *h = (safMatConv_data*)(*phMC);
-    int no, ni, nb;
-    float* h_pad, *h_pad_2hops;
-    
-    h->hopSize = hopSize;
-    h->length_h = length_h;
-    h->nCHin = nCHin;
-    h->nCHout = nCHout;
-    h->usePartFLAG = usePartFLAG;
+    safConvSpectra *s = (safConvSpectra*)(hCS);
+    int n, hopSize, nCHin, nCHout;
+
+    saf_assert(!s->diagFLAG, "Spectra were created for saf_multiConv");
+    saf_convSpectra_addRef(s, 1);
+    h->hSpectra = hCS;
+    h->hopSize = hopSize = s->hopSize;
+    h->length_h = s->length_h;
+    h->nCHin = nCHin = s->nCHin;
+    h->nCHout = nCHout = s->nCHout;
+    h->usePartFLAG = s->usePartFLAG;
+    h->hNupConv = NULL;
+    h->hThreadPool = NULL;
+    h->tailJobs = NULL;
+    h->nTailJobs = 0;
+    h->Ztail = NULL;
+    h->F = h->Fstaged = NULL;
+    h->threshold = 0.0f; /* (initially, only the sub-filters/partitions which are entirely zero are skipped) */
+    h->swapState = SAF_MATCONV_SWAP_IDLE;
     
-    if(!h->usePartFLAG){
+    if(h->usePartFLAG==2){
+        /* intialise non-uniform partitioned convolution mode */
+        saf_nupConv_create(&(h->hNupConv), hopSize, s->F, h->length_h, nCHin, nCHout, 0);
+    }
+    else if(!h->usePartFLAG){
         /* intialise non-partitioned convolution mode */
-        h->numOvrlpAddBlocks = (int)(ceilf((float)(hopSize+length_h-1)/(float)hopSize)+0.1f);
-        //h->numOvrlpAddBlocks = nextpow2((int)(ceilf((float)(hopSize+length_h-1)/(float)hopSize)+0.1f));
-        h->fftSize = (h->numOvrlpAddBlocks)*hopSize;
+        h->fftSize = s->fftSize;
+        h->numOvrlpAddBlocks = (h->fftSize)/hopSize;
         h->nBins = h->fftSize/2 + 1;
         
-        /* Allocate memory for buffers and perform fft on H */
+        /* Allocate memory for buffers and borrow the spectra of H */
         h->ovrlpAddBuffer = calloc1d(nCHout*(h->fftSize), sizeof(float));
-        h->x_pad = calloc1d((h->nCHin)*(h->fftSize), sizeof(float)); // CALLOC
-        h->y_pad = malloc1d((h->nCHout)*(h->fftSize)*sizeof(float));
-        h->hx_n = malloc1d((h->fftSize) * sizeof(float));
-        h->H_f = malloc1d((h->nCHout)*(h->nCHin)*(h->nBins)*sizeof(float_complex));
-        h->X_n = malloc1d((h->nCHout)*(h->nCHin)*(h->nBins)*sizeof(float_complex));
-        h->HX_n = malloc1d((h->nCHout)*(h->nCHin)*(h->nBins)*sizeof(float_complex));
-        h->z_n = malloc1d((h->fftSize) * sizeof(float));
+        h->x_pad = calloc1d_aligned((h->nCHin)*(h->fftSize), sizeof(float)); // CALLOC
+        h->X_n = malloc1d_aligned((h->nCHin)*(h->nBins)*sizeof(float_complex));
+        h->Z_n = malloc1d_aligned((h->nBins)*sizeof(float_complex));
+        h->z_n = malloc1d_aligned((h->fftSize) * sizeof(float));
         saf_rfft_create(&(h->hFFT), h->fftSize);
-        h_pad = calloc1d(h->fftSize, sizeof(float));
-        for(no=0; no<nCHout; no++){
-            for(ni=0; ni<nCHin; ni++){
-                memcpy(h_pad, &(H[no*nCHin*length_h+ni*length_h]), length_h*sizeof(float));
-                saf_rfft_forward(h->hFFT, h_pad, &(h->H_f[no*nCHin*(h->nBins)+ni*(h->nBins)]));
-            }
-        }
-        free(h_pad);
+        saf_rfft_prepareBatch(h->hFFT, h->fftSize, h->nBins, h->nCHin, 0);
+        saf_matConvFilters_borrow(&(h->F), s->F[0]);
+        saf_matConvFilters_findActive(h->F, h->threshold);
     }
     else{
         /* intialise partitioned convolution mode */
-        h->length_h = length_h;
-        h->fftSize = 2*(h->hopSize);
+        h->fftSize = s->fftSize;
         h->nBins = hopSize+1;
-        h->numFilterBlocks = (int)ceilf((float)length_h/(float)hopSize); /* number of partitions */
-        saf_assert(h->numFilterBlocks>=1, "Number of filter blocks/partitions must be at least 1");
+        h->numFilterBlocks = s->F[0]->nParts; /* number of partitions */
         
-        /* Allocate memory for buffers and perform fft on partitioned H */
-        h_pad = calloc1d(h->numFilterBlocks * hopSize, sizeof(float));
-        h_pad_2hops = calloc1d(2 * hopSize, sizeof(float));
-        h->Hpart_f = malloc1d(nCHout*sizeof(float_complex*));
-        h->X_n = calloc1d(h->numFilterBlocks * nCHin * (h->nBins), sizeof(float_complex));
-        h->HX_n = malloc1d(h->numFilterBlocks * nCHin * (h->nBins) * sizeof(float_complex));
-        h->x_pad = calloc1d(2 * hopSize, sizeof(float));
-        h->hx_n = malloc1d(h->numFilterBlocks*nCHin*(h->fftSize)*sizeof(float));
+        /* Allocate memory for buffers and borrow the spectra of partitioned H */
+        h->X_n = calloc1d_aligned(h->numFilterBlocks * nCHin * (h->nBins), sizeof(float_complex));
+        h->Z_n = malloc1d_aligned((h->nBins)*sizeof(float_complex));
+        h->x_pad = calloc1d_aligned(nCHin * (h->fftSize), sizeof(float)); /* (second halves remain zero) */
         h->y_n_overlap = calloc1d(nCHout*hopSize, sizeof(float));
-        h->z_n = malloc1d((h->fftSize) * sizeof(float));
+        h->z_n = malloc1d_aligned((h->fftSize) * sizeof(float));
         saf_rfft_create(&(h->hFFT), h->fftSize);
-        for(no=0; no<nCHout; no++){
-            h->Hpart_f[no] = malloc1d(h->numFilterBlocks*nCHin*(h->nBins)*sizeof(float_complex));
-            for(ni=0; ni<nCHin; ni++){
-                memcpy(h_pad, &H[no*nCHin*length_h+ni*length_h], length_h*sizeof(float)); /* zero pad filter, to be multiple of hopsize */
-                for (nb=0; nb<h->numFilterBlocks; nb++){
-                    memcpy(h_pad_2hops, &(h_pad[nb*hopSize]), hopSize*sizeof(float));
-                    saf_rfft_forward(h->hFFT, h_pad_2hops, &(h->Hpart_f[no][nb*nCHin*(h->nBins)+ni*(h->nBins)]));
-                }
-            }
+        saf_rfft_prepareBatch(h->hFFT, h->fftSize, h->nBins, nCHin, 0);
+        saf_matConvFilters_borrow(&(h->F), s->F[0]);
+        saf_matConvFilters_findActive(h->F, h->threshold);
+
+        /* For cross-fading to new filters (see saf_matrixConv_updateFilters()) */
+        h->z_n_new = malloc1d((h->fftSize) * sizeof(float));
+        h->y_n_overlap_new = malloc1d(nCHout*hopSize*sizeof(float));
+        h->out1 = malloc1d(hopSize*sizeof(float));
+        h->out2 = malloc1d(hopSize*sizeof(float));
+        h->fadeIn = malloc1d(hopSize*sizeof(float));
+        h->fadeOut = malloc1d(hopSize*sizeof(float));
+        for(n=0; n<hopSize; n++){
+            h->fadeIn[n] = (float)n / (float)SAF_MAX(hopSize-1, 1);
+            h->fadeOut[n] = 1.0f - h->fadeIn[n];
         }
-        
-        free(h_pad);
-        free(h_pad_2hops);
     }
 }
 
@@ -135,25 +1374,35 @@ void saf_matrixConv_destroy
 )
 {
     safMatConv_data *h = (safMatConv_data*)(*phMC);
-    int no;
     
-    if(h!=NULL){
+    if(h!=NULL && h->usePartFLAG==2){
+        saf_nupConv_destroy(&(h->hNupConv));
+        saf_convSpectra_destroy(&(h->hSpectra));
+        free(h);
+        h = NULL;
+        *phMC = NULL;
+    }
+    else if(h!=NULL){
+        saf_convTail_destroyJobs(&(h->tailJobs), h->nTailJobs, h->hThreadPool);
         saf_rfft_destroy(&(h->hFFT));
-        free(h->X_n);
-        free(h->x_pad);
-        free(h->z_n);
-        free(h->hx_n);
-        free(h->HX_n);
-        if(!h->usePartFLAG){
+        free1d_aligned(h->X_n);
+        free1d_aligned(h->x_pad);
+        free1d_aligned(h->z_n);
+        free1d_aligned(h->Z_n);
+        free(h->Ztail);
+        saf_matConvFilters_destroy(&(h->F));
+        saf_matConvFilters_destroy(&(h->Fstaged));
+        saf_convSpectra_destroy(&(h->hSpectra));
+        if(!h->usePartFLAG)
             free(h->ovrlpAddBuffer);
-            free(h->y_pad);
-            free(h->H_f);
-        }
         else{
             free(h->y_n_overlap);
-            for(no=0; no<h->nCHout; no++)
-                free(h->Hpart_f[no]);
-            free(h->Hpart_f);
+            free(h->z_n_new);
+            free(h->y_n_overlap_new);
+            free(h->out1);
+            free(h->out2);
+            free(h->fadeIn);
+            free(h->fadeOut);
         }
         free(h);
         h = NULL;
@@ -168,10 +1417,97 @@ void saf_matrixConv_reset
 {
     safMatConv_data *h = (safMatConv_data*)(hMC);
 
-    if(!h->usePartFLAG)
+    if(h->usePartFLAG==2)
+        saf_nupConv_reset(h->hNupConv);
+    else if(!h->usePartFLAG)
         memset(h->ovrlpAddBuffer, 0, h->nCHout*(h->fftSize)*sizeof(float));
-    else
+    else{
+        if(h->tailJobs!=NULL){
+            saf_convTail_wait(h->tailJobs, h->nTailJobs, h->hThreadPool);
+            memset(h->Ztail, 0, h->nCHout*h->nBins*sizeof(float_complex));
+        }
+        memset(h->X_n, 0, h->numFilterBlocks*h->nCHin*h->nBins*sizeof(float_complex));
         memset(h->y_n_overlap, 0, h->nCHout*h->hopSize*sizeof(float));
+    }
+}
+
+void saf_matrixConv_setThreadPool
+(
+    void * const hMC,
+    void* hThreadPool
+)
+{
+    safMatConv_data *h = (safMatConv_data*)(hMC);
+
+    if(h->usePartFLAG==2)
+        saf_nupConv_setThreadPool(h->hNupConv, hThreadPool);
+    else if(h->usePartFLAG){
+        saf_convTail_destroyJobs(&(h->tailJobs), h->nTailJobs, h->hThreadPool);
+        if(hThreadPool!=NULL && h->numFilterBlocks>1){
+            saf_convTail_createJobs(&(h->tailJobs), &(h->nTailJobs), hThreadPool, hMC, saf_matrixConv_tailJob,
+                                    h->nCHout);
+            if(h->Ztail==NULL)
+                h->Ztail = malloc1d((h->nCHout)*(h->nBins)*sizeof(float_complex));
+
+            /* The tails for the next hop are computed here, so that processing may continue seamlessly */
+            saf_convTail_run(h->tailJobs, h->nTailJobs);
+        }
+    }
+    h->hThreadPool = hThreadPool;
+}
+
+void saf_matrixConv_setSparsityThreshold
+(
+    void * const hMC,
+    float threshold
+)
+{
+    safMatConv_data *h = (safMatConv_data*)(hMC);
+
+    h->threshold = threshold;
+    if(h->usePartFLAG==2)
+        saf_nupConv_setSparsityThreshold(h->hNupConv, threshold);
+    else{
+        if(h->tailJobs!=NULL)
+            saf_convTail_wait(h->tailJobs, h->nTailJobs, h->hThreadPool);
+        saf_matConvFilters_findActive(h->F, threshold);
+
+        /* The tails for the next hop are recomputed, so that they are consistent with the new selection */
+        if(h->tailJobs!=NULL)
+            saf_convTail_run(h->tailJobs, h->nTailJobs);
+    }
+}
+
+void saf_matrixConv_updateFilters
+(
+    void * const hMC,
+    float* H,
+    int length_h
+)
+{
+    safMatConv_data *h = (safMatConv_data*)(hMC);
+    void* hFFT;
+
+    saf_assert(length_h<=h->length_h, "The filters may not be longer than those passed to saf_matrixConv_create()");
+
+    /* Wait until the staging filters are free (replacing any new filters which have not yet been swapped in) */
+    while(!saf_atomic_compareExchange(&(h->swapState), SAF_MATCONV_SWAP_IDLE, SAF_MATCONV_SWAP_STAGING) &&
+          !saf_atomic_compareExchange(&(h->swapState), SAF_MATCONV_SWAP_READY, SAF_MATCONV_SWAP_STAGING))
+        SAF_SLEEP(1);
+
+    /* Transform the new filters into the staging filter set (using a separate fft handle, since the current one may be in use) */
+    if(h->usePartFLAG==2)
+        saf_nupConv_stageFilters(h->hNupConv, H, length_h);
+    else{
+        saf_matConvFilters_prepare(&(h->Fstaged), h->nCHout, h->F->nParts, h->nCHin, h->nBins);
+        saf_rfft_create(&hFFT, h->fftSize);
+        saf_matConvFilters_transform(h->Fstaged, hFFT, h->fftSize, H, length_h, 0,
+                                     h->usePartFLAG ? h->hopSize : h->length_h, h->threshold);
+        saf_rfft_destroy(&hFFT);
+    }
+
+    /* Hand the new filters over to saf_matrixConv_apply() */
+    saf_atomic_store(&(h->swapState), SAF_MATCONV_SWAP_READY);
 }
 
 void saf_matrixConv_apply
@@ -182,31 +1518,34 @@ void saf_matrixConv_apply
 )
 {
     safMatConv_data *h = (safMatConv_data*)(hMC);
-    int ni, no, nb;
+    safMatConvFilters* Fold, *F;
+    int ni, no;
     
-    /* apply non-partitioned convolution */
-    if(!h->usePartFLAG){
-        /* zero-pad input signals and perform fft */
-        for(ni=0; ni<h->nCHin; ni++){
-            cblas_scopy(h->hopSize, &inputSig[ni*(h->hopSize)], 1, &(h->x_pad[ni*(h->fftSize)]), 1);
-            saf_rfft_forward(h->hFFT, &(h->x_pad[ni*(h->fftSize)]), &(h->X_n[ni*(h->nBins)]));
+    /* apply non-uniform partitioned convolution */
+    if(h->usePartFLAG==2){
+        /* Swap in new filters, but only once the previous old filters have left the FDLs */
+        if(saf_atomic_load(&(h->swapState))==SAF_MATCONV_SWAP_READY && saf_nupConv_canSwap(h->hNupConv) &&
+           saf_atomic_compareExchange(&(h->swapState), SAF_MATCONV_SWAP_READY, SAF_MATCONV_SWAP_SWAPPING)){
+            saf_nupConv_swapFilters(h->hNupConv);
+            saf_atomic_store(&(h->swapState), SAF_MATCONV_SWAP_IDLE);
         }
+        saf_nupConv_apply(h->hNupConv, inputSig, outputSig);
+    }
+    /* apply non-partitioned convolution */
+    else if(!h->usePartFLAG){
+        /* Swap in new filters (the tails of the old filters still ring out from the over-lap add buffer) */
+        Fold = saf_matrixConv_swapIn(h);
+        F = h->F;
 
-        /* Replicate for all outputs */
-        for(no=1; no<h->nCHout; no++)
-            cblas_ccopy(h->nCHin*(h->nBins), h->X_n, 1, &(h->X_n[no*ni*(h->nBins)]), 1);
-
-        /* Multiply spectra together */
-        utility_cvvmul(h->H_f, h->X_n, (h->nCHout)*(h->nCHin)*h->nBins, h->HX_n);
+        /* zero-pad input signals and perform fft */
+        for(ni=0; ni<h->nCHin; ni++)
+            cblas_scopy(h->hopSize, &inputSig[ni*(h->hopSize)], 1, &(h->x_pad[ni*(h->fftSize)]), 1);
+        saf_rfft_forward_batch(h->hFFT, h->x_pad, h->fftSize, h->X_n, h->nBins, h->nCHin);
 
         /* Loop over outputs */
         for(no=0; no<h->nCHout; no++){
-            /* ifft and sum */
-            memset(h->z_n, 0, (h->fftSize) * sizeof(float));
-            for(ni=0; ni<h->nCHin; ni++){
-                saf_rfft_backward(h->hFFT, &(h->HX_n[no*(h->nCHin)*(h->nBins)+ni*(h->nBins)]), h->hx_n);
-                cblas_saxpy(h->fftSize, 1.0f, h->hx_n, 1, h->z_n, 1);
-            }
+            /* Multiply spectra together, sum over the (active) inputs, and then ifft */
+            saf_matrixConv_convolve(h, F, no, h->z_n);
 
             /* shuffle the over-lap add buffer */
             memmove(&(h->ovrlpAddBuffer[no*(h->fftSize)]), &(h->ovrlpAddBuffer[no*(h->fftSize)+(h->hopSize)]), (h->numOvrlpAddBlocks-1)*(h->hopSize)*sizeof(float));
@@ -218,34 +1557,71 @@ void saf_matrixConv_apply
             /* truncate buffer and output */
             cblas_scopy(h->hopSize, &(h->ovrlpAddBuffer[no*(h->fftSize)]), 1, &(outputSig[no*(h->hopSize)]), 1); 
         }
+        if(Fold!=NULL)
+            saf_atomic_store(&(h->swapState), SAF_MATCONV_SWAP_IDLE);
     }
     /* apply partitioned convolution */
     else{
+        /* The tails for this hop must be ready before the FDL is shuffled (or the filters are swapped) */
+        if(h->tailJobs!=NULL)
+            saf_convTail_wait(h->tailJobs, h->nTailJobs, h->hThreadPool);
+
+        /* Swap in new filters, and compute the overlap that they would have produced from the previous hop (i.e. prior to the shuffle) */
+        Fold = saf_matrixConv_swapIn(h);
+        if(Fold!=NULL){
+            for(no=0; no<h->nCHout; no++){
+                saf_matrixConv_convolve(h, h->F, no, h->z_n_new);
+                cblas_scopy(h->hopSize, &(h->z_n_new[h->hopSize]), 1, &(h->y_n_overlap_new[no*(h->hopSize)]), 1);
+            }
+        }
+        F = Fold!=NULL ? Fold : h->F;
+
         /* zero-pad input signals and perform fft. Store in partition slot 1. */
         memmove(&(h->X_n[1*(h->nCHin)*(h->nBins)]), h->X_n, (h->numFilterBlocks-1)*(h->nCHin)*(h->nBins)*sizeof(float_complex)); /* shuffle */
-        for(ni=0; ni<h->nCHin; ni++){ 
-            cblas_scopy(h->hopSize, &(inputSig[ni*(h->hopSize)]), 1, h->x_pad, 1);
-            saf_rfft_forward(h->hFFT, h->x_pad, &(h->X_n[0*(h->nCHin)*(h->nBins)+ni*(h->nBins)]));
-        }
+        for(ni=0; ni<h->nCHin; ni++)
+            cblas_scopy(h->hopSize, &(inputSig[ni*(h->hopSize)]), 1, &(h->x_pad[ni*(h->fftSize)]), 1);
+        saf_rfft_forward_batch(h->hFFT, h->x_pad, h->fftSize, &(h->X_n[0*(h->nCHin)*(h->nBins)]), h->nBins, h->nCHin);
         
         /* apply convolution and inverse fft */
         for(no=0; no<h->nCHout; no++){
-            utility_cvvmul(h->Hpart_f[no], h->X_n, h->numFilterBlocks * (h->nCHin) * (h->nBins), h->HX_n); /* This is the bulk of the CPU work */
-            for(nb=0; nb<h->numFilterBlocks; nb++)
-                for(ni=0; ni<h->nCHin; ni++)
-                    saf_rfft_backward(h->hFFT, &(h->HX_n[nb*(h->nCHin)*(h->nBins)+ni*(h->nBins)]), &(h->hx_n[nb*(h->nCHin)*(h->fftSize)+ni*(h->fftSize)]));
-            
-            /* output frame for this channel is the sum over all partitions and input channels */
-            memset(h->z_n, 0, (h->fftSize) * sizeof(float));
-            for(nb=0; nb<h->numFilterBlocks*(h->nCHin); nb++)
-                cblas_saxpy(h->fftSize, 1.0f, &(h->hx_n[nb*(h->fftSize)]), 1, h->z_n, 1);
+            if(h->tailJobs!=NULL){
+                /* Only the first partition remains to be applied, and then added to the precomputed tail */
+                cblas_ccopy(h->nBins, &(h->Ztail[no*(h->nBins)]), 1, h->Z_n, 1);
+                saf_matrixConv_sumActive(F->H_f[no], h->X_n, 0, F->activeIdx[no], F->nActiveHead[no], h->nBins, h->Z_n);
+                saf_rfft_backward(h->hFFT, h->Z_n, h->z_n);
+            }
+            else{
+                /* output frame for this channel is the sum over all (active) partitions and input channels. Since the ifft is linear, this sum
+                 * is taken in the frequency-domain (i.e. over the frequency-domain delay line), so that only one ifft is required per output */
+                saf_matrixConv_convolve(h, F, no, h->z_n);
+            }
 
-            /* sum with overlap buffer and copy the result to the output buffer */
-            utility_svvadd(h->z_n, (const float*)&(h->y_n_overlap[no*(h->hopSize)]), h->hopSize, &(outputSig[no*(h->hopSize)]));
+            if(Fold!=NULL){
+                /* Cross-fade from the output of the old filters, to that of the new filters, over this hop */
+                saf_matrixConv_convolve(h, h->F, no, h->z_n_new);
+                utility_svvadd(h->z_n, (const float*)&(h->y_n_overlap[no*(h->hopSize)]), h->hopSize, h->out1);
+                utility_svvadd(h->z_n_new, (const float*)&(h->y_n_overlap_new[no*(h->hopSize)]), h->hopSize, h->out2);
+                utility_svvmul(h->out1, (const float*)h->fadeOut, h->hopSize, h->z_n);
+                utility_svvmul(h->out2, (const float*)h->fadeIn, h->hopSize, h->out1);
+                utility_svvadd(h->z_n, (const float*)h->out1, h->hopSize, &(outputSig[no*(h->hopSize)]));
 
-            /* for next iteration: */
-            cblas_scopy(h->hopSize, &(h->z_n[h->hopSize]), 1, &(h->y_n_overlap[no*(h->hopSize)]), 1);
+                /* for next iteration: */
+                cblas_scopy(h->hopSize, &(h->z_n_new[h->hopSize]), 1, &(h->y_n_overlap[no*(h->hopSize)]), 1);
+            }
+            else{
+                /* sum with overlap buffer and copy the result to the output buffer */
+                utility_svvadd(h->z_n, (const float*)&(h->y_n_overlap[no*(h->hopSize)]), h->hopSize, &(outputSig[no*(h->hopSize)]));
+
+                /* for next iteration: */
+                cblas_scopy(h->hopSize, &(h->z_n[h->hopSize]), 1, &(h->y_n_overlap[no*(h->hopSize)]), 1);
+            }
         }
+        if(Fold!=NULL)
+            saf_atomic_store(&(h->swapState), SAF_MATCONV_SWAP_IDLE);
+
+        /* Hand the tails for the next hop over to the worker threads */
+        if(h->tailJobs!=NULL)
+            saf_convTail_submit(h->tailJobs, h->nTailJobs, h->hThreadPool);
     }
 }
 
@@ -263,11 +1639,35 @@ typedef struct _safMulConv_data {
     int numOvrlpAddBlocks, numFilterBlocks;
     int usePartFLAG;
     void* hFFT;
-    float* x_pad, *z_n, *ovrlpAddBuffer, *hx_n, *y_n_overlap;
-    float_complex* X_n, *HX_n, *Z_n, *H_f, *Hpart_f;
+    void* hNupConv;
+    void* hSpectra;             /**< saf_convSpectra handle, which the filter spectra are borrowed from (a reference is held) */
+    float* x_pad, *z_n, *ovrlpAddBuffer, *y_n_overlap;
+    float_complex* X_n, *Z_n;
+    safMatConvFilters* F;       /**< Filters (i.e. one filter, with nCH inputs, of which H_f[0] is applied as-is); numFilterBlocks=1 for non-partitioned */
+    void* hThreadPool;          /**< saf_threadPool handle (not owned); NULL: single-threaded */
+    safConvTailJob* tailJobs;   /**< Tail jobs; nTailJobs x 1 (NULL if not used) */
+    int nTailJobs;              /**< Number of tail jobs */
+    float_complex* Ztail;       /**< Summed tail partitions for the next hop; FLAT: nCH x nBins */
     
 }safMulConv_data;
 
+/** Thread pool job, which computes the tail partitions of the multi-channel convolver */
+static void saf_multiConv_tailJob
+(
+    void* arg
+)
+{
+    safConvTailJob* job = (safConvTailJob*)arg;
+    safMulConv_data *h = (safMulConv_data*)(job->hConv);
+    int len;
+
+    /* Partitions 1...N-1 of the filters are applied to partition slots 0...N-2 of the FDL, which become slots 1...N-1 after the next shuffle */
+    len = (job->end - job->start) * (h->nBins);
+    utility_cvvmulsum(&(h->F->H_f[0][1*(h->nCH)*(h->nBins)+(job->start)*(h->nBins)]), (h->nCH)*(h->nBins),
+                      &(h->X_n[(job->start)*(h->nBins)]), (h->nCH)*(h->nBins), h->numFilterBlocks-1, len,
+                      &(h->Ztail[(job->start)*(h->nBins)]));
+}
+
 void saf_multiConv_create
 (
     void ** const phMC,
@@ -277,67 +1677,75 @@ void saf_multiConv_create
     int nCH,
     int usePartFLAG
 )
+{
+    void* hCS;
+
+    /* The instance holds the only other reference, so the spectra are destroyed along with it */
+    saf_convSpectra_createMulti(&hCS, hopSize, H, length_h, nCH, usePartFLAG);
+    saf_multiConv_createShared(phMC, hCS);
+    saf_convSpectra_destroy(&hCS);
+}
+
+void saf_multiConv_createShared
+(
+    void ** const phMC,
+    void * const hCS
+)
 {
     *phMC = malloc1d(sizeof(safMulConv_data));
     safMulConv_data *h = (safMulConv_data*)(*phMC);
-    int nc, nb;
-    float* h_pad, *h_pad_2hops;
-    
-    h->hopSize = hopSize;
-    h->length_h = length_h;
-    h->nCH = nCH;
-    h->usePartFLAG = usePartFLAG; 
+    safConvSpectra *s = (safConvSpectra*)(hCS);
+    int hopSize, nCH;
+
+    saf_assert(s->diagFLAG, "Spectra were created for saf_matrixConv");
+    saf_convSpectra_addRef(s, 1);
+    h->hSpectra = hCS;
+    h->hopSize = hopSize = s->hopSize;
+    h->length_h = s->length_h;
+    h->nCH = nCH = s->nCHin;
+    h->usePartFLAG = s->usePartFLAG;
+    h->hNupConv = NULL;
+    h->F = NULL;
+    h->hThreadPool = NULL;
+    h->tailJobs = NULL;
+    h->nTailJobs = 0;
+    h->Ztail = NULL;
     
-    if(!h->usePartFLAG){
+    if(h->usePartFLAG==2){
+        /* intialise non-uniform partitioned convolution mode */
+        saf_nupConv_create(&(h->hNupConv), hopSize, s->F, h->length_h, nCH, nCH, 1);
+    }
+    else if(!h->usePartFLAG){
         /* intialise non-partitioned convolution mode */
-        h->numOvrlpAddBlocks = (int)(ceilf((float)(hopSize+length_h-1)/(float)hopSize)+0.1f);
-        h->fftSize = (h->numOvrlpAddBlocks*hopSize);
+        h->fftSize = s->fftSize;
+        h->numOvrlpAddBlocks = (h->fftSize)/hopSize;
         h->nBins = h->fftSize/2 + 1;
         
-        /* Allocate memory for buffers and perform fft on partitioned H */
+        /* Allocate memory for buffers and borrow the spectra of H */
         h->ovrlpAddBuffer = calloc1d(nCH*h->fftSize, sizeof(float));
-        h_pad = calloc1d(h->fftSize, sizeof(float));
-        h->H_f = malloc1d(nCH*(h->nBins)*sizeof(float_complex));
-        h->X_n = calloc1d(nCH * (h->nBins), sizeof(float_complex));
-        h->Z_n = malloc1d(nCH * (h->nBins) * sizeof(float_complex));
-        h->x_pad = calloc1d(h->fftSize, sizeof(float));
-        h->z_n = malloc1d(nCH*(h->fftSize)*sizeof(float));
+        h->X_n = calloc1d_aligned(nCH * (h->nBins), sizeof(float_complex));
+        h->Z_n = malloc1d_aligned(nCH * (h->nBins) * sizeof(float_complex));
+        h->x_pad = calloc1d_aligned(nCH*(h->fftSize), sizeof(float));
+        h->z_n = malloc1d_aligned(nCH*(h->fftSize)*sizeof(float));
         saf_rfft_create(&(h->hFFT), h->fftSize);
-        for(nc=0; nc<nCH; nc++){
-            memcpy(h_pad, &H[nc*length_h], length_h*sizeof(float)); /* zero pad filter, to be multiple of hopsize */
-            saf_rfft_forward(h->hFFT, h_pad, &(h->H_f[nc*(h->nBins)]));
-        }
-        
-        free(h_pad);
+        saf_rfft_prepareBatch(h->hFFT, h->fftSize, h->nBins, nCH, nCH);
+        saf_matConvFilters_borrow(&(h->F), s->F[0]);
     }
     else{
         /* intialise partitioned convolution mode */
-        h->fftSize = 2*(h->hopSize);
+        h->fftSize = s->fftSize;
         h->nBins = hopSize+1;
-        h->numFilterBlocks = (int)ceilf((float)length_h/(float)hopSize); /* number of partitions */
-        saf_assert(h->numFilterBlocks>=1, "Number of filter blocks/partitions must be at least 1");
+        h->numFilterBlocks = s->F[0]->nParts; /* number of partitions */
         
-        /* Allocate memory for buffers and perform fft on partitioned H */
-        h_pad = calloc1d(h->numFilterBlocks * hopSize, sizeof(float));
-        h_pad_2hops = calloc1d(2 * hopSize, sizeof(float));
-        h->Hpart_f = malloc1d(h->numFilterBlocks*nCH*(h->nBins)*sizeof(float_complex));
-        h->X_n = calloc1d(h->numFilterBlocks * nCH * (h->nBins), sizeof(float_complex));
-        h->HX_n = calloc1d(h->numFilterBlocks * nCH * (h->nBins), sizeof(float_complex));
-        h->x_pad = calloc1d(2 * hopSize, sizeof(float));
-        h->hx_n = malloc1d(h->numFilterBlocks*nCH*(h->fftSize)*sizeof(float));
-        h->z_n = calloc1d(h->fftSize, sizeof(float));
+        /* Allocate memory for buffers and borrow the spectra of partitioned H */
+        h->X_n = calloc1d_aligned(h->numFilterBlocks * nCH * (h->nBins), sizeof(float_complex));
+        h->Z_n = malloc1d_aligned(nCH * (h->nBins) * sizeof(float_complex));
+        h->x_pad = calloc1d_aligned(nCH * (h->fftSize), sizeof(float)); /* (second halves remain zero) */
+        h->z_n = calloc1d_aligned(nCH * (h->fftSize), sizeof(float));
         h->y_n_overlap = calloc1d(nCH*hopSize, sizeof(float));
         saf_rfft_create(&(h->hFFT), h->fftSize);
-        for(nc=0; nc<nCH; nc++){
-            memcpy(h_pad, &H[nc*length_h], length_h*sizeof(float)); /* zero pad filter, to be multiple of hopsize */
-            for (nb=0; nb<h->numFilterBlocks; nb++){
-                memcpy(h_pad_2hops, &(h_pad[nb*hopSize]), hopSize*sizeof(float));
-                saf_rfft_forward(h->hFFT, h_pad_2hops, &(h->Hpart_f[nb*nCH*(h->nBins)+nc*(h->nBins)]));
-            }
-        }
-        
-        free(h_pad);
-        free(h_pad_2hops);
+        saf_rfft_prepareBatch(h->hFFT, h->fftSize, h->nBins, nCH, nCH);
+        saf_matConvFilters_borrow(&(h->F), s->F[0]);
     }
 }
 
@@ -348,21 +1756,27 @@ void saf_multiConv_destroy
 {
     safMulConv_data *h = (safMulConv_data*)(*phMC);
     
-    if(h!=NULL){
+    if(h!=NULL && h->usePartFLAG==2){
+        saf_nupConv_destroy(&(h->hNupConv));
+        saf_convSpectra_destroy(&(h->hSpectra));
+        free(h);
+        h = NULL;
+        *phMC = NULL;
+    }
+    else if(h!=NULL){
+        saf_convTail_destroyJobs(&(h->tailJobs), h->nTailJobs, h->hThreadPool);
         saf_rfft_destroy(&(h->hFFT));
-        free(h->X_n);
-        free(h->x_pad);
-        free(h->z_n);
-        if(!h->usePartFLAG){
-            free(h->Z_n);
-            free(h->H_f);
-        }
-        else{
-            free(h->HX_n);
-            free(h->hx_n);
+        free1d_aligned(h->X_n);
+        free1d_aligned(h->x_pad);
+        free1d_aligned(h->z_n);
+        free1d_aligned(h->Z_n);
+        free(h->Ztail);
+        saf_matConvFilters_destroy(&(h->F));
+        saf_convSpectra_destroy(&(h->hSpectra));
+        if(!h->usePartFLAG)
+            free(h->ovrlpAddBuffer);
+        else
             free(h->y_n_overlap);
-            free(h->Hpart_f);
-        }
         free(h);
         h = NULL;
         *phMC = NULL;
@@ -376,10 +1790,43 @@ void saf_multiConv_reset
 {
     safMulConv_data *h = (safMulConv_data*)(hMC);
 
-    if(!h->usePartFLAG)
+    if(h->usePartFLAG==2)
+        saf_nupConv_reset(h->hNupConv);
+    else if(!h->usePartFLAG)
         memset(h->ovrlpAddBuffer, 0, h->nCH*h->fftSize*sizeof(float));
-    else
+    else{
+        if(h->tailJobs!=NULL){
+            saf_convTail_wait(h->tailJobs, h->nTailJobs, h->hThreadPool);
+            memset(h->Ztail, 0, h->nCH*h->nBins*sizeof(float_complex));
+        }
+        memset(h->X_n, 0, h->numFilterBlocks*h->nCH*h->nBins*sizeof(float_complex));
         memset(h->y_n_overlap, 0, h->nCH*h->hopSize*sizeof(float));
+    }
+}
+
+void saf_multiConv_setThreadPool
+(
+    void * const hMC,
+    void* hThreadPool
+)
+{
+    safMulConv_data *h = (safMulConv_data*)(hMC);
+
+    if(h->usePartFLAG==2)
+        saf_nupConv_setThreadPool(h->hNupConv, hThreadPool);
+    else if(h->usePartFLAG){
+        saf_convTail_destroyJobs(&(h->tailJobs), h->nTailJobs, h->hThreadPool);
+        if(hThreadPool!=NULL && h->numFilterBlocks>1){
+            saf_convTail_createJobs(&(h->tailJobs), &(h->nTailJobs), hThreadPool, hMC, saf_multiConv_tailJob,
+                                    h->nCH);
+            if(h->Ztail==NULL)
+                h->Ztail = malloc1d((h->nCH)*(h->nBins)*sizeof(float_complex));
+
+            /* The tails for the next hop are computed here, so that processing may continue seamlessly */
+            saf_convTail_run(h->tailJobs, h->nTailJobs);
+        }
+    }
+    h->hThreadPool = hThreadPool;
 }
 
 void saf_multiConv_apply
@@ -390,21 +1837,22 @@ void saf_multiConv_apply
 )
 {
     safMulConv_data *h = (safMulConv_data*)(hMC);
-    int nc, nb;
+    int nc;
     
+    /* apply non-uniform partitioned convolution */
+    if(h->usePartFLAG==2)
+        saf_nupConv_apply(h->hNupConv, inputSig, outputSig);
     /* apply non-partitioned convolution */
-    if(!h->usePartFLAG){
+    else if(!h->usePartFLAG){
         /* zero-pad input signals and perform fft. */
-        for(nc=0; nc<h->nCH; nc++){
-            memcpy(h->x_pad, &(inputSig[nc*(h->hopSize)]), h->hopSize *sizeof(float));
-            saf_rfft_forward(h->hFFT, h->x_pad, &(h->X_n[nc*(h->nBins)]));
-        }
+        for(nc=0; nc<h->nCH; nc++)
+            memcpy(&(h->x_pad[nc*(h->fftSize)]), &(inputSig[nc*(h->hopSize)]), h->hopSize *sizeof(float));
+        saf_rfft_forward_batch(h->hFFT, h->x_pad, h->fftSize, h->X_n, h->nBins, h->nCH);
         
         /* apply convolution and inverse fft */
-        utility_cvvmul(h->H_f, h->X_n, (h->nCH) * (h->nBins), h->Z_n); /* This is the bulk of the CPU work */
+        utility_cvvmul(h->F->H_f[0], h->X_n, (h->nCH) * (h->nBins), h->Z_n); /* This is the bulk of the CPU work */
+        saf_rfft_backward_batch(h->hFFT, h->Z_n, h->nBins, h->z_n, h->fftSize, h->nCH);
         for(nc=0; nc<h->nCH; nc++){
-            saf_rfft_backward(h->hFFT, &(h->Z_n[nc*(h->nBins)]), &(h->z_n[nc*(h->fftSize)]));
-            
             /* sum with overlap buffer and copy the result to the output buffer */
             utility_svvcopy(&(h->ovrlpAddBuffer[nc*(h->fftSize)+(h->hopSize)]), (h->numOvrlpAddBlocks-1)*(h->hopSize), &(h->ovrlpAddBuffer[nc*(h->fftSize)]));
             memset(&(h->ovrlpAddBuffer[nc*(h->fftSize)+(h->numOvrlpAddBlocks-1)*(h->hopSize)]), 0, (h->hopSize)*sizeof(float));
@@ -414,30 +1862,37 @@ void saf_multiConv_apply
     }
     /* apply partitioned convolution */
     else{
+        /* The tails for this hop must be ready before the FDL is shuffled */
+        if(h->tailJobs!=NULL)
+            saf_convTail_wait(h->tailJobs, h->nTailJobs, h->hThreadPool);
+
         /* zero-pad input signals and perform fft. Store in partition slot 1. */
         memmove(&(h->X_n[1*(h->nCH)*(h->nBins)]), h->X_n, (h->numFilterBlocks-1)*(h->nCH)*(h->nBins)*sizeof(float_complex));
-        for(nc=0; nc<h->nCH; nc++){
-            memcpy(h->x_pad, &(inputSig[nc*(h->hopSize)]), h->hopSize * sizeof(float));
-            saf_rfft_forward(h->hFFT, h->x_pad, &(h->X_n[0*(h->nCH)*(h->nBins)+nc*(h->nBins)]));
-        }
+        for(nc=0; nc<h->nCH; nc++)
+            memcpy(&(h->x_pad[nc*(h->fftSize)]), &(inputSig[nc*(h->hopSize)]), h->hopSize * sizeof(float));
+        saf_rfft_forward_batch(h->hFFT, h->x_pad, h->fftSize, &(h->X_n[0*(h->nCH)*(h->nBins)]), h->nBins, h->nCH);
         
-        /* apply convolution and inverse fft */
-        utility_cvvmul(h->Hpart_f, h->X_n, h->numFilterBlocks * (h->nCH) * (h->nBins), h->HX_n); /* This is the bulk of the CPU work */
+        /* apply convolution and inverse fft; the output frame for each channel is the sum over all partitions (taken in the
+         * frequency-domain, so only one ifft is required) */
+        if(h->tailJobs!=NULL){ /* Only the first partition remains to be applied, and then added to the precomputed tail */
+            cblas_ccopy((h->nCH)*(h->nBins), h->Ztail, 1, h->Z_n, 1);
+            utility_cvvmac(h->F->H_f[0], h->X_n, (h->nCH) * (h->nBins), NO_CONJ, h->Z_n);
+        }
+        else
+            utility_cvvmulsum(h->F->H_f[0], (h->nCH)*(h->nBins), h->X_n, (h->nCH)*(h->nBins), h->numFilterBlocks,
+                              (h->nCH)*(h->nBins), h->Z_n); /* This is the bulk of the CPU work */
+        saf_rfft_backward_batch(h->hFFT, h->Z_n, h->nBins, h->z_n, h->fftSize, h->nCH);
         for(nc=0; nc<h->nCH; nc++){
-            for(nb=0; nb<h->numFilterBlocks; nb++)
-                saf_rfft_backward(h->hFFT, &(h->HX_n[nb*(h->nCH)*(h->nBins)+nc*(h->nBins)]), &(h->hx_n[nb*(h->nCH)*(h->fftSize)+nc*(h->fftSize)]));
-            
-            /* output frame for this channel is the sum over all partitions */
-            memset(h->z_n, 0, h->fftSize*sizeof(float));
-            for(nb=0; nb<h->numFilterBlocks; nb++)
-                cblas_saxpy(h->fftSize, 1.0f, (const float*)&(h->hx_n[nb*(h->nCH)*(h->fftSize)+nc*(h->fftSize)]), 1, h->z_n, 1);
-            
             /* sum with overlap buffer and copy the result to the output buffer */
-            utility_svvadd(h->z_n, (const float*)&(h->y_n_overlap[nc*(h->hopSize)]), h->hopSize, &(outputSig[nc* (h->hopSize)]));
+            utility_svvadd(&(h->z_n[nc*(h->fftSize)]), (const float*)&(h->y_n_overlap[nc*(h->hopSize)]), h->hopSize, &(outputSig[nc* (h->hopSize)]));
             
             /* for next iteration: */
-            memcpy(&(h->y_n_overlap[nc*(h->hopSize)]), &(h->z_n[h->hopSize]), h->hopSize*sizeof(float));
+            memcpy(&(h->y_n_overlap[nc*(h->hopSize)]), &(h->z_n[nc*(h->fftSize)+(h->hopSize)]), h->hopSize*sizeof(float));
         }
+
+        /* Hand the tails for the next hop over to the worker threads */
+        if(h->tailJobs!=NULL)
+            saf_convTail_submit(h->tailJobs, h->nTailJobs, h->hThreadPool);
     }
 }
 
@@ -445,24 +1900,270 @@ void saf_multiConv_apply
 /*                              Time-Varying Convolver                        */
 /* ========================================================================== */
 
+/** Maximum number of IRs which may be hinted at once via saf_TVConv_prefetch() */
+#define SAF_TVCONV_MAX_PREFETCH ( 16 )
+/** Maximum number of IRs which may be interpolated by saf_TVConv_applyInterp() */
+#define SAF_TVCONV_MAX_INTERP ( 8 )
+/** Number of hops over which saf_TVConv_applyInterp() ramps the interpolated spectra towards those of new weights */
+#define SAF_TVCONV_INTERP_HOPS ( 4 )
+
 /**
  * Data structure for the time-varying convolver.
+ *
+ * The partitioned spectra of the IRs are held in a cache of "cacheSize" slots.
+ * If all IRs fit, then they are all transformed upon creation. Otherwise, the
+ * IRs are transformed on demand (or in advance, if prefetched), and the least
+ * recently used IR is evicted to make room.
  */
 typedef struct _safTVConv_data {
     int hopSize, fftSize, nBins;
     int length_h, nIRs, nCHout;
     int numFilterBlocks;
     void* hFFT;
-    float* x_pad, *hx_n,
+    float* x_pad, *h_pad,
             *z_n, *z_n_last, *z_n_last2,
             *y_n_overlap, *y_n_overlap_last,
             *out1, *out2,
             *fadeIn, *fadeOut,
             *outFadeIn, *outFadeOut;
-    float_complex* X_n, *HX_n;
-    float_complex*** Hpart_f;
-    int posIdx_last, posIdx_last2;
+    float_complex* X_n, *Z_n;
+    float_complex*** Hpart_f;   /**< Partitioned IR spectra held by each cache slot; cacheSize x nCHout x (numFilterBlocks*nBins) */
+    int posIdx_last, posIdx_last2; /**< Spectra used for the previous two hops (IR index, or nIRs+b for Hinterp[b]) */
+
+    /* Spectral interpolation (see saf_TVConv_applyInterp()) */
+    float_complex*** Hinterp;   /**< Interpolated partitioned spectra (two buffers, so that the current one may be cross-faded to/from a single IR), and the ramp step per hop; 3 x nCHout x (numFilterBlocks*nBins) */
+    int interpIdx[SAF_TVCONV_MAX_INTERP];   /**< Indices of the IRs, which were most recently interpolated */
+    float interpW[SAF_TVCONV_MAX_INTERP];   /**< Their weights */
+    int nInterp;                /**< Number of IRs, which were most recently interpolated (0: none) */
+    int nRampHops;              /**< Number of hops, over which the interpolated spectra are still to be ramped by Hinterp[2] */
+
+    /* Spectral cache */
+    int cacheSize;              /**< Number of cache slots (nIRs: all IRs are transformed upon creation) */
+    float** H;                  /**< Time-domain IRs (not owned; NULL if cacheSize==nIRs); nIRs x FLAT(nCHout x length_h) */
+    int* slotIR;                /**< IR held by each cache slot (-1: empty, or being prefetched); cacheSize x 1 */
+    unsigned long* slotLastUse; /**< When each cache slot was last used; cacheSize x 1 */
+    int* irSlot;                /**< Cache slot holding each IR (-1: not cached); nIRs x 1 */
+    unsigned long useCount;     /**< Hop counter, for the least-recently-used eviction */
+    int prefetchIdx[SAF_TVCONV_MAX_PREFETCH]; /**< IRs hinted via saf_TVConv_prefetch() */
+    int nPrefetch;              /**< Number of hinted IRs not yet considered */
+    saf_threadPool_job prefetchJob; /**< Job, which transforms a prefetched IR on a worker thread */
+    int prefetchIR;             /**< IR being prefetched by "prefetchJob" */
+    int prefetchSlot;           /**< Cache slot it is being transformed into (-1: none) */
+    void* hPrefetchFFT;         /**< saf_rfft handle for "prefetchJob"; fftSize */
+    float* prefetch_pad;        /**< Scratch for "prefetchJob"; fftSize x 1 */
+
+    void* hThreadPool;          /**< saf_threadPool handle (not owned); NULL: single-threaded */
+    safConvTailJob* tailJobs;   /**< Tail jobs; nTailJobs x 1 (NULL if not used) */
+    int nTailJobs;              /**< Number of tail jobs */
+    int nTails;                 /**< Number of IRs, for which the tails have been precomputed (0, 1 or 2) */
+    int tailIdx[2];             /**< Indices of the IRs, for which the tails have been precomputed */
+    float_complex** tailH[2];   /**< Spectra, for which the tails have been precomputed */
+    float_complex* Ztail;       /**< Summed tail partitions for the next hop; FLAT: 2 x nCHout x nBins */
 }safTVConv_data;
+
+/** Transforms IR "irIdx" into the partitioned spectra "Hpart_f" (nCHout x (numFilterBlocks*nBins)) */
+static void saf_TVConv_transformIR
+(
+    safTVConv_data* h,
+    float* H,
+    void* hFFT,
+    float* h_pad,
+    float_complex** Hpart_f
+)
+{
+    int no, nb, len;
+
+    for(no=0; no<h->nCHout; no++){
+        for (nb=0; nb<h->numFilterBlocks; nb++){
+            memset(h_pad, 0, (h->fftSize)*sizeof(float)); /* zero pad each partition of the filter, to 2*hopsize */
+            len = SAF_MIN(h->hopSize, h->length_h - nb*(h->hopSize));
+            memcpy(h_pad, &H[no*(h->length_h)+nb*(h->hopSize)], len*sizeof(float));
+            saf_rfft_forward(hFFT, h_pad, &(Hpart_f[no][nb*(h->nBins)]));
+        }
+    }
+}
+
+/** Thread pool job, which transforms a prefetched IR */
+static void saf_TVConv_prefetchJob
+(
+    void* arg
+)
+{
+    safTVConv_data *h = (safTVConv_data*)arg;
+
+    saf_TVConv_transformIR(h, h->H[h->prefetchIR], h->hPrefetchFFT, h->prefetch_pad, h->Hpart_f[h->prefetchSlot]);
+}
+
+/** Assigns cache slot "slot" to IR "irIdx" */
+static void saf_TVConv_assignSlot
+(
+    safTVConv_data* h,
+    int slot,
+    int irIdx
+)
+{
+    h->slotIR[slot] = irIdx;
+    h->slotLastUse[slot] = h->useCount;
+    h->irSlot[irIdx] = slot;
+}
+
+/**
+ * Collects the prefetched IR (waiting for it if "wait" is 1)
+ *
+ * @returns 1: if nothing is (or is no longer) being prefetched, 0: otherwise
+ */
+static int saf_TVConv_collectPrefetch
+(
+    safTVConv_data* h,
+    int wait
+)
+{
+    if(h->prefetchSlot<0)
+        return 1;
+    if(wait)
+        saf_threadPool_wait(h->hThreadPool, &(h->prefetchJob));
+    else if(!saf_threadPool_isDone(&(h->prefetchJob)))
+        return 0;
+    saf_TVConv_assignSlot(h, h->prefetchSlot, h->prefetchIR);
+    h->prefetchSlot = -1;
+    return 1;
+}
+
+/**
+ * Frees up a cache slot; an empty one, or otherwise the least recently used
+ * one, which is not required for the current hop (i.e. which has not already
+ * been used during it, and does not hold the IR of the previous two hops)
+ */
+static int saf_TVConv_evict
+(
+    safTVConv_data* h,
+    int irIdx
+)
+{
+    int s, slot, ir;
+
+    slot = -1;
+    for(s=0; s<h->cacheSize; s++){
+        ir = h->slotIR[s];
+        if(s==h->prefetchSlot || (ir>=0 && (ir==irIdx || ir==h->posIdx_last || ir==h->posIdx_last2 ||
+                                            h->slotLastUse[s]==h->useCount)))
+            continue;
+        if(ir<0){
+            slot = s;
+            break;
+        }
+        if(slot<0 || h->slotLastUse[s] < h->slotLastUse[slot])
+            slot = s;
+    }
+    saf_assert(slot>=0, "Cache is too small");
+    if(h->slotIR[slot]>=0)
+        h->irSlot[h->slotIR[slot]] = -1;
+    h->slotIR[slot] = -1;
+    return slot;
+}
+
+/** Returns the partitioned spectra of IR "irIdx", transforming the IR first if it is not already cached */
+static float_complex** saf_TVConv_getIR
+(
+    safTVConv_data* h,
+    int irIdx
+)
+{
+    int slot;
+
+    if(h->irSlot[irIdx]<0)
+        saf_TVConv_collectPrefetch(h, 1); /* (it may already be on its way, and otherwise its cache slot may be needed) */
+    if(h->irSlot[irIdx]<0){
+        slot = saf_TVConv_evict(h, irIdx);
+        saf_TVConv_transformIR(h, h->H[irIdx], h->hFFT, h->h_pad, h->Hpart_f[slot]);
+        saf_TVConv_assignSlot(h, slot, irIdx);
+    }
+    slot = h->irSlot[irIdx];
+    h->slotLastUse[slot] = h->useCount;
+    return h->Hpart_f[slot];
+}
+
+/**
+ * Returns the partitioned spectra "specIdx" (an IR index, or nIRs+b for the
+ * interpolated spectra Hinterp[b], b=0,1), transforming the IR first if needed
+ */
+static float_complex** saf_TVConv_getSpectra
+(
+    safTVConv_data* h,
+    int specIdx
+)
+{
+    if(specIdx>=h->nIRs)
+        return h->Hinterp[specIdx - h->nIRs];
+    return saf_TVConv_getIR(h, specIdx);
+}
+
+/**
+ * Transforms the next hinted IR (if any) which is not already cached; on a
+ * worker thread if a thread pool is assigned. At most one IR is transformed per
+ * hop, so that the load is spread out over time.
+ */
+static void saf_TVConv_prefetchNext
+(
+    safTVConv_data* h
+)
+{
+    int irIdx;
+
+    if(!saf_TVConv_collectPrefetch(h, 0))
+        return;
+    while(h->nPrefetch>0){
+        irIdx = h->prefetchIdx[--(h->nPrefetch)];
+        if(h->irSlot[irIdx]>=0)
+            continue;
+        h->prefetchIR = irIdx;
+        h->prefetchSlot = saf_TVConv_evict(h, irIdx);
+        if(h->hThreadPool!=NULL)
+            saf_threadPool_submit(h->hThreadPool, &(h->prefetchJob));
+        else{
+            saf_TVConv_prefetchJob((void*)h);
+            saf_TVConv_collectPrefetch(h, 0);
+        }
+        break;
+    }
+}
+
+/** Thread pool job, which computes the tail partitions of the time-varying convolver */
+static void saf_TVConv_tailJob
+(
+    void* arg
+)
+{
+    safConvTailJob* job = (safConvTailJob*)arg;
+    safTVConv_data *h = (safTVConv_data*)(job->hConv);
+    int t, no;
+
+    /* Partitions 1...N-1 of the filters are applied to partition slots 0...N-2 of the FDL, which become slots 1...N-1 after the next shuffle */
+    for(t=0; t<h->nTails; t++){
+        for(no=job->start; no<job->end; no++){
+            utility_cvvmulsum(&(h->tailH[t][no][h->nBins]), h->nBins, h->X_n, h->nBins, h->numFilterBlocks-1, h->nBins,
+                              &(h->Ztail[(t*(h->nCHout)+no)*(h->nBins)]));
+        }
+    }
+}
+
+/**
+ * Selects which tails to precompute for the next hop: those of the current
+ * IR (which is also the most likely next IR), and of the previous IR (which
+ * is still required for the cross-fade if the IR has just changed)
+ */
+static void saf_TVConv_selectTails
+(
+    safTVConv_data* h
+)
+{
+    h->nTails = 1;
+    h->tailIdx[0] = h->posIdx_last;
+    if(h->posIdx_last2 != h->posIdx_last)
+        h->tailIdx[h->nTails++] = h->posIdx_last2;
+    h->tailH[0] = saf_TVConv_getSpectra(h, h->tailIdx[0]);
+    h->tailH[1] = saf_TVConv_getSpectra(h, h->tailIdx[h->nTails-1]);
+}
  
 void  saf_TVConv_create
 (
@@ -474,11 +2175,25 @@ void  saf_TVConv_create
     int nCHout,
     int initIdx
 )
+{
+    saf_TVConv_createCached(phTVC, hopSize, H, length_h, nIRs, nCHout, initIdx, nIRs);
+}
+
+void  saf_TVConv_createCached
+(
+    void ** const phTVC,
+    int hopSize,
+    float** H,         /* nIRs x FLAT(nCHout x length_h) */
+    int length_h,
+    int nIRs,
+    int nCHout,
+    int initIdx,
+    int cacheSize
+)
 {
     *phTVC = malloc1d(sizeof(safTVConv_data));
     safTVConv_data *h = (safTVConv_data*)(*phTVC);
-    int np, no, nb, n;
-    float* h_pad, *h_pad_2hops;
+    int np, no, n;
     
     h->hopSize = hopSize;
     h->length_h = length_h;
@@ -491,6 +2206,11 @@ void  saf_TVConv_create
         h->posIdx_last = 0;
         h->posIdx_last2 = 0;
     }
+    h->hThreadPool = NULL;
+    h->tailJobs = NULL;
+    h->nTailJobs = 0;
+    h->nTails = 0;
+    h->Ztail = NULL;
     
     /* intialise partitioned convolution mode */
     h->length_h = length_h;
@@ -499,14 +2219,11 @@ void  saf_TVConv_create
     h->numFilterBlocks = (int)ceilf((float)length_h/(float)hopSize); /* number of partitions */
     saf_assert(h->numFilterBlocks>=1, "Number of filter blocks/partitions must be at least 1");
     
-    /* Allocate memory for buffers and perform fft on partitioned H */
-    h_pad = calloc1d(h->numFilterBlocks * hopSize, sizeof(float));
-    h_pad_2hops = calloc1d(2 * hopSize, sizeof(float));
-    h->Hpart_f = (float_complex***) malloc2d(nIRs, nCHout, sizeof(float_complex*));
+    /* Allocate memory for buffers */
     h->X_n = calloc1d(h->numFilterBlocks * (h->nBins), sizeof(float_complex));
-    h->HX_n = malloc1d(h->numFilterBlocks * (h->nBins) * sizeof(float_complex));
+    h->Z_n = malloc1d((h->nBins) * sizeof(float_complex));
     h->x_pad = calloc1d(2 * hopSize, sizeof(float));
-    h->hx_n = malloc1d(h->numFilterBlocks*(h->fftSize)*sizeof(float));
+    h->h_pad = malloc1d(2 * hopSize * sizeof(float));
     h->y_n_overlap = calloc1d(nCHout*hopSize, sizeof(float));
     h->y_n_overlap_last = calloc1d(nCHout*hopSize, sizeof(float));
     h->z_n = malloc1d((h->fftSize) * sizeof(float));
@@ -523,19 +2240,44 @@ void  saf_TVConv_create
         h->fadeOut[n] = (float) (hopSize-1-n) / (float) (hopSize-1);
     }
     saf_rfft_create(&(h->hFFT), h->fftSize);
-    for(np=0; np<nIRs; np++){
-        for(no=0; no<nCHout; no++){
+    h->Hinterp = (float_complex***)malloc3d(3, nCHout, h->numFilterBlocks*(h->nBins), sizeof(float_complex));
+    h->nInterp = 0;
+    h->nRampHops = 0;
+
+    /* Spectral cache (the IRs for the current and two previous hops, and one being prefetched, must fit) */
+    h->cacheSize = cacheSize>=nIRs ? nIRs : SAF_MAX(cacheSize, 4);
+    h->Hpart_f = (float_complex***) malloc2d(h->cacheSize, nCHout, sizeof(float_complex*));
+    h->slotIR = malloc1d(h->cacheSize*sizeof(int));
+    h->slotLastUse = calloc1d(h->cacheSize, sizeof(unsigned long));
+    h->irSlot = malloc1d(nIRs*sizeof(int));
+    h->useCount = 0;
+    h->nPrefetch = 0;
+    h->prefetchSlot = -1;
+    saf_threadPool_initJob(&(h->prefetchJob), saf_TVConv_prefetchJob, (void*)h);
+    for(np=0; np<h->cacheSize; np++){
+        h->slotIR[np] = -1;
+        for(no=0; no<nCHout; no++)
             h->Hpart_f[np][no] = malloc1d(h->numFilterBlocks*(h->nBins)*sizeof(float_complex));
-            memcpy(h_pad, &H[np][no*length_h], length_h*sizeof(float)); /* zero pad filter, to be multiple of hopsize */
-            for (nb=0; nb<h->numFilterBlocks; nb++){
-                memcpy(h_pad_2hops, &(h_pad[nb*hopSize]), hopSize*sizeof(float));
-                saf_rfft_forward(h->hFFT, h_pad_2hops, &(h->Hpart_f[np][no][nb*(h->nBins)]));
-            }
+    }
+    for(np=0; np<nIRs; np++)
+        h->irSlot[np] = -1;
+    if(h->cacheSize==nIRs){
+        /* Perform fft on all partitioned IRs (which are then no longer needed) */
+        h->H = NULL;
+        h->hPrefetchFFT = NULL;
+        h->prefetch_pad = NULL;
+        for(np=0; np<nIRs; np++){
+            saf_TVConv_transformIR(h, H[np], h->hFFT, h->h_pad, h->Hpart_f[np]);
+            saf_TVConv_assignSlot(h, np, np);
         }
     }
-    
-    free(h_pad);
-    free(h_pad_2hops);
+    else{
+        /* The IRs are transformed as and when they are required */
+        h->H = H;
+        saf_rfft_create(&(h->hPrefetchFFT), h->fftSize);
+        h->prefetch_pad = malloc1d(2 * hopSize * sizeof(float));
+        saf_TVConv_getIR(h, h->posIdx_last);
+    }
 }
 
 void saf_TVConv_destroy
@@ -547,14 +2289,17 @@ void saf_TVConv_destroy
     int np, no;
     
     if(h!=NULL){
+        saf_convTail_destroyJobs(&(h->tailJobs), h->nTailJobs, h->hThreadPool);
+        saf_TVConv_collectPrefetch(h, 1);
         saf_rfft_destroy(&(h->hFFT));
         free(h->X_n);
         free(h->x_pad);
+        free(h->h_pad);
+        free(h->Ztail);
         free(h->z_n);
         free(h->z_n_last);
         free(h->z_n_last2);
-        free(h->hx_n);
-        free(h->HX_n);
+        free(h->Z_n);
         free(h->y_n_overlap);
         free(h->y_n_overlap_last);
         free(h->out1);
@@ -563,27 +2308,119 @@ void saf_TVConv_destroy
         free(h->fadeOut);
         free(h->outFadeIn);
         free(h->outFadeOut);
-        for(np=0; np<h->nIRs; np++){
+        for(np=0; np<h->cacheSize; np++){
             for(no=0; no<h->nCHout; no++)
                 free(h->Hpart_f[np][no]);
         }
         free(h->Hpart_f);
-        }
+        free(h->Hinterp);
+        free(h->slotIR);
+        free(h->slotLastUse);
+        free(h->irSlot);
+        if(h->hPrefetchFFT!=NULL)
+            saf_rfft_destroy(&(h->hPrefetchFFT));
+        free(h->prefetch_pad);
         free(h);
         h = NULL;
         *phTVC = NULL;
+    }
 }
 
-void saf_TVConv_apply
+void saf_TVConv_setThreadPool
+(
+    void * const hTVC,
+    void* hThreadPool
+)
+{
+    safTVConv_data *h = (safTVConv_data*)(hTVC);
+
+    saf_convTail_destroyJobs(&(h->tailJobs), h->nTailJobs, h->hThreadPool);
+    saf_TVConv_collectPrefetch(h, 1);
+    h->nTails = 0;
+    if(hThreadPool!=NULL && h->numFilterBlocks>1){
+        saf_convTail_createJobs(&(h->tailJobs), &(h->nTailJobs), hThreadPool, hTVC, saf_TVConv_tailJob,
+                                h->nCHout);
+        if(h->Ztail==NULL)
+            h->Ztail = malloc1d(2*(h->nCHout)*(h->nBins)*sizeof(float_complex));
+
+        /* The tails for the next hop are computed here, so that processing may continue seamlessly */
+        saf_TVConv_selectTails(h);
+        saf_convTail_run(h->tailJobs, h->nTailJobs);
+    }
+    h->hThreadPool = hThreadPool;
+}
+
+void saf_TVConv_prefetch
 (
     void * const hTVC,
+    int* irIdx,
+    int nIdx
+)
+{
+    safTVConv_data *h = (safTVConv_data*)(hTVC);
+    int i;
+
+    /* Replaces any previous hints. Stored in reverse, so that the first IR is considered first */
+    h->nPrefetch = SAF_MAX(SAF_MIN(nIdx, SAF_MIN(SAF_TVCONV_MAX_PREFETCH, h->cacheSize-3)), 0);
+    for(i=0; i<h->nPrefetch; i++){
+        saf_assert(irIdx[i]>=0 && irIdx[i]<h->nIRs, "Invalid IR index");
+        h->prefetchIdx[h->nPrefetch-1-i] = irIdx[i];
+    }
+}
+
+/**
+ * Convolves the FDL with the partitioned spectra "specIdx" (an IR index, or
+ * nIRs+b for the interpolated spectra Hinterp[b]; held in "Hir"), for output
+ * channel "no", and returns the time-domain result (fftSize x 1). The sum over the
+ * partitions is taken in the frequency-domain, so that only one inverse FFT is
+ * required. If the tail has been precomputed for these spectra, then only the
+ * first partition is applied here.
+ */
+static void saf_TVConv_convolve
+(
+    safTVConv_data* h,
+    int specIdx,
+    float_complex** Hir,
+    int no,
+    float* z_n
+)
+{
+    int t;
+
+    for(t=0; t<h->nTails; t++)
+        if(h->tailIdx[t]==specIdx)
+            break;
+    if(h->tailJobs!=NULL && t<h->nTails){
+        cblas_ccopy(h->nBins, &(h->Ztail[(t*(h->nCHout)+no)*(h->nBins)]), 1, h->Z_n, 1);
+        utility_cvvmac(Hir[no], h->X_n, h->nBins, NO_CONJ, h->Z_n);
+    }
+    else
+        utility_cvvmulsum(Hir[no], h->nBins, h->X_n, h->nBins, h->numFilterBlocks, h->nBins, h->Z_n); /* This is the bulk of the CPU work */
+    saf_rfft_backward(h->hFFT, h->Z_n, z_n);
+}
+
+/**
+ * Performs one hop of the time-varying convolution with the partitioned spectra
+ * "specIdx" (see saf_TVConv_convolve()), cross-fading from the spectra used for
+ * the previous hops if they were different. Interpolated spectra which are
+ * being ramped are advanced for the next hop here, before their tails are
+ * computed.
+ */
+static void saf_TVConv_process
+(
+    safTVConv_data* h,
     float* inputSig,
     float* outputSig,
-    int    irIdx
+    int    specIdx
 )
 {
-    safTVConv_data *h = (safTVConv_data*)(hTVC);
-    int no, nb;
+    int no;
+    float_complex** Hir, **Hir_last, **Hir_last2;
+
+    /* Fetch the spectra required for this hop (transforming the IRs now, if they are not cached) */
+    Hir = saf_TVConv_getSpectra(h, specIdx);
+    Hir_last = saf_TVConv_getSpectra(h, h->posIdx_last);
+    Hir_last2 = saf_TVConv_getSpectra(h, h->posIdx_last2);
     
     /* zero-pad input signals and perform fft. Store in partition slot 1. */
     memmove(&(h->X_n[1*(h->nBins)]), h->X_n, (h->numFilterBlocks-1)*(h->nBins)*sizeof(float_complex)); /* shuffle */
@@ -593,38 +2430,17 @@ void saf_TVConv_apply
     
     /* apply convolution and inverse fft */
     for(no=0; no<h->nCHout; no++){
-        utility_cvvmul(h->Hpart_f[irIdx][no], h->X_n, h->numFilterBlocks * (h->nBins), h->HX_n); /* This is the bulk of the CPU work */
-        for(nb=0; nb<h->numFilterBlocks; nb++)
-            saf_rfft_backward(h->hFFT, &(h->HX_n[nb*(h->nBins)]), &(h->hx_n[nb*(h->fftSize)]));
-        
-        /* output frame for this channel is the sum over all partitions */
-        memset(h->z_n, 0, (h->fftSize) * sizeof(float));
-        for(nb=0; nb<h->numFilterBlocks; nb++)
-            cblas_saxpy(h->fftSize, 1.0f, &(h->hx_n[nb*(h->fftSize)]), 1, h->z_n, 1);
+        saf_TVConv_convolve(h, specIdx, Hir, no, h->z_n);
         
         /* If position changed perform convolution at previous steps too */
-        if(irIdx != h->posIdx_last){
-            utility_cvvmul(h->Hpart_f[h->posIdx_last][no], h->X_n, h->numFilterBlocks * (h->nBins), h->HX_n);
-            for(nb=0; nb<h->numFilterBlocks; nb++)
-                saf_rfft_backward(h->hFFT, &(h->HX_n[nb*(h->nBins)]), &(h->hx_n[nb*(h->fftSize)]));
-            
-            /* output frame for this channel is the sum over all partitions */
-            memset(h->z_n_last, 0, (h->fftSize) * sizeof(float));
-            for(nb=0; nb<h->numFilterBlocks; nb++)
-                cblas_saxpy(h->fftSize, 1.0f, &(h->hx_n[nb*(h->fftSize)]), 1, h->z_n_last, 1);
+        if(specIdx != h->posIdx_last){
+            saf_TVConv_convolve(h, h->posIdx_last, Hir_last, no, h->z_n_last);
         }
         else {
             utility_svvcopy(h->z_n, h->fftSize, h->z_n_last);
         }
         if(h->posIdx_last != h->posIdx_last2){
-            utility_cvvmul(h->Hpart_f[h->posIdx_last2][no], h->X_n, h->numFilterBlocks * (h->nBins), h->HX_n);
-            for(nb=0; nb<h->numFilterBlocks; nb++)
-                saf_rfft_backward(h->hFFT, &(h->HX_n[nb*(h->nBins)]), &(h->hx_n[nb*(h->fftSize)]));
-            
-            /* output frame for this channel is the sum over all partitions */
-            memset(h->z_n_last2, 0, (h->fftSize) * sizeof(float));
-            for(nb=0; nb<h->numFilterBlocks; nb++)
-                cblas_saxpy(h->fftSize, 1.0f, &(h->hx_n[nb*(h->fftSize)]), 1, h->z_n_last2, 1);
+            saf_TVConv_convolve(h, h->posIdx_last2, Hir_last2, no, h->z_n_last2);
         }
         else {
             utility_svvcopy(h->z_n_last, h->fftSize, h->z_n_last2);
@@ -645,5 +2461,116 @@ void saf_TVConv_apply
     }
     
     h->posIdx_last2 = h->posIdx_last;
-    h->posIdx_last = irIdx;
+    h->posIdx_last = specIdx;
+
+    /* Take the next step towards the target interpolated spectra (in place, as they are only used again for the next
+     * hop, and with the same spectra for the partitions already in the FDL, so no cross-fade is required) */
+    if(h->nRampHops>0 && specIdx>=h->nIRs){
+        for(no=0; no<h->nCHout; no++) /* (real-valued steps, so the spectra are treated as interleaved floats) */
+            cblas_saxpy(2*(h->numFilterBlocks)*(h->nBins), 1.0f, (float*)h->Hinterp[2][no], 1, (float*)h->Hinterp[specIdx - h->nIRs][no], 1);
+        h->nRampHops--;
+    }
+
+    /* Hand the tails for the next hop over to the worker threads */
+    if(h->tailJobs!=NULL){
+        saf_TVConv_selectTails(h);
+        saf_convTail_submit(h->tailJobs, h->nTailJobs, h->hThreadPool);
+    }
+
+    /* Get a head start on the IRs which are expected next */
+    if(h->cacheSize<h->nIRs)
+        saf_TVConv_prefetchNext(h);
+}
+
+void saf_TVConv_apply
+(
+    void * const hTVC,
+    float* inputSig,
+    float* outputSig,
+    int    irIdx
+)
+{
+    safTVConv_data *h = (safTVConv_data*)(hTVC);
+
+    /* The tails for this hop must be ready before the FDL is shuffled */
+    if(h->tailJobs!=NULL)
+        saf_convTail_wait(h->tailJobs, h->nTailJobs, h->hThreadPool);
+    h->useCount++;
+
+    /* Any interpolated spectra are left as they are, since they may still be required for the cross-fade */
+    h->nRampHops = 0;
+    saf_TVConv_process(h, inputSig, outputSig, irIdx);
+}
+
+void saf_TVConv_applyInterp
+(
+    void * const hTVC,
+    float* inputSig,
+    float* outputSig,
+    int* irIdx,
+    float* weights,
+    int nIdx
+)
+{
+    safTVConv_data *h = (safTVConv_data*)(hTVC);
+    int k, t, no, b, changed, lastIdx;
+    float_complex** Hir, **Hcur, **Hstep;
+
+    saf_assert(nIdx>=1 && nIdx<=SAF_TVCONV_MAX_INTERP, "Unsupported number of IRs to interpolate");
+
+    /* The tails for this hop must be ready before the FDL is shuffled */
+    if(h->tailJobs!=NULL)
+        saf_convTail_wait(h->tailJobs, h->nTailJobs, h->hThreadPool);
+
+    /* If the previous hop used a single IR (via saf_TVConv_apply(), or upon creation), then the interpolated spectra
+     * continue from a copy of it, in a buffer which is not still required for the cross-fade */
+    if(h->posIdx_last<h->nIRs){
+        lastIdx = h->posIdx_last;
+        b = h->posIdx_last2==h->nIRs ? 1 : 0;
+        h->useCount++;
+        Hir = saf_TVConv_getIR(h, lastIdx);
+        for(no=0; no<h->nCHout; no++)
+            cblas_ccopy((h->numFilterBlocks)*(h->nBins), Hir[no], 1, h->Hinterp[b][no], 1);
+
+        /* These are the same spectra, so the precomputed tails still apply, and no cross-fade is started */
+        for(t=0; t<h->nTails; t++)
+            if(h->tailIdx[t]==lastIdx)
+                h->tailIdx[t] = h->nIRs+b;
+        if(h->posIdx_last2==lastIdx)
+            h->posIdx_last2 = h->nIRs+b;
+        h->posIdx_last = h->nIRs+b;
+        h->nInterp = 0;
+        h->nRampHops = 0;
+    }
+    Hcur = h->Hinterp[h->posIdx_last - h->nIRs];
+    Hstep = h->Hinterp[2];
+
+    /* If the IRs or weights have changed, then the interpolated spectra are ramped towards the new ones over the next
+     * SAF_TVCONV_INTERP_HOPS hops, such that only one convolution is required per hop */
+    changed = nIdx!=h->nInterp;
+    for(k=0; k<nIdx && !changed; k++)
+        changed = irIdx[k]!=h->interpIdx[k] || weights[k]!=h->interpW[k];
+    if(changed){
+        for(no=0; no<h->nCHout; no++)
+            memset(Hstep[no], 0, (h->numFilterBlocks)*(h->nBins)*sizeof(float_complex));
+        for(k=0; k<nIdx; k++){
+            /* Each IR is only required until it has been accumulated, so it is fetched in a use count of its own
+             * (such that the IRs already interpolated may be evicted, if cached) */
+            h->useCount++;
+            Hir = saf_TVConv_getIR(h, irIdx[k]);
+            for(no=0; no<h->nCHout; no++) /* (real-valued weights, so the spectra are treated as interleaved floats) */
+                cblas_saxpy(2*(h->numFilterBlocks)*(h->nBins), weights[k], (float*)Hir[no], 1, (float*)Hstep[no], 1);
+            h->interpIdx[k] = irIdx[k];
+            h->interpW[k] = weights[k];
+        }
+        h->nInterp = nIdx;
+        for(no=0; no<h->nCHout; no++){
+            cblas_saxpy(2*(h->numFilterBlocks)*(h->nBins), -1.0f, (float*)Hcur[no], 1, (float*)Hstep[no], 1);
+            cblas_sscal(2*(h->numFilterBlocks)*(h->nBins), 1.0f/(float)SAF_TVCONV_INTERP_HOPS, (float*)Hstep[no], 1);
+        }
+        h->nRampHops = SAF_TVCONV_INTERP_HOPS;
+    }
+
+    h->useCount++;
+    saf_TVConv_process(h, inputSig, outputSig, h->posIdx_last);
 }
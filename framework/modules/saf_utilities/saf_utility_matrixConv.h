@@ -32,6 +32,74 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/* ========================================================================== */
+/*                            Shared Filter Spectra                           */
+/* ========================================================================== */
+
+/**
+ * Creates filter spectra, which may be shared by many instances of matrixConv
+ *
+ * The filters are transformed (and partitioned) only once, here. Any number of
+ * instances may then be created from these spectra with
+ * saf_matrixConv_createShared(), such that memory usage and creation time scale
+ * with the number of distinct filters, rather than the number of instances.
+ * The spectra are never modified once created.
+ *
+ * @test test__saf_convSpectra()
+ *
+ * @param[in] phCS        (&) address of saf_convSpectra handle
+ * @param[in] hopSize     Hop size in samples.
+ * @param[in] H           Time-domain filters; FLAT: nCHout x nCHin x length_h
+ * @param[in] length_h    Length of the filters
+ * @param[in] nCHin       Number of input channels
+ * @param[in] nCHout      Number of output channels
+ * @param[in] usePartFLAG See saf_matrixConv_create()
+ */
+void saf_convSpectra_createMatrix(/* Input Arguments */
+                                  void ** const phCS,
+                                  int hopSize,
+                                  float* H,
+                                  int length_h,
+                                  int nCHin,
+                                  int nCHout,
+                                  int usePartFLAG);
+
+/**
+ * Creates filter spectra, which may be shared by many instances of multiConv
+ *
+ * @note See saf_convSpectra_createMatrix() for more details, and
+ *       saf_multiConv_createShared().
+ *
+ * @test test__saf_convSpectra()
+ *
+ * @param[in] phCS        (&) address of saf_convSpectra handle
+ * @param[in] hopSize     Hop size in samples.
+ * @param[in] H           Time-domain filters; FLAT: nCH x length_h
+ * @param[in] length_h    Length of the filters
+ * @param[in] nCH         Number of filters & input/output channels
+ * @param[in] usePartFLAG See saf_multiConv_create()
+ */
+void saf_convSpectra_createMulti(/* Input Arguments */
+                                 void ** const phCS,
+                                 int hopSize,
+                                 float* H,
+                                 int length_h,
+                                 int nCH,
+                                 int usePartFLAG);
+
+/**
+ * Releases the caller's reference to the shared filter spectra
+ *
+ * Instances created from the spectra hold their own references; therefore,
+ * this may be called as soon as the last instance has been created. The
+ * spectra are destroyed once the last instance using them is also destroyed.
+ *
+ * @param[in] phCS (&) address of saf_convSpectra handle
+ */
+void saf_convSpectra_destroy(/* Input Arguments */
+                             void ** const phCS);
+
+
 /* ========================================================================== */
 /*                              Matrix Convolver                              */
 /* ========================================================================== */
@@ -41,7 +109,22 @@ extern "C" {
  *
  * This is a matrix convolver intended for block-by-block processing.
  *
+ * @note The non-uniform partitioned mode (usePartFLAG=2) employs partitions of
+ *       hopSize for the head of the filters, and progressively larger
+ *       partitions (doubling in size) for the tail. This greatly reduces the
+ *       computational cost for long filters (e.g. reverb tails), while
+ *       incurring no additional latency compared to the uniformly partitioned
+ *       mode. Note, however, that the larger partitions are only computed once
+ *       every few hops, so the CPU load is less evenly distributed over time.
+ * @note Sub-filters (and partitions thereof) which are entirely zero, are
+ *       detected here and subsequently skipped by saf_matrixConv_apply(). The
+ *       computational cost therefore scales with the non-zero content of the
+ *       filter matrix (e.g. for routing matrices or mostly diagonal filters).
+ *       Near-silent ones may also be skipped, see
+ *       saf_matrixConv_setSparsityThreshold().
+ *
  * @test test__saf_matrixConv()
+ * @test test__saf_matrixConv_sparse()
  *
  * @param[in] phMC        (&) address of matrixConv handle
  * @param[in] hopSize     Hop size in samples.
@@ -50,6 +133,7 @@ extern "C" {
  * @param[in] nCHin       Number of input channels
  * @param[in] nCHout      Number of output channels
  * @param[in] usePartFLAG '0': normal fft-based convolution, '1': fft-based
+ *                        partitioned convolution, '2': fft-based non-uniform
  *                        partitioned convolution
  */
 void saf_matrixConv_create(/* Input Arguments */
@@ -61,6 +145,26 @@ void saf_matrixConv_create(/* Input Arguments */
                            int nCHout,
                            int usePartFLAG);
 
+/**
+ * Creates an instance of matrixConv, which employs shared filter spectra
+ *
+ * The hop size, filter length, number of channels and partitioning are those
+ * passed to saf_convSpectra_createMatrix(). Only the buffers of the instance
+ * are allocated here, so this is far cheaper than saf_matrixConv_create().
+ *
+ * @note saf_matrixConv_updateFilters() may still be used, in which case the
+ *       instance then transforms and owns the new filters (the shared spectra
+ *       are left untouched).
+ *
+ * @test test__saf_convSpectra()
+ *
+ * @param[in] phMC (&) address of matrixConv handle
+ * @param[in] hCS  saf_convSpectra handle (created for matrixConv)
+ */
+void saf_matrixConv_createShared(/* Input Arguments */
+                                 void ** const phMC,
+                                 void * const hCS);
+
 /**
  * Destroys an instance of matrixConv
  *
@@ -77,11 +181,87 @@ void saf_matrixConv_destroy(/* Input Arguments */
  */
 void saf_matrixConv_reset(void * const hMC);
 
+/**
+ * Sets the threshold, at or below which sub-filters (for usePartFLAG=0) or
+ * sub-filter partitions (for usePartFLAG=1,2) are skipped
+ *
+ * The threshold is relative to the peak absolute value over all filters, and
+ * is compared with the peak absolute value of each sub-filter/partition. For
+ * example, 0.00001f skips the partitions which are at least 100dB below the
+ * peak of the filters.
+ *
+ * @param[in] hMC       matrixConv handle
+ * @param[in] threshold Relative threshold (linear); 0: only the sub-filters and
+ *                      partitions which are entirely zero are skipped (default)
+ */
+void saf_matrixConv_setSparsityThreshold(void * const hMC,
+                                         float threshold);
+
+/**
+ * Assigns a thread pool, which is then used to compute the filter tails in the
+ * background
+ *
+ * For the partitioned mode (usePartFLAG=1), only the first partition is
+ * computed within saf_matrixConv_apply(), while the remaining partitions are
+ * computed by the worker threads, in advance, for the next hop. For the
+ * non-uniform partitioned mode (usePartFLAG=2), all but the smallest partitions
+ * are computed by the worker threads, and their results are collected one or
+ * more hops later (i.e. by the time they are due to be output). In both cases,
+ * the output is identical to single-threaded processing, no additional latency
+ * is incurred, and the load within saf_matrixConv_apply() becomes flatter.
+ *
+ * @note The thread pool is not owned by matrixConv, and it must outlive it (or
+ *       be removed by passing NULL). Only one thread should call
+ *       saf_matrixConv_apply() at a time. The normal fft-based convolution mode
+ *       (usePartFLAG=0) ignores the thread pool.
+ *
+ * @param[in] hMC         matrixConv handle
+ * @param[in] hThreadPool saf_threadPool handle (see saf_threadPool_create()),
+ *                        or NULL to revert to single-threaded processing
+ */
+void saf_matrixConv_setThreadPool(void * const hMC,
+                                  void* hThreadPool);
+
+/**
+ * Replaces the filters, without re-creating the matrixConv instance, and
+ * without interrupting the audio
+ *
+ * The new filters are transformed by the calling thread (which should not be
+ * the audio thread), and are then swapped in by the next call to
+ * saf_matrixConv_apply(); no memory is allocated, and the input history is
+ * retained. For the partitioned mode (usePartFLAG=1), the output of the old
+ * filters is cross-faded to that of the new filters over one hop. For the other
+ * modes, the new filters are applied to all subsequent input, while the old
+ * filters continue to be applied to the preceding input (i.e. their tails ring
+ * out); therefore, the transition is also free of discontinuities.
+ *
+ * @note This function may be called from a different thread than the one
+ *       calling saf_matrixConv_apply(), but it blocks while the previously
+ *       updated filters are still being swapped in. For the non-uniform
+ *       partitioned mode (usePartFLAG=2), the swap is deferred until the
+ *       start of the next block of the largest partitions, and until the
+ *       previously updated filters have been applied to the whole input
+ *       history. If called again before the filters have been swapped in, then
+ *       the pending filters are replaced.
+ * @note The number of input and output channels and the hopsize cannot change.
+ *
+ * @test test__saf_matrixConv_updateFilters()
+ *
+ * @param[in] hMC      matrixConv handle
+ * @param[in] H        New time-domain filters; FLAT: nCHout x nCHin x length_h
+ * @param[in] length_h Length of the new filters (no longer than the length
+ *                     passed to saf_matrixConv_create())
+ */
+void saf_matrixConv_updateFilters(void * const hMC,
+                                  float* H,
+                                  int length_h);
+
 /**
  * Performs the matrix convolution.
  *
- * @note If the number of input or output channels, the filters, or the hopsize
- *       need to change: simply destroy and re-create the matrixConv instance.
+ * @note If the number of input or output channels, or the hopsize need to
+ *       change: simply destroy and re-create the matrixConv instance. For new
+ *       filters, see saf_matrixConv_updateFilters().
  *
  * @param[in]  hMC        matrixConv handle
  * @param[in]  inputSigs  Input signals;  FLAT: nCHin  x hopSize
@@ -105,6 +285,8 @@ void saf_matrixConv_apply(/* Input Arguments */
  *
  * @note nCH can just be 1, in which case this is simply a single-channel
  *       convolver.
+ * @note See saf_matrixConv_create() for a description of the non-uniform
+ *       partitioned mode (usePartFLAG=2).
  *
  * @param[in] phMC        (&) address of multiConv handle
  * @param[in] hopSize     Hop size in samples.
@@ -112,6 +294,7 @@ void saf_matrixConv_apply(/* Input Arguments */
  * @param[in] length_h    Length of the filters
  * @param[in] nCH         Number of filters & input/output channels
  * @param[in] usePartFLAG '0': normal fft-based convolution, '1': fft-based
+ *                        partitioned convolution, '2': fft-based non-uniform
  *                        partitioned convolution
  */
 void saf_multiConv_create(/* Input Arguments */
@@ -122,6 +305,20 @@ void saf_multiConv_create(/* Input Arguments */
                           int nCH,
                           int usePartFLAG);
 
+/**
+ * Creates an instance of multiConv, which employs shared filter spectra
+ *
+ * @note See saf_matrixConv_createShared() for more details.
+ *
+ * @test test__saf_convSpectra()
+ *
+ * @param[in] phMC (&) address of multiConv handle
+ * @param[in] hCS  saf_convSpectra handle (created for multiConv)
+ */
+void saf_multiConv_createShared(/* Input Arguments */
+                                void ** const phMC,
+                                void * const hCS);
+
 /**
  * Destroys an instance of multiConv
  *
@@ -137,6 +334,19 @@ void saf_multiConv_destroy(/* Input Arguments */
  */
 void saf_multiConv_reset(void * const hMC);
 
+/**
+ * Assigns a thread pool, which is then used to compute the filter tails in the
+ * background
+ *
+ * @note See saf_matrixConv_setThreadPool() for more details.
+ *
+ * @param[in] hMC         multiConv handle
+ * @param[in] hThreadPool saf_threadPool handle, or NULL to revert to
+ *                        single-threaded processing
+ */
+void saf_multiConv_setThreadPool(void * const hMC,
+                                 void* hThreadPool);
+
 /**
  * Performs the multi-channel convolution
  *
@@ -178,6 +388,44 @@ void saf_TVConv_create(/* Input Arguments */
                            int nCHout,
                            int initIdx);
 
+/**
+ * Creates an instance of TVConv, which transforms the IRs on demand
+ *
+ * Unlike saf_TVConv_create(), which transforms and keeps the partitioned
+ * spectra of all IRs, only the spectra of up to "cacheSize" IRs are held at
+ * once here. An IR is transformed when it is first requested by
+ * saf_TVConv_apply() (or in advance, if hinted via saf_TVConv_prefetch()), and
+ * the least recently used IR is evicted to make room. This is intended for
+ * large sets of IRs (e.g. measured at many listener positions), for which only
+ * the positions actually visited need to be transformed.
+ *
+ * @warning The time-domain IRs are not copied, and "H" must therefore remain
+ *          valid until the TVConv instance is destroyed (unless
+ *          cacheSize>=nIRs).
+ *
+ * @test test__saf_TVConv_cache()
+ *
+ * @param[in] phTVC     (&) address of TVConv handle
+ * @param[in] hopSize   Hop size in samples.
+ * @param[in] H         Time-domain filters;  nIRs x (FLAT: nCHout x length_h)
+ * @param[in] length_h  Length of the filters
+ * @param[in] nIRs      Number or IRs
+ * @param[in] nCHout    Number of output channels
+ * @param[in] initIdx   Initial IR index to be used
+ * @param[in] cacheSize Maximum number of IRs, for which the spectra are held at
+ *                      once (at least 4); nIRs (or more) is equivalent to
+ *                      saf_TVConv_create()
+ */
+void saf_TVConv_createCached(/* Input Arguments */
+                             void ** const phTVC,
+                             int hopSize,
+                             float** H,
+                             int length_h,
+                             int nIRs,
+                             int nCHout,
+                             int initIdx,
+                             int cacheSize);
+
 /**
  * Destroys an instance of matrixConv
  *
@@ -186,6 +434,44 @@ void saf_TVConv_create(/* Input Arguments */
 void saf_TVConv_destroy(/* Input Arguments */
                             void ** const phTVC);
 
+/**
+ * Assigns a thread pool, which is then used to compute the filter tails in the
+ * background
+ *
+ * The tails for the current and previous IRs are computed in advance by the
+ * worker threads, for the next hop. If a different IR is requested, then its
+ * tail is instead computed within saf_TVConv_apply() (as usual).
+ *
+ * @note See saf_matrixConv_setThreadPool() for more details.
+ *
+ * @param[in] hTVC        TVConv handle
+ * @param[in] hThreadPool saf_threadPool handle, or NULL to revert to
+ *                        single-threaded processing
+ */
+void saf_TVConv_setThreadPool(void * const hTVC,
+                              void* hThreadPool);
+
+/**
+ * Hints which IRs are expected to be requested next (e.g. the predicted next
+ * listener positions), so that they may be transformed in advance
+ *
+ * One hinted IR (which is not already cached) is transformed per call to
+ * saf_TVConv_apply(); on a worker thread, if a thread pool is assigned (see
+ * saf_TVConv_setThreadPool()). The hints replace any previous hints, and are
+ * considered in the order given.
+ *
+ * @note Only applicable to instances created with saf_TVConv_createCached(),
+ *       and the number of hints is limited to cacheSize-3. This function
+ *       should be called from the same thread as saf_TVConv_apply().
+ *
+ * @param[in] hTVC  TVConv handle
+ * @param[in] irIdx Indices of the IRs, most likely first; nIdx x 1
+ * @param[in] nIdx  Number of indices
+ */
+void saf_TVConv_prefetch(void * const hTVC,
+                         int* irIdx,
+                         int nIdx);
+
 /**
  * Performs the matrix convolution.
  *
@@ -204,6 +490,42 @@ void saf_TVConv_apply(/* Input Arguments */
                           float* outputSigs,
                           int irIdx);
 
+/**
+ * Performs the time-varying convolution, with a weighted combination of IRs
+ * (e.g. those of the grid points surrounding the listener position)
+ *
+ * The partitioned spectra of the IRs are interpolated here, such that the
+ * convolution is performed with a single set of spectra per hop, regardless of
+ * the number of IRs. When the IRs or weights change, the interpolated spectra
+ * are ramped towards the new ones over the following few hops (starting from
+ * the next hop), rather than cross-fading the outputs of several convolutions.
+ * Therefore, only one convolution is performed per hop, and the IRs are only
+ * accumulated again when the IRs or weights change.
+ *
+ * @note The weights would typically sum to 1. This function may be used
+ *       interchangeably with saf_TVConv_apply(): the interpolated spectra
+ *       continue from the single IR used for the previous hop, whereas a switch
+ *       to saf_TVConv_apply() is cross-faded as any other IR change.
+ *
+ * @test test__saf_TVConv_interp()
+ *
+ * @param[in]  hTVC       TVConv handle
+ * @param[in]  inputSigs  Input signals;  FLAT: nCHin  x hopSize
+ * @param[out] outputSigs Output signals; FLAT: nCHout x hopSize
+ * @param[in]  irIdx      Indices of the IRs to interpolate; nIdx x 1
+ * @param[in]  weights    Weight for each IR; nIdx x 1
+ * @param[in]  nIdx       Number of IRs to interpolate (1..8)
+ */
+void saf_TVConv_applyInterp(/* Input Arguments */
+                            void * const hTVC,
+                            float* inputSigs,
+                            /* Output Arguments */
+                            float* outputSigs,
+                            /* Input Arguments */
+                            int* irIdx,
+                            float* weights,
+                            int nIdx);
+
 #ifdef __cplusplus
 }/* extern "C" */
 #endif /* __cplusplus */
@@ -106,8 +106,8 @@ typedef struct _smb_pitchShift_data
     float* window;
     float** gInFIFO, **gOutFIFO;
 #ifdef SMB_ENABLE_SAF_FFT
-    float_complex** gFFTworksp_td;
-    float_complex** gFFTworksp_fd;
+    float** gFFTworksp_td;          /* nCH x fftFrameSize */
+    float_complex** gFFTworksp_fd;  /* nCH x (fftFrameSize/2+1) */
 #else
     float** gFFTworksp;
 #endif
@@ -115,7 +115,7 @@ typedef struct _smb_pitchShift_data
     float** gOutputAccum;
     float** gAnaFreq, **gAnaMagn;
     float** gSynFreq, **gSynMagn;
-    int* gRover;
+    int gRover; /* (the same for all channels) */
     int stepSize, inFifoLatency;
 
 }smb_pitchShift_data;
@@ -140,20 +140,22 @@ void smb_pitchShift_create
     h->pitchShiftFactor = 1.0f;
 
     /* internals */
-    saf_fft_create(&(h->hFFT), fftFrameSize);
+#ifdef SMB_ENABLE_SAF_FFT
+    /* The channels are all transformed at once */
+    saf_rfft_create(&(h->hFFT), fftFrameSize);
+    saf_rfft_prepareBatch(h->hFFT, fftFrameSize, fftFrameSize/2+1, nCH, nCH);
+#endif
     h->stepSize = fftFrameSize/h->osamp;
     h->inFifoLatency = fftFrameSize - (h->stepSize);
-    h->gRover = (int*)malloc1d(nCH * sizeof(int));
-    for(i=0; i<nCH; i++)
-        h->gRover[i] = h->inFifoLatency;
+    h->gRover = h->inFifoLatency;
     h->window = (float*)malloc1d(fftFrameSize*sizeof(float));
     for (i = 0; i < fftFrameSize; i++)
         h->window[i] = -0.5f*cosf(2.0f*SAF_PI*(float)i/(float)fftFrameSize)+0.5f;
     h->gInFIFO = (float**)calloc2d(nCH,fftFrameSize,sizeof(float));
     h->gOutFIFO = (float**)calloc2d(nCH,fftFrameSize,sizeof(float));
 #ifdef SMB_ENABLE_SAF_FFT
-    h->gFFTworksp_td = (float_complex**)calloc2d(nCH,fftFrameSize,sizeof(float_complex));
-    h->gFFTworksp_fd = (float_complex**)calloc2d(nCH,fftFrameSize,sizeof(float_complex));
+    h->gFFTworksp_td = (float**)calloc2d(nCH,fftFrameSize,sizeof(float));
+    h->gFFTworksp_fd = (float_complex**)calloc2d(nCH,fftFrameSize/2+1,sizeof(float_complex));
 #else
     h->gFFTworksp = (float**)calloc2d(nCH,2*fftFrameSize,sizeof(float));
 #endif
@@ -173,9 +175,10 @@ void smb_pitchShift_destroy
 {
     smb_pitchShift_data *h = (smb_pitchShift_data*)(*hSmb);
     if(h!=NULL){
-        saf_fft_destroy(&(h->hFFT));
+#ifdef SMB_ENABLE_SAF_FFT
+        saf_rfft_destroy(&(h->hFFT));
+#endif
         free(h->window);
-        free(h->gRover);
         free(h->gInFIFO);
         free(h->gOutFIFO);
 #ifdef SMB_ENABLE_SAF_FFT
@@ -221,7 +224,7 @@ void smb_pitchShift_apply
     smb_pitchShift_data *h = (smb_pitchShift_data*)(hSmb);
     float magn, phase, tmp, real, imag;
     float freqPerBin, expct;
-    int ch, i, k, qpd, index, fftFrameSize2;
+    int ch, i, k, qpd, index, fftFrameSize2, nSamples;
 
     /* set up some handy variables */
     fftFrameSize2 = h->fftFrameSize/2;
@@ -239,22 +242,28 @@ void smb_pitchShift_apply
     }
 
     /* main processing loop */
-    for(ch=0; ch<h->nCH; ch++){
-        for (i = 0; i < frameSize; i++){
-            /* As long as we have not yet collected enough data just read in */
-            h->gInFIFO[ch][h->gRover[ch]] = indata[ch*frameSize+i];
-            outdata[ch*frameSize+i] = h->gOutFIFO[ch][h->gRover[ch]-(h->inFifoLatency)];
-            h->gRover[ch]++;
+    for (i = 0; i < frameSize; i += nSamples){
+        /* As long as we have not yet collected enough data just read in */
+        nSamples = SAF_MIN(frameSize-i, h->fftFrameSize - h->gRover);
+        for(ch=0; ch<h->nCH; ch++){
+            memcpy(&(h->gInFIFO[ch][h->gRover]), &indata[ch*frameSize+i], nSamples*sizeof(float));
+            memcpy(&outdata[ch*frameSize+i], &(h->gOutFIFO[ch][h->gRover-(h->inFifoLatency)]), nSamples*sizeof(float));
+        }
+        h->gRover += nSamples;
 
-            /* now we have enough data for processing */
-            if (h->gRover[ch] >= h->fftFrameSize) {
-                h->gRover[ch] = h->inFifoLatency;
+        /* now we have enough data for processing */
+        if (h->gRover >= h->fftFrameSize) {
+            h->gRover = h->inFifoLatency;
 
 #ifdef SMB_ENABLE_SAF_FFT
-                for (k = 0; k < h->fftFrameSize;k++)
-                    h->gFFTworksp_td[ch][k] = cmplxf(h->gInFIFO[ch][k] * (float)h->window[k], 0.0f);
-                saf_fft_forward(h->hFFT, h->gFFTworksp_td[ch], h->gFFTworksp_fd[ch]);
-#else
+            /* do windowing and transform (all channels at once) */
+            for(ch=0; ch<h->nCH; ch++)
+                utility_svvmul(h->gInFIFO[ch], h->window, h->fftFrameSize, h->gFFTworksp_td[ch]);
+            saf_rfft_forward_batch(h->hFFT, FLATTEN2D(h->gFFTworksp_td), h->fftFrameSize, FLATTEN2D(h->gFFTworksp_fd), fftFrameSize2+1, h->nCH);
+#endif
+
+            for(ch=0; ch<h->nCH; ch++){
+#ifndef SMB_ENABLE_SAF_FFT
                 /* do windowing and re,im interleave */
                 for (k = 0; k < h->fftFrameSize;k++) {
                     h->gFFTworksp[ch][2*k] = h->gInFIFO[ch][k] * h->window[k];
@@ -349,13 +358,10 @@ void smb_pitchShift_apply
                 }
 
 #ifdef SMB_ENABLE_SAF_FFT
-                for (k = fftFrameSize2+1; k < h->fftFrameSize; k++)
-                    h->gFFTworksp_fd[ch][k] = cmplxf(0.0f, 0.0f);
-
-                saf_fft_backward(h->hFFT, h->gFFTworksp_fd[ch], h->gFFTworksp_td[ch]);
-
-                for(k=0; k < h->fftFrameSize; k++)
-                    h->gOutputAccum[ch][k] += 2.0f*(h->window[k])*crealf(h->gFFTworksp_td[ch][k])/((h->osamp)); 
+                /* The original takes (2x) the real part of the inverse complex FFT, with the negative frequencies
+                 * zeroed. This is the same as the inverse real FFT, except that the DC and Nyquist bins are doubled */
+                h->gFFTworksp_fd[ch][0] = crmulf(h->gFFTworksp_fd[ch][0], 2.0f);
+                h->gFFTworksp_fd[ch][fftFrameSize2] = crmulf(h->gFFTworksp_fd[ch][fftFrameSize2], 2.0f);
 #else
                 /* zero negative frequencies */
                 for (k = h->fftFrameSize+2; k < 2*(h->fftFrameSize); k++)
@@ -368,6 +374,17 @@ void smb_pitchShift_apply
                 for(k=0; k < h->fftFrameSize; k++)
                     h->gOutputAccum[ch][k] += 2.*(h->window[k])*(h->gFFTworksp[ch][2*k])/(fftFrameSize2*(h->osamp));
 #endif
+            }
+
+#ifdef SMB_ENABLE_SAF_FFT
+            /* do inverse transform (all channels at once), windowing, and add to output accumulator */
+            saf_rfft_backward_batch(h->hFFT, FLATTEN2D(h->gFFTworksp_fd), fftFrameSize2+1, FLATTEN2D(h->gFFTworksp_td), h->fftFrameSize, h->nCH);
+            for(ch=0; ch<h->nCH; ch++)
+                for(k=0; k < h->fftFrameSize; k++)
+                    h->gOutputAccum[ch][k] += (h->window[k])*(h->gFFTworksp_td[ch][k])/((float)(h->osamp));
+#endif
+
+            for(ch=0; ch<h->nCH; ch++){
                 for (k = 0; k < h->stepSize; k++)
                     h->gOutFIFO[ch][k] = h->gOutputAccum[ch][k];
 
@@ -377,7 +394,7 @@ void smb_pitchShift_apply
                 /* move input FIFO */
                 for (k = 0; k < h->inFifoLatency; k++)
                     h->gInFIFO[ch][k] = h->gInFIFO[ch][k+h->stepSize];
-             }
-         }
+            }
+        }
     }
 }
@@ -64,6 +64,10 @@ static const float __qmf2hybCentreFreq[10][QMF_NBANDS_2_SUBDIVIDE] =
   { 0.0f,    0.0f,    0.9424f},
   { 0.0f,    0.0f,    1.0672f} };
 
+/** Offsets (in hops) of the synthesis buffer segments, which are windowed by
+ *  the 10 consecutive hops of the prototype filter */
+static const int __qmf_synWinOffsets[10] = { 0, 3, 4, 7, 8, 11, 12, 15, 16, 19 };
+
 /** Passes input time-domain data through the QMF filterbank. */
 static void qmfAnalyse
 (
@@ -117,10 +121,10 @@ typedef struct _qmf_data {
     int procDelay;                    /**< Processing delay in samples */
     QMF_FDDATA_FORMAT format;         /**< see #QMF_FDDATA_FORMAT */ 
 
-    /* QMF Analysis and Synthesis filters */
-    float_complex** h_a;
-    float** h_s_real;
-    float** h_s_imag;
+    /* QMF Analysis and Synthesis modulators (real-valued, such that they
+     * may be applied to all channels with a single sgemm) */
+    float* h_a_ri;  /**< Analysis modulators; rows 2k and 2k+1 hold the real and imaginary parts for band k; FLAT: 2*hopsize x 2*hopsize */
+    float* h_s_ri;  /**< Synthesis modulators, which take interleaved complex input (real parts, and negated imaginary parts); FLAT: 2*hopsize x 2*hopsize */
 
     /* Prototype window */
     float* h_p;
@@ -128,13 +132,9 @@ typedef struct _qmf_data {
     /* For run-time */
     float** buffer_ana;
     float** buffer_syn;
-    float* buffer_win;
-    float* win_sum;
-    float* win_sum_cmplx_dummy; /* treated as complex data type (interleaved with zeros for imag parts) */
-    float_complex* qmfTF_frame;
-    float* qmfTF_frame_tmp; /* used when taking the real/imag parts */
-    float* tmp_real_frame;
-    float* tmp_imag_frame;
+    float* win_sum;               /**< Windowed and folded analysis buffers; FLAT: nCHin x 2*hopsize */
+    float_complex* qmfTF_frames;  /**< QMF frames; FLAT: max(nCHin,nCHout) x hopsize */
+    float* syn_frames;            /**< Modulated synthesis frames; FLAT: nCHout x 2*hopsize */
 
     /* For hybrid filtering */
     float_complex fb8bandCoeffs[8][QMF_HYBRID_FILTER_LENGTH];
@@ -142,6 +142,7 @@ typedef struct _qmf_data {
     float_complex*** hybBuffer;
     float_complex*** qmfDelayBuffer;
     float_complex* hybQmfTF_frame;
+    float_complex* hybSubBands;   /**< Subdivided bands 1 (8), 2 (2) and 3 (2); FLAT: 12 x nCHin */
 
 }qmf_data;
 
@@ -161,6 +162,7 @@ void qmf_create
     int i,j,K,N,dsFactor;
     float scale, eq;
     float* k_tmp, *n_tmp;
+    float_complex h_a;
 
     saf_assert(hopsize==4 || hopsize==8 || hopsize==16 || hopsize==32 || hopsize==64 || hopsize==128, "Unsupported hopsize");
 
@@ -177,26 +179,29 @@ void qmf_create
     n_tmp = malloc1d(N*sizeof(float));
 
     /* QMF Analysis filters */
-    h->h_a = (float_complex**)malloc2d(K, N, sizeof(float_complex));
+    h->h_a_ri = malloc1d(N*N*sizeof(float));
     scale = (float)QMF_MAX_HOP_SIZE / (2.0f*(float)hopsize); /* (Used to balance the levels between different hopsizes) */
     for(i=0; i<K; i++)
         k_tmp[i] = SAF_PI/2.0f/(float)K * ((float)i+0.5f);
     for(i=0; i<N; i++)
         n_tmp[i] = 2.0f*(float)i - 2.0f*(float)K/(float)QMF_MAX_HOP_SIZE;
-    for(i=0; i<K; i++)
-        for(j=0; j<N; j++)
-            h->h_a[i][j] = crmulf(cexpf(cmplxf(0.0f, k_tmp[i]*n_tmp[j])), scale);
+    for(i=0; i<K; i++){
+        for(j=0; j<N; j++){
+            h_a = crmulf(cexpf(cmplxf(0.0f, k_tmp[i]*n_tmp[j])), scale);
+            h->h_a_ri[(2*i)*N+j]   = crealf(h_a);
+            h->h_a_ri[(2*i+1)*N+j] = cimagf(h_a);
+        }
+    }
 
     /* QMF Synthesis filters */
-    h->h_s_real = (float**)malloc2d(N, K, sizeof(float));
-    h->h_s_imag = (float**)malloc2d(N, K, sizeof(float));
+    h->h_s_ri = malloc1d(N*N*sizeof(float));
     scale = 2.0f / QMF_MAX_HOP_SIZE; /* (Used to balance the levels between different hopsizes) */
     for(i=0; i<N; i++)
         n_tmp[i] = 2.0f*(float)i - (2.0f*(float)QMF_MAX_HOP_SIZE-1.0f)*(float)K/((float)QMF_MAX_HOP_SIZE/2.0f);
     for(i=0; i<N; i++){
         for(j=0; j<K; j++){
-            h->h_s_real[i][j] = scale * cosf(k_tmp[j]*n_tmp[i]);
-            h->h_s_imag[i][j] = scale * sinf(k_tmp[j]*n_tmp[i]);
+            h->h_s_ri[i*N+2*j]   = scale * cosf(k_tmp[j]*n_tmp[i]);
+            h->h_s_ri[i*N+2*j+1] = -scale * sinf(k_tmp[j]*n_tmp[i]);
         }
     }
 
@@ -219,13 +224,9 @@ void qmf_create
     h->buffer_syn = (float**)malloc1d(nCHout*sizeof(float*));
     for(i=0; i<nCHout; i++)
         h->buffer_syn[i] = calloc1d(hopsize * 20, sizeof(float));
-    h->buffer_win = malloc1d(hopsize * 10 * sizeof(float));
-    h->win_sum = malloc1d(hopsize * 2 * sizeof(float));
-    h->win_sum_cmplx_dummy = calloc1d(hopsize * 4, sizeof(float)); /* ca */
-    h->qmfTF_frame = malloc1d(hopsize * sizeof(float_complex));
-    h->qmfTF_frame_tmp = malloc1d(hopsize * sizeof(float));
-    h->tmp_real_frame = malloc1d(hopsize * 2 * sizeof(float));
-    h->tmp_imag_frame = malloc1d(hopsize * 2 * sizeof(float));
+    h->win_sum = malloc1d(nCHin * hopsize * 2 * sizeof(float));
+    h->qmfTF_frames = malloc1d(SAF_MAX(nCHin, nCHout) * hopsize * sizeof(float_complex));
+    h->syn_frames = malloc1d(nCHout * hopsize * 2 * sizeof(float));
 
     /* Init hybrid filtering coefficients: */
     if(hybridmode){
@@ -254,6 +255,7 @@ void qmf_create
         h->qmfDelayBuffer = (float_complex***)calloc3d(nCHin, hopsize-QMF_NBANDS_2_SUBDIVIDE, (QMF_HYBRID_FILTER_LENGTH-1)/2 + 1, sizeof(float_complex)); /* ca */
         h->hybBuffer = (float_complex***)calloc3d(nCHin, QMF_NBANDS_2_SUBDIVIDE, QMF_HYBRID_FILTER_LENGTH, sizeof(float_complex));
         h->hybQmfTF_frame = malloc1d(h->nBands * sizeof(float_complex));
+        h->hybSubBands = malloc1d(12 * nCHin * sizeof(float_complex));
 
         /* Processing delay */
         h->procDelay = hopsize*15+1;
@@ -278,9 +280,8 @@ void qmf_destroy
 
     if(h!=NULL){
         /* QMF Analysis and Synthesis filters */
-        free(h->h_a);
-        free(h->h_s_real);
-        free(h->h_s_imag);
+        free(h->h_a_ri);
+        free(h->h_s_ri);
 
         /* Prototype window */
         free(h->h_p);
@@ -290,19 +291,16 @@ void qmf_destroy
             free(h->buffer_ana[i]);
         for(i=0; i<h->nCHout; i++)
             free(h->buffer_syn[i]);
-        free(h->buffer_win);
         free(h->win_sum);
-        free(h->win_sum_cmplx_dummy);
-        free(h->qmfTF_frame);
-        free(h->qmfTF_frame_tmp);
-        free(h->tmp_real_frame);
-        free(h->tmp_imag_frame);
+        free(h->qmfTF_frames);
+        free(h->syn_frames);
 
         /* For hybrid filtering */
         if(h->hybridmode){
             free(h->qmfDelayBuffer);
             free(h->hybBuffer);
             free(h->hybQmfTF_frame);
+            free(h->hybSubBands);
         }
 
         free(h);
@@ -320,115 +318,124 @@ void qmf_analysis
 )
 {
     qmf_data *h = (qmf_data*)(hQMF);
-    int i, ch, t, nHops, band;
-    float_complex subBands8[8], subBands2[2];
+    int i, j, n, ch, t, nHops, band, K, N;
+    float* buf, *win;
+    float_complex* qmfTF_frame, *subBands8, *subBands2a, *subBands2b;
     const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
 
     saf_assert(framesize % h->hopsize == 0, "framesize must be multiple of hopsize");  
     nHops = framesize/h->hopsize;
+    K = h->hopsize;
+    N = 2*K;
+    subBands8 = subBands2a = subBands2b = NULL;
+    if(h->hybridmode){
+        subBands8 = h->hybSubBands;
+        subBands2a = &subBands8[8*(h->nCHin)];
+        subBands2b = &subBands2a[2*(h->nCHin)];
+    }
 
-    for(ch=0; ch<h->nCHin; ch++){
-        for(t=0; t<nHops; t++){
+    for(t=0; t<nHops; t++){
+        for(ch=0; ch<h->nCHin; ch++){
             /* Shift samples to the right by one hopsize, and copy the current frame
                to the beginning */
-            memmove(&(h->buffer_ana[ch][h->hopsize]), h->buffer_ana[ch], h->hopsize * 9 * sizeof(float));
-            cblas_scopy(h->hopsize, &dataTD[ch][t*(h->hopsize)], -1, h->buffer_ana[ch], 1);
-
-            /* Apply prototype filter/window */
-            utility_svvmul(h->buffer_ana[ch], h->h_p, h->hopsize*10, h->buffer_win);
-
-            /* Sum all 5 consecutive 1:2*hopsize */
-            utility_svvadd(h->buffer_win, &(h->buffer_win[h->hopsize*2]), h->hopsize*2, h->win_sum);
-            cblas_saxpy(h->hopsize*2, 1.0f, h->buffer_win + h->hopsize*4, 1, h->win_sum, 1);
-            cblas_saxpy(h->hopsize*2, 1.0f, h->buffer_win + h->hopsize*6, 1, h->win_sum, 1);
-            cblas_saxpy(h->hopsize*2, 1.0f, h->buffer_win + h->hopsize*8, 1, h->win_sum, 1);
-            cblas_scopy(h->hopsize*2, h->win_sum, 1, h->win_sum_cmplx_dummy, 2);
-
-            /* Apply complex-QMF analysis modulators  */
-            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, h->hopsize, 1, h->hopsize*2, &calpha,
-                        FLATTEN2D(h->h_a), h->hopsize*2,
-                        (float_complex*)h->win_sum_cmplx_dummy, 1, &cbeta,
-                        h->qmfTF_frame, 1);
-
-            /* Subdivide the lowest 3 bands */
-            if(h->hybridmode){
+            buf = h->buffer_ana[ch];
+            memmove(&buf[K], buf, K * 9 * sizeof(float));
+            cblas_scopy(K, &dataTD[ch][t*K], -1, buf, 1);
+
+            /* Apply prototype filter/window, and sum all 5 consecutive 1:2*hopsize */
+            win = &(h->win_sum[ch*N]);
+            for(n=0; n<N; n++)
+                win[n] = buf[n] * h->h_p[n];
+            for(j=1; j<5; j++)
+                for(n=0; n<N; n++)
+                    win[n] += buf[j*N+n] * h->h_p[j*N+n];
+        }
+
+        /* Apply complex-QMF analysis modulators to all channels (the output
+         * rows are then the interleaved real/imaginary parts of each band) */
+        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, h->nCHin, N, N, 1.0f,
+                    h->win_sum, N,
+                    h->h_a_ri, N, 0.0f,
+                    (float*)h->qmfTF_frames, N);
+
+        /* Subdivide the lowest 3 bands */
+        if(h->hybridmode){
+            for(ch=0; ch<h->nCHin; ch++){
+                qmfTF_frame = &(h->qmfTF_frames[ch*K]);
+
                 /* Shift buffer down by 1 frame */
                 memmove(h->hybBuffer[ch][0], &(h->hybBuffer[ch][0][1]), (QMF_HYBRID_FILTER_LENGTH-1)*sizeof(float_complex));
                 memmove(h->hybBuffer[ch][1], &(h->hybBuffer[ch][1][1]), (QMF_HYBRID_FILTER_LENGTH-1)*sizeof(float_complex));
                 memmove(h->hybBuffer[ch][2], &(h->hybBuffer[ch][2][1]), (QMF_HYBRID_FILTER_LENGTH-1)*sizeof(float_complex));
 
                 /* Append new frame to hybrid filtering buffer */
-                h->hybBuffer[ch][0][QMF_HYBRID_FILTER_LENGTH-1] =  h->qmfTF_frame[0];
-                h->hybBuffer[ch][1][QMF_HYBRID_FILTER_LENGTH-1] =  h->qmfTF_frame[1];
-                h->hybBuffer[ch][2][QMF_HYBRID_FILTER_LENGTH-1] =  h->qmfTF_frame[2];
+                h->hybBuffer[ch][0][QMF_HYBRID_FILTER_LENGTH-1] =  qmfTF_frame[0];
+                h->hybBuffer[ch][1][QMF_HYBRID_FILTER_LENGTH-1] =  qmfTF_frame[1];
+                h->hybBuffer[ch][2][QMF_HYBRID_FILTER_LENGTH-1] =  qmfTF_frame[2];
 
                 /* Delay all the other QMF bands (i.e., the ones not being subdivided)
                  * so that they align with the hybrid bands in time: */
-                for(i=0; i<h->hopsize - QMF_NBANDS_2_SUBDIVIDE; i++){
+                for(i=0; i<K - QMF_NBANDS_2_SUBDIVIDE; i++){
                     memmove(h->qmfDelayBuffer[ch][i], &(h->qmfDelayBuffer[ch][i][1]), ((QMF_HYBRID_FILTER_LENGTH-1)/2)*sizeof(float_complex));
-                    h->qmfDelayBuffer[ch][i][(QMF_HYBRID_FILTER_LENGTH-1)/2] = h->qmfTF_frame[i+QMF_NBANDS_2_SUBDIVIDE];
+                    h->qmfDelayBuffer[ch][i][(QMF_HYBRID_FILTER_LENGTH-1)/2] = qmfTF_frame[i+QMF_NBANDS_2_SUBDIVIDE];
                 }
+            }
+
+            /* Subdivide first QMF band into 8 subbands, and the second and
+             * third QMF bands into 2 subbands each (for all channels) */
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasTrans, 8, h->nCHin, QMF_HYBRID_FILTER_LENGTH, &calpha,
+                        h->fb8bandCoeffs, QMF_HYBRID_FILTER_LENGTH,
+                        h->hybBuffer[0][0], QMF_NBANDS_2_SUBDIVIDE*QMF_HYBRID_FILTER_LENGTH, &cbeta,
+                        subBands8, h->nCHin);
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasTrans, 2, h->nCHin, QMF_HYBRID_FILTER_LENGTH, &calpha,
+                        h->fb4bandCoeffs, QMF_HYBRID_FILTER_LENGTH,
+                        h->hybBuffer[0][1], QMF_NBANDS_2_SUBDIVIDE*QMF_HYBRID_FILTER_LENGTH, &cbeta,
+                        subBands2a, h->nCHin);
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasTrans, 2, h->nCHin, QMF_HYBRID_FILTER_LENGTH, &calpha,
+                        h->fb4bandCoeffs, QMF_HYBRID_FILTER_LENGTH,
+                        h->hybBuffer[0][2], QMF_NBANDS_2_SUBDIVIDE*QMF_HYBRID_FILTER_LENGTH, &cbeta,
+                        subBands2b, h->nCHin);
+        }
 
-                /* Subdivide first QMF band into 8 subbands, and form hybrid bands 1-6 */
-                cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, 8, 1, QMF_HYBRID_FILTER_LENGTH, &calpha,
-                            h->fb8bandCoeffs, QMF_HYBRID_FILTER_LENGTH,
-                            h->hybBuffer[ch][0], 1, &cbeta,
-                            subBands8, 1);
-                h->hybQmfTF_frame[0] = subBands8[6];
-                h->hybQmfTF_frame[1] = subBands8[7];
-                h->hybQmfTF_frame[2] = subBands8[0];
-                h->hybQmfTF_frame[3] = subBands8[1];
+        for(ch=0; ch<h->nCHin; ch++){
+            qmfTF_frame = &(h->qmfTF_frames[ch*K]);
+            if(h->hybridmode){
+                /* Form hybrid bands 1-6 */
+                h->hybQmfTF_frame[0] = subBands8[6*(h->nCHin)+ch];
+                h->hybQmfTF_frame[1] = subBands8[7*(h->nCHin)+ch];
+                h->hybQmfTF_frame[2] = subBands8[0*(h->nCHin)+ch];
+                h->hybQmfTF_frame[3] = subBands8[1*(h->nCHin)+ch];
 #if _MSC_VER >= 1900
-                h->hybQmfTF_frame[4] = ccaddf(subBands8[2], subBands8[5]);
-                h->hybQmfTF_frame[5] = ccaddf(subBands8[3], subBands8[4]);
+                h->hybQmfTF_frame[4] = ccaddf(subBands8[2*(h->nCHin)+ch], subBands8[5*(h->nCHin)+ch]);
+                h->hybQmfTF_frame[5] = ccaddf(subBands8[3*(h->nCHin)+ch], subBands8[4*(h->nCHin)+ch]);
 #else
-                h->hybQmfTF_frame[4] = subBands8[2] + subBands8[5];
-                h->hybQmfTF_frame[5] = subBands8[3] + subBands8[4];
+                h->hybQmfTF_frame[4] = subBands8[2*(h->nCHin)+ch] + subBands8[5*(h->nCHin)+ch];
+                h->hybQmfTF_frame[5] = subBands8[3*(h->nCHin)+ch] + subBands8[4*(h->nCHin)+ch];
 #endif
 
-                /* Subdivide second QMF band to get hybrid bands 7 and 8 */
-                cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, 2, 1, QMF_HYBRID_FILTER_LENGTH, &calpha,
-                            h->fb4bandCoeffs, QMF_HYBRID_FILTER_LENGTH,
-                            h->hybBuffer[ch][1], 1, &cbeta,
-                            subBands2, 1);
-                h->hybQmfTF_frame[6] = subBands2[1]; /* Flipped! */
-                h->hybQmfTF_frame[7] = subBands2[0];
-
-                /* Subdivide third QMF band to get hybrid bands 9 and 10 */
-                cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, 2, 1, QMF_HYBRID_FILTER_LENGTH, &calpha,
-                            h->fb4bandCoeffs, QMF_HYBRID_FILTER_LENGTH,
-                            h->hybBuffer[ch][2], 1, &cbeta,
-                            subBands2, 1);
-                h->hybQmfTF_frame[8] = subBands2[0];
-                h->hybQmfTF_frame[9] = subBands2[1];
+                /* Hybrid bands 7 and 8 */
+                h->hybQmfTF_frame[6] = subBands2a[1*(h->nCHin)+ch]; /* Flipped! */
+                h->hybQmfTF_frame[7] = subBands2a[0*(h->nCHin)+ch];
+
+                /* Hybrid bands 9 and 10 */
+                h->hybQmfTF_frame[8] = subBands2b[0*(h->nCHin)+ch];
+                h->hybQmfTF_frame[9] = subBands2b[1*(h->nCHin)+ch];
 
                 /* The remaining bands are then just the delayed qmf bands, 4:end */
-                cblas_ccopy(h->hopsize - QMF_NBANDS_2_SUBDIVIDE, FLATTEN2D(h->qmfDelayBuffer[ch]),
+                cblas_ccopy(K - QMF_NBANDS_2_SUBDIVIDE, FLATTEN2D(h->qmfDelayBuffer[ch]),
                             (QMF_HYBRID_FILTER_LENGTH-1)/2 + 1, &(h->hybQmfTF_frame[10]), 1);
+                qmfTF_frame = h->hybQmfTF_frame;
             }
 
             /* copy to output */
-            if(h->hybridmode){
-                switch(h->format){
-                    case QMF_BANDS_CH_TIME:
-                        for(band=0; band<h->nBands; band++)
-                            dataFD[band][ch][t] = h->hybQmfTF_frame[band];
-                        break;
-                    case QMF_TIME_CH_BANDS:
-                        memcpy(dataFD[t][ch], h->hybQmfTF_frame, h->nBands*sizeof(float_complex));
-                        break;
-                }
-            }
-            else{
-                switch(h->format){
-                    case QMF_BANDS_CH_TIME:
-                        for(band=0; band<h->nBands; band++)
-                            dataFD[band][ch][t] = h->qmfTF_frame[band];
-                        break;
-                    case QMF_TIME_CH_BANDS:
-                        memcpy(dataFD[t][ch], h->qmfTF_frame, h->nBands*sizeof(float_complex));
-                        break;
-                }
+            switch(h->format){
+                case QMF_BANDS_CH_TIME:
+                    for(band=0; band<h->nBands; band++)
+                        dataFD[band][ch][t] = qmfTF_frame[band];
+                    break;
+                case QMF_TIME_CH_BANDS:
+                    memcpy(dataFD[t][ch], qmfTF_frame, h->nBands*sizeof(float_complex));
+                    break;
             }
         }
     }
@@ -443,14 +450,20 @@ void qmf_synthesis
 )
 {
     qmf_data *h = (qmf_data*)(hQMF);
-    int ch, t, nHops, band;
+    int j, n, ch, t, nHops, band, K, N;
+    float* buf, *out;
+    const float* h_p;
+    float_complex* qmfTF_frame;
 
     saf_assert(framesize % h->hopsize == 0, "framesize must be multiple of hopsize");
     nHops = framesize/h->hopsize;
+    K = h->hopsize;
+    N = 2*K;
 
-    for(ch=0; ch<h->nCHout; ch++){
-        for(t=0; t<nHops; t++){
+    for(t=0; t<nHops; t++){
+        for(ch=0; ch<h->nCHout; ch++){
             /* Load frequency domain data */
+            qmfTF_frame = &(h->qmfTF_frames[ch*K]);
             if(h->hybridmode){
                 switch(h->format){
                     case QMF_BANDS_CH_TIME:
@@ -464,73 +477,56 @@ void qmf_synthesis
 
                 /* Recombine the hybrid bands: */
 #if _MSC_VER >= 1900
-                h->qmfTF_frame[0] = ccaddf( h->hybQmfTF_frame[0], h->hybQmfTF_frame[1]);
-                h->qmfTF_frame[0] = ccaddf( h->qmfTF_frame[0],    h->hybQmfTF_frame[2]);
-                h->qmfTF_frame[0] = ccaddf( h->qmfTF_frame[0],    h->hybQmfTF_frame[3]);
-                h->qmfTF_frame[0] = ccaddf( h->qmfTF_frame[0],    h->hybQmfTF_frame[4]);
-                h->qmfTF_frame[0] = ccaddf( h->qmfTF_frame[0],    h->hybQmfTF_frame[5]);
-                h->qmfTF_frame[1] = ccaddf( h->hybQmfTF_frame[6], h->hybQmfTF_frame[7]);
-                h->qmfTF_frame[2] = ccaddf( h->hybQmfTF_frame[8], h->hybQmfTF_frame[9]);
+                qmfTF_frame[0] = ccaddf( h->hybQmfTF_frame[0], h->hybQmfTF_frame[1]);
+                qmfTF_frame[0] = ccaddf( qmfTF_frame[0],       h->hybQmfTF_frame[2]);
+                qmfTF_frame[0] = ccaddf( qmfTF_frame[0],       h->hybQmfTF_frame[3]);
+                qmfTF_frame[0] = ccaddf( qmfTF_frame[0],       h->hybQmfTF_frame[4]);
+                qmfTF_frame[0] = ccaddf( qmfTF_frame[0],       h->hybQmfTF_frame[5]);
+                qmfTF_frame[1] = ccaddf( h->hybQmfTF_frame[6], h->hybQmfTF_frame[7]);
+                qmfTF_frame[2] = ccaddf( h->hybQmfTF_frame[8], h->hybQmfTF_frame[9]);
 #else
-                h->qmfTF_frame[0] = h->hybQmfTF_frame[0]+h->hybQmfTF_frame[1]+h->hybQmfTF_frame[2]+
-                                    h->hybQmfTF_frame[3]+h->hybQmfTF_frame[4]+h->hybQmfTF_frame[5];
-                h->qmfTF_frame[1] = h->hybQmfTF_frame[6]+h->hybQmfTF_frame[7];
-                h->qmfTF_frame[2] = h->hybQmfTF_frame[8]+h->hybQmfTF_frame[9];
+                qmfTF_frame[0] = h->hybQmfTF_frame[0]+h->hybQmfTF_frame[1]+h->hybQmfTF_frame[2]+
+                                 h->hybQmfTF_frame[3]+h->hybQmfTF_frame[4]+h->hybQmfTF_frame[5];
+                qmfTF_frame[1] = h->hybQmfTF_frame[6]+h->hybQmfTF_frame[7];
+                qmfTF_frame[2] = h->hybQmfTF_frame[8]+h->hybQmfTF_frame[9];
 #endif
-                memmove(&(h->qmfTF_frame[3]), &(h->hybQmfTF_frame[10]), (h->hopsize - QMF_NBANDS_2_SUBDIVIDE)*sizeof(float_complex));
+                memcpy(&(qmfTF_frame[3]), &(h->hybQmfTF_frame[10]), (K - QMF_NBANDS_2_SUBDIVIDE)*sizeof(float_complex));
             }
             else{
                 switch(h->format){
                     case QMF_BANDS_CH_TIME:
                         for(band=0; band<h->nBands; band++)
-                            h->qmfTF_frame[band] = dataFD[band][ch][t];
+                            qmfTF_frame[band] = dataFD[band][ch][t];
                         break;
                     case QMF_TIME_CH_BANDS:
-                        memcpy(h->qmfTF_frame, dataFD[t][ch], h->nBands*sizeof(float_complex));
+                        memcpy(qmfTF_frame, dataFD[t][ch], h->nBands*sizeof(float_complex));
                         break;
                 }
             }
+        }
 
-            /* Shift samples to the right by 2*hopsize */
-            memmove(h->buffer_syn[ch] + h->hopsize*2, h->buffer_syn[ch], h->hopsize * 18 * sizeof(float));
-
-            /* Apply complex-QMF synthesis modulators */
-            cblas_scopy(h->hopsize, (float*)h->qmfTF_frame, 2, h->qmfTF_frame_tmp, 1); /* creal(h->qmfTF_frame) */
-            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, h->hopsize*2, 1, h->hopsize, 1.0f,
-                        FLATTEN2D(h->h_s_real), h->hopsize,
-                        h->qmfTF_frame_tmp, 1, 0.0f,
-                        h->tmp_real_frame, 1);
-            cblas_scopy(h->hopsize, &((float*)h->qmfTF_frame)[1], 2, h->qmfTF_frame_tmp, 1); /* cimag(h->qmfTF_frame) */
-            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, h->hopsize*2, 1, h->hopsize, 1.0f,
-                        FLATTEN2D(h->h_s_imag), h->hopsize,
-                        h->qmfTF_frame_tmp, 1, 0.0f,
-                        h->tmp_imag_frame, 1);
-
-            /* Append new synthesis frame */
-            utility_svvsub(h->tmp_real_frame, h->tmp_imag_frame, h->hopsize*2, h->buffer_syn[ch]);
-
-            /* Apply prototype filter/window */
-            utility_svvmul(h->buffer_syn[ch], h->h_p, h->hopsize, h->buffer_win);
-            utility_svvmul(h->buffer_syn[ch] + h->hopsize*3,  h->h_p + h->hopsize,   h->hopsize, h->buffer_win + h->hopsize);
-            utility_svvmul(h->buffer_syn[ch] + h->hopsize*4,  h->h_p + h->hopsize*2, h->hopsize, h->buffer_win + h->hopsize*2);
-            utility_svvmul(h->buffer_syn[ch] + h->hopsize*7,  h->h_p + h->hopsize*3, h->hopsize, h->buffer_win + h->hopsize*3);
-            utility_svvmul(h->buffer_syn[ch] + h->hopsize*8,  h->h_p + h->hopsize*4, h->hopsize, h->buffer_win + h->hopsize*4);
-            utility_svvmul(h->buffer_syn[ch] + h->hopsize*11, h->h_p + h->hopsize*5, h->hopsize, h->buffer_win + h->hopsize*5);
-            utility_svvmul(h->buffer_syn[ch] + h->hopsize*12, h->h_p + h->hopsize*6, h->hopsize, h->buffer_win + h->hopsize*6);
-            utility_svvmul(h->buffer_syn[ch] + h->hopsize*15, h->h_p + h->hopsize*7, h->hopsize, h->buffer_win + h->hopsize*7);
-            utility_svvmul(h->buffer_syn[ch] + h->hopsize*16, h->h_p + h->hopsize*8, h->hopsize, h->buffer_win + h->hopsize*8);
-            utility_svvmul(h->buffer_syn[ch] + h->hopsize*19, h->h_p + h->hopsize*9, h->hopsize, h->buffer_win + h->hopsize*9);
-
-            /* Sum all 1:hopsizes to get output frame */
-            utility_svvadd(h->buffer_win, h->buffer_win + h->hopsize,   h->hopsize, dataTD[ch] + t*(h->hopsize));
-            cblas_saxpy(h->hopsize, 1.0f, h->buffer_win + h->hopsize*2, 1, dataTD[ch] + t*(h->hopsize), 1);
-            cblas_saxpy(h->hopsize, 1.0f, h->buffer_win + h->hopsize*3, 1, dataTD[ch] + t*(h->hopsize), 1);
-            cblas_saxpy(h->hopsize, 1.0f, h->buffer_win + h->hopsize*4, 1, dataTD[ch] + t*(h->hopsize), 1);
-            cblas_saxpy(h->hopsize, 1.0f, h->buffer_win + h->hopsize*5, 1, dataTD[ch] + t*(h->hopsize), 1);
-            cblas_saxpy(h->hopsize, 1.0f, h->buffer_win + h->hopsize*6, 1, dataTD[ch] + t*(h->hopsize), 1);
-            cblas_saxpy(h->hopsize, 1.0f, h->buffer_win + h->hopsize*7, 1, dataTD[ch] + t*(h->hopsize), 1);
-            cblas_saxpy(h->hopsize, 1.0f, h->buffer_win + h->hopsize*8, 1, dataTD[ch] + t*(h->hopsize), 1);
-            cblas_saxpy(h->hopsize, 1.0f, h->buffer_win + h->hopsize*9, 1, dataTD[ch] + t*(h->hopsize), 1);
+        /* Apply complex-QMF synthesis modulators to all channels (taking the
+         * real part of the result) */
+        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, h->nCHout, N, N, 1.0f,
+                    (float*)h->qmfTF_frames, N,
+                    h->h_s_ri, N, 0.0f,
+                    h->syn_frames, N);
+
+        for(ch=0; ch<h->nCHout; ch++){
+            /* Shift samples to the right by 2*hopsize, and append new synthesis frame */
+            buf = h->buffer_syn[ch];
+            memmove(buf + N, buf, K * 18 * sizeof(float));
+            memcpy(buf, &(h->syn_frames[ch*N]), N*sizeof(float));
+
+            /* Apply prototype filter/window, and sum all 1:hopsizes to get output frame */
+            out = &dataTD[ch][t*K];
+            for(n=0; n<K; n++)
+                out[n] = buf[n] * h->h_p[n];
+            for(j=1; j<10; j++){
+                h_p = &(h->h_p[j*K]);
+                for(n=0; n<K; n++)
+                    out[n] += buf[__qmf_synWinOffsets[j]*K+n] * h_p[n];
+            }
         }
     }
 }
@@ -555,6 +551,8 @@ void qmf_channelChange
                                                          QMF_HYBRID_FILTER_LENGTH, h->nCHin, QMF_NBANDS_2_SUBDIVIDE,
                                                          QMF_HYBRID_FILTER_LENGTH, sizeof(float_complex));
 
+            h->hybSubBands = realloc1d(h->hybSubBands, 12 * new_nCHin * sizeof(float_complex));
+
             /* zero any new channels */
             for(i=h->nCHin; i<new_nCHin; i++){
                 memset(FLATTEN2D(h->qmfDelayBuffer[i]), 0, (h->hopsize-QMF_NBANDS_2_SUBDIVIDE) * ((QMF_HYBRID_FILTER_LENGTH-1)/2 + 1) * sizeof(float_complex));
@@ -568,6 +566,7 @@ void qmf_channelChange
         h->buffer_ana = (float**)realloc1d(h->buffer_ana, sizeof(float*)*new_nCHin);
         for(i=h->nCHin; i<new_nCHin; i++)
             h->buffer_ana[i] = (float*)calloc1d(h->hopsize * 10,sizeof(float));
+        h->win_sum = realloc1d(h->win_sum, new_nCHin * h->hopsize * 2 * sizeof(float));
 
         h->nCHin = new_nCHin;
     }
@@ -579,9 +578,11 @@ void qmf_channelChange
         h->buffer_syn = (float**)realloc1d(h->buffer_syn, sizeof(float*)*new_nCHout);
         for(i=h->nCHout; i<new_nCHout; i++)
             h->buffer_syn[i] = (float*)calloc1d(h->hopsize * 20, sizeof(float));
+        h->syn_frames = realloc1d(h->syn_frames, new_nCHout * h->hopsize * 2 * sizeof(float));
 
         h->nCHout = new_nCHout;
     }
+    h->qmfTF_frames = realloc1d(h->qmfTF_frames, SAF_MAX(h->nCHin, h->nCHout) * h->hopsize * sizeof(float_complex));
 }
 
 void qmf_clearBuffers
@@ -0,0 +1,675 @@
+/*
+ * Copyright 2026 Spatial_Audio_Framework contributors
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * @file saf_utility_threads.c
+ * @ingroup Utilities
+ * @brief A lightweight cross-platform thread pool
+ *
+ * The job queue is a bounded multi-producer/multi-consumer queue, based on
+ * the design by Dmitry Vyukov, where each cell carries a sequence number which
+ * indicates whether it is ready to be written to or read from.
+ *
+ * A job may also be claimed directly from its cell by the thread waiting for
+ * it (see saf_threadPool_wait()); a worker which later reaches that cell then
+ * finds it empty, and simply moves on to the next one.
+ *
+ * The state swap employs a single hazard pointer: the real-time thread
+ * advertises the state that it is about to use, and then checks that this is
+ * still the current state, while the publishing thread only hands back a
+ * replaced state once it is no longer advertised.
+ *
+ * @author Spatial_Audio_Framework contributors
+ * @date 15.10.2026
+ * @license ISC
+ */
+
+#include "saf_utilities.h"
+#include "saf_utility_threads.h"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+# ifdef __APPLE__
+#  include <dispatch/dispatch.h>
+# else
+#  include <semaphore.h>
+# endif
+#endif
+
+/* ========================================================================== */
+/*                            Platform Abstraction                            */
+/* ========================================================================== */
+
+#ifdef _MSC_VER
+typedef volatile long saf_atomic_long;
+typedef void* volatile saf_atomic_ptr;
+# define SAF_ATOMIC_LOAD(p)            InterlockedCompareExchange((p), 0, 0)
+# define SAF_ATOMIC_STORE(p, v)        InterlockedExchange((p), (v))
+# define SAF_ATOMIC_FETCH_ADD(p, v)    InterlockedExchangeAdd((p), (v))
+# define SAF_ATOMIC_CAS(p, expct, des) (InterlockedCompareExchange((p), (des), (expct))==(expct))
+# define SAF_ATOMIC_LOAD_PTR(p)        InterlockedCompareExchangePointer((p), NULL, NULL)
+# define SAF_ATOMIC_STORE_PTR(p, v)    InterlockedExchangePointer((p), (v))
+# define SAF_ATOMIC_EXCHANGE_PTR(p, v) InterlockedExchangePointer((p), (v))
+# define SAF_ATOMIC_CAS_PTR(p, expct, des) (InterlockedCompareExchangePointer((p), (des), (expct))==(expct))
+# define SAF_CPU_RELAX()               YieldProcessor()
+#else
+typedef long saf_atomic_long;
+typedef void* saf_atomic_ptr;
+# define SAF_ATOMIC_LOAD(p)            __atomic_load_n((p), __ATOMIC_SEQ_CST)
+# define SAF_ATOMIC_STORE(p, v)        __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+# define SAF_ATOMIC_FETCH_ADD(p, v)    __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+# define SAF_ATOMIC_CAS(p, expct, des) __extension__({ long _e = (expct); \
+    __atomic_compare_exchange_n((p), &_e, (des), 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); })
+# define SAF_ATOMIC_LOAD_PTR(p)        __atomic_load_n((p), __ATOMIC_SEQ_CST)
+# define SAF_ATOMIC_STORE_PTR(p, v)    __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+# define SAF_ATOMIC_EXCHANGE_PTR(p, v) __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+# define SAF_ATOMIC_CAS_PTR(p, expct, des) __extension__({ void* _e = (expct); \
+    __atomic_compare_exchange_n((p), &_e, (des), 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); })
+# if defined(__i386__) || defined(__x86_64__)
+#  define SAF_CPU_RELAX()              __builtin_ia32_pause()
+# else
+#  define SAF_CPU_RELAX()              do {} while(0)
+# endif
+#endif
+
+#ifdef _WIN32
+typedef HANDLE saf_thread_t;
+typedef HANDLE saf_sem_t;
+# define SAF_SEM_INIT(s)    ( (s) = CreateSemaphore(NULL, 0, LONG_MAX, NULL) )
+# define SAF_SEM_POST(s)    ReleaseSemaphore((s), 1, NULL)
+# define SAF_SEM_WAIT(s)    WaitForSingleObject((s), INFINITE)
+# define SAF_SEM_DESTROY(s) CloseHandle(s)
+# define SAF_THREAD_YIELD() SwitchToThread()
+#elif defined(__APPLE__)
+typedef pthread_t saf_thread_t;
+typedef dispatch_semaphore_t saf_sem_t;
+# define SAF_SEM_INIT(s)    ( (s) = dispatch_semaphore_create(0) )
+# define SAF_SEM_POST(s)    dispatch_semaphore_signal(s)
+# define SAF_SEM_WAIT(s)    dispatch_semaphore_wait((s), DISPATCH_TIME_FOREVER)
+# define SAF_SEM_DESTROY(s) dispatch_release(s)
+# define SAF_THREAD_YIELD() sched_yield()
+#else
+typedef pthread_t saf_thread_t;
+typedef sem_t saf_sem_t;
+# define SAF_SEM_INIT(s)    sem_init(&(s), 0, 0)
+# define SAF_SEM_POST(s)    sem_post(&(s))
+# define SAF_SEM_WAIT(s)    while(sem_wait(&(s))!=0) {}
+# define SAF_SEM_DESTROY(s) sem_destroy(&(s))
+# define SAF_THREAD_YIELD() sched_yield()
+#endif
+
+/** Number of times an idle worker polls the queue before parking */
+#define SAF_THREADPOOL_SPIN_COUNT ( 4096 )
+
+/* ========================================================================== */
+/*                                Thread Pool                                 */
+/* ========================================================================== */
+
+/** A cell of the job queue */
+typedef struct _saf_threadPool_cell {
+    saf_atomic_long seq;     /**< Sequence number of this cell */
+    saf_atomic_ptr job;      /**< Job stored in this cell (NULL: taken, or claimed by its waiter) */
+} saf_threadPool_cell;
+
+/** Shared state of a saf_threadPool_parallelFor() call */
+typedef struct _saf_threadPool_forData {
+    saf_threadPool_forFunc func; /**< Loop body */
+    void* arg;                   /**< Argument to pass to "func" */
+    int nIter;                   /**< Number of iterations */
+    int chunkSize;               /**< Number of iterations taken at a time */
+    saf_atomic_long next;        /**< Next iteration to be taken */
+
+} saf_threadPool_forData;
+
+/** Main structure for the thread pool */
+typedef struct _saf_threadPool_data {
+    int nThreads;                /**< Number of worker threads */
+    saf_thread_t* threads;       /**< Worker threads; nThreads x 1 */
+    saf_sem_t sem;               /**< Semaphore, which idle workers park on */
+    saf_atomic_long nParked;     /**< Number of parked (or parking) workers */
+    saf_sem_t doneSem;           /**< Semaphore, which threads waiting for a job to complete park on */
+    saf_atomic_long nWaiting;    /**< Number of parked (or parking) waiting threads */
+    saf_atomic_long quit;        /**< 1: workers should exit */
+    saf_threadPool_cell* cells;  /**< Job queue; SAF_THREADPOOL_MAX_NUM_JOBS x 1 */
+    saf_atomic_long enqueuePos;  /**< Queue write position */
+    saf_atomic_long dequeuePos;  /**< Queue read position */
+
+} saf_threadPool_data;
+
+/** Pushes a job onto the queue; returns 0 if the queue is full */
+static int saf_threadPool_enqueue
+(
+    saf_threadPool_data* h,
+    saf_threadPool_job* job
+)
+{
+    saf_threadPool_cell* cell;
+    long pos, seq, dif;
+
+    pos = SAF_ATOMIC_LOAD(&(h->enqueuePos));
+    for(;;){
+        cell = &(h->cells[(unsigned long)pos & (SAF_THREADPOOL_MAX_NUM_JOBS-1)]);
+        seq = SAF_ATOMIC_LOAD(&(cell->seq));
+        dif = (long)((unsigned long)seq - (unsigned long)pos);
+        if(dif==0){
+            if(SAF_ATOMIC_CAS(&(h->enqueuePos), pos, (long)((unsigned long)pos+1UL)))
+                break;
+        }
+        else if(dif<0)
+            return 0; /* full */
+        pos = SAF_ATOMIC_LOAD(&(h->enqueuePos));
+    }
+    job->cell = (void*)cell;
+    SAF_ATOMIC_STORE_PTR(&(cell->job), (void*)job);
+    SAF_ATOMIC_STORE(&(cell->seq), (long)((unsigned long)pos+1UL));
+    return 1;
+}
+
+/** Pops a job from the queue (skipping any claimed by their waiters); returns
+ *  NULL if the queue is empty */
+static saf_threadPool_job* saf_threadPool_dequeue
+(
+    saf_threadPool_data* h
+)
+{
+    saf_threadPool_cell* cell;
+    saf_threadPool_job* job;
+    long pos, seq, dif;
+
+    do {
+        pos = SAF_ATOMIC_LOAD(&(h->dequeuePos));
+        for(;;){
+            cell = &(h->cells[(unsigned long)pos & (SAF_THREADPOOL_MAX_NUM_JOBS-1)]);
+            seq = SAF_ATOMIC_LOAD(&(cell->seq));
+            dif = (long)((unsigned long)seq - ((unsigned long)pos+1UL));
+            if(dif==0){
+                if(SAF_ATOMIC_CAS(&(h->dequeuePos), pos, (long)((unsigned long)pos+1UL)))
+                    break;
+            }
+            else if(dif<0)
+                return NULL; /* empty */
+            pos = SAF_ATOMIC_LOAD(&(h->dequeuePos));
+        }
+        job = (saf_threadPool_job*)SAF_ATOMIC_EXCHANGE_PTR(&(cell->job), NULL);
+        SAF_ATOMIC_STORE(&(cell->seq), (long)((unsigned long)pos+SAF_THREADPOOL_MAX_NUM_JOBS));
+    } while(job==NULL);
+    return job;
+}
+
+/** Takes a job back out of its queue cell, if no worker has taken it yet;
+ *  returns 1 if it was claimed (and must then be run by the caller) */
+static int saf_threadPool_claim
+(
+    saf_threadPool_job* job
+)
+{
+    saf_threadPool_cell* cell;
+
+    /* A queued job is in the cell that it was last enqueued to (and only one
+     * thread can take it from there), while the cell holds some other job, or
+     * nothing, once it has been taken */
+    if(SAF_ATOMIC_LOAD(&(job->state)) != (long)SAF_THREADPOOL_JOB_QUEUED)
+        return 0;
+    cell = (saf_threadPool_cell*)job->cell;
+    return SAF_ATOMIC_CAS_PTR(&(cell->job), (void*)job, NULL) ? 1 : 0;
+}
+
+/** Executes a job, flags it as completed, and wakes up any parked waiters */
+static void saf_threadPool_run
+(
+    saf_threadPool_data* h,
+    saf_threadPool_job* job
+)
+{
+    long i, nWaiting;
+
+    SAF_ATOMIC_STORE(&(job->state), (long)SAF_THREADPOOL_JOB_RUNNING);
+    job->func(job->arg);
+    SAF_ATOMIC_STORE(&(job->state), (long)SAF_THREADPOOL_JOB_IDLE);
+
+    /* (the job may no longer exist from here on). The waiters may be waiting for other jobs, so they are all woken up,
+     * and those whose job is not yet done simply park again */
+    nWaiting = SAF_ATOMIC_LOAD(&(h->nWaiting));
+    for(i=0; i<nWaiting; i++)
+        SAF_SEM_POST(h->doneSem);
+}
+
+/** Worker thread loop */
+#ifdef _WIN32
+static DWORD WINAPI saf_threadPool_worker(LPVOID arg)
+#else
+static void* saf_threadPool_worker(void* arg)
+#endif
+{
+    saf_threadPool_data *h = (saf_threadPool_data*)arg;
+    saf_threadPool_job* job;
+    int spin;
+
+    spin = 0;
+    for(;;){
+        if((job = saf_threadPool_dequeue(h)) != NULL){
+            saf_threadPool_run(h, job);
+            spin = 0;
+            continue;
+        }
+        if(SAF_ATOMIC_LOAD(&(h->quit)))
+            break;
+        if(spin++ < SAF_THREADPOOL_SPIN_COUNT){
+            SAF_CPU_RELAX();
+            continue;
+        }
+
+        /* Announce intent to park, then check the queue once more, so that a
+         * job submitted in the meantime is not missed */
+        SAF_ATOMIC_FETCH_ADD(&(h->nParked), 1);
+        if((job = saf_threadPool_dequeue(h)) != NULL){
+            SAF_ATOMIC_FETCH_ADD(&(h->nParked), -1);
+            saf_threadPool_run(h, job);
+        }
+        else if(!SAF_ATOMIC_LOAD(&(h->quit))){
+            SAF_SEM_WAIT(h->sem);
+            SAF_ATOMIC_FETCH_ADD(&(h->nParked), -1);
+        }
+        else
+            SAF_ATOMIC_FETCH_ADD(&(h->nParked), -1);
+        spin = 0;
+    }
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+void saf_threadPool_create
+(
+    void ** const phTP,
+    int nThreads
+)
+{
+    saf_threadPool_data* h = (saf_threadPool_data*)malloc1d(sizeof(saf_threadPool_data));
+    *phTP = (void*)h;
+    int i;
+
+    h->nThreads = nThreads < 1 ? SAF_MAX(saf_threadPool_getNumCPUs()-1, 1) : nThreads;
+    h->nParked = 0;
+    h->nWaiting = 0;
+    h->quit = 0;
+    h->enqueuePos = h->dequeuePos = 0;
+    h->cells = (saf_threadPool_cell*)malloc1d(SAF_THREADPOOL_MAX_NUM_JOBS*sizeof(saf_threadPool_cell));
+    for(i=0; i<SAF_THREADPOOL_MAX_NUM_JOBS; i++){
+        h->cells[i].seq = (long)i;
+        SAF_ATOMIC_STORE_PTR(&(h->cells[i].job), NULL);
+    }
+    SAF_SEM_INIT(h->sem);
+    SAF_SEM_INIT(h->doneSem);
+
+    /* Spawn workers */
+    h->threads = (saf_thread_t*)malloc1d(h->nThreads*sizeof(saf_thread_t));
+    for(i=0; i<h->nThreads; i++){
+#ifdef _WIN32
+        h->threads[i] = CreateThread(NULL, 0, saf_threadPool_worker, (LPVOID)h, 0, NULL);
+        if(h->threads[i]==NULL)
+            saf_print_error("Failed to create thread");
+#else
+        if(pthread_create(&(h->threads[i]), NULL, saf_threadPool_worker, (void*)h)!=0)
+            saf_print_error("Failed to create thread");
+#endif
+    }
+}
+
+void saf_threadPool_destroy
+(
+    void ** const phTP
+)
+{
+    saf_threadPool_data *h = (saf_threadPool_data*)(*phTP);
+    int i;
+
+    if (h != NULL) {
+        /* Workers complete any remaining jobs before exiting */
+        SAF_ATOMIC_STORE(&(h->quit), 1);
+        for(i=0; i<h->nThreads; i++)
+            SAF_SEM_POST(h->sem);
+        for(i=0; i<h->nThreads; i++){
+#ifdef _WIN32
+            WaitForSingleObject(h->threads[i], INFINITE);
+            CloseHandle(h->threads[i]);
+#else
+            pthread_join(h->threads[i], NULL);
+#endif
+        }
+        SAF_SEM_DESTROY(h->sem);
+        SAF_SEM_DESTROY(h->doneSem);
+        free(h->threads);
+        free(h->cells);
+        free(h);
+        h = NULL;
+        *phTP = NULL;
+    }
+}
+
+int saf_threadPool_getNumThreads
+(
+    void * const hTP
+)
+{
+    saf_threadPool_data *h = (saf_threadPool_data*)(hTP);
+    return h->nThreads;
+}
+
+int saf_threadPool_getNumCPUs(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return SAF_MAX((int)sysinfo.dwNumberOfProcessors, 1);
+#else
+    return SAF_MAX((int)sysconf(_SC_NPROCESSORS_ONLN), 1);
+#endif
+}
+
+void saf_threadPool_initJob
+(
+    saf_threadPool_job* job,
+    saf_threadPool_jobFunc func,
+    void* arg
+)
+{
+    job->func = func;
+    job->arg = arg;
+    job->state = SAF_THREADPOOL_JOB_IDLE;
+    job->cell = NULL;
+}
+
+void saf_threadPool_submit
+(
+    void * const hTP,
+    saf_threadPool_job* job
+)
+{
+    saf_threadPool_data *h = (saf_threadPool_data*)(hTP);
+
+    saf_assert(job->state==SAF_THREADPOOL_JOB_IDLE, "Job has already been submitted");
+    SAF_ATOMIC_STORE(&(job->state), (long)SAF_THREADPOOL_JOB_QUEUED);
+    if(!saf_threadPool_enqueue(h, job)){
+        /* Queue is full, so just do it here */
+        saf_threadPool_run(h, job);
+        return;
+    }
+    if(SAF_ATOMIC_LOAD(&(h->nParked)) > 0)
+        SAF_SEM_POST(h->sem);
+}
+
+int saf_threadPool_tryRun
+(
+    void * const hTP,
+    saf_threadPool_job* job
+)
+{
+    saf_threadPool_data *h = (saf_threadPool_data*)(hTP);
+
+    if(!saf_threadPool_claim(job))
+        return 0;
+    saf_threadPool_run(h, job);
+    return 1;
+}
+
+void saf_threadPool_wait
+(
+    void * const hTP,
+    saf_threadPool_job* job
+)
+{
+    saf_threadPool_data *h = (saf_threadPool_data*)(hTP);
+    int spin;
+
+    /* If no worker has started the job yet, then it is run here. Other queued jobs are left alone, since they may
+     * belong to other clients of the pool, and take any amount of time */
+    if(saf_threadPool_tryRun(hTP, job))
+        return;
+    spin = 0;
+    while(!saf_threadPool_isDone(job)){
+        if(spin++ < SAF_THREADPOOL_SPIN_COUNT){
+            SAF_CPU_RELAX();
+            continue;
+        }
+
+        /* The job is being run by a worker, which may have been descheduled; so, rather than burning the time-slice
+         * that it may need, announce intent to park, and then check once more, so that its completion is not missed */
+        SAF_ATOMIC_FETCH_ADD(&(h->nWaiting), 1);
+        if(!saf_threadPool_isDone(job))
+            SAF_SEM_WAIT(h->doneSem);
+        SAF_ATOMIC_FETCH_ADD(&(h->nWaiting), -1);
+        spin = 0;
+    }
+}
+
+int saf_threadPool_isDone
+(
+    saf_threadPool_job* job
+)
+{
+    return SAF_ATOMIC_LOAD(&(job->state)) == (long)SAF_THREADPOOL_JOB_IDLE;
+}
+
+/** saf_threadPool job, which takes chunks of a saf_threadPool_parallelFor()
+ * loop until there are none left */
+static void saf_threadPool_forJob
+(
+    void* arg
+)
+{
+    saf_threadPool_forData* f = (saf_threadPool_forData*)arg;
+    long start;
+
+    while((start = SAF_ATOMIC_FETCH_ADD(&(f->next), (long)f->chunkSize)) < (long)f->nIter)
+        f->func(f->arg, (int)start, SAF_MIN((int)start+f->chunkSize, f->nIter));
+}
+
+void saf_threadPool_parallelFor
+(
+    void * const hTP,
+    int nIter,
+    saf_threadPool_forFunc func,
+    void* arg
+)
+{
+    saf_threadPool_data *h = (saf_threadPool_data*)(hTP);
+    saf_threadPool_forData f;
+    saf_threadPool_job jobs[SAF_THREADPOOL_MAX_NUM_FOR_JOBS];
+    int i, nJobs;
+
+    if(nIter<1)
+        return;
+    nJobs = h==NULL ? 0 : SAF_MIN(SAF_MIN(h->nThreads, nIter-1), SAF_THREADPOOL_MAX_NUM_FOR_JOBS);
+    if(nJobs<1){
+        func(arg, 0, nIter);
+        return;
+    }
+
+    /* A few chunks per thread, so that a slow worker does not hold up the rest */
+    f.func = func;
+    f.arg = arg;
+    f.nIter = nIter;
+    f.chunkSize = SAF_MAX(nIter/(4*(nJobs+1)), 1);
+    f.next = 0;
+    for(i=0; i<nJobs; i++){
+        saf_threadPool_initJob(&jobs[i], saf_threadPool_forJob, (void*)&f);
+        saf_threadPool_submit(hTP, &jobs[i]);
+    }
+
+    /* The calling thread also takes part, and then waits for the stragglers (the jobs which no worker has started by
+     * then return straight away, since there are no iterations left) */
+    saf_threadPool_forJob((void*)&f);
+    for(i=0; i<nJobs; i++)
+        saf_threadPool_tryRun(hTP, &jobs[i]);
+    for(i=0; i<nJobs; i++)
+        saf_threadPool_wait(hTP, &jobs[i]);
+}
+
+
+/* ========================================================================== */
+/*                                 State Swap                                 */
+/* ========================================================================== */
+
+/** Main structure for the state swap */
+typedef struct _saf_stateSwap_data {
+    saf_atomic_ptr current; /**< Currently published state */
+    saf_atomic_ptr inUse;   /**< State currently acquired by the real-time thread (the hazard pointer); NULL if none */
+
+} saf_stateSwap_data;
+
+void saf_stateSwap_create
+(
+    void ** const phSS
+)
+{
+    saf_stateSwap_data* h = (saf_stateSwap_data*)malloc1d(sizeof(saf_stateSwap_data));
+    *phSS = (void*)h;
+
+    SAF_ATOMIC_STORE_PTR(&(h->current), NULL);
+    SAF_ATOMIC_STORE_PTR(&(h->inUse), NULL);
+}
+
+void saf_stateSwap_destroy
+(
+    void ** const phSS
+)
+{
+    saf_stateSwap_data *h = (saf_stateSwap_data*)(*phSS);
+
+    if(h!=NULL){
+        /* Wait for the real-time thread to let go of the current state */
+        while(SAF_ATOMIC_LOAD_PTR(&(h->inUse))!=NULL)
+            SAF_THREAD_YIELD();
+        free(h);
+        h = NULL;
+        *phSS = NULL;
+    }
+}
+
+void* saf_stateSwap_publish
+(
+    void * const hSS,
+    void* newState
+)
+{
+    saf_stateSwap_data *h = (saf_stateSwap_data*)(hSS);
+    void* prevState;
+    int spin;
+
+    prevState = SAF_ATOMIC_EXCHANGE_PTR(&(h->current), newState);
+    saf_assert(prevState==NULL || prevState!=newState, "The new state must not be the current state");
+
+    /* The real-time thread picks up the new state with its next acquire; but it may still be using the previous one */
+    if(prevState!=NULL){
+        for(spin=0; SAF_ATOMIC_LOAD_PTR(&(h->inUse))==prevState; spin++){
+            if(spin < SAF_THREADPOOL_SPIN_COUNT)
+                SAF_CPU_RELAX();
+            else
+                SAF_THREAD_YIELD();
+        }
+    }
+    return prevState;
+}
+
+void* saf_stateSwap_acquire
+(
+    void * const hSS
+)
+{
+    saf_stateSwap_data *h = (saf_stateSwap_data*)(hSS);
+    void* state;
+
+    /* Advertise the state, and then make sure that it was not replaced in the meantime (in which case, the publishing
+     * thread may have already missed the advertisement and handed it back). Only repeats if a new state is published
+     * exactly during these few instructions. */
+    do {
+        state = SAF_ATOMIC_LOAD_PTR(&(h->current));
+        SAF_ATOMIC_STORE_PTR(&(h->inUse), state);
+    } while(state != SAF_ATOMIC_LOAD_PTR(&(h->current)));
+    return state;
+}
+
+void saf_stateSwap_release
+(
+    void * const hSS
+)
+{
+    saf_stateSwap_data *h = (saf_stateSwap_data*)(hSS);
+    SAF_ATOMIC_STORE_PTR(&(h->inUse), NULL);
+}
+
+
+/* ========================================================================== */
+/*                                  Atomics                                   */
+/* ========================================================================== */
+
+long saf_atomic_load
+(
+    volatile long* p
+)
+{
+    return SAF_ATOMIC_LOAD(p);
+}
+
+void saf_atomic_store
+(
+    volatile long* p,
+    long value
+)
+{
+    SAF_ATOMIC_STORE(p, value);
+}
+
+int saf_atomic_compareExchange
+(
+    volatile long* p,
+    long expected,
+    long desired
+)
+{
+    return SAF_ATOMIC_CAS(p, expected, desired) ? 1 : 0;
+}
+
+void saf_spinLock_lock
+(
+    volatile long* lock
+)
+{
+    int spin;
+
+    for(spin=0; !SAF_ATOMIC_CAS(lock, 0, 1); spin++){
+        /* Give up the time-slice if the lock is held for longer than a moment */
+        if(spin < SAF_THREADPOOL_SPIN_COUNT)
+            SAF_CPU_RELAX();
+        else
+            SAF_THREAD_YIELD();
+    }
+}
+
+void saf_spinLock_unlock
+(
+    volatile long* lock
+)
+{
+    SAF_ATOMIC_STORE(lock, 0);
+}
@@ -0,0 +1,331 @@
+/*
+ * Copyright 2026 Spatial_Audio_Framework contributors
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ *@addtogroup Utilities
+ *@{
+ * @file saf_utility_threads.h
+ * @brief A lightweight cross-platform thread pool
+ *
+ * The thread pool comprises persistent worker threads, which take jobs from a
+ * bounded lock-free queue. Idle workers spin for a short while before parking,
+ * and jobs are described by caller-owned structures; therefore, no memory is
+ * allocated when submitting jobs, and submitting/waiting is suitable for use
+ * from within real-time audio callbacks.
+ *
+ * A parallel-for primitive is also provided, which splits the iterations of a
+ * loop (e.g. over frequency bands or channels) across the workers and the
+ * calling thread.
+ *
+ * Lastly, saf_stateSwap allows a state (e.g. the tables and filterbanks used
+ * for rendering) to be built by one thread, while the real-time thread keeps
+ * using the previous state, and then handed over to the real-time thread
+ * without locks.
+ *
+ * @author Spatial_Audio_Framework contributors
+ * @date 15.10.2026
+ * @license ISC
+ */
+
+#ifndef SAF_THREADS_H_INCLUDED
+#define SAF_THREADS_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** Maximum number of jobs which may be queued at any one time */
+#define SAF_THREADPOOL_MAX_NUM_JOBS ( 1024 )
+
+/**
+ * Maximum number of jobs which saf_threadPool_parallelFor() splits a loop into
+ * (in addition to the calling thread)
+ */
+#define SAF_THREADPOOL_MAX_NUM_FOR_JOBS ( 64 )
+
+/** Function prototype for jobs submitted to a thread pool */
+typedef void (*saf_threadPool_jobFunc)(void* arg);
+
+/**
+ * Function prototype for loop bodies passed to saf_threadPool_parallelFor(),
+ * which should execute the iterations: start, start+1, ..., end-1
+ */
+typedef void (*saf_threadPool_forFunc)(void* arg, int start, int end);
+
+/**
+ * A job for a saf_threadPool
+ *
+ * The structure is owned by the caller, and must remain valid until the job
+ * has completed (see saf_threadPool_wait()). Only "func" and "arg" should be
+ * set by the caller; see saf_threadPool_initJob().
+ */
+typedef struct _saf_threadPool_job {
+    saf_threadPool_jobFunc func; /**< Function to execute */
+    void* arg;                   /**< Argument to pass to "func" */
+    volatile long state;         /**< Internal; see #SAF_THREADPOOL_JOB_STATES */
+    void* volatile cell;         /**< Internal; queue cell the job was last
+                                  *   submitted to */
+} saf_threadPool_job;
+
+/** Job states */
+typedef enum {
+    SAF_THREADPOOL_JOB_IDLE = 0, /**< Never submitted, or completed */
+    SAF_THREADPOOL_JOB_QUEUED,   /**< Submitted, but not yet started */
+    SAF_THREADPOOL_JOB_RUNNING   /**< Currently being executed */
+
+} SAF_THREADPOOL_JOB_STATES;
+
+
+/* ========================================================================== */
+/*                                Thread Pool                                 */
+/* ========================================================================== */
+
+/**
+ * Creates an instance of saf_threadPool
+ *
+ * @param[in] phTP     (&) address of saf_threadPool handle
+ * @param[in] nThreads Number of worker threads; or 0 (or less) to use the
+ *                     number of available CPU cores minus 1 (but at least 1)
+ */
+void saf_threadPool_create(void ** const phTP,
+                           int nThreads);
+
+/**
+ * Destroys an instance of saf_threadPool (after completing any queued jobs)
+ *
+ * @param[in] phTP (&) address of saf_threadPool handle
+ */
+void saf_threadPool_destroy(void ** const phTP);
+
+/**
+ * Returns the number of worker threads employed by a saf_threadPool
+ *
+ * @param[in] hTP saf_threadPool handle
+ */
+int saf_threadPool_getNumThreads(void * const hTP);
+
+/** Returns the number of CPU cores available on the system */
+int saf_threadPool_getNumCPUs(void);
+
+/**
+ * Prepares a job structure for submission to a saf_threadPool
+ *
+ * @param[in] job  Job structure
+ * @param[in] func Function to execute
+ * @param[in] arg  Argument to pass to "func"
+ */
+void saf_threadPool_initJob(saf_threadPool_job* job,
+                            saf_threadPool_jobFunc func,
+                            void* arg);
+
+/**
+ * Submits a job to the thread pool
+ *
+ * @note If the queue is full, then the job is executed immediately by the
+ *       calling thread. The job must not already be queued or running.
+ *
+ * @param[in] hTP saf_threadPool handle
+ * @param[in] job Job to submit
+ */
+void saf_threadPool_submit(void * const hTP,
+                           saf_threadPool_job* job);
+
+/**
+ * Runs a previously submitted job on the calling thread, if no worker has
+ * started it yet
+ *
+ * This may be used by a thread about to wait for several of its own jobs, to
+ * first take on any which are still queued (before waiting for the rest with
+ * saf_threadPool_wait()).
+ *
+ * @param[in] hTP saf_threadPool handle
+ * @param[in] job Job to run
+ * @returns 1: if the job was run by the calling thread, 0: if it has already
+ *          been started by a worker (or was not submitted)
+ */
+int saf_threadPool_tryRun(void * const hTP,
+                          saf_threadPool_job* job);
+
+/**
+ * Waits until a previously submitted job has completed
+ *
+ * If no worker has started the job yet, then it is run by the calling thread;
+ * therefore, this function returns even if all workers are busy or have not
+ * been scheduled. Other queued jobs are never taken on, so the time spent here
+ * is bounded by that of the job itself. If the job is already running on a
+ * worker, then the calling thread spins for a short while, before parking until
+ * a job completes (so as not to starve a descheduled worker of CPU time).
+ *
+ * @param[in] hTP saf_threadPool handle
+ * @param[in] job Job to wait for (returns immediately if it is not submitted)
+ */
+void saf_threadPool_wait(void * const hTP,
+                         saf_threadPool_job* job);
+
+/**
+ * Returns 1 if the job has completed (or was never submitted), 0 otherwise
+ *
+ * @param[in] job Job to query
+ */
+int saf_threadPool_isDone(saf_threadPool_job* job);
+
+/**
+ * Executes the iterations 0, 1, ..., nIter-1 of a loop, split across the
+ * workers of a saf_threadPool and the calling thread
+ *
+ * The iterations are handed out in chunks, such that loop bodies of unequal
+ * cost are still balanced across the threads. The function returns once all of
+ * the iterations have completed. No memory is allocated.
+ *
+ * @note The iterations may be executed in any order and concurrently;
+ *       therefore, they must not write to the same memory. If hTP is NULL, then
+ *       func(arg, 0, nIter) is simply called by the calling thread.
+ *
+ * @test test__saf_threadPool_parallelFor()
+ *
+ * @param[in] hTP   saf_threadPool handle (or NULL)
+ * @param[in] nIter Number of iterations
+ * @param[in] func  Loop body
+ * @param[in] arg   Argument to pass to "func"
+ */
+void saf_threadPool_parallelFor(void * const hTP,
+                                int nIter,
+                                saf_threadPool_forFunc func,
+                                void* arg);
+
+
+/* ========================================================================== */
+/*                                 State Swap                                 */
+/* ========================================================================== */
+
+/**
+ * Creates an instance of saf_stateSwap, which hands over states (pointers to
+ * anything) from one non-real-time thread to one real-time thread
+ *
+ * The non-real-time thread builds a complete new state, and then publishes it
+ * with saf_stateSwap_publish(). The real-time thread brackets each use of the
+ * current state with saf_stateSwap_acquire() and saf_stateSwap_release(),
+ * neither of which lock, wait, or allocate memory; therefore, it keeps using
+ * the previous state until the new one is published, and picks up the new
+ * state with its next saf_stateSwap_acquire() call. The previous state is
+ * handed back to the publishing thread once it is no longer in use, so that it
+ * may be freed or re-used for building the next state (i.e. double-buffering).
+ *
+ * @test test__saf_stateSwap()
+ *
+ * @param[in] phSS (&) address of saf_stateSwap handle
+ */
+void saf_stateSwap_create(void ** const phSS);
+
+/**
+ * Destroys an instance of saf_stateSwap
+ *
+ * @note The current state is not freed; it may be taken back beforehand by
+ *       publishing NULL (see saf_stateSwap_publish()).
+ *
+ * @param[in] phSS (&) address of saf_stateSwap handle
+ */
+void saf_stateSwap_destroy(void ** const phSS);
+
+/**
+ * Replaces the current state, and returns the previous one once the real-time
+ * thread is no longer using it
+ *
+ * If the real-time thread is currently using the previous state, then this
+ * function waits until it calls saf_stateSwap_release(); i.e. for at most one
+ * processing block. The returned state belongs to the caller again.
+ *
+ * @warning Must not be called by the real-time thread, and the new state must
+ *          not be the current state.
+ *
+ * @param[in] hSS      saf_stateSwap handle
+ * @param[in] newState New state (or NULL, to take back the current state)
+ * @returns The previous state (or NULL, if there was none)
+ */
+void* saf_stateSwap_publish(void * const hSS,
+                            void* newState);
+
+/**
+ * Returns the current state, which remains valid (and is not handed back to the
+ * publishing thread) until saf_stateSwap_release() is called
+ *
+ * @note Lock-free and wait-free with respect to the publishing thread. Only one
+ *       thread may acquire states at a time.
+ *
+ * @param[in] hSS saf_stateSwap handle
+ * @returns The current state (or NULL, if none has been published yet)
+ */
+void* saf_stateSwap_acquire(void * const hSS);
+
+/**
+ * Indicates that the state returned by saf_stateSwap_acquire() is no longer
+ * being used
+ *
+ * @param[in] hSS saf_stateSwap handle
+ */
+void saf_stateSwap_release(void * const hSS);
+
+
+/* ========================================================================== */
+/*                                  Atomics                                   */
+/* ========================================================================== */
+
+/** Atomically loads and returns the value of "p" */
+long saf_atomic_load(volatile long* p);
+
+/** Atomically stores "value" in "p" */
+void saf_atomic_store(volatile long* p,
+                      long value);
+
+/**
+ * Atomically replaces the value of "p" with "desired", but only if it is equal
+ * to "expected"
+ *
+ * @param[in] p        Variable
+ * @param[in] expected Expected value of the variable
+ * @param[in] desired  New value of the variable
+ * @returns 1: if the value was replaced, 0: otherwise
+ */
+int saf_atomic_compareExchange(volatile long* p,
+                               long expected,
+                               long desired);
+
+/**
+ * Acquires a spin lock (a variable, which is initially 0)
+ *
+ * If the lock is contended for more than a moment, then the calling thread
+ * yields its time-slice while waiting; therefore, the lock may also be used to
+ * guard rare, but lengthy, operations.
+ *
+ * @param[in] lock Lock variable
+ */
+void saf_spinLock_lock(volatile long* lock);
+
+/**
+ * Releases a spin lock previously acquired with saf_spinLock_lock()
+ *
+ * @param[in] lock Lock variable
+ */
+void saf_spinLock_unlock(volatile long* lock);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* SAF_THREADS_H_INCLUDED */
+
+/**@} */ /* doxygen addtogroup Utilities */
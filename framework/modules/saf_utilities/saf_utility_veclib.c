@@ -125,6 +125,362 @@
 #endif
 
 
+/* ========================================================================== */
+/*                        SIMD Kernels (Run-time Dispatch)                    */
+/* ========================================================================== */
+
+#if defined(SAF_ENABLE_SIMD)
+/*
+ * The SIMD kernels are compiled for several instruction set extensions, by
+ * means of function target attributes (GCC/Clang), or natively (MSVC). The
+ * widest variant supported by the host CPU is then selected at run-time, such
+ * that the same binary may be deployed on any x86_64 machine.
+ *
+ * Each kernel processes as many elements as it can with its vector width, and
+ * returns the number of elements that it processed; leaving the remainder for
+ * the narrower kernels and, finally, the scalar code. The real-valued
+ * add/sub/mul kernels use aligned loads/stores if all of the vectors are
+ * aligned to the vector width (e.g. if they were allocated with
+ * malloc1d_aligned()).
+ */
+# if defined(__GNUC__) || defined(__clang__)
+#  define SAF_SIMD_TARGET(isa) __attribute__((target(isa))) /**< Compile a function for the specified instruction set extension(s) */
+# else
+#  define SAF_SIMD_TARGET(isa)                              /**< MSVC permits all intrinsics without additional flags */
+# endif
+/** Non-zero if all three pointers are aligned to "nBytes" (a power of 2) */
+# define SAF_SIMD_ARE_ALIGNED(a, b, c, nBytes) ( (((uintptr_t)(a) | (uintptr_t)(b) | (uintptr_t)(c)) & ((uintptr_t)(nBytes)-1)) == 0 )
+
+/** Highest SIMD level supported by the host CPU; -1: not yet detected */
+static volatile long __saf_simd_supportedLevel = -1;
+/** Highest SIMD level that the user has permitted */
+static volatile long __saf_simd_maxLevel = SAF_SIMD_AVX512;
+
+/** Queries the host CPU (and OS) for the supported instruction sets */
+static SAF_SIMD_LEVELS saf_simd_detectLevel(void)
+{
+# if defined(_MSC_VER) && !defined(__clang__)
+    int info[4], nIds, avx2, avx512f;
+    unsigned long long xcr0;
+    __cpuid(info, 0);
+    nIds = info[0];
+    __cpuid(info, 1);
+    if(!(info[2] & (1<<0))) /* SSE3 */
+        return SAF_SIMD_NONE;
+    if(!(info[2] & (1<<27)) || !(info[2] & (1<<28))) /* OSXSAVE and AVX */
+        return SAF_SIMD_SSE3;
+    xcr0 = _xgetbv(0);
+    avx2 = avx512f = 0;
+    if(nIds>=7){
+        __cpuidex(info, 7, 0);
+        avx2 = info[1] & (1<<5);
+        avx512f = info[1] & (1<<16);
+    }
+    if(avx512f && (xcr0 & 0xE6) == 0xE6) /* OS saves the XMM, YMM, and ZMM state */
+        return SAF_SIMD_AVX512;
+    if(avx2 && (xcr0 & 0x6) == 0x6)      /* OS saves the XMM and YMM state */
+        return SAF_SIMD_AVX2;
+    return SAF_SIMD_SSE3;
+# else
+    /* (these builtins also verify that the OS saves the extended registers) */
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f"))
+        return SAF_SIMD_AVX512;
+    if(__builtin_cpu_supports("avx2"))
+        return SAF_SIMD_AVX2;
+    if(__builtin_cpu_supports("sse3"))
+        return SAF_SIMD_SSE3;
+    return SAF_SIMD_NONE;
+# endif
+}
+
+/** Element-wise vector-vector kernels (single precision): c = a (op) b */
+# define SAF_SIMD_DEFINE_SVV_KERNELS(OP) \
+static SAF_SIMD_TARGET("avx512f") int saf_simd_svv##OP##_avx512(const float* a, const float* b, const int len, float* c) { \
+    int i; \
+    if(SAF_SIMD_ARE_ALIGNED(a, b, c, 64)) \
+        for(i=0; i<(len-15); i+=16) \
+            _mm512_store_ps(c+i, _mm512_##OP##_ps(_mm512_load_ps(a+i), _mm512_load_ps(b+i))); \
+    else \
+        for(i=0; i<(len-15); i+=16) \
+            _mm512_storeu_ps(c+i, _mm512_##OP##_ps(_mm512_loadu_ps(a+i), _mm512_loadu_ps(b+i))); \
+    return i; \
+} \
+static SAF_SIMD_TARGET("avx2") int saf_simd_svv##OP##_avx2(const float* a, const float* b, const int len, float* c) { \
+    int i; \
+    if(SAF_SIMD_ARE_ALIGNED(a, b, c, 32)) \
+        for(i=0; i<(len-7); i+=8) \
+            _mm256_store_ps(c+i, _mm256_##OP##_ps(_mm256_load_ps(a+i), _mm256_load_ps(b+i))); \
+    else \
+        for(i=0; i<(len-7); i+=8) \
+            _mm256_storeu_ps(c+i, _mm256_##OP##_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i))); \
+    return i; \
+} \
+static SAF_SIMD_TARGET("sse3") int saf_simd_svv##OP##_sse3(const float* a, const float* b, const int len, float* c) { \
+    int i; \
+    if(SAF_SIMD_ARE_ALIGNED(a, b, c, 16)) \
+        for(i=0; i<(len-3); i+=4) \
+            _mm_store_ps(c+i, _mm_##OP##_ps(_mm_load_ps(a+i), _mm_load_ps(b+i))); \
+    else \
+        for(i=0; i<(len-3); i+=4) \
+            _mm_storeu_ps(c+i, _mm_##OP##_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i))); \
+    return i; \
+}
+SAF_SIMD_DEFINE_SVV_KERNELS(add)
+SAF_SIMD_DEFINE_SVV_KERNELS(sub)
+SAF_SIMD_DEFINE_SVV_KERNELS(mul)
+
+/** Element-wise vector-vector kernels (double precision): c = a (op) b */
+# define SAF_SIMD_DEFINE_DVV_KERNELS(OP) \
+static SAF_SIMD_TARGET("avx512f") int saf_simd_dvv##OP##_avx512(const double* a, const double* b, const int len, double* c) { \
+    int i; \
+    if(SAF_SIMD_ARE_ALIGNED(a, b, c, 64)) \
+        for(i=0; i<(len-7); i+=8) \
+            _mm512_store_pd(c+i, _mm512_##OP##_pd(_mm512_load_pd(a+i), _mm512_load_pd(b+i))); \
+    else \
+        for(i=0; i<(len-7); i+=8) \
+            _mm512_storeu_pd(c+i, _mm512_##OP##_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i))); \
+    return i; \
+} \
+static SAF_SIMD_TARGET("avx2") int saf_simd_dvv##OP##_avx2(const double* a, const double* b, const int len, double* c) { \
+    int i; \
+    if(SAF_SIMD_ARE_ALIGNED(a, b, c, 32)) \
+        for(i=0; i<(len-3); i+=4) \
+            _mm256_store_pd(c+i, _mm256_##OP##_pd(_mm256_load_pd(a+i), _mm256_load_pd(b+i))); \
+    else \
+        for(i=0; i<(len-3); i+=4) \
+            _mm256_storeu_pd(c+i, _mm256_##OP##_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i))); \
+    return i; \
+} \
+static SAF_SIMD_TARGET("sse3") int saf_simd_dvv##OP##_sse3(const double* a, const double* b, const int len, double* c) { \
+    int i; \
+    if(SAF_SIMD_ARE_ALIGNED(a, b, c, 16)) \
+        for(i=0; i<(len-1); i+=2) \
+            _mm_store_pd(c+i, _mm_##OP##_pd(_mm_load_pd(a+i), _mm_load_pd(b+i))); \
+    else \
+        for(i=0; i<(len-1); i+=2) \
+            _mm_storeu_pd(c+i, _mm_##OP##_pd(_mm_loadu_pd(a+i), _mm_loadu_pd(b+i))); \
+    return i; \
+}
+SAF_SIMD_DEFINE_DVV_KERNELS(add)
+SAF_SIMD_DEFINE_DVV_KERNELS(sub)
+
+/** Element-wise vector-scalar kernels: c = a (op) s */
+# define SAF_SIMD_DEFINE_VS_KERNELS(OP) \
+static SAF_SIMD_TARGET("avx512f") int saf_simd_svs##OP##_avx512(const float* a, const float s, const int len, float* c) { \
+    int i; \
+    __m512 s16 = _mm512_set1_ps(s); \
+    if(SAF_SIMD_ARE_ALIGNED(a, a, c, 64)) \
+        for(i=0; i<(len-15); i+=16) \
+            _mm512_store_ps(c+i, _mm512_##OP##_ps(_mm512_load_ps(a+i), s16)); \
+    else \
+        for(i=0; i<(len-15); i+=16) \
+            _mm512_storeu_ps(c+i, _mm512_##OP##_ps(_mm512_loadu_ps(a+i), s16)); \
+    return i; \
+} \
+static SAF_SIMD_TARGET("avx2") int saf_simd_svs##OP##_avx2(const float* a, const float s, const int len, float* c) { \
+    int i; \
+    __m256 s8 = _mm256_set1_ps(s); \
+    if(SAF_SIMD_ARE_ALIGNED(a, a, c, 32)) \
+        for(i=0; i<(len-7); i+=8) \
+            _mm256_store_ps(c+i, _mm256_##OP##_ps(_mm256_load_ps(a+i), s8)); \
+    else \
+        for(i=0; i<(len-7); i+=8) \
+            _mm256_storeu_ps(c+i, _mm256_##OP##_ps(_mm256_loadu_ps(a+i), s8)); \
+    return i; \
+} \
+static SAF_SIMD_TARGET("sse3") int saf_simd_svs##OP##_sse3(const float* a, const float s, const int len, float* c) { \
+    int i; \
+    __m128 s4 = _mm_set1_ps(s); \
+    if(SAF_SIMD_ARE_ALIGNED(a, a, c, 16)) \
+        for(i=0; i<(len-3); i+=4) \
+            _mm_store_ps(c+i, _mm_##OP##_ps(_mm_load_ps(a+i), s4)); \
+    else \
+        for(i=0; i<(len-3); i+=4) \
+            _mm_storeu_ps(c+i, _mm_##OP##_ps(_mm_loadu_ps(a+i), s4)); \
+    return i; \
+}
+SAF_SIMD_DEFINE_VS_KERNELS(add)
+SAF_SIMD_DEFINE_VS_KERNELS(sub)
+
+/** Vector-reciprocal kernels (approximate): c = 1/a */
+static SAF_SIMD_TARGET("avx512f") int saf_simd_svrecip_avx512(const float* a, const int len, float* c)
+{
+    int i;
+    for(i=0; i<(len-15); i+=16)
+        _mm512_storeu_ps(c+i, _mm512_rcp14_ps(_mm512_loadu_ps(a+i)));
+    return i;
+}
+static SAF_SIMD_TARGET("avx2") int saf_simd_svrecip_avx2(const float* a, const int len, float* c)
+{
+    int i;
+    for(i=0; i<(len-7); i+=8)
+        _mm256_storeu_ps(c+i, _mm256_rcp_ps(_mm256_loadu_ps(a+i)));
+    return i;
+}
+static SAF_SIMD_TARGET("sse3") int saf_simd_svrecip_sse3(const float* a, const int len, float* c)
+{
+    int i;
+    for(i=0; i<(len-3); i+=4)
+        _mm_storeu_ps(c+i, _mm_rcp_ps(_mm_loadu_ps(a+i)));
+    return i;
+}
+
+/** Complex element-wise multiplication kernels: c = a .* b (there is no
+ *  AVX-512 alternative for addsub, so the AVX2 kernel is also used then) */
+static SAF_SIMD_TARGET("avx2") int saf_simd_cvvmul_avx2(const float* sa, const float* sb, const int len, float* sc)
+{
+    int i;
+    __m256i permute_ri = _mm256_set_epi32(6, 7, 4, 5, 2, 3, 0, 1);
+    for(i=0; i<(len-3); i+=4){
+        /* Load only the real parts of a */
+        __m256 src1 = _mm256_moveldup_ps(_mm256_loadu_ps(sa+2*i)/*|a1|b1|a2|b2|a3|b3|a4|b4|*/); /*|a1|a1|a2|a2|a3|a3|a4|a4|*/
+        /* Load real+imag parts of b */
+        __m256 src2 = _mm256_loadu_ps(sb+2*i); /*|c1|d1|c2|d2|c3|d3|c4|d4|*/
+        /* Multiply together */
+        __m256 tmp1 = _mm256_mul_ps(src1, src2);
+        /* Swap the real+imag parts of b to be imag+real instead: */
+        __m256 b1 = _mm256_permutevar8x32_ps(src2, permute_ri);
+        /* Load only the imag parts of a */
+        src1 = _mm256_movehdup_ps(_mm256_loadu_ps(sa+2*i)/*|a1|b1|a2|b2|a3|b3|a4|b4|*/); /*|b1|b1|b2|b2|b3|b3|b4|b4|*/
+        /* Multiply together */
+        __m256 tmp2 = _mm256_mul_ps(src1, b1);
+        /* Add even indices, subtract odd indices */
+        _mm256_storeu_ps(sc+2*i, _mm256_addsub_ps(tmp1, tmp2));
+    }
+    return i;
+}
+static SAF_SIMD_TARGET("sse3") int saf_simd_cvvmul_sse3(const float* sa, const float* sb, const int len, float* sc)
+{
+    int i;
+    for(i=0; i<(len-1); i+=2){
+        /* Load only the real parts of a */
+        __m128 src1 = _mm_moveldup_ps(_mm_loadu_ps(sa+2*i)/*|a1|b1|a2|b2|*/); /*|a1|a1|a2|a2|*/
+        /* Load real+imag parts of b */
+        __m128 src2 = _mm_loadu_ps(sb+2*i); /*|c1|d1|c2|d2|*/
+        /* Multiply together */
+        __m128 tmp1 = _mm_mul_ps(src1, src2);
+        /* Swap the real+imag parts of b to be imag+real instead: */
+        __m128 b1 = _mm_shuffle_ps(src2, src2, _MM_SHUFFLE(2, 3, 0, 1));
+        /* Load only the imag parts of a */
+        src1 = _mm_movehdup_ps(_mm_loadu_ps(sa+2*i)/*|a1|b1|a2|b2|*/); /*|b1|b1|b2|b2|*/
+        /* Multiply together */
+        __m128 tmp2 = _mm_mul_ps(src1, b1);
+        /* Add even indices, subtract odd indices */
+        _mm_storeu_ps(sc+2*i, _mm_addsub_ps(tmp1, tmp2));
+    }
+    return i;
+}
+
+/** Complex element-wise multiply-accumulate kernels: c = c + a .* b, or
+ *  c = c + a .* conj(b) (if conjB is non-zero) */
+static SAF_SIMD_TARGET("avx512f") int saf_simd_cvvmac_avx512(const float* sa, const float* sb, const int len, const int conjB, float* sc)
+{
+    int i;
+    __m512 sgn = conjB ? _mm512_set_ps(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f) : _mm512_set1_ps(1.0f);
+    for(i=0; i<(len-7); i+=8){
+        __m512 src1 = _mm512_loadu_ps(sa+2*i);
+        __m512 src2 = _mm512_mul_ps(_mm512_loadu_ps(sb+2*i), sgn);
+        /* (real parts of a) * b, plus/minus (imag parts of a) * (b with its real+imag parts swapped) */
+        __m512 tmp2 = _mm512_mul_ps(_mm512_movehdup_ps(src1), _mm512_permute_ps(src2, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m512 prod = _mm512_fmaddsub_ps(_mm512_moveldup_ps(src1), src2, tmp2);
+        _mm512_storeu_ps(sc+2*i, _mm512_add_ps(_mm512_loadu_ps(sc+2*i), prod));
+    }
+    return i;
+}
+static SAF_SIMD_TARGET("avx2") int saf_simd_cvvmac_avx2(const float* sa, const float* sb, const int len, const int conjB, float* sc)
+{
+    int i;
+    __m256 sgn = conjB ? _mm256_set_ps(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f) : _mm256_set1_ps(1.0f);
+    for(i=0; i<(len-3); i+=4){
+        __m256 src1 = _mm256_loadu_ps(sa+2*i);
+        __m256 src2 = _mm256_mul_ps(_mm256_loadu_ps(sb+2*i), sgn);
+        __m256 tmp1 = _mm256_mul_ps(_mm256_moveldup_ps(src1), src2);
+        __m256 tmp2 = _mm256_mul_ps(_mm256_movehdup_ps(src1), _mm256_permute_ps(src2, _MM_SHUFFLE(2, 3, 0, 1)));
+        _mm256_storeu_ps(sc+2*i, _mm256_add_ps(_mm256_loadu_ps(sc+2*i), _mm256_addsub_ps(tmp1, tmp2)));
+    }
+    return i;
+}
+static SAF_SIMD_TARGET("sse3") int saf_simd_cvvmac_sse3(const float* sa, const float* sb, const int len, const int conjB, float* sc)
+{
+    int i;
+    __m128 sgn = conjB ? _mm_set_ps(-1.0f, 1.0f, -1.0f, 1.0f) : _mm_set1_ps(1.0f);
+    for(i=0; i<(len-1); i+=2){
+        __m128 src1 = _mm_loadu_ps(sa+2*i);
+        __m128 src2 = _mm_mul_ps(_mm_loadu_ps(sb+2*i), sgn);
+        __m128 tmp1 = _mm_mul_ps(_mm_moveldup_ps(src1), src2);
+        __m128 tmp2 = _mm_mul_ps(_mm_movehdup_ps(src1), _mm_shuffle_ps(src2, src2, _MM_SHUFFLE(2, 3, 0, 1)));
+        _mm_storeu_ps(sc+2*i, _mm_add_ps(_mm_loadu_ps(sc+2*i), _mm_addsub_ps(tmp1, tmp2)));
+    }
+    return i;
+}
+
+/** Scaled complex-real element-wise multiply-accumulate kernels:
+ *  c = c + s * (a .* b), where b is real */
+static SAF_SIMD_TARGET("avx512f") int saf_simd_crvvmac_avx512(const float* sa, const float* b, const float s, const int len, float* sc)
+{
+    int i;
+    __m512 s16 = _mm512_set1_ps(s);
+    __m512i dup = _mm512_set_epi32(7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2, 1, 1, 0, 0);
+    for(i=0; i<(len-7); i+=8){
+        /* Duplicate each real element of b, to scale both the real and imag parts of a */
+        __m512 b16 = _mm512_permutexvar_ps(dup, _mm512_castps256_ps512(_mm256_loadu_ps(b+i)));
+        _mm512_storeu_ps(sc+2*i, _mm512_fmadd_ps(_mm512_mul_ps(_mm512_loadu_ps(sa+2*i), b16), s16, _mm512_loadu_ps(sc+2*i)));
+    }
+    return i;
+}
+static SAF_SIMD_TARGET("avx2") int saf_simd_crvvmac_avx2(const float* sa, const float* b, const float s, const int len, float* sc)
+{
+    int i;
+    __m256 s8 = _mm256_set1_ps(s);
+    for(i=0; i<(len-3); i+=4){
+        /* Duplicate each real element of b, to scale both the real and imag parts of a */
+        __m128 b4 = _mm_loadu_ps(b+i);
+        __m256 b8 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(b4, b4)), _mm_unpackhi_ps(b4, b4), 1);
+        _mm256_storeu_ps(sc+2*i, _mm256_add_ps(_mm256_loadu_ps(sc+2*i), _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(sa+2*i), b8), s8)));
+    }
+    return i;
+}
+static SAF_SIMD_TARGET("sse3") int saf_simd_crvvmac_sse3(const float* sa, const float* b, const float s, const int len, float* sc)
+{
+    int i;
+    __m128 s4 = _mm_set1_ps(s);
+    for(i=0; i<(len-1); i+=2){
+        /* Duplicate each real element of b, to scale both the real and imag parts of a */
+        __m128 b2 = _mm_castpd_ps(_mm_load_sd((const double*)(b+i)));
+        __m128 b4 = _mm_unpacklo_ps(b2, b2);
+        _mm_storeu_ps(sc+2*i, _mm_add_ps(_mm_loadu_ps(sc+2*i), _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(sa+2*i), b4), s4)));
+    }
+    return i;
+}
+
+#endif /* SAF_ENABLE_SIMD */
+
+SAF_SIMD_LEVELS saf_getSIMDLevel(void)
+{
+#if defined(SAF_ENABLE_SIMD)
+    long supported;
+    supported = saf_atomic_load(&__saf_simd_supportedLevel);
+    if(supported<0){
+        /* Detected once, on first use (racing threads all store the same value) */
+        supported = (long)saf_simd_detectLevel();
+        saf_atomic_store(&__saf_simd_supportedLevel, supported);
+    }
+    return (SAF_SIMD_LEVELS)SAF_MIN(supported, saf_atomic_load(&__saf_simd_maxLevel));
+#else
+    return SAF_SIMD_NONE;
+#endif
+}
+
+void saf_setMaxSIMDLevel(SAF_SIMD_LEVELS maxLevel)
+{
+#if defined(SAF_ENABLE_SIMD)
+    saf_atomic_store(&__saf_simd_maxLevel, (long)maxLevel);
+#else
+    SAF_UNUSED(maxLevel);
+#endif
+}
+
 /* ========================================================================== */
 /*                     Built-in CBLAS Functions (Level 0)                     */
 /* ========================================================================== */
@@ -518,20 +874,13 @@ void utility_svrecip
     vmsInv(len, a, c, SAF_INTEL_MKL_VML_MODE);
 #elif defined(SAF_ENABLE_SIMD)
     int i;
+    SAF_SIMD_LEVELS level;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len-15); i+=16)
-        _mm512_storeu_ps(c+i, _mm512_rcp14_ps(_mm512_loadu_ps(a+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len-7); i+=8)
-        _mm256_storeu_ps(c+i, _mm256_rcp_ps(_mm256_loadu_ps(a+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len-3); i+=4)
-        _mm_storeu_ps(c+i, _mm_rcp_ps(_mm_loadu_ps(a+i)));
-# endif
-    for(;i<len; i++) /* The residual (if len was not divisable by the step size): */
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_svrecip_avx512(a+i, len-i, c+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_svrecip_avx2(a+i, len-i, c+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_svrecip_sse3(a+i, len-i, c+i);
+    for(; i<len; i++) /* The residual (if len was not divisable by the step size): */
         c[i] = 1.0f/a[i];
 #else
     int i;
@@ -648,19 +997,12 @@ void utility_svvadd
     vmsAdd(len, a, b, c, SAF_INTEL_MKL_VML_MODE);
 #elif defined(SAF_ENABLE_SIMD)
     int i;
+    SAF_SIMD_LEVELS level;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len-15); i+=16)
-        _mm512_storeu_ps(c+i, _mm512_add_ps(_mm512_loadu_ps(a+i), _mm512_loadu_ps(b+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len-7); i+=8)
-        _mm256_storeu_ps(c+i, _mm256_add_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len-3); i+=4)
-        _mm_storeu_ps(c+i, _mm_add_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i)));
-# endif
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_svvadd_avx512(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_svvadd_avx2(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_svvadd_sse3(a+i, b+i, len-i, c+i);
     for(; i<len; i++) /* The residual (if len was not divisable by the step size): */
         c[i] = a[i] + b[i];
 #elif defined(NDEBUG)
@@ -705,21 +1047,14 @@ void utility_cvvadd
 #elif defined(SAF_ENABLE_SIMD)
     int i, len2;
     float* sa, *sb, *sc;
+    SAF_SIMD_LEVELS level;
     len2 = len*2;
     sa = (float*)a; sb = (float*)b; sc = (float*)c;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len2-15); i+=16)
-        _mm512_storeu_ps(sc+i, _mm512_add_ps(_mm512_loadu_ps(sa+i), _mm512_loadu_ps(sb+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len2-7); i+=8)
-        _mm256_storeu_ps(sc+i, _mm256_add_ps(_mm256_loadu_ps(sa+i), _mm256_loadu_ps(sb+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len2-3); i+=4)
-        _mm_storeu_ps(sc+i, _mm_add_ps(_mm_loadu_ps(sa+i), _mm_loadu_ps(sb+i)));
-# endif
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_svvadd_avx512(sa+i, sb+i, len2-i, sc+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_svvadd_avx2(sa+i, sb+i, len2-i, sc+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_svvadd_sse3(sa+i, sb+i, len2-i, sc+i);
     for(; i<len2; i++) /* The residual (if len2 was not divisable by the step size): */
         sc[i] = sa[i] + sb[i];
 #elif __STDC_VERSION__ >= 199901L && defined(NDEBUG)
@@ -763,19 +1098,12 @@ void utility_dvvadd
     vmdAdd(len, a, b, c, SAF_INTEL_MKL_VML_MODE);
 #elif defined(SAF_ENABLE_SIMD)
     int i;
+    SAF_SIMD_LEVELS level;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len-7); i+=8)
-        _mm512_storeu_pd(c+i, _mm512_add_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len-3); i+=4)
-        _mm256_storeu_pd(c+i, _mm256_add_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len-1); i+=2)
-        _mm_storeu_pd(c+i, _mm_add_pd(_mm_loadu_pd(a+i), _mm_loadu_pd(b+i)));
-# endif
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_dvvadd_avx512(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_dvvadd_avx2(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_dvvadd_sse3(a+i, b+i, len-i, c+i);
     for(; i<len; i++) /* The residual (if len was not divisable by the step size): */
         c[i] = a[i] + b[i];
 #else
@@ -808,24 +1136,17 @@ void utility_zvvadd
     vmzAdd(len, (MKL_Complex16*)a, (MKL_Complex16*)b, (MKL_Complex16*)c, SAF_INTEL_MKL_VML_MODE);
 #elif defined(SAF_ENABLE_SIMD)
     int i, len2;
-    double* sa, *sb, *sc;
+    double* da, *db, *dc;
+    SAF_SIMD_LEVELS level;
     len2 = len*2;
-    sa = (double*)a; sb = (double*)b; sc = (double*)c;
+    da = (double*)a; db = (double*)b; dc = (double*)c;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len2-7); i+=8)
-        _mm512_storeu_pd(sc+i, _mm512_add_pd(_mm512_loadu_pd(sa+i), _mm512_loadu_pd(sb+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len2-3); i+=4)
-        _mm256_storeu_pd(sc+i, _mm256_add_pd(_mm256_loadu_pd(sa+i), _mm256_loadu_pd(sb+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len2-1); i+=2)
-        _mm_storeu_pd(sc+i, _mm_add_pd(_mm_loadu_pd(sa+i), _mm_loadu_pd(sb+i)));
-# endif
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_dvvadd_avx512(da+i, db+i, len2-i, dc+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_dvvadd_avx2(da+i, db+i, len2-i, dc+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_dvvadd_sse3(da+i, db+i, len2-i, dc+i);
     for(; i<len2; i++) /* The residual (if len2 was not divisable by the step size): */
-        sc[i] = sa[i] + sb[i];
+        dc[i] = da[i] + db[i];
 #else
     int j;
     for (j = 0; j < len; j++)
@@ -861,19 +1182,12 @@ void utility_svvsub
     vmsSub(len, a, b, c, SAF_INTEL_MKL_VML_MODE);
 #elif defined(SAF_ENABLE_SIMD)
     int i;
+    SAF_SIMD_LEVELS level;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len-15); i+=16)
-        _mm512_storeu_ps(c+i, _mm512_sub_ps(_mm512_loadu_ps(a+i), _mm512_loadu_ps(b+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len-7); i+=8)
-        _mm256_storeu_ps(c+i, _mm256_sub_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len-3); i+=4)
-        _mm_storeu_ps(c+i, _mm_sub_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i)));
-# endif
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_svvsub_avx512(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_svvsub_avx2(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_svvsub_sse3(a+i, b+i, len-i, c+i);
     for(; i<len; i++) /* The residual (if len was not divisable by the step size): */
         c[i] = a[i] - b[i];
 #elif defined(NDEBUG)
@@ -918,21 +1232,14 @@ void utility_cvvsub
 #elif defined(SAF_ENABLE_SIMD)
     int i, len2;
     float* sa, *sb, *sc;
+    SAF_SIMD_LEVELS level;
     len2 = len*2;
     sa = (float*)a; sb = (float*)b; sc = (float*)c;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len2-15); i+=16)
-        _mm512_storeu_ps(sc+i, _mm512_sub_ps(_mm512_loadu_ps(sa+i), _mm512_loadu_ps(sb+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len2-7); i+=8)
-        _mm256_storeu_ps(sc+i, _mm256_sub_ps(_mm256_loadu_ps(sa+i), _mm256_loadu_ps(sb+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len2-3); i+=4)
-        _mm_storeu_ps(sc+i, _mm_sub_ps(_mm_loadu_ps(sa+i), _mm_loadu_ps(sb+i)));
-# endif
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_svvsub_avx512(sa+i, sb+i, len2-i, sc+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_svvsub_avx2(sa+i, sb+i, len2-i, sc+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_svvsub_sse3(sa+i, sb+i, len2-i, sc+i);
     for(; i<len2; i++) /* The residual (if len2 was not divisable by the step size): */
         sc[i] = sa[i] - sb[i];
 #elif __STDC_VERSION__ >= 199901L && defined(NDEBUG)
@@ -976,20 +1283,13 @@ void utility_dvvsub
     vmdSub(len, a, b, c, SAF_INTEL_MKL_VML_MODE);
 #elif defined(SAF_ENABLE_SIMD)
     int i;
+    SAF_SIMD_LEVELS level;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len-7); i+=8)
-        _mm512_storeu_pd(c+i, _mm512_sub_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len-3); i+=4)
-        _mm256_storeu_pd(c+i, _mm256_sub_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len-1); i+=2)
-        _mm_storeu_pd(c+i, _mm_sub_pd(_mm_loadu_pd(a+i), _mm_loadu_pd(b+i)));
-# endif
-    for(;i<len; i++) /* The residual (if len was not divisable by the step size): */
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_dvvsub_avx512(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_dvvsub_avx2(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_dvvsub_sse3(a+i, b+i, len-i, c+i);
+    for(; i<len; i++) /* The residual (if len was not divisable by the step size): */
         c[i] = a[i] - b[i];
 #else
     int j;
@@ -1021,24 +1321,17 @@ void utility_zvvsub
     vmzSub(len, (MKL_Complex16*)a, (MKL_Complex16*)b, (MKL_Complex16*)c, SAF_INTEL_MKL_VML_MODE);
 #elif defined(SAF_ENABLE_SIMD)
     int i, len2;
-    double* sa, *sb, *sc;
+    double* da, *db, *dc;
+    SAF_SIMD_LEVELS level;
     len2 = len*2;
-    sa = (double*)a; sb = (double*)b; sc = (double*)c;
+    da = (double*)a; db = (double*)b; dc = (double*)c;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len2-7); i+=8)
-        _mm512_storeu_pd(sc+i, _mm512_sub_pd(_mm512_loadu_pd(sa+i), _mm512_loadu_pd(sb+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len2-3); i+=4)
-        _mm256_storeu_pd(sc+i, _mm256_sub_pd(_mm256_loadu_pd(sa+i), _mm256_loadu_pd(sb+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len2-1); i+=2)
-        _mm_storeu_pd(sc+i, _mm_sub_pd(_mm_loadu_pd(sa+i), _mm_loadu_pd(sb+i)));
-# endif
-    for(;i<len2; i++) /* The residual (if len2 was not divisable by the step size): */
-        sc[i] = sa[i] - sb[i];
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_dvvsub_avx512(da+i, db+i, len2-i, dc+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_dvvsub_avx2(da+i, db+i, len2-i, dc+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_dvvsub_sse3(da+i, db+i, len2-i, dc+i);
+    for(; i<len2; i++) /* The residual (if len2 was not divisable by the step size): */
+        dc[i] = da[i] - db[i];
 #else
     int j;
     for (j = 0; j < len; j++)
@@ -1074,20 +1367,13 @@ void utility_svvmul
     vmsMul(len, a, b, c, SAF_INTEL_MKL_VML_MODE);
 #elif defined(SAF_ENABLE_SIMD)
     int i;
+    SAF_SIMD_LEVELS level;
+    level = saf_getSIMDLevel();
     i = 0;
-# if defined(__AVX512F__)
-    for(; i<(len-15); i+=16)
-        _mm512_storeu_ps(c+i, _mm512_mul_ps(_mm512_loadu_ps(a+i), _mm512_loadu_ps(b+i)));
-# endif
-# if defined(__AVX__) && defined(__AVX2__)
-    for(; i<(len-7); i+=8)
-        _mm256_storeu_ps(c+i, _mm256_mul_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i)));
-# endif
-# if defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(; i<(len-3); i+=4)
-        _mm_storeu_ps(c+i, _mm_mul_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i)));
-# endif
-    for(;i<len; i++) /* The residual (if len was not divisable by the step size): */
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_svvmul_avx512(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_svvmul_avx2(a+i, b+i, len-i, c+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_svvmul_sse3(a+i, b+i, len-i, c+i);
+    for(; i<len; i++) /* The residual (if len was not divisable by the step size): */
         c[i] = a[i] * b[i];
 #elif defined(NDEBUG)
     int i;
@@ -1136,43 +1422,12 @@ void utility_cvvmul
 #elif defined(SAF_ENABLE_SIMD)
     int i;
     float* sa, *sb, *sc;
+    SAF_SIMD_LEVELS level;
     sa = (float*)a; sb = (float*)b; sc = (float*)c;
-# if (defined(__AVX__) && defined(__AVX2__)) || defined(__AVX512F__) /* I couldn't figure out an alternative for addsub with AVX-512... */
-    __m256i permute_ri = _mm256_set_epi32(6, 7, 4, 5, 2, 3, 0, 1);
-    for(i=0; i<(len-3); i+=4){
-        /* Load only the real parts of a */
-        __m256 src1 = _mm256_moveldup_ps(_mm256_loadu_ps(sa+2*i)/*|a1|b1|a2|b2|a3|b3|a4|b4|*/); /*|a1|a1|a2|a2|a3|a3|a4|a4|*/
-        /* Load real+imag parts of b */
-        __m256 src2 = _mm256_loadu_ps(sb+2*i); /*|c1|d1|c2|d2|c3|d3|c4|d4|*/
-        /* Multiply together */
-        __m256 tmp1 = _mm256_mul_ps(src1, src2);
-        /* Swap the real+imag parts of b to be imag+real instead: */
-        __m256 b1 = _mm256_permutevar8x32_ps(src2, permute_ri);
-        /* Load only the imag parts of a */
-        src1 = _mm256_movehdup_ps(_mm256_loadu_ps(sa+2*i)/*|a1|b1|a2|b2|a3|b3|a4|b4|*/); /*|b1|b1|b2|b2|b3|b3|b4|b4|*/
-        /* Multiply together */
-        __m256 tmp2 = _mm256_mul_ps(src1, b1);
-        /* Add even indices, subtract odd indices */
-        _mm256_storeu_ps(sc+2*i, _mm256_addsub_ps(tmp1, tmp2));
-    }
-# elif defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    for(i=0; i<(len-1); i+=2){
-        /* Load only the real parts of a */
-        __m128 src1 = _mm_moveldup_ps(_mm_loadu_ps(sa+2*i)/*|a1|b1|a2|b2|*/); /*|a1|a1|a2|a2|*/
-        /* Load real+imag parts of b */
-        __m128 src2 = _mm_loadu_ps(sb+2*i); /*|c1|d1|c2|d2|*/
-        /* Multiply together */
-        __m128 tmp1 = _mm_mul_ps(src1, src2);
-        /* Swap the real+imag parts of b to be imag+real instead: */
-        __m128 b1 = _mm_shuffle_ps(src2, src2, _MM_SHUFFLE(2, 3, 0, 1));
-        /* Load only the imag parts of a */
-        src1 = _mm_movehdup_ps(_mm_loadu_ps(sa+2*i)/*|a1|b1|a2|b2|*/); /*|b1|b1|b2|b2|*/
-        /* Multiply together */
-        __m128 tmp2 = _mm_mul_ps(src1, b1);
-        /* Add even indices, subtract odd indices */
-        _mm_storeu_ps(sc+2*i, _mm_addsub_ps(tmp1, tmp2));
-    }
-# endif
+    level = saf_getSIMDLevel();
+    i = 0;
+    if(level>=SAF_SIMD_AVX2) i += saf_simd_cvvmul_avx2(sa+2*i, sb+2*i, len-i, sc+2*i);
+    if(level>=SAF_SIMD_SSE3) i += saf_simd_cvvmul_sse3(sa+2*i, sb+2*i, len-i, sc+2*i);
     for(;i<len; i++){ /* The residual (if len was not divisable by the step size): */
         sc[2*i]   = sa[2*i] * sb[2*i]   - sa[2*i+1] * sb[2*i+1];
         sc[2*i+1] = sa[2*i] * sb[2*i+1] + sa[2*i+1] * sb[2*i];
@@ -1200,6 +1455,160 @@ void utility_cvvmul
 }
 
 
+/* ========================================================================== */
+/*                 Vector-Vector Multiply-Accumulate (?vvmac)                 */
+/* ========================================================================== */
+
+/** Number of bins processed at a time by utility_cvvmulsum(), such that the
+ *  partial sums remain in the L1 cache while accumulating over the products */
+#define SAF_VECLIB_MULSUM_BLOCK_SIZE ( 256 )
+
+/** Number of elements scaled at a time (on the stack) by the Accelerate and
+ *  IPP variants of utility_crvvmac() */
+#define SAF_VECLIB_CRVVMAC_BLOCK_SIZE ( 256 )
+
+void utility_cvvmac
+(
+    const float_complex* a,
+    const float_complex* b,
+    const int len,
+    CONJ_FLAG flag,
+    float_complex* c
+)
+{
+#if defined(SAF_USE_APPLE_ACCELERATE)
+    float* sa, *sb, *sc;
+    sa = (float*)a; sb = (float*)b; sc = (float*)c;
+    if(flag==CONJ){
+        /* Real part: c_re += a_re*b_re + a_im*b_im */
+        vDSP_vma(sa, 2, sb, 2, sc, 2, sc, 2, (vDSP_Length)len);
+        vDSP_vma(sa+1, 2, sb+1, 2, sc, 2, sc, 2, (vDSP_Length)len);
+        /* Imaginary part: c_im += a_im*b_re - a_re*b_im */
+        vDSP_vma(sa+1, 2, sb, 2, sc+1, 2, sc+1, 2, (vDSP_Length)len);
+        vDSP_vmsb(sa, 2, sb+1, 2, sc+1, 2, sc+1, 2, (vDSP_Length)len); /* (a_re*b_im - c_im) */
+        vDSP_vneg(sc+1, 2, sc+1, 2, (vDSP_Length)len);
+    }
+    else{
+        /* Real part: c_re += a_re*b_re - a_im*b_im */
+        vDSP_vma(sa, 2, sb, 2, sc, 2, sc, 2, (vDSP_Length)len);
+        vDSP_vmsb(sa+1, 2, sb+1, 2, sc, 2, sc, 2, (vDSP_Length)len); /* (a_im*b_im - c_re) */
+        vDSP_vneg(sc, 2, sc, 2, (vDSP_Length)len);
+        /* Imaginary part: c_im += a_re*b_im + a_im*b_re */
+        vDSP_vma(sa, 2, sb+1, 2, sc+1, 2, sc+1, 2, (vDSP_Length)len);
+        vDSP_vma(sa+1, 2, sb, 2, sc+1, 2, sc+1, 2, (vDSP_Length)len);
+    }
+#else
+    int i;
+    float* sa, *sb, *sc;
+# if defined(SAF_ENABLE_SIMD)
+    SAF_SIMD_LEVELS level;
+# endif
+    sa = (float*)a; sb = (float*)b; sc = (float*)c;
+    i = 0;
+# if defined(SAF_USE_INTEL_IPP)
+    if(flag==NO_CONJ){
+        ippsAddProduct_32fc((Ipp32fc*)a, (Ipp32fc*)b, (Ipp32fc*)c, len);
+        return;
+    }
+# endif
+# if defined(SAF_ENABLE_SIMD)
+    level = saf_getSIMDLevel();
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_cvvmac_avx512(sa+2*i, sb+2*i, len-i, flag==CONJ, sc+2*i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_cvvmac_avx2(sa+2*i, sb+2*i, len-i, flag==CONJ, sc+2*i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_cvvmac_sse3(sa+2*i, sb+2*i, len-i, flag==CONJ, sc+2*i);
+# endif
+    if(flag==CONJ){
+        for(; i<len; i++){ /* The residual (if len was not divisable by the step size): */
+            sc[2*i]   += sa[2*i] * sb[2*i]   + sa[2*i+1] * sb[2*i+1];
+            sc[2*i+1] += sa[2*i+1] * sb[2*i] - sa[2*i] * sb[2*i+1];
+        }
+    }
+    else{
+        for(; i<len; i++){ /* The residual (if len was not divisable by the step size): */
+            sc[2*i]   += sa[2*i] * sb[2*i]   - sa[2*i+1] * sb[2*i+1];
+            sc[2*i+1] += sa[2*i] * sb[2*i+1] + sa[2*i+1] * sb[2*i];
+        }
+    }
+#endif
+}
+
+void utility_cvvmulsum
+(
+    const float_complex* a,
+    const int strideA,
+    const float_complex* b,
+    const int strideB,
+    const int K,
+    const int len,
+    float_complex* c
+)
+{
+    int j, k, n;
+
+    if(K<1){
+        memset(c, 0, len*sizeof(float_complex));
+        return;
+    }
+    for(j=0; j<len; j+=SAF_VECLIB_MULSUM_BLOCK_SIZE){
+        n = SAF_MIN(len-j, SAF_VECLIB_MULSUM_BLOCK_SIZE);
+        utility_cvvmul(&a[j], &b[j], n, &c[j]);
+        for(k=1; k<K; k++)
+            utility_cvvmac(&a[k*strideA+j], &b[k*strideB+j], n, NO_CONJ, &c[j]);
+    }
+}
+
+void utility_crvvmac
+(
+    const float_complex* a,
+    const float* b,
+    const float s,
+    const int len,
+    float_complex* c
+)
+{
+#if defined(SAF_USE_APPLE_ACCELERATE)
+    int i, n;
+    float* sa, *sc;
+    float sb[SAF_VECLIB_CRVVMAC_BLOCK_SIZE];
+    sa = (float*)a; sc = (float*)c;
+    for(i=0; i<len; i+=SAF_VECLIB_CRVVMAC_BLOCK_SIZE){
+        n = SAF_MIN(len-i, SAF_VECLIB_CRVVMAC_BLOCK_SIZE);
+        vDSP_vsmul(b+i, 1, &s, sb, 1, (vDSP_Length)n);
+        /* The real and imaginary parts are both scaled by the (scaled) real vector */
+        vDSP_vma(sa+2*i, 2, sb, 1, sc+2*i, 2, sc+2*i, 2, (vDSP_Length)n);
+        vDSP_vma(sa+2*i+1, 2, sb, 1, sc+2*i+1, 2, sc+2*i+1, 2, (vDSP_Length)n);
+    }
+#elif defined(SAF_USE_INTEL_IPP)
+    int i, n;
+    float sb[SAF_VECLIB_CRVVMAC_BLOCK_SIZE];
+    float_complex sab[SAF_VECLIB_CRVVMAC_BLOCK_SIZE];
+    for(i=0; i<len; i+=SAF_VECLIB_CRVVMAC_BLOCK_SIZE){
+        n = SAF_MIN(len-i, SAF_VECLIB_CRVVMAC_BLOCK_SIZE);
+        ippsMulC_32f(b+i, s, sb, n);
+        ippsMul_32f32fc(sb, (Ipp32fc*)(a+i), (Ipp32fc*)sab, n);
+        ippsAdd_32fc_I((Ipp32fc*)sab, (Ipp32fc*)(c+i), n);
+    }
+#else
+    int i;
+    float* sa, *sc;
+# if defined(SAF_ENABLE_SIMD)
+    SAF_SIMD_LEVELS level;
+# endif
+    sa = (float*)a; sc = (float*)c;
+    i = 0;
+# if defined(SAF_ENABLE_SIMD)
+    level = saf_getSIMDLevel();
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_crvvmac_avx512(sa+2*i, b+i, s, len-i, sc+2*i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_crvvmac_avx2(sa+2*i, b+i, s, len-i, sc+2*i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_crvvmac_sse3(sa+2*i, b+i, s, len-i, sc+2*i);
+# endif
+    for(; i<len; i++){ /* The residual (if len was not divisable by the step size): */
+        sc[2*i]   += s * (sa[2*i] * b[i]);
+        sc[2*i+1] += s * (sa[2*i+1] * b[i]);
+    }
+#endif
+}
+
 /* ========================================================================== */
 /*                     Vector-Vector Dot Product (?vvdot)                     */
 /* ========================================================================== */
@@ -1374,20 +1783,13 @@ void utility_svsadd
     vDSP_vsadd(a, 1, s, c, 1, (vDSP_Length)len);
 #elif defined(SAF_ENABLE_SIMD)
     int i;
-# if defined(__AVX512F__)
-    __m512 s16 = _mm512_set1_ps(s[0]);
-    for(i=0; i<(len-15); i+=16)
-        _mm512_storeu_ps(c+i, _mm512_add_ps(_mm512_loadu_ps(a+i), s16));
-# elif defined(__AVX__) && defined(__AVX2__)
-    __m256 s8 = _mm256_set1_ps(s[0]);
-    for(i=0; i<(len-7); i+=8)
-        _mm256_storeu_ps(c+i, _mm256_add_ps(_mm256_loadu_ps(a+i), s8));
-# elif defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    __m128 s4 = _mm_load_ps1(s);
-    for(i=0; i<(len-3); i+=4)
-        _mm_storeu_ps(c+i, _mm_add_ps(_mm_loadu_ps(a+i), s4));
-# endif
-    for(;i<len; i++) /* The residual (if len was not divisable by the step size): */
+    SAF_SIMD_LEVELS level;
+    level = saf_getSIMDLevel();
+    i = 0;
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_svsadd_avx512(a+i, s[0], len-i, c+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_svsadd_avx2(a+i, s[0], len-i, c+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_svsadd_sse3(a+i, s[0], len-i, c+i);
+    for(; i<len; i++) /* The residual (if len was not divisable by the step size): */
         c[i] = a[i] + s[0];
 #else
     int i;
@@ -1417,20 +1819,13 @@ void utility_svssub
     vDSP_vsadd(a, 1, &inv_s, c, 1, (vDSP_Length)len);
 #elif defined(SAF_ENABLE_SIMD)
     int i;
-# if defined(__AVX512F__)
-    __m512 s16 = _mm512_set1_ps(s[0]);
-    for(i=0; i<(len-15); i+=16)
-        _mm512_storeu_ps(c+i, _mm512_sub_ps(_mm512_loadu_ps(a+i), s16));
-# elif defined(__AVX__) && defined(__AVX2__)
-    __m256 s8 = _mm256_set1_ps(s[0]);
-    for(i=0; i<(len-7); i+=8)
-        _mm256_storeu_ps(c+i, _mm256_sub_ps(_mm256_loadu_ps(a+i), s8));
-# elif defined(__SSE__) && defined(__SSE2__) && defined(__SSE3__)
-    __m128 s4 = _mm_load_ps1(s);
-    for(i=0; i<(len-3); i+=4)
-        _mm_storeu_ps(c+i, _mm_sub_ps(_mm_loadu_ps(a+i), s4));
-# endif
-    for(;i<len; i++) /* The residual (if len was not divisable by the step size): */
+    SAF_SIMD_LEVELS level;
+    level = saf_getSIMDLevel();
+    i = 0;
+    if(level>=SAF_SIMD_AVX512) i += saf_simd_svssub_avx512(a+i, s[0], len-i, c+i);
+    if(level>=SAF_SIMD_AVX2)   i += saf_simd_svssub_avx2(a+i, s[0], len-i, c+i);
+    if(level>=SAF_SIMD_SSE3)   i += saf_simd_svssub_sse3(a+i, s[0], len-i, c+i);
+    for(; i<len; i++) /* The residual (if len was not divisable by the step size): */
         c[i] = a[i] - s[0];
 #else
     int i;
@@ -1613,15 +2008,31 @@ void utility_ssvd_create(void ** const phWork, int maxDim1, int maxDim2)
 {
     *phWork = malloc1d(sizeof(utility_ssvd_data));
     utility_ssvd_data *h = (utility_ssvd_data*)(*phWork);
+    veclib_int m, n, lda, ldu, ldvt, lwork;
+    float wkopt;
+#if defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
+    veclib_int info;
+#endif
 
     h->maxDim1 = maxDim1;
     h->maxDim2 = maxDim2;
-    h->currentWorkSize = 0;
     h->a = malloc1d(maxDim1*maxDim2*sizeof(float));
     h->s = malloc1d(SAF_MIN(maxDim2,maxDim1)*sizeof(float));
     h->u = malloc1d(maxDim1*maxDim1*sizeof(float));
     h->vt = malloc1d(maxDim2*maxDim2*sizeof(float));
-    h->work = NULL;
+
+    /* Query the "work" memory required for the largest problem, so that
+     * utility_ssvd() does not need to reallocate it */
+    m = lda = ldu = maxDim1; n = ldvt = maxDim2;
+    lwork = -1;
+    wkopt = 0.0f;
+#if defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
+    sgesvd_( "A", "A", &m, &n, h->a, &lda, h->s, h->u, &ldu, h->vt, &ldvt, &wkopt, &lwork, &info );
+#elif defined(SAF_VECLIB_USE_LAPACKE_INTERFACE)
+    LAPACKE_sgesvd_work(CblasColMajor, 'A', 'A', m, n, h->a, lda, h->s, h->u, ldu, h->vt, ldvt, &wkopt, lwork);
+#endif
+    h->currentWorkSize = (veclib_int)wkopt;
+    h->work = h->currentWorkSize>0 ? malloc1d(h->currentWorkSize*sizeof(float)) : NULL;
 }
 
 void utility_ssvd_destroy(void ** const phWork)
@@ -1759,15 +2170,34 @@ void utility_csvd_create(void ** const phWork, int maxDim1, int maxDim2)
     *phWork = malloc1d(sizeof(utility_csvd_data));
     utility_csvd_data *h = (utility_csvd_data*)(*phWork);
 
+    veclib_int m, n, lda, ldu, ldvt, lwork;
+    float_complex wkopt;
+#if defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
+    veclib_int info;
+#endif
+
     h->maxDim1 = maxDim1;
     h->maxDim2 = maxDim2;
-    h->currentWorkSize = 0;
     h->a = malloc1d(maxDim1*maxDim2*sizeof(float_complex));
     h->s = malloc1d(SAF_MIN(maxDim2,maxDim1)*sizeof(float));
     h->u = malloc1d(maxDim1*maxDim1*sizeof(float_complex));
     h->vt = malloc1d(maxDim2*maxDim2*sizeof(float_complex));
     h->rwork = malloc1d(maxDim1*SAF_MAX(1, 5*SAF_MIN(maxDim2,maxDim1))*sizeof(float));
-    h->work = NULL;
+
+    /* Query the "work" memory required for the largest problem, so that
+     * utility_csvd() does not need to reallocate it */
+    m = lda = ldu = maxDim1; n = ldvt = maxDim2;
+    lwork = -1;
+    wkopt = cmplxf(0.0f, 0.0f);
+#if defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
+    cgesvd_( "A", "A", &m, &n, (veclib_float_complex*)h->a, &lda, h->s, (veclib_float_complex*)h->u, &ldu,
+            (veclib_float_complex*)h->vt, &ldvt, (veclib_float_complex*)&wkopt, &lwork, h->rwork, &info );
+#elif defined(SAF_VECLIB_USE_LAPACKE_INTERFACE)
+    LAPACKE_cgesvd_work(CblasColMajor, 'A', 'A', m, n, (veclib_float_complex*)h->a, lda, h->s, (veclib_float_complex*)h->u, ldu,
+                        (veclib_float_complex*)h->vt, ldvt, (veclib_float_complex*)&wkopt, lwork, h->rwork);
+#endif
+    h->currentWorkSize = (veclib_int)(crealf(wkopt)+0.01f);
+    h->work = h->currentWorkSize>0 ? malloc1d(h->currentWorkSize*sizeof(float_complex)) : NULL;
 }
 
 void utility_csvd_destroy(void ** const phWork)
@@ -1910,6 +2340,254 @@ void utility_csvd
         utility_csvd_destroy((void**)&h);
 }
 
+/**
+ * One-sided (Hestenes) Jacobi singular value decomposition of a small matrix,
+ * A = U S V^H, with the singular values in decending order (as in
+ * utility_csvd())
+ *
+ * @returns 0 if successful, otherwise 1 (i.e. if the iterations did not
+ *          converge, e.g. due to NaNs/Infs in the input)
+ */
+static int utility_csvd_jacobi
+(
+    const float_complex* A,
+    const int dim1,
+    const int dim2,
+    float_complex* U,
+    float_complex* S,
+    float_complex* V,
+    float* sing
+)
+{
+    int i, j, k, p, q, m, n, sweep, rotated, trans, idx[SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double ar[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double ai[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double vr[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double vi[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double ur[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double ui[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double s[SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double total, alpha, beta, gr, gi, absg, er, ei, zeta, t, c, sn, xr, xi, yr, yi, nrm, smax;
+
+    /* The columns of the tall (m >= n) matrix are orthogonalised; so for wide
+     * matrices, A^H = V S U^H is decomposed instead */
+    trans = dim1 < dim2;
+    m = trans ? dim2 : dim1;
+    n = trans ? dim1 : dim2;
+    total = 0.0;
+    for(i=0; i<m; i++){
+        for(j=0; j<n; j++){
+            ar[i][j] = trans ? (double)crealf(A[j*dim2+i]) : (double)crealf(A[i*dim2+j]);
+            ai[i][j] = trans ? -(double)cimagf(A[j*dim2+i]) : (double)cimagf(A[i*dim2+j]);
+            total += ar[i][j]*ar[i][j] + ai[i][j]*ai[i][j];
+        }
+    }
+    for(i=0; i<n; i++){
+        for(j=0; j<n; j++){
+            vr[i][j] = i==j ? 1.0 : 0.0;
+            vi[i][j] = 0.0;
+        }
+    }
+
+    for(sweep=0; sweep<50; sweep++){
+        rotated = 0;
+        for(p=0; p<n-1; p++){
+            for(q=p+1; q<n; q++){
+                /* alpha = |a_p|^2, beta = |a_q|^2, g = a_p^H a_q */
+                alpha = beta = gr = gi = 0.0;
+                for(k=0; k<m; k++){
+                    alpha += ar[k][p]*ar[k][p] + ai[k][p]*ai[k][p];
+                    beta  += ar[k][q]*ar[k][q] + ai[k][q]*ai[k][q];
+                    gr    += ar[k][p]*ar[k][q] + ai[k][p]*ai[k][q];
+                    gi    += ar[k][p]*ai[k][q] - ai[k][p]*ar[k][q];
+                }
+                absg = sqrt(gr*gr + gi*gi);
+                if(absg <= 1e-12*sqrt(alpha*beta) || absg <= 1e-24*total)
+                    continue;
+                rotated = 1;
+
+                /* g = |g| e, and the rotation of [a_p, a_q conj(e)] which makes them orthogonal */
+                er = gr/absg;
+                ei = gi/absg;
+                zeta = (beta - alpha)/(2.0*absg);
+                t = 1.0/(fabs(zeta) + sqrt(zeta*zeta + 1.0));
+                t = zeta < 0.0 ? -t : t;
+                c = 1.0/sqrt(t*t + 1.0);
+                sn = t*c;
+                for(k=0; k<m; k++){
+                    xr = ar[k][p]; xi = ai[k][p];
+                    yr = ar[k][q]*er + ai[k][q]*ei;  /* y conj(e) */
+                    yi = ai[k][q]*er - ar[k][q]*ei;
+                    ar[k][p] = c*xr - sn*yr;  ai[k][p] = c*xi - sn*yi;
+                    ar[k][q] = sn*xr + c*yr;  ai[k][q] = sn*xi + c*yi;
+                }
+                for(k=0; k<n; k++){
+                    xr = vr[k][p]; xi = vi[k][p];
+                    yr = vr[k][q]*er + vi[k][q]*ei;
+                    yi = vi[k][q]*er - vr[k][q]*ei;
+                    vr[k][p] = c*xr - sn*yr;  vi[k][p] = c*xi - sn*yi;
+                    vr[k][q] = sn*xr + c*yr;  vi[k][q] = sn*xi + c*yi;
+                }
+            }
+        }
+        if(!rotated)
+            break;
+    }
+    if(sweep==50)
+        return 1;
+
+    /* singular values are the column norms; sorted in decending order */
+    smax = 0.0;
+    for(j=0; j<n; j++){
+        s[j] = 0.0;
+        for(k=0; k<m; k++)
+            s[j] += ar[k][j]*ar[k][j] + ai[k][j]*ai[k][j];
+        s[j] = sqrt(s[j]);
+        smax = SAF_MAX(smax, s[j]);
+        idx[j] = j;
+    }
+    for(i=1; i<n; i++){
+        k = idx[i];
+        for(j=i; j>0 && s[idx[j-1]] < s[k]; j--)
+            idx[j] = idx[j-1];
+        idx[j] = k;
+    }
+
+    /* left singular vectors: the normalised columns, and then any remaining
+     * columns (rank deficient, or m > n) completed with Gram-Schmidt */
+    if((!trans && U!=NULL) || (trans && V!=NULL)){
+        for(j=0; j<n; j++){
+            k = idx[j];
+            nrm = s[k] > 1e-7*smax ? 1.0/s[k] : 0.0;
+            for(i=0; i<m; i++){
+                ur[i][j] = ar[i][k]*nrm;
+                ui[i][j] = ai[i][k]*nrm;
+            }
+        }
+        for(j=0; j<m; j++){
+            if(j<n && s[idx[j]] > 1e-7*smax)
+                continue;
+            for(k=0; k<m; k++){
+                /* e_k minus its projections onto the previous columns (twice, for stability) */
+                for(i=0; i<m; i++){
+                    ur[i][j] = i==k ? 1.0 : 0.0;
+                    ui[i][j] = 0.0;
+                }
+                for(sweep=0; sweep<2; sweep++){
+                    for(p=0; p<j; p++){
+                        gr = gi = 0.0;
+                        for(i=0; i<m; i++){
+                            gr += ur[i][p]*ur[i][j] + ui[i][p]*ui[i][j];
+                            gi += ur[i][p]*ui[i][j] - ui[i][p]*ur[i][j];
+                        }
+                        for(i=0; i<m; i++){
+                            ur[i][j] -= gr*ur[i][p] - gi*ui[i][p];
+                            ui[i][j] -= gr*ui[i][p] + gi*ur[i][p];
+                        }
+                    }
+                }
+                nrm = 0.0;
+                for(i=0; i<m; i++)
+                    nrm += ur[i][j]*ur[i][j] + ui[i][j]*ui[i][j];
+                nrm = sqrt(nrm);
+                if(nrm > 0.5/sqrt((double)m)) /* (at least one e_k leaves >= 1/sqrt(m)) */
+                    break;
+            }
+            for(i=0; i<m; i++){
+                ur[i][j] /= nrm;
+                ui[i][j] /= nrm;
+            }
+        }
+    }
+
+    /* output, swapping U and V back for wide matrices */
+    if(sing!=NULL)
+        for(j=0; j<n; j++)
+            sing[j] = (float)s[idx[j]];
+    if(S!=NULL){
+        memset(S, 0, dim1*dim2*sizeof(float_complex));
+        for(j=0; j<n; j++)
+            S[j*dim2+j] = cmplxf((float)s[idx[j]], 0.0f);
+    }
+    if(!trans){
+        if(U!=NULL)
+            for(i=0; i<m; i++)
+                for(j=0; j<m; j++)
+                    U[i*m+j] = cmplxf((float)ur[i][j], (float)ui[i][j]);
+        if(V!=NULL)
+            for(i=0; i<n; i++)
+                for(j=0; j<n; j++)
+                    V[i*n+j] = cmplxf((float)vr[i][idx[j]], (float)vi[i][idx[j]]);
+    }
+    else{
+        if(U!=NULL)
+            for(i=0; i<n; i++)
+                for(j=0; j<n; j++)
+                    U[i*n+j] = cmplxf((float)vr[i][idx[j]], (float)vi[i][idx[j]]);
+        if(V!=NULL)
+            for(i=0; i<m; i++)
+                for(j=0; j<m; j++)
+                    V[i*m+j] = cmplxf((float)ur[i][j], (float)ui[i][j]);
+    }
+    return 0;
+}
+
+void utility_csvd_batch
+(
+    void* const hWork,
+    const float_complex* A,
+    const int dim1,
+    const int dim2,
+    const int nBatch,
+    float_complex* U,
+    float_complex* S,
+    float_complex* V,
+    float* sing
+)
+{
+    void* h;
+    int i;
+
+    /* Large matrices are passed to LAPACK (with one work struct for the whole batch) */
+    if(dim1>SAF_VECLIB_BATCH_JACOBI_MAX_DIM || dim2>SAF_VECLIB_BATCH_JACOBI_MAX_DIM){
+        if(hWork==NULL)
+            utility_csvd_create(&h, dim1, dim2);
+        else
+            h = hWork;
+        for(i=0; i<nBatch; i++){
+            utility_csvd(h, &A[i*dim1*dim2], dim1, dim2,
+                         U==NULL ? NULL : &U[i*dim1*dim1],
+                         S==NULL ? NULL : &S[i*dim1*dim2],
+                         V==NULL ? NULL : &V[i*dim2*dim2],
+                         sing==NULL ? NULL : &sing[i*SAF_MIN(dim1, dim2)]);
+        }
+        if(hWork == NULL)
+            utility_csvd_destroy(&h);
+        return;
+    }
+
+    for(i=0; i<nBatch; i++){
+        if(utility_csvd_jacobi(&A[i*dim1*dim2], dim1, dim2,
+                               U==NULL ? NULL : &U[i*dim1*dim1],
+                               S==NULL ? NULL : &S[i*dim1*dim2],
+                               V==NULL ? NULL : &V[i*dim2*dim2],
+                               sing==NULL ? NULL : &sing[i*SAF_MIN(dim1, dim2)]) != 0){
+            /* failed to converge and find the singular values */
+            if(U!=NULL)
+                memset(&U[i*dim1*dim1], 0, dim1*dim1*sizeof(float_complex));
+            if(S!=NULL)
+                memset(&S[i*dim1*dim2], 0, dim1*dim2*sizeof(float_complex));
+            if(V!=NULL)
+                memset(&V[i*dim2*dim2], 0, dim2*dim2*sizeof(float_complex));
+            if(sing!=NULL)
+                memset(&sing[i*SAF_MIN(dim1, dim2)], 0, SAF_MIN(dim1, dim2)*sizeof(float));
+#ifndef NDEBUG
+            saf_print_warning("Could not compute SVD in utility_csvd_batch(). Output matrices/vectors have been zeroed.");
+#endif
+        }
+    }
+}
+
 
 /* ========================================================================== */
 /*                 Symmetric Eigenvalue Decomposition (?seig)                 */
@@ -2067,12 +2745,28 @@ void utility_cseig_create(void ** const phWork, int maxDim)
 {
     *phWork = malloc1d(sizeof(utility_cseig_data));
     utility_cseig_data *h = (utility_cseig_data*)(*phWork);
+    veclib_int n, lda, lwork;
+    float_complex wkopt;
+#if defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
+    veclib_int info;
+#endif
 
     h->maxDim = maxDim;
-    h->currentWorkSize = SAF_MAX(1, 2*maxDim-1);
     h->rwork = malloc1d((3*maxDim-2)*sizeof(float));
     h->w = malloc1d(maxDim*sizeof(float));
     h->a = malloc1d(maxDim*maxDim*sizeof(float_complex));
+
+    /* Query the "work" memory required for the largest problem, so that
+     * utility_cseig() does not need to reallocate it */
+    n = lda = maxDim;
+    lwork = -1;
+    wkopt = cmplxf(0.0f, 0.0f);
+#if defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
+    cheev_( "Vectors", "Upper", &n, (veclib_float_complex*)h->a, &lda, h->w, (veclib_float_complex*)&wkopt, &lwork, h->rwork, &info );
+#elif defined(SAF_VECLIB_USE_LAPACKE_INTERFACE)
+    LAPACKE_cheev_work(CblasColMajor, 'V', 'U', n, (veclib_float_complex*)h->a, lda, h->w, (veclib_float_complex*)&wkopt, lwork, h->rwork);
+#endif
+    h->currentWorkSize = SAF_MAX(SAF_MAX(1, 2*maxDim-1), (veclib_int)crealf(wkopt));
     h->work = malloc1d(h->currentWorkSize*sizeof(float_complex));
 }
 
@@ -2213,6 +2907,177 @@ void utility_cseig
         utility_cseig_destroy((void**)&h);
 }
 
+/**
+ * Cyclic Jacobi eigenvalue decomposition of a small Hermitian matrix (only the
+ * upper triangle of A is referenced), with the eigen values in ascending order
+ *
+ * @returns 0 if successful, otherwise 1 (i.e. if the iterations did not
+ *          converge, e.g. due to NaNs/Infs in the input)
+ */
+static int utility_cseig_jacobi
+(
+    const float_complex* A,
+    const int dim,
+    int sortDecFLAG,
+    float_complex* V,
+    float_complex* D,
+    float* eig
+)
+{
+    int i, j, k, p, q, sweep, idx[SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double ar[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double ai[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double vr[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double vi[SAF_VECLIB_BATCH_JACOBI_MAX_DIM][SAF_VECLIB_BATCH_JACOBI_MAX_DIM];
+    double off, total, absb, er, ei, theta, t, c, sn, xr, xi, yr, yi;
+
+    /* Hermitian copy of the upper triangle, and V = I */
+    total = 0.0;
+    for(i=0; i<dim; i++){
+        for(j=i; j<dim; j++){
+            ar[i][j] = (double)crealf(A[i*dim+j]);
+            ai[i][j] = i==j ? 0.0 : (double)cimagf(A[i*dim+j]);
+            ar[j][i] = ar[i][j];
+            ai[j][i] = -ai[i][j];
+            total += (i==j ? 1.0 : 2.0) * (ar[i][j]*ar[i][j] + ai[i][j]*ai[i][j]);
+        }
+        for(j=0; j<dim; j++){
+            vr[i][j] = i==j ? 1.0 : 0.0;
+            vi[i][j] = 0.0;
+        }
+    }
+
+    for(sweep=0; sweep<50; sweep++){
+        off = 0.0;
+        for(p=0; p<dim-1; p++)
+            for(q=p+1; q<dim; q++)
+                off += ar[p][q]*ar[p][q] + ai[p][q]*ai[p][q];
+        if(off <= 1e-24*total)
+            break;
+
+        for(p=0; p<dim-1; p++){
+            for(q=p+1; q<dim; q++){
+                absb = sqrt(ar[p][q]*ar[p][q] + ai[p][q]*ai[p][q]);
+                if(absb == 0.0)
+                    continue;
+
+                /* a_pq = |a_pq| e, and the rotation which zeros it */
+                er = ar[p][q]/absb;
+                ei = ai[p][q]/absb;
+                theta = (ar[q][q] - ar[p][p])/(2.0*absb);
+                t = 1.0/(fabs(theta) + sqrt(theta*theta + 1.0));
+                t = theta < 0.0 ? -t : t;
+                c = 1.0/sqrt(t*t + 1.0);
+                sn = t*c;
+
+                /* A = A J, V = V J; where the columns of J are [c, -s conj(e)] and [s, c conj(e)] */
+                for(k=0; k<dim; k++){
+                    xr = ar[k][p]; xi = ai[k][p];
+                    yr = ar[k][q]*er + ai[k][q]*ei;  /* y conj(e) */
+                    yi = ai[k][q]*er - ar[k][q]*ei;
+                    ar[k][p] = c*xr - sn*yr;  ai[k][p] = c*xi - sn*yi;
+                    ar[k][q] = sn*xr + c*yr;  ai[k][q] = sn*xi + c*yi;
+
+                    xr = vr[k][p]; xi = vi[k][p];
+                    yr = vr[k][q]*er + vi[k][q]*ei;
+                    yi = vi[k][q]*er - vr[k][q]*ei;
+                    vr[k][p] = c*xr - sn*yr;  vi[k][p] = c*xi - sn*yi;
+                    vr[k][q] = sn*xr + c*yr;  vi[k][q] = sn*xi + c*yi;
+                }
+
+                /* A = J^H A */
+                for(k=0; k<dim; k++){
+                    xr = ar[p][k]; xi = ai[p][k];
+                    yr = ar[q][k]*er - ai[q][k]*ei;  /* y e */
+                    yi = ai[q][k]*er + ar[q][k]*ei;
+                    ar[p][k] = c*xr - sn*yr;  ai[p][k] = c*xi - sn*yi;
+                    ar[q][k] = sn*xr + c*yr;  ai[q][k] = sn*xi + c*yi;
+                }
+                ar[p][q] = ai[p][q] = ar[q][p] = ai[q][p] = 0.0;
+                ai[p][p] = ai[q][q] = 0.0;
+            }
+        }
+    }
+    if(sweep==50)
+        return 1;
+
+    /* sort the eigen values in ascending order (as in utility_cseig()) */
+    for(i=0; i<dim; i++)
+        idx[i] = i;
+    for(i=1; i<dim; i++){
+        k = idx[i];
+        for(j=i; j>0 && ar[idx[j-1]][idx[j-1]] > ar[k][k]; j--)
+            idx[j] = idx[j-1];
+        idx[j] = k;
+    }
+
+    /* output, reversing the order if sortDecFlag==1 */
+    if(D!=NULL)
+        memset(D, 0, dim*dim*sizeof(float_complex));
+    for(i=0; i<dim; i++){
+        k = sortDecFLAG ? idx[dim-i-1] : idx[i];
+        if(D!=NULL)
+            D[i*dim+i] = cmplxf((float)ar[k][k], 0.0f);
+        if(eig!=NULL)
+            eig[i] = (float)ar[k][k];
+        if(V!=NULL)
+            for(j=0; j<dim; j++)
+                V[j*dim+i] = cmplxf((float)vr[j][k], (float)vi[j][k]);
+    }
+    return 0;
+}
+
+void utility_cseig_batch
+(
+    void* const hWork,
+    const float_complex* A,
+    const int dim,
+    const int nBatch,
+    int sortDecFLAG,
+    float_complex* V,
+    float_complex* D,
+    float* eig
+)
+{
+    void* h;
+    int i;
+
+    /* Large matrices are passed to LAPACK (with one work struct for the whole batch) */
+    if(dim>SAF_VECLIB_BATCH_JACOBI_MAX_DIM){
+        if(hWork==NULL)
+            utility_cseig_create(&h, dim);
+        else
+            h = hWork;
+        for(i=0; i<nBatch; i++){
+            utility_cseig(h, &A[i*dim*dim], dim, sortDecFLAG,
+                          V==NULL ? NULL : &V[i*dim*dim],
+                          D==NULL ? NULL : &D[i*dim*dim],
+                          eig==NULL ? NULL : &eig[i*dim]);
+        }
+        if(hWork == NULL)
+            utility_cseig_destroy(&h);
+        return;
+    }
+
+    for(i=0; i<nBatch; i++){
+        if(utility_cseig_jacobi(&A[i*dim*dim], dim, sortDecFLAG,
+                                V==NULL ? NULL : &V[i*dim*dim],
+                                D==NULL ? NULL : &D[i*dim*dim],
+                                eig==NULL ? NULL : &eig[i*dim]) != 0){
+            /* failed to converge and find the eigenvalues */
+            if(V!=NULL)
+                memset(&V[i*dim*dim], 0, dim*dim*sizeof(float_complex));
+            if(D!=NULL)
+                memset(&D[i*dim*dim], 0, dim*dim*sizeof(float_complex));
+            if(eig!=NULL)
+                memset(&eig[i*dim], 0, dim*sizeof(float));
+#ifndef NDEBUG
+            saf_print_warning("Could not compute EVD in utility_cseig_batch(). Output matrices/vectors have been zeroed.");
+#endif
+        }
+    }
+}
+
 
 /* ========================================================================== */
 /*                     Eigenvalues of Matrix Pair (?eigmp)                    */
@@ -2498,15 +3363,33 @@ void utility_ceig_create(void ** const phWork, int maxDim)
 {
     *phWork = malloc1d(sizeof(utility_ceig_data));
     utility_ceig_data *h = (utility_ceig_data*)(*phWork);
+    veclib_int n, lda, ldvl, ldvr, lwork;
+    float_complex wkopt;
+#if defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
+    veclib_int info;
+#endif
 
     h->maxDim = maxDim;
-    h->currentWorkSize = 0;
     h->rwork = malloc1d(4*maxDim*sizeof(float));
     h->w = malloc1d(maxDim*sizeof(float_complex));
     h->vl = malloc1d(maxDim*maxDim*sizeof(float_complex));
     h->vr = malloc1d(maxDim*maxDim*sizeof(float_complex));
     h->a = malloc1d(maxDim*maxDim*sizeof(float_complex));
-    h->work = NULL;
+
+    /* Query the "work" memory required for the largest problem, so that
+     * utility_ceig() does not need to reallocate it */
+    n = lda = ldvl = ldvr = maxDim;
+    lwork = -1;
+    wkopt = cmplxf(0.0f, 0.0f);
+#if defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
+    cgeev_( "Vectors", "Vectors", &n, (veclib_float_complex*)h->a, &lda, (veclib_float_complex*)h->w, (veclib_float_complex*)h->vl, &ldvl,
+           (veclib_float_complex*)h->vr, &ldvr, (veclib_float_complex*)&wkopt, &lwork, h->rwork, &info );
+#elif defined(SAF_VECLIB_USE_LAPACKE_INTERFACE)
+    LAPACKE_cgeev_work(CblasColMajor, 'V', 'V', n, (veclib_float_complex*)h->a, lda, (veclib_float_complex*)h->w, (veclib_float_complex*)h->vl, ldvl,
+                       (veclib_float_complex*)h->vr, ldvr, (veclib_float_complex*)&wkopt, lwork, h->rwork);
+#endif
+    h->currentWorkSize = (veclib_int)crealf(wkopt);
+    h->work = h->currentWorkSize>0 ? malloc1d(h->currentWorkSize*sizeof(float_complex)) : NULL;
 }
 
 void utility_ceig_destroy(void ** const phWork)
@@ -3382,7 +4265,7 @@ void utility_sslslv
 #ifdef SAF_VECLIB_USE_CLAPACK_INTERFACE
     info = clapack_sposv(CblasColMajor, CblasUpper, n, nrhs, h->a, lda, h->b, ldb);
 #elif defined(SAF_VECLIB_USE_LAPACKE_INTERFACE)
-    info = LAPACKE_sposv_work(CblasColMajor, CblasUpper, n, nrhs, h->a, lda, h->b, ldb);
+    info = LAPACKE_sposv_work(CblasColMajor, 'U', n, nrhs, h->a, lda, h->b, ldb);
 #elif defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
     sposv_( "U", &n, &nrhs, h->a, &lda, h->b, &ldb, &info );
 #endif
@@ -3484,7 +4367,7 @@ void utility_cslslv
 #elif defined(SAF_VECLIB_USE_CLAPACK_INTERFACE)
     info = clapack_cposv(CblasColMajor, CblasUpper, n, nrhs, (veclib_float_complex*)h->a, lda, (veclib_float_complex*)h->b, ldb);
 #elif defined(SAF_VECLIB_USE_LAPACKE_INTERFACE)
-    info = LAPACKE_cposv_work(CblasColMajor, CblasUpper, n, nrhs, (veclib_float_complex*)h->a, lda, (veclib_float_complex*)h->b, ldb);
+    info = LAPACKE_cposv_work(CblasColMajor, 'U', n, nrhs, (veclib_float_complex*)h->a, lda, (veclib_float_complex*)h->b, ldb);
 #endif
     
     /* A is not symmetric positive definate, solution not possible */
@@ -3508,6 +4391,115 @@ void utility_cslslv
         utility_cslslv_destroy((void**)&h);
 }
 
+/**
+ * Cholesky (A = U^H U) based solver for a small Hermitian positive-definate
+ * matrix (only the upper triangle of A is referenced)
+ *
+ * @returns 0 if successful, otherwise 1 (i.e. A is not positive-definate, or
+ *          contains NaNs/Infs)
+ */
+static int utility_cslslv_cholesky
+(
+    const float_complex* A,
+    const int dim,
+    const float_complex* B,
+    int nCol,
+    float_complex* X
+)
+{
+    int i, j, k;
+    double ur[SAF_VECLIB_BATCH_SMALL_DIM][SAF_VECLIB_BATCH_SMALL_DIM];
+    double ui[SAF_VECLIB_BATCH_SMALL_DIM][SAF_VECLIB_BATCH_SMALL_DIM];
+    double yr[SAF_VECLIB_BATCH_SMALL_DIM], yi[SAF_VECLIB_BATCH_SMALL_DIM];
+    double d, sr, si;
+
+    /* factorise */
+    for(i=0; i<dim; i++){
+        d = (double)crealf(A[i*dim+i]);
+        for(k=0; k<i; k++)
+            d -= ur[k][i]*ur[k][i] + ui[k][i]*ui[k][i];
+        if(!(d > 0.0))
+            return 1;
+        ur[i][i] = sqrt(d);
+        ui[i][i] = 0.0;
+        for(j=i+1; j<dim; j++){
+            sr = (double)crealf(A[i*dim+j]);
+            si = (double)cimagf(A[i*dim+j]);
+            for(k=0; k<i; k++){ /* - conj(U_ki) U_kj */
+                sr -= ur[k][i]*ur[k][j] + ui[k][i]*ui[k][j];
+                si -= ur[k][i]*ui[k][j] - ui[k][i]*ur[k][j];
+            }
+            ur[i][j] = sr/ur[i][i];
+            ui[i][j] = si/ur[i][i];
+        }
+    }
+
+    /* solve U^H y = b, then U x = y, for each column in b */
+    for(j=0; j<nCol; j++){
+        for(i=0; i<dim; i++){
+            sr = (double)crealf(B[i*nCol+j]);
+            si = (double)cimagf(B[i*nCol+j]);
+            for(k=0; k<i; k++){ /* - conj(U_ki) y_k */
+                sr -= ur[k][i]*yr[k] + ui[k][i]*yi[k];
+                si -= ur[k][i]*yi[k] - ui[k][i]*yr[k];
+            }
+            yr[i] = sr/ur[i][i];
+            yi[i] = si/ur[i][i];
+        }
+        for(i=dim-1; i>=0; i--){
+            sr = yr[i];
+            si = yi[i];
+            for(k=i+1; k<dim; k++){ /* - U_ik x_k */
+                sr -= ur[i][k]*yr[k] - ui[i][k]*yi[k];
+                si -= ur[i][k]*yi[k] + ui[i][k]*yr[k];
+            }
+            yr[i] = sr/ur[i][i];
+            yi[i] = si/ur[i][i];
+        }
+        for(i=0; i<dim; i++)
+            X[i*nCol+j] = cmplxf((float)yr[i], (float)yi[i]);
+    }
+    return 0;
+}
+
+void utility_cslslv_batch
+(
+    void* const hWork,
+    const float_complex* A,
+    const int dim,
+    float_complex* B,
+    int nCol,
+    const int nBatch,
+    float_complex* X
+)
+{
+    void* h;
+    int i;
+
+    /* Large matrices are passed to LAPACK (with one work struct for the whole batch) */
+    if(dim>SAF_VECLIB_BATCH_SMALL_DIM){
+        if(hWork==NULL)
+            utility_cslslv_create(&h, dim, nCol);
+        else
+            h = hWork;
+        for(i=0; i<nBatch; i++)
+            utility_cslslv(h, &A[i*dim*dim], dim, &B[i*dim*nCol], nCol, &X[i*dim*nCol]);
+        if(hWork == NULL)
+            utility_cslslv_destroy(&h);
+        return;
+    }
+
+    for(i=0; i<nBatch; i++){
+        /* A is not symmetric positive definate, solution not possible */
+        if(utility_cslslv_cholesky(&A[i*dim*dim], dim, &B[i*dim*nCol], nCol, &X[i*dim*nCol]) != 0){
+            memset(&X[i*dim*nCol], 0, dim*nCol*sizeof(float_complex));
+#ifndef NDEBUG
+            saf_print_warning("Could not solve the linear equation in utility_cslslv_batch(). Output matrices/vectors have been zeroed.");
+#endif
+        }
+    }
+}
+
 
 /* ========================================================================== */
 /*                        Matrix Pseudo-Inverse (?pinv)                       */
@@ -4136,7 +5128,7 @@ void utility_schol
 #ifdef SAF_VECLIB_USE_CLAPACK_INTERFACE
     info = clapack_spotrf(CblasColMajor, CblasUpper, n, h->a, lda);
 #elif defined(SAF_VECLIB_USE_LAPACKE_INTERFACE)
-    info = LAPACKE_spotrf_work(CblasColMajor, CblasUpper, n, h->a, lda);
+    info = LAPACKE_spotrf_work(CblasColMajor, 'U', n, h->a, lda);
 #elif defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
     spotrf_( "U", &n, h->a, &lda, &info );
 #endif
@@ -4224,7 +5216,7 @@ void utility_cchol
 #if defined(SAF_VECLIB_USE_CLAPACK_INTERFACE)
     info = clapack_cpotrf(CblasColMajor, CblasUpper, n, (veclib_float_complex*)h->a, lda);
 #elif defined(SAF_VECLIB_USE_LAPACKE_INTERFACE)
-    info = LAPACKE_cpotrf_work(CblasColMajor, CblasUpper, n, (veclib_float_complex*)h->a, lda);
+    info = LAPACKE_cpotrf_work(CblasColMajor, 'U', n, (veclib_float_complex*)h->a, lda);
 #elif defined(SAF_VECLIB_USE_LAPACK_FORTRAN_INTERFACE)
     cpotrf_( "U", &n, (veclib_float_complex*)h->a, &lda, &info );
 #endif
@@ -42,6 +42,17 @@ typedef enum {
   CONJ = 2      /**< Take the conjugate */
 }CONJ_FLAG;
 
+/**
+ * SIMD instruction set extensions, which may be employed by the SIMD kernels
+ * (if SAF_ENABLE_SIMD is defined)
+ */
+typedef enum {
+  SAF_SIMD_NONE = 0,  /**< Scalar code only */
+  SAF_SIMD_SSE3,      /**< SSE, SSE2 and SSE3 */
+  SAF_SIMD_AVX2,      /**< AVX and AVX2 (and the above) */
+  SAF_SIMD_AVX512     /**< AVX-512F (and the above) */
+}SAF_SIMD_LEVELS;
+
 #ifdef SAF_USE_BUILT_IN_NAIVE_CBLAS
  enum { CblasRowMajor = 101, CblasColMajor = 102 } CBLAS_ORDER;
  enum { CblasNoTrans = 111, CblasTrans = 112, CblasConjTrans = 113 } CBLAS_TRANSPOSE;
@@ -57,6 +68,23 @@ typedef enum {
  * v -> vector
  * m -> matrix */
 
+/**
+ * Largest dimension of the matrices, which utility_cslslv_batch() solves with
+ * its own (Cholesky) kernel, rather than LAPACK
+ */
+#define SAF_VECLIB_BATCH_SMALL_DIM ( 16 )
+
+/**
+ * Largest dimension of the matrices, which utility_cseig_batch() and
+ * utility_csvd_batch() decompose with their own Jacobi kernels, rather than
+ * LAPACK
+ *
+ * The cyclic Jacobi method costs more sweeps (each of O(dim^3)) than LAPACK's
+ * Householder tridiagonalisation, and is only faster for the smallest matrices
+ * (see the saf_benchmark program).
+ */
+#define SAF_VECLIB_BATCH_JACOBI_MAX_DIM ( 4 )
+
 /* ========================================================================== */
 /*                     Built-in CBLAS Functions (Level 0)                     */
 /* ========================================================================== */
@@ -82,6 +110,33 @@ void cblas_zaxpy(const int N, const void* alpha, const void* X,
 #endif
 
 
+/* ========================================================================== */
+/*                          SIMD Run-time Dispatch                            */
+/* ========================================================================== */
+
+/**
+ * Returns the SIMD instruction set extensions currently employed by the SIMD
+ * kernels
+ *
+ * The widest extensions supported by the host CPU are detected (via cpuid) on
+ * first use, and then limited by saf_setMaxSIMDLevel(). Always returns
+ * SAF_SIMD_NONE if SAF_ENABLE_SIMD is not defined.
+ *
+ * @test test__saf_simdDispatch()
+ */
+SAF_SIMD_LEVELS saf_getSIMDLevel(void);
+
+/**
+ * Limits the SIMD instruction set extensions that the SIMD kernels may employ
+ * (e.g. for testing/benchmarking the narrower kernels); default: SAF_SIMD_AVX512
+ *
+ * @note Extensions that are not supported by the host CPU are never employed,
+ *       regardless of this setting.
+ *
+ * @param[in] maxLevel Widest permitted SIMD instruction set extensions
+ */
+void saf_setMaxSIMDLevel(SAF_SIMD_LEVELS maxLevel);
+
 /* ========================================================================== */
 /*                     Built-in CBLAS Functions (Level 3)                     */
 /* ========================================================================== */
@@ -609,6 +664,91 @@ void utility_cvvmul(/* Input Arguments */
                     float_complex* c);
 
 
+/* ========================================================================== */
+/*                 Vector-Vector Multiply-Accumulate (?vvmac)                 */
+/* ========================================================================== */
+
+/**
+ * Single-precision, complex, element-wise vector-vector multiply-accumulate,
+ * i.e.
+ * \code{.m}
+ *     c = c + a.*b,  or:  c = c + a.*conj(b)
+ * \endcode
+ *
+ * @note This is equivalent to utility_cvvmul() followed by cblas_caxpy(), but
+ *       requires only one pass over the data and no temporary buffer.
+ *
+ * @test test__utility_cvvmac()
+ *
+ * @param[in]     a    Input vector a; len x 1
+ * @param[in]     b    Input vector b; len x 1
+ * @param[in]     len  Vector length
+ * @param[in]     flag '0' do not take the conjugate of 'b', '1', take the
+ *                     conjugate of 'b'. (see #CONJ_FLAG enum)
+ * @param[in,out] c    Accumulation vector c; len x 1
+ */
+void utility_cvvmac(/* Input Arguments */
+                    const float_complex* a,
+                    const float_complex* b,
+                    const int len,
+                    CONJ_FLAG flag,
+                    /* Input/Output Arguments */
+                    float_complex* c);
+
+/**
+ * Single-precision, complex, sum over K element-wise vector-vector products,
+ * i.e.
+ * \code{.m}
+ *     c = sum_k a(k*strideA + (1:len)) .* b(k*strideB + (1:len)), k = 0..K-1
+ * \endcode
+ *
+ * This is the frequency-domain delay-line (FDL) accumulation of partitioned
+ * convolution, where 'a' holds the filter partitions and 'b' the spectra of
+ * the past input blocks. The output is computed in cache-sized blocks.
+ *
+ * @test test__utility_cvvmac()
+ *
+ * @param[in]  a       Input vectors a; K x strideA (only len are used)
+ * @param[in]  strideA Stride between the vectors in 'a' (>=len)
+ * @param[in]  b       Input vectors b; K x strideB (only len are used)
+ * @param[in]  strideB Stride between the vectors in 'b' (>=len)
+ * @param[in]  K       Number of products to sum (0: c is zeroed)
+ * @param[in]  len     Vector length
+ * @param[out] c       Output vector c; len x 1 (must not overlap a or b)
+ */
+void utility_cvvmulsum(/* Input Arguments */
+                       const float_complex* a,
+                       const int strideA,
+                       const float_complex* b,
+                       const int strideB,
+                       const int K,
+                       const int len,
+                       /* Output Arguments */
+                       float_complex* c);
+
+/**
+ * Single-precision, scaled complex-real element-wise vector-vector
+ * multiply-accumulate, i.e.
+ * \code{.m}
+ *     c = c + s*(a.*b), where 'b' is real-valued
+ * \endcode
+ *
+ * @test test__utility_cvvmac()
+ *
+ * @param[in]     a   Input complex vector a; len x 1
+ * @param[in]     b   Input real vector b; len x 1
+ * @param[in]     s   Real scalar
+ * @param[in]     len Vector length
+ * @param[in,out] c   Accumulation vector c; len x 1
+ */
+void utility_crvvmac(/* Input Arguments */
+                     const float_complex* a,
+                     const float* b,
+                     const float s,
+                     const int len,
+                     /* Input/Output Arguments */
+                     float_complex* c);
+
 /* ========================================================================== */
 /*                     Vector-Vector Dot Product (?vvdot)                     */
 /* ========================================================================== */
@@ -992,6 +1132,45 @@ void utility_csvd(/* Input Arguments */
                   float_complex* V,
                   float* sing);
 
+/**
+ * Singular value decomposition of a batch of matrices: single precision
+ * complex (see utility_csvd())
+ *
+ * Matrices with both dimensions no larger than SAF_VECLIB_BATCH_JACOBI_MAX_DIM
+ * are decomposed with a one-sided Jacobi kernel, which needs no work struct
+ * (and does not allocate memory). Larger matrices are passed to LAPACK, with
+ * the same work struct for each matrix.
+ *
+ * @test test__utility_batchedSolvers()
+ *
+ * @param[in]  hWork  Handle for the work struct of utility_csvd() (set to NULL
+ *                    if not available, in which case memory is allocated once
+ *                    for the whole batch; only used for the larger matrices)
+ * @param[in]  A      Input matrices; FLAT: nBatch x dim1 x dim2
+ * @param[in]  dim1   First dimension of the matrices
+ * @param[in]  dim2   Second dimension of the matrices
+ * @param[in]  nBatch Number of matrices
+ * @param[out] U      Left matrices (set to NULL if not needed);
+ *                    FLAT: nBatch x dim1 x dim1
+ * @param[out] S      Singular values along the diagonals (set to NULL if not
+ *                    needed); FLAT: nBatch x dim1 x dim2
+ * @param[out] V      Right matrices (UNTRANSPOSED!) (set to NULL if not
+ *                    needed); FLAT: nBatch x dim2 x dim2
+ * @param[out] sing   Singular values as vectors (set to NULL if not needed);
+ *                    FLAT: nBatch x min(dim1, dim2)
+ */
+void utility_csvd_batch(/* Input Arguments */
+                        void* const hWork,
+                        const float_complex* A,
+                        const int dim1,
+                        const int dim2,
+                        const int nBatch,
+                        /* Output Arguments */
+                        float_complex* U,
+                        float_complex* S,
+                        float_complex* V,
+                        float* sing);
+
 
 /* ========================================================================== */
 /*                 Symmetric Eigenvalue Decomposition (?seig)                 */
@@ -1088,6 +1267,48 @@ void utility_cseig(/* Input Arguments */
                    float_complex* D,
                    float* eig);
 
+/**
+ * Eigenvalue decomposition of a batch of SYMMETRIC/HERMITION matrices: single
+ * precision complex (see utility_cseig())
+ *
+ * Matrices of up to SAF_VECLIB_BATCH_JACOBI_MAX_DIM x
+ * SAF_VECLIB_BATCH_JACOBI_MAX_DIM are decomposed with a (double precision)
+ * cyclic Jacobi kernel, which does not call LAPACK or allocate any memory.
+ * Larger matrices are passed to utility_cseig() one at a time, using the same
+ * work struct.
+ *
+ * @note The eigen vectors are unique only up to a (complex) scaling of each
+ *       vector, and may therefore differ from those of utility_cseig()
+ *
+ * @test test__utility_batchedSolvers()
+ *
+ * @param[in]  hWork       Handle for the work struct of utility_cseig() (only
+ *                         used if dim > SAF_VECLIB_BATCH_JACOBI_MAX_DIM; may
+ *                         be NULL)
+ * @param[in]  A           Input SYMMETRIC square matrices;
+ *                         FLAT: nBatch x dim x dim
+ * @param[in]  dim         Dimensions for the square matrices
+ * @param[in]  nBatch      Number of matrices
+ * @param[in]  sortDecFLAG '1' sort eigen values and vectors in decending order.
+ *                         '0' ascending
+ * @param[out] V           Eigen vectors (set to NULL if not needed);
+ *                         FLAT: nBatch x dim x dim
+ * @param[out] D           Eigen values along the diagonal (set to NULL if not
+ *                         needed); FLAT: nBatch x dim x dim
+ * @param[out] eig         Eigen values not diagonalised (set to NULL if not
+ *                         needed); FLAT: nBatch x dim
+ */
+void utility_cseig_batch(/* Input Arguments */
+                         void* const hWork,
+                         const float_complex* A,
+                         const int dim,
+                         const int nBatch,
+                         int sortDecFLAG,
+                         /* Output Arguments */
+                         float_complex* V,
+                         float_complex* D,
+                         float* eig);
+
 
 /* ========================================================================== */
 /*                     Eigenvalues of Matrix Pair (?eigmp)                    */
@@ -1535,6 +1756,37 @@ void utility_cslslv(/* Input Arguments */
                     /* Output Arguments */
                     float_complex* X);
 
+/**
+ * Linear solver for a batch of HERMITIAN positive-definate matrices: single
+ * precision complex (see utility_cslslv())
+ *
+ * Matrices of up to SAF_VECLIB_BATCH_SMALL_DIM x SAF_VECLIB_BATCH_SMALL_DIM
+ * are solved with a (double precision) Cholesky kernel, which does not call
+ * LAPACK or allocate any memory. Larger matrices are passed to utility_cslslv()
+ * one at a time, using the same work struct.
+ *
+ * @test test__utility_batchedSolvers()
+ *
+ * @param[in]  hWork  Handle for the work struct of utility_cslslv() (only used
+ *                    if dim > SAF_VECLIB_BATCH_SMALL_DIM; may be NULL)
+ * @param[in]  A      Input square SYMMETRIC positive-definate matrices;
+ *                    FLAT: nBatch x dim x dim
+ * @param[in]  dim    Dimensions for the square matrices
+ * @param[in]  B      Right hand side matrices; FLAT: nBatch x dim x nCol
+ * @param[in]  nCol   Number of columns in the right hand side matrices
+ * @param[in]  nBatch Number of matrices
+ * @param[out] X      The solutions; FLAT: nBatch x dim x nCol
+ */
+void utility_cslslv_batch(/* Input Arguments */
+                          void* const hWork,
+                          const float_complex* A,
+                          const int dim,
+                          float_complex* B,
+                          int nCol,
+                          const int nBatch,
+                          /* Output Arguments */
+                          float_complex* X);
+
 
 /* ========================================================================== */
 /*                        Matrix Pseudo-Inverse (?pinv)                       */
@@ -34,7 +34,11 @@
  * This version also adds functionality to change the number of channels on the
  * fly, flush the run-time buffers with zeros, return the current frequency
  * vector and the current processing delay.
- * It also incorporates SAF utilities (for the vectorisation and FFT).
+ * It also incorporates SAF utilities (for the vectorisation and FFT), and
+ * processes all channels together: the prototype filter is applied to all
+ * channels with one vector operation per hop, and the FFTs are batched.
+ * The (hybrid) spectra are read/written as interleaved complex data directly
+ * from/to the caller's buffers, using band and channel strides.
  *
  * The afSTFT design is also described in more detail in [1]
  *
@@ -54,6 +58,74 @@
 /*                            Internal functions                              */
 /* ========================================================================== */
 
+/**
+ * Resizes a hop-major buffer (totalHops x nCH x hopSize), while retaining the
+ * history of the channels which remain
+ */
+static void afSTFTlib_resizeHistory
+(
+    float** buffer,
+    int totalHops,
+    int hopSize,
+    int nCH_old,
+    int nCH_new
+)
+{
+    int k;
+    float* newBuffer;
+
+    newBuffer = (float*)calloc1d_aligned(totalHops*SAF_MAX(nCH_new,1)*hopSize, sizeof(float));
+    for(k=0; k<totalHops; k++)
+        memcpy(&newBuffer[k*nCH_new*hopSize], &(*buffer)[k*nCH_old*hopSize], SAF_MIN(nCH_old,nCH_new)*hopSize*sizeof(float));
+    free1d_aligned(*buffer);
+    (*buffer) = newBuffer;
+}
+
+/**
+ * Repeats the prototype filter for each channel, such that each hop of the
+ * filter may be applied to all channels at once; FLAT: totalHops x nCH x hopSize
+ */
+static void afSTFTlib_tileProtoFilter
+(
+    float** protoFilterMC,
+    float* protoFilter,
+    int totalHops,
+    int hopSize,
+    int nCH
+)
+{
+    int k, ch;
+
+    free1d_aligned(*protoFilterMC);
+    (*protoFilterMC) = (float*)malloc1d_aligned(totalHops*SAF_MAX(nCH,1)*hopSize*sizeof(float));
+    for(k=0; k<totalHops; k++)
+        for(ch=0; ch<nCH; ch++)
+            memcpy(&(*protoFilterMC)[(k*nCH+ch)*hopSize], &protoFilter[k*hopSize], hopSize*sizeof(float));
+}
+
+/** Enlarges the multichannel work buffers, if they cannot hold nCH channels */
+static void afSTFTlib_reserveChannels
+(
+    afSTFTlib_internal_data *h,
+    int nCH
+)
+{
+    if(nCH<=h->maxChannels)
+        return;
+    h->maxChannels = nCH;
+    /* (the contents need not be retained) */
+    free1d_aligned(h->foldBuffer[0]);
+    free1d_aligned(h->foldBuffer[1]);
+    free1d_aligned(h->tempBuffer);
+    free1d_aligned(h->fftProcessFrameTD);
+    free1d_aligned(h->fftProcessFrameFD);
+    h->foldBuffer[0] = (float*)malloc1d_aligned(nCH*h->hopSize*sizeof(float));
+    h->foldBuffer[1] = (float*)malloc1d_aligned(nCH*h->hopSize*sizeof(float));
+    h->tempBuffer = (float*)malloc1d_aligned(nCH*h->hopSize*sizeof(float));
+    h->fftProcessFrameTD = (float*)malloc1d_aligned(nCH*2*h->hopSize*sizeof(float));
+    h->fftProcessFrameFD = (float_complex*)malloc1d_aligned(nCH*(h->hopSize+1)*sizeof(float_complex));
+}
+
 void afSTFTlib_init
 (
     void** handle,
@@ -64,7 +136,7 @@ void afSTFTlib_init
     int hybridMode
 )
 {
-    int k, ch, dsFactor;
+    int k, dsFactor;
     float eq;
     
     *handle = malloc(sizeof(afSTFTlib_internal_data));
@@ -83,49 +155,19 @@ void afSTFTlib_init
     h->LDmode = LDmode;
     h->protoFilter = (float*)malloc(sizeof(float)*h->hLen);
     h->protoFilterI = (float*)malloc(sizeof(float)*h->hLen);
-    h->inBuffer = (float**)malloc(sizeof(float*)*h->inChannels);
-    h->outBuffer = (float**)malloc(sizeof(float*)*h->outChannels);
-    h->fftProcessFrameTD = (float*)calloc(sizeof(float),h->hopSize*2);
-#ifdef AFSTFT_USE_SAF_UTILITIES
+    h->inBuffer = (float*)calloc1d_aligned(h->totalHops*SAF_MAX(h->inChannels,1)*h->hopSize, sizeof(float));
+    h->outBuffer = (float*)calloc1d_aligned(h->totalHops*SAF_MAX(h->outChannels,1)*h->hopSize, sizeof(float));
+    h->protoFilterMC = h->protoFilterIMC = NULL;
+    h->maxChannels = 0;
+    h->foldBuffer[0] = h->foldBuffer[1] = h->tempBuffer = h->fftProcessFrameTD = NULL;
+    h->fftProcessFrameFD = NULL;
+    afSTFTlib_reserveChannels(h, SAF_MAX(SAF_MAX(h->inChannels, h->outChannels), 1));
     saf_rfft_create(&(h->hSafFFT), h->hopSize*2);
-    h->fftProcessFrameFD  = calloc((h->hopSize+1), sizeof(float_complex));
-    h->tempHopBuffer = malloc(h->hopSize*sizeof(float));
-#else
-    switch (hopSize) {
-        case 32:
-            h->log2n=6;
-            break;
-        case 64:
-            h->log2n=7;
-            break;
-        case 128:
-            h->log2n=8;
-            break;
-        case 256:
-            h->log2n=9;
-            break;
-        case 512:
-            h->log2n=10;
-            break;
-        case 1024:
-            h->log2n=11;
-            break;
-        default:
-            // No other modes defined
-            return;
-            break;
-    }
-    h->fftProcessFrameFD  = (float*)calloc(sizeof(float),(h->hopSize+1)*2);
-    vtInitFFT(&(h->vtFFT), h->fftProcessFrameTD, h->fftProcessFrameFD, h->log2n);
-#endif
+    saf_rfft_prepareBatch(h->hSafFFT, 2*h->hopSize, h->hopSize+1, h->inChannels, h->outChannels);
     
     /* Normalization to ensure 0dB gain */
     if (h->LDmode==0) {
-#ifdef AFSTFT_USE_SAF_UTILITIES
         eq = 2.0f/sqrtf(5.487604141f);
-#else
-        eq = 1.0f/sqrtf((float)h->hopSize*5.487604141f);
-#endif
         for (k=0; k<h->hLen; k++) {
             h->protoFilter[h->hLen-k-1] = __afSTFT_protoFilter1024[k*dsFactor]*eq;
             h->protoFilterI[h->hLen-k-1] = __afSTFT_protoFilter1024[k*dsFactor]*eq;
@@ -133,21 +175,14 @@ void afSTFTlib_init
     } 
     else
     {
-#ifdef AFSTFT_USE_SAF_UTILITIES
         eq = 2.0f/sqrtf(4.544559956f);
-#else
-        eq = 1.0f/sqrtf((float)h->hopSize*4.544559956f);
-#endif
         for (k=0; k<h->hLen; k++) {
             h->protoFilter[h->hLen-k-1] = __afSTFT_protoFilter1024LD[k*dsFactor]*eq;
             h->protoFilterI[k]=__afSTFT_protoFilter1024LD[k*dsFactor]*eq;
         }
     }
-    for(ch=0;ch<h->inChannels;ch++)
-        h->inBuffer[ch] = (float*)calloc(h->hLen,sizeof(float));
-    
-    for(ch=0;ch<h->outChannels;ch++)
-        h->outBuffer[ch] = (float*)calloc(h->hLen,sizeof(float));
+    afSTFTlib_tileProtoFilter(&(h->protoFilterMC), h->protoFilter, h->totalHops, h->hopSize, h->inChannels);
+    afSTFTlib_tileProtoFilter(&(h->protoFilterIMC), h->protoFilterI, h->totalHops, h->hopSize, h->outChannels);
     
     /* Initialize the hybrid filter memory etc. */
     h->hybridMode=hybridMode;
@@ -164,46 +199,32 @@ void afSTFTlib_channelChange
 {
     afSTFTlib_internal_data *h = (afSTFTlib_internal_data*)(handle);
     afHybrid *hyb_h = h->h_afHybrid;
-    
-    int i, ch, sample;
+    int nBins;
+
     if(h->inChannels!=new_inChannels){
-        for(i=new_inChannels; i<h->inChannels; i++)
-            free(h->inBuffer[i]);
-        h->inBuffer = (float**)realloc(h->inBuffer, sizeof(float*)*new_inChannels);
-        for(i=h->inChannels; i<new_inChannels; i++)
-            h->inBuffer[i] = (float*)calloc(h->hLen,sizeof(float));
+        afSTFTlib_resizeHistory(&(h->inBuffer), h->totalHops, h->hopSize, h->inChannels, new_inChannels);
+        afSTFTlib_tileProtoFilter(&(h->protoFilterMC), h->protoFilter, h->totalHops, h->hopSize, new_inChannels);
     }
     
     if(h->outChannels!=new_outChannels){
-        for(i=new_outChannels; i<h->outChannels; i++)
-            free(h->outBuffer[i]);
-        h->outBuffer = (float**)realloc(h->outBuffer, sizeof(float*)*new_outChannels);
-        for(i=h->outChannels; i<new_outChannels; i++)
-            h->outBuffer[i] = (float*)calloc(h->hLen,sizeof(float));
+        afSTFTlib_resizeHistory(&(h->outBuffer), h->totalHops, h->hopSize, h->outChannels, new_outChannels);
+        afSTFTlib_tileProtoFilter(&(h->protoFilterIMC), h->protoFilterI, h->totalHops, h->hopSize, new_outChannels);
     }
+    afSTFTlib_reserveChannels(h, SAF_MAX(new_inChannels, new_outChannels));
     
     if (h->hybridMode) {
         hyb_h = h->h_afHybrid;
         if (hyb_h->inChannels != new_inChannels) {
-            for (ch = new_inChannels; ch < hyb_h->inChannels; ch++) {
-                for (sample = 0; sample < 7; sample++) {
-                    free(hyb_h->analysisBuffer[ch][sample].re);
-                    free(hyb_h->analysisBuffer[ch][sample].im);
-                }
-                free(hyb_h->analysisBuffer[ch]);
-            }
-            hyb_h->analysisBuffer = (complexVector**) realloc(hyb_h->analysisBuffer, sizeof(complexVector*) * new_inChannels);
-            for (ch = hyb_h->inChannels; ch < new_inChannels; ch++) {
-                hyb_h->analysisBuffer[ch] = (complexVector*) malloc(sizeof(complexVector) * 7);
-                for (sample = 0; sample < 7; sample++) {
-                    hyb_h->analysisBuffer[ch][sample].re = (float*) calloc(sizeof(float), h->hopSize + 1);
-                    hyb_h->analysisBuffer[ch][sample].im = (float*) calloc(sizeof(float), h->hopSize + 1);
-                }
-            }
+            /* The buffer is channel-major, so the history of the remaining channels is retained */
+            nBins = 7*(h->hopSize+1);
+            hyb_h->analysisBuffer = (float_complex*)realloc(hyb_h->analysisBuffer, SAF_MAX(new_inChannels,1)*nBins*sizeof(float_complex));
+            if(new_inChannels > hyb_h->inChannels)
+                memset(&(hyb_h->analysisBuffer[hyb_h->inChannels*nBins]), 0, (new_inChannels-hyb_h->inChannels)*nBins*sizeof(float_complex));
         }
     }
     h->inChannels = new_inChannels;
     h->outChannels = new_outChannels;
+    saf_rfft_prepareBatch(h->hSafFFT, 2*h->hopSize, h->hopSize+1, h->inChannels, h->outChannels);
     if (h->hybridMode){
         hyb_h->inChannels = new_inChannels;
         hyb_h->outChannels = new_outChannels;
@@ -217,239 +238,142 @@ void afSTFTlib_clearBuffers
 {
     afSTFTlib_internal_data *h = (afSTFTlib_internal_data*)(handle);
     afHybrid *hyb_h = h->h_afHybrid;
-    int i, ch, sample;
     
-    for(i=0; i<h->inChannels; i++)
-        memset(h->inBuffer[i], 0, h->hLen*sizeof(float));
-    for(i=0; i<h->outChannels; i++)
-        memset(h->outBuffer[i], 0, h->hLen*sizeof(float));
-    if (h->hybridMode){
-        for(ch=0; ch<hyb_h->inChannels; ch++) {
-            for (sample=0;sample<7;sample++) {
-                memset(hyb_h->analysisBuffer[ch][sample].re, 0, sizeof(float)*(h->hopSize+1));
-                memset(hyb_h->analysisBuffer[ch][sample].im, 0, sizeof(float)*(h->hopSize+1));
-
-            }
-        }
-    }
+    memset(h->inBuffer, 0, h->totalHops*h->inChannels*h->hopSize*sizeof(float));
+    memset(h->outBuffer, 0, h->totalHops*h->outChannels*h->hopSize*sizeof(float));
+    if (h->hybridMode)
+        memset(hyb_h->analysisBuffer, 0, hyb_h->inChannels*7*(h->hopSize+1)*sizeof(float_complex));
 }
 
 void afSTFTlib_forward
 (
     void* handle,
     float** inTD,
-    complexVector* outFD
+    float_complex* outFD,
+    int bandStride,
+    int chStride
 )
 {
     afSTFTlib_internal_data *h = (afSTFTlib_internal_data*)(handle);
-    int ch,k,hopIndex_this,hopIndex_this2;
-    float *p1,*p2,*p3;
-#ifndef AFSTFT_USE_SAF_UTILITIES
-    float *p4;
-#endif
-    int lr;
-    
+    int ch,k,hopIndex_this,nSamples;
+    float *p1;
+
+    /* Each hop of the buffers holds nSamples, which are contiguous over all channels. The prototype filter is applied to all
+     * channels with one vector operation per hop, and the per-sample operations are the same (and in the same order) as when
+     * processing each channel separately; the output is therefore identical. */
+    nSamples = h->inChannels*h->hopSize;
+
+    /* Copy the input frames into the memory buffer */
+    p1 = &(h->inBuffer[h->hopIndexIn*nSamples]);
     for (ch=0;ch<h->inChannels;ch++)
+        cblas_scopy(h->hopSize, inTD[ch], 1, &p1[ch*h->hopSize], 1);
+    hopIndex_this = h->hopIndexIn+1;
+    if (hopIndex_this >= h->totalHops)
+        hopIndex_this = 0;
+
+    /* Apply prototype filter to the collected data in the memory buffer, and fold the result into the left (even hops) and
+     * right (odd hops) parts of the frames */
+    memset(h->foldBuffer[0], 0, nSamples*sizeof(float));
+    memset(h->foldBuffer[1], 0, nSamples*sizeof(float));
+    for (k=0;k<h->totalHops;k++)
     {
-        /* Copy the input frame into the memory buffer */
-        hopIndex_this2 = h->hopIndexIn;
-        p1=&(h->inBuffer[ch][hopIndex_this2*h->hopSize]);
-        p2=inTD[ch];
-        //memcpy((void*)p1,(void*)p2,sizeof(float)*(h->hopSize));
-        cblas_scopy(h->hopSize, p2, 1, p1, 1);
-        
-        hopIndex_this2++;
-        if (hopIndex_this2 >= h->totalHops)
-        {
-            hopIndex_this2 = 0;
-        }
-        
-        /* Apply prototype filter to the collected data in the memory buffer, and fold the result (for the FFT operation). */
-        p1 = h->fftProcessFrameTD;
-#ifdef AFSTFT_USE_SAF_UTILITIES
-        memset(p1, 0, h->hopSize*2*sizeof(float));
-#else
-        vtClr(p1, h->hopSize*2);
-#endif
-        lr=0; /* Left or right part of the frame */
-        hopIndex_this = hopIndex_this2;
-        for (k=0;k<h->totalHops;k++)
-        {
-            p1=&(h->inBuffer[ch][h->hopSize*hopIndex_this]);
-            p2=&(h->protoFilter[k*h->hopSize]);
-            if (lr==1)
-            {
-                p3=&(h->fftProcessFrameTD[h->hopSize]);
-                lr=0;
-            }
-            else
-            {
-                p3=&(h->fftProcessFrameTD[0]);
-                lr=1;
-            }
-#ifdef AFSTFT_USE_SAF_UTILITIES
-            utility_svvmul(p1, p2, h->hopSize, h->tempHopBuffer);
-            cblas_saxpy(h->hopSize, 1.0f, h->tempHopBuffer, 1, p3, 1);
-#else
-            vtVma(p1, p2, p3, h->hopSize);  /* Vector multiply-add */
-#endif
-            hopIndex_this++;
-            if (hopIndex_this >= h->totalHops)
-            {
-                hopIndex_this = 0;
-            }
-        }
-        
-        /* Apply FFT and copy the data to the output vector */
-#ifdef AFSTFT_USE_SAF_UTILITIES
-        saf_rfft_forward(h->hSafFFT, h->fftProcessFrameTD, h->fftProcessFrameFD);
-        cblas_scopy(h->hopSize+1, (float*)h->fftProcessFrameFD, 2, outFD[ch].re, 1);
-        cblas_scopy(h->hopSize+1, (float*)h->fftProcessFrameFD + 1, 2, outFD[ch].im, 1);
-#else
-        vtRunFFT(h->vtFFT,1);
-        outFD[ch].re[0]=h->fftProcessFrameFD[0];
-        outFD[ch].im[0]=0.0f; /* DC im = 0 */
-        outFD[ch].re[h->hopSize]=h->fftProcessFrameFD[h->hopSize];
-        outFD[ch].im[h->hopSize]=0.0f; /* Nyquist im = 0 */
-        p1 = outFD[ch].re + 1;
-        p2 = outFD[ch].im + 1;
-        p3 = h->fftProcessFrameFD + 1;
-        p4 = h->fftProcessFrameFD + 1 + h->hopSize;
-        memcpy((void*)p1,(void*)p3,sizeof(float)*(h->hopSize - 1));
-        memcpy((void*)p2,(void*)p4,sizeof(float)*(h->hopSize - 1));
-#endif
+        utility_svvmul(&(h->inBuffer[hopIndex_this*nSamples]), &(h->protoFilterMC[k*nSamples]), nSamples, h->tempBuffer);
+        cblas_saxpy(nSamples, 1.0f, h->tempBuffer, 1, h->foldBuffer[k%2], 1);
+        hopIndex_this++;
+        if (hopIndex_this >= h->totalHops)
+            hopIndex_this = 0;
     }
+
+    /* Assemble the frames and apply FFT to all of them */
+    for (ch=0;ch<h->inChannels;ch++)
+    {
+        cblas_scopy(h->hopSize, &(h->foldBuffer[0][ch*h->hopSize]), 1, &(h->fftProcessFrameTD[ch*2*h->hopSize]), 1);
+        cblas_scopy(h->hopSize, &(h->foldBuffer[1][ch*h->hopSize]), 1, &(h->fftProcessFrameTD[ch*2*h->hopSize+h->hopSize]), 1);
+    }
+    saf_rfft_forward_batch(h->hSafFFT, h->fftProcessFrameTD, 2*h->hopSize, h->fftProcessFrameFD, h->hopSize+1, h->inChannels);
     h->hopIndexIn++;
     if (h->hopIndexIn >= h->totalHops)
     {
         h->hopIndexIn = 0;
     }
-    
-    /* Subdivide lowest bands with half-band filters if hybrid mode is enabled */
+
+    /* Place the spectra directly into the output (subdividing the lowest bands with half-band filters if hybrid mode is
+     * enabled) */
     if (h->hybridMode)
-    {
-        afHybridForward(h->h_afHybrid, outFD);
-    }
+        afHybridForward(h->h_afHybrid, h->fftProcessFrameFD, outFD, bandStride, chStride);
+    else
+        for (ch=0;ch<h->inChannels;ch++)
+            cblas_ccopy(h->hopSize+1, &(h->fftProcessFrameFD[ch*(h->hopSize+1)]), 1, &outFD[ch*chStride], bandStride);
 }
 
 void afSTFTlib_inverse
 (
     void* handle,
-    complexVector* inFD,
+    float_complex* inFD,
+    int bandStride,
+    int chStride,
     float** outTD
 )
 {
     afSTFTlib_internal_data *h = (afSTFTlib_internal_data*)(handle);
-    int ch,k,hopIndex_this,hopIndex_this2;
-    float *p1,*p2,*p3;
-#ifndef AFSTFT_USE_SAF_UTILITIES
-    float *p4;
-#endif
-    int lr;
-    
-    /* Combine subdivided lowest bands if hybrid mode is enabled */
+    int ch,k,hopIndex_this,nSamples;
+    float_complex *pFD;
+
+    /* See afSTFTlib_forward() */
+    nSamples = h->outChannels*h->hopSize;
+
+    /* Take the spectra directly from the input (combining the subdivided lowest bands if hybrid mode is enabled) */
     if (h->hybridMode)
+        afHybridInverse(h->h_afHybrid, inFD, bandStride, chStride, h->fftProcessFrameFD);
+    else
+        for (ch=0;ch<h->outChannels;ch++)
+            cblas_ccopy(h->hopSize+1, &inFD[ch*chStride], bandStride, &(h->fftProcessFrameFD[ch*(h->hopSize+1)]), 1);
+
+    /* The low delay mode requires this procedure corresponding to the circular shift of the data in the time domain */
+    if (h->LDmode == 1)
     {
-        afHybridInverse(h->h_afHybrid, inFD);
+        for (ch=0;ch<h->outChannels;ch++)
+        {
+            pFD = &(h->fftProcessFrameFD[ch*(h->hopSize+1)]);
+            for (k=1; k<h->hopSize; k+=2)
+                pFD[k] = crmulf(pFD[k], -1.0f);
+        }
     }
-    
+
+    /* Inverse FFT of all channels, and split the frames into their left and right parts */
+    saf_rfft_backward_batch(h->hSafFFT, h->fftProcessFrameFD, h->hopSize+1, h->fftProcessFrameTD, 2*h->hopSize, h->outChannels);
     for (ch=0;ch<h->outChannels;ch++)
     {
-        /* Copy data from input to internal memory */
-        hopIndex_this2 = h->hopIndexOut;
-        
-        /* Inverse FFT */
-#ifdef AFSTFT_USE_SAF_UTILITIES
-        cblas_scopy(h->hopSize+1, inFD[ch].re, 1, (float*)h->fftProcessFrameFD, 2);
-        cblas_scopy(h->hopSize+1, inFD[ch].im, 1, (float*)h->fftProcessFrameFD + 1, 2);
-
-        /* The low delay mode requires this procedure corresponding to the circular shift of the data in the time domain */
-        if (h->LDmode == 1)
-            for (k=1; k<h->hopSize; k+=2)
-                h->fftProcessFrameFD[k] = crmulf(h->fftProcessFrameFD[k], -1.0f);
-        
-        saf_rfft_backward(h->hSafFFT, h->fftProcessFrameFD, h->fftProcessFrameTD);
-#else
-        h->fftProcessFrameFD[0] = inFD[ch].re[0]; /* DC */
-        h->fftProcessFrameFD[h->hopSize] = inFD[ch].re[h->hopSize]; /* Nyquist */
-        p1 = inFD[ch].re + 1;
-        p2 = inFD[ch].im + 1;
-        p3 = h->fftProcessFrameFD + 1;
-        p4 = h->fftProcessFrameFD + 1 + h->hopSize;
-        memcpy((void*)p3,(void*)p1,sizeof(float)*(h->hopSize - 1));
-        memcpy((void*)p4,(void*)p2,sizeof(float)*(h->hopSize - 1));
-        
-        /* The low delay mode requires this procedure corresponding to the circular shift of the data in the time domain */
-        if (h->LDmode == 1) {
-            for (k=1;k<h->hopSize;k+=2) {
-                *p3 = -*p3;
-                *p4 = -*p4;
-                p3+=2;
-                p4+=2;
-            }
-        }
-        
-        vtRunFFT(h->vtFFT, -1);
-#endif
-        
-        /* Clear buffer at the pointer location and increment the pointer */
-        p1 = &(h->outBuffer[ch][hopIndex_this2*h->hopSize]);
-#ifdef AFSTFT_USE_SAF_UTILITIES
-        memset(p1, 0, h->hopSize*sizeof(float));
-#else
-        vtClr(p1,h->hopSize);
-#endif
-        hopIndex_this2++;
-        if (hopIndex_this2 >= h->totalHops)
-        {
-            hopIndex_this2=0;
-        }
-        hopIndex_this = hopIndex_this2;
-        
-        lr=0; /* Left or right part of the frame */
-        for (k=0;k<h->totalHops;k++)
-        {
-            /* Apply the prototype filter to the repeated version of the IFFT'd data. */
-            p1=&(h->outBuffer[ch][h->hopSize*hopIndex_this]);
-            p2=&(h->protoFilterI[k*h->hopSize]);
-            
-            if (lr==1)
-            {
-                p3=&(h->fftProcessFrameTD[h->hopSize]);
-                lr=0;
-            }
-            else
-            {
-                p3=&(h->fftProcessFrameTD[0]);
-                lr=1;
-            }
- 
-            /* Overlap-add to the existing data in the memory buffer (from previous frames). */
-#ifdef AFSTFT_USE_SAF_UTILITIES
-            utility_svvmul(p2, p3, h->hopSize, h->tempHopBuffer);
-            cblas_saxpy(h->hopSize, 1.0f, h->tempHopBuffer, 1, p1, 1);
-#else
-            vtVma(p2, p3, p1, h->hopSize); /* Vector multiply-add */
-#endif
-            hopIndex_this++;
-            if (hopIndex_this >= h->totalHops)
-            {
-                hopIndex_this = 0;
-            }
-        }
-        
-        /* Copy a frame from work memory to the output */
-        p1 = outTD[ch];
-        p2 = &(h->outBuffer[ch][h->hopSize*hopIndex_this]);
-        memcpy((void*)p1,(void*)p2,sizeof(float)*(h->hopSize));
-        
+        cblas_scopy(h->hopSize, &(h->fftProcessFrameTD[ch*2*h->hopSize]), 1, &(h->foldBuffer[0][ch*h->hopSize]), 1);
+        cblas_scopy(h->hopSize, &(h->fftProcessFrameTD[ch*2*h->hopSize+h->hopSize]), 1, &(h->foldBuffer[1][ch*h->hopSize]), 1);
     }
+
+    /* Clear buffer at the pointer location and increment the pointer */
+    memset(&(h->outBuffer[h->hopIndexOut*nSamples]), 0, nSamples*sizeof(float));
+    hopIndex_this = h->hopIndexOut+1;
+    if (hopIndex_this >= h->totalHops)
+        hopIndex_this = 0;
+
+    /* Apply the prototype filter to the repeated version of the IFFT'd data, and overlap-add to the existing data in the
+     * memory buffer (from previous frames) */
+    for (k=0;k<h->totalHops;k++)
+    {
+        utility_svvmul(&(h->protoFilterIMC[k*nSamples]), h->foldBuffer[k%2], nSamples, h->tempBuffer);
+        cblas_saxpy(nSamples, 1.0f, h->tempBuffer, 1, &(h->outBuffer[hopIndex_this*nSamples]), 1);
+        hopIndex_this++;
+        if (hopIndex_this >= h->totalHops)
+            hopIndex_this = 0;
+    }
+
+    /* Copy a frame from work memory to the output */
+    for (ch=0;ch<h->outChannels;ch++)
+        memcpy(outTD[ch], &(h->outBuffer[hopIndex_this*nSamples + ch*h->hopSize]), h->hopSize*sizeof(float));
+
     h->hopIndexOut++;
     if (h->hopIndexOut >= h->totalHops)
     {
         h->hopIndexOut=0;
     }
-    
 }
 
 void afSTFTlib_free
@@ -458,32 +382,22 @@ void afSTFTlib_free
 )
 {
     afSTFTlib_internal_data *h = (afSTFTlib_internal_data*)(handle);
-    int ch;
     if (h->hybridMode)
     {
         afHybridFree(h->h_afHybrid);
     }
-    for(ch=0;ch<h->inChannels;ch++)
-    {
-        free(h->inBuffer[ch]);
-    }
-    
-    for(ch=0;ch<h->outChannels;ch++)
-    {
-        free(h->outBuffer[ch]);
-    }
+    free1d_aligned(h->protoFilterMC);
+    free1d_aligned(h->protoFilterIMC);
+    free1d_aligned(h->foldBuffer[0]);
+    free1d_aligned(h->foldBuffer[1]);
+    free1d_aligned(h->tempBuffer);
+    saf_rfft_destroy(&(h->hSafFFT));
     free(h->protoFilter);
     free(h->protoFilterI);
-    free(h->inBuffer);
-    free(h->outBuffer);
-    free(h->fftProcessFrameTD);
-    free(h->fftProcessFrameFD);
-#ifdef AFSTFT_USE_SAF_UTILITIES
-    saf_rfft_destroy(&(h->hSafFFT));
-    free(h->tempHopBuffer);
-#else
-    vtFreeFFT(h->vtFFT);
-#endif
+    free1d_aligned(h->inBuffer);
+    free1d_aligned(h->outBuffer);
+    free1d_aligned(h->fftProcessFrameTD);
+    free1d_aligned(h->fftProcessFrameFD);
     free(h);
 }
 
@@ -501,154 +415,126 @@ void afHybridInit
 )
 {
     /* Allocates 7 samples of memory for FIR filtering at lowest bands, and for delays at other bands. */
-    int ch,sample;
     *handle = malloc(sizeof(afHybrid));
     afHybrid *h = (afHybrid*)(*handle);
     h->inChannels = inChannels;
     h->hopSize = hopSize;
     h->outChannels = outChannels;
-    h->analysisBuffer = (complexVector**)malloc(sizeof(complexVector*)*h->inChannels);
+    h->analysisBuffer = (float_complex*)calloc(SAF_MAX(h->inChannels,1)*7*(h->hopSize+1), sizeof(float_complex));
     h->loopPointer=0;
-    for (ch=0;ch<h->inChannels;ch++)
-    {
-        h->analysisBuffer[ch] = (complexVector*)malloc(sizeof(complexVector)*7);
-        for (sample=0;sample<7;sample++)
-        {
-            h->analysisBuffer[ch][sample].re=(float*)calloc(sizeof(float),h->hopSize+1);
-            h->analysisBuffer[ch][sample].im=(float*)calloc(sizeof(float),h->hopSize+1);
-        }
-    }
 }
 
 void afHybridForward
 (
     void* handle,
-    complexVector* FD
+    float_complex* inFD,
+    float_complex* outFD,
+    int bandStride,
+    int chStride
 )
 {
     afHybrid *h = (afHybrid*)(handle);
-    int ch,band,sample,realImag;
-    float *pr1, *pr2, *pi1, *pi2;
+    int ch,band,sample,nBins;
     float re,im;
     int sampleIndices[7];
     int loopPointerThis;
+    float_complex* buffer, *pIn, *pOut;
+    float_complex low[9];
     h->loopPointer++;
     if( h->loopPointer == 7)
     {
         h->loopPointer = 0;
     }
+    nBins = h->hopSize+1;
 
-    for (ch=0;ch<h->inChannels;ch++)
+    /* Get the pointer to a position corresponding to the group delay of the linear-phase half-band filter. */
+    loopPointerThis = h->loopPointer - 3;
+    if( loopPointerThis < 0)
     {
-        /* Copy data from input to the memory buffer */
-        pr1 = FD[ch].re;
-        pi1 = FD[ch].im;
-        pr2 = h->analysisBuffer[ch][h->loopPointer].re;
-        pi2 = h->analysisBuffer[ch][h->loopPointer].im;
-//        memcpy(pr2, pr1, sizeof(float)*(h->hopSize+1));
-//        memcpy(pi2, pi1, sizeof(float)*(h->hopSize+1));
-        cblas_scopy(h->hopSize+1, pr1, 1, pr2, 1);
-        cblas_scopy(h->hopSize+1, pi1, 1, pi2, 1);
-        
-        /* Get the pointer to a position corresponding to the group delay of the linear-phase half-band filter. */
-        loopPointerThis = h->loopPointer - 3;
-        if( loopPointerThis < 0)
-        {
-            loopPointerThis += 7;
-        }
-        pr1 = FD[ch].re;
-        pr2 = h->analysisBuffer[ch][loopPointerThis].re;
-        for (realImag=0;realImag<2;realImag++)
+        loopPointerThis += 7;
+    }
+    for (sample=0;sample<7;sample++)
+    {
+        sampleIndices[sample]=h->loopPointer+1+sample;
+        if(sampleIndices[sample] > 6)
         {
-            /* The 0.5 multipliers are the center coefficients of the half-band FIR filters. Data is duplicated for the half-bands. */
-            *pr1 = *pr2;
-            *(pr1+1) = *(pr2+1)*0.5f;
-            *(pr1+2) = *(pr1+1);
-            *(pr1+3) = *(pr2+2)*0.5f;
-            *(pr1+4) = *(pr1+3);
-            *(pr1+5) = *(pr2+3)*0.5f;
-            *(pr1+6) = *(pr1+5);
-            *(pr1+7) = *(pr2+4)*0.5f;
-            *(pr1+8) = *(pr1+7);
-            
-            /* The rest of the bands are shifted upwards in the frequency indices, and delayed by the group delay of the half-band filters */
-            //memcpy((void*)(pr1+9),(void*)(pr2+5),sizeof(float)*(h->hopSize-4));
-            cblas_scopy(h->hopSize-4, pr2+5, 1, pr1+9, 1);
-            
-            /* Repeat process for the imaginary part, at next iteration. */
-            pr1 = FD[ch].im;
-            pr2 = h->analysisBuffer[ch][loopPointerThis].im;
+            sampleIndices[sample]-=7;
         }
-    
-        for (sample=0;sample<7;sample++)
+    }
+
+    for (ch=0;ch<h->inChannels;ch++)
+    {
+        /* Copy data from input to the memory buffer */
+        buffer = &(h->analysisBuffer[ch*7*nBins]);
+        cblas_ccopy(nBins, &inFD[ch*nBins], 1, &buffer[h->loopPointer*nBins], 1);
+        pIn = &buffer[loopPointerThis*nBins];
+        pOut = &outFD[ch*chStride];
+
+        /* The 0.5 multipliers are the center coefficients of the half-band FIR filters. Data is duplicated for the half-bands. */
+        low[0] = pIn[0];
+        for (band=1; band<5; band++)
         {
-            sampleIndices[sample]=h->loopPointer+1+sample;
-            if(sampleIndices[sample] > 6)
-            {
-                sampleIndices[sample]-=7;
-            }
-            
+            low[band*2-1] = cmplxf(crealf(pIn[band])*0.5f, cimagf(pIn[band])*0.5f);
+            low[band*2] = low[band*2-1];
         }
+
+        /* The rest of the bands are shifted upwards in the frequency indices, and delayed by the group delay of the half-band filters */
+        cblas_ccopy(h->hopSize-4, &pIn[5], 1, &pOut[9*bandStride], bandStride);
+
         for (band=1; band<5; band++)
         {
             /* The rest of the half-band FIR filtering is implemented below. The real<->imaginary shifts are for shifting the half-band filter spectra. */
-            re = -COEFF1*h->analysisBuffer[ch][sampleIndices[6]].im[band];
-            im =  COEFF1*h->analysisBuffer[ch][sampleIndices[6]].re[band];
-            re -= COEFF2*h->analysisBuffer[ch][sampleIndices[4]].im[band];
-            im += COEFF2*h->analysisBuffer[ch][sampleIndices[4]].re[band];
-            re += COEFF2*h->analysisBuffer[ch][sampleIndices[2]].im[band];
-            im -= COEFF2*h->analysisBuffer[ch][sampleIndices[2]].re[band];
-            re += COEFF1*h->analysisBuffer[ch][sampleIndices[0]].im[band];
-            im -= COEFF1*h->analysisBuffer[ch][sampleIndices[0]].re[band];
+            re = -COEFF1*cimagf(buffer[sampleIndices[6]*nBins+band]);
+            im =  COEFF1*crealf(buffer[sampleIndices[6]*nBins+band]);
+            re -= COEFF2*cimagf(buffer[sampleIndices[4]*nBins+band]);
+            im += COEFF2*crealf(buffer[sampleIndices[4]*nBins+band]);
+            re += COEFF2*cimagf(buffer[sampleIndices[2]*nBins+band]);
+            im -= COEFF2*crealf(buffer[sampleIndices[2]*nBins+band]);
+            re += COEFF1*cimagf(buffer[sampleIndices[0]*nBins+band]);
+            im -= COEFF1*crealf(buffer[sampleIndices[0]*nBins+band]);
             
             /* The addition or subtraction process below provides the upper and lower half-band spectra (the coefficient 0.5 had the same sign for both bands).
                The half-band orders are switched for bands=1,3 with respect to band=2,4, because of the organization of the spectral data at the downsampled frequency band signals. As the result of the order switching, the bands are organized by the ascending spectral position. */
             if (band == 1 || band== 3)
             {
-                FD[ch].re[band*2-1] -= re;
-                FD[ch].im[band*2-1] -= im;
-                FD[ch].re[band*2] += re;
-                FD[ch].im[band*2] += im;
+                low[band*2-1] = cmplxf(crealf(low[band*2-1]) - re, cimagf(low[band*2-1]) - im);
+                low[band*2] = cmplxf(crealf(low[band*2]) + re, cimagf(low[band*2]) + im);
             }
             else
             {
-                FD[ch].re[band*2-1] += re;
-                FD[ch].im[band*2-1] += im;
-                FD[ch].re[band*2] -= re;
-                FD[ch].im[band*2] -= im;
+                low[band*2-1] = cmplxf(crealf(low[band*2-1]) + re, cimagf(low[band*2-1]) + im);
+                low[band*2] = cmplxf(crealf(low[band*2]) - re, cimagf(low[band*2]) - im);
             }
-            
         }
+        cblas_ccopy(9, low, 1, pOut, bandStride);
     }
 }
 
 void afHybridInverse
 (
     void* handle,
-    complexVector* FD
+    float_complex* inFD,
+    int bandStride,
+    int chStride,
+    float_complex* outFD
 )
 {
     afHybrid *h = (afHybrid*)(handle);
-    int ch,realImag;
-    float *pr;
+    int ch,band;
+    float_complex *pIn, *pOut;
 
     for (ch=0;ch<h->outChannels;ch++)
     {
-        pr = FD[ch].re;
-        for (realImag=0;realImag<2;realImag++)
-        {
-            /* Since no downsampling was applied, the inverse hybrid filtering is just sum of the bands */
-            *(pr+1) = *(pr+1) + *(pr+2);
-            *(pr+2) = *(pr+3) + *(pr+4);
-            *(pr+3) = *(pr+5) + *(pr+6);
-            *(pr+4) = *(pr+7) + *(pr+8);
-            
-            /* The rest of the bands are shifted to their original positions */
-            memmove((void*)(pr+5),(void*)(pr+9),sizeof(float)*(h->hopSize-4));
-            
-            /* Repeat process for the imaginary part, at next iteration. */
-            pr = FD[ch].im;
-        }
+        pIn = &inFD[ch*chStride];
+        pOut = &outFD[ch*(h->hopSize+1)];
+
+        /* Since no downsampling was applied, the inverse hybrid filtering is just sum of the bands */
+        pOut[0] = pIn[0];
+        for (band=1; band<5; band++)
+            pOut[band] = ccaddf(pIn[(band*2-1)*bandStride], pIn[band*2*bandStride]);
+
+        /* The rest of the bands are shifted to their original positions */
+        cblas_ccopy(h->hopSize-4, &pIn[9*bandStride], bandStride, &pOut[5], 1);
     }
 }
 
@@ -657,18 +543,7 @@ void afHybridFree
     void* handle
 )
 {
-    int ch,sample;
     afHybrid *h = (afHybrid*)(handle);
-    for (ch=0;ch<h->inChannels;ch++)
-    {
-        for (sample=0;sample<7;sample++)
-        {
-            free(h->analysisBuffer[ch][sample].re);
-            free(h->analysisBuffer[ch][sample].im);
-        }
-        free(h->analysisBuffer[ch]);
-          
-    }
     free(h->analysisBuffer);
     free(handle);
 }
@@ -54,21 +54,8 @@
 extern "C" {
 #endif /* __cplusplus */
    
-/**
- * Remove the "AFSTFT_USE_SAF_UTILITIES" definition, and add the vecTools.h/c
- * and fft4g.h/c to your project, if you want to use the original afSTFT vector
- * code. Note the vecTools.h/c and fft4g.h/c files, may be found here:
- *     https://github.com/jvilkamo/afSTFT
- */
-#define AFSTFT_USE_SAF_UTILITIES
-#ifdef AFSTFT_USE_SAF_UTILITIES
-# include "../../modules/saf_utilities/saf_utilities.h"
+#include "../../modules/saf_utilities/saf_utilities.h"
 #include "saf_externals.h" 
-#else
-# include <stdio.h>
-# include <stdlib.h>
-# include <string.h>
-#endif
  
 /* Coefficients for a half-band filter, i.e., the "hybrid filter" applied optionally at the bands 1--4. */
 #define COEFF1 0.031273141818515176604f /**< Filter coefficient 0 for hybrid filtering */
@@ -80,14 +67,6 @@ extern "C" {
 /*                            Internal structures                             */
 /* ========================================================================== */
 
-/**
- * Complex data type used by afSTFTlib
- */
-typedef struct {
-    float *re;
-    float *im;
-} complexVector;
-
 /**
  * Main data structure for afSTFTlib
  */
@@ -102,19 +81,19 @@ typedef struct{
     int totalHops;
     float *protoFilter;
     float *protoFilterI;
-    float **inBuffer;
-    float *fftProcessFrameTD;
-    float **outBuffer;
-#ifdef AFSTFT_USE_SAF_UTILITIES
+    /* All channels are processed together. Therefore, the buffers are stored
+     * hop-major, such that the data of one hop is contiguous over channels, and
+     * the prototype filters are repeated for each channel accordingly */
+    int maxChannels;          /**< Number of channels the work buffers can hold */
+    float *inBuffer;          /**< Input history; FLAT: totalHops x inChannels x hopSize */
+    float *outBuffer;         /**< Output history; FLAT: totalHops x outChannels x hopSize */
+    float *protoFilterMC;     /**< protoFilter per input channel; FLAT: totalHops x inChannels x hopSize */
+    float *protoFilterIMC;    /**< protoFilterI per output channel; FLAT: totalHops x outChannels x hopSize */
+    float *foldBuffer[2];     /**< Left/right halves of the frames; FLAT: maxChannels x hopSize */
+    float *tempBuffer;        /**< Temporary buffer; FLAT: maxChannels x hopSize */
+    float *fftProcessFrameTD; /**< Time-domain frames; FLAT: maxChannels x 2*hopSize */
     void* hSafFFT;
-    float_complex *fftProcessFrameFD;
-    float* tempHopBuffer;
-#else
-    int pr;
-    int log2n;
-    void *vtFFT;
-    float *fftProcessFrameFD;
-#endif
+    float_complex *fftProcessFrameFD; /**< Frequency-domain frames; FLAT: maxChannels x (hopSize+1) */
     void *h_afHybrid;
     int hybridMode;
     
@@ -132,7 +111,7 @@ typedef struct{
     int outChannels;
     int hopSize;
     float hybridCoeffs[3];
-    complexVector **analysisBuffer;
+    float_complex *analysisBuffer; /**< Last 7 spectra; FLAT: inChannels x 7 x (hopSize+1) */
     int loopPointer;
 } afHybrid;
 
@@ -172,14 +151,36 @@ void afSTFTlib_channelChange(void* handle,
 /** Flushes time-domain buffers with zeros */
 void afSTFTlib_clearBuffers(void* handle);
 
-/** Applies the forward afSTFT transform */
+/**
+ * Applies the forward afSTFT transform
+ *
+ * @param[in]  handle     afSTFTlib handle
+ * @param[in]  inTD       Input hop; inChannels x hopSize
+ * @param[out] outFD      Output spectra; band "b" of channel "ch" is written to
+ *                        outFD[b*bandStride + ch*chStride]
+ * @param[in]  bandStride Distance between the bands of outFD
+ * @param[in]  chStride   Distance between the channels of outFD
+ */
 void afSTFTlib_forward(void* handle,
                        float** inTD,
-                       complexVector* outFD);
+                       float_complex* outFD,
+                       int bandStride,
+                       int chStride);
 
-/** Applies the backward afSTFT transform. */
+/**
+ * Applies the backward afSTFT transform
+ *
+ * @param[in]  handle     afSTFTlib handle
+ * @param[in]  inFD       Input spectra; band "b" of channel "ch" is read from
+ *                        inFD[b*bandStride + ch*chStride]
+ * @param[in]  bandStride Distance between the bands of inFD
+ * @param[in]  chStride   Distance between the channels of inFD
+ * @param[out] outTD      Output hop; outChannels x hopSize
+ */
 void afSTFTlib_inverse(void* handle,
-                       complexVector* inFD,
+                       float_complex* inFD,
+                       int bandStride,
+                       int chStride,
                        float** outTD);
 
 /** Destroys an instance of afSTFTlib */
@@ -191,13 +192,35 @@ void afHybridInit(void** handle,
                   int inChannels,
                   int outChannels);
 
-/** Forward hybrid-filtering transform */
+/**
+ * Forward hybrid-filtering transform
+ *
+ * @param[in]  handle     afHybrid handle
+ * @param[in]  inFD       FFT spectra; FLAT: inChannels x (hopSize+1)
+ * @param[out] outFD      Hybrid spectra; see afSTFTlib_forward()
+ * @param[in]  bandStride Distance between the bands of outFD
+ * @param[in]  chStride   Distance between the channels of outFD
+ */
 void afHybridForward(void* handle,
-                     complexVector* FD);
+                     float_complex* inFD,
+                     float_complex* outFD,
+                     int bandStride,
+                     int chStride);
 
-/** Inverse hybrid-filtering transform */
+/**
+ * Inverse hybrid-filtering transform
+ *
+ * @param[in]  handle     afHybrid handle
+ * @param[in]  inFD       Hybrid spectra; see afSTFTlib_inverse()
+ * @param[in]  bandStride Distance between the bands of inFD
+ * @param[in]  chStride   Distance between the channels of inFD
+ * @param[out] outFD      FFT spectra; FLAT: outChannels x (hopSize+1)
+ */
 void afHybridInverse(void* handle,
-                     complexVector* FD);
+                     float_complex* inFD,
+                     int bandStride,
+                     int chStride,
+                     float_complex* outFD);
 
 /** Frees an instnce of the afHybrid filtering structure */
 void afHybridFree(void* handle);
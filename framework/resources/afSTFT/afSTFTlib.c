@@ -127,8 +127,8 @@ typedef struct _afSTFT_data {
     int nBands;                       /**< Number of frequency bands */
     AFSTFT_FDDATA_FORMAT format;      /**< see #AFSTFT_FDDATA_FORMAT */
     void* hInt;                       /**< Internal handle for afSTFT */
-    complexVector* STFTInputFrameTF;  /**< Internal input complex buffer */
-    complexVector* STFTOutputFrameTF; /**< Internal output complex buffer */
+    float_complex* STFTInputFrameTF;  /**< Internal input buffer (only used by afSTFT_forward()); FLAT: nCHin x nBands */
+    float_complex* STFTOutputFrameTF; /**< Internal output buffer (only used by afSTFT_backward()); FLAT: nCHout x nBands */
     int afSTFTdelay;                  /**< Processing delay in samples */
     float** tempHopFrameTD;           /**< temporary multi-channel time-domain buffer of size "HOP_SIZE". */
 
@@ -152,7 +152,6 @@ void afSTFT_create
 {
     *phSTFT = malloc1d(sizeof(afSTFT_data));
     afSTFT_data *h = (afSTFT_data*)(*phSTFT);
-    int ch;
 
     if(hybridmode)
         assert(hopsize==64 || hopsize==128 || hopsize==256);
@@ -173,26 +172,10 @@ void afSTFT_create
     afSTFTlib_init(&(h->hInt), hopsize, nCHin, nCHout, lowDelayMode, hybridmode);
 
     /* temp buffers */
-    if(nCHout>0){
-        h->STFTOutputFrameTF = malloc1d(nCHout * sizeof(complexVector));
-        for(ch=0; ch < nCHout; ch++) {
-            h->STFTOutputFrameTF[ch].re = (float*)calloc1d(h->nBands, sizeof(float));
-            h->STFTOutputFrameTF[ch].im = (float*)calloc1d(h->nBands, sizeof(float));
-        }
-    }
-    else
-        h->STFTOutputFrameTF = NULL;
+    h->STFTOutputFrameTF = nCHout>0 ? calloc1d(nCHout*(h->nBands), sizeof(float_complex)) : NULL;
     if(nCHout > 0 || nCHin > 0)
         h->tempHopFrameTD = (float**)malloc2d( SAF_MAX(nCHin, nCHout), hopsize, sizeof(float));
-    if(nCHin>0){
-        h->STFTInputFrameTF = malloc1d(nCHin * sizeof(complexVector));
-        for(ch=0; ch < nCHin; ch++) {
-            h->STFTInputFrameTF[ch].re = (float*)calloc1d(h->nBands, sizeof(float));
-            h->STFTInputFrameTF[ch].im = (float*)calloc1d(h->nBands, sizeof(float));
-        }
-    }
-    else
-        h->STFTInputFrameTF = NULL;
+    h->STFTInputFrameTF = nCHin>0 ? calloc1d(nCHin*(h->nBands), sizeof(float_complex)) : NULL;
 }
 
 void afSTFT_destroy
@@ -201,21 +184,10 @@ void afSTFT_destroy
 )
 {
     afSTFT_data *h = (afSTFT_data*)(*phSTFT);
-    int ch;
 
     if(h!=NULL){
         /* For run-time */
         afSTFTlib_free(h->hInt);
-        if(h->STFTInputFrameTF!=NULL){
-            for (ch = 0; ch< h->nCHin; ch++) {
-                free(h->STFTInputFrameTF[ch].re);
-                free(h->STFTInputFrameTF[ch].im);
-            }
-        }
-        for (ch = 0; ch< h->nCHout; ch++) {
-            free(h->STFTOutputFrameTF[ch].re);
-            free(h->STFTOutputFrameTF[ch].im);
-        }
         free(h->STFTInputFrameTF);
         free(h->STFTOutputFrameTF);
         free(h->tempHopFrameTD);
@@ -245,20 +217,18 @@ void afSTFT_forward
         /* forward transform */
         for(ch = 0; ch < h->nCHin; ch++)
             utility_svvcopy(&(dataTD[ch][t*(h->hopsize)]), (h->hopsize), h->tempHopFrameTD[ch]);
-        afSTFTlib_forward(h->hInt, h->tempHopFrameTD, h->STFTInputFrameTF);
+        afSTFTlib_forward(h->hInt, h->tempHopFrameTD, h->STFTInputFrameTF, 1, h->nBands);
 
-        /* store */
+        /* store (the dimensions of dataFD are unknown, so via the internal buffer) */
         switch(h->format){
             case AFSTFT_BANDS_CH_TIME:
                 for(band=0; band<h->nBands; band++)
                     for(ch=0; ch < h->nCHin; ch++)
-                        dataFD[band][ch][t] = cmplxf(h->STFTInputFrameTF[ch].re[band], h->STFTInputFrameTF[ch].im[band]);
+                        dataFD[band][ch][t] = h->STFTInputFrameTF[ch*(h->nBands)+band];
                 break;
             case AFSTFT_TIME_CH_BANDS:
-                for(ch=0; ch < h->nCHin; ch++){
-                    cblas_scopy(h->nBands, h->STFTInputFrameTF[ch].re, 1, (float*)dataFD[t][ch], 2);
-                    cblas_scopy(h->nBands, h->STFTInputFrameTF[ch].im, 1, &((float*)dataFD[t][ch])[1], 2);
-                }
+                for(ch=0; ch < h->nCHin; ch++)
+                    memcpy(dataFD[t][ch], &(h->STFTInputFrameTF[ch*(h->nBands)]), h->nBands*sizeof(float_complex));
                 break;
         }
     }
@@ -287,21 +257,14 @@ void afSTFT_forward_knownDimensions
         /* forward transform */
         for(ch = 0; ch < h->nCHin; ch++)
             utility_svvcopy(&(dataTD[ch][t*(h->hopsize)]), (h->hopsize), h->tempHopFrameTD[ch]);
-        afSTFTlib_forward(h->hInt, h->tempHopFrameTD, h->STFTInputFrameTF);
 
-        /* store */
+        /* transform straight into dataFD */
         switch(h->format){
             case AFSTFT_BANDS_CH_TIME:
-                for(ch=0; ch < h->nCHin; ch++){
-                    cblas_scopy(h->nBands, h->STFTInputFrameTF[ch].re, 1, (float*)&pDataFD[0*dataFD_nCH*nHops + ch*dataFD_nHops + t], dataFD_nCH*dataFD_nHops*2);
-                    cblas_scopy(h->nBands, h->STFTInputFrameTF[ch].im, 1, &((float*)&pDataFD[0*dataFD_nCH*nHops + ch*dataFD_nHops + t])[1], dataFD_nCH*dataFD_nHops*2);
-                }
+                afSTFTlib_forward(h->hInt, h->tempHopFrameTD, &pDataFD[t], dataFD_nCH*dataFD_nHops, dataFD_nHops);
                 break;
             case AFSTFT_TIME_CH_BANDS:
-                for(ch=0; ch < h->nCHin; ch++){
-                    cblas_scopy(h->nBands, h->STFTInputFrameTF[ch].re, 1, (float*)dataFD[t][ch], 2);
-                    cblas_scopy(h->nBands, h->STFTInputFrameTF[ch].im, 1, &((float*)dataFD[t][ch])[1], 2);
-                }
+                afSTFTlib_forward(h->hInt, h->tempHopFrameTD, &pDataFD[t*dataFD_nCH*(h->nBands)], 1, h->nBands);
                 break;
         }
     }
@@ -316,7 +279,7 @@ void afSTFT_forward_flat
 )
 {
     afSTFT_data *h = (afSTFT_data*)(hSTFT);
-    int ch, t, nHops, band;
+    int ch, t, nHops;
 
     assert(framesize % h->hopsize == 0); /* framesize must be multiple of hopsize */
     nHops = framesize/h->hopsize;
@@ -326,19 +289,14 @@ void afSTFT_forward_flat
         /* forward transform */
         for(ch = 0; ch < h->nCHin; ch++)
             utility_svvcopy(&(dataTD[ch * framesize + t*(h->hopsize)]), (h->hopsize), h->tempHopFrameTD[ch]);
-        afSTFTlib_forward(h->hInt, h->tempHopFrameTD, h->STFTInputFrameTF);
 
-        /* store */
+        /* transform straight into dataFD */
         switch(h->format){
             case AFSTFT_BANDS_CH_TIME:
-                for(band=0; band<h->nBands; band++)
-                    for(ch=0; ch < h->nCHin; ch++)
-                        dataFD[band * (h->nCHin) * nHops + ch * nHops + t] = cmplxf(h->STFTInputFrameTF[ch].re[band], h->STFTInputFrameTF[ch].im[band]);
+                afSTFTlib_forward(h->hInt, h->tempHopFrameTD, &dataFD[t], (h->nCHin)*nHops, nHops);
                 break;
             case AFSTFT_TIME_CH_BANDS:
-                for(ch=0; ch < h->nCHin; ch++)
-                    for(band=0; band<h->nBands; band++)
-                        dataFD[t * (h->nCHin) * (h->nBands) + ch * (h->nBands) + band] = cmplxf(h->STFTInputFrameTF[ch].re[band], h->STFTInputFrameTF[ch].im[band]);
+                afSTFTlib_forward(h->hInt, h->tempHopFrameTD, &dataFD[t*(h->nCHin)*(h->nBands)], 1, h->nBands);
                 break;
         }
     }
@@ -363,23 +321,16 @@ void afSTFT_backward
         /* backward transform */
         switch(h->format){
             case AFSTFT_BANDS_CH_TIME:
-                for(band = 0; band < h->nBands; band++) {
-                    for(ch = 0; ch < h->nCHout; ch++) {
-                        h->STFTOutputFrameTF[ch].re[band] = crealf(dataFD[band][ch][t]);
-                        h->STFTOutputFrameTF[ch].im[band] = cimagf(dataFD[band][ch][t]);
-                    }
-                }
+                for(band = 0; band < h->nBands; band++)
+                    for(ch = 0; ch < h->nCHout; ch++)
+                        h->STFTOutputFrameTF[ch*(h->nBands)+band] = dataFD[band][ch][t];
                 break;
             case AFSTFT_TIME_CH_BANDS:
-                for(band = 0; band < h->nBands; band++) {
-                    for(ch = 0; ch < h->nCHout; ch++) {
-                        h->STFTOutputFrameTF[ch].re[band] = crealf(dataFD[t][ch][band]);
-                        h->STFTOutputFrameTF[ch].im[band] = cimagf(dataFD[t][ch][band]);
-                    }
-                }
+                for(ch = 0; ch < h->nCHout; ch++)
+                    memcpy(&(h->STFTOutputFrameTF[ch*(h->nBands)]), dataFD[t][ch], h->nBands*sizeof(float_complex));
                 break;
         }
-        afSTFTlib_inverse(h->hInt, h->STFTOutputFrameTF, h->tempHopFrameTD);
+        afSTFTlib_inverse(h->hInt, h->STFTOutputFrameTF, 1, h->nBands, h->tempHopFrameTD);
 
         /* store */
         for (ch = 0; ch <  h->nCHout; ch++)
@@ -407,22 +358,15 @@ void afSTFT_backward_knownDimensions
 
     /* Loop over hops */
     for(t = 0; t < nHops; t++) {
-        /* backward transform */
+        /* backward transform straight from dataFD */
         switch(h->format){
             case AFSTFT_BANDS_CH_TIME:
-                for(ch=0; ch < h->nCHout; ch++){
-                    cblas_scopy(h->nBands, (float*)&pDataFD[0*dataFD_nCH*nHops + ch*dataFD_nHops + t], dataFD_nCH*dataFD_nHops*2, h->STFTOutputFrameTF[ch].re, 1);
-                    cblas_scopy(h->nBands, &((float*)&pDataFD[0*dataFD_nCH*nHops + ch*dataFD_nHops + t])[1], dataFD_nCH*dataFD_nHops*2, h->STFTOutputFrameTF[ch].im, 1);
-                }
+                afSTFTlib_inverse(h->hInt, &pDataFD[t], dataFD_nCH*dataFD_nHops, dataFD_nHops, h->tempHopFrameTD);
                 break;
             case AFSTFT_TIME_CH_BANDS:
-                for(ch = 0; ch < h->nCHout; ch++) {
-                    cblas_scopy(h->nBands, (float*)dataFD[t][ch], 2, h->STFTOutputFrameTF[ch].re, 1);
-                    cblas_scopy(h->nBands, &((float*)dataFD[t][ch])[1], 2, h->STFTOutputFrameTF[ch].im, 1);
-                }
+                afSTFTlib_inverse(h->hInt, &pDataFD[t*dataFD_nCH*(h->nBands)], 1, h->nBands, h->tempHopFrameTD);
                 break;
         }
-        afSTFTlib_inverse(h->hInt, h->STFTOutputFrameTF, h->tempHopFrameTD);
 
         /* store */
         for (ch = 0; ch <  h->nCHout; ch++)
@@ -439,33 +383,22 @@ void afSTFT_backward_flat
 )
 {
     afSTFT_data *h = (afSTFT_data*)(hSTFT);
-    int ch, t, nHops, band;
+    int ch, t, nHops;
 
     assert(framesize % h->hopsize == 0); /* framesize must be multiple of hopsize */
     nHops = framesize/h->hopsize;
 
     /* Loop over hops */
     for(t = 0; t < nHops; t++) {
-        /* backward transform */
+        /* backward transform straight from dataFD */
         switch(h->format){
             case AFSTFT_BANDS_CH_TIME:
-                for(band = 0; band < h->nBands; band++) {
-                    for(ch = 0; ch < h->nCHout; ch++) {
-                        h->STFTOutputFrameTF[ch].re[band] = crealf(dataFD[band * (h->nCHout) * nHops + ch * nHops + t]);
-                        h->STFTOutputFrameTF[ch].im[band] = cimagf(dataFD[band * (h->nCHout) * nHops + ch * nHops + t]);
-                    }
-                }
+                afSTFTlib_inverse(h->hInt, &dataFD[t], (h->nCHout)*nHops, nHops, h->tempHopFrameTD);
                 break;
             case AFSTFT_TIME_CH_BANDS:
-                for(band = 0; band < h->nBands; band++) {
-                    for(ch = 0; ch < h->nCHout; ch++) {
-                        h->STFTOutputFrameTF[ch].re[band] = crealf(dataFD[t * (h->nCHout) * (h->nBands) + ch * (h->nBands) + band]);
-                        h->STFTOutputFrameTF[ch].im[band] = cimagf(dataFD[t * (h->nCHout) * (h->nBands) + ch * (h->nBands) + band]);
-                    }
-                }
+                afSTFTlib_inverse(h->hInt, &dataFD[t*(h->nCHout)*(h->nBands)], 1, h->nBands, h->tempHopFrameTD);
                 break;
         }
-        afSTFTlib_inverse(h->hInt, h->STFTOutputFrameTF, h->tempHopFrameTD);
 
         /* store */
         for (ch = 0; ch <  h->nCHout; ch++)
@@ -481,33 +414,14 @@ void afSTFT_channelChange
 )
 {
     afSTFT_data *h = (afSTFT_data*)(hSTFT);
-    int i;
 
     afSTFTlib_channelChange(h->hInt, new_nCHin, new_nCHout);
 
     /* resize buffers */
-    if(h->nCHin!=new_nCHin){
-        for(i=new_nCHin; i<h->nCHin; i++){
-            free(h->STFTInputFrameTF[i].re);
-            free(h->STFTInputFrameTF[i].im);
-        }
-        h->STFTInputFrameTF = realloc1d(h->STFTInputFrameTF, sizeof(complexVector)*new_nCHin);
-        for(i=h->nCHin; i<new_nCHin; i++){
-            h->STFTInputFrameTF[i].re = (float*)calloc1d(h->nBands, sizeof(float));
-            h->STFTInputFrameTF[i].im = (float*)calloc1d(h->nBands, sizeof(float));
-        }
-    }
-    if(h->nCHout!=new_nCHout){
-        for(i=new_nCHout; i<h->nCHout; i++){
-            free(h->STFTOutputFrameTF[i].re);
-            free(h->STFTOutputFrameTF[i].im);
-        }
-        h->STFTOutputFrameTF = realloc1d(h->STFTOutputFrameTF, sizeof(complexVector)*new_nCHout);
-        for(i=h->nCHout; i<new_nCHout; i++){
-            h->STFTOutputFrameTF[i].re = (float*)calloc1d(h->nBands, sizeof(float));
-            h->STFTOutputFrameTF[i].im = (float*)calloc1d(h->nBands, sizeof(float));
-        }
-    }
+    if(h->nCHin!=new_nCHin)
+        h->STFTInputFrameTF = realloc1d(h->STFTInputFrameTF, SAF_MAX(new_nCHin,1)*(h->nBands)*sizeof(float_complex));
+    if(h->nCHout!=new_nCHout)
+        h->STFTOutputFrameTF = realloc1d(h->STFTOutputFrameTF, SAF_MAX(new_nCHout,1)*(h->nBands)*sizeof(float_complex));
     if( SAF_MAX(h->nCHin, h->nCHout) != SAF_MAX(new_nCHin, new_nCHout))
         h->tempHopFrameTD = (float**)realloc2d((void**)h->tempHopFrameTD, SAF_MAX(new_nCHin, new_nCHout), h->hopsize, sizeof(float));
 
@@ -54,20 +54,7 @@
 extern "C" {
 #endif /* __cplusplus */
    
-/**
- * Remove the "AFSTFT_USE_SAF_UTILITIES" definition, and add the vecTools.h/c
- * and fft4g.h/c to your project, if you want to use the original afSTFT vector
- * code. Note the vecTools.h/c and fft4g.h/c files, may be found here:
- *     https://github.com/jvilkamo/afSTFT
- */
-#define AFSTFT_USE_SAF_UTILITIES
-#ifdef AFSTFT_USE_SAF_UTILITIES
-# include "../../modules/saf_utilities/saf_utilities.h"
-#else
-# include <stdio.h>
-# include <stdlib.h>
-# include <string.h>
-#endif
+#include "../../modules/saf_utilities/saf_utilities.h"
     
 /** Prototype filter used by afSTFTlib */
 extern const float __afSTFT_protoFilter1024[10240];
@@ -13,6 +13,9 @@
  * @license BSD 3-Clause
  */
 
+#ifndef _kiss_fft_guts_h
+#define _kiss_fft_guts_h
+
 /* kiss_fft.h
    defines kiss_fft_scalar as either short or a float type
    and defines
@@ -165,3 +168,5 @@ struct kiss_fft_state{
 #define  KISS_FFT_TMP_ALLOC(nbytes) KISS_FFT_MALLOC(nbytes)
 #define  KISS_FFT_TMP_FREE(ptr) KISS_FFT_FREE(ptr)
 #endif
+
+#endif /* _kiss_fft_guts_h */
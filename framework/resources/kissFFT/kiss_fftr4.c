@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2003-2004, Mark Borgerding. All rights reserved.
+ *  This file is part of KISS FFT - https://github.com/mborgerding/kissfft
+ *
+ *  SPDX-License-Identifier: BSD-3-Clause
+ *  See COPYING file for more information.
+ */
+
+/**
+ * @file kiss_fftr4.c
+ * @brief KISS real FFT built with USE_SIMD (four transforms at once), taken
+ *        from: https://github.com/mborgerding/kissfft
+ * @author Mark Borgerding
+ * @license BSD 3-Clause
+ */
+
+#include "kiss_fftr4.h"
+
+#ifdef KISS_FFTR4_ENABLED
+
+/* Compile kiss_fft.c and kiss_fftr.c again, with kiss_fft_scalar as __m128,
+ * and with all of the exported names changed */
+#define USE_SIMD
+#define kiss_fft_state          kiss_fft4_state
+#define kiss_fft_cfg            kiss_fft4_cfg
+#define kiss_fft_alloc          kiss_fft4_alloc
+#define kiss_fft                kiss_fft4
+#define kiss_fft_stride         kiss_fft4_stride
+#define kiss_fft_cleanup        kiss_fft4_cleanup
+#define kiss_fft_next_fast_size kiss_fft4_next_fast_size
+#define kf_work                 kf4_work
+#define kf_factor               kf4_factor
+#define kiss_fftr_state         kiss_fftr4_state
+#define kiss_fftr_cfg           kiss_fftr4_cfg_
+#define kiss_fftr_alloc         kiss_fftr4_alloc_
+#define kiss_fftr               kiss_fftr4_
+#define kiss_fftri              kiss_fftri4_
+
+#include "kiss_fft.c"
+#include "kiss_fftr.c"
+
+kiss_fftr4_cfg kiss_fftr4_alloc(int nfft,int inverse_fft)
+{
+    return (kiss_fftr4_cfg)kiss_fftr4_alloc_(nfft, inverse_fft, NULL, NULL);
+}
+
+void kiss_fftr4(kiss_fftr4_cfg cfg,const float *timedata,float *freqdata)
+{
+    kiss_fftr4_(cfg, (const kiss_fft_scalar*)timedata, (kiss_fft_cpx*)freqdata);
+}
+
+void kiss_fftri4(kiss_fftr4_cfg cfg,const float *freqdata,float *timedata)
+{
+    kiss_fftri4_(cfg, (const kiss_fft_cpx*)freqdata, (kiss_fft_scalar*)timedata);
+}
+
+void kiss_fftr4_free(kiss_fftr4_cfg cfg)
+{
+    KISS_FFT_FREE(cfg);
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2003-2004, Mark Borgerding. All rights reserved.
+ *  This file is part of KISS FFT - https://github.com/mborgerding/kissfft
+ *
+ *  SPDX-License-Identifier: BSD-3-Clause
+ *  See COPYING file for more information.
+ */
+
+/**
+ * @file kiss_fftr4.h
+ * @brief The default real <-> half-complex FFT, performing four transforms at
+ *        once with SSE (i.e. kissFFT built with USE_SIMD)
+ *
+ * This is kiss_fftr.c/kiss_fft.c compiled a second time with USE_SIMD, under
+ * different names, so that it may be used alongside the scalar version. It is
+ * only available if SAF_ENABLE_SIMD is defined and the compiler supports
+ * arithmetic on SSE vector types (GCC and Clang).
+ *
+ * Taken from: https://github.com/mborgerding/kissfft
+ *
+ * @author Mark Borgerding
+ * @license BSD 3-Clause
+ */
+
+#ifndef KISS_FTR4_H
+#define KISS_FTR4_H
+
+#include <stddef.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(SAF_ENABLE_SIMD) && (defined(__GNUC__) || defined(__clang__))
+# define KISS_FFTR4_ENABLED /**< kiss_fftr4_alloc() etc. are available */
+
+typedef struct kiss_fftr4_state *kiss_fftr4_cfg;
+
+
+kiss_fftr4_cfg kiss_fftr4_alloc(int nfft,int inverse_fft);
+/*
+ nfft must be even
+*/
+
+void kiss_fftr4(kiss_fftr4_cfg cfg,const float *timedata,float *freqdata);
+/*
+ input timedata has nfft x 4 points (16-byte aligned), where timedata[4*n+i]
+ is sample n of signal i
+ output freqdata has nfft/2+1 x {4 real parts, 4 imaginary parts} (16-byte
+ aligned), where freqdata[8*k+i] and freqdata[8*k+4+i] are bin k of signal i
+*/
+
+void kiss_fftri4(kiss_fftr4_cfg cfg,const float *freqdata,float *timedata);
+/*
+ input freqdata has nfft/2+1 x {4 real parts, 4 imaginary parts}
+ output timedata has nfft x 4 points (not scaled by 1/nfft)
+*/
+
+void kiss_fftr4_free(kiss_fftr4_cfg cfg);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -46,6 +46,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <assert.h>
 #include "md_malloc.h"
 
@@ -56,8 +57,45 @@
 # define MAX(a,b) (( (a) > (b) ) ? (a) : (b))
 #endif
 
+#ifdef SAF_ENABLE_RT_ALLOC_CHECKS
+# if defined(_MSC_VER)
+#  define MD_THREAD_LOCAL __declspec(thread)
+# else
+#  define MD_THREAD_LOCAL __thread
+# endif
+/** Number of real-time scopes currently entered by this thread */
+static MD_THREAD_LOCAL int md_rtScopeDepth = 0;
+
+/** Aborts if called within a real-time scope */
+static void md_rtCheck(const char* funcName)
+{
+    if(md_rtScopeDepth>0){
+        fprintf(stderr, "Error: '%s' was called within a real-time scope.\n", funcName);
+        abort();
+    }
+}
+#endif
+
+void md_rtScope_enter(void)
+{
+#ifdef SAF_ENABLE_RT_ALLOC_CHECKS
+    md_rtScopeDepth++;
+#endif
+}
+
+void md_rtScope_exit(void)
+{
+#ifdef SAF_ENABLE_RT_ALLOC_CHECKS
+    assert(md_rtScopeDepth>0);
+    md_rtScopeDepth--;
+#endif
+}
+
 void* malloc1d(size_t dim1_data_size)
 {
+#ifdef SAF_ENABLE_RT_ALLOC_CHECKS
+    md_rtCheck("malloc1d");
+#endif
     void *ptr = malloc(dim1_data_size);
 #if !defined(NDEBUG)
     if (ptr == NULL && dim1_data_size!=0)
@@ -68,6 +106,9 @@ void* malloc1d(size_t dim1_data_size)
 
 void* calloc1d(size_t dim1, size_t data_size)
 {
+#ifdef SAF_ENABLE_RT_ALLOC_CHECKS
+    md_rtCheck("calloc1d");
+#endif
     void *ptr = calloc(dim1, data_size);
 #if !defined(NDEBUG)
     if (ptr == NULL && dim1!=0)
@@ -78,6 +119,9 @@ void* calloc1d(size_t dim1, size_t data_size)
 
 void* realloc1d(void* ptr, size_t dim1_data_size)
 {
+#ifdef SAF_ENABLE_RT_ALLOC_CHECKS
+    md_rtCheck("realloc1d");
+#endif
     ptr = realloc(ptr, dim1_data_size);
 #if !defined(NDEBUG)
     if (ptr == NULL && dim1_data_size!=0)
@@ -543,3 +587,134 @@ void****** realloc6d(void****** ptr, size_t dim1, size_t dim2, size_t dim3, size
                          p5[i*dim2*dim3*dim4*dim5 + j*dim3*dim4*dim5 + k*dim4*dim5 + l*dim5 + p] = &p6[i*stride1 + j*stride2 + k*stride3 + l*stride4 + p*stride5];
     return ptr;
 }
+
+/** Returns the number of bytes from "addr" to the next aligned address */
+static size_t md_alignOffset(const void* addr)
+{
+    return (MD_MALLOC_ALIGNMENT - (size_t)((uintptr_t)addr % MD_MALLOC_ALIGNMENT)) % MD_MALLOC_ALIGNMENT;
+}
+
+size_t md_alignedStride(size_t dim, size_t data_size)
+{
+    size_t step;
+    if(data_size==0)
+        return dim;
+    /* (the smallest multiple of the alignment, which is also a multiple of the element size) */
+    for(step=MD_MALLOC_ALIGNMENT; step%data_size!=0; step+=MD_MALLOC_ALIGNMENT);
+    return ((dim*data_size + step - 1)/step) * (step/data_size);
+}
+
+void* malloc1d_aligned(size_t dim1_data_size)
+{
+    unsigned char *raw, *ptr;
+    /* The pointer returned by malloc is stored just before the aligned block */
+    raw = malloc1d(sizeof(void*) + MD_MALLOC_ALIGNMENT-1 + dim1_data_size);
+    if(raw==NULL)
+        return NULL;
+    ptr = raw + sizeof(void*);
+    ptr += md_alignOffset(ptr);
+    ((void**)ptr)[-1] = raw;
+    return ptr;
+}
+
+void* calloc1d_aligned(size_t dim1, size_t data_size)
+{
+    void *ptr = malloc1d_aligned(dim1*data_size);
+    if(ptr!=NULL)
+        memset(ptr, 0, dim1*data_size);
+    return ptr;
+}
+
+void free1d_aligned(void* ptr)
+{
+    if(ptr!=NULL)
+        free(((void**)ptr)[-1]);
+}
+
+void** malloc2d_aligned(size_t dim1, size_t dim2, size_t data_size)
+{
+    size_t i, stride;
+    void** ptr;
+    unsigned char* p2;
+    stride = md_alignedStride(dim2, data_size)*data_size;
+    ptr = malloc1d(dim1*sizeof(void*) + MD_MALLOC_ALIGNMENT-1 + dim1*stride);
+    p2 = (unsigned char*)(ptr + dim1);
+    p2 += md_alignOffset(p2);
+    for(i=0; i<dim1; i++)
+        ptr[i] = &p2[i*stride];
+    return ptr;
+}
+
+void** calloc2d_aligned(size_t dim1, size_t dim2, size_t data_size)
+{
+    size_t i, stride;
+    void** ptr;
+    unsigned char* p2;
+    stride = md_alignedStride(dim2, data_size)*data_size;
+    ptr = calloc1d(1, dim1*sizeof(void*) + MD_MALLOC_ALIGNMENT-1 + dim1*stride);
+    p2 = (unsigned char*)(ptr + dim1);
+    p2 += md_alignOffset(p2);
+    for(i=0; i<dim1; i++)
+        ptr[i] = &p2[i*stride];
+    return ptr;
+}
+
+void free2d_aligned(void** ptr)
+{
+    /* (the pointers and the aligned rows are all in the one block) */
+    free(ptr);
+}
+
+void*** malloc3d_aligned(size_t dim1, size_t dim2, size_t dim3, size_t data_size)
+{
+    size_t i, j, stride1, stride2;
+    void*** ptr;
+    void** p2;
+    unsigned char* p3;
+    stride2 = md_alignedStride(dim3, data_size)*data_size;
+    stride1 = dim2*stride2;
+    ptr = malloc1d(dim1*sizeof(void**) + dim1*dim2*sizeof(void*) + MD_MALLOC_ALIGNMENT-1 + dim1*stride1);
+    p2 = (void**)(ptr + dim1);
+    p3 = (unsigned char*)(p2 + dim1*dim2);
+    p3 += md_alignOffset(p3);
+    for(i=0;i<dim1;i++)
+        ptr[i] = &p2[i*dim2];
+    for(i=0;i<dim1;i++)
+        for(j=0;j<dim2;j++)
+            p2[i*dim2+j] = &p3[i*stride1 + j*stride2];
+    return ptr;
+}
+
+void*** calloc3d_aligned(size_t dim1, size_t dim2, size_t dim3, size_t data_size)
+{
+    size_t i, j, stride1, stride2;
+    void*** ptr;
+    void** p2;
+    unsigned char* p3;
+    stride2 = md_alignedStride(dim3, data_size)*data_size;
+    stride1 = dim2*stride2;
+    ptr = calloc1d(1, dim1*sizeof(void**) + dim1*dim2*sizeof(void*) + MD_MALLOC_ALIGNMENT-1 + dim1*stride1);
+    p2 = (void**)(ptr + dim1);
+    p3 = (unsigned char*)(p2 + dim1*dim2);
+    p3 += md_alignOffset(p3);
+    for(i=0;i<dim1;i++)
+        ptr[i] = &p2[i*dim2];
+    for(i=0;i<dim1;i++)
+        for(j=0;j<dim2;j++)
+            p2[i*dim2+j] = &p3[i*stride1 + j*stride2];
+    return ptr;
+}
+
+void free3d_aligned(void*** ptr)
+{
+    free(ptr);
+}
+
+#ifdef SAF_ENABLE_RT_ALLOC_CHECKS
+#undef free
+void md_free(void* ptr)
+{
+    md_rtCheck("free");
+    free(ptr);
+}
+#endif
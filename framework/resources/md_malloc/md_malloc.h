@@ -169,6 +169,102 @@ void****** calloc6d(size_t dim1, size_t dim2, size_t dim3, size_t dim4,
 void****** realloc6d(void****** ptr, size_t dim1, size_t dim2, size_t dim3,
                      size_t dim4, size_t dim5, size_t dim6, size_t data_size);
 
+/**
+ * Alignment of the "_aligned" allocations, in bytes (i.e. one cache line, which
+ * is also the width of an AVX-512 register)
+ */
+#define MD_MALLOC_ALIGNMENT ( 64 )
+
+/**
+ * Returns the number of elements in each row of a "_aligned" 2-D/3-D array;
+ * i.e. "dim" rounded up, such that every row starts on an MD_MALLOC_ALIGNMENT
+ * boundary
+ *
+ * @note If the returned value is larger than "dim", then the rows are padded,
+ *       and the FLATTEN macros may not be used on the array. The returned value
+ *       may instead be passed as the leading dimension to BLAS routines.
+ */
+size_t md_alignedStride(size_t dim, size_t data_size);
+
+/**
+ * 1-D malloc, aligned to MD_MALLOC_ALIGNMENT bytes (use free1d_aligned() to
+ * deallocate)
+ *
+ * @test test__malloc_aligned()
+ */
+void* malloc1d_aligned(size_t dim1_data_size);
+
+/**
+ * 1-D calloc, aligned to MD_MALLOC_ALIGNMENT bytes (use free1d_aligned() to
+ * deallocate)
+ */
+void* calloc1d_aligned(size_t dim1, size_t data_size);
+
+/** Frees memory allocated by malloc1d_aligned() or calloc1d_aligned() */
+void free1d_aligned(void* ptr);
+
+/**
+ * 2-D malloc, where each row starts on an MD_MALLOC_ALIGNMENT boundary (use
+ * free2d_aligned() to deallocate)
+ *
+ * @test test__malloc_aligned()
+ */
+void** malloc2d_aligned(size_t dim1, size_t dim2, size_t data_size);
+
+/**
+ * 2-D calloc, where each row starts on an MD_MALLOC_ALIGNMENT boundary (use
+ * free2d_aligned() to deallocate)
+ */
+void** calloc2d_aligned(size_t dim1, size_t dim2, size_t data_size);
+
+/** Frees memory allocated by malloc2d_aligned() or calloc2d_aligned() */
+void free2d_aligned(void** ptr);
+
+/**
+ * 3-D malloc, where each row starts on an MD_MALLOC_ALIGNMENT boundary (use
+ * free3d_aligned() to deallocate)
+ *
+ * @test test__malloc_aligned()
+ */
+void*** malloc3d_aligned(size_t dim1, size_t dim2, size_t dim3,
+                         size_t data_size);
+
+/**
+ * 3-D calloc, where each row starts on an MD_MALLOC_ALIGNMENT boundary (use
+ * free3d_aligned() to deallocate)
+ */
+void*** calloc3d_aligned(size_t dim1, size_t dim2, size_t dim3,
+                         size_t data_size);
+
+/** Frees memory allocated by malloc3d_aligned() or calloc3d_aligned() */
+void free3d_aligned(void*** ptr);
+
+/**
+ * Marks the start of a real-time scope (e.g. a "_process()" call) on the
+ * calling thread; scopes may be nested
+ *
+ * If SAF_ENABLE_RT_ALLOC_CHECKS is defined, then the functions above (and
+ * free()) print an error message and abort, if they are called within such a
+ * scope. Otherwise, this function does nothing.
+ *
+ * @test test__saf_example_powermap()
+ */
+void md_rtScope_enter(void);
+
+/** Marks the end of a real-time scope started with md_rtScope_enter() */
+void md_rtScope_exit(void);
+
+#ifdef SAF_ENABLE_RT_ALLOC_CHECKS
+/*
+ * Note: SAF_ENABLE_RT_ALLOC_CHECKS is only defined (privately) when compiling
+ * SAF's own sources, so free() is not redirected in code that merely includes
+ * this header
+ */
+/** free() which aborts if it is called within a real-time scope */
+void md_free(void* ptr);
+# define free(ptr) md_free(ptr)
+#endif
+
 
 #ifdef __cplusplus
 } /*extern "C"*/
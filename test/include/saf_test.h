@@ -110,6 +110,10 @@ void test__quaternion(void);
  * Testing for perfect reconstruction of the saf_stft (when configured for 50%
  * window overlap) */
 void test__saf_stft_50pc_overlap(void);
+/**
+ * Testing for perfect reconstruction of the saf_stft (when configured for 75%
+ * and 87.5% window overlap) */
+void test__saf_stft_high_overlap(void);
 /** 
  * Testing for perfect reconstruction of the saf_stft (when configured for
  * linear time-invariant (LTI) filtering applications) */
@@ -117,16 +121,85 @@ void test__saf_stft_LTI(void);
 /**
  * Testing the forward and backward real-(half)complex FFT (saf_rfft) */
 void test__saf_rfft(void);
+/**
+ * Testing the batched forward and backward real-valued FFTs (saf_rfft) */
+void test__saf_rfft_batch(void);
 /**
  * Testing the forward and backward complex-complex FFT (saf_fft) */
 void test__saf_fft(void);
+/**
+ * Testing that FFT instances work (and share plans) with the different
+ * planner rigours (saf_fft_setPlannerRigour) */
+void test__saf_fft_planning(void);
+/**
+ * Testing the streaming overlap-save convolver (saf_fftconv) against direct
+ * convolution, single-threaded, with a private thread pool, and with a shared
+ * one */
+void test__saf_fftconv(void);
 /**
  * Testing the saf_matrixConv */
 void test__saf_matrixConv(void);
+/**
+ * Testing that the saf_matrixConv skips zero sub-filters/partitions correctly */
+void test__saf_matrixConv_sparse(void);
+/**
+ * Testing that saf_matrixConv_updateFilters() swaps in new filters seamlessly */
+void test__saf_matrixConv_updateFilters(void);
+/**
+ * Testing the saf_multiConv */
+void test__saf_multiConv(void);
+/**
+ * Testing that convolvers sharing filter spectra (saf_convSpectra) behave like
+ * those with their own */
+void test__saf_convSpectra(void);
+/**
+ * Testing that the saf_TVConv output is unchanged when employing a thread pool */
+void test__saf_TVConv(void);
+/**
+ * Testing that the saf_TVConv output is unchanged when the IRs are transformed on demand */
+void test__saf_TVConv_cache(void);
+/**
+ * Testing the saf_TVConv with interpolated IRs */
+void test__saf_TVConv_interp(void);
+/**
+ * Testing the saf_threadPool */
+void test__saf_threadPool(void);
+/**
+ * Testing that saf_threadPool_parallelFor() executes each iteration of a loop
+ * exactly once */
+void test__saf_threadPool_parallelFor(void);
+/**
+ * Testing that saf_stateSwap never hands back a state to the publishing thread
+ * while the real-time thread is still using it */
+void test__saf_stateSwap(void);
+/**
+ * Testing the saf_blockAdapter with various host block sizes */
+void test__saf_blockAdapter(void);
+/**
+ * Testing the saf_arena allocator, including that it is merged into one block
+ * upon reset */
+void test__saf_arena(void);
 /**
  * Testing the (near)-perfect reconstruction performance of the QMF filterbank
  */
 void test__qmf(void);
+/**
+ * Testing the common filterbank interface (saf_filterbank) with each of the
+ * supported filterbanks */
+void test__saf_filterbank(void);
+/**
+ * Testing that each of the run-time selectable SIMD kernels (saf_veclib) give
+ * the same results as scalar code */
+void test__saf_simdDispatch(void);
+/**
+ * Testing the fused complex multiply-accumulate functions (utility_cvvmac,
+ * utility_cvvmulsum, utility_crvvmac) against the unfused operations */
+void test__utility_cvvmac(void);
+/**
+ * Testing the batched linear algebra functions (utility_cseig_batch,
+ * utility_cslslv_batch, utility_csvd_batch) against the single matrix
+ * versions */
+void test__utility_batchedSolvers(void);
 /**
  * Testing that the smb_pitchShifter can shift the energy of input spectra by
  * one octave down */
@@ -348,6 +421,14 @@ void test__hades(void);
  * Testing the alias-free STFT filterbank (near)-perfect reconstruction
  * performance */
 void test__afSTFT(void);
+/**
+ * Testing that the multichannel afSTFT processing is bit-exact with processing
+ * each channel separately */
+void test__afSTFT_multichannel(void);
+/**
+ * Testing that the afSTFT transforms, which read/write the frequency-domain
+ * data in-place, give the same results as the regular afSTFT transforms */
+void test__afSTFT_layouts(void);
 /**
  * Testing the realloc2d_r() function (reallocating 2-D array, while retaining
  * the previous data order; except truncated or extended) */
@@ -361,6 +442,10 @@ void test__malloc5d(void);
 /**
  * Testing that malloc6d() works, and is truely contiguously allocated */
 void test__malloc6d(void);
+/**
+ * Testing that the "_aligned" variants of malloc/calloc give aligned rows,
+ * which do not overlap */
+void test__malloc_aligned(void);
 
 
 /* ========================================================================== */
@@ -373,6 +458,10 @@ void test__malloc6d(void);
  * Testing the SAF ambi_bin.h example (this may also serve as a tutorial on how
  * to use it) */
 void test__saf_example_ambi_bin(void);
+/**
+ * Testing that the SAF ambi_bin.h example keeps rendering, while being
+ * reconfigured on another thread */
+void test__saf_example_ambi_bin_liveReinit(void);
 /**
  * Testing the SAF ambi_dec.h example (this may also serve as a tutorial on how
  * to use it) */
@@ -389,10 +478,22 @@ void test__saf_example_array2sh(void);
  * Testing the SAF rotator.h example (this may also serve as a tutorial on how
  * to use it) */
 void test__saf_example_rotator(void);
+/**
+ * Testing the SAF ambi_drc.h example with each of its filterbanks (this may
+ * also serve as a tutorial on how to use it) */
+void test__saf_example_ambi_drc(void);
+/**
+ * Testing the SAF decorrelator.h example with each of its filterbanks (this
+ * may also serve as a tutorial on how to use it) */
+void test__saf_example_decorrelator(void);
 /**
  * Testing the SAF spreader.h example (this may also serve as a tutorial on how
  * to use it) */
 void test__saf_example_spreader(void);
+/**
+ * Testing the SAF powermap.h example, and that its analysis does not allocate
+ * memory (this may also serve as a tutorial on how to use it) */
+void test__saf_example_powermap(void);
 
 #endif /* SAF_ENABLE_EXAMPLES_TESTS */
 
@@ -0,0 +1,240 @@
+/*
+ * Copyright 2026 Spatial_Audio_Framework contributors
+ *
+ * This software is dual-licensed. Please refer to the LICENCE.md file for more
+ * information.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * @file saf_benchmark.c
+ * @brief Benchmarking program for the Spatial_Audio_Framework
+ *
+ * Unlike the unit testing program (saf_test), this program does not assert
+ * anything; it only prints the time taken by competing implementations of the
+ * same operation, so that thresholds and defaults (such as
+ * SAF_VECLIB_BATCH_JACOBI_MAX_DIM) may be chosen from measurements on the
+ * target machine. It is therefore not run as part of the unit tests.
+ *
+ * New benchmarks may be added by writing a "static void benchmark__xxx(void)"
+ * function, and calling it from main().
+ *
+ * @author Spatial_Audio_Framework contributors
+ * @date 16.10.2026
+ * @license Mixed (module dependent)
+ */
+
+#include "timer.h"           /* for timing the benchmarks */
+#include "saf.h"             /* master framework include header */
+#include "saf_externals.h"   /* to also include saf dependencies (cblas etc.) */
+
+/** Fills a batch of nBatch dim x dim Hermitian positive-definate matrices */
+static void benchmark__fillHermitian
+(
+    float_complex* A,
+    int dim,
+    int nBatch
+)
+{
+    int i, j, k, b;
+    float_complex* X;
+    const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
+
+    X = malloc1d(dim*dim*sizeof(float_complex));
+    for(b=0; b<nBatch; b++){
+        k = 0;
+        for(i=0; i<dim; i++)
+            for(j=0; j<dim; j++, k++)
+                X[i*dim+j] = cmplxf(sinf(0.37f*(float)(k+b)), cosf(0.91f*(float)(k*b+1)));
+        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, dim, dim, dim, &calpha,
+                    X, dim, X, dim, &cbeta, &A[b*dim*dim], dim);
+        for(i=0; i<dim; i++)
+            A[b*dim*dim+i*dim+i] = craddf(A[b*dim*dim+i*dim+i], (float)dim);
+    }
+    free(X);
+}
+
+/**
+ * Times the "_batch" eigen/linear solvers against calling their single matrix
+ * counterparts once per matrix (with a persistent work struct), for the matrix
+ * sizes that are typically found per band in the SAF examples
+ */
+static void benchmark__utility_batchedSolvers(void){
+    int d, b, dim, it;
+    void* hEig, *hSlv, *hSvd;
+    float_complex* A, *B, *X, *V;
+    float* eig;
+    tick_t start;
+    double tLoop, tBatch;
+
+    /* Config */
+    const int nBatch = 133; /* e.g. afSTFT bands */
+    const int nIterations = 20;
+    const int nCol = 2;
+    const int dims[5] = {2, 4, 8, 16, 25};
+
+    printf("utility_cseig_batch() / utility_cslslv_batch() / utility_csvd_batch(), %d matrices, per call [ms]:\n", nBatch);
+    printf("    dim   cseig (loop)   cseig_batch   cslslv (loop)   cslslv_batch   csvd (loop)   csvd_batch\n");
+    for(d=0; d<5; d++){
+        dim = dims[d];
+        A = malloc1d(nBatch*dim*dim*sizeof(float_complex));
+        B = malloc1d(nBatch*dim*nCol*sizeof(float_complex));
+        X = malloc1d(nBatch*dim*nCol*sizeof(float_complex));
+        V = malloc1d(nBatch*dim*dim*sizeof(float_complex));
+        eig = malloc1d(nBatch*dim*sizeof(float));
+        benchmark__fillHermitian(A, dim, nBatch);
+        for(it=0; it<nBatch*dim*nCol; it++)
+            B[it] = cmplxf(cosf(0.13f*(float)it), 0.0f);
+        utility_cseig_create(&hEig, dim);
+        utility_cslslv_create(&hSlv, dim, nCol);
+        utility_csvd_create(&hSvd, dim, dim);
+        printf("    %3d", dim);
+
+        /* Eigenvalue decomposition */
+        start = timer_current();
+        for(it=0; it<nIterations; it++)
+            for(b=0; b<nBatch; b++)
+                utility_cseig(hEig, &A[b*dim*dim], dim, 1, &V[b*dim*dim], NULL, &eig[b*dim]);
+        tLoop = 1e3*(double)timer_elapsed(start)/(double)nIterations;
+        start = timer_current();
+        for(it=0; it<nIterations; it++)
+            utility_cseig_batch(hEig, A, dim, nBatch, 1, V, NULL, eig);
+        tBatch = 1e3*(double)timer_elapsed(start)/(double)nIterations;
+        printf("   %12.3f  %12.3f", tLoop, tBatch);
+
+        /* Linear solve */
+        start = timer_current();
+        for(it=0; it<nIterations; it++)
+            for(b=0; b<nBatch; b++)
+                utility_cslslv(hSlv, &A[b*dim*dim], dim, &B[b*dim*nCol], nCol, &X[b*dim*nCol]);
+        tLoop = 1e3*(double)timer_elapsed(start)/(double)nIterations;
+        start = timer_current();
+        for(it=0; it<nIterations; it++)
+            utility_cslslv_batch(hSlv, A, dim, B, nCol, nBatch, X);
+        tBatch = 1e3*(double)timer_elapsed(start)/(double)nIterations;
+        printf("    %12.3f   %12.3f", tLoop, tBatch);
+
+        /* Singular value decomposition */
+        start = timer_current();
+        for(it=0; it<nIterations; it++)
+            for(b=0; b<nBatch; b++)
+                utility_csvd(hSvd, &A[b*dim*dim], dim, dim, NULL, NULL, &V[b*dim*dim], &eig[b*dim]);
+        tLoop = 1e3*(double)timer_elapsed(start)/(double)nIterations;
+        start = timer_current();
+        for(it=0; it<nIterations; it++)
+            utility_csvd_batch(hSvd, A, dim, dim, nBatch, NULL, NULL, V, eig);
+        tBatch = 1e3*(double)timer_elapsed(start)/(double)nIterations;
+        printf("  %12.3f  %11.3f\n", tLoop, tBatch);
+
+        utility_cseig_destroy(&hEig);
+        utility_cslslv_destroy(&hSlv);
+        utility_csvd_destroy(&hSvd);
+        free(A);
+        free(B);
+        free(X);
+        free(V);
+        free(eig);
+    }
+}
+
+/**
+ * Times the analysis and synthesis of the qmf filterbank against the afSTFT
+ * filterbank (both with hybrid filtering, and processing the same signals)
+ */
+static void benchmark__qmf_afSTFT(void){
+    int fb, frame, nFrames, ch, i, nBands, band, nHops;
+    void* hFB;
+    float** insig, **inframe, **outframe;
+    float_complex*** inspec, ***outspec;
+    tick_t start;
+    double elapsed;
+
+    /* Config */
+    const int fs = 48000;
+    const int signalLength = 4*fs;
+    const int framesize = 512;
+    const int hopsize = 128;
+    const int nCH = 32;
+    const int hybridMode = 1;
+    const char* fbNames[2] = {"qmf", "afSTFT"};
+
+    /* prep (deterministic signals) */
+    insig = (float**)malloc2d(nCH,signalLength,sizeof(float));
+    inframe = (float**)malloc2d(nCH,framesize,sizeof(float));
+    outframe = (float**)malloc2d(nCH,framesize,sizeof(float));
+    for(ch=0; ch<nCH; ch++)
+        for(i=0; i<signalLength; i++)
+            insig[ch][i] = 0.5f*sinf(0.0031f*(float)(i*(ch+1))) + 0.25f*cosf(1.3f*(float)i);
+    nHops = framesize/hopsize;
+    nFrames = signalLength/framesize;
+
+    printf("qmf vs afSTFT (hybrid, hop size %d), analysis+synthesis of %d channels x %ds [s]:\n", hopsize, nCH, signalLength/fs);
+    for(fb=0; fb<2; fb++){
+        if(fb==0){
+            qmf_create(&hFB, nCH, nCH, hopsize, hybridMode, QMF_BANDS_CH_TIME);
+            nBands = qmf_getNBands(hFB);
+        }
+        else{
+            afSTFT_create(&hFB, nCH, nCH, hopsize, 0, hybridMode, AFSTFT_BANDS_CH_TIME);
+            nBands = afSTFT_getNBands(hFB);
+        }
+        inspec = (float_complex***)malloc3d(nBands, nCH, nHops, sizeof(float_complex));
+        outspec = (float_complex***)malloc3d(nBands, nCH, nHops, sizeof(float_complex));
+
+        start = timer_current();
+        for(frame = 0; frame<nFrames; frame++){
+            for(ch=0; ch<nCH; ch++)
+                memcpy(inframe[ch], &insig[ch][frame*framesize], framesize*sizeof(float));
+            if(fb==0)
+                qmf_analysis(hFB, inframe, framesize, inspec);
+            else
+                afSTFT_forward(hFB, inframe, framesize, inspec);
+            for(band=0; band<nBands; band++)
+                memcpy(FLATTEN2D(outspec[band]), FLATTEN2D(inspec[band]), nCH*nHops*sizeof(float_complex));
+            if(fb==0)
+                qmf_synthesis(hFB, outspec, framesize, outframe);
+            else
+                afSTFT_backward(hFB, outspec, framesize, outframe);
+        }
+        elapsed = (double)timer_elapsed(start);
+        printf("    %-8s (%d bands): %12.3f\n", fbNames[fb], nBands, elapsed);
+
+        if(fb==0)
+            qmf_destroy(&hFB);
+        else
+            afSTFT_destroy(&hFB);
+        free(inspec);
+        free(outspec);
+    }
+
+    /* Clean-up */
+    free(insig);
+    free(inframe);
+    free(outframe);
+}
+
+/* Main benchmark program */
+int main(void) {
+    printf("%s\n", SAF_VERSION_BANNER);
+    printf("%s\n", SAF_EXTERNALS_CONFIGURATION_STRING);
+    printf("Executing the Spatial_Audio_Framework benchmarking program");
+#ifdef NDEBUG
+    printf(" (Release):\n");
+#else
+    printf(" (Debug):\n");
+#endif
+    timer_lib_initialize();
+
+    benchmark__utility_batchedSolvers();
+    benchmark__qmf_afSTFT();
+
+    timer_lib_shutdown();
+    return 0;
+}
@@ -94,11 +94,31 @@ int main_test(void) {
     RUN_TEST(test__delaunaynd);
     RUN_TEST(test__quaternion);
     RUN_TEST(test__saf_stft_50pc_overlap);
+    RUN_TEST(test__saf_stft_high_overlap);
     RUN_TEST(test__saf_stft_LTI);
     RUN_TEST(test__saf_matrixConv);
+    RUN_TEST(test__saf_matrixConv_sparse);
+    RUN_TEST(test__saf_matrixConv_updateFilters);
+    RUN_TEST(test__saf_multiConv);
+    RUN_TEST(test__saf_convSpectra);
+    RUN_TEST(test__saf_TVConv);
+    RUN_TEST(test__saf_TVConv_cache);
+    RUN_TEST(test__saf_TVConv_interp);
+    RUN_TEST(test__saf_threadPool);
+    RUN_TEST(test__saf_threadPool_parallelFor);
+    RUN_TEST(test__saf_stateSwap);
+    RUN_TEST(test__saf_blockAdapter);
+    RUN_TEST(test__saf_arena);
     RUN_TEST(test__saf_rfft);
+    RUN_TEST(test__saf_rfft_batch);
     RUN_TEST(test__saf_fft);
+    RUN_TEST(test__saf_fft_planning);
+    RUN_TEST(test__saf_fftconv);
     RUN_TEST(test__qmf);
+    RUN_TEST(test__saf_filterbank);
+    RUN_TEST(test__saf_simdDispatch);
+    RUN_TEST(test__utility_cvvmac);
+    RUN_TEST(test__utility_batchedSolvers);
     RUN_TEST(test__smb_pitchShifter);
     RUN_TEST(test__sortf);
     RUN_TEST(test__sortz);
@@ -166,19 +186,26 @@ int main_test(void) {
 
     /* SAF resources unit tests */
     RUN_TEST(test__afSTFT);
+    RUN_TEST(test__afSTFT_multichannel);
+    RUN_TEST(test__afSTFT_layouts);
     RUN_TEST(test__realloc2d_r);
     RUN_TEST(test__malloc4d);
     RUN_TEST(test__malloc5d);
     RUN_TEST(test__malloc6d);
+    RUN_TEST(test__malloc_aligned);
 
     /* SAF examples unit tests */
 #ifdef SAF_ENABLE_EXAMPLES_TESTS
     RUN_TEST(test__saf_example_ambi_bin);
+    RUN_TEST(test__saf_example_ambi_bin_liveReinit);
     RUN_TEST(test__saf_example_ambi_dec);
     RUN_TEST(test__saf_example_ambi_enc);
     RUN_TEST(test__saf_example_array2sh);
     RUN_TEST(test__saf_example_rotator);
+    RUN_TEST(test__saf_example_ambi_drc);
+    RUN_TEST(test__saf_example_decorrelator);
     RUN_TEST(test__saf_example_spreader);
+    RUN_TEST(test__saf_example_powermap);
 #endif /* SAF_ENABLE_EXAMPLES_TESTS */
 
     /* close */
@@ -44,6 +44,7 @@ void test__saf_example_ambi_bin(void){
     /* Configure and initialise the ambi_bin codec */
     ambi_bin_setNormType(hAmbi, NORM_N3D);
     ambi_bin_setInputOrderPreset(hAmbi, (SH_ORDERS)order);
+    ambi_bin_setNumThreads(hAmbi, 3); /* Host thread + 2 pooled threads */
     ambi_bin_initCodec(hAmbi); /* Can be called whenever (thread-safe) */
     /* "initCodec" should be called after calling any of the "set" functions.
      * It should be noted that intialisations are only conducted if they are
@@ -52,7 +53,7 @@ void test__saf_example_ambi_bin(void){
      * longer than it takes to "process" the current block of samples, then the
      * output is simply muted/zeroed during this time. */
 
-    ambi_bin_init(hAmbi, fs); /* Should be called before calling "process"
+    ambi_bin_init(hAmbi, fs, ambi_bin_getFrameSize()); /* Should be called before calling "process"
                                * Cannot be called while "process" is on-going */
     ambi_bin_initCodec(hAmbi); /* Can be called whenever (thread-safe) */
     ambi_bin_setEnableRotation(hAmbi, 1);
@@ -86,7 +87,9 @@ void test__saf_example_ambi_bin(void){
         for(ch=0; ch<NUM_EARS; ch++)
             binSig_frame[ch] = &binSig[ch][i*framesize];
 
+        md_rtScope_enter();
         ambi_bin_process(hAmbi, (const float* const*)shSig_frame, binSig_frame, nSH, NUM_EARS, framesize);
+        md_rtScope_exit();
     }
 
     /* Assert that left ear energy is higher than the right ear */
@@ -109,6 +112,82 @@ void test__saf_example_ambi_bin(void){
     free(binSig_frame);
 }
 
+/** Job for test__saf_example_ambi_bin_liveReinit(), which keeps reconfiguring
+ * ambi_bin from another thread (no TEST_ASSERT calls here) */
+static void test__saf_example_ambi_bin_reinitJob(void* arg){
+    void* hAmbi = arg;
+    int i;
+    for(i=0; i<6; i++){
+        ambi_bin_setDecodingMethod(hAmbi, i%2==0 ? DECODING_METHOD_LS : DECODING_METHOD_MAGLS);
+        ambi_bin_setNumThreads(hAmbi, i%3==0 ? 1 : 3);
+        ambi_bin_initCodec(hAmbi);
+    }
+}
+
+void test__saf_example_ambi_bin_liveReinit(void){
+    int nSH, i, ch, n, framesize, nFrames, nSilentFrames;
+    void* hAmbi, *hThreadPool;
+    float energy, direction_deg[2];
+    float* y;
+    float** shSig_frame, **binSig_frame;
+    saf_threadPool_job job;
+
+    /* Config */
+    const int order = 3;
+    const int fs = 48000;
+    const int nPrimingFrames = 40; /* (more than the filterbank latency) */
+
+    /* Create and initialise an instance of ambi_bin */
+    ambi_bin_create(&hAmbi);
+    ambi_bin_setNormType(hAmbi, NORM_N3D);
+    ambi_bin_setInputOrderPreset(hAmbi, (SH_ORDERS)order);
+    ambi_bin_init(hAmbi, fs, ambi_bin_getFrameSize());
+    ambi_bin_initCodec(hAmbi);
+    TEST_ASSERT_TRUE(ambi_bin_getCodecStatus(hAmbi)==CODEC_STATUS_INITIALISED);
+
+    /* A 1 kHz tone from the left */
+    nSH = ORDER2NSH(order);
+    direction_deg[0] = 90.0f;
+    direction_deg[1] = 0.0f;
+    y = malloc1d(nSH*sizeof(float));
+    getRSH(order, (float*)direction_deg, 1, y);
+    framesize = ambi_bin_getFrameSize();
+    shSig_frame = (float**)malloc2d(nSH, framesize, sizeof(float));
+    binSig_frame = (float**)malloc2d(NUM_EARS, framesize, sizeof(float));
+
+    /* Keep processing, while the codec is reconfigured on another thread; the output should never be muted */
+    saf_threadPool_create(&hThreadPool, 1);
+    saf_threadPool_initJob(&job, test__saf_example_ambi_bin_reinitJob, hAmbi);
+    nSilentFrames = 0;
+    for(nFrames=0; nFrames<nPrimingFrames || !saf_threadPool_isDone(&job); nFrames++){
+        for(n=0; n<framesize; n++)
+            for(ch=0; ch<nSH; ch++)
+                shSig_frame[ch][n] = y[ch] * sinf(2.0f*SAF_PI*1000.0f*(float)(nFrames*framesize+n)/(float)fs);
+        md_rtScope_enter();
+        ambi_bin_process(hAmbi, (const float* const*)shSig_frame, binSig_frame, nSH, NUM_EARS, framesize);
+        md_rtScope_exit();
+        if(nFrames==nPrimingFrames-1)
+            saf_threadPool_submit(hThreadPool, &job);
+        else if(nFrames>=nPrimingFrames){
+            energy = 0.0f;
+            for(i=0; i<framesize; i++)
+                energy += binSig_frame[0][i]*binSig_frame[0][i];
+            if(energy < 1e-6f)
+                nSilentFrames++;
+        }
+    }
+    saf_threadPool_wait(hThreadPool, &job);
+    TEST_ASSERT_EQUAL_INT(0, nSilentFrames);
+    TEST_ASSERT_TRUE(ambi_bin_getCodecStatus(hAmbi)==CODEC_STATUS_INITIALISED);
+
+    /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
+    ambi_bin_destroy(&hAmbi);
+    free(y);
+    free(shSig_frame);
+    free(binSig_frame);
+}
+
 void test__saf_example_ambi_dec(void){
     int nSH, i, j, ch, max_ind, framesize;
     void* hAmbi;
@@ -131,6 +210,7 @@ void test__saf_example_ambi_dec(void){
     ambi_dec_setOutputConfigPreset(hAmbi, LOUDSPEAKER_ARRAY_PRESET_22PX);
     ambi_dec_setDecMethod(hAmbi, DECODING_METHOD_SAD, 0/* low-freq decoder */);
     ambi_dec_setDecMethod(hAmbi, DECODING_METHOD_SAD, 1/* high-freq decoder */);
+    ambi_dec_setNumThreads(hAmbi, 3); /* Host thread + 2 pooled threads */
     ambi_dec_initCodec(hAmbi); /* Can be called whenever (thread-safe) */
     /* "initCodec" should be called after calling any of the "set" functions.
      * It should be noted that intialisations are only conducted if they are
@@ -139,7 +219,7 @@ void test__saf_example_ambi_dec(void){
      * longer than it takes to "process" the current block of samples, then the
      * output is simply muted/zeroed during this time. */
 
-    ambi_dec_init(hAmbi, fs); /* Should be called before calling "process"
+    ambi_dec_init(hAmbi, fs, ambi_dec_getFrameSize()); /* Should be called before calling "process"
                                * Cannot be called while "process" is on-going */
 
     /* Define input mono signal */
@@ -169,7 +249,21 @@ void test__saf_example_ambi_dec(void){
         for(ch=0; ch<22; ch++)
             lsSig_frame[ch] = &lsSig[ch][i*framesize];
 
+        /* Re-initialise twice along the way (which re-uses the memory of the
+         * render states), first carrying over the HRTF tables, and then
+         * rebuilding them */
+        if(i==(int)((float)signalLength/(float)framesize)/3){
+            ambi_dec_setDecMethod(hAmbi, DECODING_METHOD_SAD, 1/* high-freq decoder */);
+            ambi_dec_initCodec(hAmbi);
+        }
+        else if(i==2*(int)((float)signalLength/(float)framesize)/3){
+            ambi_dec_refreshSettings(hAmbi);
+            ambi_dec_initCodec(hAmbi);
+        }
+
+        md_rtScope_enter();
         ambi_dec_process(hAmbi, (const float* const*)shSig_frame, lsSig_frame, nSH, 22, framesize);
+        md_rtScope_exit();
     }
 
     /* Assert that channel 8 (corresponding to the loudspeaker where the plane-
@@ -193,7 +287,7 @@ void test__saf_example_ambi_dec(void){
 }
 
 void test__saf_example_ambi_enc(void){
-    int nSH, i, ch, framesize, j, delay;
+    int nSH, i, ch, j, delay;
     void* hAmbi;
     float direction_deg[2][2];
     float** inSig, *y;
@@ -204,15 +298,17 @@ void test__saf_example_ambi_enc(void){
     const int order = 4;
     const int fs = 48000;
     const int signalLength = fs*2;
+    const int hostBlockSize = 48; /* not a multiple of the frame size */
     direction_deg[0][0] = 90.0f; /* encode to loudspeaker direction: index 8 */
     direction_deg[0][1] = 0.0f;
     direction_deg[1][0] = 20.0f; /* encode to loudspeaker direction: index 8 */
     direction_deg[1][1] = -45.0f;
-    delay = ambi_enc_getProcessingDelay();
 
     /* Create and initialise an instance of ambi_enc */
     ambi_enc_create(&hAmbi);
-    ambi_enc_init(hAmbi, fs); /* Cannot be called while "process" is on-going */
+    ambi_enc_init(hAmbi, fs, hostBlockSize); /* Cannot be called while "process" is on-going */
+    delay = ambi_enc_getProcessingDelay(hAmbi); /* Should already include the block adapter latency */
+    TEST_ASSERT_TRUE(delay>ambi_enc_getFrameSize());
 
     /* Configure ambi_enc */
     ambi_enc_setOutputOrder(hAmbi, (SH_ORDERS)order);
@@ -239,18 +335,20 @@ void test__saf_example_ambi_enc(void){
                 FLATTEN2D(shSig_ref), signalLength);
 
     /* Encode via ambi_enc */
-    framesize = ambi_enc_getFrameSize();
     shSig = (float**)calloc2d(nSH,signalLength,sizeof(float));
     inSig_frame = (float**)malloc1d(2*sizeof(float*));
     shSig_frame = (float**)malloc1d(nSH*sizeof(float*));
-    for(i=0; i<(int)((float)signalLength/(float)framesize); i++){
+    for(i=0; i<(int)((float)signalLength/(float)hostBlockSize); i++){
         for(ch=0; ch<2; ch++)
-            inSig_frame[ch] = &inSig[ch][i*framesize];
+            inSig_frame[ch] = &inSig[ch][i*hostBlockSize];
         for(ch=0; ch<nSH; ch++)
-            shSig_frame[ch] = &shSig[ch][i*framesize];
+            shSig_frame[ch] = &shSig[ch][i*hostBlockSize];
 
-        ambi_enc_process(hAmbi, (const float* const*)inSig_frame, shSig_frame, 2, nSH, framesize);
+        md_rtScope_enter();
+        ambi_enc_process(hAmbi, (const float* const*)inSig_frame, shSig_frame, 2, nSH, hostBlockSize);
+        md_rtScope_exit();
     }
+    TEST_ASSERT_EQUAL_INT(delay, ambi_enc_getProcessingDelay(hAmbi)); /* Same as reported before processing */
 
     /* ambi_enc should be equivalent to the reference */
     for(i=0; i<nSH; i++)
@@ -284,7 +382,7 @@ void test__saf_example_array2sh(void){
 
     /* Create and initialise an instance of array2sh for the Eigenmike32 */
     array2sh_create(&hA2sh);
-    array2sh_init(hA2sh, fs); /* Cannot be called while "process" is on-going */
+    array2sh_init(hA2sh, fs, array2sh_getFrameSize()); /* Cannot be called while "process" is on-going */
     array2sh_setPreset(hA2sh, MICROPHONE_ARRAY_PRESET_EIGENMIKE32);
     array2sh_setNormType(hA2sh, NORM_N3D);
 
@@ -338,7 +436,10 @@ void test__saf_example_array2sh(void){
         for(ch=0; ch<nSH; ch++)
             shSig_frame[ch] = &shSig[ch][i*framesize];
 
+        /* (array2sh computes its encoding matrix during the first frame) */
+        if(i>0) md_rtScope_enter();
         array2sh_process(hA2sh, (const float* const*)micSig_frame, shSig_frame, 32, nSH, framesize);
+        if(i>0) md_rtScope_exit();
     }
 
     /* Clean-up */
@@ -358,7 +459,7 @@ void test__saf_example_array2sh(void){
 }
 
 void test__saf_example_rotator(void){
-    int ch, nSH, i, j, delay, framesize;
+    int ch, nSH, i, j, delay;
     void* hRot;
     float direction_deg[2], ypr[3], Rzyx[3][3];
     float** inSig, *y, **shSig_frame, **shSig_rot_frame;
@@ -369,16 +470,18 @@ void test__saf_example_rotator(void){
     const int order = 4;
     const int fs = 48000;
     const int signalLength = fs*2;
+    const int hostBlockSize = 48; /* not a multiple of the frame size */
     direction_deg[0] = 90.0f; /* encode to loudspeaker direction: index 8 */
     direction_deg[1] = 0.0f;
     ypr[0] = -0.4f;
     ypr[1] = -1.4f;
     ypr[2] = 2.1f;
-    delay = rotator_getProcessingDelay();
 
     /* Create and initialise an instance of rotator */
     rotator_create(&hRot);
-    rotator_init(hRot, fs); /* Cannot be called while "process" is on-going */
+    rotator_init(hRot, fs, hostBlockSize); /* Cannot be called while "process" is on-going */
+    delay = rotator_getProcessingDelay(hRot); /* Should already include the block adapter latency */
+    TEST_ASSERT_TRUE(delay>rotator_getFrameSize());
 
     /* Configure rotator codec */
     rotator_setOrder(hRot, (SH_ORDERS)order);
@@ -412,18 +515,20 @@ void test__saf_example_rotator(void){
                 FLATTEN2D(shSig_rot_ref), signalLength);
 
     /* Rotate with rotator */
-    framesize = rotator_getFrameSize();
-    shSig_rot = (float**)malloc2d(nSH,signalLength,sizeof(float));
+    shSig_rot = (float**)calloc2d(nSH,signalLength,sizeof(float));
     shSig_frame = (float**)malloc1d(nSH*sizeof(float*));
     shSig_rot_frame = (float**)malloc1d(nSH*sizeof(float*));
-    for(i=0; i<(int)((float)signalLength/(float)framesize); i++){
+    for(i=0; i<(int)((float)signalLength/(float)hostBlockSize); i++){
         for(ch=0; ch<nSH; ch++)
-            shSig_frame[ch] = &shSig[ch][i*framesize];
+            shSig_frame[ch] = &shSig[ch][i*hostBlockSize];
         for(ch=0; ch<nSH; ch++)
-            shSig_rot_frame[ch] = &shSig_rot[ch][i*framesize];
+            shSig_rot_frame[ch] = &shSig_rot[ch][i*hostBlockSize];
 
-        rotator_process(hRot, (const float* const*)shSig_frame, shSig_rot_frame, nSH, nSH, framesize);
+        md_rtScope_enter();
+        rotator_process(hRot, (const float* const*)shSig_frame, shSig_rot_frame, nSH, nSH, hostBlockSize);
+        md_rtScope_exit();
     }
+    TEST_ASSERT_EQUAL_INT(delay, rotator_getProcessingDelay(hRot)); /* Same as reported before processing */
 
     /* ambi_enc should be equivalent to the reference, except delayed due to the
      * temporal interpolation employed in ambi_enc */
@@ -442,6 +547,142 @@ void test__saf_example_rotator(void){
     free(shSig_rot_frame);
 }
 
+void test__saf_example_ambi_drc(void){
+    int fb, ch, i, j, delay, nFreqPoints;
+    void* hDrc;
+    float** shSig, **shSig_drc, **shSig_frame, **shSig_drc_frame;
+    float maxErr;
+
+    /* Config */
+    const float amplitude = 0.01f; /* well below the threshold, so no compression is applied */
+    const float acceptedTolerance = 0.02f*amplitude;
+    const int nSH = 4;
+    const int fs = 48000;
+    const int signalLength = fs;
+    const int hostBlockSize = 256;
+    const int nBandsRef[AMBI_DRC_NUM_FILTERBANKS] = {133, 133, 135, 257};
+
+    /* Define input signals */
+    shSig = (float**)malloc2d(nSH,signalLength,sizeof(float));
+    shSig_drc = (float**)calloc2d(nSH,signalLength,sizeof(float));
+    rand_m1_1(FLATTEN2D(shSig), nSH*signalLength);
+    cblas_sscal(nSH*signalLength, amplitude, FLATTEN2D(shSig), 1);
+    shSig_frame = (float**)malloc1d(nSH*sizeof(float*));
+    shSig_drc_frame = (float**)malloc1d(nSH*sizeof(float*));
+
+    /* Create an instance of ambi_drc, and process the signals with each of the
+     * filterbanks (selected at run-time) */
+    ambi_drc_create(&hDrc);
+    ambi_drc_setInputPreset(hDrc, SH_ORDER_FIRST);
+    ambi_drc_setThreshold(hDrc, 0.0f);
+    for(fb=AMBI_DRC_FILTERBANK_AFSTFT; fb<=AMBI_DRC_FILTERBANK_STFT; fb++){
+        ambi_drc_setFilterbank(hDrc, fb);
+        ambi_drc_init(hDrc, fs, hostBlockSize);
+        TEST_ASSERT_EQUAL_INT(fb, ambi_drc_getFilterbank(hDrc));
+        ambi_drc_getFreqVector(hDrc, &nFreqPoints);
+        TEST_ASSERT_EQUAL_INT(nBandsRef[fb-1], nFreqPoints);
+        delay = ambi_drc_getProcessingDelay(hDrc);
+
+        for(i=0; i<signalLength/hostBlockSize; i++){
+            for(ch=0; ch<nSH; ch++){
+                shSig_frame[ch] = &shSig[ch][i*hostBlockSize];
+                shSig_drc_frame[ch] = &shSig_drc[ch][i*hostBlockSize];
+            }
+            ambi_drc_process(hDrc, (const float* const*)shSig_frame, shSig_drc_frame, nSH, hostBlockSize);
+        }
+
+        /* The output should be the same as the input, except delayed by the filterbank */
+        maxErr = 0.0f;
+        for(ch=0; ch<nSH; ch++)
+            for(j=0; j<(signalLength/hostBlockSize)*hostBlockSize-delay; j++)
+                maxErr = SAF_MAX(maxErr, fabsf(shSig[ch][j] - shSig_drc[ch][j+delay]));
+        TEST_ASSERT_TRUE(maxErr <= acceptedTolerance);
+    }
+
+    /* Clean-up */
+    ambi_drc_destroy(&hDrc);
+    free(shSig);
+    free(shSig_drc);
+    free(shSig_frame);
+    free(shSig_drc_frame);
+}
+
+void test__saf_example_decorrelator(void){
+    int fb, ch, i, j, delay;
+    void* hDecor;
+    float** inSigs, **outSigs, **inSig_frame, **outSig_frame;
+    float maxErr, energyIn, energy[2], xcorr;
+
+    /* Config */
+    const float acceptedTolerance = 0.02f;
+    const int nCH = 2;
+    const int fs = 48000;
+    const int signalLength = fs;
+    const int hostBlockSize = 256;
+    const int nBlocks = signalLength/hostBlockSize;
+
+    /* The same white-noise signal for both channels */
+    inSigs = (float**)malloc2d(nCH,signalLength,sizeof(float));
+    outSigs = (float**)calloc2d(nCH,signalLength,sizeof(float));
+    rand_m1_1(inSigs[0], signalLength);
+    cblas_scopy(signalLength, inSigs[0], 1, inSigs[1], 1);
+    inSig_frame = (float**)malloc1d(nCH*sizeof(float*));
+    outSig_frame = (float**)malloc1d(nCH*sizeof(float*));
+
+    /* Create an instance of decorrelator, and process the signals with each of
+     * the filterbanks (selected at run-time) */
+    decorrelator_create(&hDecor);
+    decorrelator_setNumberOfChannels(hDecor, nCH);
+    for(fb=DECORRELATOR_FILTERBANK_AFSTFT; fb<=DECORRELATOR_FILTERBANK_STFT; fb++){
+        decorrelator_setFilterbank(hDecor, fb);
+        TEST_ASSERT_EQUAL_INT(fb, decorrelator_getFilterbank(hDecor));
+
+        /* Bypassed, the output should be the same as the input, except delayed
+         * by the filterbank */
+        decorrelator_setDecorrelationAmount(hDecor, 0.0f);
+        decorrelator_init(hDecor, fs, hostBlockSize);
+        decorrelator_initCodec(hDecor);
+        delay = decorrelator_getProcessingDelay(hDecor);
+        for(i=0; i<nBlocks; i++){
+            for(ch=0; ch<nCH; ch++){
+                inSig_frame[ch] = &inSigs[ch][i*hostBlockSize];
+                outSig_frame[ch] = &outSigs[ch][i*hostBlockSize];
+            }
+            decorrelator_process(hDecor, (const float* const*)inSig_frame, outSig_frame, nCH, nCH, hostBlockSize);
+        }
+        maxErr = 0.0f;
+        for(ch=0; ch<nCH; ch++)
+            for(j=0; j<nBlocks*hostBlockSize-delay; j++)
+                maxErr = SAF_MAX(maxErr, fabsf(inSigs[ch][j] - outSigs[ch][j+delay]));
+        TEST_ASSERT_TRUE(maxErr <= acceptedTolerance);
+
+        /* Fully decorrelated, the two output channels should have (roughly)
+         * the energy of the input, but should no longer be coherent */
+        decorrelator_setDecorrelationAmount(hDecor, 1.0f);
+        for(i=0; i<nBlocks; i++){
+            for(ch=0; ch<nCH; ch++){
+                inSig_frame[ch] = &inSigs[ch][i*hostBlockSize];
+                outSig_frame[ch] = &outSigs[ch][i*hostBlockSize];
+            }
+            decorrelator_process(hDecor, (const float* const*)inSig_frame, outSig_frame, nCH, nCH, hostBlockSize);
+        }
+        for(ch=0; ch<nCH; ch++)
+            energy[ch] = cblas_sdot(signalLength/2, &outSigs[ch][signalLength/2], 1, &outSigs[ch][signalLength/2], 1);
+        xcorr = cblas_sdot(signalLength/2, &outSigs[0][signalLength/2], 1, &outSigs[1][signalLength/2], 1)/sqrtf(energy[0]*energy[1]);
+        energyIn = cblas_sdot(signalLength/2, &inSigs[0][signalLength/2], 1, &inSigs[0][signalLength/2], 1);
+        for(ch=0; ch<nCH; ch++)
+            TEST_ASSERT_TRUE(energy[ch] > 0.5f*energyIn && energy[ch] < 1.5f*energyIn);
+        TEST_ASSERT_TRUE(xcorr < 0.6f);
+    }
+
+    /* Clean-up */
+    decorrelator_destroy(&hDecor);
+    free(inSigs);
+    free(outSigs);
+    free(inSig_frame);
+    free(outSig_frame);
+}
+
 void test__saf_example_spreader(void){
     int i, ch, framesize, nOutputs;
     void* hSpr;
@@ -460,7 +701,8 @@ void test__saf_example_spreader(void){
     spreader_setUseDefaultHRIRsflag(hSpr, 1);
     nOutputs = NUM_EARS; /* the default is binaural operation */
     spreader_setNumSources(hSpr, nInputs);
-    spreader_init(hSpr, fs); /* Should be called before calling "process"
+    spreader_setNumThreads(hSpr, 3); /* Host thread + 2 pooled threads */
+    spreader_init(hSpr, fs, spreader_getFrameSize()); /* Should be called before calling "process"
                                * Cannot be called while "process" is on-going */
     spreader_initCodec(hSpr); /* Can be called whenever (thread-safe) */
 
@@ -479,9 +721,24 @@ void test__saf_example_spreader(void){
         for(ch=0; ch<nOutputs; ch++)
             outSig_frame[ch] = &outSigs[ch][i*framesize];
 
+        /* Re-initialise half-way through (which re-uses the memory of the previous
+         * configuration), switching to the EVD mode, so that both modes are tested */
+        if(i==(int)((float)signalLength/(float)framesize)/2){
+            spreader_setSpreadingMode(hSpr, SPREADER_MODE_EVD);
+            spreader_refreshSettings(hSpr);
+            spreader_initCodec(hSpr);
+        }
+
+        md_rtScope_enter();
         spreader_process(hSpr, (const float* const*)inSig_frame, outSig_frame, nInputs, nOutputs, framesize);
+        md_rtScope_exit();
     }
 
+    /* Both modes should produce valid output */
+    for(ch=0; ch<nOutputs; ch++)
+        for(i=0; i<(int)((float)signalLength/(float)framesize)*framesize; i++)
+            TEST_ASSERT_FALSE(isnan(outSigs[ch][i]) || isinf(outSigs[ch][i]));
+
     /* Clean-up */
     spreader_destroy(&hSpr);
     free(inSigs);
@@ -490,4 +747,79 @@ void test__saf_example_spreader(void){
     free(outSig_frame);
 }
 
+void test__saf_example_powermap(void){
+    int i, ch, mode, framesize, nSH, nDirs, pmapWidth, hfov, aspectRatio, ind;
+    void* hPm;
+    float src_dir_deg[2], src_xyz[3], peak_xyz[3], peak_dir_rad[2];
+    float* inSig, *y, *grid_dirs, *pmap;
+    float** shSig, **shSig_frame;
+
+    /* Config */
+    const float acceptedTolerance_deg = 15.0f;
+    const int order = 3;
+    const int fs = 48000;
+    const int signalLength = fs/4;
+    src_dir_deg[0] = 40.0f;
+    src_dir_deg[1] = 10.0f;
+
+    /* Create and initialise an instance of powermap */
+    powermap_create(&hPm);
+    powermap_setMasterOrder(hPm, order);
+    powermap_setAnaOrderAllBands(hPm, order);
+    powermap_setNormType(hPm, NORM_N3D);
+    powermap_setNumSources(hPm, 1);
+    powermap_setNumThreads(hPm, 3); /* Host thread + 2 pooled threads */
+    powermap_init(hPm, (float)fs); /* Cannot be called while "process" is on-going */
+    powermap_initCodec(hPm);  /* Can be called whenever (thread-safe) */
+
+    /* Define a plane-wave input signal */
+    nSH = ORDER2NSH(order);
+    inSig = malloc1d(signalLength*sizeof(float));
+    shSig = (float**)malloc2d(nSH,signalLength,sizeof(float));
+    rand_m1_1(inSig, signalLength); /* Mono white-noise signal */
+    y = malloc1d(nSH*sizeof(float));
+    getRSH(order, (float*)src_dir_deg, 1, y); /* SH plane-wave weights */
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nSH, signalLength, 1, 1.0f,
+                y, 1,
+                inSig, signalLength, 0.0f,
+                FLATTEN2D(shSig), signalLength);
+    unitSph2cart(src_dir_deg, 1, SAF_TRUE, src_xyz);
+
+    /* Generate each type of activity-map. The analysis, including the map
+     * generation, is carried out within a real-time scope; i.e., the test will
+     * abort if it allocates memory and SAF_ENABLE_RT_ALLOC_CHECKS is defined */
+    framesize = powermap_getFrameSize();
+    shSig_frame = (float**)malloc1d(nSH*sizeof(float*));
+    for(mode=PM_MODE_PWD; mode<=PM_MODE_MINNORM_LOG; mode++){
+        powermap_setPowermapMode(hPm, mode);
+        for(i=0; i<(int)((float)signalLength/(float)framesize); i++){
+            for(ch=0; ch<nSH; ch++)
+                shSig_frame[ch] = &shSig[ch][i*framesize];
+            powermap_requestPmapUpdate(hPm);
+            md_rtScope_enter();
+            powermap_analysis(hPm, (const float* const*)shSig_frame, nSH, framesize, 1);
+            md_rtScope_exit();
+        }
+
+        /* The peak of the activity-map should be in the source direction
+         * (except for Min-Norm, since utility_ceig() does not sort the
+         * eigenvalues, and so its noise sub-space is not reliable) */
+        TEST_ASSERT_TRUE(powermap_getPmap(hPm, &grid_dirs, &pmap, &nDirs, &pmapWidth, &hfov, &aspectRatio));
+        if(mode==PM_MODE_MINNORM || mode==PM_MODE_MINNORM_LOG)
+            continue;
+        utility_simaxv(pmap, nDirs, &ind);
+        peak_dir_rad[0] = grid_dirs[ind*2]*SAF_PI/180.0f;
+        peak_dir_rad[1] = grid_dirs[ind*2+1]*SAF_PI/180.0f;
+        unitSph2cart(peak_dir_rad, 1, SAF_FALSE, peak_xyz);
+        TEST_ASSERT_TRUE(acosf(SAF_MIN(1.0f, src_xyz[0]*peak_xyz[0] + src_xyz[1]*peak_xyz[1] + src_xyz[2]*peak_xyz[2]))*180.0f/SAF_PI < acceptedTolerance_deg);
+    }
+
+    /* Clean-up */
+    powermap_destroy(&hPm);
+    free(inSig);
+    free(shSig);
+    free(y);
+    free(shSig_frame);
+}
+
 #endif /* SAF_ENABLE_EXAMPLES_TESTS */
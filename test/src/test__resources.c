@@ -99,6 +99,139 @@ void test__afSTFT(void){
     free(freqVector);
 }
 
+void test__afSTFT_multichannel(void){
+    int frame, ch, band, t, nBands, nCH;
+    void* hSTFT, *hSTFT_ch[9];
+    float** inframe, **outframe, **outframe_ch;
+    float_complex*** inspec, ***inspec_ch;
+
+    /* prep */
+    const int framesize = 256;
+    const int hopsize = 64;
+    const int nFrames = 40;
+    const int nCHmax = 9;
+    const int nCHreduced = 6;
+    inframe = (float**)malloc2d(nCHmax,framesize,sizeof(float));
+    outframe = (float**)malloc2d(nCHmax,framesize,sizeof(float));
+    outframe_ch = (float**)malloc2d(1,framesize,sizeof(float));
+
+    /* One multichannel instance, and one single-channel instance per channel */
+    afSTFT_create(&hSTFT, nCHmax, nCHmax, hopsize, 1, 1, AFSTFT_BANDS_CH_TIME);
+    for(ch=0; ch<nCHmax; ch++)
+        afSTFT_create(&hSTFT_ch[ch], 1, 1, hopsize, 1, 1, AFSTFT_BANDS_CH_TIME);
+    nBands = afSTFT_getNBands(hSTFT);
+    inspec = (float_complex***)malloc3d(nBands, nCHmax, framesize/hopsize, sizeof(float_complex));
+    inspec_ch = (float_complex***)malloc3d(nBands, 1, framesize/hopsize, sizeof(float_complex));
+
+    /* All channels are processed together, but the output must be identical to processing each channel on its own; also
+     * after the number of channels has been reduced (the history of the remaining channels must be retained) */
+    nCH = nCHmax;
+    for(frame = 0; frame<nFrames; frame++){
+        if(frame==nFrames/2){
+            nCH = nCHreduced;
+            afSTFT_channelChange(hSTFT, nCH, nCH);
+        }
+        rand_m1_1(FLATTEN2D(inframe), nCH*framesize);
+        afSTFT_forward(hSTFT, inframe, framesize, inspec);
+        afSTFT_backward(hSTFT, inspec, framesize, outframe);
+        for(ch=0; ch<nCH; ch++){
+            afSTFT_forward(hSTFT_ch[ch], &inframe[ch], framesize, inspec_ch);
+            for(band=0; band<nBands; band++)
+                for(t=0; t<framesize/hopsize; t++)
+                    TEST_ASSERT_TRUE(memcmp(&inspec[band][ch][t], &inspec_ch[band][0][t], sizeof(float_complex))==0);
+            afSTFT_backward(hSTFT_ch[ch], inspec_ch, framesize, outframe_ch);
+            TEST_ASSERT_TRUE(memcmp(outframe[ch], outframe_ch[0], framesize*sizeof(float))==0);
+        }
+    }
+
+    /* Clean-up */
+    afSTFT_destroy(&hSTFT);
+    for(ch=0; ch<nCHmax; ch++)
+        afSTFT_destroy(&hSTFT_ch[ch]);
+    free(inframe);
+    free(outframe);
+    free(outframe_ch);
+    free(inspec);
+    free(inspec_ch);
+}
+
+void test__afSTFT_layouts(void){
+    int frame, fmt, ch, band, t, nBands, nHops;
+    void* hSTFT[3];
+    float** inframe, **outframe[3];
+    float* inframe_flat, *outframe_flat;
+    float_complex*** spec, ***spec_known, *spec_flat;
+    float_complex x, y;
+    AFSTFT_FDDATA_FORMAT format;
+
+    /* prep */
+    const int framesize = 512;
+    const int hopsize = 128;
+    const int nFrames = 20;
+    const int nCH = 5;
+    const int nCH_alloc = 8;  /* dataFD of afSTFT_*_knownDimensions() is larger than required */
+    const int nHops_alloc = 6;
+    nHops = framesize/hopsize;
+    inframe = (float**)malloc2d(nCH,framesize,sizeof(float));
+    inframe_flat = malloc1d(nCH*framesize*sizeof(float));
+    outframe_flat = malloc1d(nCH*framesize*sizeof(float));
+    for(ch=0; ch<3; ch++)
+        outframe[ch] = (float**)malloc2d(nCH,framesize,sizeof(float));
+
+    /* The afSTFT_*_knownDimensions() and afSTFT_*_flat() functions read/write dataFD in-place (with strides), whereas
+     * afSTFT_forward()/afSTFT_backward() go via an internal buffer; the results must be identical */
+    for(fmt=0; fmt<2; fmt++){
+        format = fmt==0 ? AFSTFT_BANDS_CH_TIME : AFSTFT_TIME_CH_BANDS;
+        for(ch=0; ch<3; ch++)
+            afSTFT_create(&hSTFT[ch], nCH, nCH, hopsize, 0, 1, format);
+        nBands = afSTFT_getNBands(hSTFT[0]);
+        if(format==AFSTFT_BANDS_CH_TIME){
+            spec = (float_complex***)malloc3d(nBands, nCH, nHops, sizeof(float_complex));
+            spec_known = (float_complex***)malloc3d(nBands, nCH_alloc, nHops_alloc, sizeof(float_complex));
+        }
+        else{
+            spec = (float_complex***)malloc3d(nHops, nCH, nBands, sizeof(float_complex));
+            spec_known = (float_complex***)malloc3d(nHops_alloc, nCH_alloc, nBands, sizeof(float_complex));
+        }
+        spec_flat = malloc1d(nBands*nCH*nHops*sizeof(float_complex));
+        for(frame = 0; frame<nFrames; frame++){
+            rand_m1_1(FLATTEN2D(inframe), nCH*framesize);
+            memcpy(inframe_flat, FLATTEN2D(inframe), nCH*framesize*sizeof(float));
+            afSTFT_forward(hSTFT[0], inframe, framesize, spec);
+            afSTFT_forward_knownDimensions(hSTFT[1], inframe, framesize, nCH_alloc, nHops_alloc, spec_known);
+            afSTFT_forward_flat(hSTFT[2], inframe_flat, framesize, spec_flat);
+            for(band=0; band<nBands; band++){
+                for(ch=0; ch<nCH; ch++){
+                    for(t=0; t<nHops; t++){
+                        x = format==AFSTFT_BANDS_CH_TIME ? spec[band][ch][t] : spec[t][ch][band];
+                        y = format==AFSTFT_BANDS_CH_TIME ? spec_known[band][ch][t] : spec_known[t][ch][band];
+                        TEST_ASSERT_TRUE(memcmp(&x, &y, sizeof(float_complex))==0);
+                        y = format==AFSTFT_BANDS_CH_TIME ? spec_flat[band*nCH*nHops + ch*nHops + t] : spec_flat[t*nCH*nBands + ch*nBands + band];
+                        TEST_ASSERT_TRUE(memcmp(&x, &y, sizeof(float_complex))==0);
+                    }
+                }
+            }
+            afSTFT_backward(hSTFT[0], spec, framesize, outframe[0]);
+            afSTFT_backward_knownDimensions(hSTFT[1], spec_known, framesize, nCH_alloc, nHops_alloc, outframe[1]);
+            afSTFT_backward_flat(hSTFT[2], spec_flat, framesize, outframe_flat);
+            TEST_ASSERT_TRUE(memcmp(FLATTEN2D(outframe[0]), FLATTEN2D(outframe[1]), nCH*framesize*sizeof(float))==0);
+            TEST_ASSERT_TRUE(memcmp(FLATTEN2D(outframe[0]), outframe_flat, nCH*framesize*sizeof(float))==0);
+        }
+        for(ch=0; ch<3; ch++)
+            afSTFT_destroy(&hSTFT[ch]);
+        free(spec);
+        free(spec_known);
+        free(spec_flat);
+    }
+
+    /* Clean-up */
+    free(inframe);
+    free(inframe_flat);
+    free(outframe_flat);
+    for(ch=0; ch<3; ch++)
+        free(outframe[ch]);
+}
+
 void test__realloc2d_r(void){
     int s, r, i, j, k;
     typedef struct _test_data{
@@ -260,3 +393,72 @@ void test__malloc6d(void){
     /* Clean-up */
     free(test_malloc_6d);
 }
+
+void test__malloc_aligned(void){
+    int i, j, k;
+    float* test_1d;
+    float** test_2d;
+    float_complex*** test_3d;
+    float*** test_3d_unpadded;
+    float REF[2][3][16];
+
+    /* Row strides */
+    TEST_ASSERT_TRUE(md_alignedStride(3, sizeof(float)) == 16);
+    TEST_ASSERT_TRUE(md_alignedStride(16, sizeof(float)) == 16);
+    TEST_ASSERT_TRUE(md_alignedStride(17, sizeof(float)) == 32);
+    TEST_ASSERT_TRUE(md_alignedStride(5, sizeof(float_complex)) == 8);
+    TEST_ASSERT_TRUE(md_alignedStride(5, 12) == 16); /* (192 bytes is the smallest multiple of both 12 and 64) */
+    TEST_ASSERT_TRUE(md_alignedStride(0, sizeof(float)) == 0);
+
+    /* 1-D */
+    test_1d = (float*)calloc1d_aligned(37, sizeof(float));
+    TEST_ASSERT_TRUE(((uintptr_t)test_1d % MD_MALLOC_ALIGNMENT) == 0);
+    for(i=0; i<37; i++)
+        TEST_ASSERT_TRUE(test_1d[i] == 0.0f);
+    free1d_aligned(test_1d);
+    free1d_aligned(NULL);
+
+    /* 2-D (with padded rows); every row should be aligned, and not overlap */
+    test_2d = (float**)malloc2d_aligned(5, 3, sizeof(float));
+    for(i=0; i<5; i++){
+        TEST_ASSERT_TRUE(((uintptr_t)test_2d[i] % MD_MALLOC_ALIGNMENT) == 0);
+        for(j=0; j<3; j++)
+            test_2d[i][j] = (float)(i*3+j);
+    }
+    for(i=0; i<5; i++)
+        for(j=0; j<3; j++)
+            TEST_ASSERT_TRUE(test_2d[i][j] == (float)(i*3+j));
+    TEST_ASSERT_TRUE(test_2d[1] - test_2d[0] == (ptrdiff_t)md_alignedStride(3, sizeof(float)));
+    free2d_aligned((void**)test_2d);
+
+    /* 3-D (with padded rows) */
+    test_3d = (float_complex***)calloc3d_aligned(4, 3, 5, sizeof(float_complex));
+    for(i=0; i<4; i++){
+        for(j=0; j<3; j++){
+            TEST_ASSERT_TRUE(((uintptr_t)test_3d[i][j] % MD_MALLOC_ALIGNMENT) == 0);
+            for(k=0; k<5; k++){
+                TEST_ASSERT_TRUE(crealf(test_3d[i][j][k]) == 0.0f && cimagf(test_3d[i][j][k]) == 0.0f);
+                test_3d[i][j][k] = cmplxf((float)(i*15+j*5+k), -1.0f);
+            }
+        }
+    }
+    for(i=0; i<4; i++)
+        for(j=0; j<3; j++)
+            for(k=0; k<5; k++)
+                TEST_ASSERT_TRUE(crealf(test_3d[i][j][k]) == (float)(i*15+j*5+k) && cimagf(test_3d[i][j][k]) == -1.0f);
+    free3d_aligned((void***)test_3d);
+
+    /* 3-D (without padding); which should then also be contiguous */
+    test_3d_unpadded = (float***)malloc3d_aligned(2, 3, 16, sizeof(float));
+    for(i=0; i<2; i++){
+        for(j=0; j<3; j++){
+            for(k=0; k<16; k++){
+                test_3d_unpadded[i][j][k] = (float)(i*3*16 + j*16 + k);
+                REF[i][j][k] = (float)(i*3*16 + j*16 + k);
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(((uintptr_t)FLATTEN3D(test_3d_unpadded) % MD_MALLOC_ALIGNMENT) == 0);
+    TEST_ASSERT_TRUE(memcmp(REF, FLATTEN3D(test_3d_unpadded), 2*3*16*sizeof(float)) == 0);
+    free3d_aligned((void***)test_3d_unpadded);
+}
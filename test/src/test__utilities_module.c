@@ -268,6 +268,62 @@ void test__saf_stft_50pc_overlap(void){
     free(outspec);
 }
 
+void test__saf_stft_high_overlap(void){
+    int frame, winsize, hopsize, nFrames, ch, i, nBands, nTimesSlots, ratio, delay;
+    void* hSTFT;
+    float** insig, **outsig, **inframe, **outframe;
+    float_complex*** spec;
+
+    /* prep */
+    const float acceptedTolerance = 0.00001f;
+    const int fs = 48000;
+    const int signalLength = fs/2;
+    const int framesize = 512;
+    const int nCH = 8;
+    insig = (float**)malloc2d(nCH,signalLength,sizeof(float));
+    outsig = (float**)malloc2d(nCH,signalLength,sizeof(float));
+    inframe = (float**)malloc2d(nCH,framesize,sizeof(float));
+    outframe = (float**)malloc2d(nCH,framesize,sizeof(float));
+    rand_m1_1(FLATTEN2D(insig), nCH*signalLength); /* populate with random numbers */
+
+    /* Set-up STFT for 75% and 87.5% overlapping */
+    for(ratio=4; ratio<=8; ratio*=2){
+        winsize = 256;
+        hopsize = winsize/ratio;
+        delay = winsize-hopsize;
+        nBands = winsize+1;
+        nTimesSlots = framesize/hopsize;
+        spec = (float_complex***)malloc3d(nTimesSlots, nCH, nBands, sizeof(float_complex));
+        saf_stft_create(&hSTFT, winsize, hopsize, nCH, nCH, SAF_STFT_TIME_CH_BANDS);
+        saf_stft_setOverlapAddNormalisation(hSTFT, 1);
+
+        /* Pass insig through STFT, block-wise processing */
+        nFrames = (int)((float)signalLength/(float)framesize);
+        for(frame = 0; frame<nFrames; frame++){
+            for(ch=0; ch<nCH; ch++)
+                memcpy(inframe[ch], &insig[ch][frame*framesize], framesize*sizeof(float));
+            saf_stft_forward(hSTFT, inframe, framesize, spec);
+            saf_stft_backward(hSTFT, spec, framesize, outframe);
+            for(ch=0; ch<nCH; ch++)
+                memcpy(&outsig[ch][frame*framesize], outframe[ch], framesize*sizeof(float));
+        }
+
+        /* Check that input==output (given some numerical precision) */
+        for(ch=0; ch<nCH; ch++)
+            for(i=0; i<nFrames*framesize-delay; i++)
+                TEST_ASSERT_TRUE( fabsf(insig[ch][i] - outsig[ch][i+delay]) <= acceptedTolerance );
+
+        saf_stft_destroy(&hSTFT);
+        free(spec);
+    }
+
+    /* Clean-up */
+    free(insig);
+    free(outsig);
+    free(inframe);
+    free(outframe);
+}
+
 void test__saf_stft_LTI(void){
     int frame, winsize, hopsize, nFrames, ch, i, nBands, nTimesSlots, band;
     void* hSTFT;
@@ -328,47 +384,1072 @@ void test__saf_stft_LTI(void){
 }
 
 void test__saf_matrixConv(void){
-    int i, frame;
-    float** inputTD, **outputTD, **inputFrameTD, **outputFrameTD;
+    int i, o, frame, usePartFLAG, threaded;
+    float** inputTD, **outputTD, **inputFrameTD, **outputFrameTD, **refTD, *y_ref;
     float*** filters;
-    void* hMatrixConv;
+    void* hMatrixConv, *hThreadPool;
 
     /* config */
+    const float acceptedTolerance = 0.001f;
     const int signalLength = 48000;
     const int hostBlockSize = 2048;
     const int filterLength = 512;
     const int nInputs = 32;
     const int nOutputs = 40;
+    const int nFrames = (int)signalLength/hostBlockSize;
+    const int checkOutputs[2] = {0, nOutputs-1};
 
     /* prep */
     inputTD = (float**)malloc2d(nInputs, signalLength, sizeof(float));
     outputTD = (float**)malloc2d(nOutputs, signalLength, sizeof(float));
     inputFrameTD = (float**)malloc2d(nInputs, hostBlockSize, sizeof(float));
     outputFrameTD = (float**)calloc2d(nOutputs, hostBlockSize, sizeof(float));
+    refTD = (float**)calloc2d(2, signalLength, sizeof(float));
+    y_ref = malloc1d(signalLength*sizeof(float));
     filters = (float***)malloc3d(nOutputs, nInputs, filterLength, sizeof(float));
     rand_m1_1(FLATTEN3D(filters), nOutputs*nInputs*filterLength);
     rand_m1_1(FLATTEN2D(inputTD), nInputs*signalLength);
-    saf_matrixConv_create(&hMatrixConv, hostBlockSize, FLATTEN3D(filters), filterLength,
-                          nInputs, nOutputs, SAF_TRUE);
+    saf_threadPool_create(&hThreadPool, 3);
+
+    /* Reference outputs (for a subset of the output channels) */
+    for(o=0; o<2; o++){
+        for(i = 0; i<nInputs; i++){
+            fftfilt(inputTD[i], filters[checkOutputs[o]][i], signalLength, filterLength, 1, y_ref);
+            cblas_saxpy(signalLength, 1.0f, y_ref, 1, refTD[o], 1);
+        }
+    }
+
+    /* Test the non-partitioned, partitioned, and non-uniform partitioned modes (also with the tails computed on worker threads) */
+    for(usePartFLAG = 0, threaded = 0; usePartFLAG<3; threaded = !threaded, usePartFLAG += !threaded){
+        saf_matrixConv_create(&hMatrixConv, hostBlockSize, FLATTEN3D(filters), filterLength,
+                              nInputs, nOutputs, usePartFLAG);
+        if(threaded)
+            saf_matrixConv_setThreadPool(hMatrixConv, hThreadPool);
+
+        /* Apply */
+        for(frame = 0; frame<nFrames; frame++){
+            for(i = 0; i<nInputs; i++)
+                memcpy(inputFrameTD[i], &inputTD[i][frame*hostBlockSize], hostBlockSize*sizeof(float));
+
+            saf_matrixConv_apply(hMatrixConv, FLATTEN2D(inputFrameTD), FLATTEN2D(outputFrameTD));
+
+            for(i = 0; i<nOutputs; i++)
+                memcpy(&outputTD[i][frame*hostBlockSize], outputFrameTD[i], hostBlockSize*sizeof(float));
+        }
+
+        /* Check that the output is equivalent to the reference */
+        for(o=0; o<2; o++)
+            for(i=0; i<nFrames*hostBlockSize; i++)
+                TEST_ASSERT_TRUE( fabsf(outputTD[checkOutputs[o]][i] - refTD[o][i]) <= acceptedTolerance );
+        saf_matrixConv_destroy(&hMatrixConv);
+    }
+
+    /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
+    free(inputTD);
+    free(outputTD);
+    free(inputFrameTD);
+    free(outputFrameTD);
+    free(refTD);
+    free(y_ref);
+    free(filters);
+}
+
+void test__saf_matrixConv_sparse(void){
+    int i, o, frame, usePartFLAG, threaded;
+    float** inputTD, **outputTD, **inputFrameTD, **outputFrameTD, **refTD, *y_ref;
+    float*** filters;
+    void* hMatrixConv, *hThreadPool;
+
+    /* config */
+    const float acceptedTolerance = 0.001f;
+    const int signalLength = 24000;
+    const int hostBlockSize = 256;
+    const int filterLength = 3000;
+    const int nInputs = 6;
+    const int nOutputs = 8;
+    const int nFrames = (int)signalLength/hostBlockSize;
+
+    /* prep */
+    inputTD = (float**)malloc2d(nInputs, signalLength, sizeof(float));
+    outputTD = (float**)malloc2d(nOutputs, signalLength, sizeof(float));
+    inputFrameTD = (float**)malloc2d(nInputs, hostBlockSize, sizeof(float));
+    outputFrameTD = (float**)calloc2d(nOutputs, hostBlockSize, sizeof(float));
+    refTD = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    y_ref = malloc1d(signalLength*sizeof(float));
+    filters = (float***)calloc3d(nOutputs, nInputs, filterLength, sizeof(float));
+    rand_m1_1(FLATTEN2D(inputTD), nInputs*signalLength);
+    saf_threadPool_create(&hThreadPool, 2);
+
+    /* Mostly diagonal routing matrix, where the filters also have a silent stretch in the middle */
+    for(o=0; o<nOutputs; o++){
+        rand_m1_1(filters[o][o%nInputs], filterLength);
+        memset(&filters[o][o%nInputs][filterLength/4], 0, (filterLength/2)*sizeof(float));
+    }
+    rand_m1_1(filters[0][nInputs-1], filterLength/2);
+    for(o=0; o<nOutputs; o++){
+        for(i = 0; i<nInputs; i++){
+            fftfilt(inputTD[i], filters[o][i], signalLength, filterLength, 1, y_ref);
+            cblas_saxpy(signalLength, 1.0f, y_ref, 1, refTD[o], 1);
+        }
+    }
+
+    /* Test the non-partitioned, partitioned, and non-uniform partitioned modes (also with the tails computed on worker threads) */
+    for(usePartFLAG = 0, threaded = 0; usePartFLAG<3; threaded = !threaded, usePartFLAG += !threaded){
+        saf_matrixConv_create(&hMatrixConv, hostBlockSize, FLATTEN3D(filters), filterLength,
+                              nInputs, nOutputs, usePartFLAG);
+        if(threaded)
+            saf_matrixConv_setThreadPool(hMatrixConv, hThreadPool);
+
+        /* Apply */
+        for(frame = 0; frame<nFrames; frame++){
+            for(i = 0; i<nInputs; i++)
+                memcpy(inputFrameTD[i], &inputTD[i][frame*hostBlockSize], hostBlockSize*sizeof(float));
+            saf_matrixConv_apply(hMatrixConv, FLATTEN2D(inputFrameTD), FLATTEN2D(outputFrameTD));
+            for(i = 0; i<nOutputs; i++)
+                memcpy(&outputTD[i][frame*hostBlockSize], outputFrameTD[i], hostBlockSize*sizeof(float));
+        }
+
+        /* Skipping the zero sub-filters and partitions should not change the output */
+        for(o=0; o<nOutputs; o++)
+            for(i=0; i<nFrames*hostBlockSize; i++)
+                TEST_ASSERT_TRUE( fabsf(outputTD[o][i] - refTD[o][i]) <= acceptedTolerance );
+
+        /* With the threshold set above the peak of the filters, everything should be skipped */
+        saf_matrixConv_reset(hMatrixConv);
+        saf_matrixConv_setSparsityThreshold(hMatrixConv, 1.0f);
+        for(frame = 0; frame<4; frame++){
+            for(i = 0; i<nInputs; i++)
+                memcpy(inputFrameTD[i], &inputTD[i][frame*hostBlockSize], hostBlockSize*sizeof(float));
+            saf_matrixConv_apply(hMatrixConv, FLATTEN2D(inputFrameTD), FLATTEN2D(outputFrameTD));
+            for(i=0; i<nOutputs*hostBlockSize; i++)
+                TEST_ASSERT_TRUE( FLATTEN2D(outputFrameTD)[i] == 0.0f );
+        }
+        saf_matrixConv_destroy(&hMatrixConv);
+    }
+
+    /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
+    free(inputTD);
+    free(outputTD);
+    free(inputFrameTD);
+    free(outputFrameTD);
+    free(refTD);
+    free(y_ref);
+    free(filters);
+}
+
+/** Arguments for test__saf_matrixConv_updateJob() */
+typedef struct _test__saf_matrixConv_updateArgs {
+    void* hMatrixConv;
+    float* filters;
+    int filterLength;
+} test__saf_matrixConv_updateArgs;
+
+/** Job for test__saf_matrixConv_updateFilters(), which updates the filters from a worker thread */
+static void test__saf_matrixConv_updateJob(void* arg){
+    test__saf_matrixConv_updateArgs* args = (test__saf_matrixConv_updateArgs*)arg;
+    saf_matrixConv_updateFilters(args->hMatrixConv, args->filters, args->filterLength);
+}
+
+void test__saf_matrixConv_updateFilters(void){
+    int i, o, n, frame, usePartFLAG, threaded, swapSample;
+    float w, expected;
+    float** inputTD, **outputTD, **inputFrameTD, **outputFrameTD, **refTD_A, **refTD_B, **refTD_AB, *x_masked, *y_ref;
+    float*** filtersA, ***filtersB;
+    void* hMatrixConv, *hThreadPool;
+    saf_threadPool_job job;
+    test__saf_matrixConv_updateArgs args;
+
+    /* config */
+    const float acceptedTolerance = 0.001f;
+    const int signalLength = 24000;
+    const int hostBlockSize = 256;
+    const int filterLength = 4000;
+    const int filterLengthB = 2500; /* (the new filters may also be shorter) */
+    const int nInputs = 3;
+    const int nOutputs = 4;
+    const int nFrames = (int)signalLength/hostBlockSize;
+    const int swapFrame = 32; /* (a multiple of the largest non-uniform partition size, so that the swap is not deferred) */
+
+    /* prep */
+    inputTD = (float**)malloc2d(nInputs, signalLength, sizeof(float));
+    outputTD = (float**)malloc2d(nOutputs, signalLength, sizeof(float));
+    inputFrameTD = (float**)malloc2d(nInputs, hostBlockSize, sizeof(float));
+    outputFrameTD = (float**)calloc2d(nOutputs, hostBlockSize, sizeof(float));
+    refTD_A = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    refTD_B = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    refTD_AB = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    x_masked = malloc1d(signalLength*sizeof(float));
+    y_ref = malloc1d(signalLength*sizeof(float));
+    filtersA = (float***)malloc3d(nOutputs, nInputs, filterLength, sizeof(float));
+    filtersB = (float***)malloc3d(nOutputs, nInputs, filterLengthB, sizeof(float));
+    rand_m1_1(FLATTEN2D(inputTD), nInputs*signalLength);
+    rand_m1_1(FLATTEN3D(filtersA), nOutputs*nInputs*filterLength);
+    rand_m1_1(FLATTEN3D(filtersB), nOutputs*nInputs*filterLengthB);
+    saf_threadPool_create(&hThreadPool, 2);
+    saf_threadPool_initJob(&job, test__saf_matrixConv_updateJob, (void*)&args);
+
+    /* References: the old filters throughout (A), the new filters throughout (B), and the old filters applied to the input
+     * prior to the swap, while the new filters are applied to the input thereafter (AB) */
+    swapSample = swapFrame*hostBlockSize;
+    for(o=0; o<nOutputs; o++){
+        for(i = 0; i<nInputs; i++){
+            fftfilt(inputTD[i], filtersA[o][i], signalLength, filterLength, 1, y_ref);
+            cblas_saxpy(signalLength, 1.0f, y_ref, 1, refTD_A[o], 1);
+            fftfilt(inputTD[i], filtersB[o][i], signalLength, filterLengthB, 1, y_ref);
+            cblas_saxpy(signalLength, 1.0f, y_ref, 1, refTD_B[o], 1);
+            memcpy(x_masked, inputTD[i], swapSample*sizeof(float));
+            memset(&x_masked[swapSample], 0, (signalLength-swapSample)*sizeof(float));
+            fftfilt(x_masked, filtersA[o][i], signalLength, filterLength, 1, y_ref);
+            cblas_saxpy(signalLength, 1.0f, y_ref, 1, refTD_AB[o], 1);
+            memset(x_masked, 0, swapSample*sizeof(float));
+            memcpy(&x_masked[swapSample], &inputTD[i][swapSample], (signalLength-swapSample)*sizeof(float));
+            fftfilt(x_masked, filtersB[o][i], signalLength, filterLengthB, 1, y_ref);
+            cblas_saxpy(signalLength, 1.0f, y_ref, 1, refTD_AB[o], 1);
+        }
+    }
+
+    /* Test the non-partitioned, partitioned, and non-uniform partitioned modes (also with the filters updated by a worker thread) */
+    for(usePartFLAG = 0, threaded = 0; usePartFLAG<3; threaded = !threaded, usePartFLAG += !threaded){
+        saf_matrixConv_create(&hMatrixConv, hostBlockSize, FLATTEN3D(filtersA), filterLength,
+                              nInputs, nOutputs, usePartFLAG);
+        if(threaded)
+            saf_matrixConv_setThreadPool(hMatrixConv, hThreadPool);
+
+        /* Apply */
+        for(frame = 0; frame<nFrames; frame++){
+            if(frame==swapFrame){
+                if(threaded){
+                    args.hMatrixConv = hMatrixConv;
+                    args.filters = FLATTEN3D(filtersB);
+                    args.filterLength = filterLengthB;
+                    saf_threadPool_submit(hThreadPool, &job);
+                    saf_threadPool_wait(hThreadPool, &job);
+                }
+                else
+                    saf_matrixConv_updateFilters(hMatrixConv, FLATTEN3D(filtersB), filterLengthB);
+            }
+            for(i = 0; i<nInputs; i++)
+                memcpy(inputFrameTD[i], &inputTD[i][frame*hostBlockSize], hostBlockSize*sizeof(float));
+            saf_matrixConv_apply(hMatrixConv, FLATTEN2D(inputFrameTD), FLATTEN2D(outputFrameTD));
+            for(i = 0; i<nOutputs; i++)
+                memcpy(&outputTD[i][frame*hostBlockSize], outputFrameTD[i], hostBlockSize*sizeof(float));
+        }
+
+        /* Partitioned: the output should cross-fade from that of the old filters to that of the new filters over the swap hop.
+         * Otherwise: the old filters should only be applied to the input prior to the swap (and the new filters thereafter) */
+        for(o=0; o<nOutputs; o++){
+            for(n=0; n<nFrames*hostBlockSize; n++){
+                if(usePartFLAG==1){
+                    w = n<swapSample ? 0.0f : n>=swapSample+hostBlockSize ? 1.0f : (float)(n-swapSample)/(float)(hostBlockSize-1);
+                    expected = (1.0f-w)*refTD_A[o][n] + w*refTD_B[o][n];
+                }
+                else
+                    expected = refTD_AB[o][n];
+                TEST_ASSERT_TRUE( fabsf(outputTD[o][n] - expected) <= acceptedTolerance );
+            }
+        }
+        saf_matrixConv_destroy(&hMatrixConv);
+    }
+
+    /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
+    free(inputTD);
+    free(outputTD);
+    free(inputFrameTD);
+    free(outputFrameTD);
+    free(refTD_A);
+    free(refTD_B);
+    free(refTD_AB);
+    free(x_masked);
+    free(y_ref);
+    free(filtersA);
+    free(filtersB);
+}
 
-    /* Apply */
-    for(frame = 0; frame<(int)signalLength/hostBlockSize; frame++){
-        for(i = 0; i<nInputs; i++)
-            memcpy(inputFrameTD[i], &inputTD[i][frame*hostBlockSize], hostBlockSize*sizeof(float));
+void test__saf_multiConv(void){
+    int i, frame, usePartFLAG, threaded;
+    float** inputTD, **outputTD, **refTD, **inputFrameTD, **outputFrameTD, **filters;
+    void* hMultiConv, *hThreadPool;
 
-        saf_matrixConv_apply(hMatrixConv, FLATTEN2D(inputFrameTD), FLATTEN2D(outputFrameTD));
+    /* config */
+    const float acceptedTolerance = 0.001f;
+    const int signalLength = 48000;
+    const int hostBlockSize = 128;
+    const int filterLength = 20000; /* long enough to span several levels of the non-uniform partitioning */
+    const int nCH = 4;
+    const int nFrames = (int)signalLength/hostBlockSize;
+
+    /* prep */
+    inputTD = (float**)malloc2d(nCH, signalLength, sizeof(float));
+    outputTD = (float**)malloc2d(nCH, signalLength, sizeof(float));
+    refTD = (float**)malloc2d(nCH, signalLength, sizeof(float));
+    inputFrameTD = (float**)malloc2d(nCH, hostBlockSize, sizeof(float));
+    outputFrameTD = (float**)calloc2d(nCH, hostBlockSize, sizeof(float));
+    filters = (float**)malloc2d(nCH, filterLength, sizeof(float));
+    rand_m1_1(FLATTEN2D(filters), nCH*filterLength);
+    rand_m1_1(FLATTEN2D(inputTD), nCH*signalLength);
+    for(i=0; i<filterLength; i++) /* Exponentially decaying, reverb-like, filters */
+        cblas_sscal(nCH, expf(-6.9f*(float)i/(float)filterLength)/10.0f, &filters[0][i], filterLength);
+    saf_threadPool_create(&hThreadPool, 3);
+
+    /* Reference */
+    fftfilt(FLATTEN2D(inputTD), FLATTEN2D(filters), signalLength, filterLength, nCH, FLATTEN2D(refTD));
+
+    /* Test the non-partitioned, partitioned, and non-uniform partitioned modes (also with the tails computed on worker threads) */
+    for(usePartFLAG = 0, threaded = 0; usePartFLAG<3; threaded = !threaded, usePartFLAG += !threaded){
+        saf_multiConv_create(&hMultiConv, hostBlockSize, FLATTEN2D(filters), filterLength, nCH, usePartFLAG);
+        if(threaded)
+            saf_multiConv_setThreadPool(hMultiConv, hThreadPool);
+
+        /* Apply */
+        for(frame = 0; frame<nFrames; frame++){
+            for(i = 0; i<nCH; i++)
+                memcpy(inputFrameTD[i], &inputTD[i][frame*hostBlockSize], hostBlockSize*sizeof(float));
+
+            /* Switching between single- and multi-threaded processing mid-stream should be seamless */
+            if(threaded && frame==nFrames/2)
+                saf_multiConv_setThreadPool(hMultiConv, NULL);
+            else if(threaded && frame==3*nFrames/4)
+                saf_multiConv_setThreadPool(hMultiConv, hThreadPool);
+
+            saf_multiConv_apply(hMultiConv, FLATTEN2D(inputFrameTD), FLATTEN2D(outputFrameTD));
+
+            for(i = 0; i<nCH; i++)
+                memcpy(&outputTD[i][frame*hostBlockSize], outputFrameTD[i], hostBlockSize*sizeof(float));
+        }
 
-        for(i = 0; i<nOutputs; i++)
-            memcpy(&outputTD[i][frame*hostBlockSize], outputFrameTD[i], hostBlockSize*sizeof(float));
+        /* Check that the output is equivalent to the reference */
+        for(i=0; i<nFrames*hostBlockSize; i++)
+            TEST_ASSERT_TRUE( fabsf(outputTD[nCH-1][i] - refTD[nCH-1][i]) <= acceptedTolerance );
+
+        /* Flushing the buffers should result in the same output again */
+        saf_multiConv_reset(hMultiConv);
+        for(i = 0; i<nCH; i++)
+            memcpy(inputFrameTD[i], inputTD[i], hostBlockSize*sizeof(float));
+        saf_multiConv_apply(hMultiConv, FLATTEN2D(inputFrameTD), FLATTEN2D(outputFrameTD));
+        for(i=0; i<hostBlockSize; i++)
+            TEST_ASSERT_TRUE( fabsf(outputFrameTD[0][i] - refTD[0][i]) <= acceptedTolerance );
+        saf_multiConv_destroy(&hMultiConv);
     }
 
     /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
     free(inputTD);
     free(outputTD);
+    free(refTD);
+    free(inputFrameTD);
+    free(outputFrameTD);
+    free(filters);
+}
+
+void test__saf_convSpectra(void){
+    int i, o, n, frame, usePartFLAG;
+    float** inputFrameTD, **outputFrameTD, **refFrameTD;
+    float*** filtersA, ***filtersB;
+    void* hCS, *hRef, *hShared[3];
+
+    /* config */
+    const float acceptedTolerance = 0.00001f;
+    const int hostBlockSize = 256;
+    const int filterLength = 4000;
+    const int nInputs = 3;
+    const int nOutputs = 4;
+    const int nFrames = 60;
+
+    /* prep */
+    inputFrameTD = (float**)malloc2d(SAF_MAX(nInputs, nOutputs), hostBlockSize, sizeof(float));
+    outputFrameTD = (float**)malloc2d(SAF_MAX(nInputs, nOutputs), hostBlockSize, sizeof(float));
+    refFrameTD = (float**)malloc2d(SAF_MAX(nInputs, nOutputs), hostBlockSize, sizeof(float));
+    filtersA = (float***)malloc3d(nOutputs, nInputs, filterLength, sizeof(float));
+    filtersB = (float***)malloc3d(nOutputs, nInputs, filterLength, sizeof(float));
+    rand_m1_1(FLATTEN3D(filtersA), nOutputs*nInputs*filterLength);
+    rand_m1_1(FLATTEN3D(filtersB), nOutputs*nInputs*filterLength);
+
+    /* Instances sharing the same spectra should behave exactly like an instance with its own (for all modes) */
+    for(usePartFLAG=0; usePartFLAG<3; usePartFLAG++){
+        /* Matrix convolver. The second instance updates its filters, which must not affect the others */
+        saf_matrixConv_create(&hRef, hostBlockSize, FLATTEN3D(filtersA), filterLength, nInputs, nOutputs, usePartFLAG);
+        saf_convSpectra_createMatrix(&hCS, hostBlockSize, FLATTEN3D(filtersA), filterLength, nInputs, nOutputs, usePartFLAG);
+        saf_matrixConv_createShared(&hShared[0], hCS);
+        saf_matrixConv_createShared(&hShared[1], hCS);
+        saf_matrixConv_updateFilters(hShared[1], FLATTEN3D(filtersB), filterLength);
+        saf_matrixConv_createShared(&hShared[2], hCS);
+        saf_convSpectra_destroy(&hCS); /* (the instances keep the spectra alive) */
+        TEST_ASSERT_TRUE(hCS==NULL);
+        for(frame=0; frame<nFrames; frame++){
+            rand_m1_1(FLATTEN2D(inputFrameTD), nInputs*hostBlockSize);
+            saf_matrixConv_apply(hRef, FLATTEN2D(inputFrameTD), FLATTEN2D(refFrameTD));
+            for(n=0; n<3; n++){
+                saf_matrixConv_apply(hShared[n], FLATTEN2D(inputFrameTD), FLATTEN2D(outputFrameTD));
+                if(n==1)
+                    continue;
+                for(o=0; o<nOutputs; o++)
+                    for(i=0; i<hostBlockSize; i++)
+                        TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, refFrameTD[o][i], outputFrameTD[o][i]);
+            }
+        }
+        saf_matrixConv_destroy(&hRef);
+        for(n=0; n<3; n++)
+            saf_matrixConv_destroy(&hShared[n]);
+
+        /* Multi-channel convolver (with the filters of the first output as the channel filters) */
+        saf_multiConv_create(&hRef, hostBlockSize, FLATTEN3D(filtersA), filterLength, nInputs, usePartFLAG);
+        saf_convSpectra_createMulti(&hCS, hostBlockSize, FLATTEN3D(filtersA), filterLength, nInputs, usePartFLAG);
+        saf_multiConv_createShared(&hShared[0], hCS);
+        saf_multiConv_createShared(&hShared[1], hCS);
+        saf_convSpectra_destroy(&hCS);
+        for(frame=0; frame<nFrames; frame++){
+            rand_m1_1(FLATTEN2D(inputFrameTD), nInputs*hostBlockSize);
+            saf_multiConv_apply(hRef, FLATTEN2D(inputFrameTD), FLATTEN2D(refFrameTD));
+            for(n=0; n<2; n++){
+                saf_multiConv_apply(hShared[n], FLATTEN2D(inputFrameTD), FLATTEN2D(outputFrameTD));
+                for(o=0; o<nInputs; o++)
+                    for(i=0; i<hostBlockSize; i++)
+                        TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, refFrameTD[o][i], outputFrameTD[o][i]);
+            }
+        }
+        saf_multiConv_destroy(&hRef);
+        for(n=0; n<2; n++)
+            saf_multiConv_destroy(&hShared[n]);
+    }
+
+    /* clean-up */
     free(inputFrameTD);
     free(outputFrameTD);
+    free(refFrameTD);
+    free(filtersA);
+    free(filtersB);
+}
+
+void test__saf_TVConv(void){
+    int i, frame, irIdx;
+    float** inputTD, **outputTD, **refTD, **filters;
+    void* hTVConv, *hThreadPool;
+
+    /* config */
+    const float acceptedTolerance = 0.0001f;
+    const int signalLength = 48000;
+    const int hostBlockSize = 256;
+    const int filterLength = 4000;
+    const int nIRs = 8;
+    const int nOutputs = 2;
+    const int nFrames = (int)signalLength/hostBlockSize;
+
+    /* prep */
+    inputTD = (float**)malloc2d(1, signalLength, sizeof(float));
+    outputTD = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    refTD = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    filters = (float**)malloc2d(nIRs, nOutputs*filterLength, sizeof(float));
+    rand_m1_1(FLATTEN2D(filters), nIRs*nOutputs*filterLength);
+    rand_m1_1(FLATTEN2D(inputTD), signalLength);
+    saf_threadPool_create(&hThreadPool, 2);
+
+    /* Reference: single-threaded, with the IR changing every few frames */
+    saf_TVConv_create(&hTVConv, hostBlockSize, filters, filterLength, nIRs, nOutputs, 0);
+    for(frame = 0; frame<nFrames; frame++){
+        irIdx = (frame/5) % nIRs;
+        saf_TVConv_apply(hTVConv, &inputTD[0][frame*hostBlockSize], FLATTEN2D(outputTD), irIdx);
+        for(i=0; i<nOutputs; i++)
+            memcpy(&refTD[i][frame*hostBlockSize], outputTD[i], hostBlockSize*sizeof(float));
+    }
+    saf_TVConv_destroy(&hTVConv);
+
+    /* The output should be the same, when the tails are computed on worker threads */
+    saf_TVConv_create(&hTVConv, hostBlockSize, filters, filterLength, nIRs, nOutputs, 0);
+    saf_TVConv_setThreadPool(hTVConv, hThreadPool);
+    for(frame = 0; frame<nFrames; frame++){
+        irIdx = (frame/5) % nIRs;
+        saf_TVConv_apply(hTVConv, &inputTD[0][frame*hostBlockSize], FLATTEN2D(outputTD), irIdx);
+        for(i=0; i<hostBlockSize; i++){
+            TEST_ASSERT_TRUE( fabsf(outputTD[0][i] - refTD[0][frame*hostBlockSize+i]) <= acceptedTolerance );
+            TEST_ASSERT_TRUE( fabsf(outputTD[nOutputs-1][i] - refTD[nOutputs-1][frame*hostBlockSize+i]) <= acceptedTolerance );
+        }
+    }
+    saf_TVConv_destroy(&hTVConv);
+
+    /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
+    free(inputTD);
+    free(outputTD);
+    free(refTD);
     free(filters);
-    saf_matrixConv_destroy(&hMatrixConv);
+}
+
+void test__saf_TVConv_cache(void){
+    int i, frame, irIdx, nextIdx[2], config, cacheSize, threaded;
+    int* irSequence;
+    float** inputTD, **outputTD, **refTD, **filters;
+    void* hTVConv, *hThreadPool;
+
+    /* config */
+    const float acceptedTolerance = 0.0001f;
+    const int signalLength = 48000;
+    const int hostBlockSize = 256;
+    const int filterLength = 3000;
+    const int nIRs = 24;
+    const int nOutputs = 3;
+    const int nFrames = (int)signalLength/hostBlockSize;
+
+    /* prep */
+    inputTD = (float**)malloc2d(1, signalLength, sizeof(float));
+    outputTD = (float**)calloc2d(nOutputs, hostBlockSize, sizeof(float));
+    refTD = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    filters = (float**)malloc2d(nIRs, nOutputs*filterLength, sizeof(float));
+    irSequence = malloc1d((nFrames+2)*sizeof(int));
+    rand_m1_1(FLATTEN2D(filters), nIRs*nOutputs*filterLength);
+    rand_m1_1(FLATTEN2D(inputTD), signalLength);
+    saf_threadPool_create(&hThreadPool, 2);
+
+    /* A random walk over the IRs, with the occasional jump */
+    irSequence[0] = 0;
+    for(frame = 1; frame<nFrames+2; frame++){
+        irSequence[frame] = irSequence[frame-1];
+        if(frame%3==0)
+            irSequence[frame] = (irSequence[frame] + (rand()%7==0 ? rand()%nIRs : 1)) % nIRs;
+    }
+
+    /* Reference: all IRs transformed upon creation */
+    saf_TVConv_create(&hTVConv, hostBlockSize, filters, filterLength, nIRs, nOutputs, 0);
+    for(frame = 0; frame<nFrames; frame++){
+        saf_TVConv_apply(hTVConv, &inputTD[0][frame*hostBlockSize], FLATTEN2D(outputTD), irSequence[frame]);
+        for(i=0; i<nOutputs; i++)
+            memcpy(&refTD[i][frame*hostBlockSize], outputTD[i], hostBlockSize*sizeof(float));
+    }
+    saf_TVConv_destroy(&hTVConv);
+
+    /* The output should be the same with the IRs transformed on demand; for the smallest cache, and for a larger cache
+     * with the upcoming IRs hinted (also with a thread pool) */
+    for(config = 0; config<4; config++){
+        cacheSize = config<2 ? 4 : 6;
+        threaded = config%2;
+        saf_TVConv_createCached(&hTVConv, hostBlockSize, filters, filterLength, nIRs, nOutputs, 0, cacheSize);
+        if(threaded)
+            saf_TVConv_setThreadPool(hTVConv, hThreadPool);
+        for(frame = 0; frame<nFrames; frame++){
+            irIdx = irSequence[frame];
+            if(cacheSize>4){
+                nextIdx[0] = irSequence[frame+1];
+                nextIdx[1] = irSequence[frame+2];
+                saf_TVConv_prefetch(hTVConv, nextIdx, 2);
+            }
+            saf_TVConv_apply(hTVConv, &inputTD[0][frame*hostBlockSize], FLATTEN2D(outputTD), irIdx);
+            for(i=0; i<hostBlockSize; i++){
+                TEST_ASSERT_TRUE( fabsf(outputTD[0][i] - refTD[0][frame*hostBlockSize+i]) <= acceptedTolerance );
+                TEST_ASSERT_TRUE( fabsf(outputTD[nOutputs-1][i] - refTD[nOutputs-1][frame*hostBlockSize+i]) <= acceptedTolerance );
+            }
+        }
+        saf_TVConv_destroy(&hTVConv);
+    }
+
+    /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
+    free(inputTD);
+    free(outputTD);
+    free(refTD);
+    free(filters);
+    free(irSequence);
+}
+
+void test__saf_TVConv_interp(void){
+    int i, o, frame, config, idx[2];
+    float w[2];
+    float** inputTD, **outputTD, **outputFrameTD, **refTD, **refTD2, **filters, *h_interp;
+    void* hTVConv, *hThreadPool;
+
+    /* config */
+    const float acceptedTolerance = 0.001f;
+    const int signalLength = 24000;
+    const int hostBlockSize = 256;
+    const int filterLength = 3000;
+    const int nIRs = 12;
+    const int nOutputs = 2;
+    const int nFrames = (int)signalLength/hostBlockSize;
+
+    /* prep */
+    inputTD = (float**)malloc2d(1, signalLength, sizeof(float));
+    outputTD = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    outputFrameTD = (float**)calloc2d(nOutputs, hostBlockSize, sizeof(float));
+    refTD = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    refTD2 = (float**)calloc2d(nOutputs, signalLength, sizeof(float));
+    filters = (float**)malloc2d(nIRs, nOutputs*filterLength, sizeof(float));
+    h_interp = malloc1d(filterLength*sizeof(float));
+    rand_m1_1(FLATTEN2D(filters), nIRs*nOutputs*filterLength);
+    rand_m1_1(FLATTEN2D(inputTD), signalLength);
+    saf_threadPool_create(&hThreadPool, 2);
+
+    /* Reference for fixed weights: convolution with the interpolated IRs */
+    idx[0] = 3; idx[1] = 7;
+    w[0] = 0.3f; w[1] = 0.7f;
+    for(o=0; o<nOutputs; o++){
+        for(i=0; i<filterLength; i++)
+            h_interp[i] = w[0]*filters[idx[0]][o*filterLength+i] + w[1]*filters[idx[1]][o*filterLength+i];
+        fftfilt(inputTD[0], h_interp, signalLength, filterLength, 1, refTD[o]);
+    }
+
+    /* The output should match (after the first few hops, over which the spectra are ramped from those of the initial
+     * IR), also with a thread pool, and with the IRs transformed on demand */
+    for(config=0; config<3; config++){
+        if(config<2)
+            saf_TVConv_create(&hTVConv, hostBlockSize, filters, filterLength, nIRs, nOutputs, 0);
+        else
+            saf_TVConv_createCached(&hTVConv, hostBlockSize, filters, filterLength, nIRs, nOutputs, 0, 4);
+        if(config>0)
+            saf_TVConv_setThreadPool(hTVConv, hThreadPool);
+        for(frame = 0; frame<nFrames; frame++){
+            saf_TVConv_applyInterp(hTVConv, &inputTD[0][frame*hostBlockSize], FLATTEN2D(outputFrameTD), idx, w, 2);
+            for(o=0; o<nOutputs; o++)
+                memcpy(&outputTD[o][frame*hostBlockSize], outputFrameTD[o], hostBlockSize*sizeof(float));
+        }
+        for(o=0; o<nOutputs; o++)
+            for(i=6*hostBlockSize; i<nFrames*hostBlockSize; i++)
+                TEST_ASSERT_TRUE( fabsf(outputTD[o][i] - refTD[o][i]) <= acceptedTolerance );
+        saf_TVConv_destroy(&hTVConv);
+    }
+
+    /* With gradually moving weights, the output should be the same with and without a thread pool, and with the IRs
+     * transformed on demand into the smallest cache */
+    for(config=0; config<3; config++){
+        if(config<2)
+            saf_TVConv_create(&hTVConv, hostBlockSize, filters, filterLength, nIRs, nOutputs, 0);
+        else
+            saf_TVConv_createCached(&hTVConv, hostBlockSize, filters, filterLength, nIRs, nOutputs, 0, 4);
+        if(config>0)
+            saf_TVConv_setThreadPool(hTVConv, hThreadPool);
+        for(frame = 0; frame<nFrames; frame++){
+            idx[0] = (frame/16) % nIRs;
+            idx[1] = (idx[0]+1) % nIRs;
+            w[1] = (float)(frame%16)/16.0f;
+            w[0] = 1.0f - w[1];
+            if(frame>=nFrames/2 && frame%16>=8){ /* (also with the weights held steady for a while) */
+                w[0] = 0.5f; w[1] = 0.5f;
+            }
+            saf_TVConv_applyInterp(hTVConv, &inputTD[0][frame*hostBlockSize], FLATTEN2D(outputFrameTD), idx, w, 2);
+            for(o=0; o<nOutputs; o++)
+                memcpy(&(config==0 ? refTD2 : outputTD)[o][frame*hostBlockSize], outputFrameTD[o], hostBlockSize*sizeof(float));
+        }
+        saf_TVConv_destroy(&hTVConv);
+        for(o=0; o<nOutputs && config>0; o++)
+            for(i=0; i<nFrames*hostBlockSize; i++)
+                TEST_ASSERT_TRUE( fabsf(outputTD[o][i] - refTD2[o][i]) <= acceptedTolerance );
+    }
+
+    /* Switching between saf_TVConv_apply() and saf_TVConv_applyInterp() with the same IR should be seamless (also
+     * while a cross-fade between IRs is still on-going) */
+    for(config=0; config<2; config++){
+        saf_TVConv_create(&hTVConv, hostBlockSize, filters, filterLength, nIRs, nOutputs, 0);
+        if(config>0)
+            saf_TVConv_setThreadPool(hTVConv, hThreadPool);
+        for(frame = 0; frame<nFrames; frame++){
+            idx[0] = (frame/8) % nIRs;
+            w[0] = 1.0f;
+            if(config==0 || frame%8==0 || (frame/4)%3==0)
+                saf_TVConv_apply(hTVConv, &inputTD[0][frame*hostBlockSize], FLATTEN2D(outputFrameTD), idx[0]);
+            else
+                saf_TVConv_applyInterp(hTVConv, &inputTD[0][frame*hostBlockSize], FLATTEN2D(outputFrameTD), idx, w, 1);
+            for(o=0; o<nOutputs; o++)
+                memcpy(&(config==0 ? refTD2 : outputTD)[o][frame*hostBlockSize], outputFrameTD[o], hostBlockSize*sizeof(float));
+        }
+        saf_TVConv_destroy(&hTVConv);
+    }
+    for(o=0; o<nOutputs; o++)
+        for(i=0; i<nFrames*hostBlockSize; i++)
+            TEST_ASSERT_TRUE( fabsf(outputTD[o][i] - refTD2[o][i]) <= acceptedTolerance );
+
+    /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
+    free(inputTD);
+    free(outputTD);
+    free(outputFrameTD);
+    free(refTD);
+    free(refTD2);
+    free(filters);
+    free(h_interp);
+}
+
+/** Job for test__saf_threadPool(), which adds a ramp to the data */
+static void test__saf_threadPool_job(void* arg){
+    float* data = (float*)arg;
+    for(int i=0; i<1000; i++)
+        data[i] += (float)i;
+}
+
+/** Job for test__saf_threadPool(), which takes long enough for the waiting
+ * thread to park */
+static void test__saf_threadPool_slowJob(void* arg){
+    SAF_SLEEP(5);
+    test__saf_threadPool_job(arg);
+}
+
+/** Job for test__saf_threadPool(), which keeps a worker busy for a while */
+static void test__saf_threadPool_verySlowJob(void* arg){
+    SAF_SLEEP(50);
+    test__saf_threadPool_job(arg);
+}
+
+void test__saf_threadPool(void){
+    int i, j;
+    void* hThreadPool;
+    saf_threadPool_job* jobs;
+    float** data;
+
+    /* config */
+    const int nJobs = 2*SAF_THREADPOOL_MAX_NUM_JOBS; /* (more than can be queued at once) */
+    const int dataLength = 1000;
+
+    /* prep */
+    jobs = malloc1d(nJobs*sizeof(saf_threadPool_job));
+    data = (float**)calloc2d(nJobs, dataLength, sizeof(float));
+    saf_threadPool_create(&hThreadPool, 0);
+    TEST_ASSERT_TRUE(saf_threadPool_getNumThreads(hThreadPool)>=1);
+
+    /* Each job fills its own row of data, several times over */
+    for(j=0; j<3; j++){
+        for(i=0; i<nJobs; i++){
+            saf_threadPool_initJob(&jobs[i], test__saf_threadPool_job, (void*)data[i]);
+            saf_threadPool_submit(hThreadPool, &jobs[i]);
+        }
+        for(i=0; i<nJobs; i++){
+            saf_threadPool_wait(hThreadPool, &jobs[i]);
+            TEST_ASSERT_TRUE(saf_threadPool_isDone(&jobs[i]));
+        }
+    }
+    for(i=0; i<nJobs; i++)
+        for(j=0; j<dataLength; j++)
+            TEST_ASSERT_EQUAL_FLOAT(3.0f*(float)j, data[i][j]);
+
+    /* Waiting on jobs which are already running, and take a while (i.e. the waiting thread parks, and must be woken up) */
+    for(j=0; j<3; j++){
+        for(i=0; i<4; i++){
+            saf_threadPool_initJob(&jobs[i], test__saf_threadPool_slowJob, (void*)data[i]);
+            saf_threadPool_submit(hThreadPool, &jobs[i]);
+        }
+        for(i=0; i<4; i++){
+            saf_threadPool_wait(hThreadPool, &jobs[i]);
+            TEST_ASSERT_TRUE(saf_threadPool_isDone(&jobs[i]));
+        }
+    }
+    for(i=0; i<4; i++)
+        for(j=0; j<dataLength; j++)
+            TEST_ASSERT_EQUAL_FLOAT(6.0f*(float)j, data[i][j]);
+    saf_threadPool_destroy(&hThreadPool);
+
+    /* With the only worker busy, waiting on a queued job runs that job on the waiting thread, but not the (slow) job
+     * queued before it by another client */
+    saf_threadPool_create(&hThreadPool, 1);
+    saf_threadPool_initJob(&jobs[0], test__saf_threadPool_verySlowJob, (void*)data[0]);
+    saf_threadPool_initJob(&jobs[1], test__saf_threadPool_slowJob, (void*)data[1]);
+    saf_threadPool_initJob(&jobs[2], test__saf_threadPool_job, (void*)data[2]);
+    saf_threadPool_submit(hThreadPool, &jobs[0]);
+    while(saf_atomic_load(&(jobs[0].state))==(long)SAF_THREADPOOL_JOB_QUEUED)
+        SAF_SLEEP(1);
+    saf_threadPool_submit(hThreadPool, &jobs[1]);
+    saf_threadPool_submit(hThreadPool, &jobs[2]);
+    saf_threadPool_wait(hThreadPool, &jobs[2]);
+    TEST_ASSERT_TRUE(saf_threadPool_isDone(&jobs[2]));
+    TEST_ASSERT_FALSE(saf_threadPool_isDone(&jobs[1]));
+    TEST_ASSERT_FALSE(saf_threadPool_tryRun(hThreadPool, &jobs[2])); /* (already done) */
+    saf_threadPool_wait(hThreadPool, &jobs[1]);
+    saf_threadPool_wait(hThreadPool, &jobs[0]);
+    for(i=0; i<3; i++)
+        for(j=0; j<dataLength; j++)
+            TEST_ASSERT_EQUAL_FLOAT(7.0f*(float)j, data[i][j]);
+
+    /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
+    free(jobs);
+    free(data);
+}
+
+/** Loop body for test__saf_threadPool_parallelFor(), which counts the number
+ * of times each iteration is executed */
+static void test__saf_threadPool_forFunc(void* arg, int start, int end){
+    int* counts = (int*)arg;
+    for(int i=start; i<end; i++)
+        counts[i]++;
+}
+
+void test__saf_threadPool_parallelFor(void){
+    int i, n, t, rep;
+    void* hThreadPool;
+    int* counts;
+
+    /* config */
+    const int nIters[6] = {0, 1, 2, 5, 133, 1000};
+    const int nReps = 20;
+
+    /* prep */
+    counts = malloc1d(1000*sizeof(int));
+
+    /* Each iteration should be executed exactly once, with and without a thread pool */
+    for(t=0; t<2; t++){
+        if(t==0)
+            hThreadPool = NULL;
+        else
+            saf_threadPool_create(&hThreadPool, 3);
+        for(n=0; n<6; n++){
+            memset(counts, 0, 1000*sizeof(int));
+            for(rep=0; rep<nReps; rep++)
+                saf_threadPool_parallelFor(hThreadPool, nIters[n], test__saf_threadPool_forFunc, (void*)counts);
+            for(i=0; i<nIters[n]; i++)
+                TEST_ASSERT_EQUAL_INT(nReps, counts[i]);
+            for(; i<1000; i++)
+                TEST_ASSERT_EQUAL_INT(0, counts[i]);
+        }
+        if(hThreadPool!=NULL)
+            saf_threadPool_destroy(&hThreadPool);
+    }
+
+    /* Clean-up */
+    free(counts);
+}
+
+/** The "real-time" side of test__saf_stateSwap() */
+typedef struct _test__saf_stateSwap_reader {
+    void* hSS;
+    int stateLength;
+    volatile long stop;      /**< 1: the reader should stop */
+    volatile long nAcquired; /**< Number of (non-NULL) states acquired so far */
+    volatile long nErrors;   /**< Number of states found to be incomplete, or older than the previous one */
+} test__saf_stateSwap_reader;
+
+/** Job for test__saf_stateSwap(), which keeps acquiring the current state and
+ * checking that it is intact (no TEST_ASSERT calls, since it is not run on the
+ * main thread) */
+static void test__saf_stateSwap_readerJob(void* arg){
+    test__saf_stateSwap_reader* r = (test__saf_stateSwap_reader*)arg;
+    long* state;
+    long gen, prevGen = -1;
+    int i, pass, intact;
+
+    while(!saf_atomic_load(&(r->stop))){
+        state = (long*)saf_stateSwap_acquire(r->hSS);
+        if(state!=NULL){
+            /* (a few passes, to mimic a state being used throughout a processing block) */
+            gen = state[0];
+            intact = gen>=prevGen;
+            for(pass=0; pass<4; pass++)
+                for(i=0; i<r->stateLength; i++)
+                    intact = intact && state[i]==gen;
+            if(!intact)
+                saf_atomic_store(&(r->nErrors), saf_atomic_load(&(r->nErrors))+1);
+            prevGen = gen;
+            saf_atomic_store(&(r->nAcquired), saf_atomic_load(&(r->nAcquired))+1);
+        }
+        saf_stateSwap_release(r->hSS);
+    }
+}
+
+void test__saf_stateSwap(void){
+    int i, gen;
+    void* hThreadPool, *hSS;
+    long* spare, *last;
+    saf_threadPool_job job;
+    test__saf_stateSwap_reader reader;
+
+    /* config */
+    const int stateLength = 512;
+    const int nGenerations = 5000;
+
+    /* Nothing to acquire until the first state is published */
+    saf_stateSwap_create(&hSS);
+    TEST_ASSERT_TRUE(saf_stateSwap_acquire(hSS)==NULL);
+    saf_stateSwap_release(hSS);
+
+    /* Start the reader */
+    reader.hSS = hSS;
+    reader.stateLength = stateLength;
+    reader.stop = reader.nAcquired = reader.nErrors = 0;
+    saf_threadPool_create(&hThreadPool, 1);
+    saf_threadPool_initJob(&job, test__saf_stateSwap_readerJob, (void*)&reader);
+    saf_threadPool_submit(hThreadPool, &job);
+
+    /* Build each generation in the state which was handed back by the previous publish (i.e. double-buffering), and
+     * scribble over handed back states straight away; the reader would notice if it was still using them */
+    spare = malloc1d(stateLength*sizeof(long));
+    for(gen=0; gen<nGenerations; gen++){
+        for(i=0; i<stateLength; i++)
+            spare[i] = (long)gen;
+        spare = (long*)saf_stateSwap_publish(hSS, (void*)spare);
+        if(spare==NULL){
+            /* Let the reader get going before publishing the rest */
+            while(saf_atomic_load(&(reader.nAcquired))==0)
+                SAF_SLEEP(1);
+            spare = malloc1d(stateLength*sizeof(long));
+        }
+        for(i=0; i<stateLength; i++)
+            spare[i] = (long)(-i);
+    }
+
+    /* Take back the last state, and stop the reader */
+    last = (long*)saf_stateSwap_publish(hSS, NULL);
+    saf_atomic_store(&(reader.stop), 1);
+    saf_threadPool_wait(hThreadPool, &job);
+    TEST_ASSERT_TRUE(reader.nAcquired>0);
+    TEST_ASSERT_EQUAL_INT(0, (int)reader.nErrors);
+    TEST_ASSERT_TRUE(last!=NULL && last!=spare);
+    for(i=0; i<stateLength; i++)
+        TEST_ASSERT_EQUAL_INT(nGenerations-1, (int)last[i]);
+
+    /* Clean-up */
+    saf_threadPool_destroy(&hThreadPool);
+    saf_stateSwap_destroy(&hSS);
+    free(spare);
+    free(last);
+}
+
+/** Frame processing function for test__saf_blockAdapter(), which copies the
+ * inputs to the outputs and counts the number of frames */
+static void test__saf_blockAdapter_frame(void* const hProc, const float* const* inputs, float* const* const outputs,
+                                         int nInputs, int nOutputs, int nSamples){
+    int* nFrames = (int*)hProc;
+    TEST_ASSERT_TRUE(nSamples==128);
+    for(int ch=0; ch<nOutputs; ch++){
+        if(ch<nInputs)
+            memcpy(outputs[ch], inputs[ch], nSamples*sizeof(float));
+        else
+            memset(outputs[ch], 0, nSamples*sizeof(float));
+    }
+    (*nFrames)++;
+}
+
+void test__saf_blockAdapter(void){
+    int i, ch, s, n, test, nFrames, latency;
+    void* hBA;
+    float** insig, **outsig;
+    const float** inPtrs;
+    float** outPtrs;
+
+    /* config */
+    const int frameSize = 128;
+    const int nInputs = 2;
+    const int nOutputs = 3;
+    const int signalLength = 8192;
+    const int blockSizes[3][5] = { {256, 256, 128, 384, 512},  /* multiples of the frame size */
+                                   {48, 32, 480, 16, 96},      /* multiples of 16 */
+                                   {100, 20, 60, 400, 4} };    /* multiples of 4 */
+    const int expectedLatency[3] = { 0, 128-16, 128-4 };
+    const int hostBlockSizeGiven[2] = { 0, 1 }; /* established by the first block, or by saf_blockAdapter_reset() */
+
+    /* prep */
+    insig = (float**)malloc2d(nInputs, signalLength, sizeof(float));
+    outsig = (float**)malloc2d(nOutputs, signalLength, sizeof(float));
+    inPtrs = (const float**)malloc1d(nInputs*sizeof(float*));
+    outPtrs = (float**)malloc1d(nOutputs*sizeof(float*));
+    for(ch=0; ch<nInputs; ch++)
+        for(i=0; i<signalLength; i++)
+            insig[ch][i] = (float)(ch*signalLength + i);
+    saf_blockAdapter_create(&hBA, frameSize, nInputs, nOutputs);
+
+    /* The output should be the input delayed by the expected latency */
+    for(test=0; test<6; test++){
+        if(hostBlockSizeGiven[test/3]){
+            saf_blockAdapter_reset(hBA, blockSizes[test%3][0]);
+            TEST_ASSERT_EQUAL_INT(expectedLatency[test%3], saf_blockAdapter_getLatency(hBA));
+        }
+        else{
+            saf_blockAdapter_reset(hBA, 0);
+            TEST_ASSERT_EQUAL_INT(0, saf_blockAdapter_getLatency(hBA));
+        }
+        nFrames = 0;
+        for(s=0, i=0; s<signalLength; s+=n, i++){
+            n = SAF_MIN(blockSizes[test%3][i%5], signalLength-s);
+            for(ch=0; ch<nInputs; ch++)
+                inPtrs[ch] = &insig[ch][s];
+            for(ch=0; ch<nOutputs; ch++)
+                outPtrs[ch] = &outsig[ch][s];
+            saf_blockAdapter_process(hBA, inPtrs, outPtrs, nInputs, nOutputs, n, test__saf_blockAdapter_frame, (void*)&nFrames);
+        }
+        latency = saf_blockAdapter_getLatency(hBA);
+        TEST_ASSERT_EQUAL_INT(expectedLatency[test%3], latency);
+        TEST_ASSERT_EQUAL_INT(signalLength/frameSize, nFrames);
+        for(ch=0; ch<nOutputs; ch++){
+            for(i=0; i<signalLength; i++){
+                if(ch<nInputs && i>=latency)
+                    TEST_ASSERT_EQUAL_FLOAT(insig[ch][i-latency], outsig[ch][i]);
+                else
+                    TEST_ASSERT_EQUAL_FLOAT(0.0f, outsig[ch][i]);
+            }
+        }
+    }
+
+    /* Clean-up */
+    saf_blockAdapter_destroy(&hBA);
+    free(insig);
+    free(outsig);
+    free(inPtrs);
+    free(outPtrs);
+}
+
+void test__saf_arena(void){
+    int i, j, k, pass, nBlocks;
+    size_t capacity = 0; /* (set by the first pass) */
+    void* hArena;
+    float* a1d;
+    int** a2d;
+    float_complex*** a3d;
+    float* big;
+    const int N = 1000;
+
+    saf_arena_create(&hArena, 0);
+    TEST_ASSERT_TRUE(saf_arena_getCapacity(hArena) == 0);
+    TEST_ASSERT_TRUE(saf_arena_malloc1d(hArena, 0) == NULL);
+
+    for(pass=0; pass<3; pass++){
+        /* (Re-)initialise, with more than fits in the default block size */
+        saf_arena_reset(hArena);
+        TEST_ASSERT_TRUE(saf_arena_getUsed(hArena) == 0);
+        a1d = (float*)saf_arena_calloc1d(hArena, N, sizeof(float));
+        a2d = (int**)saf_arena_malloc2d(hArena, 7, 13, sizeof(int));
+        a3d = (float_complex***)saf_arena_calloc3d(hArena, 5, 3, 11, sizeof(float_complex));
+        big = (float*)saf_arena_malloc1d(hArena, 100000*sizeof(float));
+
+        /* Every allocation should be aligned, and zeroed if requested */
+        TEST_ASSERT_TRUE(((uintptr_t)a1d % MD_MALLOC_ALIGNMENT) == 0);
+        TEST_ASSERT_TRUE(((uintptr_t)FLATTEN2D(a2d) % MD_MALLOC_ALIGNMENT) == 0);
+        TEST_ASSERT_TRUE(((uintptr_t)FLATTEN3D(a3d) % MD_MALLOC_ALIGNMENT) == 0);
+        TEST_ASSERT_TRUE(((uintptr_t)big % MD_MALLOC_ALIGNMENT) == 0);
+        for(i=0; i<N; i++)
+            TEST_ASSERT_TRUE(a1d[i] == 0.0f);
+        for(i=0; i<5*3*11; i++)
+            TEST_ASSERT_TRUE(crealf(FLATTEN3D(a3d)[i]) == 0.0f && cimagf(FLATTEN3D(a3d)[i]) == 0.0f);
+
+        /* Fill, and check that the allocations do not overlap, and that the 2-D/3-D arrays are contiguous */
+        for(i=0; i<N; i++)
+            a1d[i] = (float)i;
+        for(i=0; i<7; i++)
+            for(j=0; j<13; j++)
+                a2d[i][j] = i*13+j;
+        for(i=0; i<5; i++)
+            for(j=0; j<3; j++)
+                for(k=0; k<11; k++)
+                    a3d[i][j][k] = cmplxf((float)(i*3*11+j*11+k), 1.0f);
+        for(i=0; i<100000; i++)
+            big[i] = -1.0f;
+        for(i=0; i<N; i++)
+            TEST_ASSERT_TRUE(a1d[i] == (float)i);
+        for(i=0; i<7*13; i++)
+            TEST_ASSERT_TRUE(FLATTEN2D(a2d)[i] == i);
+        for(i=0; i<5*3*11; i++)
+            TEST_ASSERT_TRUE(crealf(FLATTEN3D(a3d)[i]) == (float)i && cimagf(FLATTEN3D(a3d)[i]) == 1.0f);
+
+        /* The first pass grows the arena; the next ones should then use one block, of the same size */
+        nBlocks = saf_arena_getNumBlocks(hArena);
+        if(pass==0){
+            TEST_ASSERT_TRUE(nBlocks > 1);
+            capacity = saf_arena_getUsed(hArena);
+        }
+        else{
+            TEST_ASSERT_TRUE(nBlocks == 1);
+            TEST_ASSERT_TRUE(saf_arena_getCapacity(hArena) == capacity);
+            TEST_ASSERT_TRUE(saf_arena_getUsed(hArena) == capacity);
+        }
+    }
+
+    /* Clean-up */
+    saf_arena_destroy(&hArena);
+    TEST_ASSERT_TRUE(hArena == NULL);
 }
 
 void test__saf_rfft(void){
@@ -410,6 +1491,73 @@ void test__saf_rfft(void){
     }
 }
 
+void test__saf_rfft_batch(void){
+    int i, j, k, N, nBins, strideTD, strideFD;
+    float* x_td, *test;
+    float_complex* x_fd, *ref_fd;
+    void *hFFT;
+
+    /* Config */
+    const float acceptedTolerance = 0.00001f;
+    const int howMany = 5;
+    const int fftSizesToTest[4] = {16, 256, 4096, 480};
+
+    /* Loop over the different FFT sizes */
+    for (i=0; i<4; i++){
+        N = fftSizesToTest[i];
+        nBins = N/2+1;
+        strideTD = N+3;     /* (deliberately not tightly packed) */
+        strideFD = nBins+5;
+
+        /* prep */
+        x_td = malloc1d(howMany*strideTD*sizeof(float));
+        test = calloc1d(howMany*strideTD, sizeof(float));
+        x_fd = calloc1d(howMany*strideFD, sizeof(float_complex));
+        ref_fd = malloc1d(nBins*sizeof(float_complex));
+        rand_m1_1(x_td, howMany*strideTD); /* populate with random numbers */
+        saf_rfft_create(&hFFT, N);
+        saf_rfft_prepareBatch(hFFT, strideTD, strideFD, howMany, howMany);
+
+        /* Batched forward transform should match the single transforms */
+        for(k=0; k<2; k++) /* (twice, to also test the reuse of the prepared layout) */
+            saf_rfft_forward_batch(hFFT, x_td, strideTD, x_fd, strideFD, howMany);
+        for(j=0; j<howMany; j++){
+            saf_rfft_forward(hFFT, &x_td[j*strideTD], ref_fd);
+            for(k=0; k<nBins; k++){
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance*(float)N, crealf(ref_fd[k]), crealf(x_fd[j*strideFD+k]));
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance*(float)N, cimagf(ref_fd[k]), cimagf(x_fd[j*strideFD+k]));
+            }
+        }
+
+        /* Batched backward transform should give back the inputs, and leave the gaps untouched */
+        saf_rfft_backward_batch(hFFT, x_fd, strideFD, test, strideTD, howMany);
+        for(j=0; j<howMany; j++){
+            for(k=0; k<N; k++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, x_td[j*strideTD+k], test[j*strideTD+k]);
+            for(k=N; k<strideTD; k++)
+                TEST_ASSERT_TRUE(test[j*strideTD+k]==0.0f);
+        }
+
+        /* Re-prepared for fewer (tightly packed) transforms, which should still match */
+        saf_rfft_prepareBatch(hFFT, N, nBins, howMany-2, 0);
+        saf_rfft_forward_batch(hFFT, x_td, N, x_fd, nBins, howMany-2);
+        for(j=0; j<howMany-2; j++){
+            saf_rfft_forward(hFFT, &x_td[j*N], ref_fd);
+            for(k=0; k<nBins; k++){
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance*(float)N, crealf(ref_fd[k]), crealf(x_fd[j*nBins+k]));
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance*(float)N, cimagf(ref_fd[k]), cimagf(x_fd[j*nBins+k]));
+            }
+        }
+
+        /* clean-up */
+        saf_rfft_destroy(&hFFT);
+        free(x_fd);
+        free(ref_fd);
+        free(x_td);
+        free(test);
+    }
+}
+
 void test__saf_fft(void){
     int i, j, N;
     float_complex* x_td, *test;
@@ -451,6 +1599,133 @@ void test__saf_fft(void){
     }
 }
 
+void test__saf_fft_planning(void){
+    int i, j, r, N;
+    float* x_td, *test;
+    float_complex* x_fd;
+    void *hFFT1, *hFFT2;
+
+    /* Config */
+    const float acceptedTolerance = 0.00001f;
+    const int fftSizesToTest[3] = {64, 512, 480};
+    const SAF_FFT_PLANNER_RIGOUR rigours[2] = {SAF_FFT_PLANNER_MEASURE, SAF_FFT_PLANNER_ESTIMATE};
+
+    /* Loop over the planner rigours and FFT sizes */
+    for(r=0; r<2; r++){
+        saf_fft_setPlannerRigour(rigours[r]);
+        TEST_ASSERT_TRUE(saf_fft_getPlannerRigour()==rigours[r]);
+        for (i=0; i<3; i++){
+            N = fftSizesToTest[i];
+
+            /* prep */
+            x_td = malloc1d(N*sizeof(float));
+            test = malloc1d(N*sizeof(float));
+            x_fd = malloc1d((N/2+1)*sizeof(float_complex));
+            rand_m1_1(x_td, N); /* populate with random numbers */
+
+            /* Two instances of the same size (which may share plans) should both work, also after the other is gone */
+            saf_rfft_create(&hFFT1, N);
+            saf_rfft_create(&hFFT2, N);
+            saf_rfft_forward(hFFT1, x_td, x_fd);
+            saf_rfft_backward(hFFT2, x_fd, test);
+            for(j=0; j<N; j++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, x_td[j], test[j]);
+            saf_rfft_destroy(&hFFT1);
+            memset(test, 0, N*sizeof(float));
+            saf_rfft_forward(hFFT2, x_td, x_fd);
+            saf_rfft_backward(hFFT2, x_fd, test);
+            for(j=0; j<N; j++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, x_td[j], test[j]);
+            saf_rfft_destroy(&hFFT2);
+
+            /* clean-up */
+            free(x_fd);
+            free(x_td);
+            free(test);
+        }
+    }
+}
+
+void test__saf_fftconv(void){
+    int i, j, ch, s, n, t;
+    float* h, *ref;
+    float** x, **y, **y_mt, **y_sh;
+    void* hFC, *hFC_mt, *hFC_sh, *hThreadPool;
+
+    /* Config */
+    const float acceptedTolerance = 0.0001f;
+    const int x_len = 5000;
+    const int h_len = 300;
+    const int nCH = 3;
+    const int blockSize = 256;
+    const int callSizes[5] = {1, 100, 256, 777, 3};
+
+    /* prep (deterministic signals) */
+    h = malloc1d(nCH*h_len*sizeof(float));
+    x = (float**)malloc2d(nCH, x_len, sizeof(float));
+    y = (float**)malloc2d(nCH, x_len+h_len-1, sizeof(float));
+    y_mt = (float**)malloc2d(nCH, x_len+h_len-1, sizeof(float));
+    y_sh = (float**)malloc2d(nCH, x_len+h_len-1, sizeof(float));
+    ref = malloc1d((x_len+h_len-1)*sizeof(float));
+    for(ch=0; ch<nCH; ch++){
+        for(i=0; i<h_len; i++)
+            h[ch*h_len+i] = sinf(0.37f*(float)(i*(ch+1)))*expf(-(float)i/60.0f);
+        for(i=0; i<x_len; i++)
+            x[ch][i] = sinf(0.013f*(float)i*(float)(ch+1)) + 0.5f*cosf(1.7f*(float)i);
+    }
+
+    /* Stream the input through, using awkward call sizes, then flush the tails */
+    saf_threadPool_create(&hThreadPool, 2);
+    saf_fftconv_create(&hFC, h, h_len, nCH, blockSize, 1, NULL);
+    saf_fftconv_create(&hFC_mt, h, h_len, nCH, blockSize, 2, NULL);
+    saf_fftconv_create(&hFC_sh, h, h_len, nCH, blockSize, 0, hThreadPool); /* (one group per worker thread, plus the caller's) */
+    for(s=0, t=0; s<x_len; s+=n, t++){
+        n = SAF_MIN(callSizes[t%5], x_len-s);
+        saf_fftconv_apply(hFC, &FLATTEN2D(x)[s], x_len, n, &FLATTEN2D(y)[s], x_len+h_len-1);
+        saf_fftconv_apply(hFC_mt, &FLATTEN2D(x)[s], x_len, n, &FLATTEN2D(y_mt)[s], x_len+h_len-1);
+        saf_fftconv_apply(hFC_sh, &FLATTEN2D(x)[s], x_len, n, &FLATTEN2D(y_sh)[s], x_len+h_len-1);
+    }
+    saf_fftconv_apply(hFC, NULL, 0, h_len-1, &FLATTEN2D(y)[x_len], x_len+h_len-1);
+    saf_fftconv_apply(hFC_mt, NULL, 0, h_len-1, &FLATTEN2D(y_mt)[x_len], x_len+h_len-1);
+    saf_fftconv_apply(hFC_sh, NULL, 0, h_len-1, &FLATTEN2D(y_sh)[x_len], x_len+h_len-1);
+
+    /* Compare with direct time-domain convolution; the threaded versions should be identical */
+    for(ch=0; ch<nCH; ch++){
+        memset(ref, 0, (x_len+h_len-1)*sizeof(float));
+        for(i=0; i<x_len; i++)
+            for(j=0; j<h_len; j++)
+                ref[i+j] += x[ch][i]*h[ch*h_len+j];
+        for(i=0; i<x_len+h_len-1; i++){
+            TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, ref[i], y[ch][i]);
+            TEST_ASSERT_TRUE(y[ch][i]==y_mt[ch][i]);
+            TEST_ASSERT_TRUE(y[ch][i]==y_sh[ch][i]);
+        }
+    }
+
+    /* fftfilt() should agree, as should in-place processing after a reset */
+    fftfilt(FLATTEN2D(x), h, x_len, h_len, nCH, FLATTEN2D(y_mt));
+    saf_fftconv_reset(hFC);
+    saf_fftconv_apply(hFC, FLATTEN2D(x), x_len, x_len, FLATTEN2D(x), x_len);
+    for(ch=0; ch<nCH; ch++){
+        for(i=0; i<x_len; i++){
+            TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, y[ch][i], FLATTEN2D(y_mt)[ch*x_len+i]);
+            TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, y[ch][i], x[ch][i]);
+        }
+    }
+
+    /* clean-up */
+    saf_fftconv_destroy(&hFC);
+    saf_fftconv_destroy(&hFC_mt);
+    saf_fftconv_destroy(&hFC_sh);
+    saf_threadPool_destroy(&hThreadPool); /* (after the saf_fftconv that use it) */
+    free(h);
+    free(x);
+    free(y);
+    free(y_mt);
+    free(y_sh);
+    free(ref);
+}
+
 void test__qmf(void){
     int frame, nFrames, ch, i, nBands, procDelay, band, nHops;
     void* hQMF;
@@ -517,6 +1792,445 @@ void test__qmf(void){
     free(freqVector);
 }
 
+void test__saf_filterbank(void){
+    int type, frame, nFrames, ch, i, nBands, procDelay, band, nHops;
+    void* hFB;
+    float* freqVector, *impulse;
+    float** insig, **outsig, **inframe, **outframe;
+    float_complex* H;
+    float_complex*** inspec, ***outspec;
+
+    /* Config */
+    const float acceptedTolerance = 0.01f;
+    const float fs = 48000.0f;
+    const int signalLength = 24000;
+    const int framesize = 512;
+    const int hopsize = 64;
+    const int nCH = 3;
+    const SAF_FILTERBANK_TYPES types[4] = {SAF_FILTERBANK_AFSTFT, SAF_FILTERBANK_AFSTFT_LD, SAF_FILTERBANK_QMF, SAF_FILTERBANK_STFT};
+
+    /* prep (deterministic signals) */
+    insig = (float**)malloc2d(nCH, signalLength, sizeof(float));
+    outsig = (float**)malloc2d(nCH, signalLength, sizeof(float));
+    inframe = (float**)malloc2d(nCH, framesize, sizeof(float));
+    outframe = (float**)malloc2d(nCH, framesize, sizeof(float));
+    for(ch=0; ch<nCH; ch++)
+        for(i=0; i<signalLength; i++)
+            insig[ch][i] = 0.5f*sinf(0.0031f*(float)(i*(ch+1))) + 0.25f*cosf(1.3f*(float)i);
+    impulse = calloc1d(16, sizeof(float));
+    impulse[0] = 1.0f;
+    nHops = framesize/hopsize;
+
+    for(type=0; type<4; type++){
+        /* Set-up (with some channel changes, as the examples would do) */
+        saf_filterbank_create(&hFB, types[type], 1, 5, hopsize, 1);
+        saf_filterbank_channelChange(hFB, nCH+2, 1);
+        saf_filterbank_channelChange(hFB, nCH, nCH);
+        saf_filterbank_clearBuffers(hFB);
+        TEST_ASSERT_TRUE(saf_filterbank_getType(hFB)==types[type]);
+        nBands = saf_filterbank_getNBands(hFB);
+        procDelay = saf_filterbank_getProcDelay(hFB);
+        inspec = (float_complex***)malloc3d(nBands, nCH, nHops, sizeof(float_complex));
+        outspec = (float_complex***)malloc3d(nBands, nCH, nHops, sizeof(float_complex));
+
+        /* Centre frequencies should be ascending, and span up to Nyquist */
+        freqVector = malloc1d(nBands*sizeof(float));
+        saf_filterbank_getCentreFreqs(hFB, fs, nBands, freqVector);
+        for(band=1; band<nBands; band++)
+            TEST_ASSERT_TRUE(freqVector[band]>freqVector[band-1]);
+        TEST_ASSERT_TRUE(freqVector[nBands-1]<=fs/2.0f && freqVector[nBands-1]>0.95f*fs/2.0f);
+
+        /* The filterbank coefficients of an impulse should be (close to) unity */
+        H = malloc1d(nBands*sizeof(float_complex));
+        saf_filterbank_FIRtoFilterbankCoeffs(types[type], impulse, 1, 1, 16, hopsize, 1, H);
+        for(band=0; band<nBands; band++)
+            TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, cabsf(H[band]));
+
+        /* Check for (near) perfect reconstruction */
+        nFrames = signalLength/framesize;
+        for(frame=0; frame<nFrames; frame++){
+            for(ch=0; ch<nCH; ch++)
+                memcpy(inframe[ch], &insig[ch][frame*framesize], framesize*sizeof(float));
+            saf_filterbank_forward(hFB, inframe, framesize, nCH, nHops, inspec);
+            memcpy(FLATTEN3D(outspec), FLATTEN3D(inspec), nBands*nCH*nHops*sizeof(float_complex));
+            saf_filterbank_backward(hFB, outspec, framesize, nCH, nHops, outframe);
+            for(ch=0; ch<nCH; ch++)
+                memcpy(&outsig[ch][frame*framesize], outframe[ch], framesize*sizeof(float));
+        }
+        for(ch=0; ch<nCH; ch++)
+            for(i=0; i<nFrames*framesize-procDelay; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, insig[ch][i], outsig[ch][i+procDelay]);
+
+        /* Clean-up */
+        saf_filterbank_destroy(&hFB);
+        free(inspec);
+        free(outspec);
+        free(freqVector);
+        free(H);
+    }
+
+    free(insig);
+    free(outsig);
+    free(inframe);
+    free(outframe);
+    free(impulse);
+}
+
+void test__saf_simdDispatch(void){
+    int level, l, len, i;
+    float s;
+    float *a, *b, *c, *ref;
+    double *da, *db, *dc;
+    float_complex *ca, *cb, *cc;
+    double_complex *za, *zb, *zc;
+    SAF_SIMD_LEVELS supportedLevel;
+
+    /* Config */
+    const float acceptedTolerance = 0.00001f;
+    const int maxLen = 101;
+    const int lengths[5] = {1, 7, 17, 38, 101}; /* exercise each of the remainders */
+
+    /* prep (deterministic signals) */
+    a = malloc1d(2*maxLen*sizeof(float));
+    b = malloc1d(2*maxLen*sizeof(float));
+    c = malloc1d(2*maxLen*sizeof(float));
+    ref = malloc1d(2*maxLen*sizeof(float));
+    da = malloc1d(2*maxLen*sizeof(double));
+    db = malloc1d(2*maxLen*sizeof(double));
+    dc = malloc1d(2*maxLen*sizeof(double));
+    for(i=0; i<2*maxLen; i++){
+        a[i] = 1.5f + sinf(0.37f*(float)i);
+        b[i] = 0.8f*cosf(1.1f*(float)i);
+        da[i] = (double)a[i];
+        db[i] = (double)b[i];
+    }
+    ca = (float_complex*)a; cb = (float_complex*)b; cc = (float_complex*)c;
+    za = (double_complex*)da; zb = (double_complex*)db; zc = (double_complex*)dc;
+    s = 0.3f;
+
+    /* The detected level should be retained, unless it is limited */
+    saf_setMaxSIMDLevel(SAF_SIMD_AVX512);
+    supportedLevel = saf_getSIMDLevel();
+#if !defined(SAF_ENABLE_SIMD)
+    TEST_ASSERT_TRUE(supportedLevel==SAF_SIMD_NONE);
+#endif
+
+    /* Each variant of the kernels should give the same results as scalar code */
+    for(level=SAF_SIMD_NONE; level<=SAF_SIMD_AVX512; level++){
+        saf_setMaxSIMDLevel((SAF_SIMD_LEVELS)level);
+        TEST_ASSERT_TRUE(saf_getSIMDLevel()==SAF_MIN(supportedLevel, level));
+        for(l=0; l<5; l++){
+            len = lengths[l];
+            utility_svvadd(a, b, len, c);
+            for(i=0; i<len; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, a[i]+b[i], c[i]);
+            utility_svvsub(a, b, len, c);
+            for(i=0; i<len; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, a[i]-b[i], c[i]);
+            utility_svvmul(a, b, len, c);
+            for(i=0; i<len; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, a[i]*b[i], c[i]);
+            utility_svsadd(a, &s, len, c);
+            for(i=0; i<len; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, a[i]+s, c[i]);
+            utility_svssub(a, &s, len, c);
+            for(i=0; i<len; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, a[i]-s, c[i]);
+            utility_svrecip(a, len, c);
+            for(i=0; i<len; i++) /* (the SIMD reciprocals are approximate) */
+                TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, c[i]*a[i]);
+            utility_cvvadd(ca, cb, len, cc);
+            for(i=0; i<2*len; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, a[i]+b[i], c[i]);
+            utility_cvvsub(ca, cb, len, cc);
+            for(i=0; i<2*len; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, a[i]-b[i], c[i]);
+            utility_cvvmul(ca, cb, len, cc);
+            for(i=0; i<len; i++){
+                ref[2*i]   = a[2*i]*b[2*i]   - a[2*i+1]*b[2*i+1];
+                ref[2*i+1] = a[2*i]*b[2*i+1] + a[2*i+1]*b[2*i];
+            }
+            for(i=0; i<2*len; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, ref[i], c[i]);
+            utility_dvvadd(da, db, len, dc);
+            for(i=0; i<len; i++)
+                TEST_ASSERT_TRUE(fabs(da[i]+db[i]-dc[i])<acceptedTolerance);
+            utility_dvvsub(da, db, len, dc);
+            for(i=0; i<len; i++)
+                TEST_ASSERT_TRUE(fabs(da[i]-db[i]-dc[i])<acceptedTolerance);
+            utility_zvvadd(za, zb, len, zc);
+            for(i=0; i<2*len; i++)
+                TEST_ASSERT_TRUE(fabs(da[i]+db[i]-dc[i])<acceptedTolerance);
+            utility_zvvsub(za, zb, len, zc);
+            for(i=0; i<2*len; i++)
+                TEST_ASSERT_TRUE(fabs(da[i]-db[i]-dc[i])<acceptedTolerance);
+        }
+    }
+
+    /* Clean-up */
+    saf_setMaxSIMDLevel(SAF_SIMD_AVX512);
+    free(a);
+    free(b);
+    free(c);
+    free(ref);
+    free(da);
+    free(db);
+    free(dc);
+}
+
+void test__utility_cvvmac(void){
+    int level, l, len, i, k;
+    float *br;
+    float_complex *a, *b, *c, *ref, *tmp;
+
+    /* Config */
+    const float acceptedTolerance = 0.0001f;
+    const int maxLen = 300; /* (more than one of the blocks in utility_cvvmulsum) */
+    const int K = 3;
+    const int stride = 311;
+    const int lengths[5] = {1, 7, 17, 38, 300}; /* exercise each of the remainders */
+    const float_complex calpha = cmplxf(1.0f, 0.0f);
+
+    /* prep (deterministic signals) */
+    a = malloc1d(K*stride*sizeof(float_complex));
+    b = malloc1d(K*stride*sizeof(float_complex));
+    br = malloc1d(maxLen*sizeof(float));
+    c = malloc1d(maxLen*sizeof(float_complex));
+    ref = malloc1d(maxLen*sizeof(float_complex));
+    tmp = malloc1d(maxLen*sizeof(float_complex));
+    for(i=0; i<K*stride; i++){
+        a[i] = cmplxf(sinf(0.37f*(float)i), 0.5f*cosf(0.13f*(float)i));
+        b[i] = cmplxf(0.8f*cosf(1.1f*(float)i), sinf(0.71f*(float)i+0.2f));
+    }
+    for(i=0; i<maxLen; i++)
+        br[i] = 0.9f*sinf(0.05f*(float)i);
+
+    /* Compare with the unfused operations, for each variant of the SIMD kernels */
+    for(level=SAF_SIMD_NONE; level<=SAF_SIMD_AVX512; level++){
+        saf_setMaxSIMDLevel((SAF_SIMD_LEVELS)level);
+        for(l=0; l<5; l++){
+            len = lengths[l];
+
+            /* c = c + a.*b */
+            for(i=0; i<len; i++)
+                c[i] = ref[i] = cmplxf(0.1f*(float)i, -0.2f);
+            utility_cvvmul(a, b, len, tmp);
+            cblas_caxpy(len, &calpha, tmp, 1, ref, 1);
+            utility_cvvmac(a, b, len, NO_CONJ, c);
+            for(i=0; i<len; i++){
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, crealf(ref[i]), crealf(c[i]));
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, cimagf(ref[i]), cimagf(c[i]));
+            }
+
+            /* c = c + a.*conj(b) */
+            for(i=0; i<len; i++)
+                c[i] = cmplxf(0.1f*(float)i, -0.2f);
+            for(i=0; i<len; i++)
+                ref[i] = ccaddf(c[i], ccmulf(a[i], conjf(b[i])));
+            utility_cvvmac(a, b, len, CONJ, c);
+            for(i=0; i<len; i++){
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, crealf(ref[i]), crealf(c[i]));
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, cimagf(ref[i]), cimagf(c[i]));
+            }
+
+            /* c = sum_k a_k .* b_k */
+            memset(ref, 0, len*sizeof(float_complex));
+            for(k=0; k<K; k++){
+                utility_cvvmul(&a[k*stride], &b[k*stride], len, tmp);
+                cblas_caxpy(len, &calpha, tmp, 1, ref, 1);
+            }
+            utility_cvvmulsum(a, stride, b, stride, K, len, c);
+            for(i=0; i<len; i++){
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, crealf(ref[i]), crealf(c[i]));
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, cimagf(ref[i]), cimagf(c[i]));
+            }
+
+            /* c = c + s*(a.*b), where b is real */
+            for(i=0; i<len; i++){
+                c[i] = cmplxf(0.1f*(float)i, -0.2f);
+                ref[i] = ccaddf(c[i], crmulf(a[i], 0.7f*br[i]));
+            }
+            utility_crvvmac(a, br, 0.7f, len, c);
+            for(i=0; i<len; i++){
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, crealf(ref[i]), crealf(c[i]));
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, cimagf(ref[i]), cimagf(c[i]));
+            }
+        }
+    }
+
+    /* Clean-up */
+    saf_setMaxSIMDLevel(SAF_SIMD_AVX512);
+    free(a);
+    free(b);
+    free(br);
+    free(c);
+    free(ref);
+    free(tmp);
+}
+
+void test__utility_batchedSolvers(void){
+    int d, dim, dim1, dim2, nb, i, j, k;
+    float maxErr;
+    float_complex *M, *A, *B, *X, *V, *D, *Y, *Z, *Xref, *sv;
+    float *eig, *eigRef, *sing, *singRef;
+
+    /* Config */
+    const float acceptedTolerance = 0.0005f;
+    const int nBatch = 5;
+    const int dims[6] = {1, 2, 4, 7, 16, 20}; /* (the last 3 are passed to LAPACK for the EVD, and the last one for the solver) */
+    const int nCol = 3;
+    const int maxDim = 20;
+    const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
+
+    /* prep */
+    M = malloc1d(maxDim*maxDim*sizeof(float_complex));
+    A = malloc1d(nBatch*maxDim*maxDim*sizeof(float_complex));
+    B = malloc1d(nBatch*maxDim*nCol*sizeof(float_complex));
+    X = malloc1d(nBatch*maxDim*nCol*sizeof(float_complex));
+    Xref = malloc1d(maxDim*nCol*sizeof(float_complex));
+    V = malloc1d(nBatch*maxDim*maxDim*sizeof(float_complex));
+    D = malloc1d(nBatch*maxDim*maxDim*sizeof(float_complex));
+    Y = malloc1d(maxDim*maxDim*sizeof(float_complex));
+    Z = malloc1d(maxDim*maxDim*sizeof(float_complex));
+    sv = malloc1d(nBatch*maxDim*maxDim*sizeof(float_complex));
+    eig = malloc1d(nBatch*maxDim*sizeof(float));
+    eigRef = malloc1d(maxDim*sizeof(float));
+    sing = malloc1d(nBatch*maxDim*sizeof(float));
+    singRef = malloc1d(maxDim*sizeof(float));
+
+    for(d=0; d<6; d++){
+        dim = dims[d];
+
+        /* Hermitian positive-definate matrices (deterministic): A = M M^H/dim + I */
+        for(nb=0; nb<nBatch; nb++){
+            for(i=0; i<dim*dim; i++)
+                M[i] = cmplxf(sinf(0.37f*(float)(i+nb*101)+0.1f*(float)d), cosf(1.3f*(float)(i*nb)+0.7f));
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, dim, dim, dim, &calpha,
+                        M, dim, M, dim, &cbeta, &A[nb*dim*dim], dim);
+            for(i=0; i<dim; i++)
+                for(j=0; j<dim; j++)
+                    A[nb*dim*dim+i*dim+j] = ccaddf(crmulf(A[nb*dim*dim+i*dim+j], 1.0f/(float)dim), cmplxf(i==j ? 1.0f : 0.0f, 0.0f));
+            for(i=0; i<dim*nCol; i++)
+                B[nb*dim*nCol+i] = cmplxf(cosf(0.21f*(float)(i+nb)), 0.5f*sinf(0.9f*(float)i));
+        }
+
+        /* Eigenvalue decomposition: A V = V D, V^H V = I, and same eigen values as utility_cseig() */
+        utility_cseig_batch(NULL, A, dim, nBatch, 1, V, D, eig);
+        for(nb=0; nb<nBatch; nb++){
+            utility_cseig(NULL, &A[nb*dim*dim], dim, 1, NULL, NULL, eigRef);
+            for(i=0; i<dim; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, eigRef[i], eig[nb*dim+i]);
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, dim, dim, dim, &calpha,
+                        &A[nb*dim*dim], dim, &V[nb*dim*dim], dim, &cbeta, Y, dim);
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, dim, dim, dim, &calpha,
+                        &V[nb*dim*dim], dim, &D[nb*dim*dim], dim, &cbeta, Z, dim);
+            maxErr = 0.0f;
+            for(i=0; i<dim*dim; i++)
+                maxErr = SAF_MAX(maxErr, cabsf(ccsubf(Y[i], Z[i])));
+            TEST_ASSERT_TRUE(maxErr<acceptedTolerance);
+            cblas_cgemm(CblasRowMajor, CblasConjTrans, CblasNoTrans, dim, dim, dim, &calpha,
+                        &V[nb*dim*dim], dim, &V[nb*dim*dim], dim, &cbeta, Y, dim);
+            for(i=0; i<dim; i++){
+                for(j=0; j<dim; j++){
+                    TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, i==j ? 1.0f : 0.0f, crealf(Y[i*dim+j]));
+                    TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, 0.0f, cimagf(Y[i*dim+j]));
+                }
+            }
+        }
+
+        /* Ascending order, and eigen values only */
+        utility_cseig_batch(NULL, A, dim, nBatch, 0, NULL, NULL, eig);
+        for(nb=0; nb<nBatch; nb++){
+            utility_cseig(NULL, &A[nb*dim*dim], dim, 0, NULL, NULL, eigRef);
+            for(i=0; i<dim; i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, eigRef[i], eig[nb*dim+i]);
+        }
+
+        /* Linear solver: same solutions as utility_cslslv() */
+        utility_cslslv_batch(NULL, A, dim, B, nCol, nBatch, X);
+        for(nb=0; nb<nBatch; nb++){
+            utility_cslslv(NULL, &A[nb*dim*dim], dim, &B[nb*dim*nCol], nCol, Xref);
+            for(i=0; i<dim*nCol; i++){
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, crealf(Xref[i]), crealf(X[nb*dim*nCol+i]));
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, cimagf(Xref[i]), cimagf(X[nb*dim*nCol+i]));
+            }
+        }
+
+        /* SVD: same singular values as utility_csvd() */
+        utility_csvd_batch(NULL, A, dim, dim, nBatch, NULL, sv, NULL, sing);
+        for(nb=0; nb<nBatch; nb++){
+            utility_csvd(NULL, &A[nb*dim*dim], dim, dim, NULL, NULL, NULL, singRef);
+            for(i=0; i<dim; i++){
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, singRef[i], sing[nb*dim+i]);
+                for(k=0; k<dim; k++)
+                    TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, i==k ? singRef[i] : 0.0f, crealf(sv[nb*dim*dim+i*dim+k]));
+            }
+        }
+    }
+
+    /* SVD of tall, wide and rank-deficient matrices: A = U S V^H, with unitary U and V */
+    for(d=0; d<4; d++){
+        dim1 = d==0 ? 4 : d==1 ? 2 : d==2 ? 3 : 4;
+        dim2 = d==0 ? 2 : d==1 ? 4 : d==2 ? 3 : 4;
+        for(nb=0; nb<nBatch; nb++){
+            for(i=0; i<dim1*dim2; i++)
+                A[nb*dim1*dim2+i] = cmplxf(sinf(0.53f*(float)(i+nb*7)+0.2f*(float)d), cosf(0.71f*(float)(i*nb)+0.3f));
+            if(d>=2) /* repeated rows */
+                for(j=0; j<dim2; j++)
+                    A[nb*dim1*dim2+(dim1-1)*dim2+j] = A[nb*dim1*dim2+j];
+        }
+        utility_csvd_batch(NULL, A, dim1, dim2, nBatch, X, sv, V, sing);
+        for(nb=0; nb<nBatch; nb++){
+            utility_csvd(NULL, &A[nb*dim1*dim2], dim1, dim2, NULL, NULL, NULL, singRef);
+            for(i=0; i<SAF_MIN(dim1, dim2); i++)
+                TEST_ASSERT_FLOAT_WITHIN(acceptedTolerance, singRef[i], sing[nb*SAF_MIN(dim1, dim2)+i]);
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, dim1, dim2, dim1, &calpha,
+                        &X[nb*dim1*dim1], dim1, &sv[nb*dim1*dim2], dim2, &cbeta, Y, dim2);
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, dim1, dim2, dim2, &calpha,
+                        Y, dim2, &V[nb*dim2*dim2], dim2, &cbeta, Z, dim2);
+            maxErr = 0.0f;
+            for(i=0; i<dim1*dim2; i++)
+                maxErr = SAF_MAX(maxErr, cabsf(ccsubf(A[nb*dim1*dim2+i], Z[i])));
+            TEST_ASSERT_TRUE(maxErr<acceptedTolerance);
+            cblas_cgemm(CblasRowMajor, CblasConjTrans, CblasNoTrans, dim1, dim1, dim1, &calpha,
+                        &X[nb*dim1*dim1], dim1, &X[nb*dim1*dim1], dim1, &cbeta, Y, dim1);
+            for(i=0; i<dim1; i++)
+                for(j=0; j<dim1; j++)
+                    TEST_ASSERT_TRUE(cabsf(ccsubf(Y[i*dim1+j], cmplxf(i==j ? 1.0f : 0.0f, 0.0f)))<acceptedTolerance);
+            cblas_cgemm(CblasRowMajor, CblasConjTrans, CblasNoTrans, dim2, dim2, dim2, &calpha,
+                        &V[nb*dim2*dim2], dim2, &V[nb*dim2*dim2], dim2, &cbeta, Y, dim2);
+            for(i=0; i<dim2; i++)
+                for(j=0; j<dim2; j++)
+                    TEST_ASSERT_TRUE(cabsf(ccsubf(Y[i*dim2+j], cmplxf(i==j ? 1.0f : 0.0f, 0.0f)))<acceptedTolerance);
+        }
+    }
+
+    /* Not positive-definate, so the solution should be zeroed */
+    for(i=0; i<4*4; i++)
+        A[i] = cmplxf(i%5==0 ? -1.0f : 0.0f, 0.0f);
+    for(i=0; i<4*nCol; i++)
+        X[i] = cmplxf(1.0f, 1.0f);
+    utility_cslslv_batch(NULL, A, 4, B, nCol, 1, X);
+    for(i=0; i<4*nCol; i++)
+        TEST_ASSERT_TRUE(crealf(X[i])==0.0f && cimagf(X[i])==0.0f);
+
+    /* Clean-up */
+    free(M);
+    free(A);
+    free(B);
+    free(X);
+    free(Xref);
+    free(V);
+    free(D);
+    free(Y);
+    free(Z);
+    free(sv);
+    free(eig);
+    free(eigRef);
+    free(sing);
+    free(singRef);
+}
+
 void test__smb_pitchShifter(void){
     float* inputData, *outputData;
     void* hPS, *hFFT;